@@ -0,0 +1,192 @@
+#include <array>
+#include <filesystem>
+#include <system_error>
+
+#include <benchmark/benchmark.h>
+
+#include <fmt/format.h>
+
+#include <radray/file.h>
+#include <radray/runtime/asset_database.h>
+#include <radray/types.h>
+
+using namespace radray;
+
+namespace radray {
+namespace {
+class BenchImportSettings;
+}  // namespace
+
+template <>
+struct RuntimeTypeTrait<BenchImportSettings> {
+    static constexpr RuntimeTypeId value{0x6a0f3c52, 0x1d7e, 0x4e29, 0x9b, 0x44, 0x0c, 0x5a, 0xe1, 0x72, 0x38, 0xd6};
+    using Bases = std::tuple<>;
+};
+
+namespace {
+
+class BenchImportSettings final : public AssetImportSettings {
+public:
+    const RuntimeTypeInfo& GetTypeInfo() const noexcept override { return runtime_type_info_v<BenchImportSettings>; }
+
+    bool Deserialize(const JsonValue& json) override {
+        JsonObjectReader object{json};
+        return object.IsValid() && object.MemberIfPresent("scale", Scale);
+    }
+
+    bool Serialize(JsonWriteContext& context) const noexcept override {
+        JsonObjectWriter object = context.BeginObject();
+        return object.IsValid() && object.Member("scale", Scale);
+    }
+
+    uint32_t Scale{1};
+};
+
+class BenchImporter final : public TypedAssetImporter<BenchImportSettings> {
+public:
+    std::string_view GetTypeName() const noexcept override { return "bench"; }
+
+protected:
+    task<AssetLoadResult> LoadTyped(std::filesystem::path, BenchImportSettings) override {
+        co_return AssetLoadResult::Failure("bench importer has no payload");
+    }
+};
+
+vector<unique_ptr<AssetImporter>> MakeImporters() {
+    vector<unique_ptr<AssetImporter>> importers;
+    importers.push_back(make_unique<BenchImporter>());
+    return importers;
+}
+
+AssetId MakeBenchId(uint32_t n) noexcept {
+    return AssetId{n, 0x0d0d, 0x4000, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03};
+}
+
+/// 每个条目数一个资产根: 清单与索引只在第一次用到时生成, 供各个 benchmark 共用。
+const std::filesystem::path& GetBenchRoot(uint32_t count) {
+    static unordered_map<uint32_t, std::filesystem::path> roots;
+    if (auto it = roots.find(count); it != roots.end()) {
+        return it->second;
+    }
+    std::error_code error;
+    std::filesystem::path root = std::filesystem::temp_directory_path(error) /
+                                 fmt::format("radray_bench_asset_database_{}", count);
+    std::filesystem::remove_all(root, error);
+    std::filesystem::create_directories(root, error);
+    fmt::memory_buffer manifest;
+    fmt::format_to(std::back_inserter(manifest), "{{\"version\":1,\"assets\":[");
+    for (uint32_t i = 0; i < count; ++i) {
+        fmt::format_to(
+            std::back_inserter(manifest),
+            "{}{{\"guid\":\"{}\",\"path\":\"textures/group{}/asset{}.bench\",\"type\":\"bench\",\"settings\":{{\"scale\":{}}}}}",
+            i == 0 ? "" : ",",
+            MakeBenchId(i),
+            i % 64,
+            i,
+            i % 7);
+    }
+    fmt::format_to(std::back_inserter(manifest), "]}}");
+    WriteTextFile(root / "assets.json", std::string_view{manifest.data(), manifest.size()});
+    // 第一次 Open 走 JSON 路径并写出 assets.index。
+    string openError;
+    if (AssetDatabase::Open(root, MakeImporters(), openError) == nullptr) {
+        fmt::print(stderr, "bench manifest failed to open: {}\n", openError);
+    }
+    return roots.emplace(count, std::move(root)).first->second;
+}
+
+}  // namespace
+}  // namespace radray
+
+/// 删掉索引后打开: 完整 JSON 解析、逐条解码 settings, 并重写索引。
+static void BM_AssetDatabaseOpenJson(benchmark::State& state) {
+    const std::filesystem::path& root = GetBenchRoot(static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::error_code error;
+        std::filesystem::remove(root / "assets.index", error);
+        state.ResumeTiming();
+        string openError;
+        unique_ptr<AssetDatabase> database = AssetDatabase::Open(root, MakeImporters(), openError);
+        benchmark::DoNotOptimize(database.get());
+    }
+}
+BENCHMARK(BM_AssetDatabaseOpenJson)
+    ->Arg(100'000)
+    ->Arg(1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/// 索引有效时打开: 映射并哈希清单, 映射并校验索引, 不构造任何条目。
+static void BM_AssetDatabaseOpenIndexed(benchmark::State& state) {
+    const std::filesystem::path& root = GetBenchRoot(static_cast<uint32_t>(state.range(0)));
+    for (auto _ : state) {
+        string openError;
+        unique_ptr<AssetDatabase> database = AssetDatabase::Open(root, MakeImporters(), openError);
+        benchmark::DoNotOptimize(database.get());
+    }
+}
+BENCHMARK(BM_AssetDatabaseOpenIndexed)
+    ->Arg(100'000)
+    ->Arg(1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/// 索引支撑的库上按路径查 1000 个不同条目, 含首次实体化。
+static void BM_AssetDatabaseFindIndexed(benchmark::State& state) {
+    const auto count = static_cast<uint32_t>(state.range(0));
+    const std::filesystem::path& root = GetBenchRoot(count);
+    vector<string> paths;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        const uint32_t n = static_cast<uint32_t>((uint64_t{i} * 2654435761u) % count);
+        paths.push_back(fmt::format("textures/group{}/asset{}.bench", n % 64, n));
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        string openError;
+        unique_ptr<AssetDatabase> database = AssetDatabase::Open(root, MakeImporters(), openError);
+        state.ResumeTiming();
+        for (const string& path : paths) {
+            benchmark::DoNotOptimize(database->Find(path));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+BENCHMARK(BM_AssetDatabaseFindIndexed)
+    ->Arg(100'000)
+    ->Arg(1'000'000)
+    ->Unit(benchmark::kMicrosecond);
+
+/// 改动一个条目后 Save: 其余条目复用上次 Save 的索引记录, 只重新编码这一条。
+/// 在清单的副本上进行, 不影响其他 benchmark 的资产根。
+static void BM_AssetDatabaseSaveAfterOneEdit(benchmark::State& state) {
+    const auto count = static_cast<uint32_t>(state.range(0));
+    const std::filesystem::path& source = GetBenchRoot(count);
+    std::error_code error;
+    std::filesystem::path root = source;
+    root += "_save";
+    std::filesystem::remove_all(root, error);
+    std::filesystem::copy(source, root, std::filesystem::copy_options::recursive, error);
+    string saveError;
+    unique_ptr<AssetDatabase> database = AssetDatabase::Open(root, MakeImporters(), saveError);
+    // 第一次 Save 全量编码, 之后的索引才是 Save 的输出。
+    if (database == nullptr || !database->Save(saveError)) {
+        state.SkipWithError(saveError.c_str());
+        return;
+    }
+    uint32_t iteration = 0;
+    for (auto _ : state) {
+        const AssetId dependency[]{MakeBenchId(++iteration % count)};
+        database->RecordDependencies(MakeBenchId(0), dependency);
+        if (!database->Save(saveError)) {
+            state.SkipWithError(saveError.c_str());
+            break;
+        }
+    }
+    database.reset();
+    std::filesystem::remove_all(root, error);
+}
+BENCHMARK(BM_AssetDatabaseSaveAfterOneEdit)
+    ->Arg(100'000)
+    ->Arg(1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
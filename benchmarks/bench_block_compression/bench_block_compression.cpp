@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include <radray/block_compression.h>
+#include <radray/types.h>
+
+using namespace radray;
+
+// 固定的 1024x1024 程序化图集上各 BC 格式的编码吞吐与质量。图都由固定种子生成, 不依赖外部文件,
+// 不同机器上的 PSNR 可以直接比较。PSNR 只在格式实际保存的通道上计算, 作为 counter 输出。
+
+namespace {
+
+constexpr uint32_t kImageSize = 1024;
+
+enum class TestImage : int64_t {
+    /// 平滑的三通道渐变 + 轻微噪声, alpha 纵向渐变。块内颜色近似共线。
+    Gradient,
+    /// 双线性插值的 32 像素格值噪声: 类似照片里的低频纹理。
+    ValueNoise,
+    /// 8 像素棋盘叠彩色边缘, 压块边界和端点拟合的最坏情况。
+    Checker,
+    /// 由高度场求出的切线空间法线, 编码到 [0, 255]。BC5 的典型输入。
+    NormalMap,
+};
+
+float Hash(uint32_t x, uint32_t y, uint32_t seed) noexcept {
+    uint32_t h = x * 0x8da6b343u ^ y * 0xd8163841u ^ seed * 0xcb1ab31fu;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    return static_cast<float>(h & 0xffff) / 65535.0f;
+}
+
+float ValueNoise(float x, float y, uint32_t seed) noexcept {
+    const auto x0 = static_cast<uint32_t>(x);
+    const auto y0 = static_cast<uint32_t>(y);
+    const float tx = x - static_cast<float>(x0);
+    const float ty = y - static_cast<float>(y0);
+    const float top = std::lerp(Hash(x0, y0, seed), Hash(x0 + 1, y0, seed), tx);
+    const float bottom = std::lerp(Hash(x0, y0 + 1, seed), Hash(x0 + 1, y0 + 1, seed), tx);
+    return std::lerp(top, bottom, ty);
+}
+
+byte ToByte(float value) noexcept {
+    return static_cast<byte>(static_cast<uint32_t>(std::clamp(value, 0.0f, 255.0f) + 0.5f));
+}
+
+vector<byte> MakeImage(TestImage image) {
+    std::mt19937 random{static_cast<uint32_t>(image) + 1};
+    vector<byte> pixels(size_t{kImageSize} * kImageSize * 4);
+    for (uint32_t y = 0; y < kImageSize; ++y) {
+        for (uint32_t x = 0; x < kImageSize; ++x) {
+            byte* pixel = pixels.data() + (size_t{y} * kImageSize + x) * 4;
+            const float u = static_cast<float>(x) / kImageSize;
+            const float v = static_cast<float>(y) / kImageSize;
+            switch (image) {
+                case TestImage::Gradient: {
+                    const float noise = static_cast<float>(random() % 7) - 3.0f;
+                    pixel[0] = ToByte(u * 255.0f + noise);
+                    pixel[1] = ToByte(v * 200.0f + 30.0f + noise);
+                    pixel[2] = ToByte((1.0f - u) * 180.0f + noise);
+                    pixel[3] = ToByte(255.0f - v * 255.0f);
+                    break;
+                }
+                case TestImage::ValueNoise:
+                    for (uint32_t channel = 0; channel < 4; ++channel) {
+                        pixel[channel] = ToByte(ValueNoise(x / 32.0f, y / 32.0f, channel) * 255.0f);
+                    }
+                    break;
+                case TestImage::Checker: {
+                    const bool dark = ((x / 8) ^ (y / 8)) & 1;
+                    pixel[0] = ToByte(dark ? 20.0f : 230.0f);
+                    pixel[1] = ToByte(dark ? 40.0f + u * 100.0f : 200.0f);
+                    pixel[2] = ToByte((x % 16) < 2 ? 255.0f : 60.0f);
+                    pixel[3] = ToByte(dark ? 255.0f : 96.0f);
+                    break;
+                }
+                case TestImage::NormalMap: {
+                    const auto height = [](float hx, float hy) { return ValueNoise(hx / 24.0f, hy / 24.0f, 17) * 8.0f; };
+                    const float fx = static_cast<float>(x);
+                    const float fy = static_cast<float>(y);
+                    const float dx = height(fx + 1.0f, fy) - height(fx, fy);
+                    const float dy = height(fx, fy + 1.0f) - height(fx, fy);
+                    const float inverseLength = 1.0f / std::sqrt(dx * dx + dy * dy + 1.0f);
+                    pixel[0] = ToByte((-dx * inverseLength * 0.5f + 0.5f) * 255.0f);
+                    pixel[1] = ToByte((-dy * inverseLength * 0.5f + 0.5f) * 255.0f);
+                    pixel[2] = ToByte((inverseLength * 0.5f + 0.5f) * 255.0f);
+                    pixel[3] = byte{255};
+                    break;
+                }
+            }
+        }
+    }
+    return pixels;
+}
+
+double ComputePsnr(std::span<const byte> expected, std::span<const byte> actual, BlockFormat format) {
+    const size_t channelCount = format == BlockFormat::BC4 ? 1 : format == BlockFormat::BC5 ? 2 : format == BlockFormat::BC1 ? 3 : 4;
+    double squaredError = 0.0;
+    for (size_t i = 0; i < expected.size(); i += 4) {
+        for (size_t channel = 0; channel < channelCount; ++channel) {
+            const double diff = std::to_integer<int>(expected[i + channel]) - std::to_integer<int>(actual[i + channel]);
+            squaredError += diff * diff;
+        }
+    }
+    const double meanSquaredError = squaredError / static_cast<double>(expected.size() / 4 * channelCount);
+    return meanSquaredError == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
+
+/// 与 bench_mip_chain 相同: 每次调用起 hardware_concurrency 个线程抢带号。
+void ThreadParallelFor(uint32_t count, const std::function<void(uint32_t)>& body) {
+    std::atomic<uint32_t> next{0};
+    const uint32_t threadCount = std::min(std::max(std::thread::hardware_concurrency(), 1u), count);
+    vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&]() {
+            for (uint32_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                body(i);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+}  // namespace
+
+/// range(0) 为 TestImage, range(1) 为 BlockFormat, range(2) 非 0 时并行。吞吐按 RGBA8 输入字节计。
+static void BM_CompressRgba8Blocks(benchmark::State& state) {
+    const auto image = static_cast<TestImage>(state.range(0));
+    const auto format = static_cast<BlockFormat>(state.range(1));
+    const MipParallelFor parallelFor = state.range(2) != 0 ? MipParallelFor{ThreadParallelFor} : MipParallelFor{};
+    const vector<byte> pixels = MakeImage(image);
+    vector<byte> blocks(GetBlockCompressedSize(format, kImageSize, kImageSize));
+    for (auto _ : state) {
+        CompressRgba8Blocks(pixels, kImageSize, kImageSize, format, blocks, parallelFor);
+        benchmark::DoNotOptimize(blocks.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(pixels.size()));
+
+    vector<byte> decoded(pixels.size());
+    DecompressBlocksToRgba8(blocks, kImageSize, kImageSize, format, decoded);
+    state.counters["psnr"] = ComputePsnr(pixels, decoded, format);
+    state.counters["bpp"] = static_cast<double>(GetBlockFormatBytes(format)) * 8.0 / 16.0;
+}
+BENCHMARK(BM_CompressRgba8Blocks)
+    ->ArgsProduct({
+        {static_cast<int64_t>(TestImage::Gradient),
+         static_cast<int64_t>(TestImage::ValueNoise),
+         static_cast<int64_t>(TestImage::Checker),
+         static_cast<int64_t>(TestImage::NormalMap)},
+        {static_cast<int64_t>(BlockFormat::BC1),
+         static_cast<int64_t>(BlockFormat::BC3),
+         static_cast<int64_t>(BlockFormat::BC4),
+         static_cast<int64_t>(BlockFormat::BC5),
+         static_cast<int64_t>(BlockFormat::BC7)},
+        {0, 1}})
+    ->ArgNames({"image", "format", "parallel"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
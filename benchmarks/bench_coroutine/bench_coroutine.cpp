@@ -0,0 +1,155 @@
+#include <optional>
+
+#include <benchmark/benchmark.h>
+#include <exec/task.hpp>
+
+#include <radray/coroutine.h>
+#include <radray/types.h>
+
+using namespace radray;
+
+// 模拟 AssetManager 的加载形状: 每个加载是 scope 里的一个 task, 先在手动调度器上等一帧
+// (对应 AssetWaitAwaitable / WaitFrame), 再带 stop token 等一个平凡的 loader task。
+// 每个用例跑两组: 池化帧的 radray::task 与帧走全局 operator new 的 exec::task。
+
+constexpr int64_t kTaskCount = 100'000;
+
+struct BenchWaitRecord : ManualCoroutineRecord {};
+
+using BenchScheduler = ManualCoroutineScheduler<BenchWaitRecord>;
+
+class BenchWaitAwaitable {
+public:
+    BenchWaitAwaitable(BenchScheduler* scheduler, stop_token stop) noexcept
+        : _scheduler(scheduler), _stop(stop) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> continuation) {
+        _record = _scheduler->Enqueue(_stop, continuation);
+    }
+
+    bool await_resume() noexcept {
+        const bool completed = !_record->Canceled;
+        _scheduler->Erase(_record);
+        return completed;
+    }
+
+private:
+    BenchScheduler* _scheduler;
+    stop_token _stop;
+    BenchWaitRecord* _record{nullptr};
+};
+
+/// radray::task: 帧经 AllocateCoroutineFrame 的线程本地池分配。
+struct PooledFrames {
+    template <class T>
+    using Task = task<T>;
+};
+
+/// 未池化的对照组: 同一形状用 exec::task 写, 帧走全局 operator new。
+struct GlobalNewFrames {
+    template <class T>
+    using Task = exec::task<T>;
+};
+
+template <class Frames>
+static typename Frames::template Task<int64_t> TrivialLoader(int64_t value) {
+    co_return value;
+}
+
+/// 两组都直接用 stdexec 组合 stop token (WithStopToken 只接受 radray::task), 只有 task 类型不同。
+template <class Frames>
+static typename Frames::template Task<void> TrivialLoad(BenchScheduler* scheduler, stop_token stop, int64_t value, int64_t* sink) {
+    if (scheduler != nullptr && !co_await BenchWaitAwaitable{scheduler, stop}) {
+        co_return;
+    }
+    const std::optional<int64_t> result = co_await stdexec::stopped_as_optional(
+        stdexec::write_env(
+            TrivialLoader<Frames>(value),
+            stdexec::prop{stdexec::get_stop_token, stop}));
+    *sink += result.value_or(0);
+}
+
+/// 与 Application::Pump 相同的恢复方式: 从队首逐个恢复, 按 ticket 判断是否还需摘除。
+static void PumpScheduler(BenchScheduler& scheduler) {
+    while (!scheduler.Empty()) {
+        BenchWaitRecord* record = scheduler.Front();
+        const uint64_t ticket = record->Ticket;
+        scheduler.ResumeRecord(record);
+        if (scheduler.IsAlive(record, ticket)) {
+            scheduler.Erase(record);
+        }
+    }
+}
+
+/// 10 万个加载一次性 spawn, 不经调度器等待, 只看协程帧本身的开销。
+/// 两组都 spawn 进同一种 exec::async_scope (TaskScope::Spawn 只接受 radray::task)。
+template <class Frames>
+static void BM_SpawnTrivialLoads(benchmark::State& state) {
+    int64_t sink = 0;
+    for (auto _ : state) {
+        exec::async_scope scope;
+        for (int64_t i = 0; i < kTaskCount; ++i) {
+            scope.spawn(TrivialLoad<Frames>(nullptr, scope.get_stop_token(), i, &sink));
+        }
+        (void)stdexec::sync_wait(scope.on_empty());
+    }
+    benchmark::DoNotOptimize(sink);
+    state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+BENCHMARK_TEMPLATE(BM_SpawnTrivialLoads, PooledFrames)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SpawnTrivialLoads, GlobalNewFrames)->Unit(benchmark::kMillisecond);
+
+/// 10 万个加载按每帧 range(0) 个分批: spawn 一批, 它们挂在调度器上, 泵一次全部恢复。
+/// 第一帧之后调度器的 Entry 与池化组的协程帧都来自空闲链表。
+template <class Frames>
+static void BM_FramedTrivialLoads(benchmark::State& state) {
+    const int64_t perFrame = state.range(0);
+    int64_t sink = 0;
+    for (auto _ : state) {
+        BenchScheduler scheduler;
+        exec::async_scope scope;
+        for (int64_t spawned = 0; spawned < kTaskCount;) {
+            for (int64_t i = 0; i < perFrame && spawned < kTaskCount; ++i, ++spawned) {
+                scope.spawn(TrivialLoad<Frames>(&scheduler, scope.get_stop_token(), spawned, &sink));
+            }
+            PumpScheduler(scheduler);
+        }
+        (void)stdexec::sync_wait(scope.on_empty());
+    }
+    benchmark::DoNotOptimize(sink);
+    state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+BENCHMARK_TEMPLATE(BM_FramedTrivialLoads, PooledFrames)
+    ->Arg(64)
+    ->Arg(512)
+    ->ArgNames({"per_frame"})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_FramedTrivialLoads, GlobalNewFrames)
+    ->Arg(64)
+    ->Arg(512)
+    ->ArgNames({"per_frame"})
+    ->Unit(benchmark::kMillisecond);
+
+/// 只测调度器记录的挂/摘, 不涉及协程帧。
+static void BM_SchedulerEnqueueErase(benchmark::State& state) {
+    const int64_t batch = state.range(0);
+    BenchScheduler scheduler;
+    stop_source stop;
+    vector<BenchWaitRecord*> records;
+    records.reserve(static_cast<size_t>(batch));
+    for (auto _ : state) {
+        for (int64_t i = 0; i < batch; ++i) {
+            records.push_back(scheduler.Enqueue(stop.get_token(), {}));
+        }
+        for (BenchWaitRecord* record : records) {
+            scheduler.Erase(record);
+        }
+        records.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_SchedulerEnqueueErase)->Arg(1)->Arg(64)->Arg(512);
+
+BENCHMARK_MAIN();
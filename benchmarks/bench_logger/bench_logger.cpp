@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+#include <radray/logger.h>
+#include <radray/types.h>
+
+using namespace radray;
+
+// 日志写 stdout，benchmark 报告改走 stderr，运行时把 stdout 重定向到空设备，
+// 测到的就是调用方线程在 sink 上付出的时间，而不是终端渲染速度。
+
+static void ReportLatency(benchmark::State& state, vector<int64_t>& samples) {
+    if (samples.empty()) {
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        const size_t index = std::min(samples.size() - 1, static_cast<size_t>(p * static_cast<double>(samples.size())));
+        return static_cast<double>(samples[index]);
+    };
+    state.counters["p50_ns"] = percentile(0.50);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p999_ns"] = percentile(0.999);
+    state.counters["max_ns"] = static_cast<double>(samples.back());
+}
+
+static void RunHotLoop(benchmark::State& state) {
+    vector<int64_t> samples;
+    samples.reserve(1 << 20);
+    int frame = 0;
+    for (auto _ : state) {
+        const auto begin = std::chrono::steady_clock::now();
+        LogFormat(LogLevel::Warn, "frame {} draw {} took {:.3f} ms", frame, frame * 7, 0.125);
+        const auto end = std::chrono::steady_clock::now();
+        if (samples.size() < samples.capacity()) {
+            samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+        }
+        ++frame;
+    }
+    ReportLatency(state, samples);
+}
+
+static void BM_LogSync(benchmark::State& state) {
+    RunHotLoop(state);
+    FlushLog();
+}
+BENCHMARK(BM_LogSync);
+
+static void BM_LogAsync(benchmark::State& state) {
+    const auto overflow = static_cast<LogOverflowPolicy>(state.range(0));
+    StartAsyncLog({.Capacity = 1u << 16, .Overflow = overflow});
+    RunHotLoop(state);
+    state.counters["dropped"] = static_cast<double>(GetDroppedLogCount());
+    StopAsyncLog();
+}
+BENCHMARK(BM_LogAsync)
+    ->Arg(static_cast<int64_t>(LogOverflowPolicy::Drop))
+    ->Arg(static_cast<int64_t>(LogOverflowPolicy::Block))
+    ->ArgNames({"overflow"});
+
+static void BM_LogAsyncContended(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        StartAsyncLog({.Capacity = 1u << 16, .Overflow = LogOverflowPolicy::Block});
+    }
+    RunHotLoop(state);
+    if (state.thread_index() == 0) {
+        StopAsyncLog();
+    }
+}
+BENCHMARK(BM_LogAsyncContended)->Threads(4)->UseRealTime();
+
+/// 运行时级别过滤：ShouldLog 返回 false 的调用。
+static void BM_LogFilteredAtRuntime(benchmark::State& state) {
+    int frame = 0;
+    for (auto _ : state) {
+        LogFormat(LogLevel::Trace, "frame {} draw {}", frame, frame * 7);
+        ++frame;
+    }
+}
+BENCHMARK(BM_LogFilteredAtRuntime);
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+#if defined(_WIN32)
+    std::FILE* sink = std::freopen("NUL", "w", stdout);
+#else
+    std::FILE* sink = std::freopen("/dev/null", "w", stdout);
+#endif
+    if (sink == nullptr) {
+        std::cerr << "failed to redirect stdout, log output will interleave with the report" << std::endl;
+    }
+    benchmark::ConsoleReporter reporter;
+    reporter.SetOutputStream(&std::cerr);
+    reporter.SetErrorStream(&std::cerr);
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <radray/mesh_optimizer.h>
+#include <radray/triangle_mesh.h>
+#include <radray/types.h>
+#include <radray/wavefront_obj.h>
+
+using namespace radray;
+
+// 网格优化各步的耗时, 以及缓存大小 16 时优化前后的 ACMR / ATVR (counters)。range(0) 选输入:
+// 0 为三角形次序打乱、顶点全部展开的 512 x 512 网格, 1 为 256 段的 UV 球, 2 为 assets/buddha1.obj
+// (不存在时跳过)。单步的 before 是该步的输入 (已焊接, overdraw 另做过缓存重排), BM_OptimizeMesh 的
+// before 是未焊接的原始输入。
+
+namespace {
+
+enum class MeshCase : int64_t {
+    ShuffledGrid,
+    Sphere,
+    ObjAsset,
+};
+
+TriangleMesh MakeShuffledGridSoup(uint32_t side) {
+    vector<Eigen::Vector3f> positions;
+    for (uint32_t y = 0; y <= side; y++) {
+        for (uint32_t x = 0; x <= side; x++) {
+            positions.emplace_back(static_cast<float>(x), static_cast<float>(y), ((x * 7 + y * 3) % 17) * 0.01f);
+        }
+    }
+    vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y < side; y++) {
+        for (uint32_t x = 0; x < side; x++) {
+            const uint32_t a = y * (side + 1) + x;
+            const uint32_t c = a + side + 1;
+            triangles.push_back({a, a + 1, c + 1});
+            triangles.push_back({a, c + 1, c});
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937{11});
+    TriangleMesh mesh;
+    for (const auto& triangle : triangles) {
+        for (uint32_t index : triangle) {
+            mesh.Indices.push_back(static_cast<uint32_t>(mesh.Positions.size()));
+            mesh.Positions.push_back(positions[index]);
+        }
+    }
+    return mesh;
+}
+
+const TriangleMesh* GetMesh(MeshCase meshCase) {
+    static const TriangleMesh grid = MakeShuffledGridSoup(512);
+    static const TriangleMesh sphere = []() {
+        TriangleMesh mesh;
+        mesh.InitAsUVSphere(1.0f, 256);
+        return mesh;
+    }();
+    static const std::optional<TriangleMesh> asset = []() -> std::optional<TriangleMesh> {
+        const std::filesystem::path path{"assets/buddha1.obj"};
+        if (!std::filesystem::exists(path)) {
+            return std::nullopt;
+        }
+        WavefrontObjReader reader{path};
+        reader.Read();
+        if (reader.HasError()) {
+            return std::nullopt;
+        }
+        TriangleMesh mesh;
+        reader.ToTriangleMesh(&mesh);
+        return mesh;
+    }();
+    switch (meshCase) {
+        case MeshCase::ShuffledGrid: return &grid;
+        case MeshCase::Sphere: return &sphere;
+        case MeshCase::ObjAsset: return asset.has_value() ? &asset.value() : nullptr;
+    }
+    return nullptr;
+}
+
+void ReportCache(benchmark::State& state, const VertexCacheStatistics& before, const VertexCacheStatistics& after) {
+    state.counters["acmr_before"] = before.Acmr;
+    state.counters["acmr_after"] = after.Acmr;
+    state.counters["atvr_before"] = before.Atvr;
+    state.counters["atvr_after"] = after.Atvr;
+}
+
+/// 优化各步的前置: 焊接过、(按需) 做过缓存重排的副本。
+TriangleMesh PrepareInput(const TriangleMesh& source, bool cacheOptimized) {
+    TriangleMesh mesh = source;
+    WeldVertices(mesh);
+    if (cacheOptimized) {
+        OptimizeVertexCache(mesh.Indices, mesh.Positions.size());
+    }
+    return mesh;
+}
+
+}  // namespace
+
+static void BM_WeldVertices(benchmark::State& state) {
+    const TriangleMesh* source = GetMesh(static_cast<MeshCase>(state.range(0)));
+    if (source == nullptr) {
+        state.SkipWithError("assets/buddha1.obj not found");
+        return;
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        TriangleMesh mesh = *source;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(WeldVertices(mesh));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(source->Positions.size()));
+}
+
+static void BM_OptimizeVertexCache(benchmark::State& state) {
+    const TriangleMesh* source = GetMesh(static_cast<MeshCase>(state.range(0)));
+    if (source == nullptr) {
+        state.SkipWithError("assets/buddha1.obj not found");
+        return;
+    }
+    const TriangleMesh welded = PrepareInput(*source, false);
+    vector<uint32_t> indices;
+    for (auto _ : state) {
+        state.PauseTiming();
+        indices = welded.Indices;
+        state.ResumeTiming();
+        OptimizeVertexCache(indices, welded.Positions.size());
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(welded.Indices.size() / 3));
+    ReportCache(
+        state,
+        AnalyzeVertexCache(welded.Indices, welded.Positions.size()),
+        AnalyzeVertexCache(indices, welded.Positions.size()));
+}
+
+static void BM_OptimizeOverdraw(benchmark::State& state) {
+    const TriangleMesh* source = GetMesh(static_cast<MeshCase>(state.range(0)));
+    if (source == nullptr) {
+        state.SkipWithError("assets/buddha1.obj not found");
+        return;
+    }
+    const TriangleMesh cacheOptimized = PrepareInput(*source, true);
+    vector<uint32_t> indices;
+    for (auto _ : state) {
+        state.PauseTiming();
+        indices = cacheOptimized.Indices;
+        state.ResumeTiming();
+        OptimizeOverdraw(indices, cacheOptimized.Positions);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(cacheOptimized.Indices.size() / 3));
+    ReportCache(
+        state,
+        AnalyzeVertexCache(cacheOptimized.Indices, cacheOptimized.Positions.size()),
+        AnalyzeVertexCache(indices, cacheOptimized.Positions.size()));
+}
+
+static void BM_OptimizeMesh(benchmark::State& state) {
+    const TriangleMesh* source = GetMesh(static_cast<MeshCase>(state.range(0)));
+    if (source == nullptr) {
+        state.SkipWithError("assets/buddha1.obj not found");
+        return;
+    }
+    TriangleMesh mesh;
+    for (auto _ : state) {
+        state.PauseTiming();
+        mesh = *source;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(OptimizeMesh(mesh));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(source->Indices.size() / 3));
+    ReportCache(
+        state,
+        AnalyzeVertexCache(source->Indices, source->Positions.size()),
+        AnalyzeVertexCache(mesh.Indices, mesh.Positions.size()));
+}
+
+BENCHMARK(BM_WeldVertices)->DenseRange(0, 2)->ArgName("mesh")->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_OptimizeVertexCache)->DenseRange(0, 2)->ArgName("mesh")->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_OptimizeOverdraw)->DenseRange(0, 2)->ArgName("mesh")->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_OptimizeMesh)->DenseRange(0, 2)->ArgName("mesh")->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
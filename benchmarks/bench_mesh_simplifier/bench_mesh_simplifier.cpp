@@ -0,0 +1,121 @@
+#include <cmath>
+#include <filesystem>
+#include <optional>
+
+#include <benchmark/benchmark.h>
+
+#include <radray/mesh_optimizer.h>
+#include <radray/mesh_simplifier.h>
+#include <radray/triangle_mesh.h>
+#include <radray/types.h>
+#include <radray/wavefront_obj.h>
+
+using namespace radray;
+
+// QEM 简化与 LOD 链生成的吞吐, 按输入三角形数计。range(0) 选输入: 0 为 512 x 512 格、高度起伏的
+// 网格 (开放边界), 1 为 256 段的 UV 球, 2 为 assets/buddha1.obj (不存在时跳过); 输入都先焊接过。
+// BM_SimplifyMesh 的 range(1) 为保留的三角形百分比, counters 里是剩余三角形数与报出的误差。
+
+namespace {
+
+enum class MeshCase : int64_t {
+    Terrain,
+    Sphere,
+    ObjAsset,
+};
+
+TriangleMesh MakeTerrain(uint32_t side) {
+    TriangleMesh mesh;
+    for (uint32_t y = 0; y <= side; y++) {
+        for (uint32_t x = 0; x <= side; x++) {
+            const float fx = static_cast<float>(x), fy = static_cast<float>(y);
+            mesh.Positions.emplace_back(fx, fy, 8.0f * std::sin(fx * 0.05f) * std::cos(fy * 0.07f) + std::sin(fx * 0.9f + fy * 0.4f) * 0.3f);
+        }
+    }
+    for (uint32_t y = 0; y < side; y++) {
+        for (uint32_t x = 0; x < side; x++) {
+            const uint32_t a = y * (side + 1) + x;
+            const uint32_t c = a + side + 1;
+            mesh.Indices.insert(mesh.Indices.end(), {a, a + 1, c + 1, a, c + 1, c});
+        }
+    }
+    return mesh;
+}
+
+const TriangleMesh* GetMesh(MeshCase meshCase) {
+    static const TriangleMesh terrain = MakeTerrain(512);
+    static const TriangleMesh sphere = []() {
+        TriangleMesh mesh;
+        mesh.InitAsUVSphere(1.0f, 256);
+        WeldVertices(mesh);
+        return mesh;
+    }();
+    static const std::optional<TriangleMesh> asset = []() -> std::optional<TriangleMesh> {
+        const std::filesystem::path path{"assets/buddha1.obj"};
+        if (!std::filesystem::exists(path)) {
+            return std::nullopt;
+        }
+        WavefrontObjReader reader{path};
+        reader.Read();
+        if (reader.HasError()) {
+            return std::nullopt;
+        }
+        TriangleMesh mesh;
+        reader.ToTriangleMesh(&mesh);
+        WeldVertices(mesh);
+        return mesh;
+    }();
+    switch (meshCase) {
+        case MeshCase::Terrain: return &terrain;
+        case MeshCase::Sphere: return &sphere;
+        case MeshCase::ObjAsset: return asset.has_value() ? &asset.value() : nullptr;
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+static void BM_SimplifyMesh(benchmark::State& state) {
+    const TriangleMesh* mesh = GetMesh(static_cast<MeshCase>(state.range(0)));
+    if (mesh == nullptr) {
+        state.SkipWithError("assets/buddha1.obj not found");
+        return;
+    }
+    const size_t triangles = mesh->Indices.size() / 3;
+    const MeshSimplifyOptions options{.TargetIndexCount = triangles * static_cast<size_t>(state.range(1)) / 100 * 3};
+    MeshSimplifyResult result;
+    for (auto _ : state) {
+        result = SimplifyMesh(mesh->Indices, mesh->Positions, options);
+        benchmark::DoNotOptimize(result.Indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(triangles));
+    state.counters["triangles_out"] = static_cast<double>(result.Indices.size() / 3);
+    state.counters["error"] = result.Error;
+}
+BENCHMARK(BM_SimplifyMesh)
+    ->ArgsProduct({{0, 1, 2}, {50, 10, 1}})
+    ->ArgNames({"mesh", "keep_percent"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_GenerateMeshLods(benchmark::State& state) {
+    const TriangleMesh* source = GetMesh(static_cast<MeshCase>(state.range(0)));
+    if (source == nullptr) {
+        state.SkipWithError("assets/buddha1.obj not found");
+        return;
+    }
+    vector<MeshLodEntry> lods;
+    for (auto _ : state) {
+        state.PauseTiming();
+        TriangleMesh mesh = *source;
+        state.ResumeTiming();
+        lods = GenerateMeshLods(mesh);
+        benchmark::DoNotOptimize(lods.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(source->Indices.size() / 3));
+    state.counters["lods"] = static_cast<double>(lods.size());
+    state.counters["last_error"] = lods.empty() ? 0.0 : lods.back().Error;
+}
+BENCHMARK(BM_GenerateMeshLods)->DenseRange(0, 2)->ArgName("mesh")->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include <radray/mip_chain.h>
+#include <radray/types.h>
+
+using namespace radray;
+
+// 1K–8K 的 RGBA8 sRGB 贴图生成完整 mip 链。Legacy 是 mip_chain.h 之前 texture_asset.cpp 里的
+// 逐像素逐通道实现, 原样保留作基线; 其余各项走 BuildRgba8MipChain。
+
+namespace {
+
+float LegacySrgbToLinear(uint32_t value) noexcept {
+    const float normalized = static_cast<float>(value) / 255.0f;
+    return normalized <= 0.04045f
+               ? normalized / 12.92f
+               : std::pow((normalized + 0.055f) / 1.055f, 2.4f);
+}
+
+uint32_t LegacyLinearToSrgb(float value) noexcept {
+    const float encoded = value <= 0.0031308f
+                              ? value * 12.92f
+                              : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    return static_cast<uint32_t>(std::lround(std::clamp(encoded, 0.0f, 1.0f) * 255.0f));
+}
+
+vector<vector<byte>> LegacyBuildRgba8MipChain(std::span<const byte> rgba8, uint32_t width, uint32_t height, bool srgb) {
+    vector<vector<byte>> mipChain;
+    mipChain.emplace_back(rgba8.begin(), rgba8.end());
+    uint32_t sourceWidth = width;
+    uint32_t sourceHeight = height;
+    while (sourceWidth > 1 || sourceHeight > 1) {
+        const uint32_t destinationWidth = std::max(sourceWidth / 2, 1u);
+        const uint32_t destinationHeight = std::max(sourceHeight / 2, 1u);
+        const vector<byte>& source = mipChain.back();
+        vector<byte> destination(static_cast<size_t>(destinationWidth) * destinationHeight * 4);
+        for (uint32_t y = 0; y < destinationHeight; ++y) {
+            for (uint32_t x = 0; x < destinationWidth; ++x) {
+                float totals[4]{};
+                uint32_t sampleCount = 0;
+                for (uint32_t offsetY = 0; offsetY < 2; ++offsetY) {
+                    const uint32_t sourceY = y * 2 + offsetY;
+                    if (sourceY >= sourceHeight) {
+                        continue;
+                    }
+                    for (uint32_t offsetX = 0; offsetX < 2; ++offsetX) {
+                        const uint32_t sourceX = x * 2 + offsetX;
+                        if (sourceX >= sourceWidth) {
+                            continue;
+                        }
+                        const size_t sourceOffset = (static_cast<size_t>(sourceY) * sourceWidth + sourceX) * 4;
+                        for (size_t channel = 0; channel < 4; ++channel) {
+                            const uint32_t sample = std::to_integer<uint32_t>(source[sourceOffset + channel]);
+                            totals[channel] += srgb && channel < 3 ? LegacySrgbToLinear(sample) : static_cast<float>(sample);
+                        }
+                        ++sampleCount;
+                    }
+                }
+                const size_t destinationOffset = (static_cast<size_t>(y) * destinationWidth + x) * 4;
+                for (size_t channel = 0; channel < 4; ++channel) {
+                    const float average = totals[channel] / static_cast<float>(sampleCount);
+                    const uint32_t encoded = srgb && channel < 3 ? LegacyLinearToSrgb(average) : static_cast<uint32_t>(std::lround(average));
+                    destination[destinationOffset + channel] = static_cast<byte>(encoded);
+                }
+            }
+        }
+        mipChain.push_back(std::move(destination));
+        sourceWidth = destinationWidth;
+        sourceHeight = destinationHeight;
+    }
+    return mipChain;
+}
+
+vector<byte> MakeNoise(uint32_t size) {
+    std::mt19937 random{size};
+    vector<byte> pixels(size_t{size} * size * 4);
+    for (byte& value : pixels) {
+        value = static_cast<byte>(random() & 0xff);
+    }
+    return pixels;
+}
+
+/// 每次调用起 hardware_concurrency 个线程抢带号, 近似 AssetDecodePool::ParallelFor 的分发。
+void ThreadParallelFor(uint32_t count, const std::function<void(uint32_t)>& body) {
+    std::atomic<uint32_t> next{0};
+    const uint32_t threadCount = std::min(std::max(std::thread::hardware_concurrency(), 1u), count);
+    vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&]() {
+            for (uint32_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                body(i);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+enum class MipVariant : int64_t {
+    Legacy,
+    Box,
+    BoxParallel,
+    Kaiser,
+    KaiserParallel,
+};
+
+}  // namespace
+
+/// range(0) 为边长, range(1) 为 MipVariant。吞吐按 level 0 的字节数计。
+static void BM_BuildSrgbMipChain(benchmark::State& state) {
+    const auto size = static_cast<uint32_t>(state.range(0));
+    const auto variant = static_cast<MipVariant>(state.range(1));
+    const vector<byte> pixels = MakeNoise(size);
+    MipChainOptions options{
+        .Srgb = true,
+        .Filter = variant == MipVariant::Kaiser || variant == MipVariant::KaiserParallel ? MipFilter::Kaiser : MipFilter::Box};
+    if (variant == MipVariant::BoxParallel || variant == MipVariant::KaiserParallel) {
+        options.ParallelFor = ThreadParallelFor;
+    }
+    for (auto _ : state) {
+        if (variant == MipVariant::Legacy) {
+            vector<vector<byte>> chain = LegacyBuildRgba8MipChain(pixels, size, size, true);
+            benchmark::DoNotOptimize(chain.back().data());
+        } else {
+            Rgba8MipChain chain = BuildRgba8MipChain(pixels, size, size, options);
+            benchmark::DoNotOptimize(chain.GetBytes().data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(pixels.size()));
+}
+BENCHMARK(BM_BuildSrgbMipChain)
+    ->ArgsProduct({
+        {1024, 2048, 4096, 8192},
+        {static_cast<int64_t>(MipVariant::Legacy),
+         static_cast<int64_t>(MipVariant::Box),
+         static_cast<int64_t>(MipVariant::BoxParallel),
+         static_cast<int64_t>(MipVariant::Kaiser),
+         static_cast<int64_t>(MipVariant::KaiserParallel)}})
+    ->ArgNames({"size", "variant"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include <radray/image_data.h>
+#include <radray/pixel_convert.h>
+#include <radray/types.h>
+
+using namespace radray;
+
+// 1K–8K 贴图的像素格式转换。Legacy 是 pixel_convert.h 之前 ImageData::RGB8ToRGBA8 与 FlipY 的
+// 逐字节实现, 原样保留作基线 (先转出一份新图, 再逐行交换翻转); Scalar / Simd 分别走
+// ConvertPixelsScalar 与 ConvertPixels, FlipY 折在同一趟里。
+
+namespace {
+
+ImageData LegacyRgb8ToRgba8(const ImageData& image, uint8_t alpha_) {
+    ImageData dstImg;
+    dstImg.Width = image.Width;
+    dstImg.Height = image.Height;
+    dstImg.Format = ImageFormat::RGBA8_BYTE;
+    dstImg.Data = make_unique<byte[]>(dstImg.GetSize());
+
+    const size_t row = static_cast<size_t>(image.Width);
+    const size_t srcStride = row * 3;
+    const size_t dstStride = row * 4;
+    byte a_ = static_cast<byte>(alpha_);
+    const byte* src_ = image.Data.get();
+    byte* dst_ = dstImg.Data.get();
+    for (size_t j = 0; j < image.Height; j++, src_ += srcStride, dst_ += dstStride) {
+        const byte* src = src_;
+        byte* dst = dst_;
+        for (size_t i = 0; i < row; i++, src += 3, dst += 4) {
+            byte r = src[0], g = src[1], b = src[2], a = a_;
+            dst[0] = r, dst[1] = g, dst[2] = b, dst[3] = a;
+        }
+    }
+    return dstImg;
+}
+
+void LegacyFlipY(ImageData& image) {
+    const size_t rowBytes = ImageData::FormatSize(image.Format) * static_cast<size_t>(image.Width);
+    byte* dataPtr = image.Data.get();
+    for (size_t y = 0; y < image.Height / 2; ++y) {
+        byte* rowTop = dataPtr + y * rowBytes;
+        byte* rowBottom = dataPtr + (image.Height - 1 - y) * rowBytes;
+        std::swap_ranges(rowTop, rowTop + rowBytes, rowBottom);
+    }
+}
+
+ImageData MakeNoise(ImageFormat format, uint32_t size) {
+    std::mt19937 random{7};
+    ImageData image;
+    image.Width = size;
+    image.Height = size;
+    image.Format = format;
+    image.Data = make_unique<byte[]>(image.GetSize());
+    const bool isFloat = format == ImageFormat::RGBA32_FLOAT;
+    const size_t bytes = image.GetSize();
+    for (size_t i = 0; i < bytes; i += 4) {
+        if (isFloat) {
+            const float v = static_cast<float>(random() & 0xffff) / 65535.0f;
+            std::memcpy(image.Data.get() + i, &v, 4);
+        } else {
+            const uint32_t v = static_cast<uint32_t>(random());
+            std::memcpy(image.Data.get() + i, &v, 4);
+        }
+    }
+    return image;
+}
+
+enum class ConvertVariant : int64_t {
+    Legacy,
+    Scalar,
+    Simd,
+};
+
+/// BM_ConvertPixels 的转换组合。
+struct ConvertCase {
+    ImageFormat From;
+    ImageFormat To;
+    bool Premultiply;
+};
+
+constexpr ConvertCase kCases[] = {
+    {ImageFormat::R8_BYTE, ImageFormat::RGBA8_BYTE, false},
+    {ImageFormat::RG8_BYTE, ImageFormat::RGBA8_BYTE, false},
+    {ImageFormat::RGBA16_USHORT, ImageFormat::RGBA8_BYTE, false},
+    {ImageFormat::RGB16_USHORT, ImageFormat::RGBA8_BYTE, false},
+    {ImageFormat::RGBA16_HALF, ImageFormat::RGBA32_FLOAT, false},
+    {ImageFormat::RGBA32_FLOAT, ImageFormat::RGBA16_HALF, false},
+    {ImageFormat::RGBA8_BYTE, ImageFormat::RGBA8_BYTE, true},
+};
+
+}  // namespace
+
+/// range(0) 为边长, range(1) 为 ConvertVariant。RGB8 -> RGBA8 并翻转, 吞吐按目标字节数计。
+static void BM_Rgb8ToRgba8FlipY(benchmark::State& state) {
+    const auto size = static_cast<uint32_t>(state.range(0));
+    const auto variant = static_cast<ConvertVariant>(state.range(1));
+    const ImageData source = MakeNoise(ImageFormat::RGB8_BYTE, size);
+    const size_t dstBytes = size_t{size} * size * 4;
+    vector<byte> destination(dstBytes);
+    for (auto _ : state) {
+        if (variant == ConvertVariant::Legacy) {
+            ImageData converted = LegacyRgb8ToRgba8(source, 0xff);
+            LegacyFlipY(converted);
+            benchmark::DoNotOptimize(converted.Data.get());
+        } else {
+            const auto convert = variant == ConvertVariant::Scalar ? ConvertPixelsScalar : ConvertPixels;
+            convert(ImageFormat::RGB8_BYTE, source.GetSpan(), ImageFormat::RGBA8_BYTE, destination, size, size, {.FlipY = true});
+            benchmark::DoNotOptimize(destination.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(dstBytes));
+}
+BENCHMARK(BM_Rgb8ToRgba8FlipY)
+    ->ArgsProduct({
+        {1024, 4096, 8192},
+        {static_cast<int64_t>(ConvertVariant::Legacy),
+         static_cast<int64_t>(ConvertVariant::Scalar),
+         static_cast<int64_t>(ConvertVariant::Simd)}})
+    ->ArgNames({"size", "variant"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+/// range(0) 为边长, range(1) 为 kCases 下标, range(2) 为 ConvertVariant (Scalar / Simd)。吞吐按目标字节数计。
+static void BM_ConvertPixels(benchmark::State& state) {
+    const auto size = static_cast<uint32_t>(state.range(0));
+    const ConvertCase& c = kCases[state.range(1)];
+    const auto variant = static_cast<ConvertVariant>(state.range(2));
+    const ImageData source = MakeNoise(c.From, size);
+    const size_t dstBytes = ImageData::FormatSize(c.To) * size * size;
+    vector<byte> destination(dstBytes);
+    const auto convert = variant == ConvertVariant::Scalar ? ConvertPixelsScalar : ConvertPixels;
+    for (auto _ : state) {
+        convert(c.From, source.GetSpan(), c.To, destination, size, size, {.PremultiplyAlpha = c.Premultiply});
+        benchmark::DoNotOptimize(destination.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(dstBytes));
+}
+BENCHMARK(BM_ConvertPixels)
+    ->ArgsProduct({
+        {4096},
+        benchmark::CreateDenseRange(0, static_cast<int64_t>(std::size(kCases)) - 1, 1),
+        {static_cast<int64_t>(ConvertVariant::Scalar), static_cast<int64_t>(ConvertVariant::Simd)}})
+    ->ArgNames({"size", "case", "variant"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -1,5 +1,12 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <new>
+#include <sstream>
+#include <thread>
 
 #include <benchmark/benchmark.h>
 
@@ -8,32 +15,172 @@
 
 using namespace radray;
 
-static string obj_data;
+// OBJ 解析: Text 把整份文本交给 reader (单线程, 含一次复制); Mapped 按路径内存映射,
+// range(0) 个线程分块解析, 1 表示不分块。peak_heap_MB 是一次 Read 期间 operator new 的在用字节峰值,
+// 不含映射的文件页。assets/buddha1.obj 不存在时生成一份 200 万面的网格代替。
 
-static void ReadObjFileOnce() {
+namespace {
+
+std::atomic<int64_t> g_liveBytes{0};
+std::atomic<int64_t> g_peakBytes{0};
+
+/// 记录在用字节数的全局分配。头部 16 字节存大小。
+void* CountedAlloc(size_t size) {
+    void* raw = std::malloc(size + 16);
+    if (raw == nullptr) {
+        throw std::bad_alloc{};
+    }
+    *static_cast<size_t*>(raw) = size;
+    const int64_t live = g_liveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+    int64_t peak = g_peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !g_peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    return static_cast<char*>(raw) + 16;
+}
+
+void CountedFree(void* ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    void* raw = static_cast<char*>(ptr) - 16;
+    g_liveBytes.fetch_sub(static_cast<int64_t>(*static_cast<size_t*>(raw)), std::memory_order_relaxed);
+    std::free(raw);
+}
+
+int64_t ResetPeak() noexcept {
+    const int64_t live = g_liveBytes.load(std::memory_order_relaxed);
+    g_peakBytes.store(live, std::memory_order_relaxed);
+    return live;
+}
+
+const std::filesystem::path kAssetPath{"assets/buddha1.obj"};
+
+std::filesystem::path g_objPath;
+string g_objText;
+
+/// side x side 的顶点网格, 每格两个三角形。
+string MakeGridObj(int side) {
+    std::ostringstream ss;
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            ss << "v " << x * 0.01f << ' ' << y * 0.01f << ' ' << ((x * 7 + y * 3) % 17) * 0.001f << '\n';
+        }
+    }
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            ss << "vn 0.0 0.0 1.0\n";
+        }
+    }
+    for (int y = 0; y + 1 < side; y++) {
+        for (int x = 0; x + 1 < side; x++) {
+            const int a = y * side + x + 1;
+            const int b = a + 1;
+            const int c = a + side;
+            const int d = c + 1;
+            ss << "f " << a << "//" << a << ' ' << b << "//" << b << ' ' << d << "//" << d << '\n';
+            ss << "f " << a << "//" << a << ' ' << d << "//" << d << ' ' << c << "//" << c << '\n';
+        }
+    }
+    return ss.str();
+}
+
+void LoadObjOnce() {
     static bool loaded = false;
-    if (!loaded) {
-        std::ifstream file("assets/buddha1.obj", std::ios::in | std::ios::binary);
-        std::ostringstream ss;
-        ss << file.rdbuf();
-        obj_data = ss.str();
-        loaded = true;
-
-        radray::WavefrontObjReader reader{obj_data};
-        reader.Read();
-        std::cout << "=========================================" << std::endl;
-        std::cout << "f:" << reader.Positions().size() << " f:" << reader.Faces().size() << std::endl;
-        std::cout << "=========================================" << std::endl;
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+    g_objPath = kAssetPath;
+    if (!std::filesystem::exists(g_objPath)) {
+        g_objPath = std::filesystem::temp_directory_path() / "radray_bench_read_obj.obj";
+        std::ofstream out{g_objPath, std::ios::binary | std::ios::trunc};
+        out << MakeGridObj(1001);
+    }
+    std::ifstream file(g_objPath, std::ios::in | std::ios::binary);
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    g_objText = ss.str();
+
+    WavefrontObjReader reader{g_objPath};
+    reader.Read();
+    std::cout << "=========================================" << std::endl;
+    std::cout << g_objPath.string() << " v:" << reader.Positions().size() << " f:" << reader.Faces().size() << std::endl;
+    std::cout << "=========================================" << std::endl;
+}
+
+/// 每次调用开 min(count, threads) 个线程领取下标。
+WavefrontObjReadOptions MakeReadOptions(uint32_t threads) {
+    WavefrontObjReadOptions options{};
+    if (threads <= 1) {
+        return options;
     }
+    options.ParallelFor = [threads](uint32_t count, const std::function<void(uint32_t)>& body) {
+        std::atomic<uint32_t> next{0};
+        const auto worker = [&next, &body, count]() {
+            for (uint32_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                body(i);
+            }
+        };
+        vector<std::thread> helpers;
+        for (uint32_t t = 1; t < std::min(count, threads); t++) {
+            helpers.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& helper : helpers) {
+            helper.join();
+        }
+    };
+    // 块数取线程数的 4 倍, 让行长不均的文件也能摊平。
+    options.MinChunkBytes = std::max<size_t>(g_objText.size() / (threads * 4), 1 << 16);
+    return options;
 }
 
-static void BM_ReadObj(benchmark::State& state) {
-    ReadObjFileOnce();
-    for (auto e : state) {
-        radray::WavefrontObjReader reader{obj_data};
+}  // namespace
+
+void* operator new(size_t size) { return CountedAlloc(size); }
+void* operator new[](size_t size) { return CountedAlloc(size); }
+void operator delete(void* ptr) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr) noexcept { CountedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { CountedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { CountedFree(ptr); }
+
+static void BM_ReadObjText(benchmark::State& state) {
+    LoadObjOnce();
+    int64_t peak = 0;
+    for (auto _ : state) {
+        const int64_t base = ResetPeak();
+        WavefrontObjReader reader{g_objText};
         reader.Read();
         benchmark::DoNotOptimize(reader);
+        peak = std::max(peak, g_peakBytes.load(std::memory_order_relaxed) - base);
     }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(g_objText.size()));
+    state.counters["peak_heap_MB"] = static_cast<double>(peak) / (1024.0 * 1024.0);
 }
-BENCHMARK(BM_ReadObj);
+BENCHMARK(BM_ReadObjText)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_ReadObjMapped(benchmark::State& state) {
+    LoadObjOnce();
+    const WavefrontObjReadOptions options = MakeReadOptions(static_cast<uint32_t>(state.range(0)));
+    int64_t peak = 0;
+    for (auto _ : state) {
+        const int64_t base = ResetPeak();
+        WavefrontObjReader reader{g_objPath};
+        reader.Read(options);
+        benchmark::DoNotOptimize(reader);
+        peak = std::max(peak, g_peakBytes.load(std::memory_order_relaxed) - base);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(g_objText.size()));
+    state.counters["peak_heap_MB"] = static_cast<double>(peak) / (1024.0 * 1024.0);
+}
+BENCHMARK(BM_ReadObjMapped)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Arg(static_cast<int64_t>(std::max(1u, std::thread::hardware_concurrency())))
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
 BENCHMARK_MAIN();
@@ -85,13 +85,13 @@ protected:
             groups.ViewGroup,
             groups.MaterialGroup,
             groups.ObjectGroup};
-        const shader::KeywordAssignment assignment{
-            .Name = "QUALITY",
-            .Value = "high"};
+        const shader::KeywordAssignment assignments[]{
+            {.Name = "QUALITY", .Value = "high"},
+            {.Name = "VERTEX_FORMAT", .Value = "float"}};
         const Nullable<ShaderProgram*> program =
             GetRenderSystem()->GetOrCreateShaderProgram(
                 "pipelines/forward/forward.hlsl",
-                std::span{&assignment, 1},
+                assignments,
                 render::ShaderLayoutPolicy{
                     .DynamicBufferGroups = dynamicGroups});
         if (!program.HasValue()) {
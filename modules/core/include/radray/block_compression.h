@@ -0,0 +1,89 @@
+#pragma once
+
+#include <optional>
+#include <span>
+
+#include <radray/image_data.h>
+#include <radray/mip_chain.h>
+#include <radray/types.h>
+
+// RGBA8 到 BC1 / BC3 / BC4 / BC5 / BC7 的 CPU 块压缩, 以及对应的解码(测试与质量评估用)。
+
+namespace radray {
+
+enum class BlockFormat : uint8_t {
+    /// RGB 5:6:5 两端点 + 2 bit 索引, 8 字节/块。忽略 alpha, 总是 4 色模式。
+    BC1,
+    /// BC1 颜色块 + BC4 式 alpha 块, 16 字节/块。
+    BC3,
+    /// 单通道 (R), 8 字节/块。
+    BC4,
+    /// R、G 各一个 BC4 块, 16 字节/块。切线空间法线用。
+    BC5,
+    /// 16 字节/块。【只产出 mode 6】: 单分区 RGBA, 7+1 bit 端点, 4 bit 索引。
+    BC7,
+};
+
+uint32_t GetBlockFormatBytes(BlockFormat format) noexcept;
+
+/// width x height 像素向上取整到 4x4 块后的字节数。
+size_t GetBlockCompressedSize(BlockFormat format, uint32_t width, uint32_t height) noexcept;
+
+/// 把紧密排列的 RGBA8 像素压缩进 destination, 其大小须等于 GetBlockCompressedSize。
+/// 不满 4x4 的边缘块重复边缘像素补齐。parallelFor 非空时按块行分带并行, 结果与串行逐字节一致。
+/// 尺寸不符时返回 false。sRGB 数据直接在编码空间里压缩, 与 GPU 的 *_SRGB 块格式一致。
+bool CompressRgba8Blocks(
+    std::span<const byte> rgba8,
+    uint32_t width,
+    uint32_t height,
+    BlockFormat format,
+    std::span<byte> destination,
+    const MipParallelFor& parallelFor = {});
+
+/// 把块数据解回 RGBA8。BC4 解为 (r, 0, 0, 255), BC5 解为 (r, g, 0, 255)。
+/// BC7 只认本编码器产出的 mode 6: 遇到其它 mode 时该块写 0 并最终返回 false。
+bool DecompressBlocksToRgba8(
+    std::span<const byte> blocks,
+    uint32_t width,
+    uint32_t height,
+    BlockFormat format,
+    std::span<byte> destination);
+
+/// 单级压缩。image 须是 RGBA8_BYTE(其它格式先经 ConvertToRGBA8), 否则返回 nullopt。
+std::optional<vector<byte>> CompressImage(const ImageData& image, BlockFormat format, const MipParallelFor& parallelFor = {});
+
+/// 与 Rgba8MipChain 同构的块压缩 mip 链: 一次分配, 各级从大到小紧接排列。
+/// 小于 4 的 mip 仍占一整块, 与 GPU 的布局一致。
+class BlockCompressedMipChain {
+public:
+    BlockCompressedMipChain() noexcept = default;
+
+    /// 分配 levelCount 级的存储, 内容未初始化。levelCount 超出完整链长时截断。
+    static BlockCompressedMipChain Allocate(BlockFormat format, uint32_t width, uint32_t height, uint32_t levelCount);
+
+    /// 逐级压缩。mips 为空时返回空链。
+    static BlockCompressedMipChain Compress(const Rgba8MipChain& mips, BlockFormat format, const MipParallelFor& parallelFor = {});
+
+    bool IsEmpty() const noexcept { return _levelCount == 0; }
+    BlockFormat GetFormat() const noexcept { return _format; }
+    uint32_t GetWidth() const noexcept { return _width; }
+    uint32_t GetHeight() const noexcept { return _height; }
+    uint32_t GetLevelCount() const noexcept { return _levelCount; }
+    uint32_t GetLevelWidth(uint32_t level) const noexcept { return std::max(_width >> level, 1u); }
+    uint32_t GetLevelHeight(uint32_t level) const noexcept { return std::max(_height >> level, 1u); }
+    size_t GetLevelOffset(uint32_t level) const noexcept;
+
+    std::span<const byte> GetLevel(uint32_t level) const noexcept;
+    std::span<byte> GetLevel(uint32_t level) noexcept;
+    std::span<const byte> GetBytes() const noexcept { return {_data.get(), _size}; }
+
+private:
+    unique_ptr<byte[]> _data;
+    size_t _size{0};
+    BlockFormat _format{BlockFormat::BC1};
+    uint32_t _width{0};
+    uint32_t _height{0};
+    uint32_t _levelCount{0};
+};
+
+}  // namespace radray
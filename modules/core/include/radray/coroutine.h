@@ -2,36 +2,274 @@
 
 // Coroutine support for RadRay, layered on stdexec (P2300 sender/receiver).
 //
-// Business code should use the radray aliases and helpers from this file
-// instead of depending on exec::task / stdexec::* directly. That keeps the
+// Business code should use radray::task and the helpers from this file
+// instead of depending on exec::* / stdexec::* directly. That keeps the
 // stdexec dependency behind a small facade.
 
 #include <concepts>
 #include <coroutine>
+#include <exception>
 #include <optional>
 #include <type_traits>
 #include <utility>
 
 #include <exec/async_scope.hpp>
-#include <exec/task.hpp>
 #include <stdexec/execution.hpp>
 
 #include <radray/types.h>
 
 namespace radray {
 
-template <class T>
-using task = exec::task<T>;
-
 using stop_source = stdexec::inplace_stop_source;
 using stop_token = stdexec::inplace_stop_token;
 
+/// 从协程 promise 的 env 里取 stop token。
+///
+/// 【为何需要它】: `co_await CurrentStopToken()` 只能在协程体里用, 而手写 awaitable 的
+/// await_suspend 拿到的只是一个 coroutine_handle —— 那里正是最需要 stop token 的地方
+/// (要把它记进等待记录, 以便取消时能恢复协程)。
+///
+/// promise 不提供 stop token (含类型擦除的 coroutine_handle<>) 或只提供不可停止的 token 时返回
+/// 默认构造的 token, 其 stop_requested() 恒为 false —— 即"不可取消", 这是对"没有取消源"唯一安全的解释。
+template <class Promise>
+stop_token GetCoroutineStopToken(std::coroutine_handle<Promise> handle) noexcept {
+    if constexpr (std::is_void_v<Promise>) {
+        (void)handle;
+        return stop_token{};
+    } else if constexpr (requires { stdexec::get_stop_token(stdexec::get_env(handle.promise())); }) {
+        using Token = decltype(stdexec::get_stop_token(stdexec::get_env(handle.promise())));
+        if constexpr (std::convertible_to<Token, stop_token>) {
+            return stdexec::get_stop_token(stdexec::get_env(handle.promise()));
+        } else if constexpr (stdexec::unstoppable_token<Token>) {
+            // 例如 sync_wait 的 env: 本来就不会被取消。
+            (void)handle;
+            return stop_token{};
+        } else {
+            []<bool kSupported = false>() {
+                static_assert(kSupported, "radray coroutines only propagate inplace_stop_token");
+            }();
+        }
+    } else {
+        (void)handle;
+        return stop_token{};
+    }
+}
+
+/// 协程帧按 kCoroutineFrameGranularity 字节分级, 每级在线程本地空闲链表里缓存。
+/// 超过 kMaxPooledCoroutineFrameSize 的帧直接走 operator new / delete。
+inline constexpr size_t kCoroutineFrameGranularity = 64;
+inline constexpr size_t kMaxPooledCoroutineFrameSize = 2048;
+
+/// 帧可以在别的线程上释放: 它进入释放线程的缓存, 之后由那个线程复用。
+[[nodiscard]] void* AllocateCoroutineFrame(size_t size);
+void FreeCoroutineFrame(void* frame, size_t size) noexcept;
+
+/// 当前线程缓存着的空闲帧数。
+size_t GetCachedCoroutineFrameCount() noexcept;
+
+template <class T>
+class task;
+
+namespace detail {
+
+template <class T>
+class TaskResult {
+public:
+    template <class U = T>
+    requires std::convertible_to<U&&, T>
+    void return_value(U&& value) {
+        _value.emplace(std::forward<U>(value));
+    }
+
+    void unhandled_exception() noexcept {
+        _exception = std::current_exception();
+    }
+
+    T TakeResult() {
+        if (_exception) {
+            std::rethrow_exception(std::move(_exception));
+        }
+        return std::move(*_value);
+    }
+
+private:
+    std::optional<T> _value;
+    std::exception_ptr _exception;
+};
+
+template <>
+class TaskResult<void> {
+public:
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept {
+        _exception = std::current_exception();
+    }
+
+    void TakeResult() {
+        if (_exception) {
+            std::rethrow_exception(std::move(_exception));
+        }
+    }
+
+private:
+    std::exception_ptr _exception;
+};
+
+struct TaskFinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    /// 对称转移回等待者, 深层 co_await 链不会压栈。
+    template <class Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        return handle.promise().Continuation;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+/// co_await sender 与取消 (set_stopped 沿 continuation 链上传) 由 with_awaitable_senders 提供;
+/// 这里只加帧分配、结果存储和 env。
+template <class T>
+class TaskPromise : public stdexec::with_awaitable_senders<TaskPromise<T>>, public TaskResult<T> {
+public:
+    static void* operator new(size_t size) {
+        return AllocateCoroutineFrame(size);
+    }
+
+    static void operator delete(void* frame, size_t size) noexcept {
+        FreeCoroutineFrame(frame, size);
+    }
+
+    task<T> get_return_object() noexcept {
+        return task<T>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    TaskFinalAwaiter final_suspend() noexcept { return {}; }
+
+    auto get_env() const noexcept {
+        return stdexec::prop{stdexec::get_stop_token, Stop};
+    }
+
+    /// 由等待者在 await_suspend 里写入: stop token 继承自等待者的 env。
+    stop_token Stop;
+    std::coroutine_handle<> Continuation{};
+};
+
+}  // namespace detail
+
+/// 惰性启动的协程 task, 帧经 AllocateCoroutineFrame 池化。
+///
+/// 可以 co_await 的类型在 stdexec 里自动是 sender, 所以 task 能直接交给 TaskScope::Spawn、
+/// write_env、stopped_as_optional 等算法。
+///
+/// 【线程约定: 不做调度器亲和】: co_await 之后, 协程在恢复它的那个线程上继续 —— 等 sender 时是
+/// 完成它的线程, 等手写 awaitable 时是调用 resume() 的线程; task 自己从不切换线程。exec::task
+/// 的亲和要靠 env 里的 get_scheduler, 而 TaskScope::Spawn 的 env 不提供调度器, 所以原先 spawn
+/// 出的 task 也是就地继续。
+///
+/// 【因此主线程约定由恢复方保证】: ManualCoroutineScheduler 的记录、AssetManager 的等待者与
+/// AssetDecodePool 的完成都只在主线程的 Pump 里 ResumeRecord; 工作线程只负责把结果放回队列。
+/// 新写的 awaitable 必须照做 —— 在工作线程上直接 resume 业务协程, 其后的代码就跑在那个工作线程上。
+template <class T>
+class [[nodiscard]] task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    task(task&& other) noexcept
+        : _handle(std::exchange(other._handle, {})) {}
+
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            Destroy();
+            _handle = std::exchange(other._handle, {});
+        }
+        return *this;
+    }
+
+    ~task() noexcept { Destroy(); }
+
+    class Awaiter {
+    public:
+        explicit Awaiter(std::coroutine_handle<promise_type> handle) noexcept
+            : _handle(handle) {}
+        Awaiter(const Awaiter&) = delete;
+        Awaiter& operator=(const Awaiter&) = delete;
+
+        Awaiter(Awaiter&& other) noexcept
+            : _handle(std::exchange(other._handle, {})) {}
+
+        Awaiter& operator=(Awaiter&&) = delete;
+
+        /// 被取消时等待者的帧连同这里持有的子帧一起销毁。
+        ~Awaiter() noexcept {
+            if (_handle) {
+                _handle.destroy();
+            }
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        template <class ParentPromise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<ParentPromise> parent) noexcept {
+            promise_type& promise = _handle.promise();
+            promise.Stop = GetCoroutineStopToken(parent);
+            promise.Continuation = parent;
+            if constexpr (!std::is_void_v<ParentPromise>) {
+                promise.set_continuation(parent);
+            }
+            return _handle;
+        }
+
+        T await_resume() {
+            return _handle.promise().TakeResult();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+    Awaiter operator co_await() && noexcept {
+        return Awaiter{std::exchange(_handle, {})};
+    }
+
+private:
+    friend promise_type;
+
+    explicit task(std::coroutine_handle<promise_type> handle) noexcept
+        : _handle(handle) {}
+
+    void Destroy() noexcept {
+        if (_handle) {
+            _handle.destroy();
+            _handle = {};
+        }
+    }
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
 struct ManualCoroutineRecord {
     std::coroutine_handle<> Continuation{};
     stop_token Stop;
+    /// 每次 Enqueue 重新分配。低 32 位是记录所在的槽位下标, 高 32 位是该槽位的代数,
+    /// 调度器据此从记录找回 Entry, 不需要另一张表。
+    /// 【记录的存储会被复用】: 恢复协程后要判断 "还是不是那一次等待" 须用 IsAlive(record, ticket),
+    /// 只比指针会把复用了同一 Entry 的新等待认成旧的。
+    uint64_t Ticket{0};
     bool Canceled{false};
 };
 
+/// 手动泵的协程等待队列。记录按入队顺序排列, Front / Next 按这个顺序遍历。
+///
+/// 【摘除是 O(1)】: 活动记录串成侵入式双链表, Entry 按下标放在槽位表里, 记录的 Ticket 带着
+/// 下标与代数。Erase / Next 从 Ticket 直接找到 Entry; IsAlive 只用调用方给的 ticket 查槽位,
+/// 不解引用可能已释放的记录。稳态下 Enqueue / Erase 都不分配。
 template <class TRecord>
 requires std::derived_from<TRecord, ManualCoroutineRecord>
 class ManualCoroutineScheduler {
@@ -48,63 +286,80 @@ public:
 
     template <class... Args>
     TRecord* Enqueue(stop_token stop, std::coroutine_handle<> continuation, Args&&... args) {
-        auto entry = make_unique<Entry>(std::forward<Args>(args)...);
-        TRecord* record = &entry->Record;
+        Entry* entry = AcquireEntry();
+        Slot& slot = _slots[entry->Index];
+        TRecord* record;
+        try {
+            record = &entry->Record.emplace(std::forward<Args>(args)...);
+        } catch (...) {
+            ReleaseEntry(entry);
+            throw;
+        }
+        ++slot.Generation;
         record->Continuation = continuation;
         record->Stop = stop;
+        record->Ticket = (uint64_t{slot.Generation} << 32) | entry->Index;
         record->Canceled = false;
-        _records.emplace_back(std::move(entry));
+        LinkBack(entry);
+        ++_count;
 
         if (stop.stop_requested()) {
             record->Canceled = true;
         } else if (stop.stop_possible()) {
-            _records.back()->StopCallback.emplace(stop, StopCallback{this, record});
+            entry->StopCallback.emplace(stop, StopCallback{this, record});
         }
         return record;
     }
 
+    /// 【record 必须仍在队列中】: 不确定时先用 IsAlive(record, ticket) 判断。
     bool Erase(TRecord* record) noexcept {
-        for (size_t i = 0; i < _records.size(); ++i) {
-            if (&_records[i]->Record == record) {
-                _records[i]->StopCallback.reset();
-                _records.erase(_records.begin() + static_cast<ptrdiff_t>(i));
-                return true;
-            }
+        Entry* entry = FindEntry(record);
+        if (entry == nullptr) {
+            return false;
         }
-        return false;
+        entry->StopCallback.reset();
+        Unlink(entry);
+        --_count;
+        ReleaseEntry(entry);
+        return true;
     }
 
-    bool IsAlive(TRecord* record) const noexcept {
-        for (const unique_ptr<Entry>& entry : _records) {
-            if (&entry->Record == record) {
-                return true;
-            }
+    /// record 仍在队列中且仍是 ticket 那一次等待。只读槽位表, record 已释放也可以调用。
+    bool IsAlive(TRecord* record, uint64_t ticket) const noexcept {
+        const uint32_t index = static_cast<uint32_t>(ticket);
+        if (index >= _slots.size()) {
+            return false;
         }
-        return false;
-    }
-
-    TRecord* At(size_t index) noexcept {
-        return index < _records.size() ? &_records[index]->Record : nullptr;
-    }
-
-    const TRecord* At(size_t index) const noexcept {
-        return index < _records.size() ? &_records[index]->Record : nullptr;
+        const Entry* entry = _slots[index].Owned.get();
+        return entry != nullptr &&
+               entry->Record.has_value() &&
+               &*entry->Record == record &&
+               entry->Record->Ticket == ticket;
     }
 
     TRecord* Front() noexcept {
-        return _records.empty() ? nullptr : &_records.front()->Record;
+        return _head == nullptr ? nullptr : &*_head->Record;
     }
 
     TRecord* Back() noexcept {
-        return _records.empty() ? nullptr : &_records.back()->Record;
+        return _tail == nullptr ? nullptr : &*_tail->Record;
+    }
+
+    /// 入队顺序里 record 的下一条; record 是最后一条时返回 nullptr。record 必须仍在队列中。
+    TRecord* Next(TRecord* record) noexcept {
+        Entry* entry = FindEntry(record);
+        if (entry == nullptr || entry->Next == nullptr) {
+            return nullptr;
+        }
+        return &*entry->Next->Record;
     }
 
     size_t Count() const noexcept {
-        return _records.size();
+        return _count;
     }
 
     bool Empty() const noexcept {
-        return _records.empty();
+        return _count == 0;
     }
 
     void ResumeRecord(TRecord* record) noexcept {
@@ -127,16 +382,22 @@ public:
     }
 
     void CancelAll() noexcept {
-        while (!_records.empty()) {
+        while (!Empty()) {
             TRecord* record = Back();
+            const uint64_t ticket = record->Ticket;
             record->Canceled = true;
             ResumeRecord(record);
-            if (IsAlive(record)) {
+            if (IsAlive(record, ticket)) {
                 Erase(record);
             }
         }
     }
 
+    /// 空闲链表里缓存的 Entry 数。
+    size_t FreeEntryCount() const noexcept {
+        return _freeCount;
+    }
+
 private:
     struct StopCallback {
         ManualCoroutineScheduler* Scheduler{nullptr};
@@ -151,16 +412,99 @@ private:
 
     using StopCallbackStorage = stop_token::template callback_type<StopCallback>;
 
+    /// Record 与 StopCallback 随每次等待构造/销毁, Entry 本身经空闲链表复用。
     struct Entry {
-        template <class... Args>
-        explicit Entry(Args&&... args)
-            : Record(std::forward<Args>(args)...) {}
-
-        TRecord Record;
+        std::optional<TRecord> Record;
         std::optional<StopCallbackStorage> StopCallback;
+        /// 活动记录的入队顺序链。
+        Entry* Prev{nullptr};
+        Entry* Next{nullptr};
+        Entry* NextFree{nullptr};
+        /// 在 _slots 中的下标, Entry 存活期间不变。
+        uint32_t Index{0};
     };
 
-    vector<unique_ptr<Entry>> _records;
+    /// 代数放在槽位而不是 Entry 上: 超出空闲链表上限的 Entry 被释放后, 槽位复用时代数照样递增。
+    struct Slot {
+        unique_ptr<Entry> Owned;
+        uint32_t Generation{0};
+    };
+
+    /// 空闲链表上限。同时挂起的等待超过它时, 多出的 Entry 直接释放。
+    static constexpr size_t kMaxFreeEntries = 1024;
+
+    Entry* FindEntry(TRecord* record) const noexcept {
+        if (record == nullptr) {
+            return nullptr;
+        }
+        const uint32_t index = static_cast<uint32_t>(record->Ticket);
+        if (index >= _slots.size()) {
+            return nullptr;
+        }
+        Entry* entry = _slots[index].Owned.get();
+        return entry != nullptr && entry->Record.has_value() && &*entry->Record == record ? entry : nullptr;
+    }
+
+    Entry* AcquireEntry() {
+        if (_freeHead != nullptr) {
+            Entry* entry = _freeHead;
+            _freeHead = entry->NextFree;
+            entry->NextFree = nullptr;
+            --_freeCount;
+            return entry;
+        }
+        uint32_t index;
+        if (!_releasedSlots.empty()) {
+            index = _releasedSlots.back();
+            _slots[index].Owned = make_unique<Entry>();
+            _releasedSlots.pop_back();
+        } else {
+            // 释放的槽位不会多于槽位总数, 先备好容量, noexcept 的 ReleaseEntry 就不必分配。
+            _releasedSlots.reserve(_slots.size() + 1);
+            index = static_cast<uint32_t>(_slots.size());
+            _slots.push_back(Slot{make_unique<Entry>(), 0});
+        }
+        Entry* entry = _slots[index].Owned.get();
+        entry->Index = index;
+        return entry;
+    }
+
+    /// 调用方须已注销 StopCallback 并摘链。
+    void ReleaseEntry(Entry* entry) noexcept {
+        entry->Record.reset();
+        if (_freeCount < kMaxFreeEntries) {
+            entry->NextFree = _freeHead;
+            _freeHead = entry;
+            ++_freeCount;
+            return;
+        }
+        const uint32_t index = entry->Index;
+        _slots[index].Owned.reset();
+        _releasedSlots.push_back(index);
+    }
+
+    void LinkBack(Entry* entry) noexcept {
+        entry->Prev = _tail;
+        entry->Next = nullptr;
+        (_tail != nullptr ? _tail->Next : _head) = entry;
+        _tail = entry;
+    }
+
+    void Unlink(Entry* entry) noexcept {
+        (entry->Prev != nullptr ? entry->Prev->Next : _head) = entry->Next;
+        (entry->Next != nullptr ? entry->Next->Prev : _tail) = entry->Prev;
+        entry->Prev = nullptr;
+        entry->Next = nullptr;
+    }
+
+    vector<Slot> _slots;
+    /// Entry 已释放、可以复用的槽位下标。
+    vector<uint32_t> _releasedSlots;
+    Entry* _head{nullptr};
+    Entry* _tail{nullptr};
+    Entry* _freeHead{nullptr};
+    size_t _freeCount{0};
+    size_t _count{0};
 };
 
 class TaskScope {
@@ -204,37 +548,26 @@ inline task<stop_token> CurrentStopToken() {
     co_return co_await stdexec::get_stop_token();
 }
 
-/// 从协程 promise 的 env 里取 stop token。
-///
-/// 【为何需要它】: `co_await CurrentStopToken()` 只能在协程体里用, 而手写 awaitable 的
-/// await_suspend 拿到的只是一个 coroutine_handle —— 那里正是最需要 stop token 的地方
-/// (要把它记进等待记录, 以便取消时能恢复协程)。
-///
-/// promise 不提供 stop token (含类型擦除的 coroutine_handle<>) 时返回默认构造的 token,
-/// 其 stop_requested() 恒为 false —— 即"不可取消", 这是对"没有取消源"唯一安全的解释。
-template <class Promise>
-stop_token GetCoroutineStopToken(std::coroutine_handle<Promise> handle) noexcept {
-    if constexpr (std::is_void_v<Promise>) {
-        (void)handle;
-        return stop_token{};
-    } else if constexpr (requires { stdexec::get_stop_token(stdexec::get_env(handle.promise())); }) {
-        return stdexec::get_stop_token(stdexec::get_env(handle.promise()));
-    } else {
-        (void)handle;
-        return stop_token{};
-    }
-}
-
 inline task<void> StopCurrentTask() {
     co_await stdexec::just_stopped();
 }
 
+/// 以 stop 作为 t 的 stop token 等待 t, 被取消时结果为 nullopt。
+///
+/// 返回 sender 而非协程: 在 task 里直接 co_await 它, 操作状态就放在调用方的协程帧里,
+/// 不像 AwaitWithStopToken 那样多分配一个协程帧。
 template <class T>
-task<std::optional<T>> AwaitWithStopToken(task<T> t, stop_token stop) {
-    co_return co_await stdexec::stopped_as_optional(
+auto WithStopToken(task<T> t, stop_token stop) {
+    return stdexec::stopped_as_optional(
         stdexec::write_env(
             std::move(t),
             stdexec::prop{stdexec::get_stop_token, stop}));
 }
 
+/// WithStopToken 的 task 版本, 需要把结果当 task 传递时用。
+template <class T>
+task<std::optional<T>> AwaitWithStopToken(task<T> t, stop_token stop) {
+    co_return co_await WithStopToken(std::move(t), stop);
+}
+
 }  // namespace radray
@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <optional>
 #include <span>
+#include <string_view>
 
 #include <radray/types.h>
 
@@ -23,6 +24,31 @@ bool WriteTextFile(const std::filesystem::path& filepath, std::string_view conte
 /// 把二进制数据写入文件 (覆盖已有内容)。会自动创建父目录。成功返回 true。
 bool WriteBinaryFile(const std::filesystem::path& filepath, std::span<const byte> data) noexcept;
 
+/// 只读映射整个文件。空文件映射为空 span。
+/// 【映射期间不得改写或截断该文件】视图直接指向页缓存，外部改写的内容会透出来，截断在部分
+/// 平台上会让访问触发 SIGBUS；调用方须自行校验内容（如比对哈希）后再信任它。
+/// Windows 上映射存续期间该文件不能被替换或删除。
+class MappedFile {
+public:
+    static std::optional<MappedFile> Open(const std::filesystem::path& filepath) noexcept;
+
+    MappedFile() noexcept = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile() noexcept;
+
+    std::span<const byte> GetData() const noexcept { return {_data, _size}; }
+    std::string_view GetText() const noexcept { return {reinterpret_cast<const char*>(_data), _size}; }
+
+private:
+    void Close() noexcept;
+
+    const byte* _data{nullptr};
+    size_t _size{0};
+};
+
 /// 返回当前可执行文件所在目录。失败时返回空路径。
 /// 用于以运行时目录为基准定位随程序部署的资源（例如 shaderlib include 根目录）。
 std::filesystem::path GetExecutableDirectory() noexcept;
@@ -283,6 +283,20 @@ struct StringEqual {
 size_t HashData(const void* data, size_t size) noexcept;
 uint64_t HashData64(const void* data, size_t size) noexcept;
 
+/// HashData64 的流式版本: 分段 Update 后的 GetDigest 与对拼接后整段数据调用 HashData64 相同。
+/// 用于边写边算哈希、不必把整段数据留在内存里的场合。
+class HashStream64 {
+public:
+    HashStream64() noexcept;
+
+    void Update(const void* data, size_t size) noexcept;
+    uint64_t GetDigest() const noexcept;
+
+private:
+    // XXH64_state_t 的存储; 大小在 hash.cpp 里静态检查。
+    alignas(8) unsigned char _state[88];
+};
+
 template <class T>
 struct PodHasher {
     static_assert(std::is_trivially_copyable_v<T>, "PodHasher requires a trivially copyable type");
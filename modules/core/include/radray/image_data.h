@@ -47,6 +47,24 @@ class JPEGLoadSettings {
 public:
     std::optional<uint32_t> AddAlphaIfRGB;
     bool IsFlipY{false};
+    /// DCT 域缩放解码 (libjpeg-turbo 的 scale_denom), 取 1 / 2 / 4 / 8, 输出为 ceil(原尺寸 / ScaleDenominator)。
+    /// 缩小时每个 8x8 块只做对应尺寸的 IDCT, 省掉全分辨率解码, 给低 mip 与缩略图用。
+    uint32_t ScaleDenominator{1};
+};
+
+/// 编码图像按加载设置变换 (补 alpha、缩放) 之后的像素描述。只读文件头即可得到。
+struct ImageHeader {
+    uint32_t Width{0};
+    uint32_t Height{0};
+    ImageFormat Format{ImageFormat::R8_BYTE};
+};
+
+/// 解码目标: 调用方持有的内存, 例如上传 staging 的预留。
+struct ImageDecodeTarget {
+    /// 至少 RowPitch * (Height - 1) + 紧密行宽 字节。
+    std::span<byte> Data;
+    /// 相邻两行的字节距离, 0 表示紧密排列。可取设备的贴图行对齐, 解码结果不必再按行搬一次。
+    size_t RowPitch{0};
 };
 
 struct PixelCompareResult {
@@ -82,6 +100,19 @@ public:
     static std::optional<ImageData> LoadPNG(std::istream& stream, PNGLoadSettings settings = PNGLoadSettings{});
     static bool IsJPEG(std::istream& stream);
     static std::optional<ImageData> LoadJPEG(std::istream& stream, JPEGLoadSettings settings = JPEGLoadSettings{});
+
+    /// 以下直接读内存中的编码字节 (MappedFile 映射或已读入的缓冲), 不经过 istream, 也不另拷一份。
+    static bool IsPNG(std::span<const byte> encoded) noexcept;
+    static bool IsJPEG(std::span<const byte> encoded) noexcept;
+    static std::optional<ImageData> LoadPNG(std::span<const byte> encoded, PNGLoadSettings settings = PNGLoadSettings{});
+    static std::optional<ImageData> LoadJPEG(std::span<const byte> encoded, JPEGLoadSettings settings = JPEGLoadSettings{});
+    /// 只解析文件头, 返回按 settings 解码后的尺寸与格式, 供调用方先备好 ImageDecodeTarget。
+    static std::optional<ImageHeader> ReadPNGHeader(std::span<const byte> encoded, const PNGLoadSettings& settings = PNGLoadSettings{});
+    static std::optional<ImageHeader> ReadJPEGHeader(std::span<const byte> encoded, const JPEGLoadSettings& settings = JPEGLoadSettings{});
+    /// 解码进 target, 逐行按 target.RowPitch 放置, 不分配整图缓冲。target 放不下时返回 nullopt 且不写入。
+    /// 目标可以是写合并的上传内存: JPEG 只顺序写; 隔行扫描的 PNG 在各趟之间会读回已写的行。
+    static std::optional<ImageHeader> DecodePNG(std::span<const byte> encoded, const ImageDecodeTarget& target, PNGLoadSettings settings = PNGLoadSettings{});
+    static std::optional<ImageHeader> DecodeJPEG(std::span<const byte> encoded, const ImageDecodeTarget& target, JPEGLoadSettings settings = JPEGLoadSettings{});
     bool WritePNG(PNGWriteSettings settings = PNGWriteSettings{}) const;
 
     static PixelCompareResult CompareImageRGBA8(const ImageData& actual, const ImageData& expected, uint8_t tolerance) noexcept;
@@ -2,6 +2,7 @@
 
 #include <utility>
 #include <cassert>
+#include <cstdint>
 #include <iterator>
 #include <source_location>
 
@@ -11,6 +12,14 @@
 
 #include <radray/types.h>
 
+/// 编译期最低日志级别，取 LogLevel 的数值（0 = Trace … 5 = Critical）。低于它的日志宏展开为空，
+/// LogXxx 函数体也不会实例化格式化代码。Critical 永远保留，RADRAY_ABORT 不受影响。
+#ifndef RADRAY_MIN_LOG_LEVEL
+#define RADRAY_MIN_LOG_LEVEL 0
+#endif
+
+static_assert(RADRAY_MIN_LOG_LEVEL >= 0 && RADRAY_MIN_LOG_LEVEL <= 5, "RADRAY_MIN_LOG_LEVEL must be a LogLevel value in [0, 5]");
+
 namespace radray {
 
 enum class LogLevel {
@@ -22,6 +31,25 @@ enum class LogLevel {
     Critical
 };
 
+inline constexpr LogLevel kMinLogLevel = static_cast<LogLevel>(RADRAY_MIN_LOG_LEVEL);
+
+constexpr bool IsLogLevelCompiled(LogLevel lvl) noexcept { return lvl >= kMinLogLevel; }
+
+/// 异步模式下 ring buffer 写满时的处理方式。
+enum class LogOverflowPolicy {
+    /// 丢弃这条日志并计数，调用方永不等待。
+    Drop,
+    /// 自旋让出直到 flusher 腾出位置。
+    Block
+};
+
+struct AsyncLogDescriptor {
+    /// 预分配的记录个数，向上取整到 2 的幂。
+    uint32_t Capacity{8192};
+    LogOverflowPolicy Overflow{LogOverflowPolicy::Drop};
+};
+
+/// 异步模式下回调在 flusher 线程上调用。
 using LogCallback = void (*)(LogLevel level, std::string_view message, void* userData);
 
 void Log(std::source_location loc, LogLevel lvl, fmt::string_view msg) noexcept;
@@ -31,44 +59,61 @@ void Log(std::source_location loc, LogLevel lvl, fmt::wstring_view msg) noexcept
 
 bool ShouldLog(LogLevel lvl) noexcept;
 
+/// 异步模式下会等待调用前已入队的日志全部写出。
 void FlushLog() noexcept;
 
+/// 切到异步模式：Log 只把消息拷进固定大小的记录、入队后立即返回，由后台 flusher 线程写 sink。
+/// 超过记录内联容量的长消息会额外分配一次堆内存。Critical 日志先排空队列再同步写出。
+/// 【Start/Stop 只能在没有其他线程写日志时调用（进程启动 / 退出阶段）】。
+bool StartAsyncLog(const AsyncLogDescriptor& desc) noexcept;
+
+/// 写完剩余记录、停止 flusher 线程并回到同步模式。未启动时什么都不做。
+void StopAsyncLog() noexcept;
+
+bool IsAsyncLogEnabled() noexcept;
+
+/// 自最近一次 StartAsyncLog 以来因 Drop 策略丢弃的日志条数。
+uint64_t GetDroppedLogCount() noexcept;
+
 void SetLogCallback(LogCallback callback, void* userData) noexcept;
 
 void ClearLogCallback() noexcept;
 
 template <typename... Args>
 void LogFormat(LogLevel lvl, fmt::format_string<Args...> fmt, Args&&... args) noexcept {
-    if (!ShouldLog(lvl)) {
+    if (!IsLogLevelCompiled(lvl) || !ShouldLog(lvl)) {
         return;
     }
-    auto str = fmt::format(fmt, std::forward<Args>(args)...);
-    Log({}, lvl, str);
+    fmt::memory_buffer buf;
+    fmt::format_to(std::back_inserter(buf), fmt, std::forward<Args>(args)...);
+    Log({}, lvl, fmt::string_view{buf.data(), buf.size()});
 }
 
 #if defined(_WIN32)
 template <typename... Args>
 void LogFormat(LogLevel lvl, fmt::wformat_string<Args...> fmt, Args&&... args) noexcept {
-    if (!ShouldLog(lvl)) {
+    if (!IsLogLevelCompiled(lvl) || !ShouldLog(lvl)) {
         return;
     }
-    auto str = fmt::format(fmt, std::forward<Args>(args)...);
-    Log({}, lvl, fmt::wstring_view{str.data(), str.size()});
+    fmt::wmemory_buffer buf;
+    fmt::format_to(std::back_inserter(buf), fmt, std::forward<Args>(args)...);
+    Log({}, lvl, fmt::wstring_view{buf.data(), buf.size()});
 }
 #endif
 
 template <typename... Args>
 void LogFormatLoc(std::source_location loc, LogLevel lvl, fmt::format_string<Args...> fmt, Args&&... args) noexcept {
-    if (!ShouldLog(lvl)) {
+    if (!IsLogLevelCompiled(lvl) || !ShouldLog(lvl)) {
         return;
     }
-    auto str = fmt::format(fmt, std::forward<Args>(args)...);
-    Log(loc, lvl, str);
+    fmt::memory_buffer buf;
+    fmt::format_to(std::back_inserter(buf), fmt, std::forward<Args>(args)...);
+    Log(loc, lvl, fmt::string_view{buf.data(), buf.size()});
 }
 
 template <typename S, typename... Args>
 void LogFormatSPrintf(LogLevel lvl, const S& fmt, Args&&... args) noexcept {
-    if (!ShouldLog(lvl)) {
+    if (!IsLogLevelCompiled(lvl) || !ShouldLog(lvl)) {
         return;
     }
     auto str = fmt::sprintf(fmt, std::forward<Args>(args)...);
@@ -78,17 +123,18 @@ void LogFormatSPrintf(LogLevel lvl, const S& fmt, Args&&... args) noexcept {
 #if defined(_WIN32)
 template <typename... Args>
 void LogFormatLoc(std::source_location loc, LogLevel lvl, fmt::wformat_string<Args...> fmt, Args&&... args) noexcept {
-    if (!ShouldLog(lvl)) {
+    if (!IsLogLevelCompiled(lvl) || !ShouldLog(lvl)) {
         return;
     }
-    auto str = fmt::format(fmt, std::forward<Args>(args)...);
-    Log(loc, lvl, fmt::wstring_view{str.data(), str.size()});
+    fmt::wmemory_buffer buf;
+    fmt::format_to(std::back_inserter(buf), fmt, std::forward<Args>(args)...);
+    Log(loc, lvl, fmt::wstring_view{buf.data(), buf.size()});
 }
 #endif
 
 template <typename... Args>
 void LogFormatSPrintfLoc(std::source_location loc, LogLevel lvl, fmt::format_string<Args...> fmt, Args&&... args) noexcept {
-    if (!ShouldLog(lvl)) {
+    if (!IsLogLevelCompiled(lvl) || !ShouldLog(lvl)) {
         return;
     }
     auto str = fmt::sprintf(fmt, std::forward<Args>(args)...);
@@ -97,49 +143,65 @@ void LogFormatSPrintfLoc(std::source_location loc, LogLevel lvl, fmt::format_str
 
 template <typename... Args>
 void LogDebug(fmt::format_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormat(LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Debug)) {
+        LogFormat(LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    }
 }
 
 #if defined(_WIN32)
 template <typename... Args>
 void LogDebug(fmt::wformat_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormat(LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Debug)) {
+        LogFormat(LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    }
 }
 #endif
 
 template <typename... Args>
 void LogInfo(fmt::format_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormat(LogLevel::Info, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Info)) {
+        LogFormat(LogLevel::Info, fmt, std::forward<Args>(args)...);
+    }
 }
 
 #if defined(_WIN32)
 template <typename... Args>
 void LogInfo(fmt::wformat_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormat(LogLevel::Info, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Info)) {
+        LogFormat(LogLevel::Info, fmt, std::forward<Args>(args)...);
+    }
 }
 #endif
 
 template <typename... Args>
 void LogWarn(fmt::format_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormat(LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Warn)) {
+        LogFormat(LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    }
 }
 
 #if defined(_WIN32)
 template <typename... Args>
 void LogWarn(fmt::wformat_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormat(LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Warn)) {
+        LogFormat(LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    }
 }
 #endif
 
 template <typename... Args>
 void LogError(fmt::format_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormat(LogLevel::Err, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Err)) {
+        LogFormat(LogLevel::Err, fmt, std::forward<Args>(args)...);
+    }
 }
 
 #if defined(_WIN32)
 template <typename... Args>
 void LogError(fmt::wformat_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormat(LogLevel::Err, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Err)) {
+        LogFormat(LogLevel::Err, fmt, std::forward<Args>(args)...);
+    }
 }
 #endif
 
@@ -159,49 +221,65 @@ void LogAbort(std::source_location loc, fmt::wformat_string<Args...> fmt, Args&&
 
 template <typename... Args>
 void LogDebugLoc(std::source_location loc, fmt::format_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormatLoc(loc, LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Debug)) {
+        LogFormatLoc(loc, LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    }
 }
 
 #if defined(_WIN32)
 template <typename... Args>
 void LogDebugLoc(std::source_location loc, fmt::wformat_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormatLoc(loc, LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Debug)) {
+        LogFormatLoc(loc, LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    }
 }
 #endif
 
 template <typename... Args>
 void LogInfoLoc(std::source_location loc, fmt::format_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormatLoc(loc, LogLevel::Info, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Info)) {
+        LogFormatLoc(loc, LogLevel::Info, fmt, std::forward<Args>(args)...);
+    }
 }
 
 #if defined(_WIN32)
 template <typename... Args>
 void LogInfoLoc(std::source_location loc, fmt::wformat_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormatLoc(loc, LogLevel::Info, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Info)) {
+        LogFormatLoc(loc, LogLevel::Info, fmt, std::forward<Args>(args)...);
+    }
 }
 #endif
 
 template <typename... Args>
 void LogWarnLoc(std::source_location loc, fmt::format_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormatLoc(loc, LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Warn)) {
+        LogFormatLoc(loc, LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    }
 }
 
 #if defined(_WIN32)
 template <typename... Args>
 void LogWarnLoc(std::source_location loc, fmt::wformat_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormatLoc(loc, LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Warn)) {
+        LogFormatLoc(loc, LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    }
 }
 #endif
 
 template <typename... Args>
 void LogErrorLoc(std::source_location loc, fmt::format_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormatLoc(loc, LogLevel::Err, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Err)) {
+        LogFormatLoc(loc, LogLevel::Err, fmt, std::forward<Args>(args)...);
+    }
 }
 
 #if defined(_WIN32)
 template <typename... Args>
 void LogErrorLoc(std::source_location loc, fmt::wformat_string<Args...> fmt, Args&&... args) noexcept {
-    LogFormatLoc(loc, LogLevel::Err, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Err)) {
+        LogFormatLoc(loc, LogLevel::Err, fmt, std::forward<Args>(args)...);
+    }
 }
 #endif
 
@@ -213,64 +291,91 @@ void LogAbortSPrintf(std::source_location loc, const S& fmt, Args&&... args) noe
 
 template <typename S, typename... Args>
 void LogDebugSPrintfLoc(std::source_location loc, const S& fmt, Args&&... args) noexcept {
-    LogFormatSPrintfLoc(loc, LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Debug)) {
+        LogFormatSPrintfLoc(loc, LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    }
 }
 
 template <typename S, typename... Args>
 void LogInfoSPrintfLoc(std::source_location loc, const S& fmt, Args&&... args) noexcept {
-    LogFormatSPrintfLoc(loc, LogLevel::Info, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Info)) {
+        LogFormatSPrintfLoc(loc, LogLevel::Info, fmt, std::forward<Args>(args)...);
+    }
 }
 
 template <typename S, typename... Args>
 void LogWarnSPrintfLoc(std::source_location loc, const S& fmt, Args&&... args) noexcept {
-    LogFormatSPrintfLoc(loc, LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Warn)) {
+        LogFormatSPrintfLoc(loc, LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    }
 }
 
 template <typename S, typename... Args>
 void LogErrorSPrintfLoc(std::source_location loc, const S& fmt, Args&&... args) noexcept {
-    LogFormatSPrintfLoc(loc, LogLevel::Err, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Err)) {
+        LogFormatSPrintfLoc(loc, LogLevel::Err, fmt, std::forward<Args>(args)...);
+    }
 }
 
 template <typename S, typename... Args>
 void LogDebugSPrintf(const S& fmt, Args&&... args) noexcept {
-    LogFormatSPrintf(LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Debug)) {
+        LogFormatSPrintf(LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    }
 }
 
 template <typename S, typename... Args>
 void LogInfoSPrintf(const S& fmt, Args&&... args) noexcept {
-    LogFormatSPrintf(LogLevel::Info, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Info)) {
+        LogFormatSPrintf(LogLevel::Info, fmt, std::forward<Args>(args)...);
+    }
 }
 
 template <typename S, typename... Args>
 void LogWarnSPrintf(const S& fmt, Args&&... args) noexcept {
-    LogFormatSPrintf(LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Warn)) {
+        LogFormatSPrintf(LogLevel::Warn, fmt, std::forward<Args>(args)...);
+    }
 }
 
 template <typename S, typename... Args>
 void LogErrorSPrintf(const S& fmt, Args&&... args) noexcept {
-    LogFormatSPrintf(LogLevel::Err, fmt, std::forward<Args>(args)...);
+    if constexpr (IsLogLevelCompiled(LogLevel::Err)) {
+        LogFormatSPrintf(LogLevel::Err, fmt, std::forward<Args>(args)...);
+    }
 }
 
 }  // namespace radray
 
-#ifdef RADRAY_IS_DEBUG
+#if defined(RADRAY_IS_DEBUG) && RADRAY_MIN_LOG_LEVEL <= 1
 #define RADRAY_DEBUG_LOG(fmt, ...) ::radray::LogDebug(fmt __VA_OPT__(, ) __VA_ARGS__)
+#define RADRAY_DEBUG_LOG_CSTYLE(fmt, ...) ::radray::LogDebugSPrintf(fmt __VA_OPT__(, ) __VA_ARGS__)
 #else
 #define RADRAY_DEBUG_LOG(fmt, ...)
+#define RADRAY_DEBUG_LOG_CSTYLE(fmt, ...)
 #endif
+#if RADRAY_MIN_LOG_LEVEL <= 2
 #define RADRAY_INFO_LOG(fmt, ...) ::radray::LogInfo(fmt __VA_OPT__(, ) __VA_ARGS__)
-#define RADRAY_WARN_LOG(fmt, ...) ::radray::LogWarn(fmt __VA_OPT__(, ) __VA_ARGS__)
-#define RADRAY_ERR_LOG(fmt, ...) ::radray::LogErrorLoc(::std::source_location::current(), fmt __VA_OPT__(, ) __VA_ARGS__)
-#define RADRAY_ABORT(fmt, ...) ::radray::LogAbort(::std::source_location::current(), fmt __VA_OPT__(, ) __VA_ARGS__)
-
-#ifdef RADRAY_IS_DEBUG
-#define RADRAY_DEBUG_LOG_CSTYLE(fmt, ...) ::radray::LogDebugSPrintf(fmt __VA_OPT__(, ) __VA_ARGS__)
+#define RADRAY_INFO_LOG_CSTYLE(fmt, ...) ::radray::LogInfoSPrintf(fmt __VA_OPT__(, ) __VA_ARGS__)
 #else
-#define RADRAY_DEBUG_LOG_CSTYLE(fmt, ...)
+#define RADRAY_INFO_LOG(fmt, ...)
+#define RADRAY_INFO_LOG_CSTYLE(fmt, ...)
 #endif
-#define RADRAY_INFO_LOG_CSTYLE(fmt, ...) ::radray::LogInfoSPrintf(fmt __VA_OPT__(, ) __VA_ARGS__)
+#if RADRAY_MIN_LOG_LEVEL <= 3
+#define RADRAY_WARN_LOG(fmt, ...) ::radray::LogWarn(fmt __VA_OPT__(, ) __VA_ARGS__)
 #define RADRAY_WARN_LOG_CSTYLE(fmt, ...) ::radray::LogWarnSPrintf(fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define RADRAY_WARN_LOG(fmt, ...)
+#define RADRAY_WARN_LOG_CSTYLE(fmt, ...)
+#endif
+#if RADRAY_MIN_LOG_LEVEL <= 4
+#define RADRAY_ERR_LOG(fmt, ...) ::radray::LogErrorLoc(::std::source_location::current(), fmt __VA_OPT__(, ) __VA_ARGS__)
 #define RADRAY_ERR_LOG_CSTYLE(fmt, ...) ::radray::LogErrorSPrintfLoc(::std::source_location::current(), fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define RADRAY_ERR_LOG(fmt, ...)
+#define RADRAY_ERR_LOG_CSTYLE(fmt, ...)
+#endif
+#define RADRAY_ABORT(fmt, ...) ::radray::LogAbort(::std::source_location::current(), fmt __VA_OPT__(, ) __VA_ARGS__)
 #define RADRAY_ABORT_CSTYLE(fmt, ...) ::radray::LogAbortSPrintfLoc(::std::source_location::current(), fmt __VA_OPT__(, ) __VA_ARGS__)
 
 #define RADRAY_ASSERT(x) assert(x)
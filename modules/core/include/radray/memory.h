@@ -1,6 +1,9 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <string_view>
 
 namespace radray {
 
@@ -12,4 +15,100 @@ void Free(void* ptr) noexcept;
 
 void AlignedFree(void* ptr) noexcept;
 
+/// 分配归属的子系统。由当前线程上最内层的 MemoryTagScope 决定。
+enum class MemoryTag : uint8_t {
+    Untagged,
+    AssetLoading,
+    RenderFramework,
+    ShaderJit,
+    Logging,
+    MAX_COUNT
+};
+
+inline constexpr size_t kMemoryTagCount = static_cast<size_t>(MemoryTag::MAX_COUNT);
+
+std::string_view format_as(MemoryTag tag) noexcept;
+
+struct MemoryTagStats {
+    int64_t LiveBytes{0};
+    /// 在各次 GetMemoryTagStats / SampleMemoryFrame 时观察到的最大 LiveBytes。
+    int64_t PeakBytes{0};
+    uint64_t AllocationCount{0};
+    uint64_t FreeCount{0};
+};
+
+struct MemoryFrameSample {
+    uint64_t AllocationCount{0};
+    uint64_t AllocatedBytes{0};
+};
+
+/// mimalloc-override 在 Windows 以外以 whole-archive 定义了全局 operator new / delete，
+/// 那里再定义一份会重复符号，所以只在它没接管这些函数时由 memory.cpp 替换。
+#if defined(RADRAY_ENABLE_MEMORY_TRACKING) && (defined(_WIN32) || !defined(RADRAY_ENABLE_MIMALLOC))
+#define RADRAY_MEMORY_TRACKING_REPLACES_NEW 1
+#endif
+
+/// 分配是否被统计（编译期开关 RADRAY_ENABLE_MEMORY_TRACKING）。
+constexpr bool IsMemoryTrackingEnabled() noexcept {
+#if defined(RADRAY_ENABLE_MEMORY_TRACKING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// 全局 operator new / delete 是否也转到 Malloc / Free，即容器与 make_unique 的分配是否记到当前 tag 下。
+/// 为 false 时只有显式调用 Malloc / AlignedAlloc 的分配被统计。
+constexpr bool IsGlobalNewTracked() noexcept {
+#if defined(RADRAY_MEMORY_TRACKING_REPLACES_NEW)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(RADRAY_ENABLE_MEMORY_TRACKING)
+
+/// 在作用域内把当前线程的分配记到 tag 下。【不能跨 co_await 持有：tag 是线程局部状态】。
+class MemoryTagScope {
+public:
+    explicit MemoryTagScope(MemoryTag tag) noexcept;
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope(MemoryTagScope&&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(MemoryTagScope&&) = delete;
+    ~MemoryTagScope() noexcept;
+
+private:
+    MemoryTag _previous;
+};
+
+MemoryTag GetCurrentMemoryTag() noexcept;
+
+/// 合并所有线程（含已退出线程）的计数。计数在各线程本地累加，只有这里会加锁。
+MemoryTagStats GetMemoryTagStats(MemoryTag tag) noexcept;
+std::array<MemoryTagStats, kMemoryTagCount> GetAllMemoryTagStats() noexcept;
+
+/// 返回自上次调用以来的分配次数与字节数，并把它们和各 tag 的 LiveBytes 写成剖析计数器。
+/// Application 的 runner 每帧调用一次。
+MemoryFrameSample SampleMemoryFrame() noexcept;
+
+#else
+
+class MemoryTagScope {
+public:
+    explicit MemoryTagScope(MemoryTag) noexcept {}
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope(MemoryTagScope&&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(MemoryTagScope&&) = delete;
+};
+
+inline MemoryTag GetCurrentMemoryTag() noexcept { return MemoryTag::Untagged; }
+inline MemoryTagStats GetMemoryTagStats(MemoryTag) noexcept { return {}; }
+inline std::array<MemoryTagStats, kMemoryTagCount> GetAllMemoryTagStats() noexcept { return {}; }
+inline MemoryFrameSample SampleMemoryFrame() noexcept { return {}; }
+
+#endif
+
 }  // namespace radray
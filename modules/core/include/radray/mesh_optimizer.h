@@ -0,0 +1,67 @@
+#pragma once
+
+#include <span>
+
+#include <radray/basic_math.h>
+#include <radray/types.h>
+
+// 三角形网格的顶点与索引重排: 焊接重复顶点、按后变换缓存重排三角形 (Tipsify)、按簇做 overdraw
+// 排序、按首次引用重排顶点。只改变顶点的重复与三角形、顶点的次序, 不改变光栅化出的几何。
+
+namespace radray {
+
+class TriangleMesh;
+
+/// FIFO 后变换缓存的模拟结果。
+struct VertexCacheStatistics {
+    uint32_t VerticesTransformed{0};
+    /// 每个三角形平均变换的顶点数 (ACMR)。3 为毫无复用, 规则网格的极限约 0.5。
+    float Acmr{0.0f};
+    /// 变换次数与顶点数之比 (ATVR)。1 为每个顶点只变换一次。
+    float Atvr{0.0f};
+};
+
+/// 用 cacheSize 项的 FIFO 缓存模拟 indices 的顶点变换。越界的索引算作一次变换。
+VertexCacheStatistics AnalyzeVertexCache(
+    std::span<const uint32_t> indices,
+    size_t vertexCount,
+    uint32_t cacheSize = 16) noexcept;
+
+struct MeshOptimizeOptions {
+    /// 合并所有属性都按位相同的顶点 (-0 与 +0 视作相同)。
+    bool WeldVertices{true};
+    /// Tipsify 三角形重排。
+    bool OptimizeVertexCache{true};
+    /// 在缓存重排结果上切簇, 按朝外程度排序, 先画的簇更可能挡住后画的。需要 OptimizeVertexCache。
+    bool OptimizeOverdraw{true};
+    /// 顶点按首次被索引的次序重排, 未被引用的顶点被丢弃。
+    bool OptimizeVertexFetch{true};
+    /// 重排所针对的缓存项数。
+    uint32_t CacheSize{16};
+    /// 切簇允许的 ACMR 上浮比例。越大簇越小、overdraw 排序越自由, 缓存命中越差。
+    float OverdrawThreshold{1.05f};
+};
+
+/// 合并重复顶点并改写 Indices, 幸存顶点保持原先的相对次序。返回合并后的顶点数。
+size_t WeldVertices(TriangleMesh& mesh);
+
+/// Sander 等人的 Tipsify: 以顶点为扇心逐个输出其未输出的三角形, 下一个扇心取仍在缓存里、
+/// 剩余三角形最多的邻接顶点, 无可选时退回最近输出过的顶点。线性时间。
+void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+/// 在 (已做缓存重排的) indices 上切簇: 三个顶点全部缺失处硬切, 簇内前缀 ACMR 回落到
+/// threshold 倍簇 ACMR 以内时软切。簇按 dot(簇质心 - 网格质心, 簇法线) 从大到小排列。
+void OptimizeOverdraw(
+    std::span<uint32_t> indices,
+    std::span<const Eigen::Vector3f> positions,
+    uint32_t cacheSize = 16,
+    float threshold = 1.05f);
+
+/// 按首次引用重排顶点并改写 Indices, 未被引用的顶点被丢弃。返回剩余顶点数。
+size_t OptimizeVertexFetch(TriangleMesh& mesh);
+
+/// 依 options 依次焊接、缓存重排、overdraw 排序、顶点获取重排。
+/// 网格无效 (见 TriangleMesh::IsValid) 或有越界索引时返回 false, mesh 不变。
+bool OptimizeMesh(TriangleMesh& mesh, const MeshOptimizeOptions& options = {});
+
+}  // namespace radray
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <limits>
+#include <span>
+
+#include <radray/basic_math.h>
+#include <radray/types.h>
+#include <radray/vertex_data.h>
+
+// 二次误差度量 (QEM) 的网格简化与 LOD 链生成。只删三角形、不建新顶点: 每次边坍缩把一端的
+// 顶点并进另一端已有的顶点, 简化结果是原顶点缓冲上的一份新索引, 各级 LOD 共用顶点。
+
+namespace radray {
+
+class TriangleMesh;
+
+struct MeshSimplifyOptions {
+    /// 目标索引数 (三角形数 x 3), 降到不多于它即停止。
+    size_t TargetIndexCount{0};
+    /// 允许的最大误差, 网格空间的距离。下一次坍缩会超过它时停止, 先到者为准。
+    float TargetError{std::numeric_limits<float>::max()};
+};
+
+struct MeshSimplifyResult {
+    vector<uint32_t> Indices;
+    /// 已执行的坍缩中最大的误差, 网格空间的距离。
+    float Error{0.0f};
+};
+
+/// Garland-Heckbert 二次误差简化, 坍缩到已有顶点 (half-edge collapse)。
+///
+/// 位置按位相同的顶点视作同一个几何点的不同 wedge: 属性接缝由此从索引拓扑里识别, 不看属性值。
+/// 开放边界与接缝上的点只沿边界 / 接缝滑动, 并带垂直于面的边界平面二次型; 三条以上边界交汇的点
+/// 不动。坍缩后翻面的不做。误差是并入点处各原面平面距离平方按面积加权的均值再开方。
+/// indices 必须都小于 positions.size()。
+MeshSimplifyResult SimplifyMesh(
+    std::span<const uint32_t> indices,
+    std::span<const Eigen::Vector3f> positions,
+    const MeshSimplifyOptions& options);
+
+struct MeshLodOptions {
+    /// 含 LOD0 在内的最多级数。
+    uint32_t MaxLodCount{4};
+    /// 每级相对上一级的目标三角形比例。
+    float TriangleRatio{0.5f};
+    /// 单级允许的最大误差, 相对包围盒对角线长度。
+    float MaxRelativeError{0.02f};
+    /// 上一级少于这么多三角形就不再往下生成。
+    uint32_t MinTriangleCount{64};
+    /// 各级做顶点缓存重排所针对的缓存项数。
+    uint32_t CacheSize{16};
+};
+
+/// 从 mesh.Indices (即 LOD0) 起逐级简化, 把各级索引依次追加在 mesh.Indices 之后, 返回各级范围。
+/// 每级从上一级简化而来, Error 取各级误差之和。某一级减不到上一级的九成时停止。
+/// mesh 无效或有越界索引时返回空, mesh 不变。
+vector<MeshLodEntry> GenerateMeshLods(TriangleMesh& mesh, const MeshLodOptions& options = {});
+
+}  // namespace radray
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <span>
+
+#include <radray/types.h>
+
+// RGBA8 mip 链的 CPU 生成: box / Kaiser 下采样, sRGB 经查表在线性空间里滤波。
+
+namespace radray {
+
+enum class MipFilter : uint8_t {
+    /// 2x2 平均。奇数边长丢掉最后一行/列, 与 GPU 的 floor(size / 2) 一致。
+    Box,
+    /// 可分离的 Kaiser 窗 sinc (半径 3 个目标像素, alpha 4)。更锐, 代价约为 box 的十倍。
+    Kaiser,
+};
+
+/// 把 [0, count) 分给若干线程执行 body(i), 全部完成才返回。空表示在调用线程上串行。
+using MipParallelFor = std::function<void(uint32_t count, const std::function<void(uint32_t)>& body)>;
+
+struct MipChainOptions {
+    /// RGB 按 sRGB 编码解释: 解码到线性空间滤波后再编码; alpha 始终按线性处理。
+    bool Srgb{false};
+    /// false 时只有 level 0。
+    bool GenerateMips{true};
+    MipFilter Filter{MipFilter::Box};
+    /// 大图按目标行分带并行。level 之间仍是串行的 —— 下一级从上一级生成。
+    MipParallelFor ParallelFor{};
+};
+
+/// 一次分配的 RGBA8 mip 链。各级从大到小紧接排列, 按偏移切出, 可整块交给上传或序列化。
+class Rgba8MipChain {
+public:
+    Rgba8MipChain() noexcept = default;
+
+    /// 分配 levelCount 级的存储, 内容未初始化。levelCount 超出完整链长时截断。
+    static Rgba8MipChain Allocate(uint32_t width, uint32_t height, uint32_t levelCount);
+
+    bool IsEmpty() const noexcept { return _levelCount == 0; }
+    uint32_t GetWidth() const noexcept { return _width; }
+    uint32_t GetHeight() const noexcept { return _height; }
+    uint32_t GetLevelCount() const noexcept { return _levelCount; }
+    uint32_t GetLevelWidth(uint32_t level) const noexcept { return std::max(_width >> level, 1u); }
+    uint32_t GetLevelHeight(uint32_t level) const noexcept { return std::max(_height >> level, 1u); }
+    size_t GetLevelOffset(uint32_t level) const noexcept;
+
+    std::span<const byte> GetLevel(uint32_t level) const noexcept;
+    std::span<byte> GetLevel(uint32_t level) noexcept;
+    /// 全部级别的连续字节。
+    std::span<const byte> GetBytes() const noexcept { return {_data.get(), _size}; }
+    std::span<byte> GetBytes() noexcept { return {_data.get(), _size}; }
+
+private:
+    unique_ptr<byte[]> _data;
+    size_t _size{0};
+    uint32_t _width{0};
+    uint32_t _height{0};
+    uint32_t _levelCount{0};
+};
+
+/// 到 1x1 为止的完整 mip 级数。
+uint32_t GetFullMipLevelCount(uint32_t width, uint32_t height) noexcept;
+
+/// 从紧密排列的 RGBA8 像素生成 mip 链。level 0 是 rgba8 的拷贝。
+/// rgba8 的大小不等于 width * height * 4 或尺寸为 0 时返回空链。
+Rgba8MipChain BuildRgba8MipChain(std::span<const byte> rgba8, uint32_t width, uint32_t height, const MipChainOptions& options);
+
+/// 已写好 level 0 的链上原地生成其余各级。供直接把像素解码进 level 0 的调用方省掉一次拷贝。
+void GenerateRgba8Mips(Rgba8MipChain& chain, const MipChainOptions& options);
+
+/// sRGB 8 位码值到线性 [0, 1]。查 256 项表。
+float Srgb8ToLinear(uint8_t value) noexcept;
+
+/// 线性值编码为 sRGB 8 位码值, 结果等于 round(encode(clamp(value, 0, 1)) * 255)。
+/// 查 4096 桶的分段表再做至多一次阈值比较, 不调用 pow。
+uint8_t LinearToSrgb8(float value) noexcept;
+
+}  // namespace radray
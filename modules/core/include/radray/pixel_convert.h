@@ -0,0 +1,61 @@
+#pragma once
+
+#include <span>
+
+#include <radray/image_data.h>
+#include <radray/types.h>
+
+// ImageData 的像素格式转换: 8 位通道扩展到 RGBA8、16 位收窄到 8 位、half 与 float 互转、预乘 alpha。
+// 逐行处理, 行内走 SIMD (SSSE3 / F16C / NEON, 缺失时退回标量); FlipY 折进同一趟, 大图只读写一遍。
+
+namespace radray {
+
+struct PixelConvertOptions {
+    /// 目标第 y 行取源第 height - 1 - y 行。
+    bool FlipY{false};
+    /// 颜色乘以 alpha。按编码值计算, 不做 sRGB 解码; 只对 RGBA8 / RGBA16_HALF / RGBA32_FLOAT 目标有效。
+    bool PremultiplyAlpha{false};
+    /// 源没有 alpha 而目标有时填入的值。
+    uint8_t Alpha{0xff};
+};
+
+/// 支持的组合:
+/// - 同格式 (复制、翻转, 以及上面三种目标的预乘)。
+/// - R8 / RG8 / RGB8 -> RGBA8。R 与 RG 视作灰度与灰度 + alpha, 灰度复制到 RGB。
+/// - R16 / RG16 / RGB16 / RGBA16_USHORT -> 同通道数的 8 位格式, 以及 -> RGBA8。收窄按 v * 255 / 65535 四舍五入。
+/// - R16_HALF / RG16_HALF / RGBA16_HALF 与同通道数的 float 格式互转。float -> half 就近舍入到偶数, 超出范围变 inf。
+bool IsPixelConversionSupported(ImageFormat from, ImageFormat to, bool premultiplyAlpha = false) noexcept;
+
+/// 行连续、无填充的 width x height 像素从 from 转成 to。src 与 dst 不得重叠 (就地转换见 ConvertImageInPlace)。
+/// 不支持的组合或缓冲尺寸不符时返回 false, dst 不被改动。
+bool ConvertPixels(
+    ImageFormat from,
+    std::span<const byte> src,
+    ImageFormat to,
+    std::span<byte> dst,
+    uint32_t width,
+    uint32_t height,
+    const PixelConvertOptions& options = {}) noexcept;
+
+/// 逐像素的标量实现, 与 ConvertPixels 结果逐字节一致。测试与 benchmark 用它对拍 SIMD 路径。
+bool ConvertPixelsScalar(
+    ImageFormat from,
+    std::span<const byte> src,
+    ImageFormat to,
+    std::span<byte> dst,
+    uint32_t width,
+    uint32_t height,
+    const PixelConvertOptions& options = {}) noexcept;
+
+/// 转成新图, 只分配一次目标。空图或不支持的组合返回空图。
+ImageData ConvertImage(const ImageData& image, ImageFormat to, const PixelConvertOptions& options = {});
+
+/// 目标像素不大于源时在原缓冲里转换, 不分配 (同尺寸且 FlipY 时借一行暂存; 收窄且 FlipY 时转完再翻一遍
+/// 已经变小的图)。目标更大时分配一次目标、转完释放源。空图或不支持的组合返回 false, image 不变。
+bool ConvertImageInPlace(ImageData& image, ImageFormat to, const PixelConvertOptions& options = {});
+
+/// 单个 half 与 float 互转, 舍入与上面的格式转换一致。顶点量化 (见 vertex_data.h) 也用它们。
+float HalfToFloat(uint16_t value) noexcept;
+uint16_t FloatToHalf(float value) noexcept;
+
+}  // namespace radray
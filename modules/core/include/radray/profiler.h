@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+#include <radray/json.h>
+
+namespace radray {
+
+struct ProfileCaptureDescriptor {
+    /// 每个线程在一次采集中最多保存的事件数，超出的事件丢弃并计数。
+    uint32_t MaxEventsPerThread{1u << 20};
+};
+
+struct ProfileCaptureStats {
+    uint64_t EventCount{0};
+    uint64_t DroppedEventCount{0};
+    uint32_t ThreadCount{0};
+};
+
+#if defined(RADRAY_ENABLE_PROFILER)
+
+namespace detail {
+
+inline std::atomic<bool> g_profileCapturing{false};
+
+}  // namespace detail
+
+/// 当前是否在采集。热路径上只有这一次 relaxed load。
+inline bool IsProfileCapturing() noexcept {
+    return detail::g_profileCapturing.load(std::memory_order_relaxed);
+}
+
+/// 剖析时间戳，steady_clock 纳秒。
+inline int64_t ProfileNow() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// 丢弃上一次采集的数据并开始记录。
+/// 【必须在上一次采集导出完成后再调用；各线程在自己下一次写事件时才清空旧缓冲】。
+void BeginProfileCapture(const ProfileCaptureDescriptor& desc = {}) noexcept;
+
+/// 停止记录。已记录的数据保留到下一次 BeginProfileCapture。
+void EndProfileCapture() noexcept;
+
+/// 以下函数的 name 只保存指针，【必须是静态存储期字符串（通常是字面量）】。
+void SetProfileThreadName(const char* name) noexcept;
+void RecordProfileZone(const char* name, int64_t start, int64_t end) noexcept;
+void RecordProfileFrameMark(const char* name) noexcept;
+void RecordProfileCounter(const char* name, double value) noexcept;
+
+ProfileCaptureStats GetProfileCaptureStats() noexcept;
+
+/// 把当前采集写成 Chrome trace 格式（chrome://tracing、Perfetto 可直接打开）。
+/// 可以在采集进行中调用，只导出调用时已经发布的事件。
+bool WriteProfileChromeTrace(JsonWriter& writer) noexcept;
+bool SaveProfileChromeTrace(const std::filesystem::path& path) noexcept;
+
+/// RAII 剖析区间，构造时未在采集则析构什么都不做。
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) noexcept
+        : _name(name),
+          _start(IsProfileCapturing() ? ProfileNow() : -1) {}
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope(ProfileScope&&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+    ProfileScope& operator=(ProfileScope&&) = delete;
+    ~ProfileScope() noexcept {
+        if (_start >= 0) {
+            RecordProfileZone(_name, _start, ProfileNow());
+        }
+    }
+
+private:
+    const char* _name;
+    int64_t _start;
+};
+
+#else
+
+inline bool IsProfileCapturing() noexcept { return false; }
+inline void BeginProfileCapture(const ProfileCaptureDescriptor& = {}) noexcept {}
+inline void EndProfileCapture() noexcept {}
+inline void SetProfileThreadName(const char*) noexcept {}
+inline ProfileCaptureStats GetProfileCaptureStats() noexcept { return {}; }
+inline bool WriteProfileChromeTrace(JsonWriter&) noexcept { return false; }
+inline bool SaveProfileChromeTrace(const std::filesystem::path&) noexcept { return false; }
+
+#endif
+
+}  // namespace radray
+
+#define RADRAY_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RADRAY_PROFILE_CONCAT(a, b) RADRAY_PROFILE_CONCAT_IMPL(a, b)
+
+#if defined(RADRAY_ENABLE_PROFILER)
+#define RADRAY_PROFILE_SCOPE(name) ::radray::ProfileScope RADRAY_PROFILE_CONCAT(radrayProfileScope_, __LINE__){name}
+#define RADRAY_PROFILE_FRAME(name)                     \
+    do {                                               \
+        if (::radray::IsProfileCapturing()) {          \
+            ::radray::RecordProfileFrameMark(name);    \
+        }                                              \
+    } while (0)
+#define RADRAY_PROFILE_COUNTER(name, value)                                    \
+    do {                                                                       \
+        if (::radray::IsProfileCapturing()) {                                  \
+            ::radray::RecordProfileCounter(name, static_cast<double>(value));  \
+        }                                                                      \
+    } while (0)
+#define RADRAY_PROFILE_THREAD_NAME(name) ::radray::SetProfileThreadName(name)
+#else
+#define RADRAY_PROFILE_SCOPE(name)
+#define RADRAY_PROFILE_FRAME(name) ((void)0)
+#define RADRAY_PROFILE_COUNTER(name, value) ((void)0)
+#define RADRAY_PROFILE_THREAD_NAME(name) ((void)0)
+#endif
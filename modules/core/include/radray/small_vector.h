@@ -0,0 +1,314 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <radray/logger.h>
+#include <radray/types.h>
+
+namespace radray {
+
+/// 带 N 个元素内联存储的连续容器。元素个数不超过 N 时不触碰堆；超过后整体搬到
+/// allocator<T> 分配的堆块，此后即使缩回 N 以内也继续使用堆块（与 std::vector 一样不自动收缩）。
+///
+/// 接口刻意与 std::vector 同名同义，方便在热路径里直接替换；迭代器是裸指针、满足
+/// contiguous_range，可以直接传给接收 std::span 的接口。
+/// 扩容与 std::vector 一样提供强异常保证（元素移动可能抛异常又不可拷贝时除外）。
+/// 【任何改变容量的操作都会使迭代器、指针与引用失效；内联状态下的移动同样会使源对象的元素指针失效】。
+template <class T, size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector requires a non-zero inline capacity");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    SmallVector() noexcept : _data(InlineData()) {}
+
+    explicit SmallVector(size_type count) : SmallVector() {
+        this->resize(count);
+    }
+
+    SmallVector(size_type count, const T& value) : SmallVector() {
+        this->resize(count, value);
+    }
+
+    SmallVector(std::initializer_list<T> init) : SmallVector() {
+        this->assign(init.begin(), init.end());
+    }
+
+    template <std::input_iterator It>
+    SmallVector(It first, It last) : SmallVector() {
+        this->assign(first, last);
+    }
+
+    SmallVector(const SmallVector& other) : SmallVector() {
+        this->assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : SmallVector() {
+        this->MoveFrom(std::move(other));
+    }
+
+    ~SmallVector() noexcept {
+        this->clear();
+        this->ReleaseHeap();
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            this->assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            this->clear();
+            this->ReleaseHeap();
+            this->MoveFrom(std::move(other));
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(std::initializer_list<T> init) {
+        this->assign(init.begin(), init.end());
+        return *this;
+    }
+
+    template <std::input_iterator It>
+    void assign(It first, It last) {
+        this->clear();
+        if constexpr (std::forward_iterator<It>) {
+            this->reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            this->emplace_back(*first);
+        }
+    }
+
+    void assign(std::initializer_list<T> init) { this->assign(init.begin(), init.end()); }
+
+    reference operator[](size_type index) noexcept {
+        RADRAY_ASSERT(index < _size);
+        return _data[index];
+    }
+
+    const_reference operator[](size_type index) const noexcept {
+        RADRAY_ASSERT(index < _size);
+        return _data[index];
+    }
+
+    reference front() noexcept { return (*this)[0]; }
+    const_reference front() const noexcept { return (*this)[0]; }
+    reference back() noexcept { return (*this)[_size - 1]; }
+    const_reference back() const noexcept { return (*this)[_size - 1]; }
+
+    T* data() noexcept { return _data; }
+    const T* data() const noexcept { return _data; }
+
+    iterator begin() noexcept { return _data; }
+    const_iterator begin() const noexcept { return _data; }
+    const_iterator cbegin() const noexcept { return _data; }
+    iterator end() noexcept { return _data + _size; }
+    const_iterator end() const noexcept { return _data + _size; }
+    const_iterator cend() const noexcept { return _data + _size; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator{this->end()}; }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{this->end()}; }
+    reverse_iterator rend() noexcept { return reverse_iterator{this->begin()}; }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator{this->begin()}; }
+
+    bool empty() const noexcept { return _size == 0; }
+    size_type size() const noexcept { return _size; }
+    size_type capacity() const noexcept { return _capacity; }
+    static constexpr size_type inline_capacity() noexcept { return N; }
+    /// 当前元素是否仍位于对象内部的内联存储中。
+    bool is_inline() const noexcept { return _data == InlineData(); }
+
+    void reserve(size_type newCapacity) {
+        if (newCapacity > _capacity) {
+            this->Reallocate(newCapacity);
+        }
+    }
+
+    void clear() noexcept {
+        std::destroy_n(_data, _size);
+        _size = 0;
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (_size < _capacity) {
+            T* slot = std::construct_at(_data + _size, std::forward<Args>(args)...);
+            ++_size;
+            return *slot;
+        }
+        // 先在新块里构造新元素再搬旧元素，参数引用本容器内元素时也安全。
+        // 任一步抛异常时新块被 guard 释放，本容器保持原样。
+        const size_type newCapacity = this->NextCapacity(_size + 1);
+        HeapBlock block = AllocateHeap(newCapacity);
+        T* slot = std::construct_at(block.get() + _size, std::forward<Args>(args)...);
+        try {
+            this->TransferTo(block.get());
+        } catch (...) {
+            std::destroy_at(slot);
+            throw;
+        }
+        this->AdoptHeap(block.release(), newCapacity);
+        ++_size;
+        return *slot;
+    }
+
+    void push_back(const T& value) { this->emplace_back(value); }
+    void push_back(T&& value) { this->emplace_back(std::move(value)); }
+
+    void pop_back() noexcept {
+        RADRAY_ASSERT(_size > 0);
+        --_size;
+        std::destroy_at(_data + _size);
+    }
+
+    void resize(size_type count) {
+        this->ResizeImpl(count, [](T* slot) { std::construct_at(slot); });
+    }
+
+    void resize(size_type count, const T& value) {
+        this->ResizeImpl(count, [&value](T* slot) { std::construct_at(slot, value); });
+    }
+
+    iterator erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        return this->erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        T* dst = _data + (first - _data);
+        T* src = _data + (last - _data);
+        if (dst == src) {
+            return dst;
+        }
+        T* newEnd = std::move(src, this->end(), dst);
+        std::destroy(newEnd, this->end());
+        _size = static_cast<size_type>(newEnd - _data);
+        return dst;
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        const size_type index = static_cast<size_type>(pos - _data);
+        RADRAY_ASSERT(index <= _size);
+        this->emplace_back(std::forward<Args>(args)...);
+        std::rotate(_data + index, _data + _size - 1, _data + _size);
+        return _data + index;
+    }
+
+    iterator insert(const_iterator pos, const T& value) { return this->emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return this->emplace(pos, std::move(value)); }
+
+    friend bool operator==(const SmallVector& lhs, const SmallVector& rhs) noexcept {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+private:
+    T* InlineData() noexcept { return std::launder(reinterpret_cast<T*>(_inline)); }
+    const T* InlineData() const noexcept { return std::launder(reinterpret_cast<const T*>(_inline)); }
+
+    size_type NextCapacity(size_type required) const noexcept {
+        return std::max(required, _capacity * 2);
+    }
+
+    struct HeapDeleter {
+        size_type Capacity;
+
+        void operator()(T* data) const noexcept { allocator<T>{}.deallocate(data, Capacity); }
+    };
+    /// 尚未被 AdoptHeap 接管的堆块，异常路径上自动归还。
+    using HeapBlock = std::unique_ptr<T, HeapDeleter>;
+
+    static HeapBlock AllocateHeap(size_type capacity) {
+        return HeapBlock{allocator<T>{}.allocate(capacity), HeapDeleter{capacity}};
+    }
+
+    // 把现有元素搬进 dst 的未初始化存储。移动可能抛异常且可以拷贝时改用拷贝（同 std::move_if_noexcept），
+    // 失败时源元素不受影响；uninitialized_* 会析构已构造的部分。
+    void TransferTo(T* dst) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(_data, _size, dst);
+        } else {
+            std::uninitialized_copy_n(_data, _size, dst);
+        }
+    }
+
+    void Reallocate(size_type newCapacity) {
+        HeapBlock block = AllocateHeap(newCapacity);
+        this->TransferTo(block.get());
+        this->AdoptHeap(block.release(), newCapacity);
+    }
+
+    // 销毁旧块里已被搬走的元素并接管新块；_size 保持不变。
+    void AdoptHeap(T* newData, size_type newCapacity) noexcept {
+        std::destroy_n(_data, _size);
+        this->ReleaseHeap();
+        _data = newData;
+        _capacity = newCapacity;
+    }
+
+    void ReleaseHeap() noexcept {
+        if (!this->is_inline()) {
+            allocator<T>{}.deallocate(_data, _capacity);
+            _data = InlineData();
+            _capacity = N;
+        }
+    }
+
+    // 调用前 this 必须为空且处于内联状态。
+    void MoveFrom(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (!other.is_inline()) {
+            _data = other._data;
+            _size = other._size;
+            _capacity = other._capacity;
+            other._data = other.InlineData();
+            other._size = 0;
+            other._capacity = N;
+            return;
+        }
+        std::uninitialized_move_n(other._data, other._size, _data);
+        _size = other._size;
+        other.clear();
+    }
+
+    template <typename Construct>
+    void ResizeImpl(size_type count, Construct&& construct) {
+        if (count <= _size) {
+            std::destroy(_data + count, this->end());
+            _size = count;
+            return;
+        }
+        this->reserve(count);
+        for (; _size < count; ++_size) {
+            construct(_data + _size);
+        }
+    }
+
+    T* _data;
+    size_type _size{0};
+    size_type _capacity{N};
+    alignas(T) std::byte _inline[sizeof(T) * N];
+};
+
+}  // namespace radray
@@ -17,12 +17,23 @@ public:
 
     bool IsValid() const noexcept;
     void ToSimpleMeshResource(MeshResource* outResource) const noexcept;
+    /// 与 ToSimpleMeshResource 相同的交错布局, 属性改存压缩格式:
+    /// - POSITION: UNORM16 x 4, xyz 是相对包围盒最小角、除以最长边的坐标, w 为 1; 反量化参数写进
+    ///   MeshPrimitive::PositionOffset / PositionScale, 误差不超过最长边的 1 / 131070。
+    /// - NORMAL: 八面体编码的 SNORM16 x 2。
+    /// - TEXCOORD: HALF x 2; 有分量绝对值超过 kMaxHalfTexcoord 时 half 精度不够, 保留 FLOAT x 2。
+    /// - TANGENT: UNORM10_10_10_2, xy 是映射到 [0, 1] 的八面体编码, z 为 0, w 为 0 / 1 表示副切线符号 -1 / +1。
+    /// - COLOR: UNORM8 x 4, 先夹到 [0, 1]。
+    /// 索引都小于 65536 时存 16 位。只有位置、法线与 UV 时每顶点从 32 字节降到 16 字节。
+    void ToQuantizedMeshResource(MeshResource* outResource) const noexcept;
 
     void InitAsCube(float halfExtend) noexcept;
     void InitAsUVSphere(float radius, uint32_t numberSlices) noexcept;
     void InitAsRectXY(float width, float height) noexcept;
 
     void CalculateTangent() noexcept;
+
+    static constexpr float kMaxHalfTexcoord = 8.0f;
 };
 
 }  // namespace radray
@@ -9,10 +9,19 @@
 
 namespace radray {
 
+/// 顶点属性的分量类型。FLOAT / UINT / SINT 每分量 4 字节; 其余为压缩格式, 着色器里读到的都是 float:
+/// HALF 为 16 位浮点, xNORM8 / xNORM16 为归一化整数 (UNORM 映射到 [0, 1], SNORM 映射到 [-1, 1])。
+/// UNORM10_10_10_2 只能是 4 分量, 整个属性占一个 32 位字, x 在最低 10 位, w 在最高 2 位。
 enum class VertexDataType : uint16_t {
     FLOAT,
     UINT,
-    SINT
+    SINT,
+    HALF,
+    SNORM8,
+    UNORM8,
+    SNORM16,
+    UNORM16,
+    UNORM10_10_10_2
 };
 
 enum class PrimitiveTopology : int32_t {
@@ -54,6 +63,14 @@ struct IndexBufferEntry {
     uint32_t Stride{0};
 };
 
+/// 一级 LOD 在所属 primitive 索引缓冲里的范围。各级共用同一份顶点缓冲。
+struct MeshLodEntry {
+    uint32_t FirstIndex{0};
+    uint32_t IndexCount{0};
+    /// 相对 LOD0 的几何误差, 网格空间的距离。按视距与投影换算成像素后选级, LOD0 为 0。
+    float Error{0.0f};
+};
+
 class MeshBuffer {
 public:
     MeshBuffer() = default;
@@ -80,6 +97,12 @@ public:
     IndexBufferEntry IndexBuffer{};
     uint32_t VertexCount{0};
     PrimitiveTopology Topology{PrimitiveTopology::TriangleList};
+    /// 由细到粗。为空表示只有一级, 即整个索引缓冲; 非空时 Lods[0] 是 LOD0。
+    vector<MeshLodEntry> Lods;
+    /// 位置的反量化: 网格空间位置 = 解码出的 POSITION.xyz * PositionScale + PositionOffset, 未量化时
+    /// 为 0 与 1。缩放各轴相同, 可以直接并进物体变换而不影响法线方向。
+    Eigen::Vector3f PositionOffset{Eigen::Vector3f::Zero()};
+    float PositionScale{1.0f};
 };
 
 class MeshResource {
@@ -137,9 +160,30 @@ constexpr uint32_t GetVertexDataSizeInBytes(VertexDataType type, uint16_t compon
             return 4 * componentCount;
         case VertexDataType::SINT:
             return 4 * componentCount;
+        case VertexDataType::HALF:
+        case VertexDataType::SNORM16:
+        case VertexDataType::UNORM16:
+            return 2 * componentCount;
+        case VertexDataType::SNORM8:
+        case VertexDataType::UNORM8:
+            return componentCount;
+        case VertexDataType::UNORM10_10_10_2:
+            return componentCount == 4 ? 4 : 0;
         default:
             return 0;
     }
 }
 
+/// 把一个属性解码成 float, 多于 4 个的分量丢弃、缺的分量为 0。整数类型按数值转换, 归一化类型按
+/// 上面的范围映射 (SNORM 的最小值夹到 -1)。src 至少有 GetVertexDataSizeInBytes 个字节, 不要求对齐;
+/// 类型与分量数的组合无效时返回零向量。只解码存储格式, 八面体等语义上的编码由调用方再解。
+Eigen::Vector4f DecodeVertexData(VertexDataType type, uint16_t componentCount, const byte* src) noexcept;
+
+/// 单位向量的八面体映射 (Cigolle et al. 2014): 方向投到 |x| + |y| + |z| = 1 的八面体上, 下半球沿对角
+/// 折到上半球外侧, 结果在 [-1, 1]^2。输入不要求归一化, 零向量得到 (0, 0)。
+Eigen::Vector2f OctahedralEncode(const Eigen::Vector3f& direction) noexcept;
+
+/// OctahedralEncode 的逆, 返回单位向量。
+Eigen::Vector3f OctahedralDecode(const Eigen::Vector2f& encoded) noexcept;
+
 }  // namespace radray
@@ -2,10 +2,13 @@
 
 #include <istream>
 #include <filesystem>
+#include <functional>
+#include <optional>
 #include <span>
 
 #include <radray/types.h>
 #include <radray/basic_math.h>
+#include <radray/file.h>
 
 namespace radray {
 
@@ -25,6 +28,17 @@ public:
     bool IsSmooth;
 };
 
+/// WavefrontObjReader::Read 的分块设置。
+struct WavefrontObjReadOptions {
+    /// 把 [0, count) 分给若干线程执行 body(i), 全部完成才返回 (与 MipChainOptions::ParallelFor 同一签名)。
+    /// 空表示整份文本在调用线程上作为一块解析。
+    std::function<void(uint32_t count, const std::function<void(uint32_t)>& body)> ParallelFor{};
+    /// 每块的最小字节数。块边界对齐到换行之后, 块数不超过 256。
+    size_t MinChunkBytes{size_t{1} << 20};
+};
+
+/// 文本按换行对齐切块, 各块独立解析进自己的顶点 / 面数组, 再按前缀和拼接。
+/// 负 (相对) 索引按规范相对于它之前已定义的元素换算, Faces() 里的索引都是正的 1 基索引。
 class WavefrontObjReader {
 public:
     struct TrianglePosition {
@@ -37,10 +51,14 @@ public:
         Eigen::Vector2f UV1, UV2, UV3;
     };
 
+    /// 在 Read 时把流读完再解析。
     explicit WavefrontObjReader(std::istream* stream);
+    /// 内存映射文件, 不复制文本。
     explicit WavefrontObjReader(const std::filesystem::path& file);
     explicit WavefrontObjReader(string&& text);
     explicit WavefrontObjReader(const string& text);
+    /// 不复制也不持有, text 须活到 Read 返回。
+    explicit WavefrontObjReader(std::span<const byte> text);
 
     bool HasError() const;
     std::string_view Error() const { return _error; }
@@ -51,7 +69,7 @@ public:
     std::span<const string> Mtllibs() const { return _mtllibs; }
     std::span<const WavefrontObjObject> Objects() const { return _objects; }
 
-    void Read();
+    void Read(const WavefrontObjReadOptions& options = {});
     TrianglePosition GetPosition(size_t faceIndex) const;
     TriangleNormal GetNormal(size_t faceIndex) const;
     TriangleTexcoord GetUV(size_t faceIndex) const;
@@ -61,10 +79,12 @@ public:
     bool ToTriangleMesh(std::u8string_view objName, TriangleMesh* mesh) const;
 
 private:
-    void Parse(std::string_view line, int lineNum);
-
-    std::istream* _stream;
-    unique_ptr<std::istream> _myStream;
+    std::istream* _stream{nullptr};
+    string _text;
+    std::optional<MappedFile> _mapping;
+    std::span<const byte> _view;
+    bool _hasSource{false};
+    bool _ownsText{false};
     string _error;
 
     vector<Eigen::Vector3f> _pos;
@@ -75,4 +95,8 @@ private:
     vector<WavefrontObjObject> _objects;
 };
 
+/// MTL 材质库里贴图语句 (map_*、bump、disp、decal、refl、norm) 引用的文件名, 按出现次序去重,
+/// 已剥掉 -o / -clamp 之类的选项。名字是库里的原文, 相对库文件所在目录。
+vector<string> ParseWavefrontMtlTextures(std::string_view text);
+
 }  // namespace radray
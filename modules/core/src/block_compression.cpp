@@ -0,0 +1,775 @@
+#include <radray/block_compression.h>
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RADRAY_BC_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define RADRAY_BC_NEON 1
+#endif
+
+#include <radray/logger.h>
+#include <radray/profiler.h>
+
+namespace radray {
+namespace {
+
+/// 一个 4x4 块按通道分开存放(SoA), 索引选择的内核一次处理 4 个像素。
+struct BlockPixels {
+    alignas(16) float C[4][16];
+};
+
+/// 端点之间的候选颜色, 最多 16 个, 每个 4 通道。
+using Palette = std::array<std::array<float, 4>, 16>;
+
+void LoadBlock(const byte* rgba8, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, BlockPixels& block) noexcept {
+    for (uint32_t y = 0; y < 4; ++y) {
+        const uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+        const byte* row = rgba8 + size_t{sourceY} * width * 4;
+        for (uint32_t x = 0; x < 4; ++x) {
+            const byte* pixel = row + size_t{std::min(blockX * 4 + x, width - 1)} * 4;
+            for (size_t channel = 0; channel < 4; ++channel) {
+                block.C[channel][y * 4 + x] = static_cast<float>(std::to_integer<uint32_t>(pixel[channel]));
+            }
+        }
+    }
+}
+
+/// 为 16 个像素各选 palette 中 [firstChannel, firstChannel + channelCount) 上距离最近的一项,
+/// 返回平方误差之和。距离相同取下标小的, 各实现逐位一致。
+float SelectIndices(
+    const BlockPixels& block,
+    uint32_t firstChannel,
+    uint32_t channelCount,
+    const Palette& palette,
+    uint32_t paletteCount,
+    uint8_t* indices) noexcept {
+#if RADRAY_BC_SSE2
+    __m128 total = _mm_setzero_ps();
+    for (uint32_t group = 0; group < 16; group += 4) {
+        __m128 best = _mm_set1_ps(std::numeric_limits<float>::max());
+        __m128 bestIndex = _mm_setzero_ps();
+        for (uint32_t entry = 0; entry < paletteCount; ++entry) {
+            __m128 distance = _mm_setzero_ps();
+            for (uint32_t channel = firstChannel; channel < firstChannel + channelCount; ++channel) {
+                const __m128 diff = _mm_sub_ps(_mm_load_ps(block.C[channel] + group), _mm_set1_ps(palette[entry][channel]));
+                distance = _mm_add_ps(distance, _mm_mul_ps(diff, diff));
+            }
+            const __m128 closer = _mm_cmplt_ps(distance, best);
+            best = _mm_min_ps(distance, best);
+            bestIndex = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps(static_cast<float>(entry))), _mm_andnot_ps(closer, bestIndex));
+        }
+        total = _mm_add_ps(total, best);
+        const __m128i packed = _mm_cvttps_epi32(bestIndex);
+        alignas(16) int32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), packed);
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            indices[group + lane] = static_cast<uint8_t>(lanes[lane]);
+        }
+    }
+    alignas(16) float sums[4];
+    _mm_store_ps(sums, total);
+    return sums[0] + sums[1] + sums[2] + sums[3];
+#elif RADRAY_BC_NEON
+    float32x4_t total = vdupq_n_f32(0.0f);
+    for (uint32_t group = 0; group < 16; group += 4) {
+        float32x4_t best = vdupq_n_f32(std::numeric_limits<float>::max());
+        uint32x4_t bestIndex = vdupq_n_u32(0);
+        for (uint32_t entry = 0; entry < paletteCount; ++entry) {
+            float32x4_t distance = vdupq_n_f32(0.0f);
+            for (uint32_t channel = firstChannel; channel < firstChannel + channelCount; ++channel) {
+                const float32x4_t diff = vsubq_f32(vld1q_f32(block.C[channel] + group), vdupq_n_f32(palette[entry][channel]));
+                distance = vmlaq_f32(distance, diff, diff);
+            }
+            const uint32x4_t closer = vcltq_f32(distance, best);
+            best = vminq_f32(distance, best);
+            bestIndex = vbslq_u32(closer, vdupq_n_u32(entry), bestIndex);
+        }
+        total = vaddq_f32(total, best);
+        uint32_t lanes[4];
+        vst1q_u32(lanes, bestIndex);
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            indices[group + lane] = static_cast<uint8_t>(lanes[lane]);
+        }
+    }
+    float sums[4];
+    vst1q_f32(sums, total);
+    return sums[0] + sums[1] + sums[2] + sums[3];
+#else
+    float total = 0.0f;
+    for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+        float best = std::numeric_limits<float>::max();
+        uint32_t bestIndex = 0;
+        for (uint32_t entry = 0; entry < paletteCount; ++entry) {
+            float distance = 0.0f;
+            for (uint32_t channel = firstChannel; channel < firstChannel + channelCount; ++channel) {
+                const float diff = block.C[channel][pixel] - palette[entry][channel];
+                distance += diff * diff;
+            }
+            if (distance < best) {
+                best = distance;
+                bestIndex = entry;
+            }
+        }
+        total += best;
+        indices[pixel] = static_cast<uint8_t>(bestIndex);
+    }
+    return total;
+#endif
+}
+
+// ─── 端点拟合 ───
+
+struct EndpointLine {
+    std::array<float, 4> Start{};
+    std::array<float, 4> End{};
+};
+
+/// 主成分方向上的投影极值作为端点。平坦的块两端点重合。
+EndpointLine FitPrincipalAxis(const BlockPixels& block, uint32_t channelCount) noexcept {
+    std::array<float, 4> mean{};
+    for (uint32_t channel = 0; channel < channelCount; ++channel) {
+        float sum = 0.0f;
+        for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+            sum += block.C[channel][pixel];
+        }
+        mean[channel] = sum / 16.0f;
+    }
+    float covariance[4][4]{};
+    for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+        for (uint32_t i = 0; i < channelCount; ++i) {
+            const float di = block.C[i][pixel] - mean[i];
+            for (uint32_t j = i; j < channelCount; ++j) {
+                covariance[i][j] += di * (block.C[j][pixel] - mean[j]);
+            }
+        }
+    }
+    for (uint32_t i = 0; i < channelCount; ++i) {
+        for (uint32_t j = 0; j < i; ++j) {
+            covariance[i][j] = covariance[j][i];
+        }
+    }
+    // 从方差最大的通道所在行出发做幂迭代; 收敛很快, 端点只需要方向大致正确。
+    uint32_t widest = 0;
+    for (uint32_t channel = 1; channel < channelCount; ++channel) {
+        if (covariance[channel][channel] > covariance[widest][widest]) {
+            widest = channel;
+        }
+    }
+    std::array<float, 4> axis{};
+    for (uint32_t channel = 0; channel < channelCount; ++channel) {
+        axis[channel] = covariance[widest][channel];
+    }
+    for (uint32_t iteration = 0; iteration < 8; ++iteration) {
+        std::array<float, 4> next{};
+        float length = 0.0f;
+        for (uint32_t i = 0; i < channelCount; ++i) {
+            for (uint32_t j = 0; j < channelCount; ++j) {
+                next[i] += covariance[i][j] * axis[j];
+            }
+            length = std::max(length, std::abs(next[i]));
+        }
+        if (length < 1e-6f) {
+            break;
+        }
+        for (uint32_t i = 0; i < channelCount; ++i) {
+            axis[i] = next[i] / length;
+        }
+    }
+    float lengthSquared = 0.0f;
+    for (uint32_t channel = 0; channel < channelCount; ++channel) {
+        lengthSquared += axis[channel] * axis[channel];
+    }
+    EndpointLine line{.Start = mean, .End = mean};
+    if (lengthSquared < 1e-12f) {
+        return line;
+    }
+    const float inverseLength = 1.0f / std::sqrt(lengthSquared);
+    float minT = std::numeric_limits<float>::max();
+    float maxT = std::numeric_limits<float>::lowest();
+    for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+        float t = 0.0f;
+        for (uint32_t channel = 0; channel < channelCount; ++channel) {
+            t += (block.C[channel][pixel] - mean[channel]) * axis[channel] * inverseLength;
+        }
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    for (uint32_t channel = 0; channel < channelCount; ++channel) {
+        const float direction = axis[channel] * inverseLength;
+        line.Start[channel] = std::clamp(mean[channel] + direction * minT, 0.0f, 255.0f);
+        line.End[channel] = std::clamp(mean[channel] + direction * maxT, 0.0f, 255.0f);
+    }
+    return line;
+}
+
+/// 最小二乘细化的最多轮数。一般两轮内收敛, 误差不再下降即停。
+constexpr uint32_t kRefineIterations = 3;
+
+/// 已知每个像素的插值权重(0 为 Start, 1 为 End)时, 端点的最小二乘解。方程退化时返回 false。
+bool RefineEndpoints(
+    const BlockPixels& block,
+    uint32_t channelCount,
+    const uint8_t* indices,
+    const float* weights,
+    EndpointLine& line) noexcept {
+    float aa = 0.0f;
+    float bb = 0.0f;
+    float ab = 0.0f;
+    std::array<float, 4> ax{};
+    std::array<float, 4> bx{};
+    for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+        const float b = weights[indices[pixel]];
+        const float a = 1.0f - b;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        for (uint32_t channel = 0; channel < channelCount; ++channel) {
+            ax[channel] += a * block.C[channel][pixel];
+            bx[channel] += b * block.C[channel][pixel];
+        }
+    }
+    const float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f) {
+        return false;
+    }
+    const float inverse = 1.0f / determinant;
+    for (uint32_t channel = 0; channel < channelCount; ++channel) {
+        line.Start[channel] = std::clamp((ax[channel] * bb - bx[channel] * ab) * inverse, 0.0f, 255.0f);
+        line.End[channel] = std::clamp((bx[channel] * aa - ax[channel] * ab) * inverse, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+// ─── BC1 颜色块 ───
+
+uint16_t Pack565(const std::array<float, 4>& color) noexcept {
+    const auto r = static_cast<uint32_t>(color[0] * (31.0f / 255.0f) + 0.5f);
+    const auto g = static_cast<uint32_t>(color[1] * (63.0f / 255.0f) + 0.5f);
+    const auto b = static_cast<uint32_t>(color[2] * (31.0f / 255.0f) + 0.5f);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+std::array<uint32_t, 3> Unpack565(uint16_t packed) noexcept {
+    const uint32_t r = (packed >> 11) & 31;
+    const uint32_t g = (packed >> 5) & 63;
+    const uint32_t b = packed & 31;
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+/// 4 色模式下索引对应的 End(c1) 权重。
+constexpr std::array<float, 4> kBc1Weights{0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+void WriteLe16(byte* out, uint16_t value) noexcept {
+    out[0] = static_cast<byte>(value & 0xff);
+    out[1] = static_cast<byte>(value >> 8);
+}
+
+void WriteLe32(byte* out, uint32_t value) noexcept {
+    for (size_t i = 0; i < 4; ++i) {
+        out[i] = static_cast<byte>((value >> (i * 8)) & 0xff);
+    }
+}
+
+/// 编码一组端点并返回误差。c0 > c1 保证 4 色模式; 两端点量化后相同则全用索引 0,
+/// 这样 BC1 的 3 色模式也不会选到透明黑。
+float TryColorEndpoints(const BlockPixels& block, const EndpointLine& line, byte* out, uint8_t* indices) noexcept {
+    uint16_t c0 = Pack565(line.End);
+    uint16_t c1 = Pack565(line.Start);
+    if (c0 < c1) {
+        std::swap(c0, c1);
+    }
+    const std::array<uint32_t, 3> p0 = Unpack565(c0);
+    const std::array<uint32_t, 3> p1 = Unpack565(c1);
+    Palette palette{};
+    for (size_t channel = 0; channel < 3; ++channel) {
+        const auto a = static_cast<float>(p0[channel]);
+        const auto b = static_cast<float>(p1[channel]);
+        palette[0][channel] = a;
+        palette[1][channel] = b;
+        palette[2][channel] = (2.0f * a + b) / 3.0f;
+        palette[3][channel] = (a + 2.0f * b) / 3.0f;
+    }
+    const float error = SelectIndices(block, 0, 3, palette, c0 == c1 ? 1 : 4, indices);
+    uint32_t packedIndices = 0;
+    for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+        packedIndices |= uint32_t{indices[pixel]} << (pixel * 2);
+    }
+    WriteLe16(out, c0);
+    WriteLe16(out + 2, c1);
+    WriteLe32(out + 4, packedIndices);
+    return error;
+}
+
+void EncodeColorBlock(const BlockPixels& block, byte* out) noexcept {
+    EndpointLine line = FitPrincipalAxis(block, 3);
+    uint8_t indices[16];
+    float error = TryColorEndpoints(block, line, out, indices);
+    // 索引对应排序后的 c0 / c1, 细化得到的 Start 即 c0; TryColorEndpoints 会重新排序, 端点次序无关紧要。
+    for (uint32_t iteration = 0; iteration < kRefineIterations && error > 0.0f; ++iteration) {
+        if (!RefineEndpoints(block, 3, indices, kBc1Weights.data(), line)) {
+            return;
+        }
+        byte refined[8];
+        uint8_t refinedIndices[16];
+        const float refinedError = TryColorEndpoints(block, line, refined, refinedIndices);
+        if (refinedError >= error) {
+            return;
+        }
+        error = refinedError;
+        std::memcpy(out, refined, sizeof(refined));
+        std::memcpy(indices, refinedIndices, sizeof(indices));
+    }
+}
+
+// ─── BC4 单通道块 ───
+
+/// 8 值模式(r0 > r1)下索引 i 的取值。编码与解码共用, 保证选索引时的误差与解码一致。
+uint32_t Bc4Value(uint32_t r0, uint32_t r1, uint32_t index) noexcept {
+    if (index < 2) {
+        return index == 0 ? r0 : r1;
+    }
+    if (r0 > r1) {
+        return ((8 - index) * r0 + (index - 1) * r1 + 3) / 7;
+    }
+    if (index >= 6) {
+        return index == 6 ? 0 : 255;
+    }
+    return ((6 - index) * r0 + (index - 1) * r1 + 2) / 5;
+}
+
+void EncodeSingleChannelBlock(const BlockPixels& block, uint32_t channel, byte* out) noexcept {
+    float low = 255.0f;
+    float high = 0.0f;
+    for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+        low = std::min(low, block.C[channel][pixel]);
+        high = std::max(high, block.C[channel][pixel]);
+    }
+    const auto r0 = static_cast<uint32_t>(high + 0.5f);
+    const auto r1 = static_cast<uint32_t>(low + 0.5f);
+    Palette palette{};
+    for (uint32_t index = 0; index < 8; ++index) {
+        palette[index][channel] = static_cast<float>(Bc4Value(r0, r1, index));
+    }
+    uint8_t indices[16];
+    // r0 == r1 时解码器走 6 值模式, 但索引 0 仍是 r0。
+    SelectIndices(block, channel, 1, palette, r0 == r1 ? 1 : 8, indices);
+    out[0] = static_cast<byte>(r0);
+    out[1] = static_cast<byte>(r1);
+    uint64_t packedIndices = 0;
+    for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+        packedIndices |= uint64_t{indices[pixel]} << (pixel * 3);
+    }
+    for (size_t i = 0; i < 6; ++i) {
+        out[2 + i] = static_cast<byte>((packedIndices >> (i * 8)) & 0xff);
+    }
+}
+
+// ─── BC7 mode 6 ───
+
+constexpr std::array<uint32_t, 16> kBc7Weights4{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+constexpr std::array<float, 16> kBc7RefineWeights{
+    0.0f / 64, 4.0f / 64, 9.0f / 64, 13.0f / 64, 17.0f / 64, 21.0f / 64, 26.0f / 64, 30.0f / 64,
+    34.0f / 64, 38.0f / 64, 43.0f / 64, 47.0f / 64, 51.0f / 64, 55.0f / 64, 60.0f / 64, 64.0f / 64};
+
+uint32_t Bc7Interpolate(uint32_t e0, uint32_t e1, uint32_t index) noexcept {
+    return ((64 - kBc7Weights4[index]) * e0 + kBc7Weights4[index] * e1 + 32) >> 6;
+}
+
+/// mode 6 的端点: 每通道 7 bit + 整个端点共享的 1 个 p-bit, 展开为 (q << 1) | p。
+struct Bc7Endpoint {
+    std::array<uint32_t, 4> Quantized{};
+    uint32_t PBit{0};
+
+    uint32_t Value(size_t channel) const noexcept { return (Quantized[channel] << 1) | PBit; }
+};
+
+Bc7Endpoint QuantizeBc7Endpoint(const std::array<float, 4>& color) noexcept {
+    Bc7Endpoint best;
+    float bestError = std::numeric_limits<float>::max();
+    for (uint32_t pBit = 0; pBit < 2; ++pBit) {
+        Bc7Endpoint candidate{.PBit = pBit};
+        float error = 0.0f;
+        for (size_t channel = 0; channel < 4; ++channel) {
+            const float quantized = std::clamp(std::round((color[channel] - static_cast<float>(pBit)) * 0.5f), 0.0f, 127.0f);
+            candidate.Quantized[channel] = static_cast<uint32_t>(quantized);
+            const float diff = static_cast<float>(candidate.Value(channel)) - color[channel];
+            error += diff * diff;
+        }
+        if (error < bestError) {
+            bestError = error;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+/// 128 bit 的小端位流写入器。
+class BitWriter {
+public:
+    explicit BitWriter(byte* out) noexcept : _out(out) { std::memset(out, 0, 16); }
+
+    void Write(uint32_t value, uint32_t bitCount) noexcept {
+        for (uint32_t bit = 0; bit < bitCount; ++bit, ++_position) {
+            if ((value >> bit) & 1) {
+                _out[_position >> 3] |= static_cast<byte>(1u << (_position & 7));
+            }
+        }
+    }
+
+private:
+    byte* _out;
+    uint32_t _position{0};
+};
+
+class BitReader {
+public:
+    explicit BitReader(const byte* in) noexcept : _in(in) {}
+
+    uint32_t Read(uint32_t bitCount) noexcept {
+        uint32_t value = 0;
+        for (uint32_t bit = 0; bit < bitCount; ++bit, ++_position) {
+            value |= ((std::to_integer<uint32_t>(_in[_position >> 3]) >> (_position & 7)) & 1) << bit;
+        }
+        return value;
+    }
+
+private:
+    const byte* _in;
+    uint32_t _position{0};
+};
+
+float TryBc7Mode6(const BlockPixels& block, const EndpointLine& line, byte* out, uint8_t* indices) noexcept {
+    Bc7Endpoint e0 = QuantizeBc7Endpoint(line.Start);
+    Bc7Endpoint e1 = QuantizeBc7Endpoint(line.End);
+    Palette palette{};
+    for (uint32_t index = 0; index < 16; ++index) {
+        for (size_t channel = 0; channel < 4; ++channel) {
+            palette[index][channel] = static_cast<float>(Bc7Interpolate(e0.Value(channel), e1.Value(channel), index));
+        }
+    }
+    const float error = SelectIndices(block, 0, 4, palette, 16, indices);
+    // 锚点(像素 0)的索引最高位隐含为 0: 不满足时交换端点并翻转全部索引。
+    uint8_t written[16];
+    std::memcpy(written, indices, sizeof(written));
+    if (written[0] & 8) {
+        std::swap(e0, e1);
+        for (uint8_t& index : written) {
+            index = static_cast<uint8_t>(15 - index);
+        }
+    }
+    BitWriter writer{out};
+    writer.Write(1u << 6, 7);
+    for (size_t channel = 0; channel < 4; ++channel) {
+        writer.Write(e0.Quantized[channel], 7);
+        writer.Write(e1.Quantized[channel], 7);
+    }
+    writer.Write(e0.PBit, 1);
+    writer.Write(e1.PBit, 1);
+    writer.Write(written[0], 3);
+    for (uint32_t pixel = 1; pixel < 16; ++pixel) {
+        writer.Write(written[pixel], 4);
+    }
+    return error;
+}
+
+void EncodeBc7Block(const BlockPixels& block, byte* out) noexcept {
+    EndpointLine line = FitPrincipalAxis(block, 4);
+    uint8_t indices[16];
+    float error = TryBc7Mode6(block, line, out, indices);
+    for (uint32_t iteration = 0; iteration < kRefineIterations && error > 0.0f; ++iteration) {
+        if (!RefineEndpoints(block, 4, indices, kBc7RefineWeights.data(), line)) {
+            return;
+        }
+        byte refined[16];
+        uint8_t refinedIndices[16];
+        const float refinedError = TryBc7Mode6(block, line, refined, refinedIndices);
+        if (refinedError >= error) {
+            return;
+        }
+        error = refinedError;
+        std::memcpy(out, refined, sizeof(refined));
+        std::memcpy(indices, refinedIndices, sizeof(indices));
+    }
+}
+
+void EncodeBlock(const BlockPixels& block, BlockFormat format, byte* out) noexcept {
+    switch (format) {
+        case BlockFormat::BC1: EncodeColorBlock(block, out); return;
+        case BlockFormat::BC3:
+            EncodeSingleChannelBlock(block, 3, out);
+            EncodeColorBlock(block, out + 8);
+            return;
+        case BlockFormat::BC4: EncodeSingleChannelBlock(block, 0, out); return;
+        case BlockFormat::BC5:
+            EncodeSingleChannelBlock(block, 0, out);
+            EncodeSingleChannelBlock(block, 1, out + 8);
+            return;
+        case BlockFormat::BC7: EncodeBc7Block(block, out); return;
+    }
+}
+
+// ─── 解码 ───
+
+using DecodedBlock = std::array<std::array<uint8_t, 4>, 16>;
+
+void DecodeColorBlock(const byte* in, bool allowTransparent, DecodedBlock& pixels) noexcept {
+    const auto c0 = static_cast<uint16_t>(std::to_integer<uint32_t>(in[0]) | (std::to_integer<uint32_t>(in[1]) << 8));
+    const auto c1 = static_cast<uint16_t>(std::to_integer<uint32_t>(in[2]) | (std::to_integer<uint32_t>(in[3]) << 8));
+    const std::array<uint32_t, 3> p0 = Unpack565(c0);
+    const std::array<uint32_t, 3> p1 = Unpack565(c1);
+    std::array<std::array<uint8_t, 4>, 4> palette{};
+    const bool fourColor = c0 > c1 || !allowTransparent;
+    for (size_t channel = 0; channel < 3; ++channel) {
+        palette[0][channel] = static_cast<uint8_t>(p0[channel]);
+        palette[1][channel] = static_cast<uint8_t>(p1[channel]);
+        if (fourColor) {
+            palette[2][channel] = static_cast<uint8_t>((2 * p0[channel] + p1[channel] + 1) / 3);
+            palette[3][channel] = static_cast<uint8_t>((p0[channel] + 2 * p1[channel] + 1) / 3);
+        } else {
+            palette[2][channel] = static_cast<uint8_t>((p0[channel] + p1[channel] + 1) / 2);
+        }
+    }
+    palette[0][3] = palette[1][3] = palette[2][3] = 255;
+    palette[3][3] = fourColor ? 255 : 0;
+    uint32_t packedIndices = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        packedIndices |= std::to_integer<uint32_t>(in[4 + i]) << (i * 8);
+    }
+    for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+        pixels[pixel] = palette[(packedIndices >> (pixel * 2)) & 3];
+    }
+}
+
+void DecodeSingleChannelBlock(const byte* in, size_t channel, DecodedBlock& pixels) noexcept {
+    const uint32_t r0 = std::to_integer<uint32_t>(in[0]);
+    const uint32_t r1 = std::to_integer<uint32_t>(in[1]);
+    uint64_t packedIndices = 0;
+    for (size_t i = 0; i < 6; ++i) {
+        packedIndices |= uint64_t{std::to_integer<uint32_t>(in[2 + i])} << (i * 8);
+    }
+    for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+        pixels[pixel][channel] = static_cast<uint8_t>(Bc4Value(r0, r1, static_cast<uint32_t>((packedIndices >> (pixel * 3)) & 7)));
+    }
+}
+
+bool DecodeBc7Block(const byte* in, DecodedBlock& pixels) noexcept {
+    BitReader reader{in};
+    if (reader.Read(7) != (1u << 6)) {
+        pixels = {};
+        return false;
+    }
+    std::array<uint32_t, 4> e0{};
+    std::array<uint32_t, 4> e1{};
+    for (size_t channel = 0; channel < 4; ++channel) {
+        e0[channel] = reader.Read(7) << 1;
+        e1[channel] = reader.Read(7) << 1;
+    }
+    const uint32_t p0 = reader.Read(1);
+    const uint32_t p1 = reader.Read(1);
+    for (size_t channel = 0; channel < 4; ++channel) {
+        e0[channel] |= p0;
+        e1[channel] |= p1;
+    }
+    for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+        const uint32_t index = reader.Read(pixel == 0 ? 3 : 4);
+        for (size_t channel = 0; channel < 4; ++channel) {
+            pixels[pixel][channel] = static_cast<uint8_t>(Bc7Interpolate(e0[channel], e1[channel], index));
+        }
+    }
+    return true;
+}
+
+bool DecodeBlock(const byte* in, BlockFormat format, DecodedBlock& pixels) noexcept {
+    switch (format) {
+        case BlockFormat::BC1: DecodeColorBlock(in, true, pixels); return true;
+        case BlockFormat::BC3:
+            DecodeColorBlock(in + 8, false, pixels);
+            DecodeSingleChannelBlock(in, 3, pixels);
+            return true;
+        case BlockFormat::BC4:
+            for (std::array<uint8_t, 4>& pixel : pixels) {
+                pixel = {0, 0, 0, 255};
+            }
+            DecodeSingleChannelBlock(in, 0, pixels);
+            return true;
+        case BlockFormat::BC5:
+            for (std::array<uint8_t, 4>& pixel : pixels) {
+                pixel = {0, 0, 0, 255};
+            }
+            DecodeSingleChannelBlock(in, 0, pixels);
+            DecodeSingleChannelBlock(in + 8, 1, pixels);
+            return true;
+        case BlockFormat::BC7: return DecodeBc7Block(in, pixels);
+    }
+    return false;
+}
+
+/// 每个分带约 1K 个块 —— 远大于一次 ParallelFor 的调度开销, 又足够把 2K 贴图切成几十份。
+constexpr uint32_t kBandBlocks = 1024;
+constexpr uint32_t kParallelMinBlocks = 4096;
+
+uint32_t GetBlockCount(uint32_t size) noexcept {
+    return (size + 3) / 4;
+}
+
+}  // namespace
+
+uint32_t GetBlockFormatBytes(BlockFormat format) noexcept {
+    switch (format) {
+        case BlockFormat::BC1:
+        case BlockFormat::BC4: return 8;
+        case BlockFormat::BC3:
+        case BlockFormat::BC5:
+        case BlockFormat::BC7: return 16;
+    }
+    return 0;
+}
+
+size_t GetBlockCompressedSize(BlockFormat format, uint32_t width, uint32_t height) noexcept {
+    return size_t{GetBlockCount(width)} * GetBlockCount(height) * GetBlockFormatBytes(format);
+}
+
+bool CompressRgba8Blocks(
+    std::span<const byte> rgba8,
+    uint32_t width,
+    uint32_t height,
+    BlockFormat format,
+    std::span<byte> destination,
+    const MipParallelFor& parallelFor) {
+    if (width == 0 || height == 0 ||
+        rgba8.size() != size_t{width} * height * 4 ||
+        destination.size() != GetBlockCompressedSize(format, width, height)) {
+        return false;
+    }
+    RADRAY_PROFILE_SCOPE("CompressRgba8Blocks");
+    const uint32_t blocksWide = GetBlockCount(width);
+    const uint32_t blocksHigh = GetBlockCount(height);
+    const uint32_t blockBytes = GetBlockFormatBytes(format);
+    const auto encodeRows = [&](uint32_t firstRow, uint32_t lastRow) {
+        BlockPixels block;
+        for (uint32_t blockY = firstRow; blockY < lastRow; ++blockY) {
+            byte* out = destination.data() + size_t{blockY} * blocksWide * blockBytes;
+            for (uint32_t blockX = 0; blockX < blocksWide; ++blockX, out += blockBytes) {
+                LoadBlock(rgba8.data(), width, height, blockX, blockY, block);
+                EncodeBlock(block, format, out);
+            }
+        }
+    };
+    const uint32_t bandRows = std::clamp(kBandBlocks / blocksWide, 1u, blocksHigh);
+    const uint32_t bandCount = (blocksHigh + bandRows - 1) / bandRows;
+    if (!parallelFor || bandCount < 2 || size_t{blocksWide} * blocksHigh < kParallelMinBlocks) {
+        encodeRows(0, blocksHigh);
+        return true;
+    }
+    parallelFor(bandCount, [&](uint32_t band) {
+        const uint32_t firstRow = band * bandRows;
+        encodeRows(firstRow, std::min(firstRow + bandRows, blocksHigh));
+    });
+    return true;
+}
+
+bool DecompressBlocksToRgba8(
+    std::span<const byte> blocks,
+    uint32_t width,
+    uint32_t height,
+    BlockFormat format,
+    std::span<byte> destination) {
+    if (width == 0 || height == 0 ||
+        blocks.size() != GetBlockCompressedSize(format, width, height) ||
+        destination.size() != size_t{width} * height * 4) {
+        return false;
+    }
+    const uint32_t blocksWide = GetBlockCount(width);
+    const uint32_t blocksHigh = GetBlockCount(height);
+    const uint32_t blockBytes = GetBlockFormatBytes(format);
+    bool decodedAll = true;
+    DecodedBlock pixels{};
+    for (uint32_t blockY = 0; blockY < blocksHigh; ++blockY) {
+        for (uint32_t blockX = 0; blockX < blocksWide; ++blockX) {
+            const byte* in = blocks.data() + (size_t{blockY} * blocksWide + blockX) * blockBytes;
+            decodedAll = DecodeBlock(in, format, pixels) && decodedAll;
+            for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; ++y) {
+                for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; ++x) {
+                    byte* out = destination.data() + (size_t{blockY * 4 + y} * width + blockX * 4 + x) * 4;
+                    std::memcpy(out, pixels[y * 4 + x].data(), 4);
+                }
+            }
+        }
+    }
+    return decodedAll;
+}
+
+std::optional<vector<byte>> CompressImage(const ImageData& image, BlockFormat format, const MipParallelFor& parallelFor) {
+    if (image.Format != ImageFormat::RGBA8_BYTE || image.Data == nullptr) {
+        RADRAY_ERR_LOG("CompressImage: expected RGBA8_BYTE pixels, got {}", image.Format);
+        return std::nullopt;
+    }
+    vector<byte> blocks(GetBlockCompressedSize(format, image.Width, image.Height));
+    if (!CompressRgba8Blocks(image.GetSpan(), image.Width, image.Height, format, blocks, parallelFor)) {
+        return std::nullopt;
+    }
+    return blocks;
+}
+
+BlockCompressedMipChain BlockCompressedMipChain::Allocate(BlockFormat format, uint32_t width, uint32_t height, uint32_t levelCount) {
+    BlockCompressedMipChain chain;
+    if (width == 0 || height == 0 || levelCount == 0) {
+        return chain;
+    }
+    chain._format = format;
+    chain._width = width;
+    chain._height = height;
+    chain._levelCount = std::min(levelCount, GetFullMipLevelCount(width, height));
+    chain._size = chain.GetLevelOffset(chain._levelCount);
+    chain._data = std::make_unique_for_overwrite<byte[]>(chain._size);
+    return chain;
+}
+
+BlockCompressedMipChain BlockCompressedMipChain::Compress(const Rgba8MipChain& mips, BlockFormat format, const MipParallelFor& parallelFor) {
+    if (mips.IsEmpty()) {
+        return {};
+    }
+    BlockCompressedMipChain chain = Allocate(format, mips.GetWidth(), mips.GetHeight(), mips.GetLevelCount());
+    for (uint32_t level = 0; level < chain.GetLevelCount(); ++level) {
+        CompressRgba8Blocks(
+            mips.GetLevel(level),
+            mips.GetLevelWidth(level),
+            mips.GetLevelHeight(level),
+            format,
+            chain.GetLevel(level),
+            parallelFor);
+    }
+    return chain;
+}
+
+size_t BlockCompressedMipChain::GetLevelOffset(uint32_t level) const noexcept {
+    size_t offset = 0;
+    for (uint32_t i = 0; i < level; ++i) {
+        offset += GetBlockCompressedSize(_format, GetLevelWidth(i), GetLevelHeight(i));
+    }
+    return offset;
+}
+
+std::span<const byte> BlockCompressedMipChain::GetLevel(uint32_t level) const noexcept {
+    if (level >= _levelCount) {
+        return {};
+    }
+    return {_data.get() + GetLevelOffset(level), GetBlockCompressedSize(_format, GetLevelWidth(level), GetLevelHeight(level))};
+}
+
+std::span<byte> BlockCompressedMipChain::GetLevel(uint32_t level) noexcept {
+    if (level >= _levelCount) {
+        return {};
+    }
+    return {_data.get() + GetLevelOffset(level), GetBlockCompressedSize(_format, GetLevelWidth(level), GetLevelHeight(level))};
+}
+
+}  // namespace radray
@@ -0,0 +1,110 @@
+#include <radray/coroutine.h>
+
+#include <array>
+#include <new>
+
+namespace radray {
+
+namespace {
+
+constexpr size_t kFrameClassCount = kMaxPooledCoroutineFrameSize / kCoroutineFrameGranularity;
+
+/// 每个 size class 在单个线程上最多缓存的空闲帧数。超出的帧直接还给 operator delete。
+constexpr uint32_t kMaxCachedFramesPerClass = 1024;
+
+struct FreeFrame {
+    FreeFrame* Next;
+};
+
+/// 平凡析构, 线程退出途中仍可安全访问; 清理由 CoroutineFrameCacheOwner 负责。
+struct CoroutineFrameCache {
+    std::array<FreeFrame*, kFrameClassCount> Heads{};
+    std::array<uint32_t, kFrameClassCount> Counts{};
+    bool Armed{false};
+    /// 线程退出后置位, 此后归还的帧不再入缓存。
+    bool Retired{false};
+};
+
+thread_local constinit CoroutineFrameCache t_frameCache{};
+
+constexpr size_t FrameClassOf(size_t size) noexcept {
+    return (size - 1) / kCoroutineFrameGranularity;
+}
+
+constexpr size_t FrameClassSize(size_t frameClass) noexcept {
+    return (frameClass + 1) * kCoroutineFrameGranularity;
+}
+
+/// 线程退出时释放本线程缓存的全部空闲帧。
+struct CoroutineFrameCacheOwner {
+    void Arm() noexcept {}
+
+    ~CoroutineFrameCacheOwner() noexcept {
+        CoroutineFrameCache& cache = t_frameCache;
+        cache.Retired = true;
+        for (size_t frameClass = 0; frameClass < kFrameClassCount; ++frameClass) {
+            FreeFrame* frame = cache.Heads[frameClass];
+            while (frame != nullptr) {
+                FreeFrame* next = frame->Next;
+                ::operator delete(frame, FrameClassSize(frameClass));
+                frame = next;
+            }
+            cache.Heads[frameClass] = nullptr;
+            cache.Counts[frameClass] = 0;
+        }
+    }
+};
+
+thread_local CoroutineFrameCacheOwner t_frameCacheOwner;
+
+}  // namespace
+
+void* AllocateCoroutineFrame(size_t size) {
+    if (size == 0 || size > kMaxPooledCoroutineFrameSize) {
+        return ::operator new(size);
+    }
+    const size_t frameClass = FrameClassOf(size);
+    CoroutineFrameCache& cache = t_frameCache;
+    FreeFrame* frame = cache.Heads[frameClass];
+    if (frame == nullptr) {
+        return ::operator new(FrameClassSize(frameClass));
+    }
+    cache.Heads[frameClass] = frame->Next;
+    --cache.Counts[frameClass];
+    return frame;
+}
+
+void FreeCoroutineFrame(void* frame, size_t size) noexcept {
+    if (frame == nullptr) {
+        return;
+    }
+    if (size == 0 || size > kMaxPooledCoroutineFrameSize) {
+        ::operator delete(frame, size);
+        return;
+    }
+    const size_t frameClass = FrameClassOf(size);
+    CoroutineFrameCache& cache = t_frameCache;
+    if (cache.Retired || cache.Counts[frameClass] >= kMaxCachedFramesPerClass) {
+        ::operator delete(frame, FrameClassSize(frameClass));
+        return;
+    }
+    if (!cache.Armed) {
+        // 首次缓存时才触碰带析构的 thread_local, 让不用协程的线程不注册退出回调。
+        t_frameCacheOwner.Arm();
+        cache.Armed = true;
+    }
+    FreeFrame* node = ::new (frame) FreeFrame{cache.Heads[frameClass]};
+    cache.Heads[frameClass] = node;
+    ++cache.Counts[frameClass];
+}
+
+size_t GetCachedCoroutineFrameCount() noexcept {
+    const CoroutineFrameCache& cache = t_frameCache;
+    size_t count = 0;
+    for (uint32_t classCount : cache.Counts) {
+        count += classCount;
+    }
+    return count;
+}
+
+}  // namespace radray
@@ -1,6 +1,7 @@
 #include <radray/file.h>
 
 #include <fstream>
+#include <utility>
 
 #if defined(RADRAY_PLATFORM_WINDOWS)
 #include <radray/platform/win32_headers.h>
@@ -12,6 +13,13 @@
 #include <climits>
 #endif
 
+#if !defined(RADRAY_PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace radray {
 
 std::optional<string> ReadTextFile(const std::filesystem::path& filepath) noexcept {
@@ -86,6 +94,97 @@ bool WriteBinaryFile(const std::filesystem::path& filepath, std::span<const byte
     return static_cast<bool>(file);
 }
 
+std::optional<MappedFile> MappedFile::Open(const std::filesystem::path& filepath) noexcept {
+    MappedFile mapped{};
+#if defined(RADRAY_PLATFORM_WINDOWS)
+    HANDLE file = ::CreateFileW(
+        filepath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::nullopt;
+    }
+    LARGE_INTEGER size{};
+    if (!::GetFileSizeEx(file, &size) || static_cast<uint64_t>(size.QuadPart) > SIZE_MAX) {
+        ::CloseHandle(file);
+        return std::nullopt;
+    }
+    if (size.QuadPart == 0) {
+        ::CloseHandle(file);
+        return mapped;
+    }
+    // 视图持有对 mapping 的引用，两个句柄在 MapViewOfFile 之后即可关闭。
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(file);
+    if (mapping == nullptr) {
+        return std::nullopt;
+    }
+    void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mapping);
+    if (view == nullptr) {
+        return std::nullopt;
+    }
+    mapped._data = static_cast<const byte*>(view);
+    mapped._size = static_cast<size_t>(size.QuadPart);
+#else
+    const int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    if (info.st_size == 0) {
+        ::close(fd);
+        return mapped;
+    }
+    void* view = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return std::nullopt;
+    }
+    mapped._data = static_cast<const byte*>(view);
+    mapped._size = static_cast<size_t>(info.st_size);
+#endif
+    return mapped;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data(std::exchange(other._data, nullptr)),
+      _size(std::exchange(other._size, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() noexcept {
+    Close();
+}
+
+void MappedFile::Close() noexcept {
+    if (_data == nullptr) {
+        return;
+    }
+#if defined(RADRAY_PLATFORM_WINDOWS)
+    ::UnmapViewOfFile(_data);
+#else
+    ::munmap(const_cast<byte*>(_data), _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+}
+
 std::filesystem::path GetExecutableDirectory() noexcept {
 #if defined(RADRAY_PLATFORM_WINDOWS)
     std::wstring buf;
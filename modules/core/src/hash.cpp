@@ -1,5 +1,6 @@
 #include <radray/hash.h>
 
+#define XXH_STATIC_LINKING_ONLY
 #include <xxhash.h>
 
 namespace radray {
@@ -18,4 +19,18 @@ uint64_t HashData64(const void* data, size_t size) noexcept {
     return XXH64(data, size, 0);
 }
 
+static_assert(sizeof(XXH64_state_t) <= sizeof(HashStream64) && alignof(XXH64_state_t) <= 8);
+
+HashStream64::HashStream64() noexcept {
+    XXH64_reset(reinterpret_cast<XXH64_state_t*>(_state), 0);
+}
+
+void HashStream64::Update(const void* data, size_t size) noexcept {
+    XXH64_update(reinterpret_cast<XXH64_state_t*>(_state), data, size);
+}
+
+uint64_t HashStream64::GetDigest() const noexcept {
+    return XXH64_digest(reinterpret_cast<const XXH64_state_t*>(_state));
+}
+
 }  // namespace radray
@@ -21,6 +21,7 @@
 #include <radray/logger.h>
 #include <radray/utility.h>
 #include <radray/memory.h>
+#include <radray/pixel_convert.h>
 #include <radray/scope_guard.h>
 
 namespace radray {
@@ -81,28 +82,7 @@ ImageData ImageData::RGB8ToRGBA8(uint8_t alpha_) const noexcept {
     }
     RADRAY_ASSERT(Format == ImageFormat::RGB8_BYTE);
     RADRAY_ASSERT(Data);
-
-    ImageData dstImg;
-    dstImg.Width = Width;
-    dstImg.Height = Height;
-    dstImg.Format = ImageFormat::RGBA8_BYTE;
-    dstImg.Data = make_unique<byte[]>(dstImg.GetSize());
-
-    const size_t row = static_cast<size_t>(Width);
-    const size_t srcStride = row * 3;
-    const size_t dstStride = row * 4;
-    byte a_ = static_cast<byte>(alpha_);
-    const byte* src_ = Data.get();
-    byte* dst_ = dstImg.Data.get();
-    for (size_t j = 0; j < Height; j++, src_ += srcStride, dst_ += dstStride) {
-        const byte* src = src_;
-        byte* dst = dst_;
-        for (size_t i = 0; i < row; i++, src += 3, dst += 4) {
-            byte r = src[0], g = src[1], b = src[2], a = a_;
-            dst[0] = r, dst[1] = g, dst[2] = b, dst[3] = a;
-        }
-    }
-    return dstImg;
+    return ConvertImage(*this, ImageFormat::RGBA8_BYTE, PixelConvertOptions{.Alpha = alpha_});
 }
 
 void ImageData::FlipY() noexcept {
@@ -229,11 +209,43 @@ bool ImageData::IsPNG(std::istream& stream) {
     stream.clear(original_state);
     return is_png;
 }
-std::optional<ImageData> ImageData::LoadPNG(std::istream& stream, PNGLoadSettings settings) {
-    if (!stream.good()) {
-        RADRAY_ERR_LOG("stream is not good");
-        return std::nullopt;
+struct PngMemorySource {
+    const byte* Data;
+    size_t Size;
+    size_t Offset;
+};
+
+static void radray_libpng_memory_read_fn(png_structp png_ptr, png_bytep data, png_size_t length) {
+    auto* source = static_cast<PngMemorySource*>(png_get_io_ptr(png_ptr));
+    if (length > source->Size - source->Offset) {
+        png_error(png_ptr, "read past end of PNG data");
+    }
+    std::memcpy(data, source->Data + source->Offset, length);
+    source->Offset += length;
+}
+
+static ImageFormat _PngImageFormat(png_byte color_type, png_byte bit_depth) {
+    if (bit_depth != 8 && bit_depth != 16) {
+        throw LibpngException("unsupported PNG bit depth");
     }
+    const bool is16 = bit_depth == 16;
+    switch (color_type) {
+        case PNG_COLOR_TYPE_GRAY: return is16 ? ImageFormat::R16_USHORT : ImageFormat::R8_BYTE;
+        case PNG_COLOR_TYPE_GRAY_ALPHA: return is16 ? ImageFormat::RG16_USHORT : ImageFormat::RG8_BYTE;
+        case PNG_COLOR_TYPE_RGB: return is16 ? ImageFormat::RGB16_USHORT : ImageFormat::RGB8_BYTE;
+        case PNG_COLOR_TYPE_RGB_ALPHA: return is16 ? ImageFormat::RGBA16_USHORT : ImageFormat::RGBA8_BYTE;
+        default: throw LibpngException("unsupported PNG color type");
+    }
+}
+
+// LoadPNG / ReadPNGHeader / DecodePNG 共用: 读头并按 settings 设好变换。target 与 owned 都为空时只返回头;
+// owned 非空时分配紧密排列的整图缓冲, 否则解码进 target。
+static std::optional<ImageHeader> _DecodePNG(
+    png_rw_ptr read_fn,
+    void* io,
+    const PNGLoadSettings& settings,
+    const ImageDecodeTarget* target,
+    unique_ptr<byte[]>* owned) {
     png_structp png_ptr = nullptr;
     png_infop info_ptr = nullptr;
     auto guard_png_ptr = MakeScopeGuard([&]() {
@@ -255,7 +267,7 @@ std::optional<ImageData> ImageData::LoadPNG(std::istream& stream, PNGLoadSetting
         if (!info_ptr) {
             throw LibpngException("png_create_info_struct failed");
         }
-        png_set_read_fn(png_ptr, &stream, radray_libpng_read_fn);
+        png_set_read_fn(png_ptr, io, read_fn);
 #if PNG_LIBPNG_VER >= 10600
 #ifdef PNG_MAXIMUM_INFLATE_WINDOW
         png_set_option(png_ptr, PNG_MAXIMUM_INFLATE_WINDOW, PNG_OPTION_ON);
@@ -301,72 +313,42 @@ std::optional<ImageData> ImageData::LoadPNG(std::istream& stream, PNGLoadSetting
         height = png_get_image_height(png_ptr, info_ptr);
         bit_depth = png_get_bit_depth(png_ptr, info_ptr);
         color_type = png_get_color_type(png_ptr, info_ptr);
+        const ImageHeader header{
+            .Width = static_cast<uint32_t>(width),
+            .Height = static_cast<uint32_t>(height),
+            .Format = _PngImageFormat(color_type, bit_depth)};
         const size_t height_sz = static_cast<size_t>(height);
         const size_t rowbytes = static_cast<size_t>(png_get_rowbytes(png_ptr, info_ptr));
-        if (rowbytes == 0 || height_sz == 0) {
+        if (rowbytes == 0 || rowbytes != _SafeMulSize(header.Width, ImageData::FormatSize(header.Format))) {
             throw LibpngException("png rowbytes invalid");
         }
-        const size_t image_byte_size = _SafeMulSize(rowbytes, height_sz);
-        auto image_data = make_unique<radray::byte[]>(image_byte_size);
+        if (target == nullptr && owned == nullptr) {
+            return header;
+        }
         static_assert(sizeof(radray::byte) == sizeof(png_byte), "what");
         static_assert(std::is_trivial_v<radray::byte> && std::is_trivial_v<png_byte>, "what");
         static_assert(std::is_standard_layout_v<radray::byte> && std::is_standard_layout_v<png_byte>, "what");
-        vector<png_bytep> row_pointers(height_sz);
-        png_bytep base_ptr = reinterpret_cast<png_bytep>(image_data.get());
-        if (settings.IsFlipY) {
-            png_bytep row = base_ptr + (height_sz - 1) * rowbytes;
-            for (size_t i = 0; i < height_sz; ++i, row -= rowbytes) {
-                row_pointers[i] = row;
-            }
+        ImageDecodeTarget destination{};
+        if (owned != nullptr) {
+            const size_t image_byte_size = _SafeMulSize(rowbytes, height_sz);
+            *owned = make_unique<radray::byte[]>(image_byte_size);
+            destination = ImageDecodeTarget{.Data = {owned->get(), image_byte_size}, .RowPitch = rowbytes};
         } else {
-            png_bytep row = base_ptr;
-            for (size_t i = 0; i < height_sz; ++i, row += rowbytes) {
-                row_pointers[i] = row;
-            }
+            destination = *target;
+        }
+        const size_t pitch = destination.RowPitch == 0 ? rowbytes : destination.RowPitch;
+        if (pitch < rowbytes || destination.Data.size() < _SafeMulSize(pitch, height_sz - 1) + rowbytes) {
+            throw LibpngException("png decode target too small");
+        }
+        vector<png_bytep> row_pointers(height_sz);
+        png_bytep base_ptr = reinterpret_cast<png_bytep>(destination.Data.data());
+        for (size_t i = 0; i < height_sz; ++i) {
+            const size_t dst_row = settings.IsFlipY ? height_sz - 1 - i : i;
+            row_pointers[i] = base_ptr + dst_row * pitch;
         }
         png_read_image(png_ptr, row_pointers.data());
         png_read_end(png_ptr, nullptr);
-        ImageData imgData;
-        imgData.Data = std::move(image_data);
-        imgData.Width = static_cast<uint32_t>(width);
-        imgData.Height = static_cast<uint32_t>(height);
-        switch (color_type) {
-            case PNG_COLOR_TYPE_GRAY: {
-                switch (bit_depth) {
-                    case 8: imgData.Format = ImageFormat::R8_BYTE; break;
-                    case 16: imgData.Format = ImageFormat::R16_USHORT; break;
-                    default: throw LibpngException("unsupported PNG bit depth");
-                }
-                break;
-            }
-            case PNG_COLOR_TYPE_GRAY_ALPHA: {
-                switch (bit_depth) {
-                    case 8: imgData.Format = ImageFormat::RG8_BYTE; break;
-                    case 16: imgData.Format = ImageFormat::RG16_USHORT; break;
-                    default: throw LibpngException("unsupported PNG bit depth");
-                }
-                break;
-            }
-            case PNG_COLOR_TYPE_RGB: {
-                switch (bit_depth) {
-                    case 8: imgData.Format = ImageFormat::RGB8_BYTE; break;
-                    case 16: imgData.Format = ImageFormat::RGB16_USHORT; break;
-                    default: throw LibpngException("unsupported PNG bit depth");
-                }
-                break;
-            }
-            case PNG_COLOR_TYPE_RGB_ALPHA: {
-                switch (bit_depth) {
-                    case 8: imgData.Format = ImageFormat::RGBA8_BYTE; break;
-                    case 16: imgData.Format = ImageFormat::RGBA16_USHORT; break;
-                    default: throw LibpngException("unsupported PNG bit depth");
-                }
-                break;
-            }
-            default: throw LibpngException("unsupported PNG color type");
-        }
-        RADRAY_ASSERT(image_byte_size == imgData.GetSize());
-        return std::make_optional(std::move(imgData));
+        return header;
     } catch (LibpngException& e) {
         RADRAY_ERR_LOG("LibpngException: {}", e.what());
         return std::nullopt;
@@ -376,6 +358,48 @@ std::optional<ImageData> ImageData::LoadPNG(std::istream& stream, PNGLoadSetting
     }
 }
 
+static std::optional<ImageData> _LoadPNG(png_rw_ptr read_fn, void* io, const PNGLoadSettings& settings) {
+    unique_ptr<byte[]> data;
+    const std::optional<ImageHeader> header = _DecodePNG(read_fn, io, settings, nullptr, &data);
+    if (!header.has_value()) {
+        return std::nullopt;
+    }
+    ImageData imgData;
+    imgData.Data = std::move(data);
+    imgData.Width = header->Width;
+    imgData.Height = header->Height;
+    imgData.Format = header->Format;
+    return std::make_optional(std::move(imgData));
+}
+
+std::optional<ImageData> ImageData::LoadPNG(std::istream& stream, PNGLoadSettings settings) {
+    if (!stream.good()) {
+        RADRAY_ERR_LOG("stream is not good");
+        return std::nullopt;
+    }
+    return _LoadPNG(radray_libpng_read_fn, &stream, settings);
+}
+
+bool ImageData::IsPNG(std::span<const byte> encoded) noexcept {
+    return encoded.size() >= PNG_SIG_SIZE &&
+           png_sig_cmp(reinterpret_cast<png_const_bytep>(encoded.data()), 0, PNG_SIG_SIZE) == 0;
+}
+
+std::optional<ImageData> ImageData::LoadPNG(std::span<const byte> encoded, PNGLoadSettings settings) {
+    PngMemorySource source{encoded.data(), encoded.size(), 0};
+    return _LoadPNG(radray_libpng_memory_read_fn, &source, settings);
+}
+
+std::optional<ImageHeader> ImageData::ReadPNGHeader(std::span<const byte> encoded, const PNGLoadSettings& settings) {
+    PngMemorySource source{encoded.data(), encoded.size(), 0};
+    return _DecodePNG(radray_libpng_memory_read_fn, &source, settings, nullptr, nullptr);
+}
+
+std::optional<ImageHeader> ImageData::DecodePNG(std::span<const byte> encoded, const ImageDecodeTarget& target, PNGLoadSettings settings) {
+    PngMemorySource source{encoded.data(), encoded.size(), 0};
+    return _DecodePNG(radray_libpng_memory_read_fn, &source, settings, &target, nullptr);
+}
+
 bool ImageData::WritePNG(PNGWriteSettings settings) const {
     if (settings.FilePath.empty()) {
         RADRAY_ERR_LOG("WritePNG file path is empty");
@@ -484,6 +508,29 @@ std::optional<ImageData> ImageData::LoadPNG(std::istream& stream, PNGLoadSetting
     RADRAY_ERR_LOG("libpng support is not enabled");
     return std::nullopt;
 }
+bool ImageData::IsPNG(std::span<const byte> encoded) noexcept {
+    RADRAY_UNUSED(encoded);
+    return false;
+}
+std::optional<ImageData> ImageData::LoadPNG(std::span<const byte> encoded, PNGLoadSettings settings) {
+    RADRAY_UNUSED(encoded);
+    RADRAY_UNUSED(settings);
+    RADRAY_ERR_LOG("libpng support is not enabled");
+    return std::nullopt;
+}
+std::optional<ImageHeader> ImageData::ReadPNGHeader(std::span<const byte> encoded, const PNGLoadSettings& settings) {
+    RADRAY_UNUSED(encoded);
+    RADRAY_UNUSED(settings);
+    RADRAY_ERR_LOG("libpng support is not enabled");
+    return std::nullopt;
+}
+std::optional<ImageHeader> ImageData::DecodePNG(std::span<const byte> encoded, const ImageDecodeTarget& target, PNGLoadSettings settings) {
+    RADRAY_UNUSED(encoded);
+    RADRAY_UNUSED(target);
+    RADRAY_UNUSED(settings);
+    RADRAY_ERR_LOG("libpng support is not enabled");
+    return std::nullopt;
+}
 
 bool ImageData::WritePNG(PNGWriteSettings settings) const {
     RADRAY_UNUSED(settings);
@@ -583,10 +630,17 @@ bool ImageData::IsJPEG(std::istream& stream) {
     return is_jpeg;
 }
 
-std::optional<ImageData> ImageData::LoadJPEG(std::istream& stream, JPEGLoadSettings settings) {
-    vector<byte> encoded;
-    if (!ReadStreamToBytes(stream, encoded)) {
-        RADRAY_ERR_LOG("failed to read JPEG stream");
+namespace {
+
+// LoadJPEG / ReadJPEGHeader / DecodeJPEG 共用, target 与 owned 的含义同 _DecodePNG。
+std::optional<ImageHeader> DecodeJpeg(
+    std::span<const byte> encoded,
+    const JPEGLoadSettings& settings,
+    const ImageDecodeTarget* target,
+    unique_ptr<byte[]>* owned) {
+    const uint32_t scale = settings.ScaleDenominator;
+    if (scale != 1 && scale != 2 && scale != 4 && scale != 8) {
+        RADRAY_ERR_LOG("unsupported JPEG scale denominator: {}", scale);
         return std::nullopt;
     }
 
@@ -605,55 +659,118 @@ std::optional<ImageData> ImageData::LoadJPEG(std::istream& stream, JPEGLoadSetti
             reinterpret_cast<const unsigned char*>(encoded.data()),
             static_cast<unsigned long>(encoded.size()));
         jpeg_read_header(&cinfo, TRUE);
+        const bool add_alpha = settings.AddAlphaIfRGB.has_value();
+        const uint8_t alpha = static_cast<uint8_t>(std::min(settings.AddAlphaIfRGB.value_or(0xFFu), 0xFFu));
         cinfo.out_color_space = JCS_RGB;
-        jpeg_start_decompress(&cinfo);
-
-        const uint32_t width = static_cast<uint32_t>(cinfo.output_width);
-        const uint32_t height = static_cast<uint32_t>(cinfo.output_height);
+#ifdef JCS_ALPHA_EXTENSIONS
+        // libjpeg-turbo 直接输出 RGBA (alpha 固定 0xFF), 省去逐行补 alpha。
+        if (add_alpha && alpha == 0xFF) {
+            cinfo.out_color_space = JCS_EXT_RGBA;
+        }
+#endif
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = scale;
+        jpeg_calc_output_dimensions(&cinfo);
+
+        const ImageHeader header{
+            .Width = static_cast<uint32_t>(cinfo.output_width),
+            .Height = static_cast<uint32_t>(cinfo.output_height),
+            .Format = add_alpha ? ImageFormat::RGBA8_BYTE : ImageFormat::RGB8_BYTE};
         const uint32_t channels = static_cast<uint32_t>(cinfo.output_components);
-        if (width == 0 || height == 0 || channels != 3) {
-            RADRAY_ERR_LOG("unsupported JPEG output dimensions/channels: {}x{}x{}", width, height, channels);
+        if (header.Width == 0 || header.Height == 0 || (channels != 3 && channels != 4)) {
+            RADRAY_ERR_LOG("unsupported JPEG output dimensions/channels: {}x{}x{}", header.Width, header.Height, channels);
             return std::nullopt;
         }
+        if (target == nullptr && owned == nullptr) {
+            return header;
+        }
 
-        ImageData img;
-        img.Width = width;
-        img.Height = height;
-        img.Format = settings.AddAlphaIfRGB.has_value() ? ImageFormat::RGBA8_BYTE : ImageFormat::RGB8_BYTE;
-        img.Data = make_unique<byte[]>(img.GetSize());
+        const size_t width = header.Width;
+        const size_t height = header.Height;
+        const size_t dst_pixel_size = ImageData::FormatSize(header.Format);
+        const size_t row_bytes = width * dst_pixel_size;
+        ImageDecodeTarget destination{};
+        if (owned != nullptr) {
+            *owned = make_unique<byte[]>(row_bytes * height);
+            destination = ImageDecodeTarget{.Data = {owned->get(), row_bytes * height}, .RowPitch = row_bytes};
+        } else {
+            destination = *target;
+        }
+        const size_t pitch = destination.RowPitch == 0 ? row_bytes : destination.RowPitch;
+        if (pitch < row_bytes || destination.Data.size() < pitch * (height - 1) + row_bytes) {
+            RADRAY_ERR_LOG("JPEG decode target too small for {}x{}", header.Width, header.Height);
+            return std::nullopt;
+        }
 
-        vector<unsigned char> scanline(static_cast<size_t>(width) * channels);
-        const size_t dst_pixel_size = ImageData::FormatSize(img.Format);
+        jpeg_start_decompress(&cinfo);
+        // 输出通道与目标一致时 libjpeg 直接写进目标行; 否则先解到 scanline 再补 alpha。
+        const bool direct = channels == dst_pixel_size;
+        vector<unsigned char> scanline(direct ? 0 : width * channels);
         while (cinfo.output_scanline < cinfo.output_height) {
-            const uint32_t src_y = static_cast<uint32_t>(cinfo.output_scanline);
-            unsigned char* row_ptr = scanline.data();
+            const size_t src_y = static_cast<size_t>(cinfo.output_scanline);
+            const size_t dst_y = settings.IsFlipY ? (height - 1u - src_y) : src_y;
+            byte* dst = destination.Data.data() + dst_y * pitch;
+            unsigned char* row_ptr = direct ? reinterpret_cast<unsigned char*>(dst) : scanline.data();
             jpeg_read_scanlines(&cinfo, &row_ptr, 1);
-
-            const uint32_t dst_y = settings.IsFlipY ? (height - 1u - src_y) : src_y;
-            byte* dst = img.Data.get() + static_cast<size_t>(dst_y) * width * dst_pixel_size;
-            if (img.Format == ImageFormat::RGB8_BYTE) {
-                std::memcpy(dst, scanline.data(), scanline.size());
-            } else {
-                const byte alpha = static_cast<byte>(std::min(settings.AddAlphaIfRGB.value(), 0xFFu));
-                for (uint32_t x = 0; x < width; ++x) {
-                    const size_t src_i = static_cast<size_t>(x) * 3u;
-                    const size_t dst_i = static_cast<size_t>(x) * 4u;
-                    dst[dst_i + 0] = static_cast<byte>(scanline[src_i + 0]);
-                    dst[dst_i + 1] = static_cast<byte>(scanline[src_i + 1]);
-                    dst[dst_i + 2] = static_cast<byte>(scanline[src_i + 2]);
-                    dst[dst_i + 3] = alpha;
-                }
+            if (!direct) {
+                ConvertPixels(
+                    ImageFormat::RGB8_BYTE,
+                    std::as_bytes(std::span{scanline}),
+                    ImageFormat::RGBA8_BYTE,
+                    std::span<byte>{dst, row_bytes},
+                    header.Width,
+                    1,
+                    PixelConvertOptions{.Alpha = alpha});
             }
         }
 
         jpeg_finish_decompress(&cinfo);
-        return std::make_optional(std::move(img));
+        return header;
     } catch (const LibjpegException& e) {
         RADRAY_ERR_LOG("libjpeg error: {}", e.what());
         return std::nullopt;
     }
 }
 
+}  // namespace
+
+std::optional<ImageData> ImageData::LoadJPEG(std::istream& stream, JPEGLoadSettings settings) {
+    vector<byte> encoded;
+    if (!ReadStreamToBytes(stream, encoded)) {
+        RADRAY_ERR_LOG("failed to read JPEG stream");
+        return std::nullopt;
+    }
+    return LoadJPEG(std::span<const byte>{encoded}, settings);
+}
+
+bool ImageData::IsJPEG(std::span<const byte> encoded) noexcept {
+    return encoded.size() >= 2 &&
+           encoded[0] == static_cast<byte>(0xFF) &&
+           encoded[1] == static_cast<byte>(0xD8);
+}
+
+std::optional<ImageData> ImageData::LoadJPEG(std::span<const byte> encoded, JPEGLoadSettings settings) {
+    unique_ptr<byte[]> data;
+    const std::optional<ImageHeader> header = DecodeJpeg(encoded, settings, nullptr, &data);
+    if (!header.has_value()) {
+        return std::nullopt;
+    }
+    ImageData img;
+    img.Data = std::move(data);
+    img.Width = header->Width;
+    img.Height = header->Height;
+    img.Format = header->Format;
+    return std::make_optional(std::move(img));
+}
+
+std::optional<ImageHeader> ImageData::ReadJPEGHeader(std::span<const byte> encoded, const JPEGLoadSettings& settings) {
+    return DecodeJpeg(encoded, settings, nullptr, nullptr);
+}
+
+std::optional<ImageHeader> ImageData::DecodeJPEG(std::span<const byte> encoded, const ImageDecodeTarget& target, JPEGLoadSettings settings) {
+    return DecodeJpeg(encoded, settings, &target, nullptr);
+}
+
 #else
 bool ImageData::IsJPEG(std::istream& stream) {
     RADRAY_UNUSED(stream);
@@ -667,6 +784,33 @@ std::optional<ImageData> ImageData::LoadJPEG(std::istream& stream, JPEGLoadSetti
     RADRAY_ERR_LOG("libjpeg support is not enabled");
     return std::nullopt;
 }
+
+bool ImageData::IsJPEG(std::span<const byte> encoded) noexcept {
+    RADRAY_UNUSED(encoded);
+    return false;
+}
+
+std::optional<ImageData> ImageData::LoadJPEG(std::span<const byte> encoded, JPEGLoadSettings settings) {
+    RADRAY_UNUSED(encoded);
+    RADRAY_UNUSED(settings);
+    RADRAY_ERR_LOG("libjpeg support is not enabled");
+    return std::nullopt;
+}
+
+std::optional<ImageHeader> ImageData::ReadJPEGHeader(std::span<const byte> encoded, const JPEGLoadSettings& settings) {
+    RADRAY_UNUSED(encoded);
+    RADRAY_UNUSED(settings);
+    RADRAY_ERR_LOG("libjpeg support is not enabled");
+    return std::nullopt;
+}
+
+std::optional<ImageHeader> ImageData::DecodeJPEG(std::span<const byte> encoded, const ImageDecodeTarget& target, JPEGLoadSettings settings) {
+    RADRAY_UNUSED(encoded);
+    RADRAY_UNUSED(target);
+    RADRAY_UNUSED(settings);
+    RADRAY_ERR_LOG("libjpeg support is not enabled");
+    return std::nullopt;
+}
 #endif
 
 PixelCompareResult ImageData::CompareImageRGBA8(const ImageData& actual, const ImageData& expected, uint8_t tolerance) noexcept {
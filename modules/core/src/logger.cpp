@@ -1,7 +1,14 @@
 #include <radray/logger.h>
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <mutex>
+#include <thread>
 
 #include <spdlog/spdlog.h>
 #if defined(_WIN32)
@@ -11,6 +18,8 @@
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/pattern_formatter.h>
 
+#include <radray/memory.h>
+
 namespace radray {
 
 class maybe_print_source_loc_formatter : public spdlog::custom_flag_formatter {
@@ -69,9 +78,9 @@ static spdlog::level::level_enum _ToSpdlogLogLevel(LogLevel level) {
     }
 }
 
-void Log(std::source_location loc, LogLevel lvl, fmt::string_view msg) noexcept {
+static void _WriteLog(spdlog::source_loc loc, LogLevel lvl, fmt::string_view msg) noexcept {
     g_logger.log(
-        spdlog::source_loc{loc.file_name(), (int)loc.line(), loc.function_name()},
+        loc,
         _ToSpdlogLogLevel(lvl),
         msg);
 
@@ -87,25 +96,238 @@ void Log(std::source_location loc, LogLevel lvl, fmt::string_view msg) noexcept
     }
 }
 
-#if defined(_WIN32)
-void Log(std::source_location loc, LogLevel lvl, fmt::wstring_view msg) noexcept {
-    g_logger.log(
-        spdlog::source_loc{loc.file_name(), (int)loc.line(), loc.function_name()},
-        _ToSpdlogLogLevel(lvl),
-        msg);
+namespace {
 
-    LogCallback callback = nullptr;
-    void* userData = nullptr;
-    {
-        std::lock_guard<std::mutex> lock(g_logCallback.Mutex);
-        callback = g_logCallback.Callback;
-        userData = g_logCallback.UserData;
+constexpr size_t kAsyncLogInlineTextSize = 200;
+/// 没人催时 flusher 的轮询间隔。生产者只在 ring 实际占用过半且 flusher 正在睡眠时叫醒它，
+/// 每次睡眠至多被生产者叫醒一次；其余时候 Push 不碰锁也不做系统调用。
+constexpr std::chrono::milliseconds kAsyncLogFlushInterval{2};
+
+/// ring buffer 里的一条定长记录（约 256 字节）。Sequence 是 Vyukov 有界队列的槽位序号：
+/// 等于 pos 表示可写，等于 pos + 1 表示已发布、可读。
+struct AsyncLogRecord {
+    std::atomic<uint64_t> Sequence{0};
+    const char* FileName{nullptr};
+    const char* FunctionName{nullptr};
+    uint32_t Line{0};
+    LogLevel Level{LogLevel::Info};
+    uint32_t Length{0};
+    /// 消息超过 InlineText 时由 Malloc 持有，flusher 写完后释放。
+    char* HeapText{nullptr};
+    char InlineText[kAsyncLogInlineTextSize];
+};
+
+class AsyncLogQueue {
+public:
+    AsyncLogQueue(uint32_t capacity, LogOverflowPolicy overflow) noexcept
+        : _records(make_unique<AsyncLogRecord[]>(capacity)),
+          _mask(capacity - 1),
+          _wakeOccupancy(capacity / 2),
+          _overflow(overflow) {
+        for (uint32_t i = 0; i < capacity; ++i) {
+            _records[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+        _flusher = std::thread{[this]() { this->FlusherMain(); }};
     }
-    if (callback != nullptr) {
-        spdlog::memory_buf_t utf8;
-        spdlog::details::os::wstr_to_utf8buf(spdlog::wstring_view_t{msg.data(), msg.size()}, utf8);
-        callback(lvl, std::string_view{utf8.data(), utf8.size()}, userData);
+
+    ~AsyncLogQueue() noexcept {
+        _stopping.store(true, std::memory_order_release);
+        this->Wake();
+        _flusher.join();
     }
+
+    void Push(std::source_location loc, LogLevel lvl, fmt::string_view msg) noexcept {
+        uint64_t pos = 0;
+        while (!this->TryPush(loc, lvl, msg, pos)) {
+            if (_overflow == LogOverflowPolicy::Drop) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            this->WakeIfSleeping();
+            std::this_thread::yield();
+        }
+        if (pos + 1 - _flushedPos.load(std::memory_order_relaxed) >= _wakeOccupancy) {
+            this->WakeIfSleeping();
+        }
+    }
+
+    void Flush() noexcept {
+        const uint64_t target = _enqueuePos.load(std::memory_order_acquire);
+        if (_flushedPos.load(std::memory_order_acquire) >= target) {
+            return;
+        }
+        this->Wake();
+        while (_flushedPos.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+        }
+    }
+
+    bool IsFlusherThread() const noexcept { return std::this_thread::get_id() == _flusher.get_id(); }
+
+    uint64_t DroppedCount() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    bool TryPush(std::source_location loc, LogLevel lvl, fmt::string_view msg, uint64_t& pos) noexcept {
+        AsyncLogRecord* record = nullptr;
+        pos = _enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            record = &_records[pos & _mask];
+            const uint64_t seq = record->Sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        record->FileName = loc.file_name();
+        record->FunctionName = loc.function_name();
+        record->Line = loc.line();
+        record->Level = lvl;
+        record->Length = static_cast<uint32_t>(msg.size());
+        char* text = record->InlineText;
+        if (msg.size() > sizeof(record->InlineText)) {
+            MemoryTagScope memoryTag{MemoryTag::Logging};
+            text = static_cast<char*>(Malloc(msg.size()));
+            if (text == nullptr) {
+                text = record->InlineText;
+                record->Length = static_cast<uint32_t>(sizeof(record->InlineText));
+            }
+        }
+        record->HeapText = text != record->InlineText ? text : nullptr;
+        std::memcpy(text, msg.data(), record->Length);
+        record->Sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool DrainAvailable() noexcept {
+        bool any = false;
+        for (;;) {
+            AsyncLogRecord& record = _records[_dequeuePos & _mask];
+            if (record.Sequence.load(std::memory_order_acquire) != _dequeuePos + 1) {
+                break;
+            }
+            const char* text = record.HeapText != nullptr ? record.HeapText : record.InlineText;
+            _WriteLog(
+                spdlog::source_loc{record.FileName, static_cast<int>(record.Line), record.FunctionName},
+                record.Level,
+                fmt::string_view{text, record.Length});
+            if (record.HeapText != nullptr) {
+                Free(record.HeapText);
+                record.HeapText = nullptr;
+            }
+            record.Sequence.store(_dequeuePos + _mask + 1, std::memory_order_release);
+            ++_dequeuePos;
+            _flushedPos.store(_dequeuePos, std::memory_order_release);
+            any = true;
+        }
+        return any;
+    }
+
+    void FlusherMain() noexcept {
+        uint64_t reportedDrops = 0;
+        for (;;) {
+            if (this->DrainAvailable()) {
+                continue;
+            }
+            const uint64_t dropped = _dropped.load(std::memory_order_relaxed);
+            if (dropped != reportedDrops) {
+                auto str = fmt::format("async log dropped {} message(s)", dropped - reportedDrops);
+                _WriteLog(spdlog::source_loc{"", 0, ""}, LogLevel::Warn, str);
+                reportedDrops = dropped;
+            }
+            g_logger.flush();
+            if (_stopping.load(std::memory_order_acquire)) {
+                if (!this->DrainAvailable()) {
+                    break;
+                }
+                continue;
+            }
+            // 先挂出睡眠标记再复查一次, 标记之前入队的记录不会等满一个轮询间隔。
+            _flusherSleeping.store(true, std::memory_order_seq_cst);
+            if (this->HasPending()) {
+                _flusherSleeping.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock{_wakeMutex};
+            _wakeCondition.wait_for(lock, kAsyncLogFlushInterval, [this]() { return _wakeRequested; });
+            _wakeRequested = false;
+            _flusherSleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    bool HasPending() const noexcept {
+        return _records[_dequeuePos & _mask].Sequence.load(std::memory_order_acquire) == _dequeuePos + 1;
+    }
+
+    /// 生产者侧的唤醒: 只有抢到睡眠标记的那个生产者去拿锁通知, 同一次睡眠里其他调用都是一次原子读。
+    void WakeIfSleeping() noexcept {
+        if (_flusherSleeping.load(std::memory_order_relaxed) &&
+            _flusherSleeping.exchange(false, std::memory_order_acq_rel)) {
+            this->Wake();
+        }
+    }
+
+    void Wake() noexcept {
+        {
+            std::lock_guard<std::mutex> lock{_wakeMutex};
+            _wakeRequested = true;
+        }
+        _wakeCondition.notify_one();
+    }
+
+    unique_ptr<AsyncLogRecord[]> _records;
+    uint64_t _mask;
+    uint64_t _wakeOccupancy;
+    LogOverflowPolicy _overflow;
+    alignas(64) std::atomic<uint64_t> _enqueuePos{0};
+    alignas(64) std::atomic<uint64_t> _flushedPos{0};
+    std::atomic<uint64_t> _dropped{0};
+    std::atomic<bool> _flusherSleeping{false};
+    alignas(64) uint64_t _dequeuePos{0};
+    std::mutex _wakeMutex;
+    std::condition_variable _wakeCondition;
+    bool _wakeRequested{false};
+    std::atomic<bool> _stopping{false};
+    std::thread _flusher;
+};
+
+std::atomic<AsyncLogQueue*> g_asyncLog{nullptr};
+
+/// 进程退出时把剩余记录写完；声明在 g_logger 之后，先于它析构。
+struct AsyncLogShutdown {
+    ~AsyncLogShutdown() noexcept { StopAsyncLog(); }
+};
+
+AsyncLogShutdown g_asyncLogShutdown{};
+
+}  // namespace
+
+void Log(std::source_location loc, LogLevel lvl, fmt::string_view msg) noexcept {
+    AsyncLogQueue* queue = g_asyncLog.load(std::memory_order_acquire);
+    if (queue == nullptr || queue->IsFlusherThread()) {
+        _WriteLog(spdlog::source_loc{loc.file_name(), (int)loc.line(), loc.function_name()}, lvl, msg);
+        return;
+    }
+    if (lvl >= LogLevel::Critical) {
+        // Critical 之后通常紧跟 abort，必须先把前面的日志和它本身同步写出。
+        queue->Flush();
+        _WriteLog(spdlog::source_loc{loc.file_name(), (int)loc.line(), loc.function_name()}, lvl, msg);
+        g_logger.flush();
+        return;
+    }
+    queue->Push(loc, lvl, msg);
+}
+
+#if defined(_WIN32)
+void Log(std::source_location loc, LogLevel lvl, fmt::wstring_view msg) noexcept {
+    spdlog::memory_buf_t utf8;
+    spdlog::details::os::wstr_to_utf8buf(spdlog::wstring_view_t{msg.data(), msg.size()}, utf8);
+    Log(loc, lvl, fmt::string_view{utf8.data(), utf8.size()});
 }
 #endif
 
@@ -114,9 +336,45 @@ bool ShouldLog(LogLevel lvl) noexcept {
 }
 
 void FlushLog() noexcept {
+    AsyncLogQueue* queue = g_asyncLog.load(std::memory_order_acquire);
+    if (queue != nullptr && !queue->IsFlusherThread()) {
+        queue->Flush();
+    }
     g_logger.flush();
 }
 
+bool StartAsyncLog(const AsyncLogDescriptor& desc) noexcept {
+    if (desc.Capacity == 0 || desc.Capacity > (1u << 31)) {
+        return false;
+    }
+    if (g_asyncLog.load(std::memory_order_acquire) != nullptr) {
+        return false;
+    }
+    const uint32_t capacity = std::bit_ceil(std::max(desc.Capacity, 2u));
+    auto queue = make_unique<AsyncLogQueue>(capacity, desc.Overflow);
+    AsyncLogQueue* expected = nullptr;
+    if (!g_asyncLog.compare_exchange_strong(expected, queue.get(), std::memory_order_acq_rel)) {
+        return false;
+    }
+    queue.release();
+    return true;
+}
+
+void StopAsyncLog() noexcept {
+    unique_ptr<AsyncLogQueue> queue{g_asyncLog.exchange(nullptr, std::memory_order_acq_rel)};
+    queue.reset();
+    g_logger.flush();
+}
+
+bool IsAsyncLogEnabled() noexcept {
+    return g_asyncLog.load(std::memory_order_acquire) != nullptr;
+}
+
+uint64_t GetDroppedLogCount() noexcept {
+    AsyncLogQueue* queue = g_asyncLog.load(std::memory_order_acquire);
+    return queue != nullptr ? queue->DroppedCount() : 0;
+}
+
 void SetLogCallback(LogCallback callback, void* userData) noexcept {
     std::lock_guard<std::mutex> lock(g_logCallback.Mutex);
     g_logCallback.Callback = callback;
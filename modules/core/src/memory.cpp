@@ -2,32 +2,388 @@
 
 #include <cstdlib>
 
+#if defined(RADRAY_ENABLE_MEMORY_TRACKING)
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#include <radray/profiler.h>
+#include <radray/types.h>
+#endif
+
 namespace radray {
 
+#ifdef RADRAY_PLATFORM_WINDOWS
+static void* _RawAlignedAlloc(size_t alignment, size_t size) noexcept {
+    return _aligned_malloc(size, alignment);
+}
+
+static void _RawAlignedFree(void* ptr) noexcept {
+    _aligned_free(ptr);
+}
+#else
+static void* _RawAlignedAlloc(size_t alignment, size_t size) noexcept {
+    return std::aligned_alloc(alignment, size);
+}
+
+static void _RawAlignedFree(void* ptr) noexcept {
+    std::free(ptr);
+}
+#endif
+
+std::string_view format_as(MemoryTag tag) noexcept {
+    switch (tag) {
+        case MemoryTag::Untagged: return "Untagged";
+        case MemoryTag::AssetLoading: return "AssetLoading";
+        case MemoryTag::RenderFramework: return "RenderFramework";
+        case MemoryTag::ShaderJit: return "ShaderJit";
+        case MemoryTag::Logging: return "Logging";
+        case MemoryTag::MAX_COUNT: break;
+    }
+    return "Unknown";
+}
+
+#if defined(RADRAY_ENABLE_MEMORY_TRACKING)
+
+namespace {
+
+/// 每块被跟踪的内存前面的头。Offset 是用户指针到底层分配起点的距离。
+struct alignas(16) MemoryBlockHeader {
+    uint64_t Size;
+    uint32_t Offset;
+    MemoryTag Tag;
+};
+
+static_assert(sizeof(MemoryBlockHeader) == 16);
+
+/// 跟踪器自己的簿记直接用 std::malloc。operator new 可能已被替换成 Malloc，经它分配会在
+/// thread_local 计数或注册表初始化的途中重入。
+template <typename T>
+struct UntrackedAllocator {
+    using value_type = T;
+
+    UntrackedAllocator() noexcept = default;
+    template <typename U>
+    UntrackedAllocator(const UntrackedAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        if (void* ptr = std::malloc(count * sizeof(T)); ptr != nullptr) {
+            return static_cast<T*>(ptr);
+        }
+        throw std::bad_alloc{};
+    }
+    void deallocate(T* ptr, size_t) noexcept { std::free(ptr); }
+
+    template <typename U>
+    bool operator==(const UntrackedAllocator<U>&) const noexcept { return true; }
+};
+
+/// 单线程写的计数。用 atomic 只是为了让合并线程读到不撕裂的值，写端只做 relaxed load + store。
+struct ThreadMemoryCounters {
+    std::array<std::atomic<int64_t>, kMemoryTagCount> LiveBytes{};
+    std::array<std::atomic<uint64_t>, kMemoryTagCount> AllocationCount{};
+    std::array<std::atomic<uint64_t>, kMemoryTagCount> FreeCount{};
+    std::atomic<uint64_t> AllocatedBytes{0};
+};
+
+struct MemoryTrackingRegistry {
+    std::mutex Mutex;
+    std::vector<ThreadMemoryCounters*, UntrackedAllocator<ThreadMemoryCounters*>> Threads;
+    /// 已退出线程留下的计数。
+    std::array<MemoryTagStats, kMemoryTagCount> Retired{};
+    uint64_t RetiredAllocatedBytes{0};
+    std::array<int64_t, kMemoryTagCount> Peak{};
+    uint64_t LastSampleAllocationCount{0};
+    uint64_t LastSampleAllocatedBytes{0};
+};
+
+MemoryTrackingRegistry& GetMemoryTrackingRegistry() noexcept {
+    // 有意不析构：静态析构期间仍会有 Free 调进来。放在静态存储里而不是 new 出来，
+    // 否则第一次 operator new 会在这个局部静态变量初始化途中再进来一次。
+    alignas(MemoryTrackingRegistry) static byte storage[sizeof(MemoryTrackingRegistry)];
+    static MemoryTrackingRegistry* registry = ::new (static_cast<void*>(storage)) MemoryTrackingRegistry{};
+    return *registry;
+}
+
+template <typename T>
+void AddRelaxed(std::atomic<T>& counter, T delta) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+class ThreadMemoryCountersHandle {
+public:
+    ThreadMemoryCountersHandle() noexcept {
+        MemoryTrackingRegistry& registry = GetMemoryTrackingRegistry();
+        std::lock_guard<std::mutex> lock{registry.Mutex};
+        registry.Threads.push_back(&_counters);
+    }
+
+    ~ThreadMemoryCountersHandle() noexcept {
+        MemoryTrackingRegistry& registry = GetMemoryTrackingRegistry();
+        std::lock_guard<std::mutex> lock{registry.Mutex};
+        for (size_t i = 0; i < kMemoryTagCount; ++i) {
+            registry.Retired[i].LiveBytes += _counters.LiveBytes[i].load(std::memory_order_relaxed);
+            registry.Retired[i].AllocationCount += _counters.AllocationCount[i].load(std::memory_order_relaxed);
+            registry.Retired[i].FreeCount += _counters.FreeCount[i].load(std::memory_order_relaxed);
+        }
+        registry.RetiredAllocatedBytes += _counters.AllocatedBytes.load(std::memory_order_relaxed);
+        std::erase(registry.Threads, &_counters);
+        _retired = true;
+    }
+
+    /// 线程退出后（thread_local 已析构）仍发生的分配返回 nullptr，不计数。
+    ThreadMemoryCounters* Get() noexcept { return _retired ? nullptr : &_counters; }
+
+private:
+    ThreadMemoryCounters _counters{};
+    bool _retired{false};
+};
+
+thread_local MemoryTag t_memoryTag = MemoryTag::Untagged;
+thread_local ThreadMemoryCountersHandle t_memoryCounters{};
+
+void RecordAllocation(MemoryTag tag, uint64_t size) noexcept {
+    ThreadMemoryCounters* counters = t_memoryCounters.Get();
+    if (counters == nullptr) {
+        return;
+    }
+    const size_t index = static_cast<size_t>(tag);
+    AddRelaxed(counters->LiveBytes[index], static_cast<int64_t>(size));
+    AddRelaxed(counters->AllocationCount[index], uint64_t{1});
+    AddRelaxed(counters->AllocatedBytes, size);
+}
+
+void RecordFree(MemoryTag tag, uint64_t size) noexcept {
+    ThreadMemoryCounters* counters = t_memoryCounters.Get();
+    if (counters == nullptr) {
+        return;
+    }
+    const size_t index = static_cast<size_t>(tag);
+    AddRelaxed(counters->LiveBytes[index], -static_cast<int64_t>(size));
+    AddRelaxed(counters->FreeCount[index], uint64_t{1});
+}
+
+void* FinishTrackedAllocation(void* base, size_t offset, size_t size) noexcept {
+    if (base == nullptr) {
+        return nullptr;
+    }
+    auto* user = static_cast<byte*>(base) + offset;
+    MemoryBlockHeader header{
+        .Size = size,
+        .Offset = static_cast<uint32_t>(offset),
+        .Tag = t_memoryTag};
+    std::memcpy(user - sizeof(MemoryBlockHeader), &header, sizeof(header));
+    RecordAllocation(header.Tag, size);
+    return user;
+}
+
+void* BeginTrackedFree(void* ptr) noexcept {
+    auto* user = static_cast<byte*>(ptr);
+    MemoryBlockHeader header{};
+    std::memcpy(&header, user - sizeof(MemoryBlockHeader), sizeof(header));
+    RecordFree(header.Tag, header.Size);
+    return user - header.Offset;
+}
+
+/// 调用方须持有 registry.Mutex。
+std::array<MemoryTagStats, kMemoryTagCount> MergeLocked(MemoryTrackingRegistry& registry, uint64_t* allocatedBytes) noexcept {
+    std::array<MemoryTagStats, kMemoryTagCount> result = registry.Retired;
+    uint64_t bytes = registry.RetiredAllocatedBytes;
+    for (const ThreadMemoryCounters* counters : registry.Threads) {
+        for (size_t i = 0; i < kMemoryTagCount; ++i) {
+            result[i].LiveBytes += counters->LiveBytes[i].load(std::memory_order_relaxed);
+            result[i].AllocationCount += counters->AllocationCount[i].load(std::memory_order_relaxed);
+            result[i].FreeCount += counters->FreeCount[i].load(std::memory_order_relaxed);
+        }
+        bytes += counters->AllocatedBytes.load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < kMemoryTagCount; ++i) {
+        registry.Peak[i] = std::max(registry.Peak[i], result[i].LiveBytes);
+        result[i].PeakBytes = registry.Peak[i];
+    }
+    if (allocatedBytes != nullptr) {
+        *allocatedBytes = bytes;
+    }
+    return result;
+}
+
+constexpr std::array<const char*, kMemoryTagCount> kLiveBytesCounterNames{
+    "Memory::Untagged::LiveBytes",
+    "Memory::AssetLoading::LiveBytes",
+    "Memory::RenderFramework::LiveBytes",
+    "Memory::ShaderJit::LiveBytes",
+    "Memory::Logging::LiveBytes"};
+
+}  // namespace
+
 void* Malloc(size_t size) noexcept {
-    return std::malloc(size);
+    constexpr size_t offset = sizeof(MemoryBlockHeader);
+    return FinishTrackedAllocation(std::malloc(size + offset), offset, size);
 }
 
 void Free(void* ptr) noexcept {
-    std::free(ptr);
+    if (ptr == nullptr) {
+        return;
+    }
+    std::free(BeginTrackedFree(ptr));
 }
 
-#ifdef RADRAY_PLATFORM_WINDOWS
 void* AlignedAlloc(size_t alignment, size_t size) noexcept {
-    return _aligned_malloc(size, alignment);
+    const size_t offset = std::max(alignment, sizeof(MemoryBlockHeader));
+    // aligned_alloc 要求 size 是 alignment 的倍数，offset 已经是，尾部向上取整。
+    const size_t rawSize = (size + offset + alignment - 1) / alignment * alignment;
+    return FinishTrackedAllocation(_RawAlignedAlloc(alignment, rawSize), offset, size);
 }
 
 void AlignedFree(void* ptr) noexcept {
-    _aligned_free(ptr);
+    if (ptr == nullptr) {
+        return;
+    }
+    _RawAlignedFree(BeginTrackedFree(ptr));
+}
+
+MemoryTagScope::MemoryTagScope(MemoryTag tag) noexcept
+    : _previous(t_memoryTag) {
+    t_memoryTag = tag;
+}
+
+MemoryTagScope::~MemoryTagScope() noexcept {
+    t_memoryTag = _previous;
+}
+
+MemoryTag GetCurrentMemoryTag() noexcept {
+    return t_memoryTag;
+}
+
+MemoryTagStats GetMemoryTagStats(MemoryTag tag) noexcept {
+    return GetAllMemoryTagStats()[static_cast<size_t>(tag)];
 }
+
+std::array<MemoryTagStats, kMemoryTagCount> GetAllMemoryTagStats() noexcept {
+    MemoryTrackingRegistry& registry = GetMemoryTrackingRegistry();
+    std::lock_guard<std::mutex> lock{registry.Mutex};
+    return MergeLocked(registry, nullptr);
+}
+
+MemoryFrameSample SampleMemoryFrame() noexcept {
+    MemoryTrackingRegistry& registry = GetMemoryTrackingRegistry();
+    std::array<MemoryTagStats, kMemoryTagCount> stats{};
+    MemoryFrameSample sample{};
+    {
+        std::lock_guard<std::mutex> lock{registry.Mutex};
+        uint64_t allocatedBytes = 0;
+        stats = MergeLocked(registry, &allocatedBytes);
+        uint64_t allocationCount = 0;
+        for (const MemoryTagStats& tagStats : stats) {
+            allocationCount += tagStats.AllocationCount;
+        }
+        sample.AllocationCount = allocationCount - registry.LastSampleAllocationCount;
+        sample.AllocatedBytes = allocatedBytes - registry.LastSampleAllocatedBytes;
+        registry.LastSampleAllocationCount = allocationCount;
+        registry.LastSampleAllocatedBytes = allocatedBytes;
+    }
+    RADRAY_PROFILE_COUNTER("Memory::FrameAllocations", sample.AllocationCount);
+    RADRAY_PROFILE_COUNTER("Memory::FrameAllocatedBytes", sample.AllocatedBytes);
+    for (size_t i = 0; i < kMemoryTagCount; ++i) {
+        RADRAY_PROFILE_COUNTER(kLiveBytesCounterNames[i], stats[i].LiveBytes);
+    }
+    return sample;
+}
+
+#if defined(RADRAY_MEMORY_TRACKING_REPLACES_NEW)
+
+namespace {
+
+void* NewTracked(size_t size) {
+    for (;;) {
+        if (void* ptr = Malloc(size == 0 ? 1 : size); ptr != nullptr) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+}
+
+void* NewTrackedAligned(size_t size, std::align_val_t alignment) {
+    for (;;) {
+        if (void* ptr = AlignedAlloc(static_cast<size_t>(alignment), size == 0 ? 1 : size); ptr != nullptr) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+}
+
+}  // namespace
+
+#endif
+
 #else
+
+void* Malloc(size_t size) noexcept {
+    return std::malloc(size);
+}
+
+void Free(void* ptr) noexcept {
+    std::free(ptr);
+}
+
 void* AlignedAlloc(size_t alignment, size_t size) noexcept {
-    return std::aligned_alloc(alignment, size);
+    return _RawAlignedAlloc(alignment, size);
 }
 
 void AlignedFree(void* ptr) noexcept {
-    std::free(ptr);
+    _RawAlignedFree(ptr);
 }
+
 #endif
 
 }  // namespace radray
+
+#if defined(RADRAY_MEMORY_TRACKING_REPLACES_NEW)
+
+// 打开跟踪时替换全局 operator new / delete，让 std::allocator（即 radray::allocator，
+// vector / string 等容器都经由它）、make_unique 与 new 表达式都走 Malloc 记账。
+// 这个翻译单元总会被链接进来（Malloc / MemoryTagScope 都在这里），替换对整个进程生效。
+// 与 mimalloc-override 同时链接的非 Windows 构建不定义它们，见 memory.h。
+
+void* operator new(std::size_t size) { return radray::NewTracked(size); }
+void* operator new[](std::size_t size) { return radray::NewTracked(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return radray::NewTrackedAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return radray::NewTrackedAligned(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return radray::Malloc(size == 0 ? 1 : size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return radray::Malloc(size == 0 ? 1 : size);
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return radray::AlignedAlloc(static_cast<std::size_t>(alignment), size == 0 ? 1 : size);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return radray::AlignedAlloc(static_cast<std::size_t>(alignment), size == 0 ? 1 : size);
+}
+
+void operator delete(void* ptr) noexcept { radray::Free(ptr); }
+void operator delete[](void* ptr) noexcept { radray::Free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { radray::Free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { radray::Free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { radray::Free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { radray::Free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { radray::AlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { radray::AlignedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { radray::AlignedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { radray::AlignedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { radray::AlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { radray::AlignedFree(ptr); }
+
+#endif
@@ -0,0 +1,424 @@
+#include <radray/mesh_optimizer.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#include <radray/hash.h>
+#include <radray/profiler.h>
+#include <radray/triangle_mesh.h>
+
+namespace radray {
+namespace {
+
+constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+/// 时间戳实现的 FIFO 缓存: 顶点在最近 cacheSize 次缺失之内进过缓存即命中。
+class FifoCacheSimulator {
+public:
+    FifoCacheSimulator(size_t vertexCount, uint32_t cacheSize)
+        : _timestamps(vertexCount, 0),
+          _cacheSize(std::max(cacheSize, 1u)),
+          _time(_cacheSize + 1) {}
+
+    /// 返回 1 表示缺失 (顶点被变换)。越界的顶点总是缺失。
+    uint32_t Touch(uint32_t vertex) noexcept {
+        if (vertex >= _timestamps.size()) {
+            return 1;
+        }
+        if (_time - _timestamps[vertex] > _cacheSize) {
+            _timestamps[vertex] = _time++;
+            return 1;
+        }
+        return 0;
+    }
+
+    uint32_t TouchTriangle(const uint32_t* triangle) noexcept {
+        return Touch(triangle[0]) + Touch(triangle[1]) + Touch(triangle[2]);
+    }
+
+    /// 清空缓存。
+    void Reset() noexcept { _time += _cacheSize + 1; }
+
+private:
+    vector<uint64_t> _timestamps;
+    uint64_t _cacheSize;
+    uint64_t _time;
+};
+
+/// 顶点到三角形的邻接表 (CSR)。
+struct TriangleAdjacency {
+    vector<uint32_t> Offsets;
+    vector<uint32_t> Triangles;
+
+    std::span<const uint32_t> Get(uint32_t vertex) const noexcept {
+        return std::span{Triangles}.subspan(Offsets[vertex], Offsets[vertex + 1] - Offsets[vertex]);
+    }
+    uint32_t GetCount(uint32_t vertex) const noexcept { return Offsets[vertex + 1] - Offsets[vertex]; }
+};
+
+TriangleAdjacency BuildTriangleAdjacency(std::span<const uint32_t> indices, size_t vertexCount) {
+    TriangleAdjacency adjacency;
+    adjacency.Offsets.assign(vertexCount + 1, 0);
+    const size_t triangleCount = indices.size() / 3;
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        adjacency.Offsets[indices[i] + 1]++;
+    }
+    for (size_t v = 0; v < vertexCount; v++) {
+        adjacency.Offsets[v + 1] += adjacency.Offsets[v];
+    }
+    adjacency.Triangles.resize(triangleCount * 3);
+    vector<uint32_t> cursor(adjacency.Offsets.begin(), adjacency.Offsets.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        adjacency.Triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+    return adjacency;
+}
+
+bool AreIndicesInRange(std::span<const uint32_t> indices, size_t vertexCount) noexcept {
+    return std::all_of(indices.begin(), indices.end(), [vertexCount](uint32_t i) { return i < vertexCount; });
+}
+
+/// 按 remap (旧下标 -> 新下标, kInvalidIndex 表示丢弃) 重排一路属性。属性为空时不动。
+template <class T>
+void RemapAttribute(vector<T>& attribute, std::span<const uint32_t> remap, size_t newCount) {
+    if (attribute.empty()) {
+        return;
+    }
+    vector<T> remapped(newCount);
+    for (size_t v = 0; v < remap.size(); v++) {
+        if (remap[v] != kInvalidIndex) {
+            remapped[remap[v]] = attribute[v];
+        }
+    }
+    attribute = std::move(remapped);
+}
+
+void RemapVertices(TriangleMesh& mesh, std::span<const uint32_t> remap, size_t newCount) {
+    RemapAttribute(mesh.Positions, remap, newCount);
+    RemapAttribute(mesh.Normals, remap, newCount);
+    RemapAttribute(mesh.UV0, remap, newCount);
+    RemapAttribute(mesh.Tangents, remap, newCount);
+    RemapAttribute(mesh.Color0, remap, newCount);
+    for (uint32_t& index : mesh.Indices) {
+        index = remap[index];
+    }
+}
+
+/// 把一路属性的位模式追加进每个顶点的键。
+template <int N>
+void AppendVertexKeys(
+    const vector<Eigen::Matrix<float, N, 1>>& attribute,
+    vector<uint32_t>& keys,
+    size_t stride,
+    size_t& offset) noexcept {
+    if (attribute.empty()) {
+        return;
+    }
+    for (size_t v = 0; v < attribute.size(); v++) {
+        uint32_t* key = keys.data() + v * stride + offset;
+        std::memcpy(key, attribute[v].data(), sizeof(float) * N);
+        for (int c = 0; c < N; c++) {
+            // -0 与 +0 渲染结果相同, 按同一个值合并。
+            key[c] = key[c] == 0x80000000u ? 0u : key[c];
+        }
+    }
+    offset += N;
+}
+
+}  // namespace
+
+VertexCacheStatistics AnalyzeVertexCache(
+    std::span<const uint32_t> indices,
+    size_t vertexCount,
+    uint32_t cacheSize) noexcept {
+    VertexCacheStatistics stats{};
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return stats;
+    }
+    FifoCacheSimulator cache{vertexCount, cacheSize};
+    for (size_t t = 0; t < triangleCount; t++) {
+        stats.VerticesTransformed += cache.TouchTriangle(indices.data() + t * 3);
+    }
+    stats.Acmr = static_cast<float>(stats.VerticesTransformed) / static_cast<float>(triangleCount);
+    stats.Atvr = vertexCount == 0 ? 0.0f : static_cast<float>(stats.VerticesTransformed) / static_cast<float>(vertexCount);
+    return stats;
+}
+
+size_t WeldVertices(TriangleMesh& mesh) {
+    RADRAY_PROFILE_SCOPE("WeldVertices");
+    const size_t vertexCount = mesh.Positions.size();
+    if (vertexCount == 0 || !AreIndicesInRange(mesh.Indices, vertexCount)) {
+        return vertexCount;
+    }
+    const size_t stride = 3 +
+                          (mesh.Normals.empty() ? 0 : 3) +
+                          (mesh.UV0.empty() ? 0 : 2) +
+                          (mesh.Tangents.empty() ? 0 : 4) +
+                          (mesh.Color0.empty() ? 0 : 4);
+    vector<uint32_t> keys(vertexCount * stride);
+    size_t offset = 0;
+    AppendVertexKeys(mesh.Positions, keys, stride, offset);
+    AppendVertexKeys(mesh.Normals, keys, stride, offset);
+    AppendVertexKeys(mesh.UV0, keys, stride, offset);
+    AppendVertexKeys(mesh.Tangents, keys, stride, offset);
+    AppendVertexKeys(mesh.Color0, keys, stride, offset);
+
+    // 开放寻址表, 装填率不超过一半。表项是该键第一次出现的顶点。
+    const size_t tableSize = std::bit_ceil(vertexCount * 2);
+    const size_t mask = tableSize - 1;
+    vector<uint32_t> table(tableSize, kInvalidIndex);
+    vector<uint32_t> remap(vertexCount);
+    const size_t keyBytes = stride * sizeof(uint32_t);
+    uint32_t uniqueCount = 0;
+    for (size_t v = 0; v < vertexCount; v++) {
+        const uint32_t* key = keys.data() + v * stride;
+        size_t slot = HashData(key, keyBytes) & mask;
+        while (table[slot] != kInvalidIndex &&
+               std::memcmp(keys.data() + table[slot] * stride, key, keyBytes) != 0) {
+            slot = (slot + 1) & mask;
+        }
+        if (table[slot] == kInvalidIndex) {
+            table[slot] = static_cast<uint32_t>(v);
+            remap[v] = uniqueCount++;
+        } else {
+            remap[v] = remap[table[slot]];
+        }
+    }
+    if (uniqueCount == vertexCount) {
+        return vertexCount;
+    }
+    // 重复顶点与其代表按位相同, 写进同一个新下标无妨。
+    RemapVertices(mesh, remap, uniqueCount);
+    return uniqueCount;
+}
+
+void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+    RADRAY_PROFILE_SCOPE("OptimizeVertexCache");
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2 || vertexCount == 0 || !AreIndicesInRange(indices.first(triangleCount * 3), vertexCount)) {
+        return;
+    }
+    const uint64_t k = std::max(cacheSize, 3u);
+    const TriangleAdjacency adjacency = BuildTriangleAdjacency(indices, vertexCount);
+    vector<uint32_t> live(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        live[v] = adjacency.GetCount(v);
+    }
+    vector<uint64_t> cacheTime(vertexCount, 0);
+    uint64_t time = k + 1;
+    vector<uint8_t> emitted(triangleCount, 0);
+    vector<uint32_t> deadEnd;
+    deadEnd.reserve(triangleCount * 3);
+    vector<uint32_t> candidates;
+    vector<uint32_t> order;
+    order.reserve(triangleCount);
+
+    uint32_t cursor = 0;
+    const auto nextLiveVertex = [&live, &cursor, vertexCount]() {
+        while (cursor < vertexCount && live[cursor] == 0) {
+            cursor++;
+        }
+        return cursor < vertexCount ? cursor : kInvalidIndex;
+    };
+
+    uint32_t fan = nextLiveVertex();
+    while (fan != kInvalidIndex) {
+        candidates.clear();
+        for (uint32_t t : adjacency.Get(fan)) {
+            if (emitted[t] != 0) {
+                continue;
+            }
+            emitted[t] = 1;
+            order.push_back(t);
+            for (size_t j = 0; j < 3; j++) {
+                const uint32_t v = indices[t * 3 + j];
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - cacheTime[v] > k) {
+                    cacheTime[v] = time++;
+                }
+            }
+        }
+        // 优先取扇完之后仍在缓存里的顶点; 越早进缓存 (越快被挤出) 越优先。
+        uint32_t best = kInvalidIndex;
+        int64_t bestPriority = -1;
+        for (uint32_t v : candidates) {
+            if (live[v] == 0) {
+                continue;
+            }
+            const uint64_t age = time - cacheTime[v];
+            const int64_t priority = age + 2 * uint64_t{live[v]} <= k ? static_cast<int64_t>(age) : 0;
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = v;
+            }
+        }
+        while (best == kInvalidIndex && !deadEnd.empty()) {
+            const uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v] > 0) {
+                best = v;
+            }
+        }
+        fan = best != kInvalidIndex ? best : nextLiveVertex();
+    }
+
+    vector<uint32_t> source(indices.begin(), indices.begin() + triangleCount * 3);
+    for (size_t i = 0; i < order.size(); i++) {
+        std::copy_n(source.data() + size_t{order[i]} * 3, 3, indices.data() + i * 3);
+    }
+}
+
+void OptimizeOverdraw(
+    std::span<uint32_t> indices,
+    std::span<const Eigen::Vector3f> positions,
+    uint32_t cacheSize,
+    float threshold) {
+    RADRAY_PROFILE_SCOPE("OptimizeOverdraw");
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2 || !AreIndicesInRange(indices.first(triangleCount * 3), positions.size())) {
+        return;
+    }
+    FifoCacheSimulator cache{positions.size(), cacheSize};
+
+    // 三个顶点都不在缓存里的三角形通常开始了一片与前面无关的区域, 在那里硬切。
+    vector<uint32_t> hardStarts;
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (cache.TouchTriangle(indices.data() + t * 3) == 3) {
+            hardStarts.push_back(static_cast<uint32_t>(t));
+        }
+    }
+    if (hardStarts.empty() || hardStarts.front() != 0) {
+        hardStarts.insert(hardStarts.begin(), 0);
+    }
+    hardStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+    // 硬簇内: 从簇头 (空缓存) 起累计的 ACMR 回落到 threshold 倍硬簇 ACMR 以内就软切。
+    // 切开的簇各自从空缓存开始, 因此之后任意重排都不会比这里算的更差。
+    vector<uint32_t> clusterStarts;
+    for (size_t h = 0; h + 1 < hardStarts.size(); h++) {
+        const uint32_t begin = hardStarts[h];
+        const uint32_t end = hardStarts[h + 1];
+        cache.Reset();
+        uint32_t hardMisses = 0;
+        for (uint32_t t = begin; t < end; t++) {
+            hardMisses += cache.TouchTriangle(indices.data() + size_t{t} * 3);
+        }
+        const float limit = static_cast<float>(hardMisses) / static_cast<float>(end - begin) * threshold;
+        cache.Reset();
+        clusterStarts.push_back(begin);
+        uint32_t start = begin;
+        uint32_t misses = 0;
+        for (uint32_t t = begin; t < end; t++) {
+            misses += cache.TouchTriangle(indices.data() + size_t{t} * 3);
+            if (t + 1 < end && static_cast<float>(misses) <= limit * static_cast<float>(t + 1 - start)) {
+                start = t + 1;
+                misses = 0;
+                cache.Reset();
+                clusterStarts.push_back(start);
+            }
+        }
+    }
+    clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+    const size_t clusterCount = clusterStarts.size() - 1;
+    if (clusterCount < 2) {
+        return;
+    }
+
+    // 面积加权的质心与法线和。
+    struct ClusterShape {
+        Eigen::Vector3f CentroidSum{Eigen::Vector3f::Zero()};
+        Eigen::Vector3f NormalSum{Eigen::Vector3f::Zero()};
+        float Area{0.0f};
+    };
+    vector<ClusterShape> shapes(clusterCount);
+    ClusterShape mesh{};
+    for (size_t c = 0; c < clusterCount; c++) {
+        ClusterShape& shape = shapes[c];
+        for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++) {
+            const Eigen::Vector3f& p0 = positions[indices[size_t{t} * 3 + 0]];
+            const Eigen::Vector3f& p1 = positions[indices[size_t{t} * 3 + 1]];
+            const Eigen::Vector3f& p2 = positions[indices[size_t{t} * 3 + 2]];
+            const Eigen::Vector3f normal = (p1 - p0).cross(p2 - p0);
+            const float area = normal.norm() * 0.5f;
+            shape.CentroidSum += (p0 + p1 + p2) * (area / 3.0f);
+            shape.NormalSum += normal;
+            shape.Area += area;
+        }
+        mesh.CentroidSum += shape.CentroidSum;
+        mesh.Area += shape.Area;
+    }
+    if (mesh.Area <= 0.0f) {
+        return;
+    }
+    const Eigen::Vector3f meshCentroid = mesh.CentroidSum / mesh.Area;
+    vector<float> sortKeys(clusterCount, 0.0f);
+    for (size_t c = 0; c < clusterCount; c++) {
+        const ClusterShape& shape = shapes[c];
+        const float normalLength = shape.NormalSum.norm();
+        if (shape.Area > 0.0f && normalLength > 0.0f) {
+            const Eigen::Vector3f centroid = shape.CentroidSum / shape.Area;
+            sortKeys[c] = (centroid - meshCentroid).dot(shape.NormalSum / normalLength);
+        }
+    }
+    vector<uint32_t> clusterOrder(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; c++) {
+        clusterOrder[c] = c;
+    }
+    // 越朝外的簇越先画, 它们更可能挡住朝内的簇。
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&sortKeys](uint32_t a, uint32_t b) {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    vector<uint32_t> source(indices.begin(), indices.begin() + triangleCount * 3);
+    size_t write = 0;
+    for (uint32_t c : clusterOrder) {
+        const size_t first = size_t{clusterStarts[c]} * 3;
+        const size_t count = size_t{clusterStarts[c + 1]} * 3 - first;
+        std::copy_n(source.data() + first, count, indices.data() + write);
+        write += count;
+    }
+}
+
+size_t OptimizeVertexFetch(TriangleMesh& mesh) {
+    RADRAY_PROFILE_SCOPE("OptimizeVertexFetch");
+    const size_t vertexCount = mesh.Positions.size();
+    if (!AreIndicesInRange(mesh.Indices, vertexCount)) {
+        return vertexCount;
+    }
+    vector<uint32_t> remap(vertexCount, kInvalidIndex);
+    uint32_t next = 0;
+    for (uint32_t index : mesh.Indices) {
+        if (remap[index] == kInvalidIndex) {
+            remap[index] = next++;
+        }
+    }
+    RemapVertices(mesh, remap, next);
+    return next;
+}
+
+bool OptimizeMesh(TriangleMesh& mesh, const MeshOptimizeOptions& options) {
+    RADRAY_PROFILE_SCOPE("OptimizeMesh");
+    if (!mesh.IsValid() || !AreIndicesInRange(mesh.Indices, mesh.Positions.size())) {
+        return false;
+    }
+    if (options.WeldVertices) {
+        WeldVertices(mesh);
+    }
+    if (options.OptimizeVertexCache) {
+        OptimizeVertexCache(mesh.Indices, mesh.Positions.size(), options.CacheSize);
+        if (options.OptimizeOverdraw) {
+            OptimizeOverdraw(mesh.Indices, mesh.Positions, options.CacheSize, options.OverdrawThreshold);
+        }
+    }
+    if (options.OptimizeVertexFetch) {
+        OptimizeVertexFetch(mesh);
+    }
+    return true;
+}
+
+}  // namespace radray
@@ -0,0 +1,475 @@
+#include <radray/mesh_simplifier.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include <radray/hash.h>
+#include <radray/mesh_optimizer.h>
+#include <radray/profiler.h>
+#include <radray/triangle_mesh.h>
+
+namespace radray {
+namespace {
+
+constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+/// 边界平面二次型的权重, 乘在边长平方上。与相邻面 (面积约为边长平方的一半) 相比足够大,
+/// 边界点离开边界的代价远高于在面内滑动。
+constexpr double kBoundaryWeight = 10.0;
+
+/// 一趟内可接受的代价相对第 goal 便宜候选的倍数。
+constexpr double kPassCostRatio = 1.5;
+
+/// 对称 4x4 矩阵的上三角, 与一组平面的距离平方之和。Weight 是面二次型的面积和, 用来把和化成均值。
+struct Quadric {
+    double A00{0}, A01{0}, A02{0}, A11{0}, A12{0}, A22{0};
+    double B0{0}, B1{0}, B2{0};
+    double C{0};
+    double Weight{0};
+
+    /// n 须是单位向量, 平面为 n·x + d = 0。
+    static Quadric FromPlane(const Eigen::Vector3d& n, double d, double weight) noexcept {
+        Quadric q;
+        q.A00 = weight * n.x() * n.x();
+        q.A01 = weight * n.x() * n.y();
+        q.A02 = weight * n.x() * n.z();
+        q.A11 = weight * n.y() * n.y();
+        q.A12 = weight * n.y() * n.z();
+        q.A22 = weight * n.z() * n.z();
+        q.B0 = weight * n.x() * d;
+        q.B1 = weight * n.y() * d;
+        q.B2 = weight * n.z() * d;
+        q.C = weight * d * d;
+        return q;
+    }
+
+    Quadric& operator+=(const Quadric& other) noexcept {
+        A00 += other.A00, A01 += other.A01, A02 += other.A02;
+        A11 += other.A11, A12 += other.A12, A22 += other.A22;
+        B0 += other.B0, B1 += other.B1, B2 += other.B2;
+        C += other.C;
+        Weight += other.Weight;
+        return *this;
+    }
+
+    double Evaluate(const Eigen::Vector3f& p) const noexcept {
+        const double x = p.x(), y = p.y(), z = p.z();
+        const double value = A00 * x * x + A11 * y * y + A22 * z * z +
+                             2.0 * (A01 * x * y + A02 * x * z + A12 * y * z) +
+                             2.0 * (B0 * x + B1 * y + B2 * z) + C;
+        return std::max(value, 0.0);
+    }
+};
+
+enum class GroupKind : uint8_t {
+    Interior,
+    /// 恰好两个边界邻居, 只能沿边界坍缩。
+    Boundary,
+    Locked,
+};
+
+class QuadricSimplifier {
+public:
+    QuadricSimplifier(std::span<const uint32_t> indices, std::span<const Eigen::Vector3f> positions)
+        : _positions(positions) {
+        BuildPositionGroups();
+        _remap.resize(positions.size());
+        for (size_t v = 0; v < _remap.size(); v++) {
+            _remap[v] = static_cast<uint32_t>(v);
+        }
+        _triangles.assign(indices.begin(), indices.begin() + indices.size() / 3 * 3);
+        CompactTriangles();
+        BuildGroupAdjacency();
+        BuildQuadrics();
+    }
+
+    size_t GetTriangleCount() const noexcept { return _triangles.size() / 3; }
+
+    /// 一趟: 每个点取代价最小的合法坍缩, 按代价从小到大执行, 本趟动过的点不再参与。
+    /// 返回执行的坍缩数。
+    size_t RunPass(size_t targetTriangles, double maxCost) {
+        BuildGroupAdjacency();
+        ClassifyGroups();
+        FindCandidates();
+        std::fill(_locked.begin(), _locked.end(), uint8_t{0});
+        size_t triangles = GetTriangleCount();
+        if (_order.empty() || triangles <= targetTriangles) {
+            return 0;
+        }
+        // 一次坍缩约去掉两个三角形。本趟只做代价不超过第 goal 便宜候选 kPassCostRatio 倍的坍缩:
+        // 加锁跳过的便宜候选下一趟重新评估后仍可能比眼前这些贵的更好。
+        const size_t goal = std::min((triangles - targetTriangles) / 2, _order.size() - 1);
+        const double passCost = std::min(maxCost, _bestCost[_order[goal]] * kPassCostRatio);
+        size_t collapses = 0;
+        for (uint32_t group : _order) {
+            // 门槛内的全都翻面时放宽到 maxCost, 免得本趟一个不做就提前收工。
+            if (triangles <= targetTriangles || _bestCost[group] > maxCost || (_bestCost[group] > passCost && collapses > 0)) {
+                break;
+            }
+            const uint32_t target = _bestTarget[group];
+            if (_locked[group] || _locked[target]) {
+                continue;
+            }
+            size_t removed = 0;
+            if (!TryCollapse(group, target, removed)) {
+                continue;
+            }
+            _locked[group] = 1;
+            _locked[target] = 1;
+            _quadrics[target] += _quadrics[group];
+            _maxCost = std::max(_maxCost, _bestCost[group]);
+            triangles -= std::min(removed, triangles);
+            collapses++;
+        }
+        CompactTriangles();
+        return collapses;
+    }
+
+    MeshSimplifyResult TakeResult() {
+        MeshSimplifyResult result;
+        result.Indices = std::move(_triangles);
+        result.Error = static_cast<float>(std::sqrt(_maxCost));
+        return result;
+    }
+
+private:
+    uint32_t GroupOf(uint32_t vertex) const noexcept { return _groupOf[_remap[vertex]]; }
+
+    /// 位置按位相同的顶点归为一组 (-0 与 +0 视作相同)。
+    void BuildPositionGroups() {
+        const size_t vertexCount = _positions.size();
+        _groupOf.assign(vertexCount, kInvalidIndex);
+        const size_t mask = std::bit_ceil(std::max<size_t>(vertexCount * 2, 2)) - 1;
+        vector<uint32_t> table(mask + 1, kInvalidIndex);
+        const auto bitsOf = [this](size_t v) noexcept {
+            std::array<uint32_t, 3> bits;
+            std::memcpy(bits.data(), _positions[v].data(), sizeof(bits));
+            for (uint32_t& b : bits) {
+                b = b == 0x80000000u ? 0u : b;
+            }
+            return bits;
+        };
+        for (size_t v = 0; v < vertexCount; v++) {
+            const std::array<uint32_t, 3> key = bitsOf(v);
+            size_t slot = HashData(key.data(), sizeof(key)) & mask;
+            while (table[slot] != kInvalidIndex && bitsOf(table[slot]) != key) {
+                slot = (slot + 1) & mask;
+            }
+            if (table[slot] == kInvalidIndex) {
+                table[slot] = static_cast<uint32_t>(v);
+                _groupOf[v] = static_cast<uint32_t>(_groupPositions.size());
+                _groupPositions.push_back(_positions[v]);
+            } else {
+                _groupOf[v] = _groupOf[table[slot]];
+            }
+        }
+        const size_t groupCount = _groupPositions.size();
+        _quadrics.assign(groupCount, Quadric{});
+        _locked.assign(groupCount, 0);
+        _kinds.assign(groupCount, GroupKind::Interior);
+        _boundaryNeighbors.assign(groupCount, {kInvalidIndex, kInvalidIndex});
+        _boundaryCounts.assign(groupCount, 0);
+        _bestCost.assign(groupCount, 0.0);
+        _bestTarget.assign(groupCount, kInvalidIndex);
+    }
+
+    /// 按 _remap 改写三角形, 丢掉有两个角落在同一位置组的退化三角形。
+    void CompactTriangles() {
+        size_t write = 0;
+        for (size_t t = 0; t + 2 < _triangles.size(); t += 3) {
+            const uint32_t a = _remap[_triangles[t]];
+            const uint32_t b = _remap[_triangles[t + 1]];
+            const uint32_t c = _remap[_triangles[t + 2]];
+            const uint32_t ga = _groupOf[a], gb = _groupOf[b], gc = _groupOf[c];
+            if (ga == gb || gb == gc || ga == gc) {
+                continue;
+            }
+            _triangles[write++] = a;
+            _triangles[write++] = b;
+            _triangles[write++] = c;
+        }
+        _triangles.resize(write);
+    }
+
+    /// 对每条没有反向边的 wedge 有向边 (开放边界或属性接缝) 调用 f(from, to, triangle)。
+    /// 反向边只可能在 to 所在位置组的三角形里, 借邻接表查找。需要 _adjacency 是最新的。
+    template <class F>
+    void ForEachOpenEdge(F&& f) {
+        for (size_t t = 0; t < _triangles.size(); t += 3) {
+            for (size_t k = 0; k < 3; k++) {
+                const uint32_t from = _triangles[t + k];
+                const uint32_t to = _triangles[t + (k + 1) % 3];
+                if (!HasEdge(to, from)) {
+                    f(from, to, t / 3);
+                }
+            }
+        }
+    }
+
+    bool HasEdge(uint32_t from, uint32_t to) const noexcept {
+        const uint32_t group = _groupOf[from];
+        for (uint32_t i = _adjacencyOffsets[group]; i < _adjacencyOffsets[group + 1]; i++) {
+            const uint32_t* triangle = _triangles.data() + size_t{_adjacency[i]} * 3;
+            if ((triangle[0] == from && triangle[1] == to) ||
+                (triangle[1] == from && triangle[2] == to) ||
+                (triangle[2] == from && triangle[0] == to)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Eigen::Vector3d TriangleCross(size_t triangle) const noexcept {
+        const Eigen::Vector3d p0 = _positions[_triangles[triangle * 3]].cast<double>();
+        const Eigen::Vector3d p1 = _positions[_triangles[triangle * 3 + 1]].cast<double>();
+        const Eigen::Vector3d p2 = _positions[_triangles[triangle * 3 + 2]].cast<double>();
+        return (p1 - p0).cross(p2 - p0);
+    }
+
+    void BuildQuadrics() {
+        for (size_t t = 0; t < _triangles.size() / 3; t++) {
+            const Eigen::Vector3d cross = TriangleCross(t);
+            const double length = cross.norm();
+            if (!(length > 0.0)) {
+                continue;
+            }
+            const Eigen::Vector3d n = cross / length;
+            const double d = -n.dot(_positions[_triangles[t * 3]].cast<double>());
+            Quadric q = Quadric::FromPlane(n, d, length * 0.5);
+            q.Weight = length * 0.5;
+            for (size_t k = 0; k < 3; k++) {
+                _quadrics[_groupOf[_triangles[t * 3 + k]]] += q;
+            }
+        }
+        ForEachOpenEdge([this](uint32_t from, uint32_t to, size_t triangle) {
+            const Eigen::Vector3d cross = TriangleCross(triangle);
+            const Eigen::Vector3d pa = _positions[from].cast<double>();
+            const Eigen::Vector3d edge = _positions[to].cast<double>() - pa;
+            const Eigen::Vector3d normal = edge.cross(cross);
+            const double length = normal.norm();
+            if (!(length > 0.0)) {
+                return;
+            }
+            const Eigen::Vector3d n = normal / length;
+            // 只进矩阵, 不进 Weight: 报出的误差仍是面距离的均值, 边界上只会偏大。
+            const Quadric q = Quadric::FromPlane(n, -n.dot(pa), edge.squaredNorm() * kBoundaryWeight);
+            _quadrics[_groupOf[from]] += q;
+            _quadrics[_groupOf[to]] += q;
+        });
+    }
+
+    /// 位置组到三角形的邻接表 (CSR)。本趟内坍缩只改 _remap, 表不变。
+    void BuildGroupAdjacency() {
+        const size_t groupCount = _groupPositions.size();
+        _adjacencyOffsets.assign(groupCount + 1, 0);
+        for (uint32_t vertex : _triangles) {
+            _adjacencyOffsets[_groupOf[vertex] + 1]++;
+        }
+        for (size_t g = 0; g < groupCount; g++) {
+            _adjacencyOffsets[g + 1] += _adjacencyOffsets[g];
+        }
+        _adjacency.resize(_triangles.size());
+        _cursor.assign(_adjacencyOffsets.begin(), _adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < _triangles.size(); i++) {
+            _adjacency[_cursor[_groupOf[_triangles[i]]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    void AddBoundaryNeighbor(uint32_t group, uint32_t neighbor) noexcept {
+        std::array<uint32_t, 2>& neighbors = _boundaryNeighbors[group];
+        uint8_t& count = _boundaryCounts[group];
+        if (neighbors[0] == neighbor || neighbors[1] == neighbor) {
+            return;
+        }
+        if (count < 2) {
+            neighbors[count] = neighbor;
+        }
+        count = static_cast<uint8_t>(std::min(count + 1, 3));
+    }
+
+    /// 按当前的开放边数边界邻居: 0 个为内部点, 2 个为边界 / 接缝上的点, 其余 (边界交汇处、孤立的边) 不动。
+    void ClassifyGroups() {
+        std::fill(_boundaryNeighbors.begin(), _boundaryNeighbors.end(), std::array<uint32_t, 2>{kInvalidIndex, kInvalidIndex});
+        std::fill(_boundaryCounts.begin(), _boundaryCounts.end(), uint8_t{0});
+        ForEachOpenEdge([this](uint32_t from, uint32_t to, size_t) {
+            AddBoundaryNeighbor(_groupOf[from], _groupOf[to]);
+            AddBoundaryNeighbor(_groupOf[to], _groupOf[from]);
+        });
+        for (size_t g = 0; g < _kinds.size(); g++) {
+            const uint8_t count = _boundaryCounts[g];
+            _kinds[g] = count == 0 ? GroupKind::Interior : (count == 2 ? GroupKind::Boundary : GroupKind::Locked);
+        }
+    }
+
+    void ConsiderCollapse(uint32_t from, uint32_t to) noexcept {
+        if (_kinds[from] == GroupKind::Locked) {
+            return;
+        }
+        if (_kinds[from] == GroupKind::Boundary &&
+            _boundaryNeighbors[from][0] != to && _boundaryNeighbors[from][1] != to) {
+            return;
+        }
+        const Quadric& q = _quadrics[from];
+        const double cost = q.Evaluate(_groupPositions[to]) / std::max(q.Weight, std::numeric_limits<double>::min());
+        if (_bestTarget[from] == kInvalidIndex || cost < _bestCost[from]) {
+            _bestCost[from] = cost;
+            _bestTarget[from] = to;
+        }
+    }
+
+    void FindCandidates() {
+        std::fill(_bestTarget.begin(), _bestTarget.end(), kInvalidIndex);
+        for (size_t t = 0; t < _triangles.size(); t += 3) {
+            for (size_t k = 0; k < 3; k++) {
+                const uint32_t a = _groupOf[_triangles[t + k]];
+                const uint32_t b = _groupOf[_triangles[t + (k + 1) % 3]];
+                ConsiderCollapse(a, b);
+                ConsiderCollapse(b, a);
+            }
+        }
+        _order.clear();
+        for (uint32_t g = 0; g < _bestTarget.size(); g++) {
+            if (_bestTarget[g] != kInvalidIndex) {
+                _order.push_back(g);
+            }
+        }
+        std::sort(_order.begin(), _order.end(), [this](uint32_t lhs, uint32_t rhs) noexcept {
+            return _bestCost[lhs] < _bestCost[rhs] || (_bestCost[lhs] == _bestCost[rhs] && lhs < rhs);
+        });
+    }
+
+    /// 把 from 组的每个 wedge 并进与它同在一个三角形里的 to 组 wedge; 有 wedge 找不到对应,
+    /// 或有三角形会翻面时放弃。removed 为因此退化的三角形数。
+    bool TryCollapse(uint32_t from, uint32_t to, size_t& removed) {
+        _wedgeTargets.clear();
+        const Eigen::Vector3f& target = _groupPositions[to];
+        for (uint32_t i = _adjacencyOffsets[from]; i < _adjacencyOffsets[from + 1]; i++) {
+            const size_t t = _adjacency[i];
+            std::array<uint32_t, 3> corners;
+            std::array<uint32_t, 3> groups;
+            for (size_t k = 0; k < 3; k++) {
+                corners[k] = _remap[_triangles[t * 3 + k]];
+                groups[k] = _groupOf[corners[k]];
+            }
+            if (groups[0] == groups[1] || groups[1] == groups[2] || groups[0] == groups[2]) {
+                continue;
+            }
+            const size_t self = groups[0] == from ? 0 : (groups[1] == from ? 1 : 2);
+            const auto found = std::find(groups.begin(), groups.end(), to);
+            auto entry = std::find_if(_wedgeTargets.begin(), _wedgeTargets.end(), [&](const auto& pair) noexcept {
+                return pair.first == corners[self];
+            });
+            if (entry == _wedgeTargets.end()) {
+                _wedgeTargets.emplace_back(corners[self], kInvalidIndex);
+                entry = _wedgeTargets.end() - 1;
+            }
+            if (found != groups.end()) {
+                entry->second = corners[found - groups.begin()];
+                removed++;
+                continue;
+            }
+            const Eigen::Vector3f& p0 = _groupPositions[groups[0]];
+            const Eigen::Vector3f& p1 = _groupPositions[groups[1]];
+            const Eigen::Vector3f& p2 = _groupPositions[groups[2]];
+            const Eigen::Vector3f before = (p1 - p0).cross(p2 - p0);
+            std::array<Eigen::Vector3f, 3> moved{p0, p1, p2};
+            moved[self] = target;
+            const Eigen::Vector3f after = (moved[1] - moved[0]).cross(moved[2] - moved[0]);
+            if (before.dot(after) < 0.0f) {
+                return false;
+            }
+        }
+        for (const auto& [wedge, wedgeTarget] : _wedgeTargets) {
+            if (wedgeTarget == kInvalidIndex) {
+                return false;
+            }
+        }
+        for (const auto& [wedge, wedgeTarget] : _wedgeTargets) {
+            _remap[wedge] = wedgeTarget;
+        }
+        return true;
+    }
+
+    std::span<const Eigen::Vector3f> _positions;
+    vector<uint32_t> _groupOf;
+    vector<Eigen::Vector3f> _groupPositions;
+    vector<uint32_t> _remap;
+    vector<uint32_t> _triangles;
+    vector<Quadric> _quadrics;
+    vector<GroupKind> _kinds;
+    vector<std::array<uint32_t, 2>> _boundaryNeighbors;
+    vector<uint8_t> _boundaryCounts;
+    vector<uint8_t> _locked;
+    vector<double> _bestCost;
+    vector<uint32_t> _bestTarget;
+    vector<uint32_t> _order;
+    vector<uint32_t> _adjacencyOffsets;
+    vector<uint32_t> _adjacency;
+    vector<uint32_t> _cursor;
+    vector<std::pair<uint32_t, uint32_t>> _wedgeTargets;
+    double _maxCost{0.0};
+};
+
+}  // namespace
+
+MeshSimplifyResult SimplifyMesh(
+    std::span<const uint32_t> indices,
+    std::span<const Eigen::Vector3f> positions,
+    const MeshSimplifyOptions& options) {
+    RADRAY_PROFILE_SCOPE("SimplifyMesh");
+    QuadricSimplifier simplifier{indices, positions};
+    const size_t targetTriangles = options.TargetIndexCount / 3;
+    const double targetError = options.TargetError;
+    const double maxCost = targetError * targetError;
+    while (simplifier.GetTriangleCount() > targetTriangles) {
+        if (simplifier.RunPass(targetTriangles, maxCost) == 0) {
+            break;
+        }
+    }
+    return simplifier.TakeResult();
+}
+
+vector<MeshLodEntry> GenerateMeshLods(TriangleMesh& mesh, const MeshLodOptions& options) {
+    RADRAY_PROFILE_SCOPE("GenerateMeshLods");
+    if (!mesh.IsValid() || mesh.Indices.size() < 3 ||
+        !std::all_of(mesh.Indices.begin(), mesh.Indices.end(), [&](uint32_t i) { return i < mesh.Positions.size(); })) {
+        return {};
+    }
+    Eigen::Vector3f boundsMin = Eigen::Vector3f::Constant(std::numeric_limits<float>::max());
+    Eigen::Vector3f boundsMax = Eigen::Vector3f::Constant(std::numeric_limits<float>::lowest());
+    for (uint32_t index : mesh.Indices) {
+        boundsMin = boundsMin.cwiseMin(mesh.Positions[index]);
+        boundsMax = boundsMax.cwiseMax(mesh.Positions[index]);
+    }
+    const float maxError = options.MaxRelativeError * (boundsMax - boundsMin).norm();
+
+    vector<MeshLodEntry> lods;
+    lods.push_back(MeshLodEntry{0, static_cast<uint32_t>(mesh.Indices.size()), 0.0f});
+    vector<uint32_t> previous = mesh.Indices;
+    float error = 0.0f;
+    while (lods.size() < options.MaxLodCount && previous.size() / 3 >= options.MinTriangleCount) {
+        const size_t targetTriangles = static_cast<size_t>(static_cast<double>(previous.size() / 3) * options.TriangleRatio);
+        MeshSimplifyResult level = SimplifyMesh(
+            previous,
+            mesh.Positions,
+            {.TargetIndexCount = targetTriangles * 3, .TargetError = maxError});
+        if (level.Indices.empty() || level.Indices.size() > previous.size() / 10 * 9) {
+            break;
+        }
+        OptimizeVertexCache(level.Indices, mesh.Positions.size(), options.CacheSize);
+        error += level.Error;
+        lods.push_back(MeshLodEntry{
+            static_cast<uint32_t>(mesh.Indices.size()),
+            static_cast<uint32_t>(level.Indices.size()),
+            error});
+        mesh.Indices.insert(mesh.Indices.end(), level.Indices.begin(), level.Indices.end());
+        previous = std::move(level.Indices);
+    }
+    return lods;
+}
+
+}  // namespace radray
@@ -0,0 +1,517 @@
+#include <radray/mip_chain.h>
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RADRAY_MIP_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RADRAY_MIP_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define RADRAY_MIP_NEON 1
+#endif
+
+#include <radray/profiler.h>
+
+namespace radray {
+namespace {
+
+// ─── sRGB 查表 ───
+
+constexpr uint32_t kSrgbEncodeBuckets = 4096;
+
+struct SrgbTables {
+    std::array<float, 256> ToLinear{};
+    /// Thresholds[k] 是编码结果从 k 进到 k + 1 的线性值; Thresholds[255] 为 +inf, 作扫描的哨兵。
+    std::array<float, 256> Thresholds{};
+    /// 线性值恰为第 i 个桶起点时的编码结果。相邻阈值的间距大于桶宽, 桶内至多再跨一个阈值。
+    std::array<uint8_t, kSrgbEncodeBuckets> BucketBase{};
+};
+
+double DecodeSrgb(double encoded) noexcept {
+    return encoded <= 0.04045 ? encoded / 12.92 : std::pow((encoded + 0.055) / 1.055, 2.4);
+}
+
+SrgbTables BuildSrgbTables() noexcept {
+    SrgbTables tables;
+    for (uint32_t code = 0; code < 256; ++code) {
+        tables.ToLinear[code] = static_cast<float>(DecodeSrgb(code / 255.0));
+    }
+    for (uint32_t code = 0; code < 255; ++code) {
+        tables.Thresholds[code] = static_cast<float>(DecodeSrgb((code + 0.5) / 255.0));
+    }
+    tables.Thresholds[255] = std::numeric_limits<float>::infinity();
+    uint32_t code = 0;
+    for (uint32_t bucket = 0; bucket < kSrgbEncodeBuckets; ++bucket) {
+        const float start = static_cast<float>(bucket) / static_cast<float>(kSrgbEncodeBuckets);
+        while (start >= tables.Thresholds[code]) {
+            ++code;
+        }
+        tables.BucketBase[bucket] = static_cast<uint8_t>(code);
+    }
+    return tables;
+}
+
+const SrgbTables& GetSrgbTables() noexcept {
+    static const SrgbTables tables = BuildSrgbTables();
+    return tables;
+}
+
+/// NaN 与负数都归到 0。
+float ClampUnit(float value) noexcept {
+    return value > 0.0f ? std::min(value, 1.0f) : 0.0f;
+}
+
+uint8_t EncodeSrgb(const SrgbTables& tables, float value) noexcept {
+    const float linear = ClampUnit(value);
+    const uint32_t bucket = std::min(
+        static_cast<uint32_t>(linear * static_cast<float>(kSrgbEncodeBuckets)),
+        kSrgbEncodeBuckets - 1);
+    uint32_t code = tables.BucketBase[bucket];
+    while (linear >= tables.Thresholds[code]) {
+        ++code;
+    }
+    return static_cast<uint8_t>(code);
+}
+
+uint8_t EncodeUnorm(float value) noexcept {
+    return static_cast<uint8_t>(ClampUnit(value) * 255.0f + 0.5f);
+}
+
+// ─── 4 通道浮点向量, Kaiser 的累加用 ───
+
+#if RADRAY_MIP_SSE2
+struct Float4 {
+    __m128 V;
+};
+Float4 Float4Zero() noexcept { return {_mm_setzero_ps()}; }
+Float4 Float4Load(const float* source) noexcept { return {_mm_loadu_ps(source)}; }
+Float4 Float4MulAdd(Float4 acc, Float4 value, float weight) noexcept {
+    return {_mm_add_ps(acc.V, _mm_mul_ps(value.V, _mm_set1_ps(weight)))};
+}
+void Float4Store(float* destination, Float4 value) noexcept { _mm_storeu_ps(destination, value.V); }
+#elif RADRAY_MIP_NEON
+struct Float4 {
+    float32x4_t V;
+};
+Float4 Float4Zero() noexcept { return {vdupq_n_f32(0.0f)}; }
+Float4 Float4Load(const float* source) noexcept { return {vld1q_f32(source)}; }
+Float4 Float4MulAdd(Float4 acc, Float4 value, float weight) noexcept { return {vmlaq_n_f32(acc.V, value.V, weight)}; }
+void Float4Store(float* destination, Float4 value) noexcept { vst1q_f32(destination, value.V); }
+#else
+struct Float4 {
+    float V[4];
+};
+Float4 Float4Zero() noexcept { return {}; }
+Float4 Float4Load(const float* source) noexcept { return {{source[0], source[1], source[2], source[3]}}; }
+Float4 Float4MulAdd(Float4 acc, Float4 value, float weight) noexcept {
+    for (size_t channel = 0; channel < 4; ++channel) {
+        acc.V[channel] += value.V[channel] * weight;
+    }
+    return acc;
+}
+void Float4Store(float* destination, Float4 value) noexcept { std::memcpy(destination, value.V, sizeof(value.V)); }
+#endif
+
+// ─── Box: 2x2 平均 ───
+//
+// 源宽为 1 时两列取同一像素, 源高为 1 时两行取同一行: 重复样本的平均与只取一个样本相同,
+// 于是所有情形共用一个 2x2 核。(a + b + c + d + 2) >> 2 与浮点平均后 lround 逐值相同。
+
+#if RADRAY_MIP_AVX2
+/// 8 个目标像素: 每行读 64 字节。
+void BoxUnorm8Avx2(const byte* row0, const byte* row1, byte* out) noexcept {
+    const __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0));
+    const __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + 32));
+    const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1));
+    const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + 32));
+    // 每个 u16 向量是按序的 4 个源像素, 两行已相加。
+    const __m256i p0 = _mm256_add_epi16(
+        _mm256_cvtepu8_epi16(_mm256_castsi256_si128(a0)),
+        _mm256_cvtepu8_epi16(_mm256_castsi256_si128(b0)));
+    const __m256i p1 = _mm256_add_epi16(
+        _mm256_cvtepu8_epi16(_mm256_extracti128_si256(a0, 1)),
+        _mm256_cvtepu8_epi16(_mm256_extracti128_si256(b0, 1)));
+    const __m256i p2 = _mm256_add_epi16(
+        _mm256_cvtepu8_epi16(_mm256_castsi256_si128(a1)),
+        _mm256_cvtepu8_epi16(_mm256_castsi256_si128(b1)));
+    const __m256i p3 = _mm256_add_epi16(
+        _mm256_cvtepu8_epi16(_mm256_extracti128_si256(a1, 1)),
+        _mm256_cvtepu8_epi16(_mm256_extracti128_si256(b1, 1)));
+    // unpack 在 128 位 lane 内进行: s0 = [d0, d2 | d1, d3], s1 = [d4, d6 | d5, d7]。
+    const __m256i bias = _mm256_set1_epi16(2);
+    const __m256i s0 = _mm256_srli_epi16(
+        _mm256_add_epi16(_mm256_add_epi16(_mm256_unpacklo_epi64(p0, p1), _mm256_unpackhi_epi64(p0, p1)), bias), 2);
+    const __m256i s1 = _mm256_srli_epi16(
+        _mm256_add_epi16(_mm256_add_epi16(_mm256_unpacklo_epi64(p2, p3), _mm256_unpackhi_epi64(p2, p3)), bias), 2);
+    // 打包后 32 位元素依次是 d0 d2 d4 d6 d1 d3 d5 d7, 再排回顺序。
+    const __m256i packed = _mm256_packus_epi16(s0, s1);
+    const __m256i ordered = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), ordered);
+}
+#endif
+
+#if RADRAY_MIP_SSE2
+/// 4 个目标像素: 每行读 32 字节。
+void BoxUnorm4Sse2(const byte* row0, const byte* row1, byte* out) noexcept {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0));
+    const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 16));
+    const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1));
+    const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 16));
+    // 每个 u16 向量装两个源像素, 两行已相加。
+    const __m128i p01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+    const __m128i p23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+    const __m128i p45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+    const __m128i p67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+    const __m128i bias = _mm_set1_epi16(2);
+    const __m128i d01 = _mm_srli_epi16(
+        _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi64(p01, p23), _mm_unpackhi_epi64(p01, p23)), bias), 2);
+    const __m128i d23 = _mm_srli_epi16(
+        _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi64(p45, p67), _mm_unpackhi_epi64(p45, p67)), bias), 2);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(d01, d23));
+}
+#elif RADRAY_MIP_NEON
+/// 4 个目标像素: vld2 把偶数、奇数源像素分开, 相加即水平配对。
+void BoxUnorm4Neon(const byte* row0, const byte* row1, byte* out) noexcept {
+    const uint32x4x2_t a = vld2q_u32(reinterpret_cast<const uint32_t*>(row0));
+    const uint32x4x2_t b = vld2q_u32(reinterpret_cast<const uint32_t*>(row1));
+    const uint8x16_t aEven = vreinterpretq_u8_u32(a.val[0]);
+    const uint8x16_t aOdd = vreinterpretq_u8_u32(a.val[1]);
+    const uint8x16_t bEven = vreinterpretq_u8_u32(b.val[0]);
+    const uint8x16_t bOdd = vreinterpretq_u8_u32(b.val[1]);
+    uint16x8_t low = vaddl_u8(vget_low_u8(aEven), vget_low_u8(aOdd));
+    low = vaddw_u8(vaddw_u8(low, vget_low_u8(bEven)), vget_low_u8(bOdd));
+    uint16x8_t high = vaddl_u8(vget_high_u8(aEven), vget_high_u8(aOdd));
+    high = vaddw_u8(vaddw_u8(high, vget_high_u8(bEven)), vget_high_u8(bOdd));
+    vst1q_u8(reinterpret_cast<uint8_t*>(out), vcombine_u8(vrshrn_n_u16(low, 2), vrshrn_n_u16(high, 2)));
+}
+#endif
+
+void BoxRowUnorm(const byte* row0, const byte* row1, byte* out, uint32_t dstWidth, bool singleColumn) noexcept {
+    uint32_t x = 0;
+    if (!singleColumn) {
+#if RADRAY_MIP_AVX2
+        for (; x + 8 <= dstWidth; x += 8) {
+            BoxUnorm8Avx2(row0 + size_t{x} * 8, row1 + size_t{x} * 8, out + size_t{x} * 4);
+        }
+#endif
+#if RADRAY_MIP_SSE2
+        for (; x + 4 <= dstWidth; x += 4) {
+            BoxUnorm4Sse2(row0 + size_t{x} * 8, row1 + size_t{x} * 8, out + size_t{x} * 4);
+        }
+#elif RADRAY_MIP_NEON
+        for (; x + 4 <= dstWidth; x += 4) {
+            BoxUnorm4Neon(row0 + size_t{x} * 8, row1 + size_t{x} * 8, out + size_t{x} * 4);
+        }
+#endif
+    }
+    const size_t secondColumn = singleColumn ? 0 : 4;
+    for (; x < dstWidth; ++x) {
+        const auto* top = reinterpret_cast<const uint8_t*>(row0 + size_t{x} * 8);
+        const auto* bottom = reinterpret_cast<const uint8_t*>(row1 + size_t{x} * 8);
+        for (size_t channel = 0; channel < 4; ++channel) {
+            const uint32_t sum = uint32_t{top[channel]} + top[secondColumn + channel] +
+                                 bottom[channel] + bottom[secondColumn + channel];
+            out[size_t{x} * 4 + channel] = static_cast<byte>((sum + 2) >> 2);
+        }
+    }
+}
+
+/// RGB 查表解码到线性空间求平均再编码; alpha 走整数平均。
+void BoxRowSrgb(
+    const SrgbTables& tables,
+    const byte* row0,
+    const byte* row1,
+    byte* out,
+    uint32_t dstWidth,
+    bool singleColumn) noexcept {
+    const size_t secondColumn = singleColumn ? 0 : 4;
+    for (uint32_t x = 0; x < dstWidth; ++x) {
+        const auto* top = reinterpret_cast<const uint8_t*>(row0 + size_t{x} * 8);
+        const auto* bottom = reinterpret_cast<const uint8_t*>(row1 + size_t{x} * 8);
+        byte* pixel = out + size_t{x} * 4;
+        for (size_t channel = 0; channel < 3; ++channel) {
+            const float sum = tables.ToLinear[top[channel]] + tables.ToLinear[top[secondColumn + channel]] +
+                              tables.ToLinear[bottom[channel]] + tables.ToLinear[bottom[secondColumn + channel]];
+            pixel[channel] = static_cast<byte>(EncodeSrgb(tables, sum * 0.25f));
+        }
+        const uint32_t alpha = uint32_t{top[3]} + top[secondColumn + 3] + bottom[3] + bottom[secondColumn + 3];
+        pixel[3] = static_cast<byte>((alpha + 2) >> 2);
+    }
+}
+
+struct LevelView {
+    const byte* Source;
+    uint32_t SourceWidth;
+    uint32_t SourceHeight;
+    byte* Destination;
+    uint32_t DestinationWidth;
+    uint32_t DestinationHeight;
+};
+
+void BoxBand(const LevelView& level, bool srgb, uint32_t firstRow, uint32_t lastRow) noexcept {
+    const SrgbTables& tables = GetSrgbTables();
+    const size_t sourcePitch = size_t{level.SourceWidth} * 4;
+    const bool singleColumn = level.SourceWidth == 1;
+    for (uint32_t y = firstRow; y < lastRow; ++y) {
+        const byte* row0 = level.Source + size_t{y} * 2 * sourcePitch;
+        const byte* row1 = level.SourceHeight == 1 ? row0 : row0 + sourcePitch;
+        byte* out = level.Destination + size_t{y} * level.DestinationWidth * 4;
+        if (srgb) {
+            BoxRowSrgb(tables, row0, row1, out, level.DestinationWidth, singleColumn);
+        } else {
+            BoxRowUnorm(row0, row1, out, level.DestinationWidth, singleColumn);
+        }
+    }
+}
+
+// ─── Kaiser: 可分离的窗函数 sinc ───
+
+/// 以目标像素为单位的半径与窗形状参数。
+constexpr double kKaiserRadius = 3.0;
+constexpr double kKaiserAlpha = 4.0;
+
+double BesselI0(double x) noexcept {
+    double sum = 1.0;
+    double term = 1.0;
+    const double halfSquared = x * x * 0.25;
+    for (uint32_t k = 1; k < 64 && term > sum * 1e-12; ++k) {
+        term *= halfSquared / (double(k) * double(k));
+        sum += term;
+    }
+    return sum;
+}
+
+double KaiserSincWeight(double t) noexcept {
+    if (std::abs(t) >= kKaiserRadius) {
+        return 0.0;
+    }
+    const double x = std::numbers::pi * t;
+    const double sinc = t == 0.0 ? 1.0 : std::sin(x) / x;
+    const double r = t / kKaiserRadius;
+    return sinc * BesselI0(kKaiserAlpha * std::sqrt(1.0 - r * r)) / BesselI0(kKaiserAlpha);
+}
+
+/// 一个轴上每个目标像素的源下标 (已夹到边缘) 与归一化权重, 每个目标像素 TapCount 个。
+struct FilterAxis {
+    uint32_t TapCount{0};
+    vector<uint32_t> Indices;
+    vector<float> Weights;
+};
+
+FilterAxis BuildKaiserAxis(uint32_t sourceSize, uint32_t destinationSize) {
+    const double scale = static_cast<double>(sourceSize) / destinationSize;
+    const double support = kKaiserRadius * scale;
+    const uint32_t maxTaps = static_cast<uint32_t>(std::ceil(support * 2.0)) + 1;
+    vector<double> weights(size_t{destinationSize} * maxTaps);
+    vector<int64_t> firsts(destinationSize);
+    uint32_t tapCount = 1;
+    for (uint32_t d = 0; d < destinationSize; ++d) {
+        const double center = (d + 0.5) * scale - 0.5;
+        const int64_t first = static_cast<int64_t>(std::floor(center - support)) + 1;
+        firsts[d] = first;
+        double sum = 0.0;
+        for (uint32_t k = 0; k < maxTaps; ++k) {
+            const double weight = KaiserSincWeight((static_cast<double>(first + k) - center) / scale);
+            weights[size_t{d} * maxTaps + k] = weight;
+            sum += weight;
+            if (weight != 0.0) {
+                tapCount = std::max(tapCount, k + 1);
+            }
+        }
+        for (uint32_t k = 0; k < maxTaps; ++k) {
+            weights[size_t{d} * maxTaps + k] /= sum;
+        }
+    }
+    // 尾部恒为 0 的 tap 不参与累加。
+    FilterAxis axis;
+    axis.TapCount = tapCount;
+    axis.Indices.resize(size_t{destinationSize} * tapCount);
+    axis.Weights.resize(size_t{destinationSize} * tapCount);
+    for (uint32_t d = 0; d < destinationSize; ++d) {
+        for (uint32_t k = 0; k < tapCount; ++k) {
+            const int64_t index = std::clamp<int64_t>(firsts[d] + k, 0, int64_t{sourceSize} - 1);
+            axis.Indices[size_t{d} * tapCount + k] = static_cast<uint32_t>(index);
+            axis.Weights[size_t{d} * tapCount + k] = static_cast<float>(weights[size_t{d} * maxTaps + k]);
+        }
+    }
+    return axis;
+}
+
+/// 目标行 [firstRow, lastRow) 需要的源行先横向滤波进带内临时缓冲, 再纵向滤波并编码。
+/// 相邻带的源行有少量重叠, 各自重算, 换来带与带之间没有共享状态。
+void KaiserBand(
+    const LevelView& level,
+    const FilterAxis& horizontal,
+    const FilterAxis& vertical,
+    bool srgb,
+    uint32_t firstRow,
+    uint32_t lastRow) {
+    const SrgbTables& tables = GetSrgbTables();
+    const uint32_t vTaps = vertical.TapCount;
+    const uint32_t hTaps = horizontal.TapCount;
+    const uint32_t firstSourceRow = vertical.Indices[size_t{firstRow} * vTaps];
+    const uint32_t lastSourceRow = vertical.Indices[(size_t{lastRow} - 1) * vTaps + vTaps - 1];
+    const size_t dstWidth = level.DestinationWidth;
+
+    vector<float> decoded(size_t{level.SourceWidth} * 4);
+    vector<float> rows((size_t{lastSourceRow} - firstSourceRow + 1) * dstWidth * 4);
+    for (uint32_t sourceRow = firstSourceRow; sourceRow <= lastSourceRow; ++sourceRow) {
+        const auto* source = reinterpret_cast<const uint8_t*>(level.Source + size_t{sourceRow} * level.SourceWidth * 4);
+        for (size_t i = 0; i < size_t{level.SourceWidth} * 4; i += 4) {
+            for (size_t channel = 0; channel < 4; ++channel) {
+                decoded[i + channel] = srgb && channel < 3 ? tables.ToLinear[source[i + channel]]
+                                                           : source[i + channel] * (1.0f / 255.0f);
+            }
+        }
+        float* row = rows.data() + (size_t{sourceRow} - firstSourceRow) * dstWidth * 4;
+        for (size_t x = 0; x < dstWidth; ++x) {
+            const uint32_t* indices = horizontal.Indices.data() + x * hTaps;
+            const float* weights = horizontal.Weights.data() + x * hTaps;
+            Float4 acc = Float4Zero();
+            for (uint32_t k = 0; k < hTaps; ++k) {
+                acc = Float4MulAdd(acc, Float4Load(decoded.data() + size_t{indices[k]} * 4), weights[k]);
+            }
+            Float4Store(row + x * 4, acc);
+        }
+    }
+
+    for (uint32_t y = firstRow; y < lastRow; ++y) {
+        const uint32_t* indices = vertical.Indices.data() + size_t{y} * vTaps;
+        const float* weights = vertical.Weights.data() + size_t{y} * vTaps;
+        auto* out = reinterpret_cast<uint8_t*>(level.Destination + size_t{y} * dstWidth * 4);
+        for (size_t x = 0; x < dstWidth; ++x) {
+            Float4 acc = Float4Zero();
+            for (uint32_t k = 0; k < vTaps; ++k) {
+                const float* row = rows.data() + (size_t{indices[k]} - firstSourceRow) * dstWidth * 4;
+                acc = Float4MulAdd(acc, Float4Load(row + x * 4), weights[k]);
+            }
+            float value[4];
+            Float4Store(value, acc);
+            for (size_t channel = 0; channel < 4; ++channel) {
+                out[x * 4 + channel] = srgb && channel < 3 ? EncodeSrgb(tables, value[channel])
+                                                           : EncodeUnorm(value[channel]);
+            }
+        }
+    }
+}
+
+// ─── 分带 ───
+
+/// 每带约这么多目标像素。Kaiser 的带更高, 摊薄带间重叠的源行。
+constexpr size_t kBoxBandPixels = 64 * 1024;
+constexpr size_t kKaiserBandPixels = 256 * 1024;
+/// 目标像素少于此的级别不值得分发。
+constexpr size_t kParallelMinPixels = 256 * 1024;
+
+template <class Fn>
+void ForEachBand(const LevelView& level, size_t bandPixels, const MipParallelFor& parallelFor, const Fn& fn) {
+    const uint32_t height = level.DestinationHeight;
+    const uint32_t bandRows = static_cast<uint32_t>(std::clamp<size_t>(bandPixels / level.DestinationWidth, 1, height));
+    const uint32_t bandCount = (height + bandRows - 1) / bandRows;
+    if (!parallelFor || bandCount < 2 || size_t{level.DestinationWidth} * height < kParallelMinPixels) {
+        fn(0u, height);
+        return;
+    }
+    parallelFor(bandCount, [&](uint32_t band) {
+        const uint32_t firstRow = band * bandRows;
+        fn(firstRow, std::min(firstRow + bandRows, height));
+    });
+}
+
+}  // namespace
+
+Rgba8MipChain Rgba8MipChain::Allocate(uint32_t width, uint32_t height, uint32_t levelCount) {
+    Rgba8MipChain chain;
+    if (width == 0 || height == 0 || levelCount == 0) {
+        return chain;
+    }
+    chain._width = width;
+    chain._height = height;
+    chain._levelCount = std::min(levelCount, GetFullMipLevelCount(width, height));
+    chain._size = chain.GetLevelOffset(chain._levelCount);
+    chain._data = std::make_unique_for_overwrite<byte[]>(chain._size);
+    return chain;
+}
+
+size_t Rgba8MipChain::GetLevelOffset(uint32_t level) const noexcept {
+    size_t offset = 0;
+    for (uint32_t i = 0; i < level; ++i) {
+        offset += size_t{GetLevelWidth(i)} * GetLevelHeight(i) * 4;
+    }
+    return offset;
+}
+
+std::span<const byte> Rgba8MipChain::GetLevel(uint32_t level) const noexcept {
+    if (level >= _levelCount) {
+        return {};
+    }
+    return {_data.get() + GetLevelOffset(level), size_t{GetLevelWidth(level)} * GetLevelHeight(level) * 4};
+}
+
+std::span<byte> Rgba8MipChain::GetLevel(uint32_t level) noexcept {
+    if (level >= _levelCount) {
+        return {};
+    }
+    return {_data.get() + GetLevelOffset(level), size_t{GetLevelWidth(level)} * GetLevelHeight(level) * 4};
+}
+
+uint32_t GetFullMipLevelCount(uint32_t width, uint32_t height) noexcept {
+    return static_cast<uint32_t>(std::bit_width(std::max(width, height)));
+}
+
+Rgba8MipChain BuildRgba8MipChain(std::span<const byte> rgba8, uint32_t width, uint32_t height, const MipChainOptions& options) {
+    if (width == 0 || height == 0 || rgba8.size() != size_t{width} * height * 4) {
+        return {};
+    }
+    Rgba8MipChain chain = Rgba8MipChain::Allocate(
+        width,
+        height,
+        options.GenerateMips ? GetFullMipLevelCount(width, height) : 1);
+    std::memcpy(chain.GetLevel(0).data(), rgba8.data(), rgba8.size());
+    GenerateRgba8Mips(chain, options);
+    return chain;
+}
+
+void GenerateRgba8Mips(Rgba8MipChain& chain, const MipChainOptions& options) {
+    RADRAY_PROFILE_SCOPE("GenerateRgba8Mips");
+    for (uint32_t mip = 1; mip < chain.GetLevelCount(); ++mip) {
+        const LevelView level{
+            .Source = chain.GetLevel(mip - 1).data(),
+            .SourceWidth = chain.GetLevelWidth(mip - 1),
+            .SourceHeight = chain.GetLevelHeight(mip - 1),
+            .Destination = chain.GetLevel(mip).data(),
+            .DestinationWidth = chain.GetLevelWidth(mip),
+            .DestinationHeight = chain.GetLevelHeight(mip)};
+        if (options.Filter == MipFilter::Kaiser) {
+            const FilterAxis horizontal = BuildKaiserAxis(level.SourceWidth, level.DestinationWidth);
+            const FilterAxis vertical = BuildKaiserAxis(level.SourceHeight, level.DestinationHeight);
+            ForEachBand(level, kKaiserBandPixels, options.ParallelFor, [&](uint32_t firstRow, uint32_t lastRow) {
+                KaiserBand(level, horizontal, vertical, options.Srgb, firstRow, lastRow);
+            });
+        } else {
+            ForEachBand(level, kBoxBandPixels, options.ParallelFor, [&](uint32_t firstRow, uint32_t lastRow) {
+                BoxBand(level, options.Srgb, firstRow, lastRow);
+            });
+        }
+    }
+}
+
+float Srgb8ToLinear(uint8_t value) noexcept {
+    return GetSrgbTables().ToLinear[value];
+}
+
+uint8_t LinearToSrgb8(float value) noexcept {
+    return EncodeSrgb(GetSrgbTables(), value);
+}
+
+}  // namespace radray
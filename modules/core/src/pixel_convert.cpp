@@ -0,0 +1,708 @@
+#include <radray/pixel_convert.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RADRAY_PIXEL_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define RADRAY_PIXEL_NEON 1
+#endif
+// pshufb 与 F16C 不在 x64 基线里; MSVC 不定义 __SSSE3__ / __F16C__, /arch:AVX 与 /arch:AVX2 分别蕴含它们。
+#if defined(__SSSE3__) || (defined(_MSC_VER) && defined(__AVX__))
+#include <tmmintrin.h>
+#define RADRAY_PIXEL_SSSE3 1
+#endif
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define RADRAY_PIXEL_F16C 1
+#endif
+#if defined(RADRAY_PIXEL_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define RADRAY_PIXEL_NEON_F16 1
+#endif
+
+#include <radray/profiler.h>
+
+namespace radray {
+namespace {
+
+// ─── 格式描述 ───
+
+enum class ComponentKind {
+    Byte,
+    UShort,
+    Half,
+    Float
+};
+
+struct FormatTraits {
+    uint32_t Channels;
+    ComponentKind Kind;
+};
+
+constexpr FormatTraits GetFormatTraits(ImageFormat format) noexcept {
+    switch (format) {
+        case ImageFormat::R8_BYTE: return {1, ComponentKind::Byte};
+        case ImageFormat::R16_USHORT: return {1, ComponentKind::UShort};
+        case ImageFormat::R16_HALF: return {1, ComponentKind::Half};
+        case ImageFormat::R32_FLOAT: return {1, ComponentKind::Float};
+        case ImageFormat::RG8_BYTE: return {2, ComponentKind::Byte};
+        case ImageFormat::RG16_USHORT: return {2, ComponentKind::UShort};
+        case ImageFormat::RG16_HALF: return {2, ComponentKind::Half};
+        case ImageFormat::RG32_FLOAT: return {2, ComponentKind::Float};
+        case ImageFormat::RGB32_FLOAT: return {3, ComponentKind::Float};
+        case ImageFormat::RGBA8_BYTE: return {4, ComponentKind::Byte};
+        case ImageFormat::RGBA16_USHORT: return {4, ComponentKind::UShort};
+        case ImageFormat::RGBA16_HALF: return {4, ComponentKind::Half};
+        case ImageFormat::RGBA32_FLOAT: return {4, ComponentKind::Float};
+        case ImageFormat::RGB8_BYTE: return {3, ComponentKind::Byte};
+        case ImageFormat::RGB16_USHORT: return {3, ComponentKind::UShort};
+    }
+    return {0, ComponentKind::Byte};
+}
+
+constexpr ImageFormat kByteFormats[] = {
+    ImageFormat::R8_BYTE, ImageFormat::RG8_BYTE, ImageFormat::RGB8_BYTE, ImageFormat::RGBA8_BYTE};
+
+bool CanPremultiply(ImageFormat format) noexcept {
+    return format == ImageFormat::RGBA8_BYTE ||
+           format == ImageFormat::RGBA16_HALF ||
+           format == ImageFormat::RGBA32_FLOAT;
+}
+
+// ─── 标量 kernel ───
+//
+// 行内的源与目标可以是同一缓冲 (ConvertImageInPlace): 收窄的 kernel 逐元素向前推进, 写位置始终不超过读位置。
+
+using ValueFn = void (*)(const byte* src, byte* dst, size_t count) noexcept;
+using ExpandFn = void (*)(const byte* src, byte* dst, size_t count, uint8_t alpha) noexcept;
+using PremultiplyFn = void (*)(byte* pixels, size_t count) noexcept;
+
+uint16_t LoadU16(const byte* p) noexcept {
+    uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint32_t LoadU32(const byte* p) noexcept {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void StoreU16(byte* p, uint16_t v) noexcept { std::memcpy(p, &v, sizeof(v)); }
+
+void StoreU32(byte* p, uint32_t v) noexcept { std::memcpy(p, &v, sizeof(v)); }
+
+/// round(v * 255 / 65535)。v / 257 的小数部分不会恰为 .5, 整数式与浮点舍入处处相等。
+uint8_t NarrowU16(uint32_t v) noexcept {
+    return static_cast<uint8_t>((v * 255u + 32895u) >> 16);
+}
+
+/// round(c * a / 255)。
+uint8_t MulDiv255(uint32_t c, uint32_t a) noexcept {
+    const uint32_t t = c * a + 128u;
+    return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+}
+
+/// half -> float, 精确。NaN 置 quiet 位并保留其余载荷, 与 F16C 一致。
+uint32_t HalfToFloatBits(uint16_t h) noexcept {
+    constexpr uint32_t kShiftedExp = 0x7c00u << 13;
+    uint32_t bits = (static_cast<uint32_t>(h) & 0x7fffu) << 13;
+    const uint32_t exp = bits & kShiftedExp;
+    bits += (127u - 15u) << 23;
+    if (exp == kShiftedExp) {
+        bits += (128u - 16u) << 23;
+        if ((h & 0x03ffu) != 0) {
+            bits |= 0x00400000u;
+        }
+    } else if (exp == 0) {
+        // 零与非规格数: 借一次浮点减法做归一化。
+        bits += 1u << 23;
+        bits = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) - std::bit_cast<float>(113u << 23));
+    }
+    return bits | ((static_cast<uint32_t>(h) & 0x8000u) << 16);
+}
+
+/// float -> half, 就近舍入到偶数; 超出范围得 inf, NaN 截掉低位载荷并置 quiet 位。
+uint16_t FloatToHalfBits(uint32_t bits) noexcept {
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t f = bits & 0x7fffffffu;
+    uint32_t h;
+    if (f >= ((127u + 16u) << 23)) {
+        h = f > 0x7f800000u ? (0x7e00u | ((f >> 13) & 0x03ffu)) : 0x7c00u;
+    } else if (f < (113u << 23)) {
+        // 结果是 half 的非规格数或零: 加一个魔数让浮点加法按当前 (就近) 模式舍入到 half 的最小单位。
+        constexpr uint32_t kDenormMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+        const float sum = std::bit_cast<float>(f) + std::bit_cast<float>(kDenormMagic);
+        h = std::bit_cast<uint32_t>(sum) - kDenormMagic;
+    } else {
+        const uint32_t mantissaOdd = (f >> 13) & 1u;
+        f += ((15u - 127u) << 23) + 0x0fffu;
+        f += mantissaOdd;
+        h = f >> 13;
+    }
+    return static_cast<uint16_t>(h | sign);
+}
+
+void Narrow16Scalar(const byte* src, byte* dst, size_t count) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<byte>(NarrowU16(LoadU16(src + i * 2)));
+    }
+}
+
+void HalfToFloatScalar(const byte* src, byte* dst, size_t count) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        StoreU32(dst + i * 4, HalfToFloatBits(LoadU16(src + i * 2)));
+    }
+}
+
+void FloatToHalfScalar(const byte* src, byte* dst, size_t count) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        StoreU16(dst + i * 2, FloatToHalfBits(LoadU32(src + i * 4)));
+    }
+}
+
+void R8ToRgba8Scalar(const byte* src, byte* dst, size_t count, uint8_t alpha) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        const byte g = src[i];
+        dst[i * 4 + 0] = g;
+        dst[i * 4 + 1] = g;
+        dst[i * 4 + 2] = g;
+        dst[i * 4 + 3] = static_cast<byte>(alpha);
+    }
+}
+
+void Rg8ToRgba8Scalar(const byte* src, byte* dst, size_t count, uint8_t) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        const byte g = src[i * 2 + 0];
+        dst[i * 4 + 0] = g;
+        dst[i * 4 + 1] = g;
+        dst[i * 4 + 2] = g;
+        dst[i * 4 + 3] = src[i * 2 + 1];
+    }
+}
+
+void Rgb8ToRgba8Scalar(const byte* src, byte* dst, size_t count, uint8_t alpha) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = static_cast<byte>(alpha);
+    }
+}
+
+void PremultiplyRgba8Scalar(byte* pixels, size_t count) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        byte* p = pixels + i * 4;
+        const uint32_t a = static_cast<uint8_t>(p[3]);
+        for (size_t c = 0; c < 3; ++c) {
+            p[c] = static_cast<byte>(MulDiv255(static_cast<uint8_t>(p[c]), a));
+        }
+    }
+}
+
+void PremultiplyRgba16HalfScalar(byte* pixels, size_t count) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        byte* p = pixels + i * 8;
+        const float a = std::bit_cast<float>(HalfToFloatBits(LoadU16(p + 6)));
+        for (size_t c = 0; c < 3; ++c) {
+            const float v = std::bit_cast<float>(HalfToFloatBits(LoadU16(p + c * 2))) * a;
+            StoreU16(p + c * 2, FloatToHalfBits(std::bit_cast<uint32_t>(v)));
+        }
+    }
+}
+
+void PremultiplyRgba32FloatScalar(byte* pixels, size_t count) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        byte* p = pixels + i * 16;
+        const float a = std::bit_cast<float>(LoadU32(p + 12));
+        for (size_t c = 0; c < 3; ++c) {
+            StoreU32(p + c * 4, std::bit_cast<uint32_t>(std::bit_cast<float>(LoadU32(p + c * 4)) * a));
+        }
+    }
+}
+
+// ─── SIMD kernel ───
+//
+// 主循环按寄存器宽度成块处理, 尾部交给标量版, 结果逐字节相同。
+
+void Narrow16Simd(const byte* src, byte* dst, size_t count) noexcept {
+    size_t i = 0;
+#if defined(RADRAY_PIXEL_SSE2)
+    // v * 255 + 32895 的 32 位结果拆成 mulhi / mullo, 低半加 32895 进位时高半加一。
+    const __m128i k255 = _mm_set1_epi16(255);
+    const __m128i kSignFlip = _mm_set1_epi16(static_cast<short>(0x8000));
+    const __m128i kCarryAbove = _mm_set1_epi16(static_cast<short>(32640 ^ 0x8000));
+    for (; i + 16 <= count; i += 16) {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2 + 16));
+        const __m128i hi0 = _mm_mulhi_epu16(v0, k255);
+        const __m128i hi1 = _mm_mulhi_epu16(v1, k255);
+        const __m128i carry0 = _mm_cmpgt_epi16(_mm_xor_si128(_mm_mullo_epi16(v0, k255), kSignFlip), kCarryAbove);
+        const __m128i carry1 = _mm_cmpgt_epi16(_mm_xor_si128(_mm_mullo_epi16(v1, k255), kSignFlip), kCarryAbove);
+        const __m128i r0 = _mm_sub_epi16(hi0, carry0);
+        const __m128i r1 = _mm_sub_epi16(hi1, carry1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(r0, r1));
+    }
+#elif defined(RADRAY_PIXEL_NEON)
+    const uint16x4_t k255 = vdup_n_u16(255);
+    const uint32x4_t kBias = vdupq_n_u32(32895);
+    for (; i + 8 <= count; i += 8) {
+        uint16_t lanes[8];
+        std::memcpy(lanes, src + i * 2, sizeof(lanes));
+        const uint16x8_t v = vld1q_u16(lanes);
+        const uint16x4_t lo = vshrn_n_u32(vmlal_u16(kBias, vget_low_u16(v), k255), 16);
+        const uint16x4_t hi = vshrn_n_u32(vmlal_u16(kBias, vget_high_u16(v), k255), 16);
+        vst1_u8(reinterpret_cast<uint8_t*>(dst + i), vmovn_u16(vcombine_u16(lo, hi)));
+    }
+#endif
+    Narrow16Scalar(src + i * 2, dst + i, count - i);
+}
+
+void HalfToFloatSimd(const byte* src, byte* dst, size_t count) noexcept {
+    size_t i = 0;
+#if defined(RADRAY_PIXEL_F16C)
+    for (; i + 8 <= count; i += 8) {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+        _mm_storeu_ps(reinterpret_cast<float*>(dst + i * 4), _mm_cvtph_ps(h));
+        _mm_storeu_ps(reinterpret_cast<float*>(dst + i * 4 + 16), _mm_cvtph_ps(_mm_srli_si128(h, 8)));
+    }
+#elif defined(RADRAY_PIXEL_NEON_F16)
+    for (; i + 4 <= count; i += 4) {
+        uint16_t lanes[4];
+        std::memcpy(lanes, src + i * 2, sizeof(lanes));
+        const float32x4_t f = vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(lanes)));
+        std::memcpy(dst + i * 4, &f, sizeof(f));
+    }
+#endif
+    HalfToFloatScalar(src + i * 2, dst + i * 4, count - i);
+}
+
+void FloatToHalfSimd(const byte* src, byte* dst, size_t count) noexcept {
+    size_t i = 0;
+#if defined(RADRAY_PIXEL_F16C)
+    for (; i + 8 <= count; i += 8) {
+        const __m128 f0 = _mm_loadu_ps(reinterpret_cast<const float*>(src + i * 4));
+        const __m128 f1 = _mm_loadu_ps(reinterpret_cast<const float*>(src + i * 4 + 16));
+        const __m128i h = _mm_unpacklo_epi64(
+            _mm_cvtps_ph(f0, _MM_FROUND_TO_NEAREST_INT),
+            _mm_cvtps_ph(f1, _MM_FROUND_TO_NEAREST_INT));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), h);
+    }
+#elif defined(RADRAY_PIXEL_NEON_F16)
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t f;
+        std::memcpy(&f, src + i * 4, sizeof(f));
+        const uint16x4_t h = vreinterpret_u16_f16(vcvt_f16_f32(f));
+        std::memcpy(dst + i * 2, &h, sizeof(h));
+    }
+#endif
+    FloatToHalfScalar(src + i * 4, dst + i * 2, count - i);
+}
+
+void R8ToRgba8Simd(const byte* src, byte* dst, size_t count, uint8_t alpha) noexcept {
+    size_t i = 0;
+#if defined(RADRAY_PIXEL_SSE2)
+    // gg = (g, g), ga = (g, a), 再按 16 位交错成 (g, g, g, a)。
+    const __m128i a = _mm_set1_epi8(static_cast<char>(alpha));
+    for (; i + 16 <= count; i += 16) {
+        const __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i ggLo = _mm_unpacklo_epi8(g, g);
+        const __m128i ggHi = _mm_unpackhi_epi8(g, g);
+        const __m128i gaLo = _mm_unpacklo_epi8(g, a);
+        const __m128i gaHi = _mm_unpackhi_epi8(g, a);
+        __m128i* out = reinterpret_cast<__m128i*>(dst + i * 4);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(ggLo, gaLo));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(ggLo, gaLo));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(ggHi, gaHi));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(ggHi, gaHi));
+    }
+#elif defined(RADRAY_PIXEL_NEON)
+    const uint8x16_t a = vdupq_n_u8(alpha);
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16_t g = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst + i * 4), uint8x16x4_t{{g, g, g, a}});
+    }
+#endif
+    R8ToRgba8Scalar(src + i, dst + i * 4, count - i, alpha);
+}
+
+void Rg8ToRgba8Simd(const byte* src, byte* dst, size_t count, uint8_t alpha) noexcept {
+    size_t i = 0;
+#if defined(RADRAY_PIXEL_SSE2)
+    // 每个 16 位通道是 g | a << 8; 取 g 复制成 (g, g) 后与原值交错得到 (g, g, g, a)。
+    const __m128i kLow = _mm_set1_epi16(0x00ff);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+        const __m128i g = _mm_and_si128(v, kLow);
+        const __m128i gg = _mm_or_si128(g, _mm_slli_epi16(g, 8));
+        __m128i* out = reinterpret_cast<__m128i*>(dst + i * 4);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(gg, v));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(gg, v));
+    }
+#elif defined(RADRAY_PIXEL_NEON)
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16x2_t v = vld2q_u8(reinterpret_cast<const uint8_t*>(src + i * 2));
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst + i * 4), uint8x16x4_t{{v.val[0], v.val[0], v.val[0], v.val[1]}});
+    }
+#endif
+    Rg8ToRgba8Scalar(src + i * 2, dst + i * 4, count - i, alpha);
+}
+
+void Rgb8ToRgba8Simd(const byte* src, byte* dst, size_t count, uint8_t alpha) noexcept {
+    size_t i = 0;
+#if defined(RADRAY_PIXEL_SSSE3)
+    // 一次 16 字节装载只用前 12 字节 (4 像素); 剩余不足 16 字节可读时交给标量尾。
+    const __m128i kShuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i a = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+    for (; i + 6 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, kShuffle), a));
+    }
+#elif defined(RADRAY_PIXEL_NEON)
+    const uint8x16_t a = vdupq_n_u8(alpha);
+    for (; i + 16 <= count; i += 16) {
+        const uint8x16x3_t v = vld3q_u8(reinterpret_cast<const uint8_t*>(src + i * 3));
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst + i * 4), uint8x16x4_t{{v.val[0], v.val[1], v.val[2], a}});
+    }
+#endif
+    Rgb8ToRgba8Scalar(src + i * 3, dst + i * 4, count - i, alpha);
+}
+
+void PremultiplyRgba8Simd(byte* pixels, size_t count) noexcept {
+    size_t i = 0;
+#if defined(RADRAY_PIXEL_SSE2)
+    // 展开到 16 位, 每像素的 alpha 广播到四个通道; 乘完后 alpha 通道换回原值。
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k128 = _mm_set1_epi16(128);
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+    for (; i + 4 <= count; i += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(pixels + i * 4);
+        const __m128i v = _mm_loadu_si128(p);
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        const __m128i aLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128i aHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i tLo = _mm_add_epi16(_mm_mullo_epi16(lo, aLo), k128);
+        __m128i tHi = _mm_add_epi16(_mm_mullo_epi16(hi, aHi), k128);
+        tLo = _mm_srli_epi16(_mm_add_epi16(tLo, _mm_srli_epi16(tLo, 8)), 8);
+        tHi = _mm_srli_epi16(_mm_add_epi16(tHi, _mm_srli_epi16(tHi, 8)), 8);
+        const __m128i rgb = _mm_andnot_si128(alphaMask, _mm_packus_epi16(tLo, tHi));
+        _mm_storeu_si128(p, _mm_or_si128(rgb, _mm_and_si128(v, alphaMask)));
+    }
+#elif defined(RADRAY_PIXEL_NEON)
+    const uint16x8_t k128 = vdupq_n_u16(128);
+    for (; i + 16 <= count; i += 16) {
+        uint8_t* p = reinterpret_cast<uint8_t*>(pixels + i * 4);
+        uint8x16x4_t v = vld4q_u8(p);
+        for (int c = 0; c < 3; ++c) {
+            const uint16x8_t tLo = vaddq_u16(vmull_u8(vget_low_u8(v.val[c]), vget_low_u8(v.val[3])), k128);
+            const uint16x8_t tHi = vaddq_u16(vmull_u8(vget_high_u8(v.val[c]), vget_high_u8(v.val[3])), k128);
+            v.val[c] = vcombine_u8(
+                vshrn_n_u16(vsraq_n_u16(tLo, tLo, 8), 8),
+                vshrn_n_u16(vsraq_n_u16(tHi, tHi, 8), 8));
+        }
+        vst4q_u8(p, v);
+    }
+#endif
+    PremultiplyRgba8Scalar(pixels + i * 4, count - i);
+}
+
+void PremultiplyRgba16HalfSimd(byte* pixels, size_t count) noexcept {
+    size_t i = 0;
+#if defined(RADRAY_PIXEL_F16C)
+    // 一次两个像素: 每个像素的四个 half 展成 float, 乘以广播的 alpha, alpha 通道保持原值。
+    for (; i + 2 <= count; i += 2) {
+        __m128i* p = reinterpret_cast<__m128i*>(pixels + i * 8);
+        const __m128i h = _mm_loadu_si128(p);
+        const __m128 f0 = _mm_cvtph_ps(h);
+        const __m128 f1 = _mm_cvtph_ps(_mm_srli_si128(h, 8));
+        __m128 m0 = _mm_mul_ps(f0, _mm_shuffle_ps(f0, f0, _MM_SHUFFLE(3, 3, 3, 3)));
+        __m128 m1 = _mm_mul_ps(f1, _mm_shuffle_ps(f1, f1, _MM_SHUFFLE(3, 3, 3, 3)));
+        // 把 alpha 换回乘之前的值: (m.x, m.y, m.z, f.w)。
+        m0 = _mm_shuffle_ps(m0, _mm_shuffle_ps(m0, f0, _MM_SHUFFLE(3, 3, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0));
+        m1 = _mm_shuffle_ps(m1, _mm_shuffle_ps(m1, f1, _MM_SHUFFLE(3, 3, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0));
+        const __m128i out = _mm_unpacklo_epi64(
+            _mm_cvtps_ph(m0, _MM_FROUND_TO_NEAREST_INT),
+            _mm_cvtps_ph(m1, _MM_FROUND_TO_NEAREST_INT));
+        _mm_storeu_si128(p, out);
+    }
+#endif
+    PremultiplyRgba16HalfScalar(pixels + i * 8, count - i);
+}
+
+void PremultiplyRgba32FloatSimd(byte* pixels, size_t count) noexcept {
+    size_t i = 0;
+#if defined(RADRAY_PIXEL_SSE2)
+    for (; i < count; ++i) {
+        float* p = reinterpret_cast<float*>(pixels + i * 16);
+        const __m128 v = _mm_loadu_ps(p);
+        const __m128 m = _mm_mul_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)));
+        _mm_storeu_ps(p, _mm_shuffle_ps(m, _mm_shuffle_ps(m, v, _MM_SHUFFLE(3, 3, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0)));
+    }
+#elif defined(RADRAY_PIXEL_NEON)
+    for (; i < count; ++i) {
+        float* p = reinterpret_cast<float*>(pixels + i * 16);
+        const float32x4_t v = vld1q_f32(p);
+        vst1q_f32(p, vsetq_lane_f32(vgetq_lane_f32(v, 3), vmulq_n_f32(v, vgetq_lane_f32(v, 3)), 3));
+    }
+#endif
+    PremultiplyRgba32FloatScalar(pixels + i * 16, count - i);
+}
+
+// ─── 组合 ───
+
+struct PixelKernels {
+    ValueFn Narrow16;
+    ValueFn HalfToFloat;
+    ValueFn FloatToHalf;
+    ExpandFn Expand[3];  // R8 / RG8 / RGB8 -> RGBA8
+    PremultiplyFn PremultiplyRgba8;
+    PremultiplyFn PremultiplyRgba16Half;
+    PremultiplyFn PremultiplyRgba32Float;
+};
+
+constexpr PixelKernels kScalarKernels{
+    Narrow16Scalar,
+    HalfToFloatScalar,
+    FloatToHalfScalar,
+    {R8ToRgba8Scalar, Rg8ToRgba8Scalar, Rgb8ToRgba8Scalar},
+    PremultiplyRgba8Scalar,
+    PremultiplyRgba16HalfScalar,
+    PremultiplyRgba32FloatScalar};
+
+constexpr PixelKernels kSimdKernels{
+    Narrow16Simd,
+    HalfToFloatSimd,
+    FloatToHalfSimd,
+    {R8ToRgba8Simd, Rg8ToRgba8Simd, Rgb8ToRgba8Simd},
+    PremultiplyRgba8Simd,
+    PremultiplyRgba16HalfSimd,
+    PremultiplyRgba32FloatSimd};
+
+/// 一次转换拆成至多三步, 都在同一段像素上接着做: 通道值转换 (16 -> 8 / half <-> float)、
+/// 8 位通道扩展到 RGBA8、预乘。两步都有时中间结果放在栈上的分块缓冲里。
+struct ConversionPlan {
+    ValueFn Values{nullptr};
+    uint32_t ValueChannels{0};
+    ExpandFn Expand{nullptr};
+    PremultiplyFn Premultiply{nullptr};
+    uint32_t SrcPixelBytes{0};
+    uint32_t MidPixelBytes{0};
+    uint32_t DstPixelBytes{0};
+};
+
+constexpr size_t kChunkPixels = 512;
+
+bool BuildConversionPlan(
+    ImageFormat from,
+    ImageFormat to,
+    bool premultiplyAlpha,
+    const PixelKernels& kernels,
+    ConversionPlan& plan) noexcept {
+    const FormatTraits src = GetFormatTraits(from);
+    const FormatTraits dst = GetFormatTraits(to);
+    if (src.Channels == 0 || dst.Channels == 0) {
+        return false;
+    }
+    if (premultiplyAlpha && !CanPremultiply(to)) {
+        return false;
+    }
+    plan = ConversionPlan{};
+    plan.SrcPixelBytes = static_cast<uint32_t>(ImageData::FormatSize(from));
+    plan.DstPixelBytes = static_cast<uint32_t>(ImageData::FormatSize(to));
+    if (from != to) {
+        ImageFormat expandFrom = from;
+        if (src.Kind == ComponentKind::UShort) {
+            plan.Values = kernels.Narrow16;
+            plan.ValueChannels = src.Channels;
+            expandFrom = kByteFormats[src.Channels - 1];
+            plan.MidPixelBytes = src.Channels;
+        } else if (src.Kind == ComponentKind::Half && dst.Kind == ComponentKind::Float && src.Channels == dst.Channels) {
+            plan.Values = kernels.HalfToFloat;
+            plan.ValueChannels = src.Channels;
+            expandFrom = to;
+        } else if (src.Kind == ComponentKind::Float && dst.Kind == ComponentKind::Half && src.Channels == dst.Channels) {
+            plan.Values = kernels.FloatToHalf;
+            plan.ValueChannels = src.Channels;
+            expandFrom = to;
+        }
+        if (expandFrom != to) {
+            if (GetFormatTraits(expandFrom).Kind != ComponentKind::Byte || to != ImageFormat::RGBA8_BYTE) {
+                return false;
+            }
+            plan.Expand = kernels.Expand[GetFormatTraits(expandFrom).Channels - 1];
+        }
+    }
+    if (premultiplyAlpha) {
+        switch (to) {
+            case ImageFormat::RGBA8_BYTE: plan.Premultiply = kernels.PremultiplyRgba8; break;
+            case ImageFormat::RGBA16_HALF: plan.Premultiply = kernels.PremultiplyRgba16Half; break;
+            default: plan.Premultiply = kernels.PremultiplyRgba32Float; break;
+        }
+    }
+    return true;
+}
+
+/// 转换一行。src 与 dst 可以指向同一位置, 只要目标像素不比源大 (见上文 kernel 的推进顺序)。
+void ConvertRow(const ConversionPlan& plan, const byte* src, byte* dst, size_t width, uint8_t alpha) noexcept {
+    if (plan.Values == nullptr && plan.Expand == nullptr && plan.Premultiply == nullptr) {
+        if (src != dst) {
+            std::memmove(dst, src, width * plan.SrcPixelBytes);
+        }
+        return;
+    }
+    alignas(16) byte mid[kChunkPixels * 4];
+    for (size_t x = 0; x < width; x += kChunkPixels) {
+        const size_t n = std::min(kChunkPixels, width - x);
+        const byte* s = src + x * plan.SrcPixelBytes;
+        byte* d = dst + x * plan.DstPixelBytes;
+        if (plan.Values != nullptr && plan.Expand != nullptr) {
+            plan.Values(s, mid, n * plan.ValueChannels);
+            plan.Expand(mid, d, n, alpha);
+        } else if (plan.Values != nullptr) {
+            plan.Values(s, d, n * plan.ValueChannels);
+        } else if (plan.Expand != nullptr) {
+            plan.Expand(s, d, n, alpha);
+        } else if (s != d) {
+            std::memmove(d, s, n * plan.SrcPixelBytes);
+        }
+        if (plan.Premultiply != nullptr) {
+            plan.Premultiply(d, n);
+        }
+    }
+}
+
+bool ConvertPixelsWith(
+    const PixelKernels& kernels,
+    ImageFormat from,
+    std::span<const byte> src,
+    ImageFormat to,
+    std::span<byte> dst,
+    uint32_t width,
+    uint32_t height,
+    const PixelConvertOptions& options) noexcept {
+    ConversionPlan plan;
+    if (!BuildConversionPlan(from, to, options.PremultiplyAlpha, kernels, plan)) {
+        return false;
+    }
+    const size_t srcRow = static_cast<size_t>(width) * plan.SrcPixelBytes;
+    const size_t dstRow = static_cast<size_t>(width) * plan.DstPixelBytes;
+    if (src.size() < srcRow * height || dst.size() < dstRow * height) {
+        return false;
+    }
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint32_t srcY = options.FlipY ? height - 1 - y : y;
+        ConvertRow(plan, src.data() + srcY * srcRow, dst.data() + y * dstRow, width, options.Alpha);
+    }
+    return true;
+}
+
+}  // namespace
+
+float HalfToFloat(uint16_t value) noexcept {
+    return std::bit_cast<float>(HalfToFloatBits(value));
+}
+
+uint16_t FloatToHalf(float value) noexcept {
+    return FloatToHalfBits(std::bit_cast<uint32_t>(value));
+}
+
+bool IsPixelConversionSupported(ImageFormat from, ImageFormat to, bool premultiplyAlpha) noexcept {
+    ConversionPlan plan;
+    return BuildConversionPlan(from, to, premultiplyAlpha, kScalarKernels, plan);
+}
+
+bool ConvertPixels(
+    ImageFormat from,
+    std::span<const byte> src,
+    ImageFormat to,
+    std::span<byte> dst,
+    uint32_t width,
+    uint32_t height,
+    const PixelConvertOptions& options) noexcept {
+    RADRAY_PROFILE_SCOPE("ConvertPixels");
+    return ConvertPixelsWith(kSimdKernels, from, src, to, dst, width, height, options);
+}
+
+bool ConvertPixelsScalar(
+    ImageFormat from,
+    std::span<const byte> src,
+    ImageFormat to,
+    std::span<byte> dst,
+    uint32_t width,
+    uint32_t height,
+    const PixelConvertOptions& options) noexcept {
+    return ConvertPixelsWith(kScalarKernels, from, src, to, dst, width, height, options);
+}
+
+ImageData ConvertImage(const ImageData& image, ImageFormat to, const PixelConvertOptions& options) {
+    ImageData result;
+    if (!image.Data || image.Width == 0 || image.Height == 0 ||
+        !IsPixelConversionSupported(image.Format, to, options.PremultiplyAlpha)) {
+        return result;
+    }
+    result.Width = image.Width;
+    result.Height = image.Height;
+    result.Format = to;
+    result.Data = std::make_unique_for_overwrite<byte[]>(result.GetSize());
+    ConvertPixels(
+        image.Format,
+        image.GetSpan(),
+        to,
+        std::span<byte>{result.Data.get(), result.GetSize()},
+        image.Width,
+        image.Height,
+        options);
+    return result;
+}
+
+bool ConvertImageInPlace(ImageData& image, ImageFormat to, const PixelConvertOptions& options) {
+    ConversionPlan plan;
+    if (!image.Data || image.Width == 0 || image.Height == 0 ||
+        !BuildConversionPlan(image.Format, to, options.PremultiplyAlpha, kSimdKernels, plan)) {
+        return false;
+    }
+    if (plan.DstPixelBytes > plan.SrcPixelBytes) {
+        image = ConvertImage(image, to, options);
+        return true;
+    }
+    RADRAY_PROFILE_SCOPE("ConvertImageInPlace");
+    const size_t width = image.Width;
+    const uint32_t height = image.Height;
+    const size_t srcRow = width * plan.SrcPixelBytes;
+    const size_t dstRow = width * plan.DstPixelBytes;
+    byte* data = image.Data.get();
+    if (options.FlipY && plan.DstPixelBytes == plan.SrcPixelBytes) {
+        // 上下两行成对处理: 上行先转进暂存, 下行转到上行原位, 暂存再拷到下行。
+        vector<byte> scratch(dstRow);
+        for (uint32_t y = 0; y < height / 2; ++y) {
+            byte* top = data + y * srcRow;
+            byte* bottom = data + (height - 1 - y) * srcRow;
+            ConvertRow(plan, top, scratch.data(), width, options.Alpha);
+            ConvertRow(plan, bottom, top, width, options.Alpha);
+            std::memcpy(bottom, scratch.data(), dstRow);
+        }
+        if (height % 2 != 0) {
+            byte* middle = data + (height / 2) * srcRow;
+            ConvertRow(plan, middle, middle, width, options.Alpha);
+        }
+        image.Format = to;
+        return true;
+    }
+    // 收窄: 第 y 行写到 y * dstRow, 不超过它自己与之后各行的读位置, 正序原地转换即可。
+    for (uint32_t y = 0; y < height; ++y) {
+        ConvertRow(plan, data + y * srcRow, data + y * dstRow, width, options.Alpha);
+    }
+    image.Format = to;
+    if (options.FlipY) {
+        image.FlipY();
+    }
+    return true;
+}
+
+}  // namespace radray
@@ -0,0 +1,304 @@
+#include <radray/profiler.h>
+
+#if defined(RADRAY_ENABLE_PROFILER)
+
+#include <bit>
+#include <mutex>
+
+#include <radray/types.h>
+
+namespace radray {
+
+namespace {
+
+enum class ProfileEventType : uint8_t {
+    Zone,
+    FrameMark,
+    Counter,
+};
+
+struct ProfileEvent {
+    const char* Name;
+    int64_t Start;
+    /// Zone 为时长（纳秒），Counter 为 bit_cast 后的 double。
+    int64_t Payload;
+    ProfileEventType Type;
+};
+
+/// 单线程写、任意线程读的事件块。Count 以 release 发布，读者只看 Count 之前的事件。
+struct ProfileChunk {
+    static constexpr uint32_t kCapacity = 4096;
+
+    std::atomic<uint32_t> Count{0};
+    std::atomic<ProfileChunk*> Next{nullptr};
+    ProfileEvent Events[kCapacity];
+};
+
+struct ProfileThreadBuffer {
+    uint32_t ThreadId{0};
+    std::atomic<const char*> Name{nullptr};
+    /// 本缓冲当前数据所属的采集代；与全局代不同时说明数据已过期。
+    std::atomic<uint64_t> Generation{0};
+    std::atomic<uint64_t> DroppedCount{0};
+    ProfileChunk* Head{nullptr};
+    /// 所属线程已退出，可以交给新线程续用。受 ProfilerRegistry::Mutex 保护。
+    bool Retired{false};
+    // 以下仅所属线程访问；续用时经 Mutex 交接。
+    ProfileChunk* Current{nullptr};
+    uint32_t EventCount{0};
+};
+
+struct ProfilerRegistry {
+    std::mutex Mutex;
+    vector<unique_ptr<ProfileThreadBuffer>> Buffers;
+    std::atomic<uint64_t> Generation{0};
+    std::atomic<uint32_t> MaxEventsPerThread{0};
+    std::atomic<int64_t> CaptureStart{0};
+};
+
+ProfilerRegistry& GetProfilerRegistry() noexcept {
+    // 有意泄漏：进程退出时仍可能有线程在写，不能让注册表先于它们析构。
+    static ProfilerRegistry* registry = new ProfilerRegistry{};
+    return *registry;
+}
+
+thread_local ProfileThreadBuffer* t_profileBuffer = nullptr;
+thread_local bool t_profileThreadExited = false;
+
+/// 线程退出时把缓冲标记为 Retired。已写的事件留在缓冲里照常导出，直到新线程续用它、
+/// 在下一次采集时惰性清空；缓冲个数因此以同时记录过事件的线程数为上限，而不是线程总数。
+struct ProfileThreadBufferOwner {
+    ProfileThreadBuffer* Buffer{nullptr};
+
+    ~ProfileThreadBufferOwner() noexcept {
+        if (Buffer == nullptr) {
+            return;
+        }
+        ProfilerRegistry& registry = GetProfilerRegistry();
+        std::lock_guard<std::mutex> lock{registry.Mutex};
+        Buffer->Retired = true;
+        t_profileBuffer = nullptr;
+        t_profileThreadExited = true;
+    }
+};
+
+thread_local ProfileThreadBufferOwner t_profileBufferOwner;
+
+ProfileThreadBuffer* ClaimRetiredBuffer(ProfilerRegistry& registry) noexcept {
+    // 优先续用数据已过期的缓冲；本次采集的数据仍在的缓冲续用时保留事件，新线程接着写在同一个 tid 上。
+    const uint64_t generation = registry.Generation.load(std::memory_order_acquire);
+    ProfileThreadBuffer* claimed = nullptr;
+    for (const unique_ptr<ProfileThreadBuffer>& buffer : registry.Buffers) {
+        if (!buffer->Retired) {
+            continue;
+        }
+        claimed = buffer.get();
+        if (buffer->Generation.load(std::memory_order_relaxed) != generation) {
+            break;
+        }
+    }
+    if (claimed != nullptr) {
+        claimed->Retired = false;
+        if (claimed->Generation.load(std::memory_order_relaxed) != generation) {
+            claimed->Name.store(nullptr, std::memory_order_release);
+        }
+    }
+    return claimed;
+}
+
+ProfileThreadBuffer* GetThreadBuffer() noexcept {
+    if (t_profileBuffer != nullptr) {
+        return t_profileBuffer;
+    }
+    if (t_profileThreadExited) {
+        // 线程退出途中（其他 thread_local 析构时）的事件直接丢掉，不再注册新缓冲。
+        return nullptr;
+    }
+    ProfilerRegistry& registry = GetProfilerRegistry();
+    std::unique_lock<std::mutex> lock{registry.Mutex};
+    ProfileThreadBuffer* buffer = ClaimRetiredBuffer(registry);
+    if (buffer == nullptr) {
+        lock.unlock();
+        auto created = make_unique<ProfileThreadBuffer>();
+        created->Head = new ProfileChunk{};
+        created->Current = created->Head;
+        lock.lock();
+        created->ThreadId = static_cast<uint32_t>(registry.Buffers.size()) + 1;
+        buffer = created.get();
+        registry.Buffers.emplace_back(std::move(created));
+    }
+    t_profileBuffer = buffer;
+    t_profileBufferOwner.Buffer = buffer;
+    return buffer;
+}
+
+void ResetThreadBuffer(ProfileThreadBuffer* buffer, uint64_t generation) noexcept {
+    for (ProfileChunk* chunk = buffer->Head; chunk != nullptr; chunk = chunk->Next.load(std::memory_order_relaxed)) {
+        chunk->Count.store(0, std::memory_order_relaxed);
+    }
+    buffer->Current = buffer->Head;
+    buffer->EventCount = 0;
+    buffer->DroppedCount.store(0, std::memory_order_relaxed);
+    buffer->Generation.store(generation, std::memory_order_release);
+}
+
+void PushEvent(const ProfileEvent& event) noexcept {
+    ProfileThreadBuffer* buffer = GetThreadBuffer();
+    if (buffer == nullptr) {
+        return;
+    }
+    ProfilerRegistry& registry = GetProfilerRegistry();
+    const uint64_t generation = registry.Generation.load(std::memory_order_acquire);
+    if (buffer->Generation.load(std::memory_order_relaxed) != generation) {
+        ResetThreadBuffer(buffer, generation);
+    }
+    if (buffer->EventCount >= registry.MaxEventsPerThread.load(std::memory_order_relaxed)) {
+        buffer->DroppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ProfileChunk* chunk = buffer->Current;
+    uint32_t count = chunk->Count.load(std::memory_order_relaxed);
+    if (count == ProfileChunk::kCapacity) {
+        ProfileChunk* next = chunk->Next.load(std::memory_order_relaxed);
+        if (next == nullptr) {
+            next = new ProfileChunk{};
+            chunk->Next.store(next, std::memory_order_release);
+        }
+        chunk = next;
+        buffer->Current = chunk;
+        count = 0;
+    }
+    chunk->Events[count] = event;
+    chunk->Count.store(count + 1, std::memory_order_release);
+    ++buffer->EventCount;
+}
+
+template <typename Visit>
+void ForEachPublishedEvent(const ProfileThreadBuffer& buffer, Visit&& visit) {
+    for (const ProfileChunk* chunk = buffer.Head; chunk != nullptr; chunk = chunk->Next.load(std::memory_order_acquire)) {
+        const uint32_t count = chunk->Count.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; ++i) {
+            visit(chunk->Events[i]);
+        }
+        if (count < ProfileChunk::kCapacity) {
+            break;
+        }
+    }
+}
+
+double ToTraceMicroseconds(int64_t nanoseconds) noexcept {
+    return static_cast<double>(nanoseconds) / 1000.0;
+}
+
+}  // namespace
+
+void BeginProfileCapture(const ProfileCaptureDescriptor& desc) noexcept {
+    ProfilerRegistry& registry = GetProfilerRegistry();
+    registry.MaxEventsPerThread.store(desc.MaxEventsPerThread, std::memory_order_relaxed);
+    registry.CaptureStart.store(ProfileNow(), std::memory_order_relaxed);
+    registry.Generation.fetch_add(1, std::memory_order_acq_rel);
+    detail::g_profileCapturing.store(true, std::memory_order_release);
+}
+
+void EndProfileCapture() noexcept {
+    detail::g_profileCapturing.store(false, std::memory_order_release);
+}
+
+void SetProfileThreadName(const char* name) noexcept {
+    if (ProfileThreadBuffer* buffer = GetThreadBuffer(); buffer != nullptr) {
+        buffer->Name.store(name, std::memory_order_release);
+    }
+}
+
+void RecordProfileZone(const char* name, int64_t start, int64_t end) noexcept {
+    PushEvent(ProfileEvent{name, start, end - start, ProfileEventType::Zone});
+}
+
+void RecordProfileFrameMark(const char* name) noexcept {
+    PushEvent(ProfileEvent{name, ProfileNow(), 0, ProfileEventType::FrameMark});
+}
+
+void RecordProfileCounter(const char* name, double value) noexcept {
+    PushEvent(ProfileEvent{name, ProfileNow(), std::bit_cast<int64_t>(value), ProfileEventType::Counter});
+}
+
+ProfileCaptureStats GetProfileCaptureStats() noexcept {
+    ProfilerRegistry& registry = GetProfilerRegistry();
+    const uint64_t generation = registry.Generation.load(std::memory_order_acquire);
+    ProfileCaptureStats stats{};
+    std::lock_guard<std::mutex> lock{registry.Mutex};
+    for (const unique_ptr<ProfileThreadBuffer>& buffer : registry.Buffers) {
+        if (buffer->Generation.load(std::memory_order_acquire) != generation) {
+            continue;
+        }
+        ++stats.ThreadCount;
+        stats.DroppedEventCount += buffer->DroppedCount.load(std::memory_order_relaxed);
+        ForEachPublishedEvent(*buffer, [&stats](const ProfileEvent&) { ++stats.EventCount; });
+    }
+    return stats;
+}
+
+bool WriteProfileChromeTrace(JsonWriter& writer) noexcept {
+    if (!writer.IsValid()) {
+        return false;
+    }
+    ProfilerRegistry& registry = GetProfilerRegistry();
+    const uint64_t generation = registry.Generation.load(std::memory_order_acquire);
+    const int64_t origin = registry.CaptureStart.load(std::memory_order_relaxed);
+
+    JsonRef root = writer.RootObject();
+    JsonRef events = root.AddArray("traceEvents");
+    uint64_t dropped = 0;
+    std::lock_guard<std::mutex> lock{registry.Mutex};
+    for (const unique_ptr<ProfileThreadBuffer>& buffer : registry.Buffers) {
+        if (buffer->Generation.load(std::memory_order_acquire) != generation) {
+            continue;
+        }
+        dropped += buffer->DroppedCount.load(std::memory_order_relaxed);
+        const uint32_t tid = buffer->ThreadId;
+        if (const char* name = buffer->Name.load(std::memory_order_acquire); name != nullptr) {
+            JsonRef meta = events.AppendObject();
+            meta.AddString("name", "thread_name");
+            meta.AddString("ph", "M");
+            meta.AddUint("pid", 1);
+            meta.AddUint("tid", tid);
+            meta.AddObject("args").AddString("name", name);
+        }
+        ForEachPublishedEvent(*buffer, [&events, origin, tid](const ProfileEvent& event) {
+            JsonRef item = events.AppendObject();
+            item.AddString("name", event.Name);
+            item.AddDouble("ts", ToTraceMicroseconds(event.Start - origin));
+            item.AddUint("pid", 1);
+            item.AddUint("tid", tid);
+            switch (event.Type) {
+                case ProfileEventType::Zone:
+                    item.AddString("ph", "X");
+                    item.AddDouble("dur", ToTraceMicroseconds(event.Payload));
+                    break;
+                case ProfileEventType::FrameMark:
+                    item.AddString("ph", "i");
+                    item.AddString("s", "g");
+                    break;
+                case ProfileEventType::Counter:
+                    item.AddString("ph", "C");
+                    item.AddObject("args").AddDouble("value", std::bit_cast<double>(event.Payload));
+                    break;
+            }
+        });
+    }
+    root.AddString("displayTimeUnit", "ms");
+    root.AddObject("otherData").AddUint("droppedEvents", dropped);
+    return true;
+}
+
+bool SaveProfileChromeTrace(const std::filesystem::path& path) noexcept {
+    JsonWriter writer{};
+    if (!WriteProfileChromeTrace(writer)) {
+        return false;
+    }
+    return writer.WriteFile(path, false);
+}
+
+}  // namespace radray
+
+#endif
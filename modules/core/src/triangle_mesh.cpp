@@ -2,11 +2,34 @@
 
 #include <type_traits>
 #include <utility>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstring>
 
+#include <radray/pixel_convert.h>
 #include <radray/vertex_data.h>
 
 namespace radray {
+namespace {
+
+uint32_t QuantizeUnorm(float value, uint32_t bits) noexcept {
+    const float maxValue = static_cast<float>((1u << bits) - 1u);
+    return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * maxValue + 0.5f);
+}
+
+int32_t QuantizeSnorm(float value, uint32_t bits) noexcept {
+    const float maxValue = static_cast<float>((1u << (bits - 1)) - 1u);
+    return static_cast<int32_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * maxValue));
+}
+
+template <class T, size_t N>
+byte* StoreComponents(byte* dst, const std::array<T, N>& values) noexcept {
+    std::memcpy(dst, values.data(), sizeof(T) * N);
+    return dst + sizeof(T) * N;
+}
+
+}  // namespace
 
 bool TriangleMesh::IsValid() const noexcept {
     return Indices.size() > 0 &&
@@ -116,6 +139,119 @@ void TriangleMesh::ToSimpleMeshResource(MeshResource* outResource) const noexcep
     outResource->Primitives.emplace_back(std::move(primitive));
 }
 
+void TriangleMesh::ToQuantizedMeshResource(MeshResource* outResource) const noexcept {
+    if (outResource == nullptr) {
+        return;
+    }
+    if (!IsValid()) {
+        return;
+    }
+
+    MeshPrimitive primitive{};
+    primitive.VertexCount = static_cast<uint32_t>(Positions.size());
+    Eigen::Vector3f boundsMin = Positions[0];
+    Eigen::Vector3f boundsMax = Positions[0];
+    for (const Eigen::Vector3f& position : Positions) {
+        boundsMin = boundsMin.cwiseMin(position);
+        boundsMax = boundsMax.cwiseMax(position);
+    }
+    // 统一缩放: 扁平的网格在短轴上浪费一些精度, 换来反量化可以整个并进物体变换。
+    const float extent = (boundsMax - boundsMin).maxCoeff();
+    primitive.PositionOffset = boundsMin;
+    primitive.PositionScale = extent > 0.0f && std::isfinite(extent) ? extent : 1.0f;
+    const float invScale = 1.0f / primitive.PositionScale;
+    const bool halfTexcoord = std::all_of(UV0.begin(), UV0.end(), [](const Eigen::Vector2f& uv) noexcept {
+        return uv.cwiseAbs().maxCoeff() <= kMaxHalfTexcoord;
+    });
+
+    uint32_t vertexStride = 0;
+    auto pushAttrib = [&](bool present, std::string_view semantic, VertexDataType type, uint16_t componentCount) {
+        if (!present) {
+            return;
+        }
+        primitive.VertexBuffers.emplace_back(VertexBufferEntry{
+            .Semantic = string{semantic},
+            .SemanticIndex = 0,
+            .BufferIndex = 0,
+            .Type = type,
+            .ComponentCount = componentCount,
+            .Offset = vertexStride});
+        vertexStride += GetVertexDataSizeInBytes(type, componentCount);
+    };
+    pushAttrib(true, VertexSemantics::POSITION, VertexDataType::UNORM16, 4);
+    pushAttrib(!Normals.empty(), VertexSemantics::NORMAL, VertexDataType::SNORM16, 2);
+    pushAttrib(!UV0.empty(), VertexSemantics::TEXCOORD, halfTexcoord ? VertexDataType::HALF : VertexDataType::FLOAT, 2);
+    pushAttrib(!Tangents.empty(), VertexSemantics::TANGENT, VertexDataType::UNORM10_10_10_2, 4);
+    pushAttrib(!Color0.empty(), VertexSemantics::COLOR, VertexDataType::UNORM8, 4);
+    for (VertexBufferEntry& entry : primitive.VertexBuffers) {
+        entry.Stride = vertexStride;
+    }
+
+    // 属性顺序与上面 pushAttrib 的顺序一致, 逐顶点顺序写下去正好是各自的 Offset。
+    vector<byte> vertexData(static_cast<size_t>(vertexStride) * primitive.VertexCount);
+    for (size_t v = 0; v < primitive.VertexCount; v++) {
+        byte* dst = vertexData.data() + v * vertexStride;
+        const Eigen::Vector3f local = (Positions[v] - primitive.PositionOffset) * invScale;
+        dst = StoreComponents(dst, std::array<uint16_t, 4>{
+            static_cast<uint16_t>(QuantizeUnorm(local.x(), 16)),
+            static_cast<uint16_t>(QuantizeUnorm(local.y(), 16)),
+            static_cast<uint16_t>(QuantizeUnorm(local.z(), 16)),
+            uint16_t{0xffff}});
+        if (!Normals.empty()) {
+            const Eigen::Vector2f octahedral = OctahedralEncode(Normals[v]);
+            dst = StoreComponents(dst, std::array<int16_t, 2>{
+                static_cast<int16_t>(QuantizeSnorm(octahedral.x(), 16)),
+                static_cast<int16_t>(QuantizeSnorm(octahedral.y(), 16))});
+        }
+        if (!UV0.empty()) {
+            if (halfTexcoord) {
+                dst = StoreComponents(dst, std::array<uint16_t, 2>{FloatToHalf(UV0[v].x()), FloatToHalf(UV0[v].y())});
+            } else {
+                dst = StoreComponents(dst, std::array<float, 2>{UV0[v].x(), UV0[v].y()});
+            }
+        }
+        if (!Tangents.empty()) {
+            const Eigen::Vector2f octahedral = OctahedralEncode(Tangents[v].head<3>());
+            const uint32_t packed = QuantizeUnorm(octahedral.x() * 0.5f + 0.5f, 10) |
+                                    (QuantizeUnorm(octahedral.y() * 0.5f + 0.5f, 10) << 10) |
+                                    ((Tangents[v].w() < 0.0f ? 0u : 3u) << 30);
+            dst = StoreComponents(dst, std::array<uint32_t, 1>{packed});
+        }
+        if (!Color0.empty()) {
+            const Eigen::Vector4f& color = Color0[v];
+            dst = StoreComponents(dst, std::array<uint8_t, 4>{
+                static_cast<uint8_t>(QuantizeUnorm(color.x(), 8)),
+                static_cast<uint8_t>(QuantizeUnorm(color.y(), 8)),
+                static_cast<uint8_t>(QuantizeUnorm(color.z(), 8)),
+                static_cast<uint8_t>(QuantizeUnorm(color.w(), 8))});
+        }
+    }
+
+    vector<byte> indexData;
+    if (*std::max_element(Indices.begin(), Indices.end()) <= std::numeric_limits<uint16_t>::max()) {
+        indexData.resize(Indices.size() * sizeof(uint16_t));
+        for (size_t i = 0; i < Indices.size(); i++) {
+            const uint16_t index = static_cast<uint16_t>(Indices[i]);
+            std::memcpy(indexData.data() + i * sizeof(uint16_t), &index, sizeof(index));
+        }
+        primitive.IndexBuffer.Stride = sizeof(uint16_t);
+    } else {
+        indexData.resize(Indices.size() * sizeof(uint32_t));
+        std::memcpy(indexData.data(), reinterpret_cast<const byte*>(Indices.data()), indexData.size());
+        primitive.IndexBuffer.Stride = sizeof(uint32_t);
+    }
+    primitive.IndexBuffer.BufferIndex = 1;
+    primitive.IndexBuffer.IndexCount = static_cast<uint32_t>(Indices.size());
+    primitive.IndexBuffer.Offset = 0;
+
+    outResource->Primitives.clear();
+    outResource->Bins.clear();
+
+    outResource->Bins.emplace_back(std::span<const byte>{vertexData.data(), vertexData.size()});
+    outResource->Bins.emplace_back(std::span<const byte>{indexData.data(), indexData.size()});
+    outResource->Primitives.emplace_back(std::move(primitive));
+}
+
 void TriangleMesh::InitAsCube(float halfExtend) noexcept {
     Positions = vector<Eigen::Vector3f>{
         {-1.0f, -1.0f, -1.0f},
@@ -1,9 +1,27 @@
 #include <radray/vertex_data.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <memory>
 
+#include <radray/pixel_convert.h>
+
 namespace radray {
+namespace {
+
+template <class T>
+T LoadComponent(const byte* src, size_t index) noexcept {
+    T value;
+    std::memcpy(&value, src + index * sizeof(T), sizeof(T));
+    return value;
+}
+
+float SignNotZero(float value) noexcept {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+}  // namespace
 
 MeshBuffer::MeshBuffer(std::span<const byte> data) {
     Assign(data);
@@ -36,4 +54,57 @@ void MeshBuffer::Assign(std::span<const byte> data) {
     _data = std::move(buffer);
 }
 
+Eigen::Vector4f DecodeVertexData(VertexDataType type, uint16_t componentCount, const byte* src) noexcept {
+    Eigen::Vector4f result = Eigen::Vector4f::Zero();
+    if (GetVertexDataSizeInBytes(type, componentCount) == 0) {
+        return result;
+    }
+    if (type == VertexDataType::UNORM10_10_10_2) {
+        const uint32_t packed = LoadComponent<uint32_t>(src, 0);
+        return Eigen::Vector4f{
+            static_cast<float>(packed & 0x3ffu) / 1023.0f,
+            static_cast<float>((packed >> 10) & 0x3ffu) / 1023.0f,
+            static_cast<float>((packed >> 20) & 0x3ffu) / 1023.0f,
+            static_cast<float>(packed >> 30) / 3.0f};
+    }
+    const size_t count = std::min<size_t>(componentCount, 4);
+    for (size_t i = 0; i < count; i++) {
+        switch (type) {
+            case VertexDataType::FLOAT: result[i] = LoadComponent<float>(src, i); break;
+            case VertexDataType::UINT: result[i] = static_cast<float>(LoadComponent<uint32_t>(src, i)); break;
+            case VertexDataType::SINT: result[i] = static_cast<float>(LoadComponent<int32_t>(src, i)); break;
+            case VertexDataType::HALF: result[i] = HalfToFloat(LoadComponent<uint16_t>(src, i)); break;
+            case VertexDataType::SNORM8: result[i] = std::max(static_cast<float>(LoadComponent<int8_t>(src, i)) / 127.0f, -1.0f); break;
+            case VertexDataType::UNORM8: result[i] = static_cast<float>(LoadComponent<uint8_t>(src, i)) / 255.0f; break;
+            case VertexDataType::SNORM16: result[i] = std::max(static_cast<float>(LoadComponent<int16_t>(src, i)) / 32767.0f, -1.0f); break;
+            case VertexDataType::UNORM16: result[i] = static_cast<float>(LoadComponent<uint16_t>(src, i)) / 65535.0f; break;
+            case VertexDataType::UNORM10_10_10_2: break;
+        }
+    }
+    return result;
+}
+
+Eigen::Vector2f OctahedralEncode(const Eigen::Vector3f& direction) noexcept {
+    const float l1 = direction.cwiseAbs().sum();
+    if (!(l1 > 0.0f)) {
+        return Eigen::Vector2f::Zero();
+    }
+    const Eigen::Vector3f n = direction / l1;
+    if (n.z() >= 0.0f) {
+        return Eigen::Vector2f{n.x(), n.y()};
+    }
+    return Eigen::Vector2f{
+        (1.0f - std::abs(n.y())) * SignNotZero(n.x()),
+        (1.0f - std::abs(n.x())) * SignNotZero(n.y())};
+}
+
+Eigen::Vector3f OctahedralDecode(const Eigen::Vector2f& encoded) noexcept {
+    // Rune Stubbe 的无分支写法: 下半球的点沿对角折回, 各轴按符号平移 t。
+    Eigen::Vector3f n{encoded.x(), encoded.y(), 1.0f - std::abs(encoded.x()) - std::abs(encoded.y())};
+    const float t = std::clamp(-n.z(), 0.0f, 1.0f);
+    n.x() += n.x() >= 0.0f ? -t : t;
+    n.y() += n.y() >= 0.0f ? -t : t;
+    return n.normalized();
+}
+
 }  // namespace radray
@@ -1,12 +1,14 @@
 #include <radray/wavefront_obj.h>
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <array>
 #include <cctype>
 #include <charconv>
+#include <iterator>
 
 #include <radray/logger.h>
 #include <radray/hash.h>
+#include <radray/profiler.h>
 #include <radray/triangle_mesh.h>
 
 namespace radray {
@@ -226,52 +228,46 @@ static Eigen::Vector<float, ResultCount> SelectData(const std::array<float, SrcC
     return result;
 }
 
-WavefrontObjReader::WavefrontObjReader(std::istream* stream)
-    : _stream(stream) {}
+namespace {
 
-WavefrontObjReader::WavefrontObjReader(const std::filesystem::path& file) {
-    _myStream = make_unique<std::ifstream>(file, std::ios::in);
-    _stream = _myStream.get();
-    if (!_stream->good()) {
-        RADRAY_ERR_LOG("cannot open obj file: {}", file.string());
-    }
-}
+/// 面里解析时换算过的负索引。Mask 的第 0-2 位对应 V1-V3, 3-5 位 Vt1-Vt3, 6-8 位 Vn1-Vn3。
+struct ObjRelativeFace {
+    size_t Face;
+    uint32_t Line;
+    uint16_t Mask;
+};
 
-WavefrontObjReader::WavefrontObjReader(string&& text) {
-    _myStream = make_unique<std::basic_istringstream<char, std::char_traits<char>, allocator<char>>>(std::move(text), std::ios::in, allocator<char>{});
-    _stream = _myStream.get();
-}
+struct ObjChunkError {
+    uint32_t Line;
+    string Message;
+};
 
-WavefrontObjReader::WavefrontObjReader(const string& text) {
-    _myStream = make_unique<std::basic_istringstream<char, std::char_traits<char>, allocator<char>>>(text, std::ios::in, allocator<char>{});
-    _stream = _myStream.get();
-}
+/// 一块文本的解析结果。面下标、行号都是块内的; 负索引换算成相对本块起点的 1 基索引 (可能 <= 0,
+/// 即指向前面的块), 合并时按前缀和平移。
+struct ObjChunk {
+    vector<Eigen::Vector3f> Positions;
+    vector<Eigen::Vector2f> UVs;
+    vector<Eigen::Vector3f> Normals;
+    vector<WavefrontObjFace> Faces;
+    vector<ObjRelativeFace> RelativeFaces;
+    vector<string> Mtllibs;
+    /// 本块内新开的对象, Faces 为块内面下标。
+    vector<WavefrontObjObject> Objects;
+    /// 本块第一个 o / g 之前的面数与 usemtl / s, 归属前面的块留下的最后一个对象。
+    size_t LeadingFaceCount{0};
+    std::optional<u8string> LeadingMaterial;
+    std::optional<bool> LeadingSmooth;
+    vector<ObjChunkError> Errors;
+    uint32_t LineCount{0};
+};
 
-bool WavefrontObjReader::HasError() const {
-    return !_error.empty();
-}
+constexpr size_t kMaxObjChunks = 256;
 
-void WavefrontObjReader::Read() {
-    if (!_stream || !_stream->good()) {
-        _error = "cannot read data";
-        return;
-    }
-    uint32_t allLine = 0;
-    string buffer;
-    buffer.reserve(512);
-    while (std::getline(*_stream, buffer)) {
-        allLine++;
-        if (buffer.empty()) {
-            continue;
-        }
-        Parse(buffer, allLine);
-    }
-    if (_error.size() > 0 && *_error.rbegin() == '\n') {
-        _error.erase(_error.begin() + _error.size() - 1);
-    }
+std::array<int32_t*, 9> GetFaceIndices(WavefrontObjFace& face) noexcept {
+    return {&face.V1, &face.V2, &face.V3, &face.Vt1, &face.Vt2, &face.Vt3, &face.Vn1, &face.Vn2, &face.Vn3};
 }
 
-void WavefrontObjReader::Parse(std::string_view line, int lineNum) {
+void ParseObjLine(std::string_view line, uint32_t lineNum, ObjChunk& chunk) {
     if (IsStringWhiteSpace(line)) {
         return;
     }
@@ -286,72 +282,295 @@ void WavefrontObjReader::Parse(std::string_view line, int lineNum) {
         std::array<float, 4> result;
         auto fullOpt = ParseNumberArray(data, result);
         if (!fullOpt.has_value()) {
-            _error += fmt::format("at line {}: can't parse vertex {}\n", lineNum, data);
-            _pos.emplace_back(Eigen::Vector3f::Zero());
+            chunk.Errors.emplace_back(ObjChunkError{lineNum, fmt::format("can't parse vertex {}", data)});
+            chunk.Positions.emplace_back(Eigen::Vector3f::Zero());
         } else {
-            _pos.emplace_back(SelectData<3>(result, fullOpt.value()));
+            chunk.Positions.emplace_back(SelectData<3>(result, fullOpt.value()));
         }
     } else if (cmd == "vt") {
         std::array<float, 3> result;
         auto fullOpt = ParseNumberArray(data, result);
         if (!fullOpt.has_value()) {
-            _error += fmt::format("at line {}: can't parse uv {}\n", lineNum, data);
-            _uv.emplace_back(Eigen::Vector2f::Zero());
+            chunk.Errors.emplace_back(ObjChunkError{lineNum, fmt::format("can't parse uv {}", data)});
+            chunk.UVs.emplace_back(Eigen::Vector2f::Zero());
         } else {
-            _uv.emplace_back(SelectData<2>(result, fullOpt.value()));
+            chunk.UVs.emplace_back(SelectData<2>(result, fullOpt.value()));
         }
     } else if (cmd == "vn") {
         std::array<float, 3> result;
         auto fullOpt = ParseNumberArray(data, result);
         if (!fullOpt.has_value()) {
-            _error += fmt::format("at line {}: can't parse normal {}\n", lineNum, data);
-            _normal.emplace_back(Eigen::Vector3f::Zero());
+            chunk.Errors.emplace_back(ObjChunkError{lineNum, fmt::format("can't parse normal {}", data)});
+            chunk.Normals.emplace_back(Eigen::Vector3f::Zero());
         } else {
-            _normal.emplace_back(SelectData<3>(result, fullOpt.value()));
+            chunk.Normals.emplace_back(SelectData<3>(result, fullOpt.value()));
         }
     } else if (cmd == "f") {
-        WavefrontObjFace face;
-        bool isSuccess = ParseFace(data, face);
-        if (!isSuccess) {
-            _error += fmt::format("at line {}: can't parse face {}\n", lineNum, data);
+        WavefrontObjFace face{};
+        if (!ParseFace(data, face)) {
+            chunk.Errors.emplace_back(ObjChunkError{lineNum, fmt::format("can't parse face {}", data)});
+        } else {
+            const size_t counts[]{chunk.Positions.size(), chunk.UVs.size(), chunk.Normals.size()};
+            const auto indices = GetFaceIndices(face);
+            uint16_t mask = 0;
+            for (size_t i = 0; i < indices.size(); i++) {
+                if (*indices[i] < 0) {
+                    *indices[i] = static_cast<int32_t>(counts[i / 3]) + *indices[i] + 1;
+                    mask |= static_cast<uint16_t>(1u << i);
+                }
+            }
+            if (mask != 0) {
+                chunk.RelativeFaces.emplace_back(ObjRelativeFace{chunk.Faces.size(), lineNum, mask});
+            }
         }
-        size_t index = _faces.size();
-        _faces.emplace_back(face);
-        if (_objects.size() > 0) {
-            _objects.rbegin()->Faces.push_back(index);
+        size_t index = chunk.Faces.size();
+        chunk.Faces.emplace_back(face);
+        if (chunk.Objects.size() > 0) {
+            chunk.Objects.rbegin()->Faces.push_back(index);
         }
     } else if (cmd == "o" || cmd == "g") {
+        if (chunk.Objects.empty()) {
+            chunk.LeadingFaceCount = chunk.Faces.size();
+        }
         std::string_view nameView = TrimEnd(data);
         u8string name((char8_t*)nameView.data(), nameView.size());
-        auto& obj = _objects.emplace_back(WavefrontObjObject{});
+        auto& obj = chunk.Objects.emplace_back(WavefrontObjObject{});
         obj.Name = std::move(name);
     } else if (cmd == "mtllib") {
         std::string_view v = TrimEnd(data);
-        _mtllibs.emplace_back(string{v});
+        chunk.Mtllibs.emplace_back(string{v});
     } else if (cmd == "usemtl") {
-        if (_objects.size() > 0) {
-            std::string_view v = TrimEnd(data);
-            _objects.rbegin()->Material = u8string{(char8_t*)v.data(), v.size()};
+        std::string_view v = TrimEnd(data);
+        u8string material{(char8_t*)v.data(), v.size()};
+        if (chunk.Objects.size() > 0) {
+            chunk.Objects.rbegin()->Material = std::move(material);
+        } else {
+            chunk.LeadingMaterial = std::move(material);
         }
     } else if (cmd == "s") {
-        if (_objects.size() > 0) {
-            std::string_view v = TrimEnd(data);
-            if (v == "off") {
-                _objects.rbegin()->IsSmooth = false;
-            } else if (v == "on") {
-                _objects.rbegin()->IsSmooth = true;
-            } else if (v == "1") {
-                _objects.rbegin()->IsSmooth = true;
-            } else if (v == "0") {
-                _objects.rbegin()->IsSmooth = false;
+        std::string_view v = TrimEnd(data);
+        std::optional<bool> smooth;
+        if (v == "off" || v == "0") {
+            smooth = false;
+        } else if (v == "on" || v == "1") {
+            smooth = true;
+        } else {
+            chunk.Errors.emplace_back(ObjChunkError{lineNum, fmt::format("unknown smooth value {}", v)});
+        }
+        if (smooth.has_value()) {
+            if (chunk.Objects.size() > 0) {
+                chunk.Objects.rbegin()->IsSmooth = smooth.value();
             } else {
-                _error += fmt::format("at line {}: unknown smooth value {}\n", lineNum, v);
+                chunk.LeadingSmooth = smooth;
             }
         }
-    } else if (cmd == "#") {
+    } else if (cmd.starts_with('#')) {
         // no op
     } else {
-        _error += fmt::format("at line {}: unknown command {}\n", lineNum, cmd);
+        chunk.Errors.emplace_back(ObjChunkError{lineNum, fmt::format("unknown command {}", cmd)});
+    }
+}
+
+void ParseObjChunk(std::string_view text, ObjChunk& chunk) {
+    uint32_t lineNum = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        lineNum++;
+        if (end > pos) {
+            ParseObjLine(text.substr(pos, end - pos), lineNum, chunk);
+        }
+        pos = end + 1;
+    }
+    chunk.LineCount = lineNum;
+    if (chunk.Objects.empty()) {
+        chunk.LeadingFaceCount = chunk.Faces.size();
+    }
+}
+
+/// 按字节均分后把每个边界推到下一个换行之后。
+vector<std::string_view> SplitObjChunks(std::string_view text, const WavefrontObjReadOptions& options) {
+    size_t chunkCount = 1;
+    if (options.ParallelFor) {
+        chunkCount = std::clamp<size_t>(text.size() / std::max<size_t>(options.MinChunkBytes, 1), 1, kMaxObjChunks);
+    }
+    vector<std::string_view> chunks;
+    chunks.reserve(chunkCount);
+    size_t begin = 0;
+    for (size_t i = 1; i <= chunkCount && begin < text.size(); i++) {
+        size_t end = text.size();
+        if (i < chunkCount) {
+            const size_t newline = text.find('\n', std::max(begin, text.size() / chunkCount * i));
+            end = newline == std::string_view::npos ? text.size() : newline + 1;
+        }
+        chunks.emplace_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+template <class T>
+void MoveChunkElements(vector<T>& src, vector<T>& dst, size_t offset) noexcept {
+    std::copy(src.begin(), src.end(), dst.begin() + offset);
+    vector<T>{}.swap(src);
+}
+
+}  // namespace
+
+WavefrontObjReader::WavefrontObjReader(std::istream* stream)
+    : _stream(stream),
+      _hasSource(stream != nullptr) {}
+
+WavefrontObjReader::WavefrontObjReader(const std::filesystem::path& file) {
+    _mapping = MappedFile::Open(file);
+    if (!_mapping.has_value()) {
+        RADRAY_ERR_LOG("cannot open obj file: {}", file.string());
+        return;
+    }
+    _view = _mapping->GetData();
+    _hasSource = true;
+}
+
+WavefrontObjReader::WavefrontObjReader(string&& text)
+    : _text(std::move(text)),
+      _hasSource(true),
+      _ownsText(true) {}
+
+WavefrontObjReader::WavefrontObjReader(const string& text)
+    : _text(text),
+      _hasSource(true),
+      _ownsText(true) {}
+
+WavefrontObjReader::WavefrontObjReader(std::span<const byte> text)
+    : _view(text),
+      _hasSource(true) {}
+
+bool WavefrontObjReader::HasError() const {
+    return !_error.empty();
+}
+
+void WavefrontObjReader::Read(const WavefrontObjReadOptions& options) {
+    RADRAY_PROFILE_SCOPE("WavefrontObjReader::Read");
+    if (!_hasSource || (_stream != nullptr && !_stream->good())) {
+        _error = "cannot read data";
+        return;
+    }
+    if (_stream != nullptr) {
+        _text.assign(std::istreambuf_iterator<char>{*_stream}, std::istreambuf_iterator<char>{});
+        _ownsText = true;
+        _stream = nullptr;
+    }
+    if (_ownsText) {
+        _view = std::as_bytes(std::span{_text});
+    }
+    const std::string_view text{reinterpret_cast<const char*>(_view.data()), _view.size()};
+    const vector<std::string_view> parts = SplitObjChunks(text, options);
+    vector<ObjChunk> chunks(parts.size());
+    const auto forEachChunk = [&options, &chunks](const std::function<void(uint32_t)>& body) {
+        if (options.ParallelFor && chunks.size() > 1) {
+            options.ParallelFor(static_cast<uint32_t>(chunks.size()), body);
+        } else {
+            for (uint32_t i = 0; i < chunks.size(); i++) {
+                body(i);
+            }
+        }
+    };
+    forEachChunk([&parts, &chunks](uint32_t i) {
+        RADRAY_PROFILE_SCOPE("WavefrontObjReader::ParseChunk");
+        ParseObjChunk(parts[i], chunks[i]);
+    });
+
+    // 各块在最终数组里的起点。
+    struct ChunkBase {
+        size_t Position, UV, Normal, Face;
+        uint32_t Line;
+    };
+    vector<ChunkBase> bases(chunks.size());
+    ChunkBase total{0, 0, 0, 0, 0};
+    for (size_t i = 0; i < chunks.size(); i++) {
+        bases[i] = total;
+        total.Position += chunks[i].Positions.size();
+        total.UV += chunks[i].UVs.size();
+        total.Normal += chunks[i].Normals.size();
+        total.Face += chunks[i].Faces.size();
+        total.Line += chunks[i].LineCount;
+    }
+    const bool singleChunk = chunks.size() == 1;
+    if (!singleChunk) {
+        _pos.resize(total.Position);
+        _uv.resize(total.UV);
+        _normal.resize(total.Normal);
+        _faces.resize(total.Face);
+    }
+    forEachChunk([this, &chunks, &bases, singleChunk](uint32_t i) {
+        ObjChunk& chunk = chunks[i];
+        const ChunkBase& base = bases[i];
+        const int32_t offsets[]{
+            static_cast<int32_t>(base.Position),
+            static_cast<int32_t>(base.UV),
+            static_cast<int32_t>(base.Normal)};
+        for (const ObjRelativeFace& relative : chunk.RelativeFaces) {
+            const auto indices = GetFaceIndices(chunk.Faces[relative.Face]);
+            for (size_t j = 0; j < indices.size(); j++) {
+                if ((relative.Mask & (1u << j)) == 0) {
+                    continue;
+                }
+                *indices[j] += offsets[j / 3];
+                if (*indices[j] <= 0) {
+                    chunk.Errors.emplace_back(ObjChunkError{relative.Line, "relative face index out of range"});
+                }
+            }
+        }
+        if (singleChunk) {
+            // 只有一块时直接接管数组, 不再复制一遍。
+            _pos = std::move(chunk.Positions);
+            _uv = std::move(chunk.UVs);
+            _normal = std::move(chunk.Normals);
+            _faces = std::move(chunk.Faces);
+            return;
+        }
+        MoveChunkElements(chunk.Positions, _pos, base.Position);
+        MoveChunkElements(chunk.UVs, _uv, base.UV);
+        MoveChunkElements(chunk.Normals, _normal, base.Normal);
+        MoveChunkElements(chunk.Faces, _faces, base.Face);
+    });
+
+    for (size_t i = 0; i < chunks.size(); i++) {
+        ObjChunk& chunk = chunks[i];
+        const ChunkBase& base = bases[i];
+        std::stable_sort(chunk.Errors.begin(), chunk.Errors.end(), [](const ObjChunkError& a, const ObjChunkError& b) {
+            return a.Line < b.Line;
+        });
+        for (const ObjChunkError& error : chunk.Errors) {
+            _error += fmt::format("at line {}: {}\n", base.Line + error.Line, error.Message);
+        }
+        for (string& mtllib : chunk.Mtllibs) {
+            _mtllibs.emplace_back(std::move(mtllib));
+        }
+        if (!_objects.empty()) {
+            WavefrontObjObject& open = *_objects.rbegin();
+            for (size_t f = 0; f < chunk.LeadingFaceCount; f++) {
+                open.Faces.push_back(base.Face + f);
+            }
+            if (chunk.LeadingMaterial.has_value()) {
+                open.Material = std::move(chunk.LeadingMaterial.value());
+            }
+            if (chunk.LeadingSmooth.has_value()) {
+                open.IsSmooth = chunk.LeadingSmooth.value();
+            }
+        }
+        for (WavefrontObjObject& obj : chunk.Objects) {
+            for (size_t& f : obj.Faces) {
+                f += base.Face;
+            }
+            _objects.emplace_back(std::move(obj));
+        }
+    }
+    if (_error.size() > 0 && *_error.rbegin() == '\n') {
+        _error.erase(_error.begin() + _error.size() - 1);
     }
 }
 
@@ -461,4 +680,47 @@ bool WavefrontObjReader::ToTriangleMesh(std::u8string_view objName, TriangleMesh
     return false;
 }
 
+vector<string> ParseWavefrontMtlTextures(std::string_view text) {
+    // 取 1 个参数的选项; 其余选项 (-o -s -t -mm -bm -boost -texres) 取后面连着的数值, 至多 3 个。
+    constexpr std::array<std::string_view, 6> wordOptions{"-blendu", "-blendv", "-cc", "-clamp", "-imfchan", "-type"};
+    const auto isNumber = [](std::string_view token) {
+        float value = 0.0f;
+        auto [end, ec] = std::from_chars(token.data(), token.data() + token.size(), value, std::chars_format::general);
+        return ec == std::errc{} && end == token.data() + token.size();
+    };
+    const auto nextToken = [](std::string_view str) {
+        const size_t end = str.find_first_of(" \t");
+        return end == std::string_view::npos ? str : str.substr(0, end);
+    };
+    vector<string> textures;
+    while (!text.empty()) {
+        const size_t lineEnd = text.find('\n');
+        std::string_view line = TrimEnd(TrimStart(text.substr(0, lineEnd)));
+        text = lineEnd == std::string_view::npos ? std::string_view{} : text.substr(lineEnd + 1);
+        const std::string_view cmd = nextToken(line);
+        if (!cmd.starts_with("map_") && cmd != "bump" && cmd != "disp" && cmd != "decal" && cmd != "refl" && cmd != "norm") {
+            continue;
+        }
+        std::string_view data = TrimStart(line.substr(cmd.size()));
+        while (data.starts_with('-')) {
+            const std::string_view option = nextToken(data);
+            data = TrimStart(data.substr(option.size()));
+            if (std::find(wordOptions.begin(), wordOptions.end(), option) != wordOptions.end()) {
+                data = TrimStart(data.substr(nextToken(data).size()));
+                continue;
+            }
+            for (int arg = 0; arg < 3 && !data.empty() && isNumber(nextToken(data)); ++arg) {
+                data = TrimStart(data.substr(nextToken(data).size()));
+            }
+        }
+        if (data.empty()) {
+            continue;
+        }
+        if (std::find(textures.begin(), textures.end(), data) == textures.end()) {
+            textures.emplace_back(data);
+        }
+    }
+    return textures;
+}
+
 }  // namespace radray
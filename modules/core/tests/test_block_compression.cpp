@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <thread>
+
+#include <radray/block_compression.h>
+
+using namespace radray;
+
+namespace {
+
+/// 斜率固定的平滑渐变叠一点噪声, 与尺寸无关, 是块压缩的典型输入。
+vector<byte> MakeGradient(uint32_t width, uint32_t height, uint32_t seed) {
+    std::mt19937 random{seed};
+    vector<byte> pixels(size_t{width} * height * 4);
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            byte* pixel = pixels.data() + (size_t{y} * width + x) * 4;
+            const int noise = static_cast<int>(random() % 9) - 4;
+            pixel[0] = static_cast<byte>(std::clamp(static_cast<int>(x * 3) + noise, 0, 255));
+            pixel[1] = static_cast<byte>(std::clamp(static_cast<int>(y * 2) + noise, 0, 255));
+            pixel[2] = static_cast<byte>(std::clamp(static_cast<int>(x + y) + 64, 0, 255));
+            pixel[3] = static_cast<byte>(std::max(255 - static_cast<int>(y * 3), 0));
+        }
+    }
+    return pixels;
+}
+
+/// 按格式实际保存的通道算 PSNR: BC1 只看 RGB, BC4 只看 R, BC5 只看 RG。
+double ComputePsnr(std::span<const byte> expected, std::span<const byte> actual, BlockFormat format) {
+    const size_t channelCount = format == BlockFormat::BC4 ? 1 : format == BlockFormat::BC5 ? 2 : format == BlockFormat::BC1 ? 3 : 4;
+    double squaredError = 0.0;
+    size_t samples = 0;
+    for (size_t i = 0; i < expected.size(); i += 4) {
+        for (size_t channel = 0; channel < channelCount; ++channel) {
+            const double diff = std::to_integer<int>(expected[i + channel]) - std::to_integer<int>(actual[i + channel]);
+            squaredError += diff * diff;
+            ++samples;
+        }
+    }
+    if (squaredError == 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return 10.0 * std::log10(255.0 * 255.0 / (squaredError / static_cast<double>(samples)));
+}
+
+vector<byte> RoundTrip(std::span<const byte> pixels, uint32_t width, uint32_t height, BlockFormat format) {
+    vector<byte> blocks(GetBlockCompressedSize(format, width, height));
+    EXPECT_TRUE(CompressRgba8Blocks(pixels, width, height, format, blocks));
+    vector<byte> decoded(pixels.size());
+    EXPECT_TRUE(DecompressBlocksToRgba8(blocks, width, height, format, decoded));
+    return decoded;
+}
+
+MipParallelFor ThreadParallelFor() {
+    return [](uint32_t count, const std::function<void(uint32_t)>& body) {
+        vector<std::thread> threads;
+        for (uint32_t i = 0; i < count; ++i) {
+            threads.emplace_back([&body, i]() { body(i); });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    };
+}
+
+constexpr std::array<BlockFormat, 5> kAllFormats{BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC4, BlockFormat::BC5, BlockFormat::BC7};
+
+}  // namespace
+
+TEST(BlockCompressionTest, SizesRoundUpToWholeBlocks) {
+    EXPECT_EQ(GetBlockCompressedSize(BlockFormat::BC1, 4, 4), 8u);
+    EXPECT_EQ(GetBlockCompressedSize(BlockFormat::BC7, 4, 4), 16u);
+    EXPECT_EQ(GetBlockCompressedSize(BlockFormat::BC4, 5, 1), 16u);
+    EXPECT_EQ(GetBlockCompressedSize(BlockFormat::BC5, 1, 1), 16u);
+
+    const vector<byte> pixels = MakeGradient(16, 8, 1);
+    const Rgba8MipChain mips = BuildRgba8MipChain(pixels, 16, 8, MipChainOptions{});
+    const BlockCompressedMipChain chain = BlockCompressedMipChain::Compress(mips, BlockFormat::BC1);
+    ASSERT_EQ(chain.GetLevelCount(), 5u);
+    // 16x8, 8x4, 4x2, 2x1, 1x1 -> 8 + 2 + 1 + 1 + 1 块。
+    EXPECT_EQ(chain.GetBytes().size(), 13u * 8u);
+    EXPECT_EQ(chain.GetLevel(1).data(), chain.GetBytes().data() + 64);
+    EXPECT_EQ(chain.GetLevel(4).size(), 8u);
+    EXPECT_TRUE(chain.GetLevel(5).empty());
+
+    vector<byte> tooSmall(7);
+    EXPECT_FALSE(CompressRgba8Blocks(pixels, 16, 8, BlockFormat::BC1, tooSmall));
+}
+
+TEST(BlockCompressionTest, FlatColorsRoundTripExactly) {
+    // 各通道都能被 565 精确表示, 且同为奇数 —— mode 6 的一个端点只有一个共享 p-bit。
+    const uint32_t width = 8;
+    const uint32_t height = 8;
+    vector<byte> pixels(size_t{width} * height * 4);
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        pixels[i + 0] = byte{255};
+        pixels[i + 1] = byte{65};
+        pixels[i + 2] = byte{107};
+        pixels[i + 3] = byte{201};
+    }
+    for (const BlockFormat format : kAllFormats) {
+        const vector<byte> decoded = RoundTrip(pixels, width, height, format);
+        EXPECT_TRUE(std::isinf(ComputePsnr(pixels, decoded, format))) << static_cast<int>(format);
+    }
+}
+
+TEST(BlockCompressionTest, GradientsMeetPsnrThresholds) {
+    // 23x13 覆盖不满 4x4 的边缘块。
+    for (const auto& [width, height] : std::array<std::pair<uint32_t, uint32_t>, 2>{{{64, 64}, {23, 13}}}) {
+        const vector<byte> pixels = MakeGradient(width, height, width + height);
+        const std::array<std::pair<BlockFormat, double>, 5> thresholds{{
+            {BlockFormat::BC1, 39.0},
+            {BlockFormat::BC3, 40.0},
+            {BlockFormat::BC4, 50.0},
+            {BlockFormat::BC5, 50.0},
+            {BlockFormat::BC7, 40.5},
+        }};
+        for (const auto& [format, minimum] : thresholds) {
+            const vector<byte> decoded = RoundTrip(pixels, width, height, format);
+            EXPECT_GE(ComputePsnr(pixels, decoded, format), minimum) << width << "x" << height << " format " << static_cast<int>(format);
+        }
+    }
+}
+
+TEST(BlockCompressionTest, ParallelBandsProduceIdenticalBytes) {
+    const uint32_t width = 512;
+    const uint32_t height = 512;
+    const vector<byte> pixels = MakeGradient(width, height, 3);
+    for (const BlockFormat format : kAllFormats) {
+        vector<byte> serial(GetBlockCompressedSize(format, width, height));
+        vector<byte> parallel(serial.size());
+        ASSERT_TRUE(CompressRgba8Blocks(pixels, width, height, format, serial));
+        ASSERT_TRUE(CompressRgba8Blocks(pixels, width, height, format, parallel, ThreadParallelFor()));
+        EXPECT_EQ(serial, parallel) << static_cast<int>(format);
+    }
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <radray/coroutine.h>
+
+using namespace radray;
+
+namespace {
+
+struct TestRecord : ManualCoroutineRecord {
+    static inline int Alive = 0;
+
+    TestRecord() noexcept { ++Alive; }
+    explicit TestRecord(int value) noexcept : Value(value) { ++Alive; }
+    ~TestRecord() noexcept { --Alive; }
+
+    int Value{0};
+};
+
+}  // namespace
+
+TEST(ManualCoroutineSchedulerTest, ReusesErasedEntries) {
+    ManualCoroutineScheduler<TestRecord> scheduler;
+    TestRecord* first = scheduler.Enqueue(stop_token{}, {}, 7);
+    EXPECT_EQ(first->Value, 7);
+    EXPECT_TRUE(scheduler.Erase(first));
+    EXPECT_EQ(scheduler.FreeEntryCount(), 1u);
+    EXPECT_EQ(TestRecord::Alive, 0);
+
+    TestRecord* second = scheduler.Enqueue(stop_token{}, {});
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(second->Value, 0);
+    EXPECT_EQ(scheduler.FreeEntryCount(), 0u);
+    EXPECT_EQ(TestRecord::Alive, 1);
+}
+
+TEST(ManualCoroutineSchedulerTest, TicketDistinguishesReusedEntry) {
+    ManualCoroutineScheduler<TestRecord> scheduler;
+    TestRecord* first = scheduler.Enqueue(stop_token{}, {});
+    const uint64_t firstTicket = first->Ticket;
+    EXPECT_TRUE(scheduler.IsAlive(first, firstTicket));
+    scheduler.Erase(first);
+
+    TestRecord* second = scheduler.Enqueue(stop_token{}, {});
+    ASSERT_EQ(second, first);
+    EXPECT_FALSE(scheduler.IsAlive(first, firstTicket));
+    EXPECT_TRUE(scheduler.IsAlive(second, second->Ticket));
+}
+
+TEST(ManualCoroutineSchedulerTest, StopCallbackDoesNotOutliveErase) {
+    ManualCoroutineScheduler<TestRecord> scheduler;
+    stop_source first;
+    TestRecord* record = scheduler.Enqueue(first.get_token(), {});
+    scheduler.Erase(record);
+
+    TestRecord* reused = scheduler.Enqueue(stop_token{}, {});
+    ASSERT_EQ(reused, record);
+    first.request_stop();
+    EXPECT_FALSE(reused->Canceled);
+
+    stop_source second;
+    TestRecord* canceled = scheduler.Enqueue(second.get_token(), {});
+    second.request_stop();
+    EXPECT_TRUE(canceled->Canceled);
+}
+
+TEST(ManualCoroutineSchedulerTest, FreeListIsBounded) {
+    ManualCoroutineScheduler<TestRecord> scheduler;
+    vector<TestRecord*> records;
+    for (int i = 0; i < 3000; ++i) {
+        records.push_back(scheduler.Enqueue(stop_token{}, {}, i));
+    }
+    for (TestRecord* record : records) {
+        scheduler.Erase(record);
+    }
+    EXPECT_TRUE(scheduler.Empty());
+    EXPECT_EQ(scheduler.FreeEntryCount(), 1024u);
+    EXPECT_EQ(TestRecord::Alive, 0);
+}
+
+/// 超出空闲链表上限的 Entry 已经释放, IsAlive 仍只凭 ticket 判断, 不碰那块内存;
+/// 槽位复用后代数不同, 旧 ticket 不会认成新等待。
+TEST(ManualCoroutineSchedulerTest, TicketsOfReleasedEntriesStayDead) {
+    ManualCoroutineScheduler<TestRecord> scheduler;
+    vector<std::pair<TestRecord*, uint64_t>> erased;
+    for (int i = 0; i < 2000; ++i) {
+        TestRecord* record = scheduler.Enqueue(stop_token{}, {}, i);
+        erased.emplace_back(record, record->Ticket);
+    }
+    for (auto [record, ticket] : erased) {
+        EXPECT_TRUE(scheduler.Erase(record));
+    }
+    for (int i = 0; i < 2000; ++i) {
+        scheduler.Enqueue(stop_token{}, {}, i);
+    }
+    for (auto [record, ticket] : erased) {
+        EXPECT_FALSE(scheduler.IsAlive(record, ticket));
+    }
+    EXPECT_EQ(scheduler.Count(), 2000u);
+}
+
+TEST(ManualCoroutineSchedulerTest, EraseKeepsTheRemainingOrder) {
+    ManualCoroutineScheduler<TestRecord> scheduler;
+    vector<TestRecord*> records;
+    for (int i = 0; i < 5; ++i) {
+        records.push_back(scheduler.Enqueue(stop_token{}, {}, i));
+    }
+    const uint64_t erasedTicket = records[2]->Ticket;
+    scheduler.Erase(records[0]);
+    scheduler.Erase(records[2]);
+    scheduler.Erase(records[4]);
+    EXPECT_FALSE(scheduler.IsAlive(records[2], erasedTicket));
+    EXPECT_EQ(scheduler.Count(), 2u);
+
+    vector<int> order;
+    for (TestRecord* record = scheduler.Front(); record != nullptr; record = scheduler.Next(record)) {
+        order.push_back(record->Value);
+    }
+    EXPECT_EQ(order, (vector<int>{1, 3}));
+    EXPECT_EQ(scheduler.Back(), records[3]);
+
+    TestRecord* appended = scheduler.Enqueue(stop_token{}, {}, 5);
+    EXPECT_EQ(scheduler.Next(records[3]), appended);
+    EXPECT_EQ(scheduler.Next(appended), nullptr);
+}
@@ -0,0 +1,188 @@
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <radray/coroutine.h>
+
+using namespace radray;
+
+namespace {
+
+struct FrameProbe {
+    static inline int Alive = 0;
+
+    FrameProbe() noexcept { ++Alive; }
+    ~FrameProbe() noexcept { --Alive; }
+};
+
+task<int> Constant(int value) {
+    co_return value;
+}
+
+task<int> Sum(int depth) {
+    if (depth == 0) {
+        co_return 0;
+    }
+    const int rest = co_await Sum(depth - 1);
+    co_return rest + co_await Constant(depth);
+}
+
+task<int> Throwing() {
+    throw std::runtime_error{"load failed"};
+    co_return 0;
+}
+
+task<bool> ObservesStop() {
+    const stop_token stop = co_await CurrentStopToken();
+    co_return stop.stop_requested();
+}
+
+task<int> StopsMidway(bool* reachedEnd) {
+    FrameProbe probe;
+    co_await StopCurrentTask();
+    *reachedEnd = true;
+    co_return 1;
+}
+
+/// 把恢复交给另一个线程的 awaitable, 用来钉住 "在恢复方的线程上继续" 这条约定。
+class ResumeOnThread {
+public:
+    explicit ResumeOnThread(std::thread* worker) noexcept : _worker(worker) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    /// 线程一启动, 协程帧 (连同这个 awaiter) 就可能在那边跑完并释放, 所以先把指针取出来。
+    void await_suspend(std::coroutine_handle<> continuation) {
+        std::thread* worker = _worker;
+        *worker = std::thread{[continuation]() { continuation.resume(); }};
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    std::thread* _worker;
+};
+
+task<std::thread::id> ContinueOn(std::thread* worker) {
+    co_await ResumeOnThread{worker};
+    co_return std::this_thread::get_id();
+}
+
+}  // namespace
+
+TEST(CoroutineTaskTest, ReturnsValuesThroughNestedTasks) {
+    int result = 0;
+    {
+        TaskScope scope;
+        scope.Spawn([](int* out) -> task<void> {
+            *out = co_await Sum(100);
+        }(&result));
+        scope.WaitUntilEmpty();
+    }
+    EXPECT_EQ(result, 5050);
+}
+
+TEST(CoroutineTaskTest, RethrowsInTheAwaitingTask) {
+    bool caught = false;
+    {
+        TaskScope scope;
+        scope.Spawn([](bool* out) -> task<void> {
+            try {
+                (void)co_await Throwing();
+            } catch (const std::runtime_error&) {
+                *out = true;
+            }
+        }(&caught));
+        scope.WaitUntilEmpty();
+    }
+    EXPECT_TRUE(caught);
+}
+
+TEST(CoroutineTaskTest, NestedTaskInheritsStopToken) {
+    std::optional<bool> observed;
+    {
+        TaskScope scope;
+        stop_source stop;
+        stop.request_stop();
+        scope.Spawn([](stop_token token, std::optional<bool>* out) -> task<void> {
+            *out = co_await WithStopToken(ObservesStop(), token);
+        }(stop.get_token(), &observed));
+        scope.WaitUntilEmpty();
+    }
+    ASSERT_TRUE(observed.has_value());
+    EXPECT_TRUE(*observed);
+}
+
+TEST(CoroutineTaskTest, StoppedTaskDestroysItsFrame) {
+    bool reachedEnd = false;
+    bool resumed = false;
+    std::optional<int> result{0};
+    {
+        TaskScope scope;
+        stop_source stop;
+        scope.Spawn([](stop_token token, bool* reached, bool* resumedOut, std::optional<int>* out) -> task<void> {
+            *out = co_await WithStopToken(StopsMidway(reached), token);
+            *resumedOut = true;
+        }(stop.get_token(), &reachedEnd, &resumed, &result));
+        scope.WaitUntilEmpty();
+    }
+    EXPECT_TRUE(resumed);
+    EXPECT_FALSE(result.has_value());
+    EXPECT_FALSE(reachedEnd);
+    EXPECT_EQ(FrameProbe::Alive, 0);
+}
+
+TEST(CoroutineTaskTest, ContinuesOnTheResumingThread) {
+    std::thread worker;
+    std::thread::id inner;
+    std::thread::id outer;
+    {
+        TaskScope scope;
+        scope.Spawn([](std::thread* w, std::thread::id* innerOut, std::thread::id* outerOut) -> task<void> {
+            *innerOut = co_await ContinueOn(w);
+            *outerOut = std::this_thread::get_id();
+        }(&worker, &inner, &outer));
+        worker.join();
+        scope.WaitUntilEmpty();
+    }
+    EXPECT_NE(inner, std::this_thread::get_id());
+    EXPECT_EQ(inner, outer);
+}
+
+TEST(CoroutineTaskTest, FramesAreReusedOnTheSameThread) {
+    void* first = AllocateCoroutineFrame(100);
+    FreeCoroutineFrame(first, 100);
+    const size_t cached = GetCachedCoroutineFrameCount();
+    EXPECT_GE(cached, 1u);
+
+    // 100 与 120 落在同一个 64 字节级里。
+    void* second = AllocateCoroutineFrame(120);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(GetCachedCoroutineFrameCount(), cached - 1);
+    FreeCoroutineFrame(second, 120);
+}
+
+TEST(CoroutineTaskTest, LargeFramesBypassThePool) {
+    const size_t cached = GetCachedCoroutineFrameCount();
+    void* frame = AllocateCoroutineFrame(kMaxPooledCoroutineFrameSize + 1);
+    FreeCoroutineFrame(frame, kMaxPooledCoroutineFrameSize + 1);
+    EXPECT_EQ(GetCachedCoroutineFrameCount(), cached);
+}
+
+TEST(CoroutineTaskTest, SteadyStateTasksDoNotGrowThePool) {
+    auto run = [] {
+        int result = 0;
+        TaskScope scope;
+        scope.Spawn([](int* out) -> task<void> {
+            *out = co_await Sum(16);
+        }(&result));
+        scope.WaitUntilEmpty();
+        return result;
+    };
+    EXPECT_EQ(run(), 136);
+    const size_t cached = GetCachedCoroutineFrameCount();
+    EXPECT_GT(cached, 0u);
+    EXPECT_EQ(run(), 136);
+    EXPECT_EQ(GetCachedCoroutineFrameCount(), cached);
+}
@@ -1,3 +1,5 @@
+#include <array>
+#include <cstring>
 #include <fstream>
 #include <filesystem>
 #include <cstdlib>
@@ -128,3 +130,159 @@ TEST(PNG, WriteUnsupportedFormatFails) {
     auto path = MakeTempFilePath("unsupported.png");
     EXPECT_FALSE(img.WritePNG({path.string(), false}));
 }
+
+
+static std::vector<radray::byte> ReadFileBytes(const std::filesystem::path& path) {
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    std::vector<radray::byte> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return bytes;
+}
+
+TEST(PNG, DecodeFromSpanIntoPitchedTarget) {
+    radray::ImageData img;
+    img.Width = 5;
+    img.Height = 3;
+    img.Format = radray::ImageFormat::RGBA8_BYTE;
+    img.Data = std::make_unique<radray::byte[]>(img.GetSize());
+    for (size_t i = 0; i < img.GetSize(); ++i) {
+        img.Data[i] = static_cast<radray::byte>((i * 37 + 11) & 0xFF);
+    }
+    auto path = MakeTempFilePath("decode_span.png");
+    ASSERT_TRUE(img.WritePNG({path.string(), false}));
+    const std::vector<radray::byte> encoded = ReadFileBytes(path);
+    ASSERT_TRUE(radray::ImageData::IsPNG(encoded));
+    EXPECT_FALSE(radray::ImageData::IsJPEG(encoded));
+
+    auto loaded = radray::ImageData::LoadPNG(std::span<const radray::byte>{encoded});
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_EQ(loaded->GetSize(), img.GetSize());
+    EXPECT_EQ(std::memcmp(loaded->Data.get(), img.Data.get(), img.GetSize()), 0);
+
+    auto header = radray::ImageData::ReadPNGHeader(encoded);
+    ASSERT_TRUE(header.has_value());
+    EXPECT_EQ(header->Width, 5u);
+    EXPECT_EQ(header->Height, 3u);
+    EXPECT_EQ(header->Format, radray::ImageFormat::RGBA8_BYTE);
+
+    // 行距 32 (紧密行宽 20), 翻转; 行尾补齐不被写。
+    constexpr size_t kPitch = 32;
+    std::vector<radray::byte> staging(kPitch * 3, radray::byte{0xCD});
+    auto decoded = radray::ImageData::DecodePNG(encoded, {.Data = staging, .RowPitch = kPitch}, {.IsFlipY = true});
+    ASSERT_TRUE(decoded.has_value());
+    for (size_t y = 0; y < 3; ++y) {
+        EXPECT_EQ(std::memcmp(staging.data() + (2 - y) * kPitch, img.Data.get() + y * 20, 20), 0) << y;
+        EXPECT_EQ(staging[y * kPitch + 20], radray::byte{0xCD});
+    }
+
+    // 放不下时失败, 不写入。
+    std::vector<radray::byte> small(kPitch * 2 + 19, radray::byte{0xCD});
+    EXPECT_FALSE(radray::ImageData::DecodePNG(encoded, {.Data = small, .RowPitch = kPitch}).has_value());
+    EXPECT_EQ(small[0], radray::byte{0xCD});
+}
+
+#ifdef RADRAY_ENABLE_JPEG
+
+// 32x16, 4:4:4 采样, 每个 8x8 块一种纯色 (上行: 红 绿 蓝 黄, 下行: 青 品红 灰 近白)。
+static constexpr std::array<uint8_t, 302> kBlockColorsJpeg{
+    0xff, 0xd8, 0xff, 0xdb, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01,
+    0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x04, 0x03, 0x02, 0x02, 0x02, 0x02, 0x05, 0x04, 0x04, 0x03,
+    0x04, 0x06, 0x05, 0x06, 0x06, 0x06, 0x05, 0x06, 0x06, 0x06, 0x07, 0x09, 0x08, 0x06, 0x07, 0x09,
+    0x07, 0x06, 0x06, 0x08, 0x0b, 0x08, 0x09, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x06, 0x08, 0x0b, 0x0c,
+    0x0b, 0x0a, 0x0c, 0x09, 0x0a, 0x0a, 0x0a, 0xff, 0xdb, 0x00, 0x43, 0x01, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x05, 0x03, 0x03, 0x05, 0x0a, 0x07, 0x06, 0x07, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a,
+    0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0xff, 0xc0, 0x00, 0x11,
+    0x08, 0x00, 0x10, 0x00, 0x20, 0x03, 0x01, 0x11, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xff,
+    0xc4, 0x00, 0x16, 0x00, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x08, 0x09, 0x07, 0xff, 0xc4, 0x00, 0x14, 0x10, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xc4, 0x00,
+    0x18, 0x01, 0x00, 0x03, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x07, 0x09, 0x0a, 0x00, 0x08, 0xff, 0xc4, 0x00, 0x14, 0x11, 0x01, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xda, 0x00,
+    0x0c, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3f, 0x00, 0x2f, 0x82, 0x66, 0x80, 0x5c,
+    0x02, 0xe9, 0xb3, 0x4c, 0xf5, 0x0a, 0x3b, 0x61, 0x7c, 0x12, 0xfe, 0x34, 0x30, 0x73, 0xac, 0x28,
+    0xb1, 0x1c, 0x68, 0x52, 0x63, 0x58, 0x71, 0x59, 0x79, 0xae, 0x03, 0x33, 0xff, 0xd9,
+};
+
+static constexpr uint8_t kBlockColors[8][3]{
+    {200, 40, 40}, {40, 200, 40}, {40, 40, 200}, {200, 200, 40},
+    {40, 200, 200}, {200, 40, 200}, {128, 128, 128}, {240, 240, 240}};
+
+static std::span<const radray::byte> BlockColorsJpeg() {
+    return std::as_bytes(std::span{kBlockColorsJpeg});
+}
+
+static void ExpectNear(const radray::byte* pixel, const uint8_t* expected, int tolerance) {
+    for (size_t c = 0; c < 3; ++c) {
+        EXPECT_NEAR(static_cast<int>(pixel[c]), static_cast<int>(expected[c]), tolerance) << c;
+    }
+}
+
+TEST(JPEG, LoadFromSpan) {
+    ASSERT_TRUE(radray::ImageData::IsJPEG(BlockColorsJpeg()));
+    EXPECT_FALSE(radray::ImageData::IsPNG(BlockColorsJpeg()));
+    auto header = radray::ImageData::ReadJPEGHeader(BlockColorsJpeg(), {.AddAlphaIfRGB = 0xFFu});
+    ASSERT_TRUE(header.has_value());
+    EXPECT_EQ(header->Width, 32u);
+    EXPECT_EQ(header->Height, 16u);
+    EXPECT_EQ(header->Format, radray::ImageFormat::RGBA8_BYTE);
+
+    auto loaded = radray::ImageData::LoadJPEG(BlockColorsJpeg());
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_EQ(loaded->Format, radray::ImageFormat::RGB8_BYTE);
+    for (uint32_t block = 0; block < 8; ++block) {
+        const size_t x = (block % 4) * 8 + 4;
+        const size_t y = (block / 4) * 8 + 4;
+        ExpectNear(loaded->Data.get() + (y * 32 + x) * 3, kBlockColors[block], 4);
+    }
+}
+
+TEST(JPEG, ScaledDecode) {
+    for (uint32_t scale : {2u, 4u, 8u}) {
+        auto loaded = radray::ImageData::LoadJPEG(BlockColorsJpeg(), {.AddAlphaIfRGB = 0xFFu, .ScaleDenominator = scale});
+        ASSERT_TRUE(loaded.has_value()) << scale;
+        ASSERT_EQ(loaded->Width, 32u / scale);
+        ASSERT_EQ(loaded->Height, 16u / scale);
+        ASSERT_EQ(loaded->Format, radray::ImageFormat::RGBA8_BYTE);
+        const uint32_t blockSize = 8 / scale;
+        for (uint32_t block = 0; block < 8; ++block) {
+            const size_t x = (block % 4) * blockSize + blockSize / 2;
+            const size_t y = (block / 4) * blockSize + blockSize / 2;
+            const radray::byte* pixel = loaded->Data.get() + (y * loaded->Width + x) * 4;
+            ExpectNear(pixel, kBlockColors[block], 4);
+            EXPECT_EQ(pixel[3], radray::byte{0xFF});
+        }
+    }
+    EXPECT_FALSE(radray::ImageData::LoadJPEG(BlockColorsJpeg(), {.ScaleDenominator = 3}).has_value());
+}
+
+TEST(JPEG, DecodeIntoPitchedTarget) {
+    auto reference = radray::ImageData::LoadJPEG(BlockColorsJpeg());
+    ASSERT_TRUE(reference.has_value());
+
+    // 非 0xFF 的 alpha 走逐行补 alpha; 行距 160 (紧密行宽 128), 翻转。
+    constexpr size_t kPitch = 160;
+    std::vector<radray::byte> staging(kPitch * 16, radray::byte{0xCD});
+    auto decoded = radray::ImageData::DecodeJPEG(
+        BlockColorsJpeg(),
+        {.Data = staging, .RowPitch = kPitch},
+        {.AddAlphaIfRGB = 0x80u, .IsFlipY = true});
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->Format, radray::ImageFormat::RGBA8_BYTE);
+    for (size_t y = 0; y < 16; ++y) {
+        const radray::byte* row = staging.data() + (15 - y) * kPitch;
+        for (size_t x = 0; x < 32; ++x) {
+            ASSERT_EQ(std::memcmp(row + x * 4, reference->Data.get() + (y * 32 + x) * 3, 3), 0) << x << "," << y;
+            ASSERT_EQ(row[x * 4 + 3], radray::byte{0x80});
+        }
+        EXPECT_EQ(row[128], radray::byte{0xCD});
+    }
+
+    std::vector<radray::byte> small(kPitch * 15, radray::byte{0xCD});
+    EXPECT_FALSE(radray::ImageData::DecodeJPEG(BlockColorsJpeg(), {.Data = small, .RowPitch = kPitch}).has_value());
+}
+
+#endif
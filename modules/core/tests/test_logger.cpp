@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#include <radray/logger.h>
+
+using namespace radray;
+
+namespace {
+
+constexpr std::string_view kTag = "[async-log-test] ";
+
+struct CapturedLogs {
+    std::mutex Mutex;
+    vector<string> Messages;
+    std::atomic<bool> Gate{true};
+    std::atomic<uint32_t> Entered{0};
+};
+
+void CaptureLog(LogLevel, std::string_view message, void* userData) {
+    auto* captured = static_cast<CapturedLogs*>(userData);
+    if (!message.starts_with(kTag)) {
+        return;
+    }
+    captured->Entered.fetch_add(1);
+    while (!captured->Gate.load()) {
+        std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock{captured->Mutex};
+    captured->Messages.emplace_back(message.substr(kTag.size()));
+}
+
+class AsyncLogTest : public ::testing::Test {
+protected:
+    void SetUp() override { SetLogCallback(&CaptureLog, &_captured); }
+
+    void TearDown() override {
+        _captured.Gate.store(true);
+        StopAsyncLog();
+        ClearLogCallback();
+    }
+
+    CapturedLogs _captured;
+};
+
+}  // namespace
+
+static_assert(IsLogLevelCompiled(LogLevel::Critical));
+
+TEST_F(AsyncLogTest, DeliversEveryMessageInPerThreadOrder) {
+    ASSERT_TRUE(StartAsyncLog({.Capacity = 64, .Overflow = LogOverflowPolicy::Block}));
+    EXPECT_TRUE(IsAsyncLogEnabled());
+    EXPECT_FALSE(StartAsyncLog({}));
+
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 500;
+    vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < kPerThread; ++i) {
+                LogFormat(LogLevel::Warn, "{}{} {}", kTag, t, i);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    FlushLog();
+
+    ASSERT_EQ(_captured.Messages.size(), static_cast<size_t>(kThreads * kPerThread));
+    int next[kThreads]{};
+    for (const string& message : _captured.Messages) {
+        int t = -1;
+        int i = -1;
+        ASSERT_EQ(std::sscanf(message.c_str(), "%d %d", &t, &i), 2) << message;
+        ASSERT_GE(t, 0);
+        ASSERT_LT(t, kThreads);
+        EXPECT_EQ(i, next[t]++);
+    }
+    EXPECT_EQ(GetDroppedLogCount(), 0u);
+}
+
+TEST_F(AsyncLogTest, DropPolicyCountsOverflow) {
+    ASSERT_TRUE(StartAsyncLog({.Capacity = 4, .Overflow = LogOverflowPolicy::Drop}));
+    _captured.Gate.store(false);
+
+    LogFormat(LogLevel::Warn, "{}first", kTag);
+    while (_captured.Entered.load() == 0) {
+        std::this_thread::yield();
+    }
+    // flusher 卡在回调里，队列最多再收 4 条。
+    constexpr int kBurst = 100;
+    for (int i = 0; i < kBurst; ++i) {
+        LogFormat(LogLevel::Warn, "{}{}", kTag, i);
+    }
+    const uint64_t dropped = GetDroppedLogCount();
+    EXPECT_GE(dropped, static_cast<uint64_t>(kBurst - 4));
+
+    _captured.Gate.store(true);
+    FlushLog();
+    EXPECT_EQ(_captured.Messages.size() + dropped, static_cast<size_t>(kBurst + 1));
+}
+
+TEST_F(AsyncLogTest, LongMessagesSurviveTheQueue) {
+    ASSERT_TRUE(StartAsyncLog({.Capacity = 8}));
+    const string payload(4096, 'x');
+    LogFormat(LogLevel::Warn, "{}{}", kTag, payload);
+    FlushLog();
+    ASSERT_EQ(_captured.Messages.size(), 1u);
+    EXPECT_EQ(_captured.Messages[0], payload);
+}
+
+TEST_F(AsyncLogTest, StopFallsBackToSynchronousLogging) {
+    ASSERT_TRUE(StartAsyncLog({.Capacity = 8}));
+    LogFormat(LogLevel::Warn, "{}queued", kTag);
+    StopAsyncLog();
+    EXPECT_FALSE(IsAsyncLogEnabled());
+    ASSERT_EQ(_captured.Messages.size(), 1u);
+
+    LogFormat(LogLevel::Warn, "{}direct", kTag);
+    ASSERT_EQ(_captured.Messages.size(), 2u);
+    EXPECT_EQ(_captured.Messages[1], "direct");
+}
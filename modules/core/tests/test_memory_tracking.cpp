@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include <radray/memory.h>
+#include <radray/types.h>
+
+using namespace radray;
+
+namespace {
+
+class MemoryTrackingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if constexpr (!IsMemoryTrackingEnabled()) {
+            GTEST_SKIP() << "RADRAY_ENABLE_MEMORY_TRACKING is off";
+        }
+    }
+};
+
+}  // namespace
+
+TEST_F(MemoryTrackingTest, AttributesAllocationsToTheInnermostTag) {
+    const MemoryTagStats assetBefore = GetMemoryTagStats(MemoryTag::AssetLoading);
+    const MemoryTagStats jitBefore = GetMemoryTagStats(MemoryTag::ShaderJit);
+
+    void* asset = nullptr;
+    void* jit = nullptr;
+    {
+        MemoryTagScope assetScope{MemoryTag::AssetLoading};
+        asset = Malloc(1000);
+        {
+            MemoryTagScope jitScope{MemoryTag::ShaderJit};
+            EXPECT_EQ(GetCurrentMemoryTag(), MemoryTag::ShaderJit);
+            jit = Malloc(24);
+        }
+        EXPECT_EQ(GetCurrentMemoryTag(), MemoryTag::AssetLoading);
+    }
+    EXPECT_EQ(GetCurrentMemoryTag(), MemoryTag::Untagged);
+
+    const MemoryTagStats assetLive = GetMemoryTagStats(MemoryTag::AssetLoading);
+    EXPECT_EQ(assetLive.LiveBytes - assetBefore.LiveBytes, 1000);
+    EXPECT_EQ(assetLive.AllocationCount - assetBefore.AllocationCount, 1u);
+    EXPECT_GE(assetLive.PeakBytes, assetLive.LiveBytes);
+    EXPECT_EQ(GetMemoryTagStats(MemoryTag::ShaderJit).LiveBytes - jitBefore.LiveBytes, 24);
+
+    // 释放时按分配时的 tag 记账，与释放点所在的 tag 无关。
+    Free(asset);
+    Free(jit);
+    const MemoryTagStats assetAfter = GetMemoryTagStats(MemoryTag::AssetLoading);
+    EXPECT_EQ(assetAfter.LiveBytes, assetBefore.LiveBytes);
+    EXPECT_EQ(assetAfter.FreeCount - assetBefore.FreeCount, 1u);
+    EXPECT_GE(assetAfter.PeakBytes, assetBefore.LiveBytes + 1000);
+    EXPECT_EQ(GetMemoryTagStats(MemoryTag::ShaderJit).LiveBytes, jitBefore.LiveBytes);
+}
+
+TEST_F(MemoryTrackingTest, MergesCountersFromOtherAndExitedThreads) {
+    const MemoryTagStats before = GetMemoryTagStats(MemoryTag::RenderFramework);
+    void* block = nullptr;
+    std::thread allocator{[&block]() {
+        MemoryTagScope scope{MemoryTag::RenderFramework};
+        block = Malloc(4096);
+    }};
+    allocator.join();
+    EXPECT_EQ(GetMemoryTagStats(MemoryTag::RenderFramework).LiveBytes - before.LiveBytes, 4096);
+
+    Free(block);
+    const MemoryTagStats after = GetMemoryTagStats(MemoryTag::RenderFramework);
+    EXPECT_EQ(after.LiveBytes, before.LiveBytes);
+    EXPECT_EQ(after.AllocationCount - before.AllocationCount, 1u);
+    EXPECT_EQ(after.FreeCount - before.FreeCount, 1u);
+}
+
+TEST_F(MemoryTrackingTest, AlignedAllocationsKeepTheirAlignment) {
+    const MemoryTagStats before = GetMemoryTagStats(MemoryTag::Untagged);
+    for (size_t alignment : {size_t{8}, size_t{16}, size_t{64}, size_t{256}}) {
+        void* ptr = AlignedAlloc(alignment, alignment * 4);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0u);
+        AlignedFree(ptr);
+    }
+    EXPECT_EQ(GetMemoryTagStats(MemoryTag::Untagged).LiveBytes, before.LiveBytes);
+}
+
+TEST_F(MemoryTrackingTest, FrameSampleCountsAllocationsSinceLastSample) {
+    SampleMemoryFrame();
+    const MemoryFrameSample idle = SampleMemoryFrame();
+    EXPECT_EQ(idle.AllocationCount, 0u);
+    EXPECT_EQ(idle.AllocatedBytes, 0u);
+
+    void* a = Malloc(100);
+    void* b = Malloc(28);
+    const MemoryFrameSample busy = SampleMemoryFrame();
+    EXPECT_EQ(busy.AllocationCount, 2u);
+    EXPECT_EQ(busy.AllocatedBytes, 128u);
+    Free(a);
+    Free(b);
+    EXPECT_EQ(SampleMemoryFrame().AllocationCount, 0u);
+}
+
+TEST_F(MemoryTrackingTest, CountsContainerAndNewExpressionAllocations) {
+    if constexpr (!IsGlobalNewTracked()) {
+        GTEST_SKIP() << "the global operator new belongs to mimalloc-override on this platform";
+    }
+    struct alignas(64) Wide {
+        byte Bytes[64];
+    };
+    const MemoryTagStats before = GetMemoryTagStats(MemoryTag::ShaderJit);
+    {
+        MemoryTagScope scope{MemoryTag::ShaderJit};
+        vector<uint32_t> values;
+        values.reserve(256);
+        auto block = make_unique<std::array<byte, 512>>();
+        auto wide = make_unique<Wide>();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(wide.get()) % alignof(Wide), 0u);
+
+        const MemoryTagStats live = GetMemoryTagStats(MemoryTag::ShaderJit);
+        EXPECT_EQ(live.AllocationCount - before.AllocationCount, 3u);
+        EXPECT_EQ(live.LiveBytes - before.LiveBytes, 256 * 4 + 512 + 64);
+    }
+    const MemoryTagStats after = GetMemoryTagStats(MemoryTag::ShaderJit);
+    EXPECT_EQ(after.LiveBytes, before.LiveBytes);
+    EXPECT_EQ(after.FreeCount - before.FreeCount, 3u);
+}
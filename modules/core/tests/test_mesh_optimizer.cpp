@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <tuple>
+
+#include <radray/mesh_optimizer.h>
+#include <radray/triangle_mesh.h>
+
+using namespace radray;
+
+namespace {
+
+using TriangleKey = std::array<std::tuple<float, float, float, float, float>, 3>;
+
+/// 按位置与 UV 描述每个三角形, 旋转到最小顶点在前 (保留绕序) 后排序。重排前后必须相同。
+vector<TriangleKey> CanonicalTriangles(const TriangleMesh& mesh) {
+    vector<TriangleKey> triangles;
+    for (size_t t = 0; t + 2 < mesh.Indices.size(); t += 3) {
+        TriangleKey key;
+        for (size_t j = 0; j < 3; j++) {
+            const uint32_t v = mesh.Indices[t + j];
+            const Eigen::Vector3f& p = mesh.Positions[v];
+            const Eigen::Vector2f uv = mesh.UV0.empty() ? Eigen::Vector2f::Zero() : mesh.UV0[v];
+            key[j] = {p.x(), p.y(), p.z(), uv.x(), uv.y()};
+        }
+        std::rotate(key.begin(), std::min_element(key.begin(), key.end()), key.end());
+        triangles.push_back(key);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+/// side x side 个格子的平面网格, 三角形次序打乱。
+TriangleMesh MakeShuffledGrid(uint32_t side, uint32_t seed) {
+    TriangleMesh mesh;
+    for (uint32_t y = 0; y <= side; y++) {
+        for (uint32_t x = 0; x <= side; x++) {
+            mesh.Positions.emplace_back(static_cast<float>(x), static_cast<float>(y), 0.0f);
+            mesh.UV0.emplace_back(static_cast<float>(x) / side, static_cast<float>(y) / side);
+        }
+    }
+    vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y < side; y++) {
+        for (uint32_t x = 0; x < side; x++) {
+            const uint32_t a = y * (side + 1) + x;
+            const uint32_t c = a + side + 1;
+            triangles.push_back({a, a + 1, c + 1});
+            triangles.push_back({a, c + 1, c});
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937{seed});
+    for (const auto& triangle : triangles) {
+        mesh.Indices.insert(mesh.Indices.end(), triangle.begin(), triangle.end());
+    }
+    return mesh;
+}
+
+/// 每个三角形各自持有三个顶点, 没有任何共享。
+TriangleMesh Unweld(const TriangleMesh& mesh) {
+    TriangleMesh soup;
+    for (uint32_t index : mesh.Indices) {
+        soup.Indices.push_back(static_cast<uint32_t>(soup.Positions.size()));
+        soup.Positions.push_back(mesh.Positions[index]);
+        soup.UV0.push_back(mesh.UV0[index]);
+    }
+    return soup;
+}
+
+}  // namespace
+
+TEST(Core_MeshOptimizer, AnalyzeVertexCacheCountsFifoMisses) {
+    const std::array<uint32_t, 9> indices{0, 1, 2, 0, 2, 3, 3, 4, 0};
+    const VertexCacheStatistics stats = AnalyzeVertexCache(indices, 5, 16);
+    EXPECT_EQ(stats.VerticesTransformed, 5u);
+    EXPECT_FLOAT_EQ(stats.Acmr, 5.0f / 3.0f);
+    EXPECT_FLOAT_EQ(stats.Atvr, 1.0f);
+
+    // 3 项缓存: 第三个三角形时 0 已被 3 挤出。
+    const VertexCacheStatistics small = AnalyzeVertexCache(indices, 5, 3);
+    EXPECT_EQ(small.VerticesTransformed, 6u);
+}
+
+TEST(Core_MeshOptimizer, WeldMergesBitwiseEqualVertices) {
+    const TriangleMesh grid = MakeShuffledGrid(8, 1);
+    TriangleMesh soup = Unweld(grid);
+    ASSERT_EQ(soup.Positions.size(), 8u * 8u * 6u);
+    EXPECT_EQ(WeldVertices(soup), grid.Positions.size());
+    EXPECT_EQ(soup.Positions.size(), grid.Positions.size());
+    EXPECT_EQ(soup.UV0.size(), grid.Positions.size());
+    EXPECT_EQ(CanonicalTriangles(soup), CanonicalTriangles(grid));
+
+    // 位置相同而 UV 不同的顶点 (UV 接缝) 不合并; -0 与 +0 合并。
+    TriangleMesh seam;
+    seam.Positions = {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {-0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+    seam.UV0 = {{0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {0.0f, 0.0f}, {0.5f, 1.0f}};
+    seam.Indices = {0, 1, 2, 3, 1, 4};
+    EXPECT_EQ(WeldVertices(seam), 4u);
+    EXPECT_EQ(seam.Indices, (vector<uint32_t>{0, 1, 2, 0, 1, 3}));
+}
+
+TEST(Core_MeshOptimizer, VertexCacheReorderLowersAcmr) {
+    TriangleMesh mesh = MakeShuffledGrid(64, 2);
+    const vector<TriangleKey> before = CanonicalTriangles(mesh);
+    const VertexCacheStatistics shuffled = AnalyzeVertexCache(mesh.Indices, mesh.Positions.size());
+    OptimizeVertexCache(mesh.Indices, mesh.Positions.size());
+    const VertexCacheStatistics optimized = AnalyzeVertexCache(mesh.Indices, mesh.Positions.size());
+    // 打乱的网格几乎没有复用; 规则网格上 Tipsify 应接近每个顶点只变换一次。
+    EXPECT_GT(shuffled.Acmr, 2.0f);
+    EXPECT_LT(optimized.Acmr, 0.8f);
+    EXPECT_LT(optimized.Atvr, 1.5f);
+    EXPECT_EQ(CanonicalTriangles(mesh), before);
+}
+
+TEST(Core_MeshOptimizer, OverdrawOrderKeepsTrianglesAndCacheBudget) {
+    TriangleMesh sphere;
+    sphere.InitAsUVSphere(1.0f, 48);
+    const vector<TriangleKey> before = CanonicalTriangles(sphere);
+    OptimizeVertexCache(sphere.Indices, sphere.Positions.size());
+    const VertexCacheStatistics cacheOnly = AnalyzeVertexCache(sphere.Indices, sphere.Positions.size());
+    OptimizeOverdraw(sphere.Indices, sphere.Positions, 16, 1.05f);
+    const VertexCacheStatistics withOverdraw = AnalyzeVertexCache(sphere.Indices, sphere.Positions.size());
+    EXPECT_EQ(CanonicalTriangles(sphere), before);
+    // 簇各自从空缓存起算, 重排后的 ACMR 不会超过切簇时允许的上浮太多。
+    EXPECT_LT(withOverdraw.Acmr, cacheOnly.Acmr * 1.25f);
+}
+
+TEST(Core_MeshOptimizer, VertexFetchFollowsFirstUseAndDropsUnused) {
+    TriangleMesh mesh;
+    mesh.Positions = {{0, 0, 0}, {1, 0, 0}, {2, 0, 0}, {3, 0, 0}, {4, 0, 0}};
+    mesh.Normals = {{0, 0, 1}, {0, 1, 0}, {1, 0, 0}, {0, 0, -1}, {0, -1, 0}};
+    mesh.Indices = {4, 2, 0, 0, 2, 3};
+    EXPECT_EQ(OptimizeVertexFetch(mesh), 4u);
+    EXPECT_EQ(mesh.Indices, (vector<uint32_t>{0, 1, 2, 2, 1, 3}));
+    ASSERT_EQ(mesh.Positions.size(), 4u);
+    EXPECT_EQ(mesh.Positions[0].x(), 4.0f);
+    EXPECT_EQ(mesh.Positions[3].x(), 3.0f);
+    EXPECT_EQ(mesh.Normals[0], Eigen::Vector3f(0, -1, 0));
+}
+
+TEST(Core_MeshOptimizer, OptimizeMeshReportsAcmrAndAtvr) {
+    TriangleMesh mesh = Unweld(MakeShuffledGrid(48, 3));
+    const vector<TriangleKey> before = CanonicalTriangles(mesh);
+    const VertexCacheStatistics original = AnalyzeVertexCache(mesh.Indices, mesh.Positions.size());
+    ASSERT_TRUE(OptimizeMesh(mesh));
+    const VertexCacheStatistics optimized = AnalyzeVertexCache(mesh.Indices, mesh.Positions.size());
+    RecordProperty("AcmrBefore", std::to_string(original.Acmr));
+    RecordProperty("AcmrAfter", std::to_string(optimized.Acmr));
+    RecordProperty("AtvrBefore", std::to_string(original.Atvr));
+    RecordProperty("AtvrAfter", std::to_string(optimized.Atvr));
+    EXPECT_FLOAT_EQ(original.Acmr, 3.0f);
+    EXPECT_EQ(mesh.Positions.size(), 49u * 49u);
+    EXPECT_LT(optimized.Acmr, 0.85f);
+    EXPECT_LT(optimized.Atvr, 1.6f);
+    EXPECT_EQ(CanonicalTriangles(mesh), before);
+    // 顶点获取重排之后, 每个顶点第一次出现时恰好是下一个新下标。
+    uint32_t next = 0;
+    for (uint32_t index : mesh.Indices) {
+        ASSERT_LE(index, next);
+        next = std::max(next, index + 1);
+    }
+
+    TriangleMesh broken;
+    broken.Positions = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}};
+    broken.Indices = {0, 1, 3};
+    EXPECT_FALSE(OptimizeMesh(broken));
+    EXPECT_EQ(broken.Indices, (vector<uint32_t>{0, 1, 3}));
+}
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <radray/mesh_simplifier.h>
+#include <radray/triangle_mesh.h>
+
+using namespace radray;
+
+namespace {
+
+/// side x side 个单位格子的 z = 0 平面。seam 为 true 时 x = side / 2 一列顶点复制一份,
+/// 右半边的三角形用副本, 模拟 UV 接缝。
+TriangleMesh MakeGrid(uint32_t side, bool seam) {
+    TriangleMesh mesh;
+    const uint32_t row = side + 1;
+    for (uint32_t y = 0; y <= side; y++) {
+        for (uint32_t x = 0; x <= side; x++) {
+            mesh.Positions.emplace_back(static_cast<float>(x), static_cast<float>(y), 0.0f);
+        }
+    }
+    const uint32_t seamFirst = static_cast<uint32_t>(mesh.Positions.size());
+    if (seam) {
+        for (uint32_t y = 0; y <= side; y++) {
+            mesh.Positions.emplace_back(static_cast<float>(side / 2), static_cast<float>(y), 0.0f);
+        }
+    }
+    const auto vertex = [&](uint32_t x, uint32_t y, bool rightHalf) {
+        return seam && rightHalf && x == side / 2 ? seamFirst + y : y * row + x;
+    };
+    for (uint32_t y = 0; y < side; y++) {
+        for (uint32_t x = 0; x < side; x++) {
+            const bool right = x >= side / 2;
+            const uint32_t a = vertex(x, y, right), b = vertex(x + 1, y, right);
+            const uint32_t c = vertex(x, y + 1, right), d = vertex(x + 1, y + 1, right);
+            mesh.Indices.insert(mesh.Indices.end(), {a, b, d, a, d, c});
+        }
+    }
+    return mesh;
+}
+
+Eigen::Vector3f TriangleNormal(std::span<const Eigen::Vector3f> positions, const uint32_t* triangle) {
+    const Eigen::Vector3f& p0 = positions[triangle[0]];
+    return (positions[triangle[1]] - p0).cross(positions[triangle[2]] - p0);
+}
+
+/// 点到三角形的距离 (Ericson, Real-Time Collision Detection 5.1.5)。
+float PointTriangleDistance(const Eigen::Vector3f& p, const Eigen::Vector3f& a, const Eigen::Vector3f& b, const Eigen::Vector3f& c) {
+    const Eigen::Vector3f ab = b - a, ac = c - a, ap = p - a;
+    const float d1 = ab.dot(ap), d2 = ac.dot(ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        return (p - a).norm();
+    }
+    const Eigen::Vector3f bp = p - b;
+    const float d3 = ab.dot(bp), d4 = ac.dot(bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+        return (p - b).norm();
+    }
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        return (p - (a + ab * (d1 / (d1 - d3)))).norm();
+    }
+    const Eigen::Vector3f cp = p - c;
+    const float d5 = ab.dot(cp), d6 = ac.dot(cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+        return (p - c).norm();
+    }
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        return (p - (a + ac * (d2 / (d2 - d6)))).norm();
+    }
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return (p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))))).norm();
+    }
+    const float denom = 1.0f / (va + vb + vc);
+    return (p - (a + ab * (vb * denom) + ac * (vc * denom))).norm();
+}
+
+/// 原网格每个顶点到简化网格的最大距离 (单侧 Hausdorff 距离在顶点上的取样)。
+float MaxVertexDeviation(const TriangleMesh& mesh, std::span<const uint32_t> simplified) {
+    vector<uint32_t> vertices = mesh.Indices;
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+    float worst = 0.0f;
+    for (uint32_t index : vertices) {
+        const Eigen::Vector3f& p = mesh.Positions[index];
+        float nearest = std::numeric_limits<float>::max();
+        for (size_t t = 0; t + 2 < simplified.size(); t += 3) {
+            nearest = std::min(nearest, PointTriangleDistance(
+                p,
+                mesh.Positions[simplified[t]],
+                mesh.Positions[simplified[t + 1]],
+                mesh.Positions[simplified[t + 2]]));
+        }
+        worst = std::max(worst, nearest);
+    }
+    return worst;
+}
+
+}  // namespace
+
+TEST(Core_MeshSimplifier, FlatGridCollapsesWithoutMovingTheOutline) {
+    const TriangleMesh grid = MakeGrid(16, false);
+    const MeshSimplifyResult result = SimplifyMesh(grid.Indices, grid.Positions, {.TargetIndexCount = 0, .TargetError = 1e-4f});
+    EXPECT_LE(result.Indices.size() / 3, 8u);
+    EXPECT_LE(result.Error, 1e-4f);
+    float area = 0.0f;
+    Eigen::Vector3f boundsMin = Eigen::Vector3f::Constant(1e9f);
+    Eigen::Vector3f boundsMax = Eigen::Vector3f::Constant(-1e9f);
+    for (size_t t = 0; t < result.Indices.size(); t += 3) {
+        const Eigen::Vector3f normal = TriangleNormal(grid.Positions, result.Indices.data() + t);
+        EXPECT_GT(normal.z(), 0.0f);
+        area += normal.z() * 0.5f;
+        for (size_t k = 0; k < 3; k++) {
+            boundsMin = boundsMin.cwiseMin(grid.Positions[result.Indices[t + k]]);
+            boundsMax = boundsMax.cwiseMax(grid.Positions[result.Indices[t + k]]);
+        }
+    }
+    // 边界只沿自身滑动、角点不动: 覆盖的面积与外框不变。
+    EXPECT_FLOAT_EQ(area, 256.0f);
+    EXPECT_EQ(boundsMin, Eigen::Vector3f(0.0f, 0.0f, 0.0f));
+    EXPECT_EQ(boundsMax, Eigen::Vector3f(16.0f, 16.0f, 0.0f));
+}
+
+TEST(Core_MeshSimplifier, AttributeSeamStaysIntact) {
+    const TriangleMesh grid = MakeGrid(16, true);
+    const uint32_t seamFirst = 17u * 17u;
+    const MeshSimplifyResult result = SimplifyMesh(grid.Indices, grid.Positions, {.TargetIndexCount = 0, .TargetError = 1e-4f});
+    EXPECT_LT(result.Indices.size(), grid.Indices.size() / 8);
+    float leftArea = 0.0f;
+    float rightArea = 0.0f;
+    for (size_t t = 0; t < result.Indices.size(); t += 3) {
+        bool usesSeamCopy = false;
+        bool left = true;
+        bool right = true;
+        for (size_t k = 0; k < 3; k++) {
+            const uint32_t index = result.Indices[t + k];
+            usesSeamCopy |= index >= seamFirst;
+            left &= grid.Positions[index].x() <= 8.0f;
+            right &= grid.Positions[index].x() >= 8.0f;
+        }
+        // 三角形不跨接缝, 右半边只用接缝副本, 左半边只用原顶点。
+        ASSERT_TRUE(left || right);
+        const float area = TriangleNormal(grid.Positions, result.Indices.data() + t).z() * 0.5f;
+        if (left && !usesSeamCopy) {
+            leftArea += area;
+        } else {
+            EXPECT_TRUE(right);
+            for (size_t k = 0; k < 3; k++) {
+                const uint32_t index = result.Indices[t + k];
+                EXPECT_TRUE(grid.Positions[index].x() > 8.0f || index >= seamFirst);
+            }
+            rightArea += area;
+        }
+    }
+    EXPECT_FLOAT_EQ(leftArea, 128.0f);
+    EXPECT_FLOAT_EQ(rightArea, 128.0f);
+}
+
+TEST(Core_MeshSimplifier, ReportedErrorBoundsDeviation) {
+    TriangleMesh sphere;
+    sphere.InitAsUVSphere(1.0f, 64);
+    const size_t triangles = sphere.Indices.size() / 3;
+
+    const MeshSimplifyResult coarse = SimplifyMesh(sphere.Indices, sphere.Positions, {.TargetIndexCount = triangles / 10 * 3});
+    ASSERT_LE(coarse.Indices.size(), triangles / 10 * 3);
+    ASSERT_GT(coarse.Indices.size(), 0u);
+    EXPECT_GT(coarse.Error, 0.0f);
+    const float deviation = MaxVertexDeviation(sphere, coarse.Indices);
+    RecordProperty("Error", std::to_string(coarse.Error));
+    RecordProperty("Deviation", std::to_string(deviation));
+    EXPECT_LE(deviation, coarse.Error * 2.0f);
+    for (size_t t = 0; t < coarse.Indices.size(); t += 3) {
+        const Eigen::Vector3f normal = TriangleNormal(sphere.Positions, coarse.Indices.data() + t);
+        const Eigen::Vector3f centroid = (sphere.Positions[coarse.Indices[t]] +
+                                          sphere.Positions[coarse.Indices[t + 1]] +
+                                          sphere.Positions[coarse.Indices[t + 2]]) /
+                                         3.0f;
+        // 没有翻进球内的面 (南极一圈原本就是退化的细条); 面心离球面不超过误差的两倍。
+        EXPECT_GE(normal.dot(centroid), -1e-6f);
+        EXPECT_LE(1.0f - centroid.norm(), coarse.Error * 2.0f);
+    }
+
+    // 误差上限先到时停在上限以内, 上限越小剩下的三角形越多。
+    const MeshSimplifyResult bounded = SimplifyMesh(
+        sphere.Indices,
+        sphere.Positions,
+        {.TargetIndexCount = 0, .TargetError = coarse.Error * 0.25f});
+    EXPECT_LE(bounded.Error, coarse.Error * 0.25f);
+    EXPECT_GT(bounded.Indices.size(), coarse.Indices.size());
+    EXPECT_LE(MaxVertexDeviation(sphere, bounded.Indices), coarse.Error * 0.5f);
+}
+
+TEST(Core_MeshSimplifier, GenerateMeshLodsAppendsCoarserLevels) {
+    TriangleMesh sphere;
+    sphere.InitAsUVSphere(1.0f, 48);
+    const vector<uint32_t> lod0 = sphere.Indices;
+    const vector<MeshLodEntry> lods = GenerateMeshLods(sphere, {.MaxLodCount = 4, .MaxRelativeError = 0.1f});
+    ASSERT_EQ(lods.size(), 4u);
+    EXPECT_EQ(lods[0].FirstIndex, 0u);
+    EXPECT_EQ(lods[0].IndexCount, lod0.size());
+    EXPECT_EQ(lods[0].Error, 0.0f);
+    EXPECT_TRUE(std::equal(lod0.begin(), lod0.end(), sphere.Indices.begin()));
+    for (size_t level = 1; level < lods.size(); level++) {
+        EXPECT_EQ(lods[level].FirstIndex, lods[level - 1].FirstIndex + lods[level - 1].IndexCount);
+        EXPECT_LE(lods[level].IndexCount, lods[level - 1].IndexCount / 2 + 3);
+        EXPECT_GT(lods[level].Error, lods[level - 1].Error);
+        const std::span<const uint32_t> indices{sphere.Indices.data() + lods[level].FirstIndex, lods[level].IndexCount};
+        // 逐级误差之和是对 LOD0 的保守上界。
+        TriangleMesh original = sphere;
+        original.Indices = lod0;
+        EXPECT_LE(MaxVertexDeviation(original, indices), lods[level].Error * 2.0f);
+    }
+    EXPECT_EQ(sphere.Indices.size(), size_t{lods.back().FirstIndex} + lods.back().IndexCount);
+
+    TriangleMesh broken;
+    broken.Positions = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}};
+    broken.Indices = {0, 1, 3};
+    EXPECT_TRUE(GenerateMeshLods(broken).empty());
+}
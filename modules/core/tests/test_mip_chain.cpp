@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+
+#include <radray/mip_chain.h>
+
+using namespace radray;
+
+namespace {
+
+vector<byte> MakeNoise(uint32_t width, uint32_t height, uint32_t seed) {
+    std::mt19937 random{seed};
+    vector<byte> pixels(size_t{width} * height * 4);
+    for (byte& value : pixels) {
+        value = static_cast<byte>(random() & 0xff);
+    }
+    return pixels;
+}
+
+float ReferenceSrgbToLinear(uint32_t value) {
+    const double normalized = value / 255.0;
+    return static_cast<float>(normalized <= 0.04045 ? normalized / 12.92 : std::pow((normalized + 0.055) / 1.055, 2.4));
+}
+
+uint32_t ReferenceLinearToSrgb(double value) {
+    const double encoded = value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+    return static_cast<uint32_t>(std::lround(std::clamp(encoded, 0.0, 1.0) * 255.0));
+}
+
+/// 逐像素逐通道的 2x2 平均, 越界样本跳过。新实现必须与它一致。
+vector<byte> ReferenceBoxLevel(std::span<const byte> source, uint32_t width, uint32_t height, bool srgb) {
+    const uint32_t dstWidth = std::max(width / 2, 1u);
+    const uint32_t dstHeight = std::max(height / 2, 1u);
+    vector<byte> destination(size_t{dstWidth} * dstHeight * 4);
+    for (uint32_t y = 0; y < dstHeight; ++y) {
+        for (uint32_t x = 0; x < dstWidth; ++x) {
+            double totals[4]{};
+            uint32_t samples = 0;
+            for (uint32_t sy = y * 2; sy < std::min(y * 2 + 2, height); ++sy) {
+                for (uint32_t sx = x * 2; sx < std::min(x * 2 + 2, width); ++sx) {
+                    for (size_t channel = 0; channel < 4; ++channel) {
+                        const uint32_t sample = std::to_integer<uint32_t>(source[(size_t{sy} * width + sx) * 4 + channel]);
+                        totals[channel] += srgb && channel < 3 ? ReferenceSrgbToLinear(sample) : sample;
+                    }
+                    ++samples;
+                }
+            }
+            for (size_t channel = 0; channel < 4; ++channel) {
+                const double average = totals[channel] / samples;
+                destination[(size_t{y} * dstWidth + x) * 4 + channel] = static_cast<byte>(
+                    srgb && channel < 3 ? ReferenceLinearToSrgb(average) : static_cast<uint32_t>(std::lround(average)));
+            }
+        }
+    }
+    return destination;
+}
+
+MipParallelFor ThreadParallelFor() {
+    return [](uint32_t count, const std::function<void(uint32_t)>& body) {
+        vector<std::thread> threads;
+        for (uint32_t i = 0; i < count; ++i) {
+            threads.emplace_back([&body, i]() { body(i); });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    };
+}
+
+}  // namespace
+
+TEST(MipChainTest, LevelsAreContiguousInOneAllocation) {
+    const vector<byte> pixels = MakeNoise(5, 3, 1);
+    const Rgba8MipChain chain = BuildRgba8MipChain(pixels, 5, 3, MipChainOptions{});
+    ASSERT_EQ(chain.GetLevelCount(), 3u);
+    EXPECT_EQ(chain.GetLevelWidth(1), 2u);
+    EXPECT_EQ(chain.GetLevelHeight(1), 1u);
+    EXPECT_EQ(chain.GetLevelWidth(2), 1u);
+    EXPECT_EQ(chain.GetBytes().size(), (15u + 2u + 1u) * 4u);
+    EXPECT_EQ(chain.GetLevel(1).data(), chain.GetBytes().data() + 60);
+    EXPECT_EQ(chain.GetLevel(2).data(), chain.GetBytes().data() + 68);
+    EXPECT_TRUE(std::equal(pixels.begin(), pixels.end(), chain.GetLevel(0).begin()));
+    EXPECT_TRUE(chain.GetLevel(3).empty());
+
+    const Rgba8MipChain single = BuildRgba8MipChain(pixels, 5, 3, MipChainOptions{.GenerateMips = false});
+    EXPECT_EQ(single.GetLevelCount(), 1u);
+    EXPECT_TRUE(BuildRgba8MipChain(pixels, 4, 3, MipChainOptions{}).IsEmpty());
+}
+
+TEST(MipChainTest, BoxFilterMatchesThePerSampleReference) {
+    // 奇数边长、单行、单列与够宽到走 SIMD 的尺寸都覆盖。
+    const std::array<std::pair<uint32_t, uint32_t>, 5> sizes{{{37, 21}, {64, 64}, {1, 9}, {9, 1}, {130, 7}}};
+    for (const bool srgb : {false, true}) {
+        for (const auto& [width, height] : sizes) {
+            const vector<byte> pixels = MakeNoise(width, height, width * 31 + height);
+            const Rgba8MipChain chain = BuildRgba8MipChain(pixels, width, height, MipChainOptions{.Srgb = srgb});
+            vector<byte> expected = pixels;
+            for (uint32_t mip = 1; mip < chain.GetLevelCount(); ++mip) {
+                expected = ReferenceBoxLevel(expected, chain.GetLevelWidth(mip - 1), chain.GetLevelHeight(mip - 1), srgb);
+                const std::span<const byte> actual = chain.GetLevel(mip);
+                ASSERT_EQ(actual.size(), expected.size());
+                EXPECT_TRUE(std::equal(actual.begin(), actual.end(), expected.begin()))
+                    << width << "x" << height << " mip " << mip << (srgb ? " srgb" : " unorm");
+                // 下一级从实现的输出继续, 让每级的比较彼此独立。
+                expected.assign(actual.begin(), actual.end());
+            }
+        }
+    }
+}
+
+TEST(MipChainTest, SrgbEncodeMatchesTheClosedForm) {
+    for (uint32_t code = 0; code < 256; ++code) {
+        EXPECT_EQ(LinearToSrgb8(Srgb8ToLinear(static_cast<uint8_t>(code))), code);
+    }
+    for (uint32_t i = 0; i <= 100'000; ++i) {
+        const double linear = i / 100'000.0;
+        EXPECT_EQ(LinearToSrgb8(static_cast<float>(linear)), ReferenceLinearToSrgb(static_cast<float>(linear))) << linear;
+    }
+    EXPECT_EQ(LinearToSrgb8(-1.0f), 0u);
+    EXPECT_EQ(LinearToSrgb8(2.0f), 255u);
+    EXPECT_EQ(LinearToSrgb8(std::nanf("")), 0u);
+}
+
+TEST(MipChainTest, ParallelBandsProduceIdenticalBytes) {
+    const vector<byte> pixels = MakeNoise(2048, 2048, 7);
+    for (const MipFilter filter : {MipFilter::Box, MipFilter::Kaiser}) {
+        const Rgba8MipChain serial = BuildRgba8MipChain(pixels, 2048, 2048, MipChainOptions{.Srgb = true, .Filter = filter});
+        const Rgba8MipChain parallel = BuildRgba8MipChain(
+            pixels,
+            2048,
+            2048,
+            MipChainOptions{.Srgb = true, .Filter = filter, .ParallelFor = ThreadParallelFor()});
+        ASSERT_EQ(serial.GetBytes().size(), parallel.GetBytes().size());
+        EXPECT_TRUE(std::equal(serial.GetBytes().begin(), serial.GetBytes().end(), parallel.GetBytes().begin()));
+    }
+}
+
+TEST(MipChainTest, KaiserKeepsFlatColorsFlat) {
+    const uint32_t width = 48;
+    const uint32_t height = 20;
+    vector<byte> pixels(size_t{width} * height * 4);
+    for (size_t i = 0; i < pixels.size(); i += 4) {
+        pixels[i + 0] = byte{200};
+        pixels[i + 1] = byte{17};
+        pixels[i + 2] = byte{96};
+        pixels[i + 3] = byte{128};
+    }
+    for (const bool srgb : {false, true}) {
+        const Rgba8MipChain chain = BuildRgba8MipChain(
+            pixels,
+            width,
+            height,
+            MipChainOptions{.Srgb = srgb, .Filter = MipFilter::Kaiser});
+        ASSERT_EQ(chain.GetLevelCount(), 6u);
+        for (uint32_t mip = 1; mip < chain.GetLevelCount(); ++mip) {
+            const std::span<const byte> level = chain.GetLevel(mip);
+            for (size_t i = 0; i < level.size(); i += 4) {
+                ASSERT_EQ(level[i + 0], byte{200}) << "mip " << mip;
+                ASSERT_EQ(level[i + 1], byte{17}) << "mip " << mip;
+                ASSERT_EQ(level[i + 2], byte{96}) << "mip " << mip;
+                ASSERT_EQ(level[i + 3], byte{128}) << "mip " << mip;
+            }
+        }
+    }
+}
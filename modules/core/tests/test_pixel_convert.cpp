@@ -0,0 +1,348 @@
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include <radray/pixel_convert.h>
+
+using namespace radray;
+
+namespace {
+
+constexpr ImageFormat kAllFormats[] = {
+    ImageFormat::R8_BYTE,
+    ImageFormat::R16_USHORT,
+    ImageFormat::R16_HALF,
+    ImageFormat::R32_FLOAT,
+    ImageFormat::RG8_BYTE,
+    ImageFormat::RG16_USHORT,
+    ImageFormat::RG16_HALF,
+    ImageFormat::RG32_FLOAT,
+    ImageFormat::RGB32_FLOAT,
+    ImageFormat::RGBA8_BYTE,
+    ImageFormat::RGBA16_USHORT,
+    ImageFormat::RGBA16_HALF,
+    ImageFormat::RGBA32_FLOAT,
+    ImageFormat::RGB8_BYTE,
+    ImageFormat::RGB16_USHORT};
+
+bool IsFloatFormat(ImageFormat format) {
+    return format == ImageFormat::R32_FLOAT || format == ImageFormat::RG32_FLOAT ||
+           format == ImageFormat::RGB32_FLOAT || format == ImageFormat::RGBA32_FLOAT;
+}
+
+bool IsHalfFormat(ImageFormat format) {
+    return format == ImageFormat::R16_HALF || format == ImageFormat::RG16_HALF || format == ImageFormat::RGBA16_HALF;
+}
+
+/// 随机像素。float 格式取 [-4, 4) 的有限值, half 格式取不含 NaN 的位模式, 以便逐字节比较。
+ImageData MakeNoiseImage(ImageFormat format, uint32_t width, uint32_t height, uint32_t seed) {
+    std::mt19937 random{seed};
+    ImageData image;
+    image.Width = width;
+    image.Height = height;
+    image.Format = format;
+    image.Data = make_unique<byte[]>(image.GetSize());
+    byte* data = image.Data.get();
+    const size_t size = image.GetSize();
+    if (IsFloatFormat(format)) {
+        std::uniform_real_distribution<float> dist{-4.0f, 4.0f};
+        for (size_t i = 0; i < size; i += 4) {
+            const float v = dist(random);
+            std::memcpy(data + i, &v, 4);
+        }
+    } else if (IsHalfFormat(format)) {
+        for (size_t i = 0; i < size; i += 2) {
+            uint16_t h = static_cast<uint16_t>(random());
+            if ((h & 0x7c00u) == 0x7c00u) {
+                h &= 0xbfffu;
+            }
+            std::memcpy(data + i, &h, 2);
+        }
+    } else {
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<byte>(random() & 0xff);
+        }
+    }
+    return image;
+}
+
+uint16_t ScalarFloatToHalf(float value) {
+    const float v = value;
+    uint16_t h{};
+    ConvertPixelsScalar(
+        ImageFormat::R32_FLOAT,
+        std::as_bytes(std::span{&v, 1}),
+        ImageFormat::R16_HALF,
+        std::as_writable_bytes(std::span{&h, 1}),
+        1,
+        1);
+    return h;
+}
+
+float ScalarHalfToFloat(uint16_t value) {
+    const uint16_t h = value;
+    float f{};
+    ConvertPixelsScalar(
+        ImageFormat::R16_HALF,
+        std::as_bytes(std::span{&h, 1}),
+        ImageFormat::R32_FLOAT,
+        std::as_writable_bytes(std::span{&f, 1}),
+        1,
+        1);
+    return f;
+}
+
+}  // namespace
+
+TEST(PixelConvertTest, SupportedPairs) {
+    EXPECT_TRUE(IsPixelConversionSupported(ImageFormat::RGB8_BYTE, ImageFormat::RGBA8_BYTE));
+    EXPECT_TRUE(IsPixelConversionSupported(ImageFormat::R8_BYTE, ImageFormat::RGBA8_BYTE));
+    EXPECT_TRUE(IsPixelConversionSupported(ImageFormat::RG8_BYTE, ImageFormat::RGBA8_BYTE));
+    EXPECT_TRUE(IsPixelConversionSupported(ImageFormat::RGB16_USHORT, ImageFormat::RGB8_BYTE));
+    EXPECT_TRUE(IsPixelConversionSupported(ImageFormat::R16_USHORT, ImageFormat::RGBA8_BYTE));
+    EXPECT_TRUE(IsPixelConversionSupported(ImageFormat::RGBA16_HALF, ImageFormat::RGBA32_FLOAT));
+    EXPECT_TRUE(IsPixelConversionSupported(ImageFormat::RG32_FLOAT, ImageFormat::RG16_HALF));
+    EXPECT_TRUE(IsPixelConversionSupported(ImageFormat::RGB32_FLOAT, ImageFormat::RGB32_FLOAT));
+    EXPECT_TRUE(IsPixelConversionSupported(ImageFormat::RGBA8_BYTE, ImageFormat::RGBA8_BYTE, true));
+
+    EXPECT_FALSE(IsPixelConversionSupported(ImageFormat::RGBA8_BYTE, ImageFormat::RGB8_BYTE));
+    EXPECT_FALSE(IsPixelConversionSupported(ImageFormat::R16_HALF, ImageFormat::RGBA8_BYTE));
+    EXPECT_FALSE(IsPixelConversionSupported(ImageFormat::RGBA16_HALF, ImageFormat::R32_FLOAT));
+    EXPECT_FALSE(IsPixelConversionSupported(ImageFormat::RGB32_FLOAT, ImageFormat::RGBA16_HALF));
+    EXPECT_FALSE(IsPixelConversionSupported(ImageFormat::RGB8_BYTE, ImageFormat::RGB8_BYTE, true));
+}
+
+TEST(PixelConvertTest, SimdMatchesScalarForEveryPair) {
+    // 宽度覆盖各 kernel 的块宽与尾部, 以及多于一个分块的行。
+    const uint32_t widths[] = {1, 3, 5, 7, 15, 16, 17, 33, 600};
+    uint32_t seed = 1;
+    for (ImageFormat from : kAllFormats) {
+        for (ImageFormat to : kAllFormats) {
+            for (bool premultiply : {false, true}) {
+                if (!IsPixelConversionSupported(from, to, premultiply)) {
+                    continue;
+                }
+                for (uint32_t width : widths) {
+                    for (bool flip : {false, true}) {
+                        const uint32_t height = 3;
+                        const ImageData src = MakeNoiseImage(from, width, height, seed++);
+                        const size_t dstSize = ImageData::FormatSize(to) * width * height;
+                        vector<byte> expected(dstSize);
+                        vector<byte> actual(dstSize);
+                        const PixelConvertOptions options{.FlipY = flip, .PremultiplyAlpha = premultiply, .Alpha = 0x7f};
+                        ASSERT_TRUE(ConvertPixelsScalar(from, src.GetSpan(), to, expected, width, height, options));
+                        ASSERT_TRUE(ConvertPixels(from, src.GetSpan(), to, actual, width, height, options));
+                        EXPECT_EQ(expected, actual)
+                            << "from " << static_cast<int>(from) << " to " << static_cast<int>(to)
+                            << " width " << width << " flip " << flip << " premultiply " << premultiply;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(PixelConvertTest, ExpandsToRgba8WithFlip) {
+    // 2x2, 行 0: (1,2,3) (4,5,6), 行 1: (7,8,9) (10,11,12)。
+    const uint8_t rgb[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    uint8_t rgba[16]{};
+    ASSERT_TRUE(ConvertPixels(
+        ImageFormat::RGB8_BYTE,
+        std::as_bytes(std::span{rgb}),
+        ImageFormat::RGBA8_BYTE,
+        std::as_writable_bytes(std::span{rgba}),
+        2,
+        2,
+        {.FlipY = true, .Alpha = 200}));
+    const uint8_t expected[] = {7, 8, 9, 200, 10, 11, 12, 200, 1, 2, 3, 200, 4, 5, 6, 200};
+    EXPECT_EQ(std::memcmp(rgba, expected, sizeof(expected)), 0);
+
+    const uint8_t gray[] = {10, 20};
+    ASSERT_TRUE(ConvertPixels(
+        ImageFormat::R8_BYTE,
+        std::as_bytes(std::span{gray}),
+        ImageFormat::RGBA8_BYTE,
+        std::as_writable_bytes(std::span{rgba}).first(8),
+        2,
+        1));
+    const uint8_t expectedGray[] = {10, 10, 10, 255, 20, 20, 20, 255};
+    EXPECT_EQ(std::memcmp(rgba, expectedGray, sizeof(expectedGray)), 0);
+
+    const uint8_t grayAlpha[] = {10, 1, 20, 2};
+    ASSERT_TRUE(ConvertPixels(
+        ImageFormat::RG8_BYTE,
+        std::as_bytes(std::span{grayAlpha}),
+        ImageFormat::RGBA8_BYTE,
+        std::as_writable_bytes(std::span{rgba}).first(8),
+        2,
+        1));
+    const uint8_t expectedGrayAlpha[] = {10, 10, 10, 1, 20, 20, 20, 2};
+    EXPECT_EQ(std::memcmp(rgba, expectedGrayAlpha, sizeof(expectedGrayAlpha)), 0);
+
+    // 缓冲不够大时不动目标。
+    EXPECT_FALSE(ConvertPixels(
+        ImageFormat::RGB8_BYTE,
+        std::as_bytes(std::span{rgb}),
+        ImageFormat::RGBA8_BYTE,
+        std::as_writable_bytes(std::span{rgba}).first(15),
+        2,
+        2));
+}
+
+TEST(PixelConvertTest, NarrowsSixteenBitWithExactRounding) {
+    vector<uint16_t> values(65536);
+    for (uint32_t v = 0; v < 65536; ++v) {
+        values[v] = static_cast<uint16_t>(v);
+    }
+    vector<uint8_t> narrowed(values.size());
+    ASSERT_TRUE(ConvertPixels(
+        ImageFormat::R16_USHORT,
+        std::as_bytes(std::span{values}),
+        ImageFormat::R8_BYTE,
+        std::as_writable_bytes(std::span{narrowed}),
+        256,
+        256));
+    for (uint32_t v = 0; v < 65536; ++v) {
+        ASSERT_EQ(narrowed[v], static_cast<uint8_t>(std::lround(v * 255.0 / 65535.0))) << v;
+    }
+}
+
+TEST(PixelConvertTest, HalfFloatRoundTrip) {
+    // 每个非 NaN 的 half 展开再收回都不变, 且与 ConvertPixelsScalar 的 R16_HALF 转换逐位一致。
+    for (uint32_t h = 0; h < 65536; ++h) {
+        const float f = HalfToFloat(static_cast<uint16_t>(h));
+        if ((h & 0x7c00u) == 0x7c00u && (h & 0x03ffu) != 0) {
+            EXPECT_TRUE(std::isnan(f));
+            EXPECT_TRUE(std::isnan(ScalarHalfToFloat(static_cast<uint16_t>(h))));
+            continue;
+        }
+        ASSERT_EQ(f, ScalarHalfToFloat(static_cast<uint16_t>(h))) << h;
+        ASSERT_EQ(FloatToHalf(f), h) << h;
+        ASSERT_EQ(ScalarFloatToHalf(f), h) << h;
+    }
+    EXPECT_EQ(HalfToFloat(0x3c00), 1.0f);
+    EXPECT_EQ(HalfToFloat(0xc000), -2.0f);
+    EXPECT_EQ(HalfToFloat(0x0001), std::ldexp(1.0f, -24));
+    EXPECT_EQ(HalfToFloat(0x7c00), std::numeric_limits<float>::infinity());
+
+    // 舍入: 就近到偶数, 超出范围变 inf, 过小变 0。
+    EXPECT_EQ(FloatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3c00);
+    EXPECT_EQ(FloatToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)), 0x3c02);
+    EXPECT_EQ(FloatToHalf(65504.0f), 0x7bff);
+    EXPECT_EQ(FloatToHalf(65520.0f), 0x7c00);
+    EXPECT_EQ(FloatToHalf(-1.0e10f), 0xfc00);
+    EXPECT_EQ(FloatToHalf(std::ldexp(1.0f, -26)), 0x0000);
+    EXPECT_EQ(FloatToHalf(3.0f * std::ldexp(1.0f, -26)), 0x0001);
+    const uint16_t nan = FloatToHalf(std::numeric_limits<float>::quiet_NaN());
+    EXPECT_EQ(nan & 0x7c00u, 0x7c00u);
+    EXPECT_NE(nan & 0x03ffu, 0u);
+    for (float v : {1.0f + std::ldexp(1.0f, -11), 65520.0f, -1.0e10f, 3.0f * std::ldexp(1.0f, -26), 0.1f, -0.0f}) {
+        EXPECT_EQ(FloatToHalf(v), ScalarFloatToHalf(v)) << v;
+    }
+}
+
+TEST(PixelConvertTest, PremultipliesColorButNotAlpha) {
+    const uint8_t rgba[] = {255, 128, 0, 128, 200, 100, 50, 0, 200, 100, 50, 255};
+    uint8_t out[12]{};
+    ASSERT_TRUE(ConvertPixels(
+        ImageFormat::RGBA8_BYTE,
+        std::as_bytes(std::span{rgba}),
+        ImageFormat::RGBA8_BYTE,
+        std::as_writable_bytes(std::span{out}),
+        3,
+        1,
+        {.PremultiplyAlpha = true}));
+    const uint8_t expected[] = {128, 64, 0, 128, 0, 0, 0, 0, 200, 100, 50, 255};
+    EXPECT_EQ(std::memcmp(out, expected, sizeof(expected)), 0);
+
+    // 全部 (c, a) 组合都是 round(c * a / 255)。
+    vector<uint8_t> all(256 * 256 * 4);
+    for (uint32_t c = 0; c < 256; ++c) {
+        for (uint32_t a = 0; a < 256; ++a) {
+            uint8_t* p = all.data() + (c * 256 + a) * 4;
+            p[0] = p[1] = p[2] = static_cast<uint8_t>(c);
+            p[3] = static_cast<uint8_t>(a);
+        }
+    }
+    ImageData image;
+    image.Width = 256;
+    image.Height = 256;
+    image.Format = ImageFormat::RGBA8_BYTE;
+    image.Data = make_unique<byte[]>(all.size());
+    std::memcpy(image.Data.get(), all.data(), all.size());
+    ASSERT_TRUE(ConvertImageInPlace(image, ImageFormat::RGBA8_BYTE, {.PremultiplyAlpha = true}));
+    const uint8_t* result = reinterpret_cast<const uint8_t*>(image.Data.get());
+    for (uint32_t c = 0; c < 256; ++c) {
+        for (uint32_t a = 0; a < 256; ++a) {
+            const uint8_t* p = result + (c * 256 + a) * 4;
+            ASSERT_EQ(p[0], static_cast<uint8_t>(std::lround(c * a / 255.0))) << c << " " << a;
+            ASSERT_EQ(p[3], a);
+        }
+    }
+
+    const float rgbaFloat[] = {0.5f, 1.0f, 2.0f, 0.25f};
+    float outFloat[4]{};
+    ASSERT_TRUE(ConvertPixels(
+        ImageFormat::RGBA32_FLOAT,
+        std::as_bytes(std::span{rgbaFloat}),
+        ImageFormat::RGBA32_FLOAT,
+        std::as_writable_bytes(std::span{outFloat}),
+        1,
+        1,
+        {.PremultiplyAlpha = true}));
+    EXPECT_EQ(outFloat[0], 0.125f);
+    EXPECT_EQ(outFloat[1], 0.25f);
+    EXPECT_EQ(outFloat[2], 0.5f);
+    EXPECT_EQ(outFloat[3], 0.25f);
+}
+
+TEST(PixelConvertTest, InPlaceMatchesOutOfPlace) {
+    const std::pair<ImageFormat, ImageFormat> pairs[] = {
+        {ImageFormat::RGBA8_BYTE, ImageFormat::RGBA8_BYTE},      // 同尺寸
+        {ImageFormat::RG16_USHORT, ImageFormat::RGBA8_BYTE},     // 同尺寸, 两步
+        {ImageFormat::RGB16_USHORT, ImageFormat::RGBA8_BYTE},    // 收窄, 两步
+        {ImageFormat::RGBA16_USHORT, ImageFormat::RGBA8_BYTE},   // 收窄
+        {ImageFormat::RGBA32_FLOAT, ImageFormat::RGBA16_HALF},   // 收窄
+        {ImageFormat::RGB8_BYTE, ImageFormat::RGBA8_BYTE},       // 扩展, 另分配
+        {ImageFormat::RG16_HALF, ImageFormat::RG32_FLOAT}};      // 扩展, 另分配
+    uint32_t seed = 100;
+    for (const auto& [from, to] : pairs) {
+        for (uint32_t height : {1u, 4u, 5u}) {
+            for (bool flip : {false, true}) {
+                const PixelConvertOptions options{.FlipY = flip, .PremultiplyAlpha = to != ImageFormat::RG32_FLOAT};
+                const ImageData src = MakeNoiseImage(from, 37, height, seed++);
+                const ImageData expected = ConvertImage(src, to, options);
+                ASSERT_EQ(expected.Format, to);
+                ImageData actual = src;
+                ASSERT_TRUE(ConvertImageInPlace(actual, to, options));
+                ASSERT_EQ(actual.Format, to);
+                ASSERT_EQ(actual.GetSize(), expected.GetSize());
+                EXPECT_EQ(std::memcmp(actual.Data.get(), expected.Data.get(), expected.GetSize()), 0)
+                    << static_cast<int>(from) << " -> " << static_cast<int>(to) << " height " << height << " flip " << flip;
+            }
+        }
+    }
+
+    ImageData unsupported = MakeNoiseImage(ImageFormat::RGBA8_BYTE, 4, 4, 7);
+    EXPECT_FALSE(ConvertImageInPlace(unsupported, ImageFormat::R8_BYTE));
+    EXPECT_EQ(unsupported.Format, ImageFormat::RGBA8_BYTE);
+    EXPECT_EQ(ConvertImage(unsupported, ImageFormat::R8_BYTE).Data, nullptr);
+}
+
+TEST(PixelConvertTest, Rgb8ToRgba8MatchesConvertPixels) {
+    const ImageData src = MakeNoiseImage(ImageFormat::RGB8_BYTE, 19, 7, 42);
+    const ImageData viaImage = src.RGB8ToRGBA8(0x40);
+    ASSERT_EQ(viaImage.Format, ImageFormat::RGBA8_BYTE);
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(src.Data.get());
+    const uint8_t* d = reinterpret_cast<const uint8_t*>(viaImage.Data.get());
+    for (size_t i = 0; i < size_t{19} * 7; ++i) {
+        ASSERT_EQ(d[i * 4 + 0], s[i * 3 + 0]);
+        ASSERT_EQ(d[i * 4 + 1], s[i * 3 + 1]);
+        ASSERT_EQ(d[i * 4 + 2], s[i * 3 + 2]);
+        ASSERT_EQ(d[i * 4 + 3], 0x40);
+    }
+}
@@ -105,3 +105,20 @@ TEST(HashCodeTest, StaticCombineMatchesIncrementalHash) {
         radray::HashCode::Combine(size_t{0x12345678}, size_t{0x9abcdef0}),
         hash.ToHashCode());
 }
+
+TEST(HashStream64Test, ChunkedUpdatesMatchOneShotHash) {
+    char data[1000];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = static_cast<char>(i * 131 + 7);
+    }
+    // 分段跨过 XXH64 的 32 字节条带边界, 也包含空段。
+    radray::HashStream64 stream;
+    size_t offset = 0;
+    for (size_t chunk : {0, 1, 31, 33, 64, 0, 871}) {
+        stream.Update(data + offset, chunk);
+        offset += chunk;
+    }
+    ASSERT_EQ(offset, sizeof(data));
+    EXPECT_EQ(stream.GetDigest(), radray::HashData64(data, sizeof(data)));
+    EXPECT_EQ(radray::HashStream64{}.GetDigest(), radray::HashData64(nullptr, 0));
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <string_view>
+#include <thread>
+
+#include <radray/json.h>
+#include <radray/profiler.h>
+
+using namespace radray;
+
+#if defined(RADRAY_ENABLE_PROFILER)
+
+namespace {
+
+size_t CountEvents(JsonValue events, std::string_view phase, std::string_view name) {
+    size_t count = 0;
+    for (size_t i = 0; i < events.Size(); ++i) {
+        JsonValue event = events.At(i);
+        if (event["ph"].AsString() == phase && event["name"].AsString() == name) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST(ProfilerTest, ScopesOutsideCaptureRecordNothing) {
+    BeginProfileCapture();
+    EndProfileCapture();
+    {
+        RADRAY_PROFILE_SCOPE("Ignored");
+    }
+    RADRAY_PROFILE_COUNTER("IgnoredCounter", 1);
+    EXPECT_EQ(GetProfileCaptureStats().EventCount, 0u);
+}
+
+TEST(ProfilerTest, ExportsZonesFramesAndCountersAsChromeTrace) {
+    BeginProfileCapture();
+    RADRAY_PROFILE_THREAD_NAME("TestMain");
+    for (int frame = 0; frame < 3; ++frame) {
+        RADRAY_PROFILE_SCOPE("Frame");
+        {
+            RADRAY_PROFILE_SCOPE("Inner");
+        }
+        RADRAY_PROFILE_COUNTER("DrawCount", frame * 10);
+        RADRAY_PROFILE_FRAME("Frame");
+    }
+    std::thread worker{[]() {
+        RADRAY_PROFILE_THREAD_NAME("TestWorker");
+        RADRAY_PROFILE_SCOPE("Worker");
+    }};
+    worker.join();
+    EndProfileCapture();
+
+    const ProfileCaptureStats stats = GetProfileCaptureStats();
+    EXPECT_EQ(stats.EventCount, 3u * 4u + 1u);
+    EXPECT_EQ(stats.DroppedEventCount, 0u);
+    EXPECT_GE(stats.ThreadCount, 2u);
+
+    JsonWriter writer{};
+    ASSERT_TRUE(WriteProfileChromeTrace(writer));
+    std::optional<string> text = writer.Write(false);
+    ASSERT_TRUE(text.has_value());
+    std::optional<JsonDocument> doc = JsonDocument::Parse(*text);
+    ASSERT_TRUE(doc.has_value());
+    JsonValue events = doc->Root()["traceEvents"];
+    ASSERT_TRUE(events.IsArray());
+    EXPECT_EQ(CountEvents(events, "X", "Frame"), 3u);
+    EXPECT_EQ(CountEvents(events, "X", "Inner"), 3u);
+    EXPECT_EQ(CountEvents(events, "X", "Worker"), 1u);
+    EXPECT_EQ(CountEvents(events, "i", "Frame"), 3u);
+    EXPECT_EQ(CountEvents(events, "C", "DrawCount"), 3u);
+    EXPECT_EQ(CountEvents(events, "M", "thread_name"), 2u);
+}
+
+TEST(ProfilerTest, DropsEventsPastThePerThreadLimit) {
+    BeginProfileCapture({.MaxEventsPerThread = 8});
+    for (int i = 0; i < 20; ++i) {
+        RADRAY_PROFILE_SCOPE("Spam");
+    }
+    EndProfileCapture();
+    const ProfileCaptureStats stats = GetProfileCaptureStats();
+    EXPECT_EQ(stats.EventCount, 8u);
+    EXPECT_EQ(stats.DroppedEventCount, 12u);
+}
+
+TEST(ProfilerTest, SpansChunksWithoutLosingEvents) {
+    BeginProfileCapture();
+    constexpr int kEvents = 10000;
+    for (int i = 0; i < kEvents; ++i) {
+        RADRAY_PROFILE_SCOPE("Many");
+    }
+    EndProfileCapture();
+    EXPECT_EQ(GetProfileCaptureStats().EventCount, static_cast<uint64_t>(kEvents));
+}
+
+TEST(ProfilerTest, ExitedThreadsHandTheirBuffersOn) {
+    BeginProfileCapture();
+    constexpr int kThreads = 64;
+    for (int i = 0; i < kThreads; ++i) {
+        std::thread worker{[]() {
+            RADRAY_PROFILE_SCOPE("ShortLived");
+        }};
+        worker.join();
+    }
+    // 依次退出的线程续用同一块缓冲, 事件都还在。
+    const ProfileCaptureStats stats = GetProfileCaptureStats();
+    EXPECT_EQ(stats.EventCount, static_cast<uint64_t>(kThreads));
+    EXPECT_EQ(stats.ThreadCount, 1u);
+
+    BeginProfileCapture();
+    std::thread worker{[]() {
+        RADRAY_PROFILE_THREAD_NAME("Reused");
+        RADRAY_PROFILE_SCOPE("NextCapture");
+    }};
+    worker.join();
+    EndProfileCapture();
+    const ProfileCaptureStats next = GetProfileCaptureStats();
+    EXPECT_EQ(next.EventCount, 1u);
+    EXPECT_EQ(next.ThreadCount, 1u);
+}
+
+#else
+
+TEST(ProfilerTest, CompiledOut) {
+    RADRAY_PROFILE_SCOPE("Ignored");
+    RADRAY_PROFILE_FRAME("Frame");
+    RADRAY_PROFILE_COUNTER("Counter", 1);
+    EXPECT_FALSE(IsProfileCapturing());
+}
+
+#endif
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <span>
+#include <stdexcept>
+
+#include <radray/small_vector.h>
+
+using namespace radray;
+
+namespace {
+
+struct Tracked {
+    static inline int Alive = 0;
+
+    explicit Tracked(int value) noexcept : Value(value) { ++Alive; }
+    Tracked(const Tracked& other) noexcept : Value(other.Value) { ++Alive; }
+    Tracked(Tracked&& other) noexcept : Value(other.Value) { ++Alive; }
+    Tracked& operator=(const Tracked&) noexcept = default;
+    Tracked& operator=(Tracked&&) noexcept = default;
+    ~Tracked() noexcept { --Alive; }
+
+    int Value;
+};
+
+/// 第 ThrowAfter 次拷贝时抛异常；移动不是 noexcept，扩容时应退回拷贝。
+struct ThrowingCopy {
+    static inline int Alive = 0;
+    static inline int CopiesLeft = -1;
+
+    explicit ThrowingCopy(int value) noexcept : Value(value) { ++Alive; }
+    ThrowingCopy(const ThrowingCopy& other) : Value(other.Value) {
+        if (CopiesLeft == 0) {
+            throw std::runtime_error("copy");
+        }
+        --CopiesLeft;
+        ++Alive;
+    }
+    ThrowingCopy(ThrowingCopy&& other) : Value(other.Value) {
+        other.Value = -1;
+        ++Alive;
+    }
+    ~ThrowingCopy() noexcept { --Alive; }
+
+    int Value;
+};
+
+int Sum(std::span<const int> values) noexcept {
+    int sum = 0;
+    for (const int value : values) {
+        sum += value;
+    }
+    return sum;
+}
+
+}  // namespace
+
+TEST(SmallVectorTest, StaysInlineUpToCapacity) {
+    SmallVector<int, 4> values;
+    EXPECT_TRUE(values.empty());
+    EXPECT_TRUE(values.is_inline());
+    EXPECT_EQ(values.capacity(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        values.push_back(i);
+    }
+    EXPECT_TRUE(values.is_inline());
+    EXPECT_EQ(values.size(), 4u);
+    EXPECT_EQ(Sum(values), 0 + 1 + 2 + 3);
+
+    values.push_back(4);
+    EXPECT_FALSE(values.is_inline());
+    EXPECT_GE(values.capacity(), 5u);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(values[i], i);
+    }
+}
+
+TEST(SmallVectorTest, PushBackOwnElementWhileGrowing) {
+    SmallVector<string, 2> values{"alpha", "beta"};
+    values.push_back(values.front());
+    ASSERT_EQ(values.size(), 3u);
+    EXPECT_EQ(values[2], "alpha");
+}
+
+TEST(SmallVectorTest, CopyAndMovePreserveContents) {
+    SmallVector<int, 2> inlineValues{1, 2};
+    SmallVector<int, 2> heapValues{1, 2, 3, 4};
+
+    SmallVector<int, 2> inlineCopy = inlineValues;
+    SmallVector<int, 2> heapCopy = heapValues;
+    EXPECT_EQ(inlineCopy, inlineValues);
+    EXPECT_EQ(heapCopy, heapValues);
+
+    const int* heapStorage = heapValues.data();
+    SmallVector<int, 2> heapMoved = std::move(heapValues);
+    EXPECT_EQ(heapMoved.data(), heapStorage);
+    EXPECT_TRUE(heapValues.empty());
+    EXPECT_TRUE(heapValues.is_inline());
+
+    SmallVector<int, 2> inlineMoved = std::move(inlineValues);
+    EXPECT_TRUE(inlineMoved.is_inline());
+    EXPECT_EQ(inlineMoved, inlineCopy);
+
+    inlineMoved = heapCopy;
+    EXPECT_EQ(inlineMoved, heapCopy);
+    inlineMoved = {7};
+    ASSERT_EQ(inlineMoved.size(), 1u);
+    EXPECT_EQ(inlineMoved[0], 7);
+}
+
+TEST(SmallVectorTest, EraseInsertAndResize) {
+    SmallVector<int, 4> values{0, 1, 2, 3};
+    values.erase(values.begin() + 1);
+    EXPECT_EQ(values, (SmallVector<int, 4>{0, 2, 3}));
+
+    values.insert(values.begin(), -1);
+    EXPECT_EQ(values, (SmallVector<int, 4>{-1, 0, 2, 3}));
+
+    values.erase(values.begin(), values.begin() + 2);
+    EXPECT_EQ(values, (SmallVector<int, 4>{2, 3}));
+
+    values.resize(6, 9);
+    EXPECT_EQ(values, (SmallVector<int, 4>{2, 3, 9, 9, 9, 9}));
+    values.resize(1);
+    EXPECT_EQ(values, (SmallVector<int, 4>{2}));
+}
+
+TEST(SmallVectorTest, DestroysEveryElement) {
+    {
+        SmallVector<Tracked, 2> values;
+        for (int i = 0; i < 8; ++i) {
+            values.emplace_back(i);
+        }
+        values.pop_back();
+        values.erase(values.begin());
+        EXPECT_EQ(Tracked::Alive, 6);
+
+        SmallVector<Tracked, 2> moved = std::move(values);
+        EXPECT_EQ(Tracked::Alive, 6);
+        moved.clear();
+        EXPECT_EQ(Tracked::Alive, 0);
+        moved.emplace_back(1);
+    }
+    EXPECT_EQ(Tracked::Alive, 0);
+}
+
+TEST(SmallVectorTest, HoldsMoveOnlyValues) {
+    SmallVector<std::unique_ptr<int>, 1> values;
+    values.push_back(std::make_unique<int>(1));
+    values.push_back(std::make_unique<int>(2));
+    ASSERT_EQ(values.size(), 2u);
+    EXPECT_EQ(*values[0], 1);
+    EXPECT_EQ(*values[1], 2);
+}
+
+TEST(SmallVectorTest, GrowthIsExceptionSafe) {
+    {
+        SmallVector<ThrowingCopy, 2> values;
+        values.emplace_back(1);
+        values.emplace_back(2);
+        const ThrowingCopy extra{3};
+
+        // 新元素的构造抛异常: 容器不变, 新块已释放 (ASan 下检查泄漏)。
+        ThrowingCopy::CopiesLeft = 0;
+        EXPECT_THROW(values.push_back(extra), std::runtime_error);
+        ASSERT_EQ(values.size(), 2u);
+        EXPECT_TRUE(values.is_inline());
+
+        // 搬旧元素时抛异常: 已构造的新元素与已拷贝的部分都析构, 旧元素没有被移走。
+        ThrowingCopy::CopiesLeft = 2;
+        EXPECT_THROW(values.push_back(extra), std::runtime_error);
+        ASSERT_EQ(values.size(), 2u);
+        EXPECT_EQ(values[0].Value, 1);
+        EXPECT_EQ(values[1].Value, 2);
+        EXPECT_THROW(values.reserve(8), std::runtime_error);
+        EXPECT_EQ(values.capacity(), 2u);
+        EXPECT_EQ(ThrowingCopy::Alive, 3);
+
+        ThrowingCopy::CopiesLeft = -1;
+        values.push_back(extra);
+        ASSERT_EQ(values.size(), 3u);
+        EXPECT_FALSE(values.is_inline());
+        EXPECT_EQ(values[0].Value, 1);
+        EXPECT_EQ(values[2].Value, 3);
+    }
+    EXPECT_EQ(ThrowingCopy::Alive, 0);
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include <radray/pixel_convert.h>
+#include <radray/triangle_mesh.h>
+#include <radray/vertex_data.h>
+
+using namespace radray;
+
+namespace {
+
+const VertexBufferEntry* FindEntry(const MeshPrimitive& primitive, std::string_view semantic) {
+    const auto found = std::find_if(
+        primitive.VertexBuffers.begin(),
+        primitive.VertexBuffers.end(),
+        [&](const VertexBufferEntry& entry) { return entry.Semantic == semantic; });
+    return found == primitive.VertexBuffers.end() ? nullptr : &*found;
+}
+
+Eigen::Vector4f ReadEntry(const MeshResource& resource, const VertexBufferEntry& entry, size_t vertex) {
+    const std::span<const byte> data = resource.Bins[entry.BufferIndex].GetData();
+    return DecodeVertexData(entry.Type, entry.ComponentCount, data.data() + entry.Offset + vertex * entry.Stride);
+}
+
+float AngleBetween(const Eigen::Vector3f& a, const Eigen::Vector3f& b) {
+    return std::atan2(a.cross(b).norm(), a.dot(b));
+}
+
+/// 半径 3、圆心不在原点的 UV 球, 带切线与顶点色。
+TriangleMesh MakeTestSphere() {
+    TriangleMesh mesh;
+    mesh.InitAsUVSphere(3.0f, 64);
+    mesh.CalculateTangent();
+    for (Eigen::Vector3f& position : mesh.Positions) {
+        position += Eigen::Vector3f{10.0f, -5.0f, 2.5f};
+    }
+    // 球的 UV 是 i / 64, half 能精确表示; 挪一下让它们落在 half 的格点之间。
+    for (Eigen::Vector2f& uv : mesh.UV0) {
+        uv = uv * 0.9f + Eigen::Vector2f::Constant(0.05f);
+    }
+    for (const Eigen::Vector3f& normal : mesh.Normals) {
+        mesh.Color0.emplace_back(normal.x() * 0.5f + 0.5f, normal.y() * 0.5f + 0.5f, normal.z() * 0.5f + 0.5f, 1.0f);
+    }
+    return mesh;
+}
+
+}  // namespace
+
+TEST(Core_VertexQuantization, DecodeVertexDataMapsEachType) {
+    const int8_t snorm8[]{127, -128, 0, -127};
+    EXPECT_EQ(DecodeVertexData(VertexDataType::SNORM8, 4, reinterpret_cast<const byte*>(snorm8)), Eigen::Vector4f(1.0f, -1.0f, 0.0f, -1.0f));
+    const uint8_t unorm8[]{255, 0, 51, 0};
+    EXPECT_EQ(DecodeVertexData(VertexDataType::UNORM8, 2, reinterpret_cast<const byte*>(unorm8)), Eigen::Vector4f(1.0f, 0.0f, 0.0f, 0.0f));
+    const int16_t snorm16[]{-32768, 32767};
+    EXPECT_EQ(DecodeVertexData(VertexDataType::SNORM16, 2, reinterpret_cast<const byte*>(snorm16)), Eigen::Vector4f(-1.0f, 1.0f, 0.0f, 0.0f));
+    const uint16_t unorm16[]{65535, 0, 0, 65535};
+    EXPECT_EQ(DecodeVertexData(VertexDataType::UNORM16, 4, reinterpret_cast<const byte*>(unorm16)), Eigen::Vector4f(1.0f, 0.0f, 0.0f, 1.0f));
+    const uint16_t half[]{FloatToHalf(0.5f), FloatToHalf(-2.0f)};
+    EXPECT_EQ(DecodeVertexData(VertexDataType::HALF, 2, reinterpret_cast<const byte*>(half)), Eigen::Vector4f(0.5f, -2.0f, 0.0f, 0.0f));
+    const uint32_t packed = 1023u | (0u << 10) | (341u << 20) | (3u << 30);
+    const Eigen::Vector4f unpacked = DecodeVertexData(VertexDataType::UNORM10_10_10_2, 4, reinterpret_cast<const byte*>(&packed));
+    EXPECT_FLOAT_EQ(unpacked.x(), 1.0f);
+    EXPECT_FLOAT_EQ(unpacked.y(), 0.0f);
+    EXPECT_FLOAT_EQ(unpacked.z(), 341.0f / 1023.0f);
+    EXPECT_FLOAT_EQ(unpacked.w(), 1.0f);
+    // 打包格式只能是 4 分量。
+    EXPECT_EQ(GetVertexDataSizeInBytes(VertexDataType::UNORM10_10_10_2, 3), 0u);
+    EXPECT_EQ(DecodeVertexData(VertexDataType::UNORM10_10_10_2, 3, reinterpret_cast<const byte*>(&packed)), Eigen::Vector4f::Zero());
+    EXPECT_EQ(GetVertexDataSizeInBytes(VertexDataType::HALF, 3), 6u);
+    EXPECT_EQ(GetVertexDataSizeInBytes(VertexDataType::UNORM8, 4), 4u);
+}
+
+TEST(Core_VertexQuantization, OctahedralRoundTrip) {
+    std::mt19937 random{7};
+    std::normal_distribution<float> gaussian;
+    float worst = 0.0f;
+    for (int i = 0; i < 10000; i++) {
+        const Eigen::Vector3f direction = Eigen::Vector3f{gaussian(random), gaussian(random), gaussian(random)}.normalized();
+        const Eigen::Vector2f encoded = OctahedralEncode(direction);
+        ASSERT_LE(encoded.cwiseAbs().maxCoeff(), 1.0f);
+        worst = std::max(worst, AngleBetween(direction, OctahedralDecode(encoded)));
+    }
+    EXPECT_LT(worst, 1e-5f);
+    // 坐标轴与零向量。
+    const Eigen::Vector3f axes[]{{1.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}};
+    for (const Eigen::Vector3f& axis : axes) {
+        EXPECT_TRUE(OctahedralDecode(OctahedralEncode(axis)).isApprox(axis, 1e-6f));
+    }
+    EXPECT_EQ(OctahedralEncode(Eigen::Vector3f::Zero()), Eigen::Vector2f::Zero());
+}
+
+TEST(Core_VertexQuantization, QuantizedMeshHalvesVertexBytesWithinErrorBounds) {
+    const TriangleMesh mesh = MakeTestSphere();
+    MeshResource simple;
+    MeshResource quantized;
+    mesh.ToSimpleMeshResource(&simple);
+    mesh.ToQuantizedMeshResource(&quantized);
+    ASSERT_EQ(quantized.Primitives.size(), 1u);
+    ASSERT_EQ(quantized.Bins.size(), 2u);
+    const MeshPrimitive& primitive = quantized.Primitives[0];
+    ASSERT_EQ(primitive.VertexCount, mesh.Positions.size());
+
+    // 全部五个属性: 64 -> 24 字节; 顶点少于 65536 个, 索引也减半。
+    const float vertexRatio = static_cast<float>(simple.Bins[0].GetSize()) / static_cast<float>(quantized.Bins[0].GetSize());
+    const float totalRatio = static_cast<float>(simple.Bins[0].GetSize() + simple.Bins[1].GetSize()) /
+                             static_cast<float>(quantized.Bins[0].GetSize() + quantized.Bins[1].GetSize());
+    RecordProperty("VertexByteRatio", std::to_string(vertexRatio));
+    RecordProperty("TotalByteRatio", std::to_string(totalRatio));
+    EXPECT_EQ(primitive.VertexBuffers[0].Stride, 24u);
+    EXPECT_GE(vertexRatio, 2.0f);
+    EXPECT_GE(totalRatio, 2.0f);
+    EXPECT_EQ(primitive.IndexBuffer.Stride, sizeof(uint16_t));
+    ASSERT_EQ(primitive.IndexBuffer.IndexCount, mesh.Indices.size());
+    for (size_t i = 0; i < mesh.Indices.size(); i++) {
+        uint16_t index;
+        std::memcpy(&index, quantized.Bins[1].GetData().data() + i * sizeof(index), sizeof(index));
+        ASSERT_EQ(index, mesh.Indices[i]);
+    }
+
+    const VertexBufferEntry* position = FindEntry(primitive, VertexSemantics::POSITION);
+    const VertexBufferEntry* normal = FindEntry(primitive, VertexSemantics::NORMAL);
+    const VertexBufferEntry* uv = FindEntry(primitive, VertexSemantics::TEXCOORD);
+    const VertexBufferEntry* tangent = FindEntry(primitive, VertexSemantics::TANGENT);
+    const VertexBufferEntry* color = FindEntry(primitive, VertexSemantics::COLOR);
+    ASSERT_TRUE(position && normal && uv && tangent && color);
+    EXPECT_EQ(uv->Type, VertexDataType::HALF);
+
+    float positionError = 0.0f;
+    float normalError = 0.0f;
+    float uvError = 0.0f;
+    float tangentError = 0.0f;
+    float colorError = 0.0f;
+    for (size_t v = 0; v < mesh.Positions.size(); v++) {
+        const Eigen::Vector4f stored = ReadEntry(quantized, *position, v);
+        EXPECT_EQ(stored.w(), 1.0f);
+        const Eigen::Vector3f decoded = stored.head<3>() * primitive.PositionScale + primitive.PositionOffset;
+        positionError = std::max(positionError, (decoded - mesh.Positions[v]).cwiseAbs().maxCoeff());
+        const Eigen::Vector3f n = OctahedralDecode(ReadEntry(quantized, *normal, v).head<2>());
+        normalError = std::max(normalError, AngleBetween(n, mesh.Normals[v]));
+        uvError = std::max(uvError, (ReadEntry(quantized, *uv, v).head<2>() - mesh.UV0[v]).cwiseAbs().maxCoeff());
+        const Eigen::Vector4f t = ReadEntry(quantized, *tangent, v);
+        const Eigen::Vector3f tangentDirection = OctahedralDecode(t.head<2>() * 2.0f - Eigen::Vector2f::Ones());
+        tangentError = std::max(tangentError, AngleBetween(tangentDirection, mesh.Tangents[v].head<3>().normalized()));
+        EXPECT_EQ(t.w() * 2.0f - 1.0f, mesh.Tangents[v].w() < 0.0f ? -1.0f : 1.0f);
+        colorError = std::max(colorError, (ReadEntry(quantized, *color, v) - mesh.Color0[v]).cwiseAbs().maxCoeff());
+    }
+    RecordProperty("PositionError", std::to_string(positionError));
+    RecordProperty("NormalErrorRadians", std::to_string(normalError));
+    RecordProperty("UvError", std::to_string(uvError));
+    RecordProperty("TangentErrorRadians", std::to_string(tangentError));
+    RecordProperty("ColorError", std::to_string(colorError));
+    // 位置: 半个 UNORM16 步长乘最长边 (直径 6), 另给 float 运算留一点余量。
+    EXPECT_NEAR(primitive.PositionScale, 6.0f, 1e-4f);
+    EXPECT_LE(positionError, 6.0f / 131070.0f * 1.05f);
+    // 16 位八面体约 1e-4 弧度, 10 位约 3e-3 弧度; UV 在 [0, 1] 内 half 的半步长为 2^-12。
+    EXPECT_LE(normalError, 1e-4f);
+    EXPECT_LE(tangentError, 5e-3f);
+    EXPECT_LE(uvError, 1.0f / 4096.0f);
+    EXPECT_LE(colorError, 0.5f / 255.0f + 1e-6f);
+}
+
+TEST(Core_VertexQuantization, LargeTexcoordsStayFloat) {
+    TriangleMesh mesh;
+    mesh.InitAsRectXY(1.0f, 1.0f);
+    mesh.Normals.clear();
+    mesh.Tangents.clear();
+    mesh.UV0[0] = Eigen::Vector2f{TriangleMesh::kMaxHalfTexcoord * 2.0f, 0.0f};
+    MeshResource quantized;
+    mesh.ToQuantizedMeshResource(&quantized);
+    ASSERT_EQ(quantized.Primitives.size(), 1u);
+    const VertexBufferEntry* uv = FindEntry(quantized.Primitives[0], VertexSemantics::TEXCOORD);
+    ASSERT_NE(uv, nullptr);
+    EXPECT_EQ(uv->Type, VertexDataType::FLOAT);
+    EXPECT_EQ(ReadEntry(quantized, *uv, 0).head<2>(), mesh.UV0[0]);
+    // 平面网格: z 方向没有跨度, 统一缩放取最长边。
+    EXPECT_FLOAT_EQ(quantized.Primitives[0].PositionScale, 1.0f);
+
+    TriangleMesh invalid;
+    MeshResource untouched;
+    untouched.Name = "kept";
+    invalid.ToQuantizedMeshResource(&untouched);
+    EXPECT_TRUE(untouched.Primitives.empty());
+    EXPECT_EQ(untouched.Name, "kept");
+}
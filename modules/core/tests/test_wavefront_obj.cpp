@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
 
 #include <radray/wavefront_obj.h>
 
@@ -73,3 +77,136 @@ TEST(Core_WaveObjTest, Simple) {
     reader.Read();
     SimpleTest(reader);
 }
+
+TEST_F(WaveObjTest, MappedFile) {
+    radray::WavefrontObjReader reader{std::filesystem::path{testFile}};
+    reader.Read();
+    SimpleTest(reader);
+}
+
+TEST(Core_WaveObjTest, MissingFile) {
+    radray::WavefrontObjReader reader{std::filesystem::path{"___missing___.obj"}};
+    reader.Read();
+    EXPECT_TRUE(reader.HasError());
+}
+
+TEST(Core_WaveObjTest, NegativeIndicesAreRelativeToPrecedingVertices) {
+    radray::WavefrontObjReader reader{string(R"(v 0 0 0
+v 1 0 0
+v 0 1 0
+f -3 -2 -1
+v 0 0 1
+v 1 0 1
+v 0 1 1
+vt 0 0
+vt 1 0
+vt 0 1
+f -3/-3 -2/-2 -1/-1
+f -4 -2 -1
+)")};
+    reader.Read();
+    EXPECT_FALSE(reader.HasError()) << reader.Error();
+    ASSERT_EQ(reader.Faces().size(), 3);
+    EXPECT_EQ(reader.Faces()[0].V1, 1);
+    EXPECT_EQ(reader.Faces()[0].V3, 3);
+    EXPECT_EQ(reader.Faces()[1].V1, 4);
+    EXPECT_EQ(reader.Faces()[1].V3, 6);
+    EXPECT_EQ(reader.Faces()[1].Vt1, 1);
+    EXPECT_EQ(reader.Faces()[1].Vt3, 3);
+    EXPECT_EQ(reader.Faces()[2].V1, 3);
+
+    radray::WavefrontObjReader outOfRange{string("v 0 0 0\nf -1 -2 -1\n")};
+    outOfRange.Read();
+    EXPECT_TRUE(outOfRange.HasError());
+}
+
+/// 每个 body 一个线程。
+static void ThreadParallelFor(uint32_t count, const std::function<void(uint32_t)>& body) {
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < count; i++) {
+        threads.emplace_back([&body, i]() { body(i); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+/// 顶点与面交错, 面用负索引, 对象、材质与光滑组跨越块边界。
+static string MakeInterleavedObj(int quads) {
+    string text = "mtllib a.mtl\n";
+    for (int i = 0; i < quads; i++) {
+        if (i % 7 == 0) {
+            text += fmt::format("o part{}\nusemtl m{}\ns {}\n", i, i % 3, i % 2);
+        }
+        text += fmt::format("v {} 0 0\nv {} 1 0\nv {} 1 1\nv {} 0 1\n", i, i, i, i);
+        text += fmt::format("vt 0.{} 0\nvn 0 0 1\n", i % 10);
+        text += "f -4/-1/-1 -3/-1/-1 -2/-1/-1\n";
+        text += fmt::format("f {} {} {}\n", i * 4 + 1, i * 4 + 3, i * 4 + 4);
+        if (i == 40) {
+            text += "bogus line\n";
+        }
+    }
+    return text;
+}
+
+TEST(Core_WaveObjTest, ParallelMatchesSerial) {
+    const string text = MakeInterleavedObj(100);
+    radray::WavefrontObjReader serial{text};
+    serial.Read();
+    radray::WavefrontObjReader parallel{std::as_bytes(std::span{text})};
+    parallel.Read(radray::WavefrontObjReadOptions{.ParallelFor = ThreadParallelFor, .MinChunkBytes = 97});
+
+    EXPECT_EQ(serial.Error(), "at line 348: unknown command bogus");
+    EXPECT_EQ(parallel.Error(), serial.Error());
+    ASSERT_EQ(parallel.Positions().size(), 400);
+    ASSERT_EQ(parallel.Positions().size(), serial.Positions().size());
+    ASSERT_EQ(parallel.UVs().size(), serial.UVs().size());
+    ASSERT_EQ(parallel.Normals().size(), serial.Normals().size());
+    ASSERT_EQ(parallel.Faces().size(), serial.Faces().size());
+    for (size_t i = 0; i < serial.Positions().size(); i++) {
+        EXPECT_EQ(parallel.Positions()[i], serial.Positions()[i]);
+    }
+    for (size_t i = 0; i < serial.UVs().size(); i++) {
+        EXPECT_EQ(parallel.UVs()[i], serial.UVs()[i]);
+    }
+    for (size_t i = 0; i < serial.Faces().size(); i++) {
+        const auto& a = serial.Faces()[i];
+        const auto& b = parallel.Faces()[i];
+        EXPECT_EQ(std::memcmp(&a, &b, sizeof(a)), 0) << "face " << i;
+    }
+    // 第 i 个四边形的相对索引面与写成绝对索引的面共用前两个顶点。
+    EXPECT_EQ(parallel.Faces()[2 * 57].V1, 57 * 4 + 1);
+    EXPECT_EQ(parallel.Faces()[2 * 57].Vt1, 58);
+    EXPECT_EQ(parallel.Faces()[2 * 57].Vn1, 58);
+
+    ASSERT_EQ(parallel.Mtllibs().size(), 1);
+    ASSERT_EQ(parallel.Objects().size(), serial.Objects().size());
+    ASSERT_EQ(parallel.Objects().size(), 15);
+    for (size_t i = 0; i < serial.Objects().size(); i++) {
+        const auto& a = serial.Objects()[i];
+        const auto& b = parallel.Objects()[i];
+        EXPECT_EQ(a.Name, b.Name);
+        EXPECT_EQ(a.Material, b.Material);
+        EXPECT_EQ(a.IsSmooth, b.IsSmooth);
+        EXPECT_EQ(a.Faces, b.Faces);
+    }
+    EXPECT_EQ(parallel.Objects()[1].Faces.size(), 14);
+    EXPECT_EQ(parallel.Objects()[1].Faces.front(), 14);
+    EXPECT_EQ(parallel.Objects()[1].Material, u8"m1");
+    EXPECT_TRUE(parallel.Objects()[1].IsSmooth);
+}
+
+TEST(Core_WaveObjTest, MtlTexturesSkipOptionsAndDuplicates) {
+    const char* mtl = R"(newmtl brick
+Kd 1 1 1
+map_Kd -o 0.5 0.5 -clamp on textures/brick diffuse.png
+map_Bump -bm 2 textures/brick_normal.png
+newmtl floor
+map_Kd textures/brick diffuse.png
+bump
+disp -mm 0 1 height.png
+# map_Kd commented.png
+)";
+    const vector<string> textures = ParseWavefrontMtlTextures(mtl);
+    EXPECT_EQ(textures, (vector<string>{"textures/brick diffuse.png", "textures/brick_normal.png", "height.png"}));
+}
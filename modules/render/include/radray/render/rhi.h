@@ -111,6 +111,7 @@ enum class VertexFormat : int32_t {
     FLOAT32X2,
     FLOAT32X3,
     FLOAT32X4,
+    UNORM10_10_10_2,
 };
 
 enum class ShaderParameterBindingType : int32_t {
@@ -190,6 +191,16 @@ enum class TextureFormat : int32_t {
     RGBA32_UINT,
     RGBA32_FLOAT,
 
+    // 4x4 块压缩。mip 0 的宽高须为 4 的倍数; 更小的 mip 仍按整块存放。
+    BC1_UNORM,
+    BC1_UNORM_SRGB,
+    BC3_UNORM,
+    BC3_UNORM_SRGB,
+    BC4_UNORM,
+    BC5_UNORM,
+    BC7_UNORM,
+    BC7_UNORM_SRGB,
+
     D16_UNORM,
     D32_FLOAT,
     D24_UNORM_S8_UINT,
@@ -1225,6 +1236,8 @@ struct DeviceDetail {
     uint32_t MaxVertexInputBindings{0};
     bool IsUMA{false};
     bool IsLayeredRenderingFromVertexShaderSupported{false};
+    /// 可采样 BC1-BC7 贴图。D3D12 恒为 true; Vulkan 取 textureCompressionBC。
+    bool IsBlockCompressionSupported{false};
 };
 
 // == 接口: Device 与 queue ==
@@ -1605,7 +1618,16 @@ bool IsUintFormat(TextureFormat format) noexcept;
 bool IsSintFormat(TextureFormat format) noexcept;
 uint32_t GetIndexFormatSizeInBytes(IndexFormat format) noexcept;
 IndexFormat SizeInBytesToIndexFormat(uint32_t size) noexcept;
+/// 块压缩格式返回 0: 它们没有逐 texel 的大小, 拷贝与占用按 GetTextureFormatBlockInfo 计。
 uint32_t GetTextureFormatBytesPerPixel(TextureFormat format) noexcept;
+/// 一个寻址单元的 texel 尺寸与字节数。非压缩格式为 1x1 texel、BytesPerPixel 字节; UNKNOWN 的 Bytes 为 0。
+struct TextureFormatBlockInfo {
+    uint32_t Width{1};
+    uint32_t Height{1};
+    uint32_t Bytes{0};
+};
+bool IsBlockCompressedFormat(TextureFormat format) noexcept;
+TextureFormatBlockInfo GetTextureFormatBlockInfo(TextureFormat format) noexcept;
 uint32_t GetVertexFormatSizeInBytes(VertexFormat format) noexcept;
 bool IsDynamicShaderParameterBindingType(ShaderParameterBindingType type) noexcept;
 // -------------------------------------------------------------------------
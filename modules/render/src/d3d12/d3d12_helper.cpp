@@ -317,6 +317,14 @@ DXGI_FORMAT MapType(TextureFormat v) noexcept {
         case TextureFormat::RGBA32_SINT: return DXGI_FORMAT_R32G32B32A32_SINT;
         case TextureFormat::RGBA32_UINT: return DXGI_FORMAT_R32G32B32A32_UINT;
         case TextureFormat::RGBA32_FLOAT: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+        case TextureFormat::BC1_UNORM: return DXGI_FORMAT_BC1_UNORM;
+        case TextureFormat::BC1_UNORM_SRGB: return DXGI_FORMAT_BC1_UNORM_SRGB;
+        case TextureFormat::BC3_UNORM: return DXGI_FORMAT_BC3_UNORM;
+        case TextureFormat::BC3_UNORM_SRGB: return DXGI_FORMAT_BC3_UNORM_SRGB;
+        case TextureFormat::BC4_UNORM: return DXGI_FORMAT_BC4_UNORM;
+        case TextureFormat::BC5_UNORM: return DXGI_FORMAT_BC5_UNORM;
+        case TextureFormat::BC7_UNORM: return DXGI_FORMAT_BC7_UNORM;
+        case TextureFormat::BC7_UNORM_SRGB: return DXGI_FORMAT_BC7_UNORM_SRGB;
         case TextureFormat::D16_UNORM: return DXGI_FORMAT_D16_UNORM;
         case TextureFormat::D32_FLOAT: return DXGI_FORMAT_D32_FLOAT;
         case TextureFormat::D24_UNORM_S8_UINT: return DXGI_FORMAT_D24_UNORM_S8_UINT;
@@ -410,6 +418,7 @@ DXGI_FORMAT MapType(VertexFormat v) noexcept {
         case VertexFormat::FLOAT32X2: return DXGI_FORMAT_R32G32_FLOAT;
         case VertexFormat::FLOAT32X3: return DXGI_FORMAT_R32G32B32_FLOAT;
         case VertexFormat::FLOAT32X4: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+        case VertexFormat::UNORM10_10_10_2: return DXGI_FORMAT_R10G10B10A2_UNORM;
     }
     Unreachable();
 }
@@ -755,6 +755,8 @@ Nullable<shared_ptr<DeviceD3D12>> CreateDevice(const D3D12DeviceDescriptor& desc
     detail.TextureDataPitchAlignment = D3D12_TEXTURE_DATA_PITCH_ALIGNMENT;
     detail.TextureDataPlacementAlignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
     detail.MaxVertexInputBindings = D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT;
+    // BC1-BC7 是 feature level 11_0 的必备能力。
+    detail.IsBlockCompressionSupported = true;
     {
         DXGI_ADAPTER_DESC1 adapDesc{};
         if (HRESULT hr = adapter->GetDesc1(&adapDesc); SUCCEEDED(hr)) {
@@ -30,7 +30,8 @@ uint32_t GetVertexFormatSizeInBytes(VertexFormat format) noexcept {
         case VertexFormat::FLOAT16X2:
         case VertexFormat::UINT32:
         case VertexFormat::SINT32:
-        case VertexFormat::FLOAT32: return 4;
+        case VertexFormat::FLOAT32:
+        case VertexFormat::UNORM10_10_10_2: return 4;
         case VertexFormat::UINT16X4:
         case VertexFormat::SINT16X4:
         case VertexFormat::UNORM16X4:
@@ -141,6 +142,7 @@ std::string_view format_as(VertexFormat v) noexcept {
         case VertexFormat::FLOAT32X2: return "float2";
         case VertexFormat::FLOAT32X3: return "float3";
         case VertexFormat::FLOAT32X4: return "float4";
+        case VertexFormat::UNORM10_10_10_2: return "unorm10_10_10_2";
     }
     Unreachable();
 }
@@ -346,11 +348,47 @@ uint32_t GetTextureFormatBytesPerPixel(TextureFormat format) noexcept {
         case TextureFormat::RGBA32_SINT:
         case TextureFormat::RGBA32_UINT:
         case TextureFormat::RGBA32_FLOAT: return 16;
+        case TextureFormat::BC1_UNORM:
+        case TextureFormat::BC1_UNORM_SRGB:
+        case TextureFormat::BC3_UNORM:
+        case TextureFormat::BC3_UNORM_SRGB:
+        case TextureFormat::BC4_UNORM:
+        case TextureFormat::BC5_UNORM:
+        case TextureFormat::BC7_UNORM:
+        case TextureFormat::BC7_UNORM_SRGB:
         case TextureFormat::UNKNOWN: return 0;
     }
     Unreachable();
 }
 
+bool IsBlockCompressedFormat(TextureFormat format) noexcept {
+    switch (format) {
+        case TextureFormat::BC1_UNORM:
+        case TextureFormat::BC1_UNORM_SRGB:
+        case TextureFormat::BC3_UNORM:
+        case TextureFormat::BC3_UNORM_SRGB:
+        case TextureFormat::BC4_UNORM:
+        case TextureFormat::BC5_UNORM:
+        case TextureFormat::BC7_UNORM:
+        case TextureFormat::BC7_UNORM_SRGB: return true;
+        default: return false;
+    }
+}
+
+TextureFormatBlockInfo GetTextureFormatBlockInfo(TextureFormat format) noexcept {
+    switch (format) {
+        case TextureFormat::BC1_UNORM:
+        case TextureFormat::BC1_UNORM_SRGB:
+        case TextureFormat::BC4_UNORM: return TextureFormatBlockInfo{.Width = 4, .Height = 4, .Bytes = 8};
+        case TextureFormat::BC3_UNORM:
+        case TextureFormat::BC3_UNORM_SRGB:
+        case TextureFormat::BC5_UNORM:
+        case TextureFormat::BC7_UNORM:
+        case TextureFormat::BC7_UNORM_SRGB: return TextureFormatBlockInfo{.Width = 4, .Height = 4, .Bytes = 16};
+        default: return TextureFormatBlockInfo{.Bytes = GetTextureFormatBytesPerPixel(format)};
+    }
+}
+
 std::string_view format_as(RenderBackend v) noexcept {
     // MAX_COUNT 是哨兵而非真实后端, 不暴露其成员名。
     if (v == RenderBackend::MAX_COUNT) {
@@ -176,6 +176,7 @@ bool GetVertexFormatShape(
         case VertexFormat::SNORM16X4:
         case VertexFormat::FLOAT16X4:
         case VertexFormat::FLOAT32X4:
+        case VertexFormat::UNORM10_10_10_2:
             componentType = static_cast<uint32_t>(shader::ShaderVertexComponentType::Float);
             componentCount = 4;
             return true;
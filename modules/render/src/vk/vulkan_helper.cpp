@@ -342,6 +342,15 @@ VkFormat MapType(TextureFormat v) noexcept {
         case TextureFormat::RGBA32_SINT: return VK_FORMAT_R32G32B32A32_SINT;
         case TextureFormat::RGBA32_UINT: return VK_FORMAT_R32G32B32A32_UINT;
         case TextureFormat::RGBA32_FLOAT: return VK_FORMAT_R32G32B32A32_SFLOAT;
+        // BC1 按 RGBA 变体映射, 与 D3D12 的 DXGI_FORMAT_BC1_UNORM 一样解码 1 bit alpha。
+        case TextureFormat::BC1_UNORM: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case TextureFormat::BC1_UNORM_SRGB: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+        case TextureFormat::BC3_UNORM: return VK_FORMAT_BC3_UNORM_BLOCK;
+        case TextureFormat::BC3_UNORM_SRGB: return VK_FORMAT_BC3_SRGB_BLOCK;
+        case TextureFormat::BC4_UNORM: return VK_FORMAT_BC4_UNORM_BLOCK;
+        case TextureFormat::BC5_UNORM: return VK_FORMAT_BC5_UNORM_BLOCK;
+        case TextureFormat::BC7_UNORM: return VK_FORMAT_BC7_UNORM_BLOCK;
+        case TextureFormat::BC7_UNORM_SRGB: return VK_FORMAT_BC7_SRGB_BLOCK;
         case TextureFormat::D16_UNORM: return VK_FORMAT_D16_UNORM;
         case TextureFormat::D32_FLOAT: return VK_FORMAT_D32_SFLOAT;
         case TextureFormat::D24_UNORM_S8_UINT: return VK_FORMAT_D24_UNORM_S8_UINT;
@@ -468,6 +477,7 @@ VkFormat MapType(VertexFormat v) noexcept {
         case VertexFormat::FLOAT32X2: return VK_FORMAT_R32G32_SFLOAT;
         case VertexFormat::FLOAT32X3: return VK_FORMAT_R32G32B32_SFLOAT;
         case VertexFormat::FLOAT32X4: return VK_FORMAT_R32G32B32A32_SFLOAT;
+        case VertexFormat::UNORM10_10_10_2: return VK_FORMAT_A2B10G10R10_UNORM_PACK32;
         case VertexFormat::UNKNOWN: return VK_FORMAT_MAX_ENUM;
     }
     Unreachable();
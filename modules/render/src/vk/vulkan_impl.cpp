@@ -3474,6 +3474,7 @@ Nullable<shared_ptr<DeviceVulkan>> CreateDeviceVulkan(const VulkanDeviceDescript
         detail.IsLayeredRenderingFromVertexShaderSupported =
             selectPhyDevice.properties.apiVersion >= VK_API_VERSION_1_2 &&
             f12.shaderOutputLayer;
+        detail.IsBlockCompressionSupported = deviceR->_feature.textureCompressionBC == VK_TRUE;
     }
     RADRAY_INFO_LOG("========== Feature ==========");
     {
@@ -3522,6 +3523,7 @@ Nullable<shared_ptr<DeviceVulkan>> CreateDeviceVulkan(const VulkanDeviceDescript
     RADRAY_INFO_LOG(
         "Layered Rendering From Vertex Shader: {}",
         deviceR->_detail.IsLayeredRenderingFromVertexShaderSupported);
+    RADRAY_INFO_LOG("Texture Compression BC: {}", deviceR->_detail.IsBlockCompressionSupported);
     RADRAY_INFO_LOG("=============================");
     return deviceR;
 }
@@ -3940,8 +3942,8 @@ void CommandBufferVulkan::CopyBufferToBuffer(Buffer* dst_, uint64_t dstOffset, B
 void CommandBufferVulkan::CopyBufferToTexture(Texture* dst_, SubresourceRange dstRange, Buffer* src_, uint64_t srcOffset) noexcept {
     auto dst = CastVkObject(dst_);
     auto src = CastVkObject(src_);
-    const uint32_t bpp = GetTextureFormatBytesPerPixel(dst->_format);
-    if (bpp == 0) {
+    const TextureFormatBlockInfo block = GetTextureFormatBlockInfo(dst->_format);
+    if (block.Bytes == 0) {
         RADRAY_ERR_LOG("vk CopyBufferToTexture invalid texture format {}", dst->_format);
         return;
     }
@@ -3977,21 +3979,23 @@ void CommandBufferVulkan::CopyBufferToTexture(Texture* dst_, SubresourceRange ds
         uint32_t mipWidth = std::max(dst->_width >> mipLevel, 1u);
         uint32_t mipHeight = std::max(dst->_height >> mipLevel, 1u);
         uint32_t mipDepth = is3D ? std::max(dst->_depthOrArraySize >> mipLevel, 1u) : 1u;
-        uint64_t tightBytesPerRow = static_cast<uint64_t>(mipWidth) * bpp;
+        // 块压缩格式按块行寻址: bufferRowLength / bufferImageHeight 以 texel 计, 须是块尺寸的倍数。
+        uint32_t blockRows = (mipHeight + block.Height - 1) / block.Height;
+        uint64_t tightBytesPerRow = static_cast<uint64_t>((mipWidth + block.Width - 1) / block.Width) * block.Bytes;
         uint64_t alignedBytesPerRow = Align(tightBytesPerRow, rowPitchAlignment);
-        if (alignedBytesPerRow % bpp != 0) {
+        if (alignedBytesPerRow % block.Bytes != 0) {
             RADRAY_ERR_LOG(
-                "vk CopyBufferToTexture row pitch cannot be represented in texels (alignedBytesPerRow={}, bpp={})", alignedBytesPerRow, bpp);
+                "vk CopyBufferToTexture row pitch cannot be represented in texels (alignedBytesPerRow={}, blockBytes={})", alignedBytesPerRow, block.Bytes);
             return;
         }
-        uint32_t bufferRowLength = static_cast<uint32_t>(alignedBytesPerRow / bpp);
-        uint64_t bytesPerImage = alignedBytesPerRow * mipHeight;
+        uint32_t bufferRowLength = static_cast<uint32_t>(alignedBytesPerRow / block.Bytes) * block.Width;
+        uint64_t bytesPerImage = alignedBytesPerRow * blockRows;
         for (uint32_t layer = 0; layer < layerCount; layer++) {
             uint32_t arrayLayer = dstRange.BaseArrayLayer + layer;
             VkBufferImageCopy copyInfo{};
             copyInfo.bufferOffset = bufferOffset;
             copyInfo.bufferRowLength = bufferRowLength;
-            copyInfo.bufferImageHeight = mipHeight;
+            copyInfo.bufferImageHeight = blockRows * block.Height;
             copyInfo.imageSubresource.aspectMask = aspectMask;
             copyInfo.imageSubresource.mipLevel = mipLevel;
             copyInfo.imageSubresource.baseArrayLayer = arrayLayer;
@@ -4007,8 +4011,8 @@ void CommandBufferVulkan::CopyBufferToTexture(Texture* dst_, SubresourceRange ds
 void CommandBufferVulkan::CopyTextureToBuffer(Buffer* dst_, uint64_t dstOffset, Texture* src_, SubresourceRange srcRange) noexcept {
     auto dst = CastVkObject(dst_);
     auto src = CastVkObject(src_);
-    const uint32_t bpp = GetTextureFormatBytesPerPixel(src->_format);
-    if (bpp == 0) {
+    const TextureFormatBlockInfo block = GetTextureFormatBlockInfo(src->_format);
+    if (block.Bytes == 0) {
         RADRAY_ERR_LOG("vk CopyTextureToBuffer invalid texture format {}", src->_format);
         return;
     }
@@ -4044,21 +4048,22 @@ void CommandBufferVulkan::CopyTextureToBuffer(Buffer* dst_, uint64_t dstOffset,
         uint32_t mipWidth = std::max(src->_width >> mipLevel, 1u);
         uint32_t mipHeight = std::max(src->_height >> mipLevel, 1u);
         uint32_t mipDepth = is3D ? std::max(src->_depthOrArraySize >> mipLevel, 1u) : 1u;
-        uint64_t tightBytesPerRow = static_cast<uint64_t>(mipWidth) * bpp;
+        uint32_t blockRows = (mipHeight + block.Height - 1) / block.Height;
+        uint64_t tightBytesPerRow = static_cast<uint64_t>((mipWidth + block.Width - 1) / block.Width) * block.Bytes;
         uint64_t alignedBytesPerRow = Align(tightBytesPerRow, rowPitchAlignment);
-        if (alignedBytesPerRow % bpp != 0) {
+        if (alignedBytesPerRow % block.Bytes != 0) {
             RADRAY_ERR_LOG(
-                "vk CopyTextureToBuffer row pitch cannot be represented in texels (alignedBytesPerRow={}, bpp={})", alignedBytesPerRow, bpp);
+                "vk CopyTextureToBuffer row pitch cannot be represented in texels (alignedBytesPerRow={}, blockBytes={})", alignedBytesPerRow, block.Bytes);
             return;
         }
-        uint32_t bufferRowLength = static_cast<uint32_t>(alignedBytesPerRow / bpp);
-        uint64_t bytesPerImage = alignedBytesPerRow * mipHeight;
+        uint32_t bufferRowLength = static_cast<uint32_t>(alignedBytesPerRow / block.Bytes) * block.Width;
+        uint64_t bytesPerImage = alignedBytesPerRow * blockRows;
         for (uint32_t layer = 0; layer < layerCount; layer++) {
             uint32_t arrayLayer = srcRange.BaseArrayLayer + layer;
             VkBufferImageCopy copyInfo{};
             copyInfo.bufferOffset = bufferOffset;
             copyInfo.bufferRowLength = bufferRowLength;
-            copyInfo.bufferImageHeight = mipHeight;
+            copyInfo.bufferImageHeight = blockRows * block.Height;
             copyInfo.imageSubresource.aspectMask = aspectMask;
             copyInfo.imageSubresource.mipLevel = mipLevel;
             copyInfo.imageSubresource.baseArrayLayer = arrayLayer;
@@ -6,6 +6,10 @@
 
 #include <radray/coroutine.h>
 #include <radray/types.h>
+#include <radray/runtime/asset_decode_pool.h>
+#include <radray/runtime/asset_manager.h>
+#include <radray/runtime/derived_data_cache.h>
+#include <radray/runtime/texture_streaming.h>
 
 namespace radray {
 
@@ -90,7 +94,7 @@ private:
 
     ApplicationSchedulerRecord* Enqueue(stop_token stop, std::coroutine_handle<> continuation);
     bool Erase(ApplicationSchedulerRecord* record) noexcept;
-    bool IsAlive(ApplicationSchedulerRecord* record) const noexcept;
+    bool IsAlive(ApplicationSchedulerRecord* record, uint64_t ticket) const noexcept;
     void ResumeRecord(ApplicationSchedulerRecord* record) noexcept;
     void CancelRecord(ApplicationSchedulerRecord* record) noexcept;
 
@@ -112,6 +116,16 @@ struct ApplicationRuntimeDescriptor {
     std::filesystem::path RenderCachePath{};
     /// 开发时资产根；清单固定为 `<AssetRoot>/assets.json`。空路径不启用 AssetDatabase。
     std::filesystem::path AssetRoot{};
+    /// 资产 CPU 阶段(解码、mip 生成、网格处理)的 worker 数与在飞字节预算。
+    AssetDecodePoolDescriptor AssetDecode{};
+    /// AssetManager 同时运行的加载数与在飞字节预算, 超出的按 AssetLoadPriority 排队。
+    AssetLoadBudget AssetLoads{};
+    /// 零引用资产的保活缓存预算。默认为 0, 不缓存。
+    AssetCacheBudget AssetCache{};
+    /// importer 产物的本机磁盘缓存。目录为空时不启用, 每次加载都从源格式重新导入。
+    DerivedDataCacheDescriptor DerivedData{};
+    /// 贴图 mip 流送的显存与每帧上传预算。显存预算为 0 时取设备报告的一半。
+    TextureStreamingDescriptor TextureStreaming{};
     /// 开发时 shader 逻辑源名的文件系统根。空路径会让 program 请求明确失败。
     std::filesystem::path ShaderSourceRoot{};
     /// 传给 shader compiler 的 HLSL include roots。
@@ -147,6 +161,14 @@ public:
     const GpuSystem* GetGpuSystem() const noexcept { return _gpuSystem.get(); }
     AssetManager* GetAssetManager() noexcept { return _assetManager.get(); }
     const AssetManager* GetAssetManager() const noexcept { return _assetManager.get(); }
+    AssetDecodePool* GetAssetDecodePool() noexcept { return _assetDecodePool.get(); }
+    const AssetDecodePool* GetAssetDecodePool() const noexcept { return _assetDecodePool.get(); }
+    AssetDatabase* GetAssetDatabase() noexcept { return _assetDatabase.get(); }
+    const AssetDatabase* GetAssetDatabase() const noexcept { return _assetDatabase.get(); }
+    DerivedDataCache* GetDerivedDataCache() noexcept { return _derivedDataCache.get(); }
+    const DerivedDataCache* GetDerivedDataCache() const noexcept { return _derivedDataCache.get(); }
+    TextureStreamingManager* GetTextureStreamingManager() noexcept { return _textureStreaming.get(); }
+    const TextureStreamingManager* GetTextureStreamingManager() const noexcept { return _textureStreaming.get(); }
     RenderSystem* GetRenderSystem() noexcept { return _renderSystem.get(); }
     const RenderSystem* GetRenderSystem() const noexcept { return _renderSystem.get(); }
     ApplicationScheduler& GetScheduler() noexcept { return _scheduler; }
@@ -203,6 +225,9 @@ private:
 
     unique_ptr<WindowManager> _windowManager;
     unique_ptr<GpuSystem> _gpuSystem;
+    unique_ptr<DerivedDataCache> _derivedDataCache;
+    unique_ptr<AssetDecodePool> _assetDecodePool;
+    unique_ptr<TextureStreamingManager> _textureStreaming;
     unique_ptr<AssetDatabase> _assetDatabase;
     unique_ptr<AssetManager> _assetManager;
     unique_ptr<RenderSystem> _renderSystem;
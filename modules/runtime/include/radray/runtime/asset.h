@@ -13,13 +13,21 @@ class AssetManager;
 /// 资产的持久标识。落盘/去重缓存的 key,跨进程有效。
 using AssetId = Guid;
 
+/// 资产占用的内存, 供 AssetManager 的保活缓存计预算。估算即可, 不必精确。
+struct AssetMemorySize {
+    uint64_t CpuBytes{0};
+    uint64_t GpuBytes{0};
+};
+
 /// 资产基类。
 ///
-/// 【生命周期只由引用计数决定】没有强制卸载。引用归零后资产立即销毁 (对齐到
-/// AssetManager::Pump 这一确定时刻), 不做闲置缓存。由此资产可以放心向外交出指向自身
-/// 内部的指针 —— 持有一份 StreamingAssetRef 即保证它们不悬垂。
+/// 【生命周期只由引用计数决定】没有强制卸载。引用归零后资产在下一次 AssetManager::Pump
+/// 销毁; 装配了保活缓存 (AssetCacheBudget) 时, 零引用的 Ready 资产留在缓存里直到被挤出,
+/// 但只会比引用活得更久, 不会更短。由此资产可以放心向外交出指向自身内部的指针 —— 持有
+/// 一份 StreamingAssetRef 即保证它们不悬垂。
 ///
-/// 改这条不变量之前先读 docs/adr/0007-asset-lifetime-refcount-only.md。
+/// 改这条不变量之前先读 docs/adr/0007-asset-lifetime-refcount-only.md 与
+/// docs/adr/0051-opt-in-keep-alive-cache-for-zero-ref-assets.md。
 class Asset {
 public:
     Asset() noexcept = default;
@@ -39,6 +47,9 @@ public:
     /// 返回资产自身的运行时类型 id。
     virtual RuntimeTypeId GetTypeId() const noexcept = 0;
 
+    /// 本资产持有的 CPU / GPU 内存。引用归零、决定是否进保活缓存时调用。
+    virtual AssetMemorySize GetMemorySize() const noexcept = 0;
+
     const AssetId& GetAssetId() const noexcept { return _id; }
 
 private:
@@ -30,6 +30,8 @@ struct AssetEntry {
     unique_ptr<AssetImportSettings> Settings;
     /// 仅在 type 未注册、type 无 settings 形状或 settings 解码失败时保存原始 JSON 值。
     string RawSettings;
+    /// 直接依赖, 去重且不含自身。由 importer 声明或首次加载时发现, 随清单持久化。
+    vector<AssetId> Dependencies;
 };
 
 template <class T>
@@ -54,6 +56,10 @@ public:
     virtual std::span<const std::string_view> GetFileExtensions() const noexcept { return {}; }
     virtual unique_ptr<AssetImportSettings> CreateSettings() const { return nullptr; }
 
+    /// 见 IAssetSource::EstimateLoadBytes。默认取源文件大小; 解码后明显膨胀的格式应覆写。
+    /// 源文件不可访问时返回 0。
+    virtual uint64_t EstimateLoadBytes(const AssetLoadContext& ctx) const;
+
     /// 【不得实现成协程】调用返回前必须同步读完 ctx；惰性 task 启动后 ctx 可能已经失效。
     virtual task<AssetLoadResult> Load(const AssetLoadContext& ctx) = 0;
 };
@@ -84,6 +90,21 @@ private:
     }
 };
 
+struct AssetRefreshStats {
+    /// 本次遍历到的目录数。
+    uint32_t DirectoryCount{0};
+    /// 其中 mtime 与快照不符、重新列出的目录数; 其余目录复用上次的列表。
+    uint32_t RescannedDirectoryCount{0};
+    /// 快照核对过、列表也没变, 因而其中文件一个都没看的目录数。
+    uint32_t SkippedDirectoryCount{0};
+    uint32_t AddedCount{0};
+    /// 登记了但扫描中没见到的条目数(缺失或位于符号链接目录下)。目录被跳过时只计
+    /// 本次从快照列表里消失的文件。
+    uint32_t UnseenCount{0};
+};
+
+class AssetDatabaseIndex;
+
 /// `<assetRoot>/assets.json` 的内存索引，也是 AssetManager 的可选 IAssetSource。
 class AssetDatabase final : public IAssetSource {
 public:
@@ -94,13 +115,14 @@ public:
         vector<unique_ptr<AssetImporter>> importers,
         string& outError);
 
-    ~AssetDatabase() noexcept override = default;
+    ~AssetDatabase() noexcept override;
     AssetDatabase(const AssetDatabase&) = delete;
     AssetDatabase& operator=(const AssetDatabase&) = delete;
     AssetDatabase(AssetDatabase&&) = delete;
     AssetDatabase& operator=(AssetDatabase&&) = delete;
 
     /// 返回指针在表 rehash 后仍有效；RemoveEntry 对该条目的调用会使它失效。
+    /// 从二进制索引打开时，条目（含 settings 解码）在首次 Find 时才实体化。
     const AssetEntry* Find(const AssetId& id) const noexcept;
     const AssetEntry* Find(std::string_view relPath) const noexcept;
     std::filesystem::path ResolvePath(const AssetEntry& entry) const;
@@ -115,16 +137,34 @@ public:
     T* MutableSettings(const AssetId& id) noexcept;
 
     bool SetPath(const AssetId& id, std::string_view newRelPath, string& outError);
+    /// 覆盖 id 的直接依赖。重复项与自身被丢弃; 依赖可以是尚未登记的 GUID。
+    bool SetDependencies(const AssetId& id, std::span<const AssetId> dependencies, string& outError);
     bool RemoveEntry(const AssetId& id) noexcept;
 
-    /// 按 path 排序全量重写清单。不保留条目顺序或其他根内容。
+    /// 按 path 排序重写清单。不保留条目顺序或其他根内容。
+    /// 增量进行: 上次 Save 以来没改动的条目直接复用索引里的记录, 只有改动过的条目(以及
+    /// 取过 MutableSettings 的条目)重新编码 settings, 编码分到多个线程。输出与逐条全量编码
+    /// 逐字节相同。清单边写边哈希, 经临时文件原子替换; 随后重建 `assets.index` 并留在内存里。
     bool Save(string& outError) const;
 
+    /// 条目由二进制索引支撑: Open 时映射的 `assets.index`, 或上次 Save 留下的内存副本。
+    bool IsIndexBacked() const noexcept { return _index != nullptr; }
+
     /// 扫描 importer 认领的文件并登记新条目；缺失文件只记 warning。不会自动 Save。
+    /// 目录列表缓存在 `assets.refresh`：mtime 未变的目录不重新列出，子树多线程遍历。
+    /// 快照核对过的清单已 Save 且未被改动时，列表未变的目录连文件也不看；什么都没变时不重写快照。
     bool Refresh(string& outError);
+    const AssetRefreshStats& GetLastRefreshStats() const noexcept { return _lastRefreshStats; }
 
     std::optional<task<AssetLoadResult>> CreateLoadTask(const AssetId& id) override;
     std::optional<AssetId> ResolveId(std::string_view relPath) const override;
+    /// 交给条目类型的 importer 估算; 类型未注册时为 0。
+    uint64_t EstimateLoadBytes(const AssetId& id) const override;
+    std::span<const AssetId> GetDependencies(const AssetId& id) const override;
+    /// 资产根之外的路径为 nullopt。
+    std::optional<AssetId> ResolveSourceFile(const std::filesystem::path& absolutePath) const override;
+    /// 加载时发现的依赖只进内存, 下一次 Save 写入清单。
+    void RecordDependencies(const AssetId& id, std::span<const AssetId> dependencies) override;
 
 private:
     AssetDatabase(
@@ -132,24 +172,50 @@ private:
         vector<unique_ptr<AssetImporter>> importers) noexcept;
 
     AssetImporter* FindImporter(std::string_view type) const noexcept;
+    /// 已实体化的条目, 或从索引解码后放进 _entries 的条目; 不存在或已删除时为 nullptr。
+    AssetEntry* Materialize(const AssetId& id) const noexcept;
+    /// 记录越界(索引损坏)时记 warning 并返回 nullptr。
+    AssetEntry* MaterializeRecord(uint32_t recordIndex) const;
+    /// 实体化全部剩余索引条目并释放映射。有记录越界时保留索引并返回 false。
+    bool MaterializeAll() const;
+    void AssignDependencies(AssetEntry& entry, std::span<const AssetId> dependencies) const;
+    /// 只查身份, 不实体化条目。
+    std::optional<AssetId> FindId(std::string_view relPath) const;
+    std::optional<AssetId> FindIdByPathKey(const string& pathKey) const;
+    bool Contains(const AssetId& id) const noexcept;
 
     std::filesystem::path _assetRoot;
     vector<unique_ptr<AssetImporter>> _ownedImporters;
     unordered_map<string, AssetImporter*> _importers;
     unordered_map<string, AssetImporter*> _extensionImporters;
-    unordered_map<AssetId, AssetEntry> _entries;
-    unordered_map<string, AssetId> _paths;
+    // 以下四项是"清单 = 索引中未实体化的条目 + _entries"这一视图的缓存, const 查询也会推进它。
+    /// Open 时映射的 `assets.index`; 为空表示全部条目都在 _entries 里。
+    mutable unique_ptr<AssetDatabaseIndex> _index;
+    mutable unordered_map<AssetId, AssetEntry> _entries;
+    /// 只含 _entries 的 path key; 未实体化条目的 path 由索引的桶表回答。
+    mutable unordered_map<string, AssetId> _paths;
+    /// 已被 RemoveEntry 删除、但仍在索引里的 GUID。
+    mutable unordered_set<AssetId> _removedIndexed;
+    /// 上次 Save 以来 path 或依赖变过的条目; 新增条目不在索引里, 不必登记。
+    mutable unordered_set<AssetId> _dirty;
+    /// 上次 Save 以来登记、删除过条目或改过 path。为真时 Refresh 不信任快照里 "已核对" 的记录。
+    mutable bool _registrationsUnsaved{false};
+    /// 取过 MutableSettings 的条目。调用方可能在任何时候经指针改写 settings, 每次 Save 都重新编码。
+    unordered_set<AssetId> _settingsExposed;
+    uint64_t _importersHash{0};
+    AssetRefreshStats _lastRefreshStats{};
 };
 
 template <class T>
 requires std::derived_from<T, AssetImportSettings>
 T* AssetDatabase::MutableSettings(const AssetId& id) noexcept {
-    auto it = _entries.find(id);
-    if (it == _entries.end() || it->second.Settings == nullptr ||
-        !it->second.Settings->GetTypeInfo().IsA(runtime_type_id_v<T>)) {
+    AssetEntry* entry = Materialize(id);
+    if (entry == nullptr || entry->Settings == nullptr ||
+        !entry->Settings->GetTypeInfo().IsA(runtime_type_id_v<T>)) {
         return nullptr;
     }
-    return static_cast<T*>(it->second.Settings.get());
+    _settingsExposed.insert(id);
+    return static_cast<T*>(entry->Settings.get());
 }
 
 }  // namespace radray
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+#include <radray/coroutine.h>
+#include <radray/types.h>
+
+// 资产加载的 CPU 阶段(读文件、解码、mip 生成、网格处理)在 worker 线程上执行,
+// 结果由主线程的 AssetDecodePool::Pump 交回等待的协程。GPU 上传与提交仍在主线程。
+
+namespace radray {
+
+class AssetDecodePool;
+class AssetDecodeAwaitable;
+struct AssetDecodeRecord;
+
+struct AssetDecodePoolDescriptor {
+    /// worker 线程数。0 表示 hardware_concurrency - 1, 至少 1 个。
+    uint32_t WorkerCount{0};
+    /// 在飞字节预算: 已派发给 worker、结果尚未被 Pump 交回的任务, 其预估字节数之和不超过它。
+    /// 超过预算的单个任务只在没有其它在飞任务时派发, 不会永远排不上。
+    uint64_t MaxInFlightBytes{256ull << 20};
+};
+
+/// 一条等待 worker 任务完成的协程记录。由 AssetDecodePool 管理, 只在主线程访问。
+struct AssetDecodeRecord : ManualCoroutineRecord {
+    bool Completed{false};
+};
+
+/// 一次 CPU 任务。由 worker 与等待它的协程共享所有权: 协程被取消后先行结束时,
+/// 正在执行的任务仍只写自己的成员, 不会碰到已销毁的协程帧。
+class AssetDecodeJob {
+public:
+    virtual ~AssetDecodeJob() noexcept = default;
+
+    /// 在 worker 线程上调用, 恰好一次或(被放弃时)零次。
+    virtual void Execute() = 0;
+
+    /// 预估的峰值内存占用, 计入在飞预算。
+    uint64_t Bytes{0};
+    /// 等待者已取消或已结束。worker 跳过尚未开始的被放弃任务; Pump 不再恢复它的等待者。
+    /// 【只由主线程写】, 故主线程读到 false 即说明 Record 仍有效。
+    std::atomic<bool> Abandoned{false};
+    /// 仅主线程访问。
+    AssetDecodeRecord* Record{nullptr};
+};
+
+template <class Fn>
+class TypedAssetDecodeJob final : public AssetDecodeJob {
+public:
+    using Result = std::invoke_result_t<Fn&>;
+
+    explicit TypedAssetDecodeJob(Fn fn) noexcept(std::is_nothrow_move_constructible_v<Fn>)
+        : _fn(std::move(fn)) {}
+
+    void Execute() override { Output.emplace(_fn()); }
+
+    std::optional<Result> Output;
+
+private:
+    Fn _fn;
+};
+
+/// co_await AssetDecodePool::Run 的挂起点。恢复点在 AssetDecodePool::Pump(主线程)。
+class AssetDecodeAwaitable {
+public:
+    AssetDecodeAwaitable(AssetDecodePool* pool, stop_token stop, shared_ptr<AssetDecodeJob> job) noexcept
+        : _pool(pool), _stop(stop), _job(std::move(job)) {}
+
+    bool await_ready() const noexcept;
+    bool await_suspend(std::coroutine_handle<> h);
+    bool await_resume() noexcept;
+
+private:
+    AssetDecodePool* _pool;
+    stop_token _stop;
+    shared_ptr<AssetDecodeJob> _job;
+    AssetDecodeRecord* _record{nullptr};
+};
+
+/// 资产 CPU 阶段的 worker 线程池。
+///
+/// 【只从主线程调用 Run / Pump】: 等待表是 ManualCoroutineScheduler, 与其它 runtime
+/// 调度器一样不加锁; worker 只碰任务队列与完成表。
+/// 派发按提交顺序进行, 队首任务超出预算时后面的任务也等待, 保证大资产不被小资产饿死。
+class AssetDecodePool {
+public:
+    explicit AssetDecodePool(const AssetDecodePoolDescriptor& desc = {});
+    AssetDecodePool(const AssetDecodePool&) = delete;
+    AssetDecodePool(AssetDecodePool&&) = delete;
+    AssetDecodePool& operator=(const AssetDecodePool&) = delete;
+    AssetDecodePool& operator=(AssetDecodePool&&) = delete;
+    /// 取消全部等待者, 丢弃未开始的任务, 等正在执行的任务结束后 join worker。
+    ~AssetDecodePool() noexcept;
+
+    /// 在 worker 线程上执行 fn() 并返回其结果, 协程在主线程的 Pump 中恢复。
+    /// bytes 为 fn 执行期间及其结果的预估内存占用, 只用于节流, 不必精确。
+    /// fn 被移进任务对象, 【不得引用调用方协程帧里的局部量】: 取消后协程先结束, fn 可能仍在执行。
+    /// 被取消时以 stopped 结束当前 task。
+    template <class Fn>
+    requires std::invocable<Fn&> && (!std::is_void_v<std::invoke_result_t<Fn&>>)
+    task<std::invoke_result_t<Fn&>> Run(uint64_t bytes, Fn fn) {
+        auto job = make_shared<TypedAssetDecodeJob<Fn>>(std::move(fn));
+        job->Bytes = bytes;
+        stop_token stop = co_await CurrentStopToken();
+        const bool completed = co_await AssetDecodeAwaitable{this, stop, job};
+        if (!completed) {
+            co_await StopCurrentTask();
+        }
+        co_return std::move(job->Output.value());
+    }
+
+    /// 恢复已完成任务的等待者, 并归还它们占用的预算。每帧在 AssetManager::Pump 之前调用。
+    void Pump();
+
+    /// 对 [0, count) 的每个 i 执行 body(i), 全部完成才返回。供 Run 的任务体把大块计算切开。
+    /// 调用线程自己也领取下标, 空闲 worker 优先于排队任务来帮忙; 因此在 worker 上调用不会死锁,
+    /// 没有空闲 worker 时退化为串行。body 会被多个线程并发调用。可从任意线程调用。
+    void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& body);
+
+    uint32_t GetWorkerCount() const noexcept { return static_cast<uint32_t>(_workers.size()); }
+    uint64_t GetMaxInFlightBytes() const noexcept { return _maxInFlightBytes; }
+    uint64_t GetInFlightBytes() const noexcept;
+
+private:
+    friend class AssetDecodeAwaitable;
+
+    AssetDecodeRecord* Submit(stop_token stop, std::coroutine_handle<> continuation, shared_ptr<AssetDecodeJob> job);
+    void Erase(AssetDecodeRecord* record) noexcept;
+    /// 一次 ParallelFor。住在调用方的栈上, 调用方等 Helpers 归零后才把它摘出 _batches。
+    struct ParallelBatch {
+        const std::function<void(uint32_t)>* Body{nullptr};
+        uint32_t Count{0};
+        std::atomic<uint32_t> Next{0};
+        /// 正在领取下标的 worker 数。受 _mutex 保护。
+        uint32_t Helpers{0};
+    };
+
+    void WorkerMain() noexcept;
+    /// 调用方须持有 _mutex。
+    bool HasDispatchableJobLocked() const noexcept;
+    /// 还有下标没被领走的批次。调用方须持有 _mutex。
+    ParallelBatch* FindOpenBatchLocked() const noexcept;
+    static void RunParallelBatch(ParallelBatch& batch);
+
+    const uint64_t _maxInFlightBytes;
+    ManualCoroutineScheduler<AssetDecodeRecord> _waiters;
+    mutable std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    /// 某个批次的最后一个 helper 退出。
+    std::condition_variable _batchIdle;
+    deque<shared_ptr<AssetDecodeJob>> _pending;
+    vector<ParallelBatch*> _batches;
+    /// worker 执行完、等 Pump 交回主线程的任务。
+    vector<shared_ptr<AssetDecodeJob>> _completed;
+    uint64_t _inFlightBytes{0};
+    uint32_t _inFlightCount{0};
+    bool _stopping{false};
+    vector<std::thread> _workers;
+};
+
+/// pool 为空时在调用线程上直接执行 fn, 供没有 worker 的调用方(测试、工具)复用同一条加载路径。
+template <class Fn>
+requires std::invocable<Fn&> && (!std::is_void_v<std::invoke_result_t<Fn&>>)
+task<std::invoke_result_t<Fn&>> RunOnAssetDecodePool(AssetDecodePool* pool, uint64_t bytes, Fn fn) {
+    if (pool == nullptr) {
+        co_return fn();
+    }
+    co_return co_await pool->Run(bytes, std::move(fn));
+}
+
+}  // namespace radray
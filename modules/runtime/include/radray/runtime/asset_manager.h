@@ -1,6 +1,9 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <concepts>
+#include <span>
 #include <utility>
 
 #include <radray/types.h>
@@ -15,6 +18,7 @@
 namespace radray {
 
 class AssetManager;
+class AssetWaitAllAwaitable;
 class AssetWaitAwaitable;
 class IWaitFrameProcessor;
 class StreamingAssetRefAny;
@@ -31,16 +35,53 @@ struct AssetSlot;
 /// 资产 slot 的生命周期状态。
 /// 【没有 Unloaded】只要还有一个引用指向 slot, slot 就一定存在, 故"已卸载"没有观察者。
 enum class AssetState {
-    Loading,   ///< 空位已占,加载协程在飞,Object 尚未就绪。
+    Loading,   ///< 空位已占,加载排队中或协程在飞,Object 尚未就绪。
     Ready,     ///< 资产已构造,可访问。
     Faulted,   ///< 加载失败。
     Canceled,  ///< 加载被取消。
 };
 
+struct AssetWaitRecord;
+
+/// 等待记录在一个槽位等待链上的节点。单个等待一个节点, WhenAllReady 每个未到终态的槽位一个。
+/// 节点由 awaitable 持有, 挂起期间位于协程帧里, 地址稳定。
+struct AssetWaitLink {
+    AssetWaitRecord* Record{nullptr};
+    /// 节点所在等待链的槽位。由等待者持有的 ref 保住; 槽位进入终态、节点被摘下后为 nullptr。
+    AssetSlot* Slot{nullptr};
+    AssetWaitLink* Prev{nullptr};
+    AssetWaitLink* Next{nullptr};
+};
+
+/// 【一条记录等多个槽位】每个节点所在的槽位进入终态时 Remaining 减一, 减到 0 才恢复等待者。
+/// 槽位只遍历自己的等待链, Pump 的代价与真正到期的等待成正比, 而不是与等待总数。
 struct AssetWaitRecord : ManualCoroutineRecord {
-    /// 等待目标。由等待者持有的 ref 保住, 故在记录存活期内有效。
-    /// 【只用于比较, 不解引用】AssetSlot 在此是不完整类型。
-    const AssetSlot* Slot{nullptr};
+    /// 本记录的全部节点, 由 awaitable 持有。
+    std::span<AssetWaitLink> Links;
+    /// 仍在 Loading 的槽位数。
+    uint32_t Remaining{0};
+};
+
+/// 加载优先级, 数值越小越先准入。
+enum class AssetLoadPriority : uint8_t {
+    Critical,    ///< 不受并发与字节预算限制, 只按提交顺序排在其它 Critical 之后。
+    VisibleNow,  ///< 当前画面要用。默认值。
+    Prefetch,    ///< 马上可能要用。
+    Background,  ///< 空闲时再加载。
+    MAX_COUNT
+};
+
+inline constexpr size_t kAssetLoadPriorityCount = static_cast<size_t>(AssetLoadPriority::MAX_COUNT);
+
+std::string_view format_as(AssetLoadPriority priority) noexcept;
+
+/// 在飞加载的准入上限。Critical 不受限。
+struct AssetLoadBudget {
+    /// 同时运行的加载协程数。
+    uint32_t MaxConcurrentLoads{256};
+    /// 在飞加载的 AssetLoadRequest::EstimatedBytes 之和。
+    /// 超过预算的单个请求只在没有其它在飞加载时准入, 不会永远排不上。
+    uint64_t MaxInFlightBytes{1ull << 30};
 };
 
 /// AssetManager 的加载请求。具体 loader 的参数形状完全由调用方决定;
@@ -49,6 +90,45 @@ struct AssetLoadRequest {
     AssetId Id;
     task<AssetLoadResult> Task;
     string DebugName{};
+    AssetLoadPriority Priority{AssetLoadPriority::VisibleNow};
+    /// 加载期间预估的峰值内存(解码后的像素、顶点等), 计入 AssetLoadBudget。未知时为 0。
+    /// 经 IAssetSource 的 Load(id) / Prefetch 由 IAssetSource::EstimateLoadBytes 填写。
+    uint64_t EstimatedBytes{0};
+};
+
+struct AssetLoadPriorityStats {
+    /// 当前排队、尚未启动的加载数。
+    uint32_t QueuedCount{0};
+    /// 以下为累计值。
+    uint64_t AdmittedCount{0};
+    /// 启动前就因取消或引用全部放开而被丢弃的加载数。
+    uint64_t DroppedBeforeStartCount{0};
+    /// 从提交到启动的排队时间, 按 AdmittedCount 累计。
+    std::chrono::nanoseconds TotalWait{0};
+    std::chrono::nanoseconds MaxWait{0};
+};
+
+/// 零引用 Ready 资产的保活缓存预算。两项各自限制缓存里该类内存之和; 都为 0 (默认) 时不缓存,
+/// 引用归零的资产在下一次 Pump 销毁。只报 CPU 内存的资产只需要 MaxCpuBytes, 反之亦然。
+struct AssetCacheBudget {
+    uint64_t MaxCpuBytes{0};
+    uint64_t MaxGpuBytes{0};
+};
+
+struct AssetCacheStats {
+    uint32_t CachedCount{0};
+    AssetMemorySize CachedBytes{};
+    /// 以下为累计值。Hit 是 Load 命中缓存里的资产, Miss 是 Load 新建了槽位。
+    uint64_t HitCount{0};
+    uint64_t MissCount{0};
+    uint64_t EvictedCount{0};
+    AssetMemorySize EvictedBytes{};
+};
+
+struct AssetLoadStats {
+    std::array<AssetLoadPriorityStats, kAssetLoadPriorityCount> Priorities{};
+    uint32_t RunningLoads{0};
+    uint64_t InFlightBytes{0};
 };
 
 /// 【类型擦除的 streaming 引用】同时表达加载状态与 ready 后的资产访问。
@@ -110,6 +190,7 @@ public:
 
 private:
     friend class AssetManager;
+    friend class AssetWaitAllAwaitable;
     friend class AssetWaitAwaitable;
     template <class U>
     requires std::derived_from<U, Asset>
@@ -205,11 +286,60 @@ private:
     bool Suspend(std::coroutine_handle<> continuation, stop_token stop);
 
     StreamingAssetRefAny _ref;
+    AssetWaitLink _link;
     AssetWaitRecord* _record{nullptr};
     /// 挂起前就已被取消。此时没有记录, 但结论是"没等到"而非"已到终态"。
     bool _canceledBeforeSuspend{false};
 };
 
+/// `co_await WhenAllReady(...)` 的 awaitable: 等一组引用全部离开 Loading 状态。
+/// 【只登记一条计数记录】而不是 N 个各自的等待: 每个未到终态的槽位挂一个节点, 最后一个槽位
+/// 进入终态时恢复一次。await_resume 的含义同 AssetWaitAwaitable。
+///
+/// 【必须来自同一个 AssetManager】记录只能挂在一个 manager 的等待队列上; 混用时记 error,
+/// 不挂起, 结果为 false。
+class AssetWaitAllAwaitable {
+public:
+    explicit AssetWaitAllAwaitable(vector<StreamingAssetRefAny> refs) noexcept : _refs(std::move(refs)) {}
+    AssetWaitAllAwaitable(const AssetWaitAllAwaitable&) = delete;
+    AssetWaitAllAwaitable(AssetWaitAllAwaitable&&) noexcept = default;
+    AssetWaitAllAwaitable& operator=(const AssetWaitAllAwaitable&) = delete;
+    AssetWaitAllAwaitable& operator=(AssetWaitAllAwaitable&&) = delete;
+
+    bool await_ready() const noexcept;
+
+    /// 见 AssetWaitAwaitable::await_suspend。
+    template <class Promise>
+    bool await_suspend(std::coroutine_handle<Promise> continuation) {
+        return Suspend(continuation, GetCoroutineStopToken(continuation));
+    }
+
+    bool await_resume() noexcept;
+
+private:
+    bool Suspend(std::coroutine_handle<> continuation, stop_token stop);
+
+    vector<StreamingAssetRefAny> _refs;
+    /// 挂起时一次定长分配, 之后不再改变大小 —— 槽位的等待链指着这些元素。
+    vector<AssetWaitLink> _links;
+    AssetManager* _manager{nullptr};
+    AssetWaitRecord* _record{nullptr};
+    /// 挂起前就已被取消, 或引用来自不同的 manager。
+    bool _canceledBeforeSuspend{false};
+};
+
+/// 等待 refs 全部离开 Loading 状态。无效引用视为已完成; 空集合立即完成。
+AssetWaitAllAwaitable WhenAllReady(std::span<const StreamingAssetRefAny> refs);
+
+template <class... Refs>
+requires(sizeof...(Refs) > 0 && (std::convertible_to<const Refs&, StreamingAssetRefAny> && ...))
+AssetWaitAllAwaitable WhenAllReady(const Refs&... refs) {
+    vector<StreamingAssetRefAny> all;
+    all.reserve(sizeof...(Refs));
+    (all.emplace_back(refs), ...);
+    return AssetWaitAllAwaitable{std::move(all)};
+}
+
 inline AssetWaitAwaitable StreamingAssetRefAny::operator co_await() const noexcept {
     return AssetWaitAwaitable{*this};
 }
@@ -220,13 +350,32 @@ AssetWaitAwaitable StreamingAssetRef<T>::operator co_await() const noexcept {
     return AssetWaitAwaitable{AsAny()};
 }
 
+/// AssetManager::Prefetch 发起的一组加载。持有组内每个资产的引用, 析构即放开。
+class AssetLoadGroup {
+public:
+    std::span<const StreamingAssetRefAny> GetRefs() const noexcept { return _refs; }
+    size_t Size() const noexcept { return _refs.size(); }
+
+    /// 组内每个加载都已到终态 (Ready / Faulted / Canceled)。
+    bool IsCompleted() const noexcept;
+    /// 组内每个资产都已 Ready。
+    bool IsReady() const noexcept;
+
+private:
+    friend class AssetManager;
+
+    vector<StreamingAssetRefAny> _refs;
+};
+
 /// 资产仓库。按 AssetId 去重的单表 + 引用计数。
 ///
 /// - 单线程使用, 不加锁 (协程推进、表操作、引用增减全在主线程)。
-/// - Load 只接受已创建好的 task<AssetLoadResult>, 再包装为内部 task<void> 提交给 TaskScope。
+/// - Load 只接受已创建好的 task<AssetLoadResult>, 按 AssetLoadPriority 与 AssetLoadBudget
+///   准入后包装为内部 task<void> 提交给 TaskScope。
 /// - slot 自己维护 per-load stop_source 与 pending result; TaskScope 只负责结构化生命周期。
-/// - 【引用计数是唯一的回收权威】没有 Unload / CollectUnreferenced / 闲置缓存。最后一份
-///   引用消失后, 资产在下一次 Pump 里 OnUnload + 析构 + 摘除 slot。
+/// - 【引用计数是唯一的回收权威】没有 Unload / CollectUnreferenced。最后一份引用消失后,
+///   资产在下一次 Pump 里 OnUnload + 析构 + 摘除 slot; 装配了 AssetCacheBudget 时, Ready 资产
+///   先进按放开顺序排列的 LRU, 超出预算才从最久未用的一端挤出。缓存只会让资产活得更久。
 ///
 class AssetManager {
 public:
@@ -240,11 +389,15 @@ public:
     /// GpuSystem。违反时记 error log 并照样卸载, 不 abort (关停期 abort 会掩盖真正的首因)。
     ~AssetManager() noexcept;
 
-    /// 异步发起加载。按 id 去重:命中在飞或已就绪 slot 直接复用。
+    /// 异步发起加载。按 id 去重:命中在飞或已就绪 slot 直接复用; 命中排队中的 slot 且本次
+    /// 优先级更高时把它提上来。
+    ///
+    /// 预算允许且没有同级或更高优先级的请求在排队时立即启动, 否则排队到 Pump 里按优先级准入。
+    /// 【排队中的加载不自持引用】启动前引用全部放开即被丢弃, task 不会运行。
     StreamingAssetRefAny Load(AssetLoadRequest request);
 
     /// 经可选 IAssetSource 按持久 id 发起加载。来源未装配或 id 未登记时记错误并返回空引用。
-    StreamingAssetRefAny Load(const AssetId& id);
+    StreamingAssetRefAny Load(const AssetId& id, AssetLoadPriority priority = AssetLoadPriority::VisibleNow);
 
     /// 类型化加载入口。T 只是返回引用的类型视图,最终实例类型由 loader 的结果决定。
     template <class T>
@@ -253,18 +406,45 @@ public:
 
     template <class T>
     requires std::derived_from<T, Asset>
-    StreamingAssetRef<T> Load(const AssetId& id);
+    StreamingAssetRef<T> Load(const AssetId& id, AssetLoadPriority priority = AssetLoadPriority::VisibleNow);
 
     /// 人类可读路径入口。路径由 IAssetSource 解析为持久 id，再进入同一 slot 表。
     template <class T>
     requires std::derived_from<T, Asset>
-    StreamingAssetRef<T> Load(std::string_view relPath);
+    StreamingAssetRef<T> Load(std::string_view relPath, AssetLoadPriority priority = AssetLoadPriority::VisibleNow);
+
+    /// 经 IAssetSource 展开 roots 的整棵依赖树 (GetDependencies), 一次性发起全部加载。
+    /// 叶子先提交, 同一优先级内先于依赖它们的资产准入; 整组的耗时取决于最慢的那个资产,
+    /// 而不是依赖链上的延迟之和。来源未装配时记错误并返回空组; 无法加载的 id 不进组。
+    AssetLoadGroup Prefetch(std::span<const AssetId> roots, AssetLoadPriority priority = AssetLoadPriority::Prefetch);
+
+    /// 修改一次加载的优先级。排队中的加载移到新优先级的队尾(排队时间照旧从首次提交算起),
+    /// 在下一次 Pump 按新优先级准入; 已启动或已完成的加载不受影响。
+    void SetPriority(const StreamingAssetRefAny& ref, AssetLoadPriority priority) noexcept;
+
+    template <class T>
+    requires std::derived_from<T, Asset>
+    void SetPriority(const StreamingAssetRef<T>& ref, AssetLoadPriority priority) noexcept {
+        SetPriority(ref.AsAny(), priority);
+    }
+
+    void SetLoadBudget(const AssetLoadBudget& budget) noexcept { _loadBudget = budget; }
+    const AssetLoadBudget& GetLoadBudget() const noexcept { return _loadBudget; }
+    AssetLoadStats GetLoadStats() const noexcept;
+
+    /// 设置保活缓存预算。收紧预算立即挤出超出的部分 (它们的 OnUnload 在本调用里执行)。
+    void SetCacheBudget(const AssetCacheBudget& budget);
+    const AssetCacheBudget& GetCacheBudget() const noexcept { return _cacheBudget; }
+    AssetCacheStats GetCacheStats() const noexcept;
 
     /// 等待 streaming 引用离开 Loading 状态。等待者取消不会取消底层资产加载。
     /// 【薄转发】直接 `co_await ref` 等价; 本函数额外把"等待者被取消"转成对当前 task
     /// 的 stop 传播。
     task<void> Wait(StreamingAssetRefAny ref);
 
+    /// 等待整组离开 Loading 状态。组内加载已同时在飞, 经 WhenAllReady 只登记一条等待。
+    task<void> Wait(AssetLoadGroup group);
+
     template <class T>
     requires std::derived_from<T, Asset>
     task<void> Wait(StreamingAssetRef<T> ref);
@@ -293,6 +473,7 @@ public:
     StreamingAssetRef<T> Get(const AssetId& id) noexcept;
 
     /// 请求取消一次在飞加载。终态前生效,协程在挂起点感知后以 Canceled 终止。
+    /// 排队中的加载直接丢弃 task, 下一次 Pump 以 Canceled 提交。
     void Cancel(const StreamingAssetRefAny& ref) noexcept;
 
     template <class T>
@@ -301,7 +482,7 @@ public:
         Cancel(ref.AsAny());
     }
 
-    /// 提交加载协程写入的 pending result, 并销毁引用已归零的资产。
+    /// 提交加载协程写入的 pending result, 销毁引用已归零的资产, 再按优先级准入排队的加载。
     void Pump();
 
     /// 资产内部数据的延迟销毁入口。由 Asset::OnUnload 调用。
@@ -328,6 +509,7 @@ public:
     uint32_t GetAssetCount() const noexcept;
 
 private:
+    friend class AssetWaitAllAwaitable;
     friend class AssetWaitAwaitable;
     friend class StreamingAssetRefAny;
 
@@ -349,11 +531,27 @@ private:
     Slot* FindSlot(const AssetId& id) const noexcept;
     Slot* EmplaceLoadingSlot(const AssetId& id);
     StreamingAssetRefAny MakeRef(Slot* slot) noexcept;
-    StreamingAssetRefAny LoadSourcePath(std::string_view relPath);
+    StreamingAssetRefAny LoadSourcePath(std::string_view relPath, AssetLoadPriority priority);
 
     void PumpLoadResults();
     void FlushDeferredBatch();
 
+    bool CanAdmit(AssetLoadPriority priority, uint64_t bytes) const noexcept;
+    void StartLoad(Slot* slot, task<AssetLoadResult> loadTask);
+    void AdmitQueuedLoads();
+    void LinkQueued(Slot* slot) noexcept;
+    void UnlinkQueued(Slot* slot) noexcept;
+    /// 丢弃排队中、尚未启动的加载。
+    void DropQueuedLoad(Slot* slot) noexcept;
+    void CancelQueuedLoads();
+    void RecordAdmission(const Slot* slot) noexcept;
+
+    /// 零引用的 Ready 槽位放进保活缓存。预算未装配或资产单独就超出预算时返回 false。
+    bool TryCacheSlot(Slot* slot);
+    void UnlinkCached(Slot* slot) noexcept;
+    /// 从最久未用的一端挤出, 直到缓存回到预算以内。
+    void EvictCachedSlots();
+
     task<void> RunLoad(StreamingAssetRefAny ref, task<AssetLoadResult> loadTask);
     void StoreLoadResult(Slot* slot, AssetLoadResult result) noexcept;
     void StoreLoadCanceled(Slot* slot) noexcept;
@@ -361,27 +559,51 @@ private:
     void ResumeWaiters(Slot* slot) noexcept;
     void CollectZeroRefSlots();
     void DestroySlot(Slot* slot) noexcept;
+    void EnqueueZeroRef(Slot* slot) noexcept;
 
-    AssetWaitRecord* RegisterWait(Slot* slot, stop_token stop, std::coroutine_handle<> continuation);
+    /// links 的 Slot 须已填好且都在 Loading; 本函数把每个节点挂到其槽位的等待链尾。
+    AssetWaitRecord* RegisterWait(std::span<AssetWaitLink> links, stop_token stop, std::coroutine_handle<> continuation);
+    /// 把记录仍挂着的节点从等待链上摘下, 并从 _waiters 移除记录。
+    void UnregisterWait(AssetWaitRecord* record) noexcept;
 
     void EnqueueDeferred(unique_ptr<DeferredPayload> payload);
     task<void> RunDeferredDestroy(vector<unique_ptr<DeferredPayload>> batch);
 
     static void AddRef(Slot* slot) noexcept;
-    static void Release(Slot* slot) noexcept;
+    static void Release(AssetManager* manager, Slot* slot) noexcept;
 
     IWaitFrameProcessor* _waitFrame{nullptr};
     Nullable<IAssetSource*> _assetSource{nullptr};
     TaskScope _loadScope;
     ManualCoroutineScheduler<AssetWaitRecord> _waiters;
     unordered_map<AssetId, unique_ptr<Slot>> _slots;
-    /// 在飞加载的 slot。manager 自持一份引用 —— 加载期间外部引用可能全部消失, 但槽位要
-    /// 活到协程跑完。
-    vector<StreamingAssetRefAny> _activeLoads;
+    /// 已写好 pending result、待 Pump 提交的加载。RunLoad 结束时把自己持有的那份引用移进来 ——
+    /// 加载期间外部引用可能全部消失, 但槽位要活到结果被提交。Pump 只处理这张表。
+    vector<StreamingAssetRefAny> _completedLoads;
+    /// 引用计数归零的槽位, 经 AssetSlot::NextZeroRef 串成的 FIFO。Pump 只回收这条队列上的槽位,
+    /// 代价与本帧的变化量成正比, 而不是与槽位总数。
+    AssetSlot* _zeroRefHead{nullptr};
+    AssetSlot* _zeroRefTail{nullptr};
     /// 本帧待延迟销毁的 payload。Pump 时整批交给一个协程。
     vector<unique_ptr<DeferredPayload>> _pendingDeferred;
-    /// 递归保护: CollectZeroRefSlots 里销毁资产会放开它持有的引用, 从而令更多 slot 归零。
+    /// 递归保护: CollectZeroRefSlots 里销毁资产会放开它持有的引用, 从而令更多 slot 归零
+    /// (它们排到队尾, 由同一次回收继续处理)。
     bool _collecting{false};
+
+    /// 排队中、尚未启动的加载, 每个优先级一条经 AssetSlot::PrevQueued/NextQueued 串成的 FIFO。
+    /// 侵入式双链表: 提优先级与启动前丢弃都是 O(1)。
+    std::array<AssetSlot*, kAssetLoadPriorityCount> _queueHeads{};
+    std::array<AssetSlot*, kAssetLoadPriorityCount> _queueTails{};
+    std::array<AssetLoadPriorityStats, kAssetLoadPriorityCount> _priorityStats{};
+    AssetLoadBudget _loadBudget{};
+    uint32_t _runningLoads{0};
+    uint64_t _inFlightLoadBytes{0};
+
+    /// 保活缓存, 经 AssetSlot::PrevCached/NextCached 串成的 LRU: 头部最久未用。
+    AssetSlot* _cacheHead{nullptr};
+    AssetSlot* _cacheTail{nullptr};
+    AssetCacheBudget _cacheBudget{};
+    AssetCacheStats _cacheStats{};
 };
 
 template <class T>
@@ -392,14 +614,14 @@ StreamingAssetRef<T> AssetManager::Load(AssetLoadRequest request) {
 
 template <class T>
 requires std::derived_from<T, Asset>
-StreamingAssetRef<T> AssetManager::Load(const AssetId& id) {
-    return Load(id).template CastTo<T>();
+StreamingAssetRef<T> AssetManager::Load(const AssetId& id, AssetLoadPriority priority) {
+    return Load(id, priority).template CastTo<T>();
 }
 
 template <class T>
 requires std::derived_from<T, Asset>
-StreamingAssetRef<T> AssetManager::Load(std::string_view relPath) {
-    return LoadSourcePath(relPath).template CastTo<T>();
+StreamingAssetRef<T> AssetManager::Load(std::string_view relPath, AssetLoadPriority priority) {
+    return LoadSourcePath(relPath, priority).template CastTo<T>();
 }
 
 template <class T>
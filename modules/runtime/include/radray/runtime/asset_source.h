@@ -1,7 +1,9 @@
 #pragma once
 
 #include <concepts>
+#include <filesystem>
 #include <optional>
+#include <span>
 #include <string_view>
 #include <utility>
 
@@ -15,6 +17,13 @@ struct AssetLoadResult {
     unique_ptr<Asset> Object;
     const RuntimeTypeInfo* TypeInfo{nullptr};
     string Error;
+    /// 加载中发现的依赖 (例如材质引用的贴图)。提交时交给 IAssetSource::RecordDependencies,
+    /// 供之后的 AssetManager::Prefetch 一次展开整棵依赖树。
+    vector<AssetId> Dependencies;
+    /// 加载中读到的、按文件路径引用的其他源文件 (绝对路径, 例如 OBJ 材质库里的贴图)。importer
+    /// 不认识 GUID, 提交时经 IAssetSource::ResolveSourceFile 换成 GUID 并入 Dependencies;
+    /// 来源里没登记的文件忽略。
+    vector<std::filesystem::path> ReferencedFiles;
     bool Succeeded{false};
 
     static AssetLoadResult Success(unique_ptr<Asset> object, const RuntimeTypeInfo& typeInfo) noexcept {
@@ -49,6 +58,31 @@ public:
 
     virtual std::optional<task<AssetLoadResult>> CreateLoadTask(const AssetId& id) = 0;
     virtual std::optional<AssetId> ResolveId(std::string_view relPath) const = 0;
+
+    /// 加载 id 期间预估的峰值内存, AssetManager::Load(id) 把它填进 AssetLoadRequest::EstimatedBytes。
+    /// 只看元数据, 不读文件内容。未知时为 0, 即不受字节预算约束。
+    virtual uint64_t EstimateLoadBytes(const AssetId& id) const {
+        (void)id;
+        return 0;
+    }
+
+    /// id 的直接依赖。返回的 span 在下一次修改本来源之前有效。未登记或没有依赖时为空。
+    virtual std::span<const AssetId> GetDependencies(const AssetId& id) const {
+        (void)id;
+        return {};
+    }
+
+    /// 源文件绝对路径对应的资产。不按文件组织的来源, 或文件没登记时为 nullopt。
+    virtual std::optional<AssetId> ResolveSourceFile(const std::filesystem::path& absolutePath) const {
+        (void)absolutePath;
+        return std::nullopt;
+    }
+
+    /// 记下加载时发现的直接依赖, 覆盖原有记录。不持久化依赖的来源忽略它。
+    virtual void RecordDependencies(const AssetId& id, std::span<const AssetId> dependencies) {
+        (void)id;
+        (void)dependencies;
+    }
 };
 
 }  // namespace radray
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include <radray/file.h>
+#include <radray/types.h>
+
+// importer 产物(解码后的 mip 链、处理好的顶点/索引数据)的本机磁盘缓存。
+// 源文件、settings 与 importer 版本都不变时, 加载跳过解码, 直接读回上次的产物。
+
+namespace radray {
+
+class AssetImportSettings;
+
+/// 缓存键。任何一项变化都视为不同产物; importer 改动产物格式或算法时必须递增 ImporterVersion。
+struct DerivedDataKey {
+    std::string_view ImporterType;
+    uint32_t ImporterVersion{0};
+    /// 源文件内容的 XXH64。
+    uint64_t SourceHash{0};
+    /// 紧凑序列化后 settings 的 XXH64, 无 settings 时为 0。见 HashImportSettings。
+    uint64_t SettingsHash{0};
+};
+
+struct DerivedDataCacheDescriptor {
+    /// 缓存目录。本机产物, 不应提交; 空路径表示不启用。
+    std::filesystem::path Directory{};
+    /// 条目总字节上限。超出时按最近使用时间从旧到新删除。
+    uint64_t MaxBytes{4ull << 30};
+};
+
+/// 单个 importer 的命中统计。
+struct DerivedDataStats {
+    uint64_t Hits{0};
+    uint64_t Misses{0};
+    uint64_t Writes{0};
+    /// 命中时 "当初烘焙耗时 - 本次读取耗时" 之和。
+    double SavedMilliseconds{0.0};
+
+    double GetHitRate() const noexcept {
+        const uint64_t lookups = Hits + Misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(Hits) / static_cast<double>(lookups);
+    }
+};
+
+/// DerivedDataCache::Map 的结果。Payload 指向 File 的映射区, 起点即文件起点 (页对齐)。
+/// 【移动 File 不改变映射地址】, Payload 随本对象移动仍然有效。
+struct MappedDerivedData {
+    MappedFile File;
+    std::span<const byte> Payload;
+};
+
+/// settings 的缓存键分量: 紧凑 JSON 序列化后的 XXH64。settings 为空或序列化失败时返回 0。
+uint64_t HashImportSettings(const AssetImportSettings* settings) noexcept;
+
+/// 按 DerivedDataKey 存取产物的磁盘缓存。每个条目一个文件, 尾部记录完整键与内容哈希,
+/// 键哈希碰撞、截断或损坏的文件都按未命中处理并删除。
+///
+/// 【线程安全】: Get / Map / Put 在 AssetDecodePool 的 worker 上调用。文件读写不持锁,
+/// 只有条目表与统计受 _mutex 保护。最近使用时间写回文件 mtime, 重启后 LRU 顺序仍然有效。
+class DerivedDataCache {
+public:
+    explicit DerivedDataCache(const DerivedDataCacheDescriptor& desc);
+    DerivedDataCache(const DerivedDataCache&) = delete;
+    DerivedDataCache(DerivedDataCache&&) = delete;
+    DerivedDataCache& operator=(const DerivedDataCache&) = delete;
+    DerivedDataCache& operator=(DerivedDataCache&&) = delete;
+    ~DerivedDataCache() noexcept;
+
+    /// 命中时返回产物字节, 一次读盘, 不额外拷贝。
+    std::optional<vector<byte>> Get(const DerivedDataKey& key);
+
+    /// 与 Get 相同的校验与统计, 但把条目映射进内存而不是读进缓冲, 适合直接拷进 staging 的大产物。
+    /// 【Windows 上映射期间条目不能被删除或替换】: 淘汰与同键 Put 会失败并只记 warning,
+    /// 因此结果不要持有超过一次加载。
+    std::optional<MappedDerivedData> Map(const DerivedDataKey& key);
+
+    /// 写入产物并按需淘汰旧条目。cookMilliseconds 是生成这份产物的耗时, 用于统计命中节省的时间。
+    /// 单个就超出上限的产物不写入。写盘失败只记 warning, 返回 false。
+    bool Put(const DerivedDataKey& key, std::span<const byte> payload, double cookMilliseconds);
+
+    DerivedDataStats GetStats(std::string_view importerType) const;
+    uint64_t GetTotalBytes() const noexcept;
+    uint32_t GetEntryCount() const noexcept;
+    const std::filesystem::path& GetDirectory() const noexcept { return _directory; }
+    uint64_t GetMaxBytes() const noexcept { return _maxBytes; }
+
+private:
+    struct Entry {
+        uint64_t Bytes{0};
+        /// 单调递增的使用序号, 越大越新。
+        uint64_t LastUse{0};
+    };
+
+    std::filesystem::path GetEntryPath(const DerivedDataKey& key) const;
+    /// 条目表里没有时记一次未命中并返回 false。
+    bool BeginLookup(const DerivedDataKey& key, const std::filesystem::path& path);
+    /// 读盘 / 映射之后的 LRU 与统计。cookMilliseconds 为空表示文件缺失或损坏, fileRead 时删掉文件。
+    void FinishLookup(
+        const DerivedDataKey& key,
+        const std::filesystem::path& path,
+        bool fileRead,
+        std::optional<float> cookMilliseconds,
+        std::chrono::steady_clock::time_point start);
+    void RecordLookup(std::string_view importerType, bool hit, double savedMilliseconds);
+    /// 调用方须持有 _mutex。
+    void EvictLocked(uint64_t reserveBytes);
+    /// 调用方须持有 _mutex。
+    void EraseLocked(const string& fileName);
+
+    const std::filesystem::path _directory;
+    const uint64_t _maxBytes;
+    mutable std::mutex _mutex;
+    unordered_map<string, Entry> _entries;
+    unordered_map<string, DerivedDataStats> _stats;
+    uint64_t _totalBytes{0};
+    uint64_t _useClock{0};
+};
+
+}  // namespace radray
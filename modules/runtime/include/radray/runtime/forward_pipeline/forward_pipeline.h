@@ -10,6 +10,14 @@ class CameraComponent;
 class ForwardDrawPass;
 class Scene;
 
+/// Draw bookkeeping of the most recent PrepareCamera.
+struct ForwardPipelineStats {
+    uint32_t PreparedDrawCount{0};
+    uint32_t ValidDrawCount{0};
+    /// Per-draw dynamic offset lists that outgrew their inline storage and hit the heap.
+    uint32_t HeapDrawListCount{0};
+};
+
 class ForwardPipeline final : public RenderPipeline {
 public:
     ForwardPipeline(
@@ -22,6 +30,8 @@ public:
         return BindingGroupPlan{0, 1, 2};
     }
 
+    ForwardPipelineStats GetStats() const noexcept;
+
 protected:
     void OnBeginFrame(RenderPipelineContext& ctx) override;
     void OnBuildCameraList(
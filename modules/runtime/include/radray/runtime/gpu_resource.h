@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <limits>
 #include <optional>
 #include <span>
@@ -100,7 +101,12 @@ struct TextureUploadRequest {
     std::span<const byte> SrcData;
     render::Texture* DstTexture;
     render::SubresourceRange DstRange;
+    /// 源数据相邻两行的字节距离, 0 表示紧密排列。块压缩格式的"行"是一行 4x4 块。
+    /// 等于设备对齐后的行距时整级一次 memcpy 进 staging。
     uint64_t SrcRowPitch{0};
+    /// SrcData 为空时由它直接写 staging: dst 为整个 subresource, 行距 rowPitch (已按设备对齐)。
+    /// 用于解码器直接落进上传缓冲 (如 ImageData::DecodePNG / DecodeJPEG), 省去中间图像。返回 false 时放弃本次上传。
+    std::function<bool(std::span<byte> dst, uint64_t rowPitch)> WriteRows;
     render::TextureStates Before{render::TextureState::Undefined};
     render::TextureStates After{render::TextureState::ShaderRead};
 };
@@ -188,7 +188,7 @@ public:
     bool EraseUpload(FrameUploadRecord* record) noexcept;
 
 private:
-    bool IsUploadAlive(FrameUploadRecord* record) const noexcept;
+    bool IsUploadAlive(FrameUploadRecord* record, uint64_t ticket) const noexcept;
     void ResumeRecord(FrameUploadRecord* record);
     void CancelRecord(FrameUploadRecord* record) noexcept;
 
@@ -16,6 +16,7 @@ public:
 
     void OnUnload(AssetManager& manager) override;
     RuntimeTypeId GetTypeId() const noexcept override;
+    AssetMemorySize GetMemorySize() const noexcept override;
 
     bool IsValid() const noexcept { return _image.Data != nullptr && _image.Width != 0 && _image.Height != 0; }
 
@@ -34,7 +35,9 @@ struct ImageAssetLoadOptions {
 };
 
 ImageData MakeSolidImage(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
-ImageData ConvertToRGBA8(const ImageData& src);
+/// 转成 RGBA8。R 与 RG 视作灰度与灰度 + alpha, 16 位通道收窄到 8 位; half / float 等不支持的格式得到白色 1x1。
+/// 按值接收: 调用方 move 进来时不比 RGBA8 大的源直接在原缓冲里转换, 不再另拷一份。
+ImageData ConvertToRGBA8(ImageData src);
 
 /// 解码 PNG/JPEG 编码字节为 ImageData。失败返回 nullopt。RGB 源自动补 alpha=0xff。
 /// 供不走 ImageAsset 的调用方(如 glTF 加载协程直接解码后上传 GPU)复用。
@@ -8,6 +8,7 @@
 #include <radray/runtime/render_framework/render_types.h>
 #include <radray/runtime/shader_parameters.h>
 #include <radray/runtime/texture_asset.h>
+#include <radray/small_vector.h>
 #include <radray/types.h>
 
 namespace radray {
@@ -19,6 +20,8 @@ struct MaterialBufferBinding {
     render::ShaderBufferBinding Value;
 };
 
+using MaterialBufferBindingList = SmallVector<MaterialBufferBinding, 4>;
+
 class Material {
 public:
     static Nullable<unique_ptr<Material>> Create(
@@ -60,6 +63,10 @@ public:
         const render::SamplerDescriptor& sampler,
         uint32_t element = 0) noexcept;
 
+    /// 已绑定的贴图, 按 SetTexture 首次绑定的次序。仍在加载的返回 nullptr。贴图流送据此上报需求。
+    uint32_t GetBoundTextureCount() const noexcept;
+    const TextureAsset* GetBoundTexture(uint32_t index) const noexcept;
+
     Nullable<render::ShaderParameterSet*> PrepareParameterSet(
         uint32_t flightIndex,
         std::span<const MaterialBufferBinding> bufferBindings) noexcept;
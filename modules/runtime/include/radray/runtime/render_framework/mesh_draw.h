@@ -10,6 +10,7 @@ namespace radray {
 
 class Material;
 class Scene;
+class TextureStreamingManager;
 
 struct MeshDrawItem {
     const GpuMesh::DrawData* Geometry;
@@ -19,12 +20,25 @@ struct MeshDrawItem {
     uint32_t IndexCount{0};
     int32_t VertexOffset{0};
     uint32_t SectionIndex{0};
+    uint32_t LodIndex{0};
     float ViewDepth{0.0f};
 };
 
+/// Collect 顺带上报贴图流送需求所需的视图参数。Manager 为空时不上报。
+struct MeshDrawStreamingView {
+    TextureStreamingManager* Manager{nullptr};
+    /// 视距 1 处一个世界单位在屏幕上的像素数: 0.5 * 视口高 * proj(1, 1)。
+    float PixelsPerUnit{0.0f};
+};
+
 class MeshDrawList {
 public:
-    void Collect(const Scene* scene, const Eigen::Matrix4f& viewMatrix);
+    /// lod 为默认值时总用最细一级。
+    void Collect(
+        const Scene* scene,
+        const Eigen::Matrix4f& viewMatrix,
+        const MeshDrawStreamingView& streaming = {},
+        const MeshLodView& lod = {});
     void Sort();
     void Clear() noexcept { _items.clear(); }
 
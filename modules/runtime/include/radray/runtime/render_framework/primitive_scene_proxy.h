@@ -20,6 +20,23 @@ struct MeshDrawArgs {
     uint32_t FirstIndex{0};
     uint32_t IndexCount{0};
     int32_t VertexOffset{0};
+    // 贴图流送用: 本地空间包围球与 section 的 UV 密度 (见 StaticMeshSection::UvDensity)。
+    // UvDensity 为 0 表示不参与流送需求。
+    Eigen::Vector3f BoundsCenter{Eigen::Vector3f::Zero()};
+    float BoundsRadius{0.0f};
+    float UvDensity{0.0f};
+    // 量化顶点的位置反量化 (见 MeshPrimitive::PositionOffset)。Collect 把它并进 MeshDrawItem::LocalToWorld,
+    // 着色器直接拿存储值乘物体变换。
+    Eigen::Vector3f PositionOffset{Eigen::Vector3f::Zero()};
+    float PositionScale{1.0f};
+};
+
+/// 选 LOD 的视图参数。PixelsPerUnit 不为正时总用最细一级。
+struct MeshLodView {
+    /// 视距 1 处一个世界单位在屏幕上的像素数, 同 MeshDrawStreamingView::PixelsPerUnit。
+    float PixelsPerUnit{0.0f};
+    /// 简化误差投到屏幕上允许的像素数。
+    float MaxPixelError{1.0f};
 };
 
 /// 渲染基本体组件的侧代理。
@@ -39,9 +56,12 @@ public:
     /// 基类默认单位阵; 具体 proxy 覆写。
     virtual Eigen::Matrix4f GetLocalToWorld() const noexcept { return Eigen::Matrix4f::Identity(); }
 
-    /// 取指定 section 的绘制参数 (几何 + 索引范围)。执行器据此绑定 VB/IB 并 DrawIndexed。
-    /// 基类默认无几何 (Geometry=nullptr); 具体 proxy 覆写。
-    virtual MeshDrawArgs GetDrawArgs(uint32_t /*sectionIndex*/) const noexcept { return MeshDrawArgs{}; }
+    /// 本视图下的 LOD 级别, 同一 proxy 的所有 section 共用。基类默认 0 (最细一级)。
+    virtual uint32_t SelectLod(const Eigen::Matrix4f& /*viewMatrix*/, const MeshLodView& /*view*/) const noexcept { return 0; }
+
+    /// 取指定 section 在 lodIndex 级的绘制参数 (几何 + 索引范围)。执行器据此绑定 VB/IB 并 DrawIndexed。
+    /// lodIndex 超出 section 的级数时取最粗一级。基类默认无几何 (Geometry=nullptr); 具体 proxy 覆写。
+    virtual MeshDrawArgs GetDrawArgs(uint32_t /*sectionIndex*/, uint32_t /*lodIndex*/) const noexcept { return MeshDrawArgs{}; }
     virtual uint32_t GetSectionCount() const noexcept { return 0; }
     virtual Nullable<Material*> GetMaterial(uint32_t /*sectionIndex*/) const noexcept { return nullptr; }
 
@@ -19,7 +19,8 @@ public:
     ~StaticMeshSceneProxy() noexcept override;
 
     Eigen::Matrix4f GetLocalToWorld() const noexcept override { return _localToWorld; }
-    MeshDrawArgs GetDrawArgs(uint32_t sectionIndex) const noexcept override;
+    uint32_t SelectLod(const Eigen::Matrix4f& viewMatrix, const MeshLodView& view) const noexcept override;
+    MeshDrawArgs GetDrawArgs(uint32_t sectionIndex, uint32_t lodIndex) const noexcept override;
     uint32_t GetSectionCount() const noexcept override;
     Nullable<Material*> GetMaterial(uint32_t sectionIndex) const noexcept override;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <optional>
+#include <span>
 
 #include <radray/hash.h>
 #include <radray/nullable.h>
@@ -8,20 +9,24 @@
 #include <radray/runtime/material_state.h>
 #include <radray/runtime/render_framework/primitive_vertex_layout.h>
 #include <radray/runtime/shader_parameters.h>
+#include <radray/small_vector.h>
 #include <radray/types.h>
 
 namespace radray {
 
 struct GraphicsPassState {
+    // Stored inline so the usual one to four color targets never allocate.
+    using ColorFormatList = SmallVector<render::TextureFormat, 4>;
+
     GraphicsPassState(
-        vector<render::TextureFormat> colorFormats,
+        std::span<const render::TextureFormat> colorFormats,
         std::optional<render::TextureFormat> depthStencilFormat,
         uint32_t sampleCount,
         render::RenderPass* compatibleRenderPass) noexcept;
 
     bool IsValid() const noexcept;
 
-    vector<render::TextureFormat> ColorFormats;
+    ColorFormatList ColorFormats;
     std::optional<render::TextureFormat> DepthStencilFormat;
     uint32_t SampleCount;
     render::RenderPass* CompatibleRenderPass;
@@ -66,9 +71,9 @@ private:
     };
 
     // Borrowed view of a PsoKey used for cache lookups. The draw loop asks for a PSO
-    // once per draw, and an owning PsoKey allocates for its format vector, its vertex
-    // buffer/attribute vectors and every attribute semantic string. Looking up through
-    // this view keeps the hit path allocation free; only a miss materializes a key.
+    // once per draw, and an owning PsoKey allocates for its vertex buffer/attribute
+    // vectors and every attribute semantic string. Looking up through this view keeps
+    // the hit path allocation free; only a miss materializes a key.
     struct PsoKeyRef {
         const MaterialPipelineState* MaterialState;
         const PrimitiveVertexLayout* VertexLayout;
@@ -12,6 +12,35 @@
 namespace radray {
 
 class FrameUploadScheduler;
+class AssetDecodePool;
+class DerivedDataCache;
+
+class MeshImportSettings;
+
+template <>
+struct RuntimeTypeTrait<MeshImportSettings> {
+    static constexpr RuntimeTypeId value{0x5e0c27d4, 0x3a91, 0x4b6e, 0x8f, 0x15, 0xc2, 0x7a, 0x90, 0x3d, 0x61, 0xe8};
+    using Bases = std::tuple<>;
+};
+
+class MeshImportSettings final : public AssetImportSettings {
+public:
+    const RuntimeTypeInfo& GetTypeInfo() const noexcept override;
+    bool Deserialize(const JsonValue& json) override;
+    bool Serialize(JsonWriteContext& context) const noexcept override;
+
+    /// 导入时焊接重复顶点并做顶点缓存、overdraw 与顶点获取重排 (见 mesh_optimizer.h)。
+    /// 只在非默认值时写入 manifest。
+    bool Optimize{true};
+    /// 导入时生成的 LOD 级数 (含 LOD0, 见 mesh_simplifier.h), 1 表示不生成, 上限 kMaxLodCount。
+    /// 网格太小或简化不动时实际级数会更少。只在非默认值时写入 manifest。
+    uint32_t LodCount{4};
+    /// 导入时把顶点属性存成压缩格式 (见 TriangleMesh::ToQuantizedMeshResource), 顶点字节数约减半。
+    /// 用这种网格的材质要选 forward 着色器的 VERTEX_FORMAT=quantized 变体。只在非默认值时写入 manifest。
+    bool QuantizeVertices{false};
+
+    static constexpr uint32_t kMaxLodCount = 8;
+};
 
 struct StaticMeshSection {
     StaticMeshSection() noexcept;
@@ -29,6 +58,9 @@ struct StaticMeshSection {
     uint32_t MinVertexIndex;
     uint32_t MaxVertexIndex;
     int32_t VertexOffset;
+    /// 本地空间长度 / UV 单位 (TEXCOORD0), 贴图流送用来估算屏幕上的 texel 密度。
+    /// 取 section 内三角形面积和与 UV 面积和之比的平方根; 没有 UV 或 UV 退化时为 0。
+    float UvDensity;
 };
 
 /// CPU 网格数据的自洽性校验。section 为空时只校验 primitive。
@@ -40,6 +72,15 @@ bool IsStaticMeshDataValid(
     const MeshResource& meshResource,
     std::span<const StaticMeshSection> sections) noexcept;
 
+/// section 的 UV 密度 (见 StaticMeshSection::UvDensity)。只认三角形列表与 float POSITION0 / TEXCOORD0,
+/// 其余情况返回 0。调用方须先通过 IsStaticMeshDataValid。
+float ComputeStaticMeshUvDensity(
+    const MeshResource& meshResource,
+    const StaticMeshSection& section) noexcept;
+
+/// 本地空间误差不超过 errorBudget 的最粗一级 LOD (lods 由细到粗, 见 MeshLodEntry)。lods 为空时返回 0。
+uint32_t SelectStaticMeshLod(std::span<const MeshLodEntry> lods, float errorBudget) noexcept;
+
 /// 静态网格资产。CPU 网格数据 + section/bounds + 已上传的 GPU 渲染数据。
 ///
 /// 【构造即完整】: CPU 数据与 GPU 上传都由加载协程在构造前备齐, 资产一出生即可渲染,
@@ -56,6 +97,7 @@ public:
 
     void OnUnload(AssetManager& manager) override;
     RuntimeTypeId GetTypeId() const noexcept override;
+    AssetMemorySize GetMemorySize() const noexcept override;
 
     const MeshResource& GetMeshResource() const noexcept { return _meshResource; }
     const vector<StaticMeshSection>& GetSections() const noexcept { return _sections; }
@@ -86,20 +128,33 @@ task<AssetLoadResult> LoadStaticMesh(
     FrameUploadScheduler& frameUploads,
     MeshResource meshResource);
 
-class MeshImporter final : public AssetImporter {
+class MeshImporter final : public TypedAssetImporter<MeshImportSettings> {
 public:
-    explicit MeshImporter(FrameUploadScheduler& frameUploads) noexcept;
+    /// derivedData 可为空; 非空时必须活过 decodePool 的全部 worker 任务。
+    MeshImporter(
+        FrameUploadScheduler& frameUploads,
+        AssetDecodePool& decodePool,
+        DerivedDataCache* derivedData = nullptr) noexcept;
 
     std::string_view GetTypeName() const noexcept override;
     std::span<const std::string_view> GetFileExtensions() const noexcept override;
-    task<AssetLoadResult> Load(const AssetLoadContext& ctx) override;
+
+protected:
+    task<AssetLoadResult> LoadTyped(
+        std::filesystem::path path,
+        MeshImportSettings settings) override;
 
 private:
     static task<AssetLoadResult> LoadMesh(
         FrameUploadScheduler* frameUploads,
-        std::filesystem::path path);
+        AssetDecodePool* decodePool,
+        DerivedDataCache* derivedData,
+        std::filesystem::path path,
+        MeshImportSettings settings);
 
     FrameUploadScheduler& _frameUploads;
+    AssetDecodePool& _decodePool;
+    DerivedDataCache* _derivedData;
 };
 
 template <>
@@ -1,20 +1,28 @@
 #pragma once
 
+#include <atomic>
 #include <filesystem>
 
 #include <radray/hash.h>
 #include <radray/image_data.h>
+#include <radray/mip_chain.h>
 #include <radray/render/rhi.h>
 #include <radray/runtime/asset.h>
 #include <radray/runtime/asset_database.h>
 #include <radray/runtime/asset_manager.h>
+#include <radray/runtime/texture_container.h>
 
 namespace radray {
 
 class FrameUploadScheduler;
+class AssetDecodePool;
+class DerivedDataCache;
 
 class TextureImportSettings;
 
+struct TextureMipStream;
+class TextureStreamingManager;
+
 template <>
 struct RuntimeTypeTrait<TextureImportSettings> {
     static constexpr RuntimeTypeId value{0xbb83ae65, 0x95ec, 0x4737, 0xb9, 0x02, 0x64, 0x64, 0x72, 0xec, 0x6d, 0x9c};
@@ -29,6 +37,10 @@ public:
 
     bool Srgb{true};
     bool GenerateMips{true};
+    /// 只在非默认值时写入 manifest。
+    MipFilter Filter{MipFilter::Box};
+    /// 只在非默认值时写入 manifest。
+    TextureCompression Compression{TextureCompression::None};
 };
 
 /// 一个【非默认 SRV】的差异描述值 (对应 UE5 的 FRHITextureSRVCreateInfo)。
@@ -70,35 +82,65 @@ struct hash<radray::TextureSubViewDesc> {
 
 namespace radray {
 
+/// 被换下的贴图与它的全部 view。Texture 先声明, 故析构时 view 先于贴图释放。
+struct RetiredTexture {
+    unique_ptr<render::Texture> Texture;
+    vector<unique_ptr<render::TextureView>> Views;
+};
+
 /// GPU 贴图资产。对应 UE5 的 UTexture2D (最小化)。持有已上传的 device-local
 /// render::Texture + 默认全量 SRV, 并内建一个按 TextureSubViewDesc 去重的子 view 缓存
 /// (对应 UE5 挂在 texture 上的 FRHITextureViewCache)。
 ///
-/// 构造即完整 (CPU 解码 + GPU 上传由加载协程在构造前完成), 与纯 CPU 的 ImageAsset 解耦。
-/// view 所有权归本资产且永生至资产销毁, 故绑定点拿到的 view 指针在持有一份
-/// StreamingAssetRef 期间永不悬垂 —— 材质快照只需存 "ref + 描述值", 零裸指针。
+/// 构造时至少 mip 链的尾部已驻留 (CPU 解码 + GPU 上传由加载协程在构造前完成), 与纯 CPU 的
+/// ImageAsset 解耦。可流送的贴图由 TextureStreamingManager 按屏幕需求增减驻留的 mip: 底层贴图
+/// 只含 [GetResidentMip(), GetMipCount()) 这几级, 驻留范围每变一次就整张换掉, 默认 SRV 与子 view
+/// 随之重建, GetViewVersion() 递增。换下的贴图与 view 交给管理器, 等此前提交的 GPU 工作完成后释放。
+/// 因此绑定点拿到的 view 指针只在【同一 view 版本】内稳定 —— 材质快照存 "ref + 描述值",
+/// 比较 GetViewVersion() 后重新取 view。
 class TextureAsset : public Asset {
 public:
+    /// texture 只含完整链的 [residentMip, 链尾), srv 覆盖它的全部 mip。stream 非空表示可流送,
+    /// 完整链的尺寸取自 stream->Container; 否则 residentMip 须为 0。
     TextureAsset(
         render::Device* device,
         string name,
         unique_ptr<render::Texture> texture,
-        unique_ptr<render::TextureView> srv) noexcept;
+        unique_ptr<render::TextureView> srv,
+        uint32_t residentMip = 0,
+        shared_ptr<TextureMipStream> stream = nullptr) noexcept;
     ~TextureAsset() noexcept override;
 
     void OnUnload(AssetManager& manager) override;
     RuntimeTypeId GetTypeId() const noexcept override;
+    AssetMemorySize GetMemorySize() const noexcept override;
 
     bool IsValid() const noexcept { return _texture != nullptr && _srv != nullptr; }
 
     const string& GetName() const noexcept { return _name; }
+    /// 底层贴图。它的 mip 0 是完整链的 GetResidentMip()。
     render::Texture* GetTexture() const noexcept { return _texture.get(); }
     render::TextureView* GetSrv() const noexcept { return _srv.get(); }
+    /// 完整 mip 链的尺寸与级数, 与当前驻留无关。
+    uint32_t GetWidth() const noexcept { return _width; }
+    uint32_t GetHeight() const noexcept { return _height; }
+    uint32_t GetMipCount() const noexcept { return _mipCount; }
+    /// 已驻留的最高精度 mip。0 表示整条链都已驻留。可在任何线程读取。
+    uint32_t GetResidentMip() const noexcept { return _residentMip.load(std::memory_order_acquire); }
+    /// 每次 ReplaceTexture 换 view 时递增。
+    uint64_t GetViewVersion() const noexcept { return _viewVersion; }
+
+    /// 换上只含 [residentMip, 链尾) 的新贴图, 由 TextureStreamingManager 在 upload phase 调用。
+    /// 默认 SRV 随之重建、子 view 缓存清空。旧贴图与全部旧 view 从返回值交出 —— 其他 flight 的
+    /// 描述符可能还指着它们, 调用方须让它们活到此前提交的 GPU 工作完成。
+    /// view 创建失败时不替换, 新贴图原样放进返回值。
+    RetiredTexture ReplaceTexture(unique_ptr<render::Texture> texture, uint32_t residentMip) noexcept;
 
     /// 按子 view 描述取 SRV。默认描述 (sub.IsDefault()) 直接返回 _srv;
-    /// 否则按 descriptor 去重: 命中返回缓存指针, 未命中创建并永生缓存。
+    /// 否则按 descriptor 去重: 命中返回缓存指针, 未命中创建并缓存到下一次 ReplaceTexture。
+    /// sub 的 mip 级别按完整链计, 低于驻留边界的部分被裁掉, 不会采到尚未驻留的 mip。
     /// device 为空 / 贴图无效 / 创建失败返回 nullptr。
-    /// 返回指针在【本资产】存活期内稳定 —— 持有一份 StreamingAssetRef 即保证不悬垂。
+    /// 返回指针在同一 GetViewVersion() 内稳定, 且持有 StreamingAssetRef 期间不会被立即销毁。
     render::TextureView* GetOrCreateSrv(const TextureSubViewDesc& sub) noexcept;
 
 private:
@@ -107,6 +149,14 @@ private:
     unique_ptr<render::Texture> _texture;
     unique_ptr<render::TextureView> _srv;
     unordered_map<TextureSubViewDesc, unique_ptr<render::TextureView>> _viewCache;
+    shared_ptr<TextureMipStream> _stream;
+    uint32_t _width{0};
+    uint32_t _height{0};
+    uint32_t _mipCount{0};
+    render::TextureFormat _format{render::TextureFormat::UNKNOWN};
+    /// 只由渲染侧换贴图时写; AssetManager 在主线程按它估算占用。
+    std::atomic<uint32_t> _residentMip{0};
+    uint64_t _viewVersion{0};
 };
 
 struct TextureAssetLoadOptions {
@@ -115,26 +165,44 @@ struct TextureAssetLoadOptions {
     bool Srgb{false};
     /// true 时在 CPU 侧生成完整 RGBA8 mip 链并逐级上传。
     bool GenerateMips{false};
+    /// mip 的下采样滤波器。生成在 decodePool 的 worker 上按行分带并行。
+    MipFilter Filter{MipFilter::Box};
+    /// 非 None 时在 worker 上把每级 mip 压成对应的 BC 格式。BC1 / BC3 / BC7 随 Srgb 选 *_SRGB。
+    TextureCompression Compression{TextureCompression::None};
     /// 解码失败时的回退像素(CPU)。为空时加载失败。
     ImageData FallbackImage{};
 };
 
 /// importer 级构造任务：只产出 AssetLoadResult，不创建 AssetManager slot。
+/// RGBA8 归一与 mip 生成在 decodePool 的 worker 上执行；decodePool 为空时在调用线程上执行。
 task<AssetLoadResult> CreateTextureAssetFromImage(
     FrameUploadScheduler& frameUploads,
+    AssetDecodePool* decodePool,
     string name,
     ImageData image,
     TextureAssetLoadOptions options = {});
 
 task<AssetLoadResult> CreateTextureAssetFromMemory(
     FrameUploadScheduler& frameUploads,
+    AssetDecodePool* decodePool,
     string name,
     vector<byte> encodedBytes,
     TextureAssetLoadOptions options = {});
 
+/// 导入 PNG / JPEG 源与烘焙好的 .rrtex 容器。前者的烘焙产物就是 .rrtex, 存进 derived data 缓存,
+/// 命中时 mmap 后直接上传。.rrtex 源不再经过 settings 处理, sRGB 等都取自容器。
+///
+/// 给了 TextureStreamingManager 时只有链尾 (最小的几级, 凑满约 256 KiB) 随首帧上传, 资产随即可用,
+/// 其余 mip 由管理器按屏幕需求与预算补传或淘汰; 否则整条链随首帧上传。
 class TextureImporter final : public TypedAssetImporter<TextureImportSettings> {
 public:
-    explicit TextureImporter(FrameUploadScheduler& frameUploads) noexcept;
+    /// derivedData 可为空; 非空时必须活过 decodePool 的全部 worker 任务。
+    /// streaming 可为空; 非空时必须活过本 importer 发起的全部加载。
+    TextureImporter(
+        FrameUploadScheduler& frameUploads,
+        AssetDecodePool& decodePool,
+        DerivedDataCache* derivedData = nullptr,
+        TextureStreamingManager* streaming = nullptr) noexcept;
 
     std::string_view GetTypeName() const noexcept override;
     std::span<const std::string_view> GetFileExtensions() const noexcept override;
@@ -146,13 +214,17 @@ protected:
 
 private:
     FrameUploadScheduler& _frameUploads;
+    AssetDecodePool& _decodePool;
+    DerivedDataCache* _derivedData;
+    TextureStreamingManager* _streaming;
 };
 
-/// 从已解码的 CPU 像素(ImageData)创建 GPU 贴图。协程内部 co_await 帧顶 upload phase
-/// 录制上传,再等 GPU fence,完成后一次性构造 TextureAsset。
+/// 从已解码的 CPU 像素(ImageData)创建 GPU 贴图。像素处理在 decodePool 上完成后,协程回到
+/// 主线程 co_await 帧顶 upload phase 录制上传,再等 GPU fence,完成后一次性构造 TextureAsset。
 StreamingAssetRef<TextureAsset> LoadTextureAssetFromImage(
     AssetManager& assetManager,
     FrameUploadScheduler& frameUploads,
+    AssetDecodePool* decodePool,
     const AssetId& assetId,
     string name,
     ImageData image,
@@ -162,6 +234,7 @@ StreamingAssetRef<TextureAsset> LoadTextureAssetFromImage(
 StreamingAssetRef<TextureAsset> LoadTextureAssetFromMemory(
     AssetManager& assetManager,
     FrameUploadScheduler& frameUploads,
+    AssetDecodePool* decodePool,
     const AssetId& assetId,
     string name,
     vector<byte> encodedBytes,
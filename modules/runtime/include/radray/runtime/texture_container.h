@@ -0,0 +1,113 @@
+#pragma once
+
+#include <optional>
+#include <span>
+
+#include <radray/block_compression.h>
+#include <radray/render/rhi.h>
+#include <radray/types.h>
+
+// RadRay 烘焙贴图容器 (.rrtex)。一次烘焙, 运行时 mmap 后各级 mip 直接拷进 staging, 不再解码。
+//
+// 文件布局 (小端):
+//
+//   header   (32 B)  magic "RRTX" | version | width | height | mipCount
+//                    | compression(u8) | flags(u8) | reserved(u16)
+//                    | rowPitchAlignment | placementAlignment
+//   mip 表   (24 B × mipCount, 按 mip 级别升序)  offset(u64) | size(u64) | rowPitch(u32) | rowCount(u32)
+//   payload  各级 mip, 【最小的一级在最前】, 每级起点对齐到 placementAlignment,
+//            每行 (块压缩格式为一行 4x4 块) 补齐到 rowPitch。
+//
+// 对齐取 D3D12 的 256 / 512 作默认值, 它们也是常见 Vulkan 设备 optimalBufferCopy*Alignment
+// 的倍数, 因此 staging 拷贝通常退化成每级一次 memcpy。小 mip 在前, 顺序读文件时
+// 先到的就是先上传的尾部 mip。
+
+namespace radray {
+
+/// 贴图的块压缩档位。压缩在 CPU 阶段逐级进行, 产物随 derived data 缓存。
+/// mip 0 的宽高不是 4 的倍数时退回 RGBA8; 设备不支持 BC 时上传前解回 RGBA8。
+enum class TextureCompression : uint8_t {
+    /// 不压缩, RGBA8 上传。
+    None,
+    /// 不透明颜色, 4 bpp。alpha 被丢弃。
+    BC1,
+    /// 带 alpha 的颜色, 8 bpp。
+    BC3,
+    /// 单通道 (roughness / occlusion / mask), 4 bpp。
+    BC4,
+    /// 双通道 (切线空间法线 XY), 8 bpp。
+    BC5,
+    /// 高质量颜色 + alpha, 8 bpp。
+    BC7,
+};
+
+/// compression 为 None 时返回 nullopt。
+std::optional<BlockFormat> ToBlockFormat(TextureCompression compression) noexcept;
+
+/// 采样用的 RHI 格式。BC4 / BC5 存的是数据通道, 没有 sRGB 变体。
+render::TextureFormat GetTextureContainerFormat(TextureCompression compression, bool srgb) noexcept;
+
+/// 写容器时的对齐。两项都必须是 2 的幂。
+struct TextureContainerLayout {
+    /// 对应 DeviceDetail::TextureDataPitchAlignment。
+    uint32_t RowPitchAlignment{256};
+    /// 对应 DeviceDetail::TextureDataPlacementAlignment。
+    uint32_t PlacementAlignment{512};
+};
+
+struct TextureContainerMip {
+    uint32_t Width{0};
+    uint32_t Height{0};
+    /// 相对容器起点的字节偏移。
+    uint64_t Offset{0};
+    /// RowPitch * RowCount。
+    uint64_t Size{0};
+    uint32_t RowPitch{0};
+    /// 像素行数; 块压缩格式为块行数。
+    uint32_t RowCount{0};
+};
+
+/// 已校验的 .rrtex 只读视图。不拥有字节 —— 调用方让底层 mapping / 缓冲活过本对象。
+class TextureContainer {
+public:
+    static constexpr uint32_t kMagic = 0x58545252;  // "RRTX"
+    static constexpr uint32_t kVersion = 1;
+
+    TextureContainer() noexcept = default;
+
+    /// 校验 header、mip 表与全部偏移 / 对齐, 任一不符返回 nullopt。不拷贝像素。
+    static std::optional<TextureContainer> Parse(std::span<const byte> bytes) noexcept;
+
+    bool IsEmpty() const noexcept { return _mips.empty(); }
+    uint32_t GetWidth() const noexcept { return _width; }
+    uint32_t GetHeight() const noexcept { return _height; }
+    uint32_t GetMipCount() const noexcept { return static_cast<uint32_t>(_mips.size()); }
+    TextureCompression GetCompression() const noexcept { return _compression; }
+    bool IsSrgb() const noexcept { return _srgb; }
+    render::TextureFormat GetFormat() const noexcept { return GetTextureContainerFormat(_compression, _srgb); }
+    std::span<const byte> GetBytes() const noexcept { return _bytes; }
+
+    const TextureContainerMip& GetMip(uint32_t mipLevel) const noexcept { return _mips[mipLevel]; }
+    /// 含行尾补齐的整级字节, 直接作为 TextureUploadRequest::SrcData, SrcRowPitch 取 GetMip().RowPitch。
+    std::span<const byte> GetMipData(uint32_t mipLevel) const noexcept;
+
+private:
+    std::span<const byte> _bytes;
+    vector<TextureContainerMip> _mips;
+    uint32_t _width{0};
+    uint32_t _height{0};
+    TextureCompression _compression{TextureCompression::None};
+    bool _srgb{false};
+};
+
+/// 把紧密排列的各级 mip (RGBA8 或 compression 对应的 BC 块) 写成容器。levels[0] 为 mip 0,
+/// 每级尺寸须与 width / height 逐级减半一致。输入不合法时记日志并返回空。
+vector<byte> EncodeTextureContainer(
+    uint32_t width,
+    uint32_t height,
+    TextureCompression compression,
+    bool srgb,
+    std::span<const std::span<const byte>> levels,
+    const TextureContainerLayout& layout = {});
+
+}  // namespace radray
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <mutex>
+#include <span>
+
+#include <radray/coroutine.h>
+#include <radray/file.h>
+#include <radray/render/rhi.h>
+#include <radray/runtime/texture_container.h>
+#include <radray/types.h>
+
+// 贴图流送: 按屏幕上实际需要的精度决定每张贴图驻留哪几级 mip。
+//
+// 需求来自 MeshDrawList::Collect —— 每个 draw 按 section 的 UV 密度、缩放与视距算出屏幕上
+// 1 UV 单位占多少像素, 报给 TextureStreamingManager。管理器每帧在主线程结算一次: 缺的 mip
+// 按缺口从大到小、在每帧字节预算内上传; 驻留总量超出显存预算时先淘汰最不需要的高精度 mip。
+//
+// RHI 没有稀疏 / 分块资源, 驻留范围变化靠换贴图: 新贴图只含 [目标 mip, 链尾), 保留的那几级在
+// GPU 上从旧贴图拷过去, 缺的从 .rrtex 容器上传。fence 之后在下一个 upload phase 换进 TextureAsset,
+// 旧贴图与旧 view 再等一个 fence 后释放, 因此淘汰真正归还显存。
+
+namespace radray {
+
+class FrameUploadScheduler;
+class FrameUploadScope;
+class TextureAsset;
+
+/// 一张可流送贴图的 mip 来源与所属资产。TextureAsset 与 TextureStreamingManager 共享。
+struct TextureMipStream {
+    /// 受 Mutex 保护。资产卸载或销毁时置空, 管理器之后不再碰它。
+    TextureAsset* Asset{nullptr};
+    std::mutex Mutex;
+    /// 容器的底层字节: 映射 (derived data 条目或 .rrtex 源) 与刚烘焙出的缓冲二选一。
+    MappedFile Mapping;
+    vector<byte> Bytes;
+    TextureContainer Container;
+    /// 随首帧上传、不参与淘汰的链尾起点。
+    uint32_t TailMip{0};
+};
+
+struct TextureStreamingDescriptor {
+    /// 流送贴图可占的显存字节。0 表示取 DeviceDetail::VramBudget 的一半, 另一半留给 buffer 与 render target。
+    uint64_t VramBudget{0};
+    /// 每帧最多录制的上传字节。至少一级, 单级超出时照样整级上传。
+    uint64_t UploadBytesPerFrame{8ull << 20};
+    /// 连续这么多帧没被任何 draw 引用的贴图, 需求退回链尾。
+    uint32_t RequestHoldFrames{60};
+};
+
+struct TextureStreamingStats {
+    uint32_t TextureCount{0};
+    /// 已驻留 mip 的显存字节, 逐级按块计, 不含驱动的对齐填充。
+    uint64_t ResidentBytes{0};
+    /// 按当前需求应驻留的字节。大于 ResidentBytes 表示还有 mip 在排队或被预算挡住。
+    uint64_t RequestedBytes{0};
+    uint64_t VramBudget{0};
+};
+
+/// PlanTextureStreaming 的一项输入。
+struct TextureStreamingCandidate {
+    /// 每级 mip 的显存字节, 下标为 mip 级别。
+    std::span<const uint64_t> MipBytes;
+    uint32_t ResidentMip{0};
+    /// 需要驻留的最高精度 mip。
+    uint32_t WantedMip{0};
+    /// 不可淘汰的链尾起点。
+    uint32_t TailMip{0};
+    /// 缺口相同时的次序: 越大越先上传、越晚淘汰。
+    float Priority{0.0f};
+    /// 已有批次在途, 本帧不动。
+    bool Busy{false};
+};
+
+struct TextureStreamingBudget {
+    uint64_t VramBytes{0};
+    uint64_t UploadBytesPerFrame{0};
+};
+
+/// mip 级别 mipLevel 的显存字节。块压缩格式按整块计。
+uint64_t GetTextureMipBytes(render::TextureFormat format, uint32_t width, uint32_t height, uint32_t mipLevel) noexcept;
+
+/// 屏幕上 1 UV 单位占 pixelsPerUv 像素时, width x height 的贴图需要驻留的最高精度 mip:
+/// floor(log2(texel / pixel)), 夹在 [0, mipCount - 1]。pixelsPerUv 不为正时返回最后一级。
+uint32_t ComputeRequiredTextureMip(uint32_t width, uint32_t height, uint32_t mipCount, float pixelsPerUv) noexcept;
+
+/// 1 UV 单位在屏幕上占的像素。uvDensity 为 section 的本地长度 / UV 单位, worldScale 为
+/// local->world 的最大轴缩放, pixelsPerUnit 为视距 1 处一个世界单位投影出的像素数。
+float ComputeTexturePixelsPerUv(float uvDensity, float worldScale, float distance, float pixelsPerUnit) noexcept;
+
+/// 一帧的驻留规划, 返回每个 candidate 的目标 ResidentMip (与输入相同表示不动)。
+///
+/// 1. 驻留总量超出 VramBytes 时逐级淘汰: 多余级数 (ResidentMip 比 WantedMip 精细几级) 最多的先淘汰,
+///    其次 Priority 低的; 只淘汰到 TailMip 为止。
+/// 2. 上传按缺口级数从大到小、Priority 从高到低, 从驻留边界往 mip 0 逐级累加, 合计不超过
+///    UploadBytesPerFrame (第一级例外)。放不进显存预算时先淘汰其他贴图的多余级, 仍放不下就停。
+/// 本帧被淘汰的贴图不再上传, 每个 candidate 只朝一个方向移动。
+vector<uint32_t> PlanTextureStreaming(
+    std::span<const TextureStreamingCandidate> candidates,
+    const TextureStreamingBudget& budget);
+
+/// 录制 [firstMip, endMip) 的上传, 小 mip 先录。texture 的 mip 0 对应完整链的 textureBaseMip。
+/// 源直接取容器字节 (映射或烘焙缓冲), 行距沿用容器的, 与设备对齐一致时每级只有一次 memcpy。
+/// firstUpload 表示贴图刚创建, 第一条上传从 Undefined 出发。
+void RecordTextureMipUploads(
+    const FrameUploadScope& frame,
+    render::Texture* texture,
+    const TextureContainer& container,
+    uint32_t textureBaseMip,
+    uint32_t firstMip,
+    uint32_t endMip,
+    bool firstUpload);
+
+/// 贴图 mip 流送管理器。对应 UE5 的 FRenderAssetStreamingManager (最小化)。
+///
+/// 【线程】: Register / Update / SetVramBudget 在主线程调用; Request 可在任何线程调用
+/// (多线程 runner 下 Collect 在渲染线程)。需求表与统计受 _mutex 保护。批次的录制与换贴图都在
+/// 帧顶 upload phase, 与渲染线程的录制串行, 换下的 view 不会被正在录制的帧看到。
+class TextureStreamingManager {
+public:
+    /// deviceVramBudget 取 DeviceDetail::VramBudget, 只在 desc.VramBudget 为 0 时用来推出预算;
+    /// 二者都为 0 时不设上限。
+    TextureStreamingManager(
+        FrameUploadScheduler& frameUploads,
+        uint64_t deviceVramBudget,
+        const TextureStreamingDescriptor& desc = {}) noexcept;
+    TextureStreamingManager(const TextureStreamingManager&) = delete;
+    TextureStreamingManager(TextureStreamingManager&&) = delete;
+    TextureStreamingManager& operator=(const TextureStreamingManager&) = delete;
+    TextureStreamingManager& operator=(TextureStreamingManager&&) = delete;
+    ~TextureStreamingManager() noexcept;
+
+    /// 纳入一张已发布的贴图。由加载协程在构造 TextureAsset 后调用; stream->Asset 须已指向它。
+    void Register(shared_ptr<TextureMipStream> stream);
+
+    /// 记录本帧一次需求: texture 在屏幕上 1 UV 单位占 pixelsPerUv 像素。同一帧取最大值。
+    /// 不在管理中的贴图 (全量驻留的) 忽略。
+    void Request(const TextureAsset* texture, float pixelsPerUv) noexcept;
+
+    /// 每帧一次: 结算上一帧收集的需求, 规划并发起本帧的批次。
+    void Update();
+
+    void SetVramBudget(uint64_t bytes) noexcept;
+    uint64_t GetVramBudget() const noexcept;
+    TextureStreamingStats GetStats() const noexcept;
+
+private:
+    struct Entry {
+        shared_ptr<TextureMipStream> Stream;
+        vector<uint64_t> MipBytes;
+        uint32_t ResidentMip{0};
+        uint32_t WantedMip{0};
+        /// 上一次 Update 以来收到的最大需求, 0 表示没有。
+        float PendingPixelsPerUv{0.0f};
+        float PixelsPerUv{0.0f};
+        uint64_t LastRequestFrame{0};
+        bool Busy{false};
+    };
+
+    /// 一张贴图本批次的驻留变化。Source 与 SourceMip 在规划时取自资产; Texture 由录制填入。
+    /// Key 只用来找回 _entries 里的条目, 资产卸载后不再解引用。
+    struct Transition {
+        const TextureAsset* Key{nullptr};
+        shared_ptr<TextureMipStream> Stream;
+        string DebugName;
+        render::Texture* Source{nullptr};
+        uint32_t SourceMip{0};
+        uint32_t TargetMip{0};
+        unique_ptr<render::Texture> Texture;
+    };
+
+    task<void> RunBatch(vector<Transition> batch);
+
+    FrameUploadScheduler& _frameUploads;
+    uint64_t _uploadBytesPerFrame;
+    uint32_t _requestHoldFrames;
+    mutable std::mutex _mutex;
+    unordered_map<const TextureAsset*, Entry> _entries;
+    uint64_t _vramBudget;
+    uint64_t _frame{0};
+    /// 在途批次。最后声明、最先析构: 停止并等完批次后, 其余成员才失效。
+    TaskScope _batchScope;
+};
+
+}  // namespace radray
@@ -10,8 +10,11 @@
 #include <thread>
 
 #include <radray/logger.h>
+#include <radray/memory.h>
+#include <radray/profiler.h>
 #include <radray/render/rhi.h>
 #include <radray/runtime/asset_database.h>
+#include <radray/runtime/asset_decode_pool.h>
 #include <radray/runtime/gpu_system.h>
 #include <radray/runtime/window_manager.h>
 #include <radray/runtime/asset_manager.h>
@@ -40,10 +43,13 @@ namespace radray {
 namespace {
 
 vector<unique_ptr<AssetImporter>> MakeDefaultAssetImporters(
-    FrameUploadScheduler& frameUploads) {
+    FrameUploadScheduler& frameUploads,
+    AssetDecodePool& decodePool,
+    DerivedDataCache* derivedData,
+    TextureStreamingManager* textureStreaming) {
     vector<unique_ptr<AssetImporter>> importers;
-    importers.push_back(make_unique<TextureImporter>(frameUploads));
-    importers.push_back(make_unique<MeshImporter>(frameUploads));
+    importers.push_back(make_unique<TextureImporter>(frameUploads, decodePool, derivedData, textureStreaming));
+    importers.push_back(make_unique<MeshImporter>(frameUploads, decodePool, derivedData));
     return importers;
 }
 
@@ -94,8 +100,8 @@ bool ApplicationScheduler::Erase(ApplicationSchedulerRecord* record) noexcept {
     return _records.Erase(record);
 }
 
-bool ApplicationScheduler::IsAlive(ApplicationSchedulerRecord* record) const noexcept {
-    return _records.IsAlive(record);
+bool ApplicationScheduler::IsAlive(ApplicationSchedulerRecord* record, uint64_t ticket) const noexcept {
+    return _records.IsAlive(record, ticket);
 }
 
 void ApplicationScheduler::ResumeRecord(ApplicationSchedulerRecord* record) noexcept {
@@ -110,11 +116,12 @@ void ApplicationScheduler::Pump() {
     const size_t recordCount = _records.Count();
     for (size_t i = 0; i < recordCount && !_records.Empty(); ++i) {
         ApplicationSchedulerRecord* record = _records.Front();
+        const uint64_t ticket = record->Ticket;
         if (record->Stop.stop_requested()) {
             record->Canceled = true;
         }
         ResumeRecord(record);
-        if (IsAlive(record)) {
+        if (IsAlive(record, ticket)) {
             Erase(record);
         }
     }
@@ -441,6 +448,7 @@ public:
           _modalLoopTickConnection(_app->GetWindowManager()->EventModalLoopTick().connect(&SingleThreadRunner::OnModalLoopTick, this)) {}
 
     int Run() {
+        RADRAY_PROFILE_THREAD_NAME("Main");
         while (true) {
 #if defined(RADRAY_APP_IMPL_ENABLE_VBLANK_TICK)
             StopWin32ModalVBlank();
@@ -490,6 +498,9 @@ public:
     }
 
     void TickFrame(bool isInModalLoop) {
+        RADRAY_PROFILE_FRAME("Frame");
+        SampleMemoryFrame();
+        RADRAY_PROFILE_SCOPE("SingleThreadRunner::TickFrame");
         if (isInModalLoop) {
             MarkModalLoopActivityDuringDispatch();
         }
@@ -586,6 +597,7 @@ public:
           _renderThread(&ThreadedRunner::RenderThread, this) {}
 
     int Run() {
+        RADRAY_PROFILE_THREAD_NAME("Main");
         while (true) {
             _hasModalLoopActivityDuringDispatch = false;
             _app->GetWindowManager()->DispatchEvents();
@@ -616,11 +628,15 @@ public:
     }
 
     void RenderThread() {
+        RADRAY_PROFILE_THREAD_NAME("Render");
         while (true) {
             RetireRenderedFrames(false, true);
 
             auto* gpuSystem = _app->GetGpuSystem();
-            _readySlotsSemaphore.acquire();
+            {
+                RADRAY_PROFILE_SCOPE("ThreadedRunner::WaitForReadySlot");
+                _readySlotsSemaphore.acquire();
+            }
 
             if (_reqExit) {
                 RetireRenderedFrames(true, false);
@@ -637,13 +653,16 @@ public:
                 NotifyRenderFrameComplete(_renderFrameIndex);
                 continue;
             }
-            AppFrameContext frameCtx = gpuSystem->BeginFrameRecord(
-                flightIndex,
-                runnerFrameData.DeltaTime,
-                gpuSystem->GetLastFrameLatency(),
-                runnerFrameData.IsInModalLoop);
-            _app->Render(frameCtx);
-            gpuSystem->EndFrameRecordAndSubmit(flightIndex);
+            {
+                RADRAY_PROFILE_SCOPE("ThreadedRunner::RenderFrame");
+                AppFrameContext frameCtx = gpuSystem->BeginFrameRecord(
+                    flightIndex,
+                    runnerFrameData.DeltaTime,
+                    gpuSystem->GetLastFrameLatency(),
+                    runnerFrameData.IsInModalLoop);
+                _app->Render(frameCtx);
+                gpuSystem->EndFrameRecordAndSubmit(flightIndex);
+            }
 
             _renderFrameIndex++;
             NotifyRenderFrameComplete(_renderFrameIndex);
@@ -675,8 +694,12 @@ public:
     }
 
     std::optional<uint64_t> TickFrame(bool isInModalLoop, bool waitForWritableSlot) {
+        RADRAY_PROFILE_FRAME("Frame");
+        SampleMemoryFrame();
+        RADRAY_PROFILE_SCOPE("ThreadedRunner::TickFrame");
         auto* gpuSystem = _app->GetGpuSystem();
         if (waitForWritableSlot) {
+            RADRAY_PROFILE_SCOPE("ThreadedRunner::WaitForWritableSlot");
             WaitRenderFrameComplete(gpuSystem->GetFrameIndex());
             RetireRenderedFrames(false, false);
             CheckRecreateSwapChains();
@@ -784,14 +807,28 @@ void Application::NotifyRenderComplete(const AppRenderCompleteContext& ctx) {
 // ════════════════════════════════════════════════════════════════
 
 AppUpdateResult Application::Update(const AppUpdateContext& ctx) {
-    // 1) 推进资产加载状态机(恢复本帧 GPU 上传已完成的协程 → 启动未启动协程 → reap 终态)。
+    // 1) 把 worker 上完成的资产 CPU 阶段交回主线程, 再推进资产加载状态机
+    //    (恢复本帧 GPU 上传已完成的协程 → 启动未启动协程 → reap 终态)。
+    if (_assetDecodePool != nullptr) {
+        _assetDecodePool->Pump();
+    }
     if (_assetManager != nullptr) {
         _assetManager->Pump();
     }
+    // 结算上一帧 Collect 上报的贴图需求, 发起本帧的 mip 上传与淘汰。
+    if (_textureStreaming != nullptr) {
+        _textureStreaming->Update();
+    }
     // 恢复需要在应用 update 线程上继续执行的协程。
-    _scheduler.Pump();
+    {
+        RADRAY_PROFILE_SCOPE("Application::PumpScheduler");
+        _scheduler.Pump();
+    }
     // 2) 游戏逻辑。
-    OnUpdate(ctx);
+    {
+        RADRAY_PROFILE_SCOPE("Application::OnUpdate");
+        OnUpdate(ctx);
+    }
     // 3) World Tick(组件解析当帧就绪的资产、建代理)。
     if (_world != nullptr) {
         _world->Tick(ctx.DeltaTime.count());
@@ -842,6 +879,12 @@ void Application::DestroyRuntime() noexcept {
     _assetManager.reset();
     // importer 与 settings 必须活到全部在飞加载协程被 AssetManager 收束之后。
     _assetDatabase.reset();
+    // 资产已全部卸载; 停掉在途批次, 换下的贴图随协程帧在 device 销毁前释放。
+    _textureStreaming.reset();
+    // 同理, 被取消的加载协程在收束时还要从解码池的等待表里摘除记录。
+    _assetDecodePool.reset();
+    // worker 上的导入任务会读写 derived data, 解码池 join 之后才能销毁。
+    _derivedDataCache.reset();
     if (_windowManager != nullptr) {
         _windowManager->DetachAllSwapChains();
         _windowManager->SetGpuSystem(nullptr);
@@ -898,12 +941,29 @@ void Application::InitializeRuntime(const ApplicationRuntimeDescriptor& desc) {
         .FlightDataCount = desc.FlightDataCount};
     _gpuSystem = make_unique<GpuSystem>(this, gpuSysDesc);
     _renderSystem = make_unique<RenderSystem>(this);
+    if (!desc.DerivedData.Directory.empty()) {
+        _derivedDataCache = make_unique<DerivedDataCache>(desc.DerivedData);
+    }
+    _assetDecodePool = make_unique<AssetDecodePool>(desc.AssetDecode);
+    {
+        render::Device* device = _gpuSystem->GetDevice();
+        _textureStreaming = make_unique<TextureStreamingManager>(
+            _gpuSystem->GetFrameUploadScheduler(),
+            device != nullptr ? device->GetDetail().VramBudget : 0,
+            desc.TextureStreaming);
+    }
     _assetManager = make_unique<AssetManager>();
+    _assetManager->SetLoadBudget(desc.AssetLoads);
+    _assetManager->SetCacheBudget(desc.AssetCache);
     if (!desc.AssetRoot.empty()) {
         string error;
         _assetDatabase = AssetDatabase::Open(
             desc.AssetRoot,
-            MakeDefaultAssetImporters(_gpuSystem->GetFrameUploadScheduler()),
+            MakeDefaultAssetImporters(
+                _gpuSystem->GetFrameUploadScheduler(),
+                *_assetDecodePool,
+                _derivedDataCache.get(),
+                _textureStreaming.get()),
             error);
         if (_assetDatabase == nullptr) {
             RADRAY_ERR_LOG("open asset database failed: {}", error);
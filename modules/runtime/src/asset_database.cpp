@@ -1,13 +1,23 @@
 #include <radray/runtime/asset_database.h>
 
 #include <algorithm>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <fstream>
+#include <limits>
+#include <mutex>
 #include <system_error>
+#include <thread>
 
 #include <fmt/format.h>
 
+#include <radray/binary_io.h>
 #include <radray/file.h>
+#include <radray/hash.h>
 #include <radray/logger.h>
+#include <radray/profiler.h>
 #include <radray/text_encoding.h>
 
 #if defined(RADRAY_PLATFORM_WINDOWS)
@@ -19,6 +29,35 @@ namespace {
 
 constexpr std::string_view kManifestFileName = "assets.json";
 constexpr uint32_t kManifestVersion = 1;
+constexpr std::string_view kIndexFileName = "assets.index";
+constexpr uint32_t kIndexMagic = 0x49415252;  // "RRAI"
+constexpr uint32_t kIndexVersion = 3;
+constexpr size_t kIndexHeaderSize = 72;
+constexpr size_t kIndexRecordSize = 56;
+constexpr uint32_t kIndexNoSettings = std::numeric_limits<uint32_t>::max();
+/// 索引描述的清单由 Save 写出: 每条记录都是 Save 对该条目的输出, 可被下一次 Save 原样复用。
+constexpr uint32_t kIndexFlagSaveOutput = 1;
+/// 写索引时清单的 mtime 已在不可信窗口之外: 此后清单大小与 mtime 都没变, 就是同一份内容。
+constexpr uint32_t kIndexFlagStampSettled = 2;
+/// 头里清单 mtime 与 flags 字段的字节偏移, Open 补记 kIndexFlagStampSettled 时原地改写。
+constexpr size_t kIndexManifestWriteTimeOffset = 32;
+constexpr size_t kIndexFlagsOffset = 64;
+/// 路径桶按 MakePathKey 的结果散列, 而它在 Windows 上做 Unicode 折叠、其他平台只折 ASCII。
+#if defined(RADRAY_PLATFORM_WINDOWS)
+constexpr uint32_t kIndexPathKeyFlavor = 1;
+#else
+constexpr uint32_t kIndexPathKeyFlavor = 0;
+#endif
+constexpr std::string_view kRefreshSnapshotFileName = "assets.refresh";
+constexpr uint32_t kRefreshSnapshotMagic = 0x46455252;  // "RREF"
+constexpr uint32_t kRefreshSnapshotVersion = 2;
+/// 目录 mtime 距上次扫描开始不足这么久时不信任它: 同一时间戳粒度内的后续修改不会再推进 mtime。
+/// 2 秒覆盖 FAT 的粒度, 其余文件系统只会多重扫几个刚改过的目录。
+constexpr std::chrono::seconds kRefreshRacyWindow{2};
+constexpr uint32_t kMaxRefreshWorkers = 8;
+constexpr uint32_t kMaxSaveWorkers = 8;
+/// 需要重新编码的 settings 少于这个数时不开线程: 线程启动的开销比编码本身还大。
+constexpr size_t kParallelSaveMinEntries = 256;
 
 char LowerAscii(char value) noexcept {
     return value >= 'A' && value <= 'Z'
@@ -496,7 +535,7 @@ private:
                 return false;
             }
             const bool isSchemaKey =
-                key == "guid" || key == "path" || key == "type" || key == "settings";
+                key == "guid" || key == "path" || key == "type" || key == "settings" || key == "dependencies";
             if (isSchemaKey && !keys.insert(key).second) {
                 return false;
             }
@@ -530,6 +569,19 @@ private:
     size_t _position{0};
 };
 
+/// 去重并丢弃自身, 保持首次出现的顺序。
+vector<AssetId> NormalizeDependencies(const AssetId& self, std::span<const AssetId> dependencies) {
+    vector<AssetId> result;
+    result.reserve(dependencies.size());
+    for (const AssetId& dependency : dependencies) {
+        if (dependency != self && !dependency.IsEmpty() &&
+            std::find(result.begin(), result.end(), dependency) == result.end()) {
+            result.push_back(dependency);
+        }
+    }
+    return result;
+}
+
 std::optional<string> EncodeJsonString(std::string_view value) noexcept {
     return SerializeJson(value, false);
 }
@@ -546,70 +598,981 @@ std::optional<string> EncodeSettings(const AssetImportSettings& settings) noexce
     return writer.Write(false);
 }
 
+/// JSON 清单与二进制索引共用的 settings 口径。settingsText 为空表示条目没有 settings 字段;
+/// 有 text 而 settingsJson 为空表示它无法被解析, 与解码失败同样退化为 RawSettings。
+void AssignEntrySettings(
+    const AssetImporter* importer,
+    AssetEntry& entry,
+    const JsonValue* settingsJson,
+    std::optional<std::string_view> settingsText) {
+    if (importer == nullptr) {
+        RADRAY_WARN_LOG("AssetDatabase: asset {} uses unregistered importer type '{}'", entry.Guid, entry.Type);
+        if (settingsText.has_value()) {
+            entry.RawSettings = string{settingsText.value()};
+        }
+        return;
+    }
+    if (!settingsText.has_value()) {
+        entry.Settings = importer->CreateSettings();
+        return;
+    }
+    unique_ptr<AssetImportSettings> settings = importer->CreateSettings();
+    if (settings == nullptr) {
+        RADRAY_WARN_LOG("AssetDatabase: importer '{}' does not accept settings for asset {}", entry.Type, entry.Guid);
+        entry.RawSettings = string{settingsText.value()};
+    } else if (settingsJson == nullptr || !settings->Deserialize(*settingsJson)) {
+        RADRAY_WARN_LOG("AssetDatabase: settings for asset {} failed to decode as type '{}'", entry.Guid, entry.Type);
+        entry.RawSettings = string{settingsText.value()};
+    } else {
+        entry.Settings = std::move(settings);
+    }
+}
+
+/// 写到同目录的 `<path>.tmp`, Commit 时原子替换目标文件; 没有 Commit 就析构时删掉临时文件。
+/// Write 先进固定大小的缓冲区, 满了才落盘, 调用方可以逐段写出大文件而不必先拼成一整块。
+class AtomicFileWriter {
+public:
+    explicit AtomicFileWriter(std::filesystem::path path)
+        : _path(std::move(path)) {
+        _temporaryPath = _path;
+        _temporaryPath += ".tmp";
+    }
+    AtomicFileWriter(const AtomicFileWriter&) = delete;
+    AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+    ~AtomicFileWriter() noexcept {
+        if (_file.is_open()) {
+            _file.close();
+            std::error_code error;
+            std::filesystem::remove(_temporaryPath, error);
+        }
+    }
+
+    bool Open(string& outError) {
+        std::error_code error;
+        if (_path.has_parent_path()) {
+            std::filesystem::create_directories(_path.parent_path(), error);
+            if (error) {
+                outError = fmt::format(
+                    "failed to create asset manifest directory '{}': {}",
+                    _path.parent_path().string(),
+                    error.message());
+                return false;
+            }
+        }
+        _file.open(_temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!_file) {
+            outError = fmt::format("failed to open temporary asset manifest '{}'", _temporaryPath.string());
+            return false;
+        }
+        _buffer.reserve(kBufferSize);
+        return true;
+    }
+
+    void Write(std::string_view contents) {
+        if (_buffer.size() + contents.size() > kBufferSize) {
+            Flush();
+            if (contents.size() >= kBufferSize) {
+                _file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+                return;
+            }
+        }
+        _buffer += contents;
+    }
+
+    bool Commit(string& outError) {
+        Flush();
+        _file.flush();
+        const bool writeSucceeded = static_cast<bool>(_file);
+        _file.close();
+        std::error_code error;
+        if (!writeSucceeded || _file.fail()) {
+            outError = fmt::format("failed to write temporary asset manifest '{}'", _temporaryPath.string());
+            std::filesystem::remove(_temporaryPath, error);
+            return false;
+        }
+
+#if defined(RADRAY_PLATFORM_WINDOWS)
+        if (!MoveFileExW(
+                _temporaryPath.c_str(),
+                _path.c_str(),
+                MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+            const std::error_code moveError{
+                static_cast<int>(GetLastError()),
+                std::system_category()};
+            outError = fmt::format(
+                "failed to replace asset manifest '{}': {}",
+                _path.string(),
+                moveError.message());
+            std::filesystem::remove(_temporaryPath, error);
+            return false;
+        }
+#else
+        std::filesystem::rename(_temporaryPath, _path, error);
+        if (error) {
+            outError = fmt::format(
+                "failed to replace asset manifest '{}': {}",
+                _path.string(),
+                error.message());
+            std::error_code cleanupError;
+            std::filesystem::remove(_temporaryPath, cleanupError);
+            return false;
+        }
+#endif
+        return true;
+    }
+
+private:
+    static constexpr size_t kBufferSize = 1u << 20;
+
+    void Flush() {
+        if (!_buffer.empty()) {
+            _file.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+            _buffer.clear();
+        }
+    }
+
+    std::filesystem::path _path;
+    std::filesystem::path _temporaryPath;
+    std::ofstream _file;
+    string _buffer;
+};
+
 bool WriteManifestAtomically(
     const std::filesystem::path& manifestPath,
     std::string_view contents,
     string& outError) {
+    AtomicFileWriter writer{manifestPath};
+    if (!writer.Open(outError)) {
+        return false;
+    }
+    writer.Write(contents);
+    return writer.Commit(outError);
+}
+
+/// 一个目录在上次 Refresh 时的列表。目录的 mtime 只随直接子项的增删改名推进, 不随文件内容
+/// 或更深层的变化推进, 所以 mtime 未变时可以直接复用列表, 但子目录仍要逐个检查。
+struct RefreshDirectory {
+    /// 相对资产根的 UTF-8 路径, 根为空串。
+    string Path;
+    int64_t WriteTime{0};
+    /// 两个列表都按字节序排好, 便于与快照逐项比较。
+    vector<string> Directories;
+    vector<string> Files;
+    /// 本次重新列出后内容与快照不同 (含快照里没有的目录)。不写入快照。
+    bool Changed{false};
+};
+
+/// 清单文件的大小与 mtime。快照据此确认自己核对过的登记仍是磁盘上的那一份。
+struct ManifestStamp {
+    uint64_t Size{0};
+    int64_t WriteTime{0};
+
+    bool operator==(const ManifestStamp&) const noexcept = default;
+};
+
+struct RefreshSnapshot {
+    /// 上次扫描开始的时刻; mtime 不早于它减去 kRefreshRacyWindow 的目录一律重扫。
+    int64_t ScanStart{0};
+    /// 写快照时列表里每个被认领的文件都已登记, 且登记已全部 Save 进这份清单。
+    /// 此后清单与认领的扩展名都没变时, 列表未变的目录不必再逐个文件核对。
+    std::optional<ManifestStamp> Reconciled;
+    /// 写快照时的扩展名认领表, 见 HashClaimedExtensions。
+    uint64_t ExtensionsHash{0};
+    unordered_map<string, RefreshDirectory> Directories;
+};
+
+int64_t ToFileTimeTicks(std::filesystem::file_time_type time) noexcept {
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+int64_t RefreshRacyWindowTicks() noexcept {
+    return ToFileTimeTicks(std::filesystem::file_time_type{
+        std::chrono::duration_cast<std::filesystem::file_time_type::duration>(kRefreshRacyWindow)});
+}
+
+std::optional<ManifestStamp> StatManifest(const std::filesystem::path& path) noexcept {
     std::error_code error;
-    if (manifestPath.has_parent_path()) {
-        std::filesystem::create_directories(manifestPath.parent_path(), error);
+    const uintmax_t size = std::filesystem::file_size(path, error);
+    if (error) {
+        return std::nullopt;
+    }
+    const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return std::nullopt;
+    }
+    return ManifestStamp{.Size = static_cast<uint64_t>(size), .WriteTime = ToFileTimeTicks(writeTime)};
+}
+
+/// mtime 早于现在减去 kRefreshRacyWindow: 之后对该文件的任何修改都会推进 mtime。
+bool IsSettledWriteTime(int64_t writeTime) noexcept {
+    return writeTime < ToFileTimeTicks(std::filesystem::file_time_type::clock::now()) - RefreshRacyWindowTicks();
+}
+
+string JoinRelativePath(std::string_view directory, std::string_view name) {
+    if (directory.empty()) {
+        return string{name};
+    }
+    string result;
+    result.reserve(directory.size() + 1 + name.size());
+    result += directory;
+    result += '/';
+    result += name;
+    return result;
+}
+
+string EncodeRefreshSnapshot(
+    int64_t scanStart,
+    const std::optional<ManifestStamp>& reconciled,
+    uint64_t extensionsHash,
+    const vector<RefreshDirectory>& directories) {
+    BinaryWriter writer;
+    writer.U32(kRefreshSnapshotMagic);
+    writer.U32(kRefreshSnapshotVersion);
+    writer.U64(static_cast<uint64_t>(std::filesystem::file_time_type::period::num));
+    writer.U64(static_cast<uint64_t>(std::filesystem::file_time_type::period::den));
+    writer.U64(static_cast<uint64_t>(scanStart));
+    writer.U64(extensionsHash);
+    writer.U8(reconciled.has_value() ? 1 : 0);
+    writer.U64(reconciled.has_value() ? reconciled->Size : 0);
+    writer.U64(static_cast<uint64_t>(reconciled.has_value() ? reconciled->WriteTime : 0));
+    writer.U64(directories.size());
+    for (const RefreshDirectory& directory : directories) {
+        writer.String(directory.Path);
+        writer.U64(static_cast<uint64_t>(directory.WriteTime));
+        writer.Size32(directory.Directories.size());
+        for (const string& name : directory.Directories) {
+            writer.String(name);
+        }
+        writer.Size32(directory.Files.size());
+        for (const string& name : directory.Files) {
+            writer.String(name);
+        }
+    }
+    const std::span<const byte> data = writer.GetData();
+    return string{reinterpret_cast<const char*>(data.data()), data.size()};
+}
+
+bool ReadSnapshotNames(BinaryReader& reader, vector<string>& names) {
+    uint32_t count = 0;
+    if (!reader.U32(count) || count > reader.Remaining()) {
+        return false;
+    }
+    names.resize(count);
+    for (string& name : names) {
+        std::string_view value;
+        if (!reader.String(value)) {
+            return false;
+        }
+        name.assign(value);
+    }
+    return true;
+}
+
+/// 快照只是缓存: 缺失、损坏或来自时钟周期不同的构建时返回空快照, Refresh 退化为全量扫描。
+RefreshSnapshot LoadRefreshSnapshot(const std::filesystem::path& path) {
+    const std::optional<vector<byte>> contents = ReadBinaryFile(path);
+    if (!contents.has_value()) {
+        return {};
+    }
+    BinaryReader reader{contents.value()};
+    RefreshSnapshot snapshot{};
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t periodNum = 0;
+    uint64_t periodDen = 0;
+    uint64_t scanStart = 0;
+    uint64_t extensionsHash = 0;
+    uint8_t reconciled = 0;
+    uint64_t manifestSize = 0;
+    uint64_t manifestWriteTime = 0;
+    uint64_t count = 0;
+    if (!reader.U32(magic) || magic != kRefreshSnapshotMagic ||
+        !reader.U32(version) || version != kRefreshSnapshotVersion ||
+        !reader.U64(periodNum) || periodNum != static_cast<uint64_t>(std::filesystem::file_time_type::period::num) ||
+        !reader.U64(periodDen) || periodDen != static_cast<uint64_t>(std::filesystem::file_time_type::period::den) ||
+        !reader.U64(scanStart) ||
+        !reader.U64(extensionsHash) ||
+        !reader.U8(reconciled) || !reader.U64(manifestSize) || !reader.U64(manifestWriteTime) ||
+        !reader.U64(count)) {
+        return {};
+    }
+    snapshot.ScanStart = static_cast<int64_t>(scanStart);
+    snapshot.ExtensionsHash = extensionsHash;
+    if (reconciled != 0) {
+        snapshot.Reconciled = ManifestStamp{.Size = manifestSize, .WriteTime = static_cast<int64_t>(manifestWriteTime)};
+    }
+    for (uint64_t index = 0; index < count; ++index) {
+        RefreshDirectory directory{};
+        std::string_view directoryPath;
+        uint64_t writeTime = 0;
+        if (!reader.String(directoryPath) ||
+            !reader.U64(writeTime) ||
+            !ReadSnapshotNames(reader, directory.Directories) ||
+            !ReadSnapshotNames(reader, directory.Files)) {
+            return {};
+        }
+        directory.Path.assign(directoryPath);
+        directory.WriteTime = static_cast<int64_t>(writeTime);
+        string key = directory.Path;
+        snapshot.Directories.insert_or_assign(std::move(key), std::move(directory));
+    }
+    if (!reader.AtEnd()) {
+        return {};
+    }
+    return snapshot;
+}
+
+/// 多线程遍历资产根。每个 worker 从共享栈取一个目录: mtime 与快照一致就复用上次的列表,
+/// 否则重新列目录; 子目录再压回栈里。只读共享 previous, 结果与错误在锁内汇总。
+/// 与 recursive_directory_iterator 的默认行为一致, 不进入目录符号链接。
+class ParallelDirectoryScan {
+public:
+    ParallelDirectoryScan(const std::filesystem::path& root, const RefreshSnapshot& previous, int64_t racyLimit) noexcept
+        : _root(root), _previous(previous), _racyLimit(racyLimit) {}
+
+    bool Run(uint32_t workerCount, string& outError) {
+        _pending.emplace_back();
+        vector<std::thread> workers;
+        workers.reserve(workerCount - 1);
+        for (uint32_t i = 1; i < workerCount; ++i) {
+            workers.emplace_back([this]() { this->WorkerMain(); });
+        }
+        WorkerMain();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        if (!_error.empty()) {
+            outError = std::move(_error);
+            return false;
+        }
+        std::sort(_results.begin(), _results.end(), [](const RefreshDirectory& lhs, const RefreshDirectory& rhs) {
+            return lhs.Path < rhs.Path;
+        });
+        return true;
+    }
+
+    vector<RefreshDirectory>& GetResults() noexcept { return _results; }
+    uint32_t GetRescannedCount() const noexcept { return _rescannedCount; }
+
+private:
+    void WorkerMain() {
+        std::unique_lock<std::mutex> lock{_mutex};
+        while (true) {
+            _workAvailable.wait(lock, [this]() { return !_pending.empty() || _active == 0 || !_error.empty(); });
+            if (!_error.empty() || _pending.empty()) {
+                _workAvailable.notify_all();
+                return;
+            }
+            string path = std::move(_pending.back());
+            _pending.pop_back();
+            ++_active;
+            lock.unlock();
+
+            RefreshDirectory directory{};
+            bool rescanned = false;
+            string error;
+            const bool scanned = ScanDirectory(std::move(path), directory, rescanned, error);
+
+            lock.lock();
+            --_active;
+            if (!scanned) {
+                if (_error.empty()) {
+                    _error = std::move(error);
+                }
+            } else {
+                for (const string& child : directory.Directories) {
+                    _pending.emplace_back(JoinRelativePath(directory.Path, child));
+                }
+                _rescannedCount += rescanned ? 1 : 0;
+                _results.emplace_back(std::move(directory));
+            }
+            _workAvailable.notify_all();
+        }
+    }
+
+    bool ScanDirectory(string path, RefreshDirectory& directory, bool& rescanned, string& outError) const {
+        const std::filesystem::path absolutePath = path.empty() ? _root : _root / PathFromUtf8(path);
+        std::error_code error;
+        const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(absolutePath, error);
         if (error) {
-            outError = fmt::format(
-                "failed to create asset manifest directory '{}': {}",
-                manifestPath.parent_path().string(),
-                error.message());
+            outError = fmt::format("cannot inspect asset directory '{}': {}", absolutePath.string(), error.message());
+            return false;
+        }
+        const int64_t ticks = ToFileTimeTicks(writeTime);
+        auto previousIt = _previous.Directories.find(path);
+        if (previousIt != _previous.Directories.end() && previousIt->second.WriteTime == ticks && ticks < _racyLimit) {
+            directory = previousIt->second;
+            return true;
+        }
+
+        rescanned = true;
+        directory.Path = std::move(path);
+        directory.WriteTime = ticks;
+        std::filesystem::directory_iterator iterator{absolutePath, error};
+        const std::filesystem::directory_iterator end;
+        while (iterator != end) {
+            if (error) {
+                break;
+            }
+            const std::filesystem::directory_entry& entry = *iterator;
+            const bool isDirectory = entry.is_directory(error) && !error && !entry.is_symlink(error);
+            if (error) {
+                outError = fmt::format("cannot inspect asset path '{}': {}", entry.path().string(), error.message());
+                return false;
+            }
+            if (isDirectory) {
+                directory.Directories.emplace_back(PathToUtf8(entry.path().filename()));
+            } else {
+                const bool regularFile = entry.is_regular_file(error);
+                if (error) {
+                    outError = fmt::format("cannot inspect asset path '{}': {}", entry.path().string(), error.message());
+                    return false;
+                }
+                if (regularFile) {
+                    directory.Files.emplace_back(PathToUtf8(entry.path().filename()));
+                }
+            }
+            iterator.increment(error);
+        }
+        if (error) {
+            outError = fmt::format("failed while scanning asset directory '{}': {}", absolutePath.string(), error.message());
             return false;
         }
+        std::sort(directory.Directories.begin(), directory.Directories.end());
+        std::sort(directory.Files.begin(), directory.Files.end());
+        // 只推进了 mtime 的目录 (例如根目录因写快照而变) 不算变化, 其中的文件不必再核对。
+        directory.Changed = previousIt == _previous.Directories.end() ||
+                            previousIt->second.Directories != directory.Directories ||
+                            previousIt->second.Files != directory.Files;
+        return true;
     }
 
-    std::filesystem::path temporaryPath = manifestPath;
-    temporaryPath += ".tmp";
-    std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
-    if (!file) {
-        outError = fmt::format("failed to open temporary asset manifest '{}'", temporaryPath.string());
-        return false;
+    const std::filesystem::path& _root;
+    const RefreshSnapshot& _previous;
+    const int64_t _racyLimit;
+    std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    vector<string> _pending;
+    uint32_t _active{0};
+    vector<RefreshDirectory> _results;
+    uint32_t _rescannedCount{0};
+    string _error;
+};
+
+/// 清单条目进索引时的来源。SettingsText 是清单里该条目 settings 值的原文, 没有该字段时为空。
+struct AssetIndexSource {
+    AssetId Guid;
+    std::string_view Path;
+    std::string_view Type;
+    /// 依赖 GUID 依次排列的原始字节, 每个 Guid::Size 字节。
+    std::span<const byte> Dependencies;
+    std::optional<std::string_view> SettingsText;
+};
+
+static_assert(sizeof(AssetId) == Guid::Size, "dependency lists are viewed as packed guid bytes");
+
+AssetIndexSource MakeIndexSource(const AssetEntry& entry, std::optional<std::string_view> settingsText) noexcept {
+    return AssetIndexSource{
+        .Guid = entry.Guid,
+        .Path = entry.Path,
+        .Type = entry.Type,
+        .Dependencies = std::as_bytes(std::span{entry.Dependencies}),
+        .SettingsText = settingsText};
+}
+
+}  // namespace
+
+/// `assets.index`: 由清单派生的只读二进制索引, 整体 mmap, 不进版本控制。
+///
+/// 布局(小端): 72 字节头, 按 GUID 升序的定长记录表, 按 path key 散列的开放寻址桶(记录号 + 1,
+/// 0 为空), 依赖 GUID 表, 字符串池。头里记着生成它的清单的字节数、mtime 与哈希: 大小不符即
+/// 视为过期; 大小与 mtime 都相符且 mtime 已落定时不读清单, 否则才哈希清单比对。头里另记清单
+/// 是否由 Save 写出、写出时 importer 集合的哈希, 供增量 Save 判断能否复用记录。
+///
+/// Open 只检查头与各段长度, 不哈希正文、不逐条校验: 记录的偏移在 GetRecord 取用时才查边界,
+/// 越界的记录读作不存在, 由调用方决定如何失败。
+///
+/// Save 之后索引不再映射文件, 而是持有刚编码的字节: 这样不必重读刚写出的文件, Windows 上
+/// 也不会因为映射而无法替换它。
+class AssetDatabaseIndex {
+public:
+    struct Record {
+        AssetId Guid;
+        uint64_t PathKeyHash{0};
+        std::string_view Path;
+        std::string_view Type;
+        std::optional<std::string_view> Settings;
+        uint32_t DependencyFirst{0};
+        uint32_t DependencyCount{0};
+    };
+
+    /// hashManifest 只在头里的大小与 mtime 不足以确认清单时调用, 返回 nullopt 表示清单读不出。
+    /// 哈希确认过、mtime 已落定的清单会被补记进索引头, 下次 Open 就不必再读清单。
+    template <class HashManifest>
+    static unique_ptr<AssetDatabaseIndex> Open(
+        const std::filesystem::path& path,
+        const ManifestStamp& manifest,
+        const HashManifest& hashManifest) {
+        std::optional<MappedFile> file = MappedFile::Open(path);
+        if (!file.has_value()) {
+            return nullptr;
+        }
+        unique_ptr<AssetDatabaseIndex> index{new AssetDatabaseIndex{}};
+        index->_file = std::move(file.value());
+        bool hashed = false;
+        const auto hashOnce = [&hashManifest, &hashed]() {
+            hashed = true;
+            return hashManifest();
+        };
+        if (!index->Attach(index->_file.GetData(), manifest, hashOnce)) {
+            return nullptr;
+        }
+        if (!hashed || !IsSettledWriteTime(manifest.WriteTime)) {
+            return index;
+        }
+        string bytes{index->_file.GetText()};
+        const uint64_t manifestHash = index->_manifestHash;
+        // 先释放映射, 再替换文件。
+        index.reset();
+        BinaryWriter stamp;
+        stamp.U64(static_cast<uint64_t>(manifest.WriteTime));
+        bytes.replace(kIndexManifestWriteTimeOffset, 8, reinterpret_cast<const char*>(stamp.GetData().data()), 8);
+        bytes[kIndexFlagsOffset] = static_cast<char>(static_cast<uint8_t>(bytes[kIndexFlagsOffset]) | kIndexFlagStampSettled);
+        string error;
+        if (!WriteManifestAtomically(path, bytes, error)) {
+            RADRAY_DEBUG_LOG("AssetDatabase: cannot restamp binary index: {}", error);
+        }
+        return FromBytes(std::move(bytes), manifest, manifestHash);
+    }
+
+    /// 接管 Encode 的输出。
+    static unique_ptr<AssetDatabaseIndex> FromBytes(
+        string bytes,
+        const ManifestStamp& manifest,
+        uint64_t manifestHash) {
+        unique_ptr<AssetDatabaseIndex> index{new AssetDatabaseIndex{}};
+        index->_bytes = std::move(bytes);
+        const auto knownHash = [manifestHash]() { return std::optional<uint64_t>{manifestHash}; };
+        return index->Attach(std::as_bytes(std::span{index->_bytes}), manifest, knownHash) ? std::move(index) : nullptr;
+    }
+
+    /// 写不出(字符串池超过 4 GiB)时返回 nullopt。
+    static std::optional<string> Encode(
+        vector<AssetIndexSource> sources,
+        const ManifestStamp& manifest,
+        uint64_t manifestHash,
+        uint64_t importersHash,
+        uint32_t flags) {
+        std::sort(sources.begin(), sources.end(), [](const AssetIndexSource& lhs, const AssetIndexSource& rhs) {
+            return lhs.Guid < rhs.Guid;
+        });
+        const uint32_t bucketCount = std::bit_ceil(static_cast<uint32_t>(std::max<size_t>(sources.size() * 2, 1)));
+        vector<uint32_t> buckets(bucketCount, 0);
+        BinaryWriter records{sources.size() * kIndexRecordSize};
+        BinaryWriter dependencies;
+        string strings;
+        uint32_t dependencyCount = 0;
+        const auto appendString = [&strings](std::string_view value, uint32_t& offset, uint32_t& size) {
+            if (strings.size() + value.size() >= kIndexNoSettings) {
+                return false;
+            }
+            offset = static_cast<uint32_t>(strings.size());
+            size = static_cast<uint32_t>(value.size());
+            strings += value;
+            return true;
+        };
+        for (size_t recordIndex = 0; recordIndex < sources.size(); ++recordIndex) {
+            const AssetIndexSource& entry = sources[recordIndex];
+            const string pathKey = MakePathKey(entry.Path);
+            const uint64_t pathKeyHash = HashData64(pathKey.data(), pathKey.size());
+            uint32_t pathOffset = 0;
+            uint32_t pathSize = 0;
+            uint32_t typeOffset = 0;
+            uint32_t typeSize = 0;
+            uint32_t settingsOffset = 0;
+            uint32_t settingsSize = kIndexNoSettings;
+            if (!appendString(entry.Path, pathOffset, pathSize) ||
+                !appendString(entry.Type, typeOffset, typeSize) ||
+                (entry.SettingsText.has_value() &&
+                 !appendString(entry.SettingsText.value(), settingsOffset, settingsSize))) {
+                return std::nullopt;
+            }
+            records.Bytes(std::as_bytes(std::span{entry.Guid.Bytes()}));
+            records.U64(pathKeyHash);
+            records.U32(pathOffset);
+            records.U32(pathSize);
+            records.U32(typeOffset);
+            records.U32(typeSize);
+            records.U32(settingsOffset);
+            records.U32(settingsSize);
+            records.U32(dependencyCount);
+            records.Size32(entry.Dependencies.size() / Guid::Size);
+            dependencies.Bytes(entry.Dependencies);
+            dependencyCount += static_cast<uint32_t>(entry.Dependencies.size() / Guid::Size);
+
+            uint32_t slot = static_cast<uint32_t>(pathKeyHash) & (bucketCount - 1);
+            while (buckets[slot] != 0) {
+                slot = (slot + 1) & (bucketCount - 1);
+            }
+            buckets[slot] = static_cast<uint32_t>(recordIndex) + 1;
+        }
+
+        BinaryWriter body{records.GetSize() + size_t{bucketCount} * 4 + dependencies.GetSize() + strings.size()};
+        body.Bytes(records.GetData());
+        for (uint32_t bucket : buckets) {
+            body.U32(bucket);
+        }
+        body.Bytes(dependencies.GetData());
+        body.Bytes(std::as_bytes(std::span{strings}));
+
+        BinaryWriter header{kIndexHeaderSize};
+        header.U32(kIndexMagic);
+        header.U32(kIndexVersion);
+        header.U32(kIndexPathKeyFlavor);
+        header.Size32(sources.size());
+        header.U64(manifest.Size);
+        header.U64(manifestHash);
+        header.U64(static_cast<uint64_t>(manifest.WriteTime));
+        header.U32(bucketCount);
+        header.U32(dependencyCount);
+        header.U64(strings.size());
+        header.U64(importersHash);
+        header.U32(flags | (IsSettledWriteTime(manifest.WriteTime) ? kIndexFlagStampSettled : 0));
+        header.U32(0);
+
+        string out;
+        out.reserve(header.GetSize() + body.GetSize());
+        out.append(reinterpret_cast<const char*>(header.GetData().data()), header.GetSize());
+        out.append(reinterpret_cast<const char*>(body.GetData().data()), body.GetSize());
+        return out;
+    }
+
+    uint32_t GetCount() const noexcept { return _count; }
+    uint64_t GetImportersHash() const noexcept { return _importersHash; }
+    bool IsSaveOutput() const noexcept { return (_flags & kIndexFlagSaveOutput) != 0; }
+    /// FromBytes 接管的字节; 映射文件的索引返回空。
+    std::string_view GetOwnedBytes() const noexcept { return _bytes; }
+
+    AssetId GetGuid(uint32_t index) const noexcept {
+        Guid::ByteArray bytes{};
+        std::memcpy(bytes.data(), _records.data() + size_t{index} * kIndexRecordSize, Guid::Size);
+        return AssetId{bytes};
+    }
+
+    /// 偏移越出字符串池或依赖表时返回 nullopt。
+    std::optional<Record> GetRecord(uint32_t index) const noexcept {
+        BinaryReader reader{_records.subspan(size_t{index} * kIndexRecordSize + Guid::Size, kIndexRecordSize - Guid::Size)};
+        Record record{.Guid = GetGuid(index)};
+        uint32_t pathOffset = 0;
+        uint32_t pathSize = 0;
+        uint32_t typeOffset = 0;
+        uint32_t typeSize = 0;
+        uint32_t settingsOffset = 0;
+        uint32_t settingsSize = 0;
+        // 记录表的长度在 Attach 里核对过, 定长字段的读取不会失败。
+        reader.U64(record.PathKeyHash);
+        reader.U32(pathOffset);
+        reader.U32(pathSize);
+        reader.U32(typeOffset);
+        reader.U32(typeSize);
+        reader.U32(settingsOffset);
+        reader.U32(settingsSize);
+        reader.U32(record.DependencyFirst);
+        reader.U32(record.DependencyCount);
+        const auto inPool = [this](uint64_t offset, uint64_t size) {
+            return offset + size <= _strings.size();
+        };
+        if (!inPool(pathOffset, pathSize) || !inPool(typeOffset, typeSize) ||
+            (settingsSize != kIndexNoSettings && !inPool(settingsOffset, settingsSize)) ||
+            uint64_t{record.DependencyFirst} + record.DependencyCount > _dependencyCount) {
+            return std::nullopt;
+        }
+        record.Path = StringAt(pathOffset, pathSize);
+        record.Type = StringAt(typeOffset, typeSize);
+        if (settingsSize != kIndexNoSettings) {
+            record.Settings = StringAt(settingsOffset, settingsSize);
+        }
+        return record;
     }
-    if (!contents.empty()) {
-        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+    std::span<const byte> GetDependencyBytes(const Record& record) const noexcept {
+        return _dependencies.subspan(size_t{record.DependencyFirst} * Guid::Size, size_t{record.DependencyCount} * Guid::Size);
     }
-    file.flush();
-    const bool writeSucceeded = static_cast<bool>(file);
-    file.close();
-    if (!writeSucceeded || file.fail()) {
-        outError = fmt::format("failed to write temporary asset manifest '{}'", temporaryPath.string());
-        error.clear();
-        std::filesystem::remove(temporaryPath, error);
+
+    vector<AssetId> GetDependencies(const Record& record) const {
+        vector<AssetId> dependencies;
+        dependencies.reserve(record.DependencyCount);
+        for (uint32_t index = 0; index < record.DependencyCount; ++index) {
+            Guid::ByteArray bytes{};
+            std::memcpy(bytes.data(), _dependencies.data() + size_t{record.DependencyFirst + index} * Guid::Size, Guid::Size);
+            dependencies.emplace_back(bytes);
+        }
+        return dependencies;
+    }
+
+    /// GUID 乱序的索引只会让查找落空, 不会越界。
+    std::optional<uint32_t> FindById(const AssetId& id) const noexcept {
+        uint32_t first = 0;
+        uint32_t last = _count;
+        while (first < last) {
+            const uint32_t middle = first + (last - first) / 2;
+            const AssetId candidate = GetGuid(middle);
+            if (candidate == id) {
+                return middle;
+            }
+            if (candidate < id) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<uint32_t> FindByPathKey(std::string_view pathKey) const {
+        const uint64_t hash = HashData64(pathKey.data(), pathKey.size());
+        uint32_t slot = static_cast<uint32_t>(hash) & (_bucketCount - 1);
+        // 探测步数以桶数为限: 损坏的桶表可能没有空位。
+        for (uint32_t probe = 0; probe < _bucketCount; ++probe) {
+            const uint32_t bucket = BucketAt(slot);
+            if (bucket == 0 || bucket > _count) {
+                return std::nullopt;
+            }
+            const std::optional<Record> record = GetRecord(bucket - 1);
+            if (!record.has_value()) {
+                return std::nullopt;
+            }
+            if (record->PathKeyHash == hash && MakePathKey(record->Path) == pathKey) {
+                return bucket - 1;
+            }
+            slot = (slot + 1) & (_bucketCount - 1);
+        }
+        return std::nullopt;
+    }
+
+private:
+    AssetDatabaseIndex() noexcept = default;
+
+    template <class HashManifest>
+    bool Attach(std::span<const byte> data, const ManifestStamp& manifest, const HashManifest& hashManifest) {
+        if (data.size() < kIndexHeaderSize) {
+            return false;
+        }
+        BinaryReader header{data.first(kIndexHeaderSize)};
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint32_t pathKeyFlavor = 0;
+        uint64_t storedManifestSize = 0;
+        uint64_t storedManifestWriteTime = 0;
+        uint64_t stringPoolSize = 0;
+        uint32_t reserved = 0;
+        if (!header.U32(magic) || magic != kIndexMagic ||
+            !header.U32(version) || version != kIndexVersion ||
+            !header.U32(pathKeyFlavor) || pathKeyFlavor != kIndexPathKeyFlavor ||
+            !header.U32(_count) ||
+            !header.U64(storedManifestSize) || storedManifestSize != manifest.Size ||
+            !header.U64(_manifestHash) ||
+            !header.U64(storedManifestWriteTime) ||
+            !header.U32(_bucketCount) || !std::has_single_bit(_bucketCount) ||
+            !header.U32(_dependencyCount) ||
+            !header.U64(stringPoolSize) ||
+            !header.U64(_importersHash) ||
+            !header.U32(_flags) ||
+            !header.U32(reserved)) {
+            return false;
+        }
+        const std::span<const byte> body = data.subspan(kIndexHeaderSize);
+        const uint64_t expectedBodySize = uint64_t{_count} * kIndexRecordSize + uint64_t{_bucketCount} * 4 +
+                                          uint64_t{_dependencyCount} * Guid::Size + stringPoolSize;
+        if (body.size() != expectedBodySize) {
+            return false;
+        }
+        const bool stampMatches = (_flags & kIndexFlagStampSettled) != 0 &&
+                                  static_cast<int64_t>(storedManifestWriteTime) == manifest.WriteTime;
+        if (!stampMatches) {
+            const std::optional<uint64_t> manifestHash = hashManifest();
+            if (!manifestHash.has_value() || manifestHash.value() != _manifestHash) {
+                return false;
+            }
+        }
+        _records = body.first(size_t{_count} * kIndexRecordSize);
+        _buckets = body.subspan(_records.size(), size_t{_bucketCount} * 4);
+        _dependencies = body.subspan(_records.size() + _buckets.size(), size_t{_dependencyCount} * Guid::Size);
+        _strings = body.subspan(_records.size() + _buckets.size() + _dependencies.size());
+        return true;
+    }
+
+    uint32_t BucketAt(uint32_t slot) const noexcept {
+        BinaryReader reader{_buckets.subspan(size_t{slot} * 4, 4)};
+        uint32_t value = 0;
+        reader.U32(value);
+        return value;
+    }
+
+    std::string_view StringAt(uint32_t offset, uint32_t size) const noexcept {
+        return std::string_view{reinterpret_cast<const char*>(_strings.data()) + offset, size};
+    }
+
+    MappedFile _file;
+    string _bytes;
+    std::span<const byte> _records;
+    std::span<const byte> _buckets;
+    std::span<const byte> _dependencies;
+    std::span<const byte> _strings;
+    uint32_t _count{0};
+    uint32_t _bucketCount{0};
+    uint32_t _dependencyCount{0};
+    uint64_t _manifestHash{0};
+    uint64_t _importersHash{0};
+    uint32_t _flags{0};
+};
+
+namespace {
+
+/// 注册的 importer 类型集合的哈希。集合变化会改变条目 settings 的解码结果(RawSettings 与
+/// 强类型 settings 互转), 此时 Save 不能复用旧记录。
+uint64_t HashImporterTypes(const unordered_map<string, AssetImporter*>& importers) {
+    vector<std::string_view> types;
+    types.reserve(importers.size());
+    for (const auto& [type, importer] : importers) {
+        types.push_back(type);
+    }
+    std::sort(types.begin(), types.end());
+    HashStream64 stream;
+    for (std::string_view type : types) {
+        stream.Update(type.data(), type.size());
+        stream.Update("", 1);
+    }
+    return stream.GetDigest();
+}
+
+/// 扩展名到 importer type 的认领表。新认领的扩展名会让列表未变的目录里也冒出待登记的文件。
+uint64_t HashClaimedExtensions(const unordered_map<string, AssetImporter*>& extensionImporters) {
+    vector<std::pair<std::string_view, std::string_view>> claims;
+    claims.reserve(extensionImporters.size());
+    for (const auto& [extension, importer] : extensionImporters) {
+        claims.emplace_back(extension, importer->GetTypeName());
+    }
+    std::sort(claims.begin(), claims.end());
+    HashStream64 stream;
+    for (const auto& [extension, type] : claims) {
+        stream.Update(extension.data(), extension.size());
+        stream.Update("", 1);
+        stream.Update(type.data(), type.size());
+        stream.Update("", 1);
+    }
+    return stream.GetDigest();
+}
+
+/// 索引只是缓存: 写不出时只记 debug, 下次 Open 仍走 JSON 路径。
+/// 这里的清单不是 Save 写出的, 记录里的 settings 是手写原文, 不能被增量 Save 复用。
+/// stamp 是映射清单之前 stat 到的; 映射之后清单若又被改写, mtime 必然不同, 下次 Open 会哈希比对。
+void WriteAssetIndex(
+    const std::filesystem::path& assetRoot,
+    vector<AssetIndexSource> sources,
+    std::string_view manifest,
+    const std::optional<ManifestStamp>& stamp,
+    uint64_t importersHash) {
+    RADRAY_PROFILE_SCOPE("AssetDatabase::WriteIndex");
+    const std::optional<string> encoded = AssetDatabaseIndex::Encode(
+        std::move(sources),
+        ManifestStamp{.Size = manifest.size(), .WriteTime = stamp.has_value() && stamp->Size == manifest.size() ? stamp->WriteTime : 0},
+        HashData64(manifest.data(), manifest.size()),
+        importersHash,
+        0);
+    string error;
+    if (!encoded.has_value()) {
+        RADRAY_DEBUG_LOG("AssetDatabase: manifest is too large for a binary index");
+    } else if (!WriteManifestAtomically(assetRoot / kIndexFileName, encoded.value(), error)) {
+        RADRAY_DEBUG_LOG("AssetDatabase: cannot write binary index: {}", error);
+    }
+}
+
+/// Save 输出里的一个条目。Entry 非空表示要按内存中的条目重新编码 settings; 否则 Source 指向
+/// 上次 Save 的索引记录, 原样复用。
+struct SaveItem {
+    AssetIndexSource Source;
+    const AssetEntry* Entry{nullptr};
+    string EncodedSettings;
+    bool EncodeFailed{false};
+};
+
+/// 把 [0, count) 切成连续块分给至多 kMaxSaveWorkers 个线程; 量小时直接在调用线程上跑。
+template <class Fn>
+void ParallelFor(size_t count, const Fn& fn) {
+    const size_t workerCount = count < kParallelSaveMinEntries
+                                   ? 1
+                                   : std::min<size_t>(std::clamp(std::thread::hardware_concurrency(), 1u, kMaxSaveWorkers), count);
+    const size_t chunk = (count + workerCount - 1) / workerCount;
+    vector<std::thread> workers;
+    workers.reserve(workerCount - 1);
+    for (size_t worker = 1; worker < workerCount; ++worker) {
+        workers.emplace_back([&fn, first = worker * chunk, last = std::min(count, (worker + 1) * chunk)]() {
+            for (size_t index = first; index < last; ++index) {
+                fn(index);
+            }
+        });
+    }
+    for (size_t index = 0; index < std::min(count, chunk); ++index) {
+        fn(index);
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/// 只含可打印 ASCII 且不需要转义的串直接加引号, 与 yyjson 的输出逐字节相同; 其余交给 yyjson。
+bool AppendJsonString(string& out, std::string_view value) {
+    const bool plain = std::all_of(value.begin(), value.end(), [](char character) {
+        const auto code = static_cast<unsigned char>(character);
+        return code >= 0x20 && code < 0x7f && character != '"' && character != '\\';
+    });
+    if (plain) {
+        out += '"';
+        out += value;
+        out += '"';
+        return true;
+    }
+    const std::optional<string> encoded = EncodeJsonString(value);
+    if (!encoded.has_value()) {
         return false;
     }
+    out += encoded.value();
+    return true;
+}
 
-#if defined(RADRAY_PLATFORM_WINDOWS)
-    if (!MoveFileExW(
-            temporaryPath.c_str(),
-            manifestPath.c_str(),
-            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
-        const std::error_code moveError{
-            static_cast<int>(GetLastError()),
-            std::system_category()};
-        outError = fmt::format(
-            "failed to replace asset manifest '{}': {}",
-            manifestPath.string(),
-            moveError.message());
-        error.clear();
-        std::filesystem::remove(temporaryPath, error);
+/// 清单里一个条目的文本, 不含条目之间的分隔符。格式即 Save 的输出格式, 改动它等于改动清单格式。
+bool AppendManifestEntry(string& out, const AssetIndexSource& source) {
+    out += "    {\n      \"guid\": ";
+    if (!AppendJsonString(out, source.Guid.ToString())) {
         return false;
     }
-#else
-    std::filesystem::rename(temporaryPath, manifestPath, error);
-    if (error) {
-        outError = fmt::format(
-            "failed to replace asset manifest '{}': {}",
-            manifestPath.string(),
-            error.message());
-        std::error_code cleanupError;
-        std::filesystem::remove(temporaryPath, cleanupError);
+    out += ",\n      \"path\": ";
+    if (!AppendJsonString(out, source.Path)) {
         return false;
     }
-#endif
+    out += ",\n      \"type\": ";
+    if (!AppendJsonString(out, source.Type)) {
+        return false;
+    }
+    if (source.SettingsText.has_value()) {
+        out += ",\n      \"settings\": ";
+        out += source.SettingsText.value();
+    }
+    if (!source.Dependencies.empty()) {
+        out += ",\n      \"dependencies\": [";
+        for (size_t offset = 0; offset < source.Dependencies.size(); offset += Guid::Size) {
+            Guid::ByteArray bytes{};
+            std::memcpy(bytes.data(), source.Dependencies.data() + offset, Guid::Size);
+            out += offset == 0 ? "" : ", ";
+            if (!AppendJsonString(out, AssetId{bytes}.ToString())) {
+                return false;
+            }
+        }
+        out += "]";
+    }
+    out += "\n    }";
     return true;
 }
 
@@ -687,6 +1650,7 @@ unique_ptr<AssetDatabase> AssetDatabase::Open(
             }
         }
     }
+    database->_importersHash = HashImporterTypes(database->_importers);
 
     const std::filesystem::path manifestPath = database->_assetRoot / kManifestFileName;
     const bool manifestExists = std::filesystem::exists(manifestPath, error);
@@ -698,12 +1662,39 @@ unique_ptr<AssetDatabase> AssetDatabase::Open(
         return database;
     }
 
-    std::optional<string> source = ReadTextFile(manifestPath);
-    if (!source.has_value()) {
+    // 索引头里的大小与 mtime 对得上时清单一个字节都不读; 否则映射而非读入, 只哈希一遍。
+    const std::optional<ManifestStamp> manifestStamp = StatManifest(manifestPath);
+    std::optional<MappedFile> manifestFile;
+    const auto mapManifest = [&manifestFile, &manifestPath]() {
+        if (!manifestFile.has_value()) {
+            manifestFile = MappedFile::Open(manifestPath);
+        }
+        return manifestFile.has_value();
+    };
+    if (manifestStamp.has_value()) {
+        RADRAY_PROFILE_SCOPE("AssetDatabase::OpenIndex");
+        database->_index = AssetDatabaseIndex::Open(
+            database->_assetRoot / kIndexFileName,
+            manifestStamp.value(),
+            [&manifestFile, &mapManifest]() -> std::optional<uint64_t> {
+                if (!mapManifest()) {
+                    return std::nullopt;
+                }
+                const std::string_view text = manifestFile->GetText();
+                return HashData64(text.data(), text.size());
+            });
+    }
+    if (database->_index != nullptr) {
+        return database;
+    }
+    if (!mapManifest()) {
         outError = fmt::format("cannot read asset manifest '{}'", manifestPath.string());
         return nullptr;
     }
-    std::optional<JsonDocument> document = JsonDocument::Parse(source.value());
+    const std::string_view source = manifestFile->GetText();
+
+    RADRAY_PROFILE_SCOPE("AssetDatabase::ParseManifest");
+    std::optional<JsonDocument> document = JsonDocument::Parse(source);
     if (!document.has_value()) {
         outError = fmt::format("asset manifest '{}' is not valid JSON", manifestPath.string());
         return nullptr;
@@ -726,12 +1717,14 @@ unique_ptr<AssetDatabase> AssetDatabase::Open(
     }
 
     vector<std::optional<string>> rawSettings;
-    SettingsSourceScanner scanner{source.value()};
+    SettingsSourceScanner scanner{source};
     if (!scanner.Scan(rawSettings) || rawSettings.size() != assets.Size()) {
         outError = "asset manifest settings source spans could not be recovered";
         return nullptr;
     }
 
+    vector<AssetIndexSource> indexSources;
+    indexSources.reserve(assets.Size());
     for (size_t index = 0; index < assets.Size(); ++index) {
         const JsonValue jsonEntry = assets.At(index);
         if (!jsonEntry.IsObject()) {
@@ -775,56 +1768,156 @@ unique_ptr<AssetDatabase> AssetDatabase::Open(
             return nullptr;
         }
 
-        AssetImporter* importer = database->FindImporter(entry.Type);
         const bool hasSettings = jsonEntry.Has("settings");
         if (hasSettings && !rawSettings[index].has_value()) {
             outError = fmt::format("asset entry {} settings text is unavailable", index);
             return nullptr;
         }
-        if (importer == nullptr) {
-            RADRAY_WARN_LOG("AssetDatabase: asset {} uses unregistered importer type '{}'", entry.Guid, entry.Type);
-            if (hasSettings) {
-                entry.RawSettings = std::move(rawSettings[index].value());
-            }
-        } else if (hasSettings) {
-            unique_ptr<AssetImportSettings> settings = importer->CreateSettings();
-            if (settings == nullptr) {
-                RADRAY_WARN_LOG("AssetDatabase: importer '{}' does not accept settings for asset {}", entry.Type, entry.Guid);
-                entry.RawSettings = std::move(rawSettings[index].value());
-            } else if (!settings->Deserialize(jsonEntry["settings"])) {
-                RADRAY_WARN_LOG("AssetDatabase: settings for asset {} failed to decode as type '{}'", entry.Guid, entry.Type);
-                entry.RawSettings = std::move(rawSettings[index].value());
-            } else {
-                entry.Settings = std::move(settings);
+        const JsonValue settingsJson = jsonEntry["settings"];
+        AssignEntrySettings(
+            database->FindImporter(entry.Type),
+            entry,
+            hasSettings ? &settingsJson : nullptr,
+            hasSettings ? std::optional<std::string_view>{rawSettings[index].value()} : std::nullopt);
+
+        if (jsonEntry.Has("dependencies")) {
+            const JsonValue dependencies = jsonEntry["dependencies"];
+            if (!dependencies.IsArray()) {
+                outError = fmt::format("asset entry {} 'dependencies' must be an array of guid strings", index);
+                return nullptr;
             }
-        } else {
-            entry.Settings = importer->CreateSettings();
+            vector<AssetId> parsed;
+            parsed.reserve(dependencies.Size());
+            for (size_t depIndex = 0; depIndex < dependencies.Size(); ++depIndex) {
+                const JsonValue dependency = dependencies.At(depIndex);
+                AssetId dependencyId;
+                if (!dependency.IsString() || !Guid::TryParse(dependency.AsString(), dependencyId) || dependencyId.IsEmpty()) {
+                    outError = fmt::format("asset entry {} has an invalid dependency at index {}", index, depIndex);
+                    return nullptr;
+                }
+                parsed.push_back(dependencyId);
+            }
+            entry.Dependencies = NormalizeDependencies(entry.Guid, parsed);
         }
 
-        WarnIfSourceFileUnavailable(
-            entry.Guid,
-            database->_assetRoot / PathFromUtf8(entry.Path));
-
         const AssetId guid = entry.Guid;
         database->_paths.emplace(pathKey, guid);
-        database->_entries.emplace(guid, std::move(entry));
+        const AssetEntry& inserted = database->_entries.emplace(guid, std::move(entry)).first->second;
+        indexSources.push_back(MakeIndexSource(
+            inserted,
+            hasSettings ? std::optional<std::string_view>{rawSettings[index].value()} : std::nullopt));
     }
 
+    // 下一次 Open 直接映射索引。
+    WriteAssetIndex(database->_assetRoot, std::move(indexSources), source, manifestStamp, database->_importersHash);
     return database;
 }
 
+AssetDatabase::~AssetDatabase() noexcept = default;
+
 const AssetEntry* AssetDatabase::Find(const AssetId& id) const noexcept {
-    auto it = _entries.find(id);
-    return it == _entries.end() ? nullptr : &it->second;
+    return Materialize(id);
 }
 
 const AssetEntry* AssetDatabase::Find(std::string_view relPath) const noexcept {
+    const std::optional<AssetId> id = FindId(relPath);
+    return id.has_value() ? Find(id.value()) : nullptr;
+}
+
+AssetEntry* AssetDatabase::Materialize(const AssetId& id) const noexcept {
+    if (auto it = _entries.find(id); it != _entries.end()) {
+        return &it->second;
+    }
+    if (_index == nullptr || _removedIndexed.contains(id)) {
+        return nullptr;
+    }
+    const std::optional<uint32_t> recordIndex = _index->FindById(id);
+    if (!recordIndex.has_value()) {
+        return nullptr;
+    }
+    return MaterializeRecord(recordIndex.value());
+}
+
+AssetEntry* AssetDatabase::MaterializeRecord(uint32_t recordIndex) const {
+    const std::optional<AssetDatabaseIndex::Record> indexed = _index->GetRecord(recordIndex);
+    if (!indexed.has_value()) {
+        RADRAY_WARN_LOG("AssetDatabase: binary index record {} is out of bounds; delete '{}' to rebuild it", recordIndex, kIndexFileName);
+        return nullptr;
+    }
+    const AssetDatabaseIndex::Record& record = indexed.value();
+    AssetEntry entry{
+        .Guid = record.Guid,
+        .Path = string{record.Path},
+        .Type = string{record.Type},
+        .Dependencies = _index->GetDependencies(record)};
+    std::optional<JsonDocument> settingsDocument;
+    JsonValue settingsJson;
+    if (record.Settings.has_value()) {
+        settingsDocument = JsonDocument::Parse(record.Settings.value());
+        if (settingsDocument.has_value()) {
+            settingsJson = settingsDocument->Root();
+        }
+    }
+    AssignEntrySettings(
+        FindImporter(entry.Type),
+        entry,
+        settingsDocument.has_value() ? &settingsJson : nullptr,
+        record.Settings);
+    _paths.emplace(MakePathKey(entry.Path), entry.Guid);
+    return &_entries.emplace(record.Guid, std::move(entry)).first->second;
+}
+
+bool AssetDatabase::MaterializeAll() const {
+    if (_index == nullptr) {
+        return true;
+    }
+    bool complete = true;
+    for (uint32_t recordIndex = 0; recordIndex < _index->GetCount(); ++recordIndex) {
+        const AssetId guid = _index->GetGuid(recordIndex);
+        if (!_entries.contains(guid) && !_removedIndexed.contains(guid)) {
+            complete = MaterializeRecord(recordIndex) != nullptr && complete;
+        }
+    }
+    if (!complete) {
+        return false;
+    }
+    _index.reset();
+    _removedIndexed.clear();
+    return true;
+}
+
+std::optional<AssetId> AssetDatabase::FindId(std::string_view relPath) const {
     const std::optional<string> normalized = NormalizeEntryPath(relPath);
     if (!normalized.has_value()) {
-        return nullptr;
+        return std::nullopt;
     }
-    auto pathIt = _paths.find(MakePathKey(normalized.value()));
-    return pathIt == _paths.end() ? nullptr : Find(pathIt->second);
+    return FindIdByPathKey(MakePathKey(normalized.value()));
+}
+
+std::optional<AssetId> AssetDatabase::FindIdByPathKey(const string& pathKey) const {
+    if (auto pathIt = _paths.find(pathKey); pathIt != _paths.end()) {
+        return pathIt->second;
+    }
+    if (_index == nullptr) {
+        return std::nullopt;
+    }
+    const std::optional<uint32_t> recordIndex = _index->FindByPathKey(pathKey);
+    if (!recordIndex.has_value()) {
+        return std::nullopt;
+    }
+    // 已实体化的条目以 _paths 为准: 它可能已被 SetPath 改名或被删除。
+    const AssetId guid = _index->GetGuid(recordIndex.value());
+    if (_entries.contains(guid) || _removedIndexed.contains(guid)) {
+        return std::nullopt;
+    }
+    return guid;
+}
+
+bool AssetDatabase::Contains(const AssetId& id) const noexcept {
+    if (_entries.contains(id)) {
+        return true;
+    }
+    return _index != nullptr && !_removedIndexed.contains(id) && _index->FindById(id).has_value();
 }
 
 std::filesystem::path AssetDatabase::ResolvePath(const AssetEntry& entry) const {
@@ -854,15 +1947,15 @@ std::optional<AssetId> AssetDatabase::AddEntry(
     }
 
     const string pathKey = MakePathKey(normalized.value());
-    if (auto existing = _paths.find(pathKey); existing != _paths.end()) {
-        outError = fmt::format("asset path '{}' is already registered as {}", normalized.value(), existing->second);
+    if (const std::optional<AssetId> existing = FindIdByPathKey(pathKey); existing.has_value()) {
+        outError = fmt::format("asset path '{}' is already registered as {}", normalized.value(), existing.value());
         return std::nullopt;
     }
 
     AssetId guid;
     do {
         guid = Guid::NewGuid();
-    } while (guid.IsEmpty() || _entries.contains(guid));
+    } while (guid.IsEmpty() || Contains(guid));
 
     AssetEntry entry{
         .Guid = guid,
@@ -876,6 +1969,7 @@ std::optional<AssetId> AssetDatabase::AddEntry(
 
     _paths.emplace(pathKey, guid);
     _entries.emplace(guid, std::move(entry));
+    _registrationsUnsaved = true;
     return guid;
 }
 
@@ -884,8 +1978,8 @@ bool AssetDatabase::SetPath(
     std::string_view newRelPath,
     string& outError) {
     outError.clear();
-    auto entryIt = _entries.find(id);
-    if (entryIt == _entries.end()) {
+    AssetEntry* entry = Materialize(id);
+    if (entry == nullptr) {
         outError = fmt::format("asset {} is not registered", id);
         return false;
     }
@@ -898,82 +1992,204 @@ bool AssetDatabase::SetPath(
     }
 
     const string newKey = MakePathKey(normalized.value());
-    if (auto existing = _paths.find(newKey); existing != _paths.end() && existing->second != id) {
-        outError = fmt::format("asset path '{}' is already registered as {}", normalized.value(), existing->second);
+    if (const std::optional<AssetId> existing = FindIdByPathKey(newKey); existing.has_value() && existing.value() != id) {
+        outError = fmt::format("asset path '{}' is already registered as {}", normalized.value(), existing.value());
         return false;
     }
 
-    _paths.erase(MakePathKey(entryIt->second.Path));
-    entryIt->second.Path = normalized.value();
+    _paths.erase(MakePathKey(entry->Path));
+    entry->Path = normalized.value();
     _paths.emplace(newKey, id);
+    _dirty.insert(id);
+    _registrationsUnsaved = true;
     return true;
 }
 
-bool AssetDatabase::RemoveEntry(const AssetId& id) noexcept {
-    auto it = _entries.find(id);
-    if (it == _entries.end()) {
+bool AssetDatabase::SetDependencies(
+    const AssetId& id,
+    std::span<const AssetId> dependencies,
+    string& outError) {
+    outError.clear();
+    AssetEntry* entry = Materialize(id);
+    if (entry == nullptr) {
+        outError = fmt::format("asset {} is not registered", id);
         return false;
     }
-    _paths.erase(MakePathKey(it->second.Path));
-    _entries.erase(it);
+    AssignDependencies(*entry, dependencies);
     return true;
 }
 
+bool AssetDatabase::RemoveEntry(const AssetId& id) noexcept {
+    bool removed = false;
+    _dirty.erase(id);
+    _settingsExposed.erase(id);
+    if (auto it = _entries.find(id); it != _entries.end()) {
+        _paths.erase(MakePathKey(it->second.Path));
+        _entries.erase(it);
+        removed = true;
+    }
+    if (_index != nullptr && !_removedIndexed.contains(id) && _index->FindById(id).has_value()) {
+        _removedIndexed.insert(id);
+        removed = true;
+    }
+    _registrationsUnsaved = _registrationsUnsaved || removed;
+    return removed;
+}
+
 bool AssetDatabase::Save(string& outError) const {
+    RADRAY_PROFILE_SCOPE("AssetDatabase::Save");
     outError.clear();
-    vector<const AssetEntry*> entries;
-    entries.reserve(_entries.size());
+    // 上次 Save 写出的索引记录就是未改动条目在清单里的输出, 原样复用, 只重新编码改动过的条目。
+    // 索引来自手写清单或 importer 集合变了时, 记录不再等于 Save 的输出, 退回全量编码。
+    const bool reuseIndex = _index != nullptr && _index->IsSaveOutput() && _index->GetImportersHash() == _importersHash;
+    // 越界的索引记录无从恢复, 宁可不写也不能让它从清单里消失。
+    const auto reportCorruptIndex = [&outError] {
+        outError = fmt::format("binary index '{}' has out-of-bounds records; delete it and reopen the database", kIndexFileName);
+        return false;
+    };
+    if (!reuseIndex && !MaterializeAll()) {
+        return reportCorruptIndex();
+    }
+
+    vector<SaveItem> items;
+    items.reserve(_entries.size() + (reuseIndex ? _index->GetCount() : 0));
+    const auto pushRecord = [this, &items](uint32_t recordIndex) {
+        const std::optional<AssetDatabaseIndex::Record> indexed = _index->GetRecord(recordIndex);
+        if (!indexed.has_value()) {
+            return false;
+        }
+        const AssetDatabaseIndex::Record& record = indexed.value();
+        items.push_back(SaveItem{.Source = AssetIndexSource{
+                                     .Guid = record.Guid,
+                                     .Path = record.Path,
+                                     .Type = record.Type,
+                                     .Dependencies = _index->GetDependencyBytes(record),
+                                     .SettingsText = record.Settings}});
+        return true;
+    };
     for (const auto& [guid, entry] : _entries) {
-        entries.push_back(&entry);
+        std::optional<uint32_t> recordIndex;
+        if (reuseIndex && !_dirty.contains(guid) && !_settingsExposed.contains(guid)) {
+            recordIndex = _index->FindById(guid);
+        }
+        // 已实体化的条目在内存里有权威副本, 记录读不出时照常重新编码。
+        if (!recordIndex.has_value() || !pushRecord(recordIndex.value())) {
+            items.push_back(SaveItem{.Source = MakeIndexSource(entry, std::nullopt), .Entry = &entry});
+        }
+    }
+    for (uint32_t recordIndex = 0; reuseIndex && recordIndex < _index->GetCount(); ++recordIndex) {
+        const AssetId guid = _index->GetGuid(recordIndex);
+        if (!_entries.contains(guid) && !_removedIndexed.contains(guid) && !pushRecord(recordIndex)) {
+            return reportCorruptIndex();
+        }
     }
-    std::sort(entries.begin(), entries.end(), [](const AssetEntry* left, const AssetEntry* right) {
-        return left->Path < right->Path;
+    std::sort(items.begin(), items.end(), [](const SaveItem& left, const SaveItem& right) {
+        return left.Source.Path < right.Source.Path;
     });
 
-    string manifest = "{\n  \"version\": 1,\n  \"assets\": [";
-    if (!entries.empty()) {
-        manifest.push_back('\n');
-    }
-    for (size_t index = 0; index < entries.size(); ++index) {
-        const AssetEntry& entry = *entries[index];
-        const std::optional<string> guid = EncodeJsonString(entry.Guid.ToString());
-        const std::optional<string> path = EncodeJsonString(entry.Path);
-        const std::optional<string> type = EncodeJsonString(entry.Type);
-        if (!guid.has_value() || !path.has_value() || !type.has_value()) {
-            outError = fmt::format("failed to encode manifest strings for asset {}", entry.Guid);
+    vector<size_t> encodeQueue;
+    for (size_t index = 0; index < items.size(); ++index) {
+        if (items[index].Entry != nullptr && items[index].Entry->Settings != nullptr) {
+            encodeQueue.push_back(index);
+        }
+    }
+    RADRAY_PROFILE_COUNTER("AssetDatabase::SaveEncodedSettings", encodeQueue.size());
+    ParallelFor(encodeQueue.size(), [&items, &encodeQueue](size_t queueIndex) {
+        SaveItem& item = items[encodeQueue[queueIndex]];
+        std::optional<string> settings = EncodeSettings(*item.Entry->Settings);
+        item.EncodeFailed = !settings.has_value();
+        if (settings.has_value()) {
+            item.EncodedSettings = std::move(settings.value());
+        }
+    });
+    for (SaveItem& item : items) {
+        if (item.Entry == nullptr) {
+            continue;
+        }
+        if (item.EncodeFailed) {
+            outError = fmt::format("failed to encode settings for asset {}", item.Source.Guid);
             return false;
         }
-
-        manifest += "    {\n      \"guid\": ";
-        manifest += guid.value();
-        manifest += ",\n      \"path\": ";
-        manifest += path.value();
-        manifest += ",\n      \"type\": ";
-        manifest += type.value();
-
-        if (entry.Settings != nullptr) {
-            const std::optional<string> settings = EncodeSettings(*entry.Settings);
-            if (!settings.has_value()) {
-                outError = fmt::format("failed to encode settings for asset {}", entry.Guid);
-                return false;
-            }
-            manifest += ",\n      \"settings\": ";
-            manifest += settings.value();
-        } else if (!entry.RawSettings.empty()) {
-            manifest += ",\n      \"settings\": ";
-            manifest += entry.RawSettings;
+        if (item.Entry->Settings != nullptr) {
+            item.Source.SettingsText = item.EncodedSettings;
+        } else if (!item.Entry->RawSettings.empty()) {
+            item.Source.SettingsText = item.Entry->RawSettings;
         }
-        manifest += "\n    }";
-        manifest += index + 1 == entries.size() ? "\n" : ",\n";
     }
-    manifest += "  ]\n}\n";
 
-    const std::filesystem::path manifestPath = _assetRoot / kManifestFileName;
-    return WriteManifestAtomically(manifestPath, manifest, outError);
+    // 边写边算清单哈希, 整份清单不必在内存里拼出来。
+    AtomicFileWriter writer{_assetRoot / kManifestFileName};
+    if (!writer.Open(outError)) {
+        return false;
+    }
+    HashStream64 manifestHash;
+    uint64_t manifestSize = 0;
+    const auto emit = [&](std::string_view text) {
+        writer.Write(text);
+        manifestHash.Update(text.data(), text.size());
+        manifestSize += text.size();
+    };
+    emit(items.empty() ? "{\n  \"version\": 1,\n  \"assets\": [" : "{\n  \"version\": 1,\n  \"assets\": [\n");
+    string fragment;
+    for (size_t index = 0; index < items.size(); ++index) {
+        fragment.clear();
+        if (!AppendManifestEntry(fragment, items[index].Source)) {
+            outError = fmt::format("failed to encode manifest strings for asset {}", items[index].Source.Guid);
+            return false;
+        }
+        fragment += index + 1 == items.size() ? "\n" : ",\n";
+        emit(fragment);
+    }
+    emit("  ]\n}\n");
+    if (!writer.Commit(outError)) {
+        return false;
+    }
+    // stat 不到 mtime 时记 0: 下次 Open 对不上, 哈希清单确认。
+    const std::optional<ManifestStamp> writtenStamp = StatManifest(_assetRoot / kManifestFileName);
+    const ManifestStamp manifestStamp{
+        .Size = manifestSize,
+        .WriteTime = writtenStamp.has_value() && writtenStamp->Size == manifestSize ? writtenStamp->WriteTime : 0};
+
+    vector<AssetIndexSource> indexSources;
+    indexSources.reserve(items.size());
+    for (const SaveItem& item : items) {
+        indexSources.push_back(item.Source);
+    }
+    unique_ptr<AssetDatabaseIndex> index;
+    {
+        RADRAY_PROFILE_SCOPE("AssetDatabase::WriteIndex");
+        std::optional<string> encoded = AssetDatabaseIndex::Encode(
+            std::move(indexSources),
+            manifestStamp,
+            manifestHash.GetDigest(),
+            _importersHash,
+            kIndexFlagSaveOutput);
+        if (encoded.has_value()) {
+            index = AssetDatabaseIndex::FromBytes(std::move(encoded.value()), manifestStamp, manifestHash.GetDigest());
+        }
+    }
+    if (index == nullptr) {
+        RADRAY_DEBUG_LOG("AssetDatabase: manifest is too large for a binary index");
+        // 没有新索引接替, 旧索引里剩下的条目必须先实体化。
+        MaterializeAll();
+    } else {
+        // 先替换(从而释放)旧索引的映射, 再覆盖索引文件。
+        _index = std::move(index);
+        string indexError;
+        if (!WriteManifestAtomically(_assetRoot / kIndexFileName, _index->GetOwnedBytes(), indexError)) {
+            RADRAY_DEBUG_LOG("AssetDatabase: cannot write binary index: {}", indexError);
+        }
+    }
+    _removedIndexed.clear();
+    _dirty.clear();
+    _registrationsUnsaved = false;
+    return true;
 }
 
 bool AssetDatabase::Refresh(string& outError) {
+    RADRAY_PROFILE_SCOPE("AssetDatabase::Refresh");
     outError.clear();
+    _lastRefreshStats = {};
     std::error_code error;
     if (!std::filesystem::is_directory(_assetRoot, error)) {
         outError = error
@@ -982,46 +2198,135 @@ bool AssetDatabase::Refresh(string& outError) {
         return false;
     }
 
-    std::filesystem::recursive_directory_iterator iterator{_assetRoot, error};
-    const std::filesystem::recursive_directory_iterator end;
-    while (iterator != end) {
-        if (error) {
-            outError = fmt::format("failed while scanning asset root '{}': {}", _assetRoot.string(), error.message());
-            return false;
+    const std::filesystem::path snapshotPath = _assetRoot / kRefreshSnapshotFileName;
+    const RefreshSnapshot previous = LoadRefreshSnapshot(snapshotPath);
+    const int64_t scanStart = ToFileTimeTicks(std::filesystem::file_time_type::clock::now());
+    const int64_t racyLimit = previous.ScanStart - RefreshRacyWindowTicks();
+    const uint32_t workerCount = std::clamp(std::thread::hardware_concurrency(), 1u, kMaxRefreshWorkers);
+    ParallelDirectoryScan scan{_assetRoot, previous, racyLimit};
+    if (!scan.Run(workerCount, outError)) {
+        return false;
+    }
+    vector<RefreshDirectory>& directories = scan.GetResults();
+    _lastRefreshStats.DirectoryCount = static_cast<uint32_t>(directories.size());
+    _lastRefreshStats.RescannedDirectoryCount = scan.GetRescannedCount();
+
+    // 快照核对过的登记就是磁盘上这份清单、认领的扩展名也没变, 且之后没有未 Save 的登记改动时,
+    // 列表未变的目录整个跳过, 代价只与变化的目录成正比。否则 (例如上次登记后没 Save 就退出,
+    // 文件此时不在清单里, 必须再次被发现) 逐个文件查内存索引。
+    const std::optional<ManifestStamp> manifest = StatManifest(_assetRoot / kManifestFileName);
+    const uint64_t extensionsHash = HashClaimedExtensions(_extensionImporters);
+    const bool reconciled = !_registrationsUnsaved &&
+                            manifest.has_value() &&
+                            previous.Reconciled == manifest &&
+                            previous.ExtensionsHash == extensionsHash;
+    unordered_set<AssetId> present;
+    if (!reconciled) {
+        present.reserve(_entries.size() + (_index != nullptr ? _index->GetCount() : 0));
+    }
+    bool listingsChanged = previous.Directories.size() != directories.size();
+    for (const RefreshDirectory& directory : directories) {
+        listingsChanged = listingsChanged || directory.Changed;
+        if (reconciled && !directory.Changed) {
+            ++_lastRefreshStats.SkippedDirectoryCount;
+            continue;
         }
-        const std::filesystem::directory_entry& file = *iterator;
-        error.clear();
-        const bool regularFile = file.is_regular_file(error);
-        if (error) {
-            outError = fmt::format("cannot inspect asset path '{}': {}", file.path().string(), error.message());
-            return false;
+        for (const string& name : directory.Files) {
+            if (directory.Path.empty() &&
+                (name == kManifestFileName || name == kIndexFileName || name == kRefreshSnapshotFileName)) {
+                continue;
+            }
+            const string storedPath = JoinRelativePath(directory.Path, name);
+            if (const std::optional<AssetId> existing = FindId(storedPath); existing.has_value()) {
+                present.insert(existing.value());
+                continue;
+            }
+            const string extension = LowerAscii(PathFromUtf8(name).extension().generic_string());
+            auto importerIt = _extensionImporters.find(extension);
+            if (importerIt == _extensionImporters.end()) {
+                continue;
+            }
+            const std::optional<AssetId> added = AddEntry(storedPath, importerIt->second->GetTypeName(), outError);
+            if (!added.has_value()) {
+                return false;
+            }
+            present.insert(added.value());
+            ++_lastRefreshStats.AddedCount;
         }
-        if (regularFile) {
-            const std::filesystem::path relativePath = file.path().lexically_relative(_assetRoot);
-            const string storedPath = PathToUtf8(relativePath);
-            if (storedPath != kManifestFileName && Find(storedPath) == nullptr) {
-                const string extension = LowerAscii(relativePath.extension().generic_string());
-                auto importerIt = _extensionImporters.find(extension);
-                if (importerIt != _extensionImporters.end()) {
-                    if (!AddEntry(storedPath, importerIt->second->GetTypeName(), outError).has_value()) {
-                        return false;
-                    }
+    }
+
+    if (reconciled) {
+        // 上次核对时都在, 所以只有从快照列表里消失的文件可能缺失: 变化目录里少掉的, 以及整个消失的目录。
+        auto warnIfRegistered = [this](std::string_view directoryPath, const string& name) {
+            const string storedPath = JoinRelativePath(directoryPath, name);
+            if (const std::optional<AssetId> missing = FindId(storedPath); missing.has_value()) {
+                ++_lastRefreshStats.UnseenCount;
+                WarnIfSourceFileUnavailable(missing.value(), (_assetRoot / PathFromUtf8(storedPath)).lexically_normal());
+            }
+        };
+        for (const RefreshDirectory& directory : directories) {
+            auto previousIt = previous.Directories.find(directory.Path);
+            if (!directory.Changed || previousIt == previous.Directories.end()) {
+                continue;
+            }
+            for (const string& name : previousIt->second.Files) {
+                if (!std::ranges::binary_search(directory.Files, name)) {
+                    warnIfRegistered(directory.Path, name);
                 }
             }
         }
-        iterator.increment(error);
-    }
-    if (error) {
-        outError = fmt::format("failed while scanning asset root '{}': {}", _assetRoot.string(), error.message());
-        return false;
+        for (const auto& [path, directory] : previous.Directories) {
+            if (!std::ranges::binary_search(directories, path, std::ranges::less{}, &RefreshDirectory::Path)) {
+                listingsChanged = true;
+                for (const string& name : directory.Files) {
+                    warnIfRegistered(path, name);
+                }
+            }
+        }
+    } else {
+        // 只对扫描中没见到的条目再 stat 一次: 它们可能在符号链接目录里, 也可能真的缺失。
+        for (const auto& [guid, entry] : _entries) {
+            if (!present.contains(guid)) {
+                ++_lastRefreshStats.UnseenCount;
+                WarnIfSourceFileUnavailable(guid, ResolvePath(entry));
+            }
+        }
+        // 还留在索引里的条目不必为此实体化。
+        for (uint32_t recordIndex = 0; _index != nullptr && recordIndex < _index->GetCount(); ++recordIndex) {
+            const AssetId guid = _index->GetGuid(recordIndex);
+            if (present.contains(guid) || _entries.contains(guid) || _removedIndexed.contains(guid)) {
+                continue;
+            }
+            ++_lastRefreshStats.UnseenCount;
+            if (const std::optional<AssetDatabaseIndex::Record> record = _index->GetRecord(recordIndex); record.has_value()) {
+                WarnIfSourceFileUnavailable(guid, (_assetRoot / PathFromUtf8(record->Path)).lexically_normal());
+            }
+        }
     }
 
-    for (const auto& [guid, entry] : _entries) {
-        WarnIfSourceFileUnavailable(guid, ResolvePath(entry));
+    // 什么都没变时不重写快照: 写快照本身会推进根目录的 mtime, 也让无事可做的 Refresh 不碰磁盘。
+    // 刚写的清单还在不可信窗口内时不记为已核对, 下一次 Refresh 再核对一遍。
+    std::optional<ManifestStamp> nowReconciled;
+    if (!_registrationsUnsaved && manifest.has_value() && manifest->WriteTime < scanStart - RefreshRacyWindowTicks()) {
+        nowReconciled = manifest;
     }
+    if (listingsChanged || nowReconciled != previous.Reconciled || extensionsHash != previous.ExtensionsHash) {
+        string snapshotError;
+        const string snapshot = EncodeRefreshSnapshot(scanStart, nowReconciled, extensionsHash, directories);
+        if (!WriteManifestAtomically(snapshotPath, snapshot, snapshotError)) {
+            RADRAY_WARN_LOG("AssetDatabase: cannot write refresh snapshot, the next Refresh rescans everything: {}", snapshotError);
+        }
+    }
+    RADRAY_PROFILE_COUNTER("AssetDatabase::RefreshRescannedDirectories", _lastRefreshStats.RescannedDirectoryCount);
     return true;
 }
 
+uint64_t AssetImporter::EstimateLoadBytes(const AssetLoadContext& ctx) const {
+    std::error_code error;
+    const uintmax_t size = std::filesystem::file_size(ctx.AbsolutePath, error);
+    return error ? 0 : static_cast<uint64_t>(size);
+}
+
 std::optional<task<AssetLoadResult>> AssetDatabase::CreateLoadTask(const AssetId& id) {
     const AssetEntry* entry = Find(id);
     if (entry == nullptr) {
@@ -1039,9 +2344,53 @@ std::optional<task<AssetLoadResult>> AssetDatabase::CreateLoadTask(const AssetId
     return importer->Load(context);
 }
 
+uint64_t AssetDatabase::EstimateLoadBytes(const AssetId& id) const {
+    const AssetEntry* entry = Find(id);
+    if (entry == nullptr) {
+        return 0;
+    }
+    const AssetImporter* importer = FindImporter(entry->Type);
+    if (importer == nullptr) {
+        return 0;
+    }
+    AssetLoadContext context{
+        .AbsolutePath = ResolvePath(*entry),
+        .Settings = entry->Settings.get()};
+    return importer->EstimateLoadBytes(context);
+}
+
 std::optional<AssetId> AssetDatabase::ResolveId(std::string_view relPath) const {
-    const AssetEntry* entry = Find(relPath);
-    return entry != nullptr ? std::optional<AssetId>{entry->Guid} : std::nullopt;
+    return FindId(relPath);
+}
+
+std::optional<AssetId> AssetDatabase::ResolveSourceFile(const std::filesystem::path& absolutePath) const {
+    const std::filesystem::path relative = absolutePath.lexically_normal().lexically_relative(_assetRoot);
+    if (relative.empty() || *relative.begin() == "..") {
+        return std::nullopt;
+    }
+    return FindId(PathToUtf8(relative));
+}
+
+std::span<const AssetId> AssetDatabase::GetDependencies(const AssetId& id) const {
+    const AssetEntry* entry = Find(id);
+    return entry != nullptr ? std::span<const AssetId>{entry->Dependencies} : std::span<const AssetId>{};
+}
+
+void AssetDatabase::RecordDependencies(const AssetId& id, std::span<const AssetId> dependencies) {
+    AssetEntry* entry = Materialize(id);
+    if (entry == nullptr) {
+        return;
+    }
+    AssignDependencies(*entry, dependencies);
+}
+
+void AssetDatabase::AssignDependencies(AssetEntry& entry, std::span<const AssetId> dependencies) const {
+    vector<AssetId> normalized = NormalizeDependencies(entry.Guid, dependencies);
+    // 每次加载都会回报依赖; 没变时不弄脏条目, 下一次 Save 仍可复用它的记录。
+    if (normalized != entry.Dependencies) {
+        entry.Dependencies = std::move(normalized);
+        _dirty.insert(entry.Guid);
+    }
 }
 
 }  // namespace radray
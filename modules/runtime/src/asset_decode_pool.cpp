@@ -0,0 +1,206 @@
+#include <radray/runtime/asset_decode_pool.h>
+
+#include <algorithm>
+
+#include <radray/memory.h>
+#include <radray/profiler.h>
+
+namespace radray {
+
+bool AssetDecodeAwaitable::await_ready() const noexcept {
+    return _pool == nullptr || _stop.stop_requested();
+}
+
+bool AssetDecodeAwaitable::await_suspend(std::coroutine_handle<> h) {
+    if (_pool == nullptr || _stop.stop_requested()) {
+        return false;
+    }
+    _record = _pool->Submit(_stop, h, _job);
+    return true;
+}
+
+bool AssetDecodeAwaitable::await_resume() noexcept {
+    if (_record == nullptr) {
+        return false;
+    }
+    const bool completed = _record->Completed && !_record->Canceled && !_record->Stop.stop_requested();
+    // 无论成败都放弃任务: 之后 Pump 不会再碰这条记录, 尚未开始的任务也不必再执行。
+    _job->Abandoned.store(true, std::memory_order_relaxed);
+    _pool->Erase(_record);
+    _record = nullptr;
+    return completed;
+}
+
+AssetDecodePool::AssetDecodePool(const AssetDecodePoolDescriptor& desc)
+    : _maxInFlightBytes(desc.MaxInFlightBytes) {
+    uint32_t workerCount = desc.WorkerCount;
+    if (workerCount == 0) {
+        workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+    _workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        _workers.emplace_back([this]() { this->WorkerMain(); });
+    }
+}
+
+AssetDecodePool::~AssetDecodePool() noexcept {
+    _waiters.CancelAll();
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _stopping = true;
+    }
+    _workAvailable.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+AssetDecodeRecord* AssetDecodePool::Submit(
+    stop_token stop,
+    std::coroutine_handle<> continuation,
+    shared_ptr<AssetDecodeJob> job) {
+    AssetDecodeRecord* record = _waiters.Enqueue(stop, continuation);
+    record->Completed = false;
+    job->Record = record;
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _pending.emplace_back(std::move(job));
+    }
+    _workAvailable.notify_one();
+    return record;
+}
+
+void AssetDecodePool::Erase(AssetDecodeRecord* record) noexcept {
+    _waiters.Erase(record);
+}
+
+uint64_t AssetDecodePool::GetInFlightBytes() const noexcept {
+    std::lock_guard<std::mutex> lock{_mutex};
+    return _inFlightBytes;
+}
+
+bool AssetDecodePool::HasDispatchableJobLocked() const noexcept {
+    if (_pending.empty()) {
+        return false;
+    }
+    const AssetDecodeJob& front = *_pending.front();
+    // 被放弃的任务不占预算, 交给 worker 直接丢掉。
+    if (front.Abandoned.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    return _inFlightCount == 0 || front.Bytes <= _maxInFlightBytes - std::min(_inFlightBytes, _maxInFlightBytes);
+}
+
+AssetDecodePool::ParallelBatch* AssetDecodePool::FindOpenBatchLocked() const noexcept {
+    for (ParallelBatch* batch : _batches) {
+        if (batch->Next.load(std::memory_order_relaxed) < batch->Count) {
+            return batch;
+        }
+    }
+    return nullptr;
+}
+
+void AssetDecodePool::RunParallelBatch(ParallelBatch& batch) {
+    for (uint32_t i = batch.Next.fetch_add(1, std::memory_order_relaxed); i < batch.Count;
+         i = batch.Next.fetch_add(1, std::memory_order_relaxed)) {
+        (*batch.Body)(i);
+    }
+}
+
+void AssetDecodePool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& body) {
+    if (count <= 1 || _workers.empty()) {
+        for (uint32_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+    ParallelBatch batch{.Body = &body, .Count = count};
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _batches.push_back(&batch);
+    }
+    _workAvailable.notify_all();
+    RunParallelBatch(batch);
+    // 下标已领完, 但 helper 可能还在执行最后一个; 等它们退出后批次才能出栈。
+    std::unique_lock<std::mutex> lock{_mutex};
+    _batchIdle.wait(lock, [&batch]() { return batch.Helpers == 0; });
+    _batches.erase(std::find(_batches.begin(), _batches.end(), &batch));
+}
+
+void AssetDecodePool::WorkerMain() noexcept {
+    RADRAY_PROFILE_THREAD_NAME("AssetDecode");
+    std::unique_lock<std::mutex> lock{_mutex};
+    while (true) {
+        _workAvailable.wait(lock, [this]() {
+            return _stopping || FindOpenBatchLocked() != nullptr || HasDispatchableJobLocked();
+        });
+        if (_stopping) {
+            return;
+        }
+        // 批次优先: 它的发起者正占着一个 worker 等结果, 先帮它比开新任务更快腾出线程。
+        if (ParallelBatch* batch = FindOpenBatchLocked(); batch != nullptr) {
+            ++batch->Helpers;
+            lock.unlock();
+            {
+                RADRAY_PROFILE_SCOPE("AssetDecodePool::ParallelFor");
+                MemoryTagScope memoryTag{MemoryTag::AssetLoading};
+                RunParallelBatch(*batch);
+            }
+            lock.lock();
+            if (--batch->Helpers == 0) {
+                _batchIdle.notify_all();
+            }
+            continue;
+        }
+        shared_ptr<AssetDecodeJob> job = std::move(_pending.front());
+        _pending.pop_front();
+        if (job->Abandoned.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        _inFlightBytes += job->Bytes;
+        ++_inFlightCount;
+        lock.unlock();
+        {
+            RADRAY_PROFILE_SCOPE("AssetDecodePool::Execute");
+            MemoryTagScope memoryTag{MemoryTag::AssetLoading};
+            job->Execute();
+        }
+        lock.lock();
+        _completed.emplace_back(std::move(job));
+    }
+}
+
+void AssetDecodePool::Pump() {
+    vector<shared_ptr<AssetDecodeJob>> completed;
+    uint64_t inFlightBytes = 0;
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        completed.swap(_completed);
+        for (const shared_ptr<AssetDecodeJob>& job : completed) {
+            _inFlightBytes -= job->Bytes;
+            --_inFlightCount;
+        }
+        inFlightBytes = _inFlightBytes;
+    }
+    RADRAY_PROFILE_COUNTER("AssetDecodePool::InFlightBytes", inFlightBytes);
+    if (completed.empty()) {
+        return;
+    }
+    // 归还的预算可能让队首任务变得可派发。
+    _workAvailable.notify_all();
+    for (const shared_ptr<AssetDecodeJob>& job : completed) {
+        // 被放弃说明等待者已被取消并摘除了记录, Record 不再有效。
+        if (job->Abandoned.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        AssetDecodeRecord* record = job->Record;
+        if (record->Stop.stop_requested()) {
+            record->Canceled = true;
+        }
+        record->Completed = true;
+        // await_resume 负责摘除记录。
+        _waiters.ResumeRecord(record);
+    }
+}
+
+}  // namespace radray
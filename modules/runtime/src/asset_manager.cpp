@@ -1,6 +1,10 @@
 #include <radray/runtime/asset_manager.h>
 
+#include <algorithm>
+
 #include <radray/logger.h>
+#include <radray/memory.h>
+#include <radray/profiler.h>
 #include <radray/runtime/wait_frame.h>
 
 namespace radray {
@@ -19,10 +23,53 @@ struct AssetSlot {
     bool PendingCanceled{false};
     /// 【普通整数, 非原子】: 引用只在主线程增减 (见 StreamingAssetRefAny 的线程说明)。
     uint32_t RefCount{0};
+    /// 零引用队列的链接。ZeroRefQueued 为真时槽位在队列里 (或正被回收), 不会重复入队。
+    AssetSlot* NextZeroRef{nullptr};
+    bool ZeroRefQueued{false};
+    /// 排队中、尚未启动的加载。有值即表示槽位挂在 Priority 对应的准入队列上。
+    std::optional<task<AssetLoadResult>> QueuedTask;
+    AssetSlot* PrevQueued{nullptr};
+    AssetSlot* NextQueued{nullptr};
+    AssetLoadPriority Priority{AssetLoadPriority::VisibleNow};
+    uint64_t EstimatedBytes{0};
+    std::chrono::steady_clock::time_point QueuedAt{};
+    /// 保活缓存的链接。Cached 为真时 RefCount 为 0, 槽位挂在 LRU 上; 重新被引用即摘下。
+    bool Cached{false};
+    AssetSlot* PrevCached{nullptr};
+    AssetSlot* NextCached{nullptr};
+    AssetMemorySize CachedSize{};
+    /// 等在本槽位上的等待节点, 按登记顺序。只有 Loading 的槽位会有等待者, 进入终态时整条摘下。
+    AssetWaitLink* WaiterHead{nullptr};
+    AssetWaitLink* WaiterTail{nullptr};
 };
 
 using Slot = AssetSlot;
 
+namespace {
+
+constexpr size_t PriorityIndex(AssetLoadPriority priority) noexcept {
+    return static_cast<size_t>(priority);
+}
+
+constexpr std::array<const char*, kAssetLoadPriorityCount> kQueuedLoadsCounterNames{
+    "AssetManager::QueuedLoads::Critical",
+    "AssetManager::QueuedLoads::VisibleNow",
+    "AssetManager::QueuedLoads::Prefetch",
+    "AssetManager::QueuedLoads::Background"};
+
+}  // namespace
+
+std::string_view format_as(AssetLoadPriority priority) noexcept {
+    switch (priority) {
+        case AssetLoadPriority::Critical: return "Critical";
+        case AssetLoadPriority::VisibleNow: return "VisibleNow";
+        case AssetLoadPriority::Prefetch: return "Prefetch";
+        case AssetLoadPriority::Background: return "Background";
+        case AssetLoadPriority::MAX_COUNT: break;
+    }
+    return "Unknown";
+}
+
 bool AssetWaitAwaitable::Suspend(std::coroutine_handle<> continuation, stop_token stop) {
     AssetManager* manager = _ref._manager;
     if (manager == nullptr || _ref._slot == nullptr || _ref.IsCompleted()) {
@@ -34,7 +81,8 @@ bool AssetWaitAwaitable::Suspend(std::coroutine_handle<> continuation, stop_toke
         _canceledBeforeSuspend = true;
         return false;
     }
-    _record = manager->RegisterWait(_ref._slot, stop, continuation);
+    _link.Slot = _ref._slot;
+    _record = manager->RegisterWait(std::span{&_link, 1}, stop, continuation);
     return _record != nullptr;
 }
 
@@ -45,12 +93,64 @@ bool AssetWaitAwaitable::await_resume() noexcept {
     }
     const bool completed = !_record->Canceled && !_record->Stop.stop_requested();
     if (AssetManager* manager = _ref._manager; manager != nullptr) {
-        manager->_waiters.Erase(_record);
+        manager->UnregisterWait(_record);
+    }
+    _record = nullptr;
+    return completed;
+}
+
+bool AssetWaitAllAwaitable::await_ready() const noexcept {
+    return std::all_of(_refs.begin(), _refs.end(), [](const StreamingAssetRefAny& ref) {
+        return !ref.IsValid() || ref.IsCompleted();
+    });
+}
+
+bool AssetWaitAllAwaitable::Suspend(std::coroutine_handle<> continuation, stop_token stop) {
+    size_t pending = 0;
+    for (const StreamingAssetRefAny& ref : _refs) {
+        if (!ref.IsValid() || ref.IsCompleted()) {
+            continue;
+        }
+        if (_manager != nullptr && _manager != ref._manager) {
+            RADRAY_ERR_LOG("WhenAllReady: references belong to different AssetManagers");
+            _canceledBeforeSuspend = true;
+            return false;
+        }
+        _manager = ref._manager;
+        ++pending;
+    }
+    if (pending == 0) {
+        return false;
+    }
+    if (stop.stop_requested()) {
+        _canceledBeforeSuspend = true;
+        return false;
+    }
+    _links.resize(pending);
+    size_t index = 0;
+    for (const StreamingAssetRefAny& ref : _refs) {
+        if (ref.IsValid() && !ref.IsCompleted()) {
+            _links[index++].Slot = ref._slot;
+        }
+    }
+    _record = _manager->RegisterWait(_links, stop, continuation);
+    return _record != nullptr;
+}
+
+bool AssetWaitAllAwaitable::await_resume() noexcept {
+    if (_record == nullptr) {
+        return !_canceledBeforeSuspend;
     }
+    const bool completed = !_record->Canceled && !_record->Stop.stop_requested();
+    _manager->UnregisterWait(_record);
     _record = nullptr;
     return completed;
 }
 
+AssetWaitAllAwaitable WhenAllReady(std::span<const StreamingAssetRefAny> refs) {
+    return AssetWaitAllAwaitable{vector<StreamingAssetRefAny>{refs.begin(), refs.end()}};
+}
+
 // ════════════════════════════════════════════════════════════
 //  StreamingAssetRefAny
 // ════════════════════════════════════════════════════════════
@@ -77,7 +177,7 @@ StreamingAssetRefAny& StreamingAssetRefAny::operator=(const StreamingAssetRefAny
     }
     // 先加后减: other 与 *this 可能指向同一个 slot, 反过来会让计数瞬间归零。
     AssetManager::AddRef(other._slot);
-    AssetManager::Release(_slot);
+    AssetManager::Release(_manager, _slot);
     _manager = other._manager;
     _slot = other._slot;
     return *this;
@@ -87,7 +187,7 @@ StreamingAssetRefAny& StreamingAssetRefAny::operator=(StreamingAssetRefAny&& oth
     if (this == &other) {
         return *this;
     }
-    AssetManager::Release(_slot);
+    AssetManager::Release(_manager, _slot);
     _manager = other._manager;
     _slot = other._slot;
     other._manager = nullptr;
@@ -96,11 +196,11 @@ StreamingAssetRefAny& StreamingAssetRefAny::operator=(StreamingAssetRefAny&& oth
 }
 
 StreamingAssetRefAny::~StreamingAssetRefAny() noexcept {
-    AssetManager::Release(_slot);
+    AssetManager::Release(_manager, _slot);
 }
 
 void StreamingAssetRefAny::Reset() noexcept {
-    AssetManager::Release(_slot);
+    AssetManager::Release(_manager, _slot);
     _manager = nullptr;
     _slot = nullptr;
 }
@@ -159,6 +259,14 @@ RuntimeTypeId StreamingAssetRefAny::GetTypeId() const noexcept {
     return typeInfo != nullptr ? typeInfo->Id : Guid::Empty();
 }
 
+bool AssetLoadGroup::IsCompleted() const noexcept {
+    return std::all_of(_refs.begin(), _refs.end(), [](const StreamingAssetRefAny& ref) { return ref.IsCompleted(); });
+}
+
+bool AssetLoadGroup::IsReady() const noexcept {
+    return std::all_of(_refs.begin(), _refs.end(), [](const StreamingAssetRefAny& ref) { return ref.IsReady(); });
+}
+
 // ════════════════════════════════════════════════════════════
 //  AssetManager
 // ════════════════════════════════════════════════════════════
@@ -166,7 +274,10 @@ RuntimeTypeId StreamingAssetRefAny::GetTypeId() const noexcept {
 AssetManager::AssetManager() noexcept = default;
 
 AssetManager::~AssetManager() noexcept {
-    // 1. 停掉在飞加载并等协程退出。
+    // 1. 丢弃排队中的加载 (它们以 Canceled 提交, 等待者照常被恢复), 停掉在飞加载并等协程退出。
+    //    关掉保活缓存: 之后归零的资产直接销毁, 已在缓存里的由第 3 步统一卸载。
+    _cacheBudget = AssetCacheBudget{};
+    CancelQueuedLoads();
     for (auto& [id, slot] : _slots) {
         if (slot && slot->State == AssetState::Loading) {
             slot->Stop.request_stop();
@@ -175,13 +286,12 @@ AssetManager::~AssetManager() noexcept {
     _loadScope.RequestStop();
     _loadScope.WaitUntilEmpty();
 
-    // 2. 提交残留结果, 再放开 _activeLoads 里那些引用, 然后回收已归零的资产。
+    // 2. 提交残留结果 (同时放开 _completedLoads 里那些引用), 然后回收已归零的资产。
     //
-    //    【顺序不能反】PumpLoadResults 遍历的正是 _activeLoads —— 先 clear 会让"协程已写好
-    //    结果但还没 Pump"的资产随 optional 析构而永不走 OnUnload, GPU 对象活过 device。
+    //    【不能直接 clear _completedLoads】那会让"协程已写好结果但还没 Pump"的资产随
+    //    optional 析构而永不走 OnUnload, GPU 对象活过 device。
     //    【刻意不调 Pump】它会 spawn 一个立刻被取消的协程去等帧边界; 这里直接同步走完。
     PumpLoadResults();
-    _activeLoads.clear();
     CollectZeroRefSlots();
 
     // 3. 无条件对残留槽位走一遍 OnUnload + 析构, 即便仍被引用。
@@ -201,7 +311,28 @@ AssetManager::~AssetManager() noexcept {
             slot->Object.reset();
         }
     }
+    // 第 1 步之后槽位都已到终态, 等待链理应为空; 仍有节点时摘下, 让 _waiters 析构时的
+    // UnregisterWait 不再碰已销毁的槽位。
+    for (auto& [id, slot] : _slots) {
+        if (slot == nullptr) {
+            continue;
+        }
+        for (AssetWaitLink* link = slot->WaiterHead; link != nullptr;) {
+            AssetWaitLink* next = link->Next;
+            link->Slot = nullptr;
+            link->Prev = nullptr;
+            link->Next = nullptr;
+            link = next;
+        }
+        slot->WaiterHead = nullptr;
+        slot->WaiterTail = nullptr;
+    }
     _slots.clear();
+    // 上面的 OnUnload / 析构放开引用时可能把槽位排进零引用队列, 它们此刻都已销毁。
+    _zeroRefHead = nullptr;
+    _zeroRefTail = nullptr;
+    _cacheHead = nullptr;
+    _cacheTail = nullptr;
 
     // 4. 刚才 OnUnload 交出的 payload 已无从等待帧边界 (_loadScope 已停)。就地销毁。
     //    【为何安全】: 关停路径在此之前已经 device wait-idle 过 (Application::Shutdown 先
@@ -224,6 +355,10 @@ Slot* AssetManager::EmplaceLoadingSlot(const AssetId& id) {
 }
 
 StreamingAssetRefAny AssetManager::MakeRef(Slot* slot) noexcept {
+    // 缓存里的槽位没有引用, 故新引用只能从这里来; 在此摘下即是复活。
+    if (slot->Cached) {
+        UnlinkCached(slot);
+    }
     return StreamingAssetRefAny{this, slot};
 }
 
@@ -233,34 +368,70 @@ void AssetManager::AddRef(Slot* slot) noexcept {
     }
 }
 
-void AssetManager::Release(Slot* slot) noexcept {
-    if (slot != nullptr) {
-        --slot->RefCount;
+void AssetManager::Release(AssetManager* manager, Slot* slot) noexcept {
+    if (slot == nullptr) {
+        return;
     }
     // 归零【不】在此销毁。析构路径是 noexcept 且可能正处在资产表的遍历中,
     // 就地销毁会递归跑资产析构并使迭代器失效 —— 理由详见头文件 AssetManager 的说明。
-    // 实际销毁由 Pump -> CollectZeroRefSlots 完成。
+    // 这里只把槽位排进零引用队列, 实际销毁由 Pump -> CollectZeroRefSlots 完成。
+    if (--slot->RefCount == 0 && manager != nullptr) {
+        manager->EnqueueZeroRef(slot);
+    }
+}
+
+void AssetManager::EnqueueZeroRef(Slot* slot) noexcept {
+    if (slot->ZeroRefQueued) {
+        return;
+    }
+    slot->ZeroRefQueued = true;
+    slot->NextZeroRef = nullptr;
+    if (_zeroRefTail != nullptr) {
+        _zeroRefTail->NextZeroRef = slot;
+    } else {
+        _zeroRefHead = slot;
+    }
+    _zeroRefTail = slot;
 }
 
 StreamingAssetRefAny AssetManager::Load(AssetLoadRequest request) {
     if (Slot* existing = FindSlot(request.Id); existing != nullptr) {
-        return MakeRef(existing);
+        if (existing->Cached) {
+            ++_cacheStats.HitCount;
+        }
+        StreamingAssetRefAny ref = MakeRef(existing);
+        if (request.Priority < existing->Priority) {
+            SetPriority(ref, request.Priority);
+        }
+        return ref;
     }
 
+    ++_cacheStats.MissCount;
     Slot* slot = EmplaceLoadingSlot(request.Id);
+    slot->Priority = request.Priority;
+    slot->EstimatedBytes = request.EstimatedBytes;
+    slot->QueuedAt = std::chrono::steady_clock::now();
     StreamingAssetRefAny ref = MakeRef(slot);
-    // 【manager 自持一份引用直到加载跑完】: 外部引用可能在加载途中全部消失, 但我们不
-    // request_stop —— 加载多半已花掉大半代价 (IO 已完成、GPU 上传已提交), 半途取消既救不回
-    // 那部分开销, 又要在每个 loader 里写"取消后如何回退"。让它跑完, 之后按常规归零回收。
-    _activeLoads.push_back(ref);
-    _loadScope.Spawn(RunLoad(ref, std::move(request.Task)));
-
+    if (CanAdmit(request.Priority, request.EstimatedBytes)) {
+        RecordAdmission(slot);
+        StartLoad(slot, std::move(request.Task));
+    } else {
+        slot->QueuedTask.emplace(std::move(request.Task));
+        LinkQueued(slot);
+    }
     return ref;
 }
 
-StreamingAssetRefAny AssetManager::Load(const AssetId& id) {
+StreamingAssetRefAny AssetManager::Load(const AssetId& id, AssetLoadPriority priority) {
     if (Slot* existing = FindSlot(id); existing != nullptr) {
-        return MakeRef(existing);
+        if (existing->Cached) {
+            ++_cacheStats.HitCount;
+        }
+        StreamingAssetRefAny ref = MakeRef(existing);
+        if (priority < existing->Priority) {
+            SetPriority(ref, priority);
+        }
+        return ref;
     }
     if (!_assetSource.HasValue()) {
         RADRAY_ERR_LOG("AssetManager: no asset source is installed for asset {}", id);
@@ -275,10 +446,12 @@ StreamingAssetRefAny AssetManager::Load(const AssetId& id) {
     return Load(AssetLoadRequest{
         .Id = id,
         .Task = std::move(loadTask.value()),
-        .DebugName = id.ToString()});
+        .DebugName = id.ToString(),
+        .Priority = priority,
+        .EstimatedBytes = _assetSource->EstimateLoadBytes(id)});
 }
 
-StreamingAssetRefAny AssetManager::LoadSourcePath(std::string_view relPath) {
+StreamingAssetRefAny AssetManager::LoadSourcePath(std::string_view relPath, AssetLoadPriority priority) {
     if (!_assetSource.HasValue()) {
         RADRAY_ERR_LOG("AssetManager: no asset source is installed for path '{}'", relPath);
         return {};
@@ -288,7 +461,203 @@ StreamingAssetRefAny AssetManager::LoadSourcePath(std::string_view relPath) {
         RADRAY_ERR_LOG("AssetManager: asset source cannot resolve path '{}'", relPath);
         return {};
     }
-    return Load(id.value());
+    return Load(id.value(), priority);
+}
+
+bool AssetManager::CanAdmit(AssetLoadPriority priority, uint64_t bytes) const noexcept {
+    // 同级或更高优先级还有人排队时不插队, 保持同一优先级内的提交顺序。
+    for (size_t i = 0; i <= PriorityIndex(priority); ++i) {
+        if (_queueHeads[i] != nullptr) {
+            return false;
+        }
+    }
+    if (priority == AssetLoadPriority::Critical || _runningLoads == 0) {
+        return true;
+    }
+    if (_runningLoads >= _loadBudget.MaxConcurrentLoads) {
+        return false;
+    }
+    return bytes <= _loadBudget.MaxInFlightBytes - std::min(_inFlightLoadBytes, _loadBudget.MaxInFlightBytes);
+}
+
+void AssetManager::StartLoad(Slot* slot, task<AssetLoadResult> loadTask) {
+    ++_runningLoads;
+    _inFlightLoadBytes += slot->EstimatedBytes;
+    // 【加载自持一份引用直到结果被提交】(RunLoad 的参数, 结束时移进 _completedLoads):
+    // 外部引用可能在加载途中全部消失, 但我们不 request_stop —— 加载多半已花掉大半代价
+    // (IO 已完成、GPU 上传已提交), 半途取消既救不回那部分开销, 又要在每个 loader 里写
+    // "取消后如何回退"。让它跑完, 之后按常规归零回收。
+    // 还在排队的加载则相反: 一分代价都没花, 引用归零时直接丢弃 (见 CollectZeroRefSlots)。
+    _loadScope.Spawn(RunLoad(MakeRef(slot), std::move(loadTask)));
+}
+
+void AssetManager::AdmitQueuedLoads() {
+    // 严格按优先级: 最高优先级的队首放不下时, 低优先级的也不准入, 免得小的低优先级加载
+    // 持续占满预算把它饿死。
+    for (size_t i = 0; i < kAssetLoadPriorityCount; ++i) {
+        while (Slot* slot = _queueHeads[i]) {
+            const bool critical = slot->Priority == AssetLoadPriority::Critical;
+            const bool fits = _runningLoads == 0 ||
+                              (_runningLoads < _loadBudget.MaxConcurrentLoads &&
+                               slot->EstimatedBytes <= _loadBudget.MaxInFlightBytes - std::min(_inFlightLoadBytes, _loadBudget.MaxInFlightBytes));
+            if (!critical && !fits) {
+                return;
+            }
+            UnlinkQueued(slot);
+            task<AssetLoadResult> loadTask = std::move(slot->QueuedTask.value());
+            slot->QueuedTask.reset();
+            RecordAdmission(slot);
+            StartLoad(slot, std::move(loadTask));
+        }
+    }
+}
+
+void AssetManager::RecordAdmission(const Slot* slot) noexcept {
+    AssetLoadPriorityStats& stats = _priorityStats[PriorityIndex(slot->Priority)];
+    const auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - slot->QueuedAt);
+    ++stats.AdmittedCount;
+    stats.TotalWait += wait;
+    stats.MaxWait = std::max(stats.MaxWait, wait);
+}
+
+void AssetManager::LinkQueued(Slot* slot) noexcept {
+    const size_t index = PriorityIndex(slot->Priority);
+    slot->PrevQueued = _queueTails[index];
+    slot->NextQueued = nullptr;
+    if (_queueTails[index] != nullptr) {
+        _queueTails[index]->NextQueued = slot;
+    } else {
+        _queueHeads[index] = slot;
+    }
+    _queueTails[index] = slot;
+    ++_priorityStats[index].QueuedCount;
+}
+
+void AssetManager::UnlinkQueued(Slot* slot) noexcept {
+    const size_t index = PriorityIndex(slot->Priority);
+    if (slot->PrevQueued != nullptr) {
+        slot->PrevQueued->NextQueued = slot->NextQueued;
+    } else {
+        _queueHeads[index] = slot->NextQueued;
+    }
+    if (slot->NextQueued != nullptr) {
+        slot->NextQueued->PrevQueued = slot->PrevQueued;
+    } else {
+        _queueTails[index] = slot->PrevQueued;
+    }
+    slot->PrevQueued = nullptr;
+    slot->NextQueued = nullptr;
+    --_priorityStats[index].QueuedCount;
+}
+
+void AssetManager::DropQueuedLoad(Slot* slot) noexcept {
+    UnlinkQueued(slot);
+    // 未启动的 task 只是一个挂起在初始点的协程帧, 销毁它不会运行 loader 的任何代码。
+    slot->QueuedTask.reset();
+    ++_priorityStats[PriorityIndex(slot->Priority)].DroppedBeforeStartCount;
+}
+
+void AssetManager::CancelQueuedLoads() {
+    for (size_t i = 0; i < kAssetLoadPriorityCount; ++i) {
+        while (Slot* slot = _queueHeads[i]) {
+            DropQueuedLoad(slot);
+            StoreLoadCanceled(slot);
+            _completedLoads.emplace_back(MakeRef(slot));
+        }
+    }
+}
+
+void AssetManager::SetPriority(const StreamingAssetRefAny& ref, AssetLoadPriority priority) noexcept {
+    Slot* slot = ref._slot;
+    if (slot == nullptr || slot->Priority == priority) {
+        return;
+    }
+    if (!slot->QueuedTask.has_value()) {
+        slot->Priority = priority;
+        return;
+    }
+    UnlinkQueued(slot);
+    slot->Priority = priority;
+    LinkQueued(slot);
+}
+
+bool AssetManager::TryCacheSlot(Slot* slot) {
+    if (_cacheBudget.MaxCpuBytes == 0 && _cacheBudget.MaxGpuBytes == 0) {
+        return false;
+    }
+    const AssetMemorySize size = slot->Object->GetMemorySize();
+    if (size.CpuBytes > _cacheBudget.MaxCpuBytes || size.GpuBytes > _cacheBudget.MaxGpuBytes) {
+        return false;
+    }
+    // 离开零引用队列: 复活后再次归零要能重新入队。
+    slot->ZeroRefQueued = false;
+    slot->Cached = true;
+    slot->CachedSize = size;
+    slot->PrevCached = _cacheTail;
+    slot->NextCached = nullptr;
+    if (_cacheTail != nullptr) {
+        _cacheTail->NextCached = slot;
+    } else {
+        _cacheHead = slot;
+    }
+    _cacheTail = slot;
+    ++_cacheStats.CachedCount;
+    _cacheStats.CachedBytes.CpuBytes += size.CpuBytes;
+    _cacheStats.CachedBytes.GpuBytes += size.GpuBytes;
+    EvictCachedSlots();
+    return true;
+}
+
+void AssetManager::UnlinkCached(Slot* slot) noexcept {
+    if (slot->PrevCached != nullptr) {
+        slot->PrevCached->NextCached = slot->NextCached;
+    } else {
+        _cacheHead = slot->NextCached;
+    }
+    if (slot->NextCached != nullptr) {
+        slot->NextCached->PrevCached = slot->PrevCached;
+    } else {
+        _cacheTail = slot->PrevCached;
+    }
+    slot->PrevCached = nullptr;
+    slot->NextCached = nullptr;
+    slot->Cached = false;
+    --_cacheStats.CachedCount;
+    _cacheStats.CachedBytes.CpuBytes -= slot->CachedSize.CpuBytes;
+    _cacheStats.CachedBytes.GpuBytes -= slot->CachedSize.GpuBytes;
+}
+
+void AssetManager::EvictCachedSlots() {
+    while (_cacheHead != nullptr &&
+           (_cacheStats.CachedBytes.CpuBytes > _cacheBudget.MaxCpuBytes ||
+            _cacheStats.CachedBytes.GpuBytes > _cacheBudget.MaxGpuBytes)) {
+        Slot* slot = _cacheHead;
+        UnlinkCached(slot);
+        ++_cacheStats.EvictedCount;
+        _cacheStats.EvictedBytes.CpuBytes += slot->CachedSize.CpuBytes;
+        _cacheStats.EvictedBytes.GpuBytes += slot->CachedSize.GpuBytes;
+        // 与 CollectZeroRefSlots 同理: OnUnload / 析构期间的临时引用放开时不得再入队。
+        slot->ZeroRefQueued = true;
+        slot->Object->OnUnload(*this);
+        DestroySlot(slot);
+    }
+}
+
+void AssetManager::SetCacheBudget(const AssetCacheBudget& budget) {
+    _cacheBudget = budget;
+    // 挤出的资产放开的引用排进零引用队列, 由下一次 Pump 回收。
+    EvictCachedSlots();
+}
+
+AssetCacheStats AssetManager::GetCacheStats() const noexcept {
+    return _cacheStats;
+}
+
+AssetLoadStats AssetManager::GetLoadStats() const noexcept {
+    return AssetLoadStats{
+        .Priorities = _priorityStats,
+        .RunningLoads = _runningLoads,
+        .InFlightBytes = _inFlightLoadBytes};
 }
 
 task<void> AssetManager::Wait(StreamingAssetRefAny ref) {
@@ -298,6 +667,44 @@ task<void> AssetManager::Wait(StreamingAssetRefAny ref) {
     }
 }
 
+task<void> AssetManager::Wait(AssetLoadGroup group) {
+    const bool completed = co_await WhenAllReady(group.GetRefs());
+    if (!completed) {
+        co_await StopCurrentTask();
+    }
+}
+
+AssetLoadGroup AssetManager::Prefetch(std::span<const AssetId> roots, AssetLoadPriority priority) {
+    AssetLoadGroup group;
+    if (!_assetSource.HasValue()) {
+        RADRAY_ERR_LOG("AssetManager: no asset source is installed for prefetch");
+        return group;
+    }
+    // 广度优先展开, 再逆序发起: 依赖先于依赖它的资产排队。
+    vector<AssetId> order;
+    unordered_set<AssetId> visited;
+    for (const AssetId& root : roots) {
+        if (visited.insert(root).second) {
+            order.push_back(root);
+        }
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (const AssetId& dependency : _assetSource->GetDependencies(order[i])) {
+            if (visited.insert(dependency).second) {
+                order.push_back(dependency);
+            }
+        }
+    }
+    group._refs.reserve(order.size());
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        StreamingAssetRefAny ref = Load(*it, priority);
+        if (ref.IsValid()) {
+            group._refs.push_back(std::move(ref));
+        }
+    }
+    return group;
+}
+
 StreamingAssetRefAny AssetManager::AddReady(
     const AssetId& id,
     unique_ptr<Asset> object,
@@ -322,12 +729,17 @@ task<void> AssetManager::RunLoad(StreamingAssetRefAny ref, task<AssetLoadResult>
     // 这类预期结果 (那条路由 AssetLoadResult::Failure 表达), 而是分配失败或不变量被破坏,
     // 把它转成 Faulted 只会掩盖首因。见 AGENTS.md 的异常策略。
     stop_token stop = slot->Stop.get_token();
-    std::optional<AssetLoadResult> result = co_await AwaitWithStopToken(std::move(loadTask), stop);
+    std::optional<AssetLoadResult> result = co_await WithStopToken(std::move(loadTask), stop);
     if (!result.has_value()) {
         StoreLoadCanceled(slot);
-        co_return;
+    } else {
+        StoreLoadResult(slot, std::move(result.value()));
     }
-    StoreLoadResult(slot, std::move(result.value()));
+    // 结果已写好, 归还预算; 新的准入留给下一次 Pump。
+    --_runningLoads;
+    _inFlightLoadBytes -= slot->EstimatedBytes;
+    // 把本协程持有的引用交给 _completedLoads, 槽位活到 Pump 提交结果。
+    _completedLoads.emplace_back(std::move(ref));
 }
 
 void AssetManager::StoreLoadResult(Slot* slot, AssetLoadResult result) noexcept {
@@ -348,9 +760,18 @@ StreamingAssetRefAny AssetManager::Find(const AssetId& id) noexcept {
 
 void AssetManager::Cancel(const StreamingAssetRefAny& ref) noexcept {
     Slot* slot = ref._slot;
-    if (slot != nullptr && slot->State == AssetState::Loading) {
-        slot->Stop.request_stop();
+    if (slot == nullptr || slot->State != AssetState::Loading) {
+        return;
     }
+    if (slot->QueuedTask.has_value()) {
+        // 还没启动: 不必等挂起点, 直接丢弃。经 _completedLoads 在 Pump 里提交, 与在飞取消一样
+        // 不在调用方的栈上恢复等待者。
+        DropQueuedLoad(slot);
+        StoreLoadCanceled(slot);
+        _completedLoads.emplace_back(MakeRef(slot));
+        return;
+    }
+    slot->Stop.request_stop();
 }
 
 void AssetManager::CommitLoadResult(Slot* slot, AssetLoadResult result) noexcept {
@@ -368,6 +789,17 @@ void AssetManager::CommitLoadResult(Slot* slot, AssetLoadResult result) noexcept
         slot->State = AssetState::Faulted;
         return;
     }
+    if (_assetSource.HasValue()) {
+        for (const std::filesystem::path& file : result.ReferencedFiles) {
+            if (std::optional<AssetId> dependency = _assetSource->ResolveSourceFile(file); dependency.has_value()) {
+                result.Dependencies.push_back(dependency.value());
+            }
+        }
+    }
+    // 只在报告了依赖时覆盖: 大多数 loader 不发现依赖, 空表不应抹掉 importer 声明的那份。
+    if (!result.Dependencies.empty() && _assetSource.HasValue()) {
+        _assetSource->RecordDependencies(slot->Id, result.Dependencies);
+    }
     object->_id = slot->Id;
     slot->Object = std::move(object);
     slot->TypeInfo = typeInfo;
@@ -375,35 +807,69 @@ void AssetManager::CommitLoadResult(Slot* slot, AssetLoadResult result) noexcept
 }
 
 void AssetManager::ResumeWaiters(Slot* slot) noexcept {
-    // 先收集再恢复: 恢复会让等待者从 _waiters 里摘掉自己的记录, 边遍历边恢复会失效。
-    vector<AssetWaitRecord*> targets;
-    const size_t count = _waiters.Count();
-    for (size_t i = 0; i < count; ++i) {
-        AssetWaitRecord* waiter = _waiters.At(i);
-        if (waiter != nullptr && waiter->Slot == slot) {
-            targets.push_back(waiter);
-        }
-    }
-    for (AssetWaitRecord* waiter : targets) {
-        if (_waiters.IsAlive(waiter)) {
+    // 逐个从链头摘下再恢复, 不先拷出整条链: 恢复会跑等待者的代码, 它可能注销链上别的节点
+    // (连同它所在的协程帧一起销毁), 留在链上的节点才能被 UnregisterWait 正确摘掉。
+    // 槽位已进入终态, RegisterWait 不会再往这条链上追加节点, 所以循环只处理调用时已挂着的等待。
+    // 链上的节点都属于尚未注销的记录, 恢复前不必再查 IsAlive。
+    while (AssetWaitLink* link = slot->WaiterHead) {
+        slot->WaiterHead = link->Next;
+        (link->Next != nullptr ? link->Next->Prev : slot->WaiterTail) = nullptr;
+        link->Slot = nullptr;
+        link->Prev = nullptr;
+        link->Next = nullptr;
+        AssetWaitRecord* waiter = link->Record;
+        if (--waiter->Remaining == 0) {
             _waiters.ResumeRecord(waiter);
         }
     }
 }
 
 AssetWaitRecord* AssetManager::RegisterWait(
-    Slot* slot,
+    std::span<AssetWaitLink> links,
     stop_token stop,
     std::coroutine_handle<> continuation) {
-    if (slot == nullptr || slot->State != AssetState::Loading) {
+    if (links.empty()) {
         return nullptr;
     }
+    for (const AssetWaitLink& link : links) {
+        if (link.Slot == nullptr || link.Slot->State != AssetState::Loading) {
+            return nullptr;
+        }
+    }
     AssetWaitRecord* record = _waiters.Enqueue(stop, continuation);
-    record->Slot = slot;
+    record->Links = links;
+    record->Remaining = static_cast<uint32_t>(links.size());
+    for (AssetWaitLink& link : links) {
+        Slot* slot = link.Slot;
+        link.Record = record;
+        link.Prev = slot->WaiterTail;
+        link.Next = nullptr;
+        (slot->WaiterTail != nullptr ? slot->WaiterTail->Next : slot->WaiterHead) = &link;
+        slot->WaiterTail = &link;
+    }
     return record;
 }
 
+void AssetManager::UnregisterWait(AssetWaitRecord* record) noexcept {
+    for (AssetWaitLink& link : record->Links) {
+        Slot* slot = link.Slot;
+        if (slot == nullptr) {
+            continue;
+        }
+        (link.Prev != nullptr ? link.Prev->Next : slot->WaiterHead) = link.Next;
+        (link.Next != nullptr ? link.Next->Prev : slot->WaiterTail) = link.Prev;
+        link.Slot = nullptr;
+        link.Prev = nullptr;
+        link.Next = nullptr;
+    }
+    _waiters.Erase(record);
+}
+
 void AssetManager::DestroySlot(Slot* slot) noexcept {
+    // 排队中的槽位没有自持引用, 归零即在此被丢弃, 先从准入队列摘下。
+    if (slot->QueuedTask.has_value()) {
+        DropQueuedLoad(slot);
+    }
     // Object 先析构再摘表: 资产析构可能查询 manager (例如放开它自己持有的引用),
     // 此时表里还留着自己的槽位是无害的, 而反过来则会让 unique_ptr 析构发生在
     // erase 内部、此时 slot 指针已不可用。
@@ -417,29 +883,29 @@ void AssetManager::CollectZeroRefSlots() {
     }
     _collecting = true;
 
-    // 循环到不动点: 销毁一个资产会放开它持有的 StreamingAssetRef, 从而可能令别的
-    // 槽位归零。每轮重新扫表, 因为上一轮的销毁已经改过 _slots。
-    for (;;) {
-        vector<Slot*> zeroRef;
-        for (auto& [id, slot] : _slots) {
-            if (slot && slot->RefCount == 0) {
-                zeroRef.push_back(slot.get());
-            }
+    // 只看零引用队列。销毁一个资产会放开它持有的 StreamingAssetRef, 令别的槽位归零并排到
+    // 队尾, 于是同一个循环一路处理到级联结束, 不需要重扫整张表。
+    while (_zeroRefHead != nullptr) {
+        Slot* slot = _zeroRefHead;
+        _zeroRefHead = slot->NextZeroRef;
+        if (_zeroRefHead == nullptr) {
+            _zeroRefTail = nullptr;
         }
-        if (zeroRef.empty()) {
-            break;
+        slot->NextZeroRef = nullptr;
+        // 入队之后又被引用 (例如 Find): 出队, 下次归零时再入队。
+        if (slot->RefCount > 0) {
+            slot->ZeroRefQueued = false;
+            continue;
         }
-        for (Slot* slot : zeroRef) {
-            // 上一轮的销毁不会令这里的指针失效 (只有本循环销毁槽位, 且每个只销毁一次),
-            // 但资产析构可能新建引用又放开, 故仍要复查 RefCount。
-            if (slot->RefCount > 0) {
-                continue;
-            }
-            if (slot->State == AssetState::Ready && slot->Object) {
-                slot->Object->OnUnload(*this);
-            }
-            DestroySlot(slot);
+        if (slot->State == AssetState::Ready && slot->Object && TryCacheSlot(slot)) {
+            continue;
         }
+        // ZeroRefQueued 保持为真: OnUnload / 析构期间本槽位若被临时引用再放开,
+        // 不能再次入队 —— 它马上就要被销毁, 队列里不能留下悬垂指针。
+        if (slot->State == AssetState::Ready && slot->Object) {
+            slot->Object->OnUnload(*this);
+        }
+        DestroySlot(slot);
     }
 
     _collecting = false;
@@ -470,28 +936,28 @@ task<void> AssetManager::RunDeferredDestroy(vector<unique_ptr<DeferredPayload>>
 }
 
 void AssetManager::PumpLoadResults() {
-    for (size_t i = 0; i < _activeLoads.size();) {
-        Slot* slot = _activeLoads[i]._slot;
-        if (slot == nullptr) {
-            _activeLoads.erase(_activeLoads.begin() + static_cast<ptrdiff_t>(i));
-            continue;
-        }
-        if (!slot->PendingCanceled && !slot->PendingResult.has_value()) {
-            ++i;
-            continue;
-        }
+    // 整表换出再处理: 恢复等待者会跑调用方的代码, 它可能发起新的加载并同步完成, 追加到
+    // _completedLoads。那些留给外层循环的下一轮, 与先前"同一次 Pump 内提交"的行为一致。
+    while (!_completedLoads.empty()) {
+        vector<StreamingAssetRefAny> completed = std::move(_completedLoads);
+        _completedLoads.clear();
+        for (StreamingAssetRefAny& ref : completed) {
+            Slot* slot = ref._slot;
+            if (slot == nullptr) {
+                continue;
+            }
+            if (slot->PendingCanceled) {
+                slot->State = AssetState::Canceled;
+                slot->PendingCanceled = false;
+            } else if (slot->PendingResult.has_value()) {
+                CommitLoadResult(slot, std::move(slot->PendingResult.value()));
+                slot->PendingResult.reset();
+            }
+            ResumeWaiters(slot);
 
-        if (slot->PendingCanceled) {
-            slot->State = AssetState::Canceled;
-            slot->PendingCanceled = false;
-        } else {
-            CommitLoadResult(slot, std::move(slot->PendingResult.value()));
-            slot->PendingResult.reset();
+            // 放开加载持有的那份引用。可能就此归零, 排进零引用队列由 CollectZeroRefSlots 处理。
+            ref.Reset();
         }
-        ResumeWaiters(slot);
-
-        // 放开 manager 自持的那份引用。可能就此归零, 由 CollectZeroRefSlots 处理。
-        _activeLoads.erase(_activeLoads.begin() + static_cast<ptrdiff_t>(i));
     }
 }
 
@@ -506,9 +972,21 @@ void AssetManager::FlushDeferredBatch() {
 }
 
 void AssetManager::Pump() {
+    RADRAY_PROFILE_SCOPE("AssetManager::Pump");
+    MemoryTagScope memoryTag{MemoryTag::AssetLoading};
     PumpLoadResults();
+    // 先回收再准入: 引用已全部放开的排队加载在这里被丢弃, 不会被启动。
     CollectZeroRefSlots();
+    AdmitQueuedLoads();
     FlushDeferredBatch();
+    RADRAY_PROFILE_COUNTER("AssetManager::Slots", _slots.size());
+    RADRAY_PROFILE_COUNTER("AssetManager::RunningLoads", _runningLoads);
+    RADRAY_PROFILE_COUNTER("AssetManager::InFlightLoadBytes", _inFlightLoadBytes);
+    RADRAY_PROFILE_COUNTER("AssetManager::CachedCpuBytes", _cacheStats.CachedBytes.CpuBytes);
+    RADRAY_PROFILE_COUNTER("AssetManager::CachedGpuBytes", _cacheStats.CachedBytes.GpuBytes);
+    for (size_t i = 0; i < kAssetLoadPriorityCount; ++i) {
+        RADRAY_PROFILE_COUNTER(kQueuedLoadsCounterNames[i], _priorityStats[i].QueuedCount);
+    }
 }
 
 uint32_t AssetManager::GetAssetCount() const noexcept {
@@ -0,0 +1,389 @@
+#include <radray/runtime/derived_data_cache.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <system_error>
+
+#include <fmt/format.h>
+
+#include <radray/binary_io.h>
+#include <radray/file.h>
+#include <radray/hash.h>
+#include <radray/json.h>
+#include <radray/logger.h>
+#include <radray/profiler.h>
+#include <radray/runtime/asset_database.h>
+
+namespace radray {
+namespace {
+
+constexpr std::string_view kEntryExtension = ".ddc";
+constexpr uint32_t kEntryMagic = 0x43444452;  // "RDDC"
+constexpr uint32_t kEntryVersion = 1;
+/// 文件末尾固定的 8 字节: footer 字节数 + magic。
+constexpr size_t kEntryTrailerSize = 8;
+
+/// 同一进程内临时文件名的唯一后缀; 两个 worker 可能同时写同一个键。
+std::atomic<uint64_t> g_temporaryCounter{0};
+
+uint64_t HashKey(const DerivedDataKey& key) noexcept {
+    BinaryWriter writer{key.ImporterType.size() + 24};
+    writer.String(key.ImporterType);
+    writer.U32(key.ImporterVersion);
+    writer.U64(key.SourceHash);
+    writer.U64(key.SettingsHash);
+    const std::span<const byte> data = writer.GetData();
+    return HashData64(data.data(), data.size());
+}
+
+/// 条目文件 = payload | footer | footerSize(u32) | magic(u32)。
+/// payload 在最前, 命中时读进来的缓冲截掉尾部即是产物, 不必搬动。
+vector<byte> EncodeFooter(const DerivedDataKey& key, std::span<const byte> payload, double cookMilliseconds) {
+    BinaryWriter writer{key.ImporterType.size() + 64};
+    writer.U32(kEntryVersion);
+    writer.String(key.ImporterType);
+    writer.U32(key.ImporterVersion);
+    writer.U64(key.SourceHash);
+    writer.U64(key.SettingsHash);
+    writer.U64(payload.size());
+    writer.U64(HashData64(payload.data(), payload.size()));
+    writer.Float(static_cast<float>(cookMilliseconds));
+    const auto footerSize = static_cast<uint32_t>(writer.GetSize());
+    writer.U32(footerSize);
+    writer.U32(kEntryMagic);
+    return std::move(writer).TakeData();
+}
+
+struct DecodedEntry {
+    size_t PayloadSize{0};
+    float CookMilliseconds{0.0f};
+};
+
+std::optional<DecodedEntry> DecodeEntry(const DerivedDataKey& key, std::span<const byte> file) noexcept {
+    if (file.size() < kEntryTrailerSize) {
+        return std::nullopt;
+    }
+    BinaryReader trailer{file.subspan(file.size() - kEntryTrailerSize)};
+    uint32_t footerSize = 0;
+    uint32_t magic = 0;
+    if (!trailer.U32(footerSize) || !trailer.U32(magic) || magic != kEntryMagic ||
+        footerSize > file.size() - kEntryTrailerSize) {
+        return std::nullopt;
+    }
+    const size_t footerOffset = file.size() - kEntryTrailerSize - footerSize;
+    BinaryReader footer{file.subspan(footerOffset, footerSize)};
+    uint32_t version = 0;
+    std::string_view importerType;
+    uint32_t importerVersion = 0;
+    uint64_t sourceHash = 0;
+    uint64_t settingsHash = 0;
+    uint64_t payloadSize = 0;
+    uint64_t payloadHash = 0;
+    DecodedEntry decoded{};
+    if (!footer.U32(version) || version != kEntryVersion ||
+        !footer.String(importerType) ||
+        !footer.U32(importerVersion) ||
+        !footer.U64(sourceHash) ||
+        !footer.U64(settingsHash) ||
+        !footer.U64(payloadSize) ||
+        !footer.U64(payloadHash) ||
+        !footer.Float(decoded.CookMilliseconds) ||
+        !footer.AtEnd()) {
+        return std::nullopt;
+    }
+    // 文件名只是键的 64 位哈希, 完整键在这里逐项确认。
+    if (importerType != key.ImporterType || importerVersion != key.ImporterVersion ||
+        sourceHash != key.SourceHash || settingsHash != key.SettingsHash) {
+        return std::nullopt;
+    }
+    if (payloadSize != footerOffset || HashData64(file.data(), footerOffset) != payloadHash) {
+        return std::nullopt;
+    }
+    decoded.PayloadSize = footerOffset;
+    return decoded;
+}
+
+bool WriteEntryFile(const std::filesystem::path& path, std::span<const byte> payload, std::span<const byte> footer) {
+    std::filesystem::path temporaryPath = path;
+    temporaryPath += fmt::format(".{}.tmp", g_temporaryCounter.fetch_add(1, std::memory_order_relaxed));
+    {
+        std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+        if (!file) {
+            return false;
+        }
+        if (!payload.empty()) {
+            file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        }
+        file.write(reinterpret_cast<const char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+        file.flush();
+        if (!file) {
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::error_code cleanupError;
+        std::filesystem::remove(temporaryPath, cleanupError);
+        return false;
+    }
+    return true;
+}
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) noexcept {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+uint64_t HashImportSettings(const AssetImportSettings* settings) noexcept {
+    if (settings == nullptr) {
+        return 0;
+    }
+    JsonWriter writer;
+    if (!writer.IsValid()) {
+        return 0;
+    }
+    JsonWriteContext context{writer};
+    if (!settings->Serialize(context)) {
+        return 0;
+    }
+    const std::optional<string> text = writer.Write(false);
+    return text.has_value() ? HashData64(text->data(), text->size()) : 0;
+}
+
+DerivedDataCache::DerivedDataCache(const DerivedDataCacheDescriptor& desc)
+    : _directory(desc.Directory),
+      _maxBytes(desc.MaxBytes) {
+    std::error_code error;
+    std::filesystem::create_directories(_directory, error);
+    if (error) {
+        RADRAY_WARN_LOG("DerivedDataCache: cannot create '{}': {}", _directory.string(), error.message());
+        return;
+    }
+    // 按 mtime 从旧到新编号, 作为上次运行留下的 LRU 顺序。
+    struct ScannedEntry {
+        string FileName;
+        uint64_t Bytes;
+        std::filesystem::file_time_type WriteTime;
+    };
+    vector<ScannedEntry> scanned;
+    for (std::filesystem::directory_iterator it{_directory, error}, end; !error && it != end; it.increment(error)) {
+        const std::filesystem::path& path = it->path();
+        std::error_code entryError;
+        if (!it->is_regular_file(entryError)) {
+            continue;
+        }
+        if (path.extension() != kEntryExtension) {
+            // 上次异常退出留下的临时文件。
+            if (path.extension() == ".tmp") {
+                std::filesystem::remove(path, entryError);
+            }
+            continue;
+        }
+        const uintmax_t bytes = it->file_size(entryError);
+        const std::filesystem::file_time_type writeTime = it->last_write_time(entryError);
+        if (!entryError) {
+            scanned.push_back(ScannedEntry{path.filename().string(), static_cast<uint64_t>(bytes), writeTime});
+        }
+    }
+    if (error) {
+        RADRAY_WARN_LOG("DerivedDataCache: cannot list '{}': {}", _directory.string(), error.message());
+    }
+    std::sort(scanned.begin(), scanned.end(), [](const ScannedEntry& lhs, const ScannedEntry& rhs) noexcept {
+        return lhs.WriteTime < rhs.WriteTime;
+    });
+    std::lock_guard<std::mutex> lock{_mutex};
+    _entries.reserve(scanned.size());
+    for (ScannedEntry& entry : scanned) {
+        _totalBytes += entry.Bytes;
+        _entries.emplace(std::move(entry.FileName), Entry{.Bytes = entry.Bytes, .LastUse = ++_useClock});
+    }
+    EvictLocked(0);
+}
+
+DerivedDataCache::~DerivedDataCache() noexcept {
+    for (const auto& [importerType, stats] : _stats) {
+        RADRAY_DEBUG_LOG(
+            "DerivedDataCache: '{}' hits {} misses {} ({:.1f}%), saved {:.1f} ms",
+            importerType,
+            stats.Hits,
+            stats.Misses,
+            stats.GetHitRate() * 100.0,
+            stats.SavedMilliseconds);
+    }
+}
+
+std::filesystem::path DerivedDataCache::GetEntryPath(const DerivedDataKey& key) const {
+    return _directory / fmt::format("{:016x}{}", HashKey(key), kEntryExtension);
+}
+
+std::optional<vector<byte>> DerivedDataCache::Get(const DerivedDataKey& key) {
+    RADRAY_PROFILE_SCOPE("DerivedDataCache::Get");
+    const auto start = std::chrono::steady_clock::now();
+    const std::filesystem::path path = GetEntryPath(key);
+    if (!BeginLookup(key, path)) {
+        return std::nullopt;
+    }
+    // 读盘不持锁; 期间条目可能被另一线程淘汰, 读失败按未命中处理。
+    std::optional<vector<byte>> file = ReadBinaryFile(path);
+    std::optional<DecodedEntry> decoded;
+    if (file.has_value()) {
+        decoded = DecodeEntry(key, file.value());
+    }
+    if (!decoded.has_value()) {
+        FinishLookup(key, path, file.has_value(), std::nullopt, start);
+        return std::nullopt;
+    }
+    file->resize(decoded->PayloadSize);
+    FinishLookup(key, path, true, decoded->CookMilliseconds, start);
+    return file;
+}
+
+std::optional<MappedDerivedData> DerivedDataCache::Map(const DerivedDataKey& key) {
+    RADRAY_PROFILE_SCOPE("DerivedDataCache::Map");
+    const auto start = std::chrono::steady_clock::now();
+    const std::filesystem::path path = GetEntryPath(key);
+    if (!BeginLookup(key, path)) {
+        return std::nullopt;
+    }
+    std::optional<MappedFile> file = MappedFile::Open(path);
+    std::optional<DecodedEntry> decoded;
+    if (file.has_value()) {
+        decoded = DecodeEntry(key, file->GetData());
+    }
+    if (!decoded.has_value()) {
+        const bool opened = file.has_value();
+        // 先解除映射, Windows 上映射中的文件删不掉。
+        file.reset();
+        FinishLookup(key, path, opened, std::nullopt, start);
+        return std::nullopt;
+    }
+    FinishLookup(key, path, true, decoded->CookMilliseconds, start);
+    const std::span<const byte> payload = file->GetData().first(decoded->PayloadSize);
+    return MappedDerivedData{.File = std::move(file.value()), .Payload = payload};
+}
+
+bool DerivedDataCache::BeginLookup(const DerivedDataKey& key, const std::filesystem::path& path) {
+    std::lock_guard<std::mutex> lock{_mutex};
+    if (_entries.contains(path.filename().string())) {
+        return true;
+    }
+    RecordLookup(key.ImporterType, false, 0.0);
+    return false;
+}
+
+void DerivedDataCache::FinishLookup(
+    const DerivedDataKey& key,
+    const std::filesystem::path& path,
+    bool fileRead,
+    std::optional<float> cookMilliseconds,
+    std::chrono::steady_clock::time_point start) {
+    const string fileName = path.filename().string();
+    if (!cookMilliseconds.has_value()) {
+        if (fileRead) {
+            RADRAY_WARN_LOG("DerivedDataCache: dropping corrupt or mismatched entry '{}'", path.string());
+            std::error_code error;
+            std::filesystem::remove(path, error);
+        }
+        std::lock_guard<std::mutex> lock{_mutex};
+        EraseLocked(fileName);
+        RecordLookup(key.ImporterType, false, 0.0);
+        return;
+    }
+    // mtime 即持久化的最近使用时间。
+    std::error_code touchError;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), touchError);
+    const double saved = std::max(0.0, static_cast<double>(cookMilliseconds.value()) - MillisecondsSince(start));
+    std::lock_guard<std::mutex> lock{_mutex};
+    if (auto it = _entries.find(fileName); it != _entries.end()) {
+        it->second.LastUse = ++_useClock;
+    }
+    RecordLookup(key.ImporterType, true, saved);
+}
+
+bool DerivedDataCache::Put(const DerivedDataKey& key, std::span<const byte> payload, double cookMilliseconds) {
+    RADRAY_PROFILE_SCOPE("DerivedDataCache::Put");
+    const vector<byte> footer = EncodeFooter(key, payload, cookMilliseconds);
+    const uint64_t bytes = payload.size() + footer.size();
+    if (bytes > _maxBytes) {
+        return false;
+    }
+    const std::filesystem::path path = GetEntryPath(key);
+    if (!WriteEntryFile(path, payload, footer)) {
+        RADRAY_WARN_LOG("DerivedDataCache: cannot write '{}'", path.string());
+        return false;
+    }
+    string fileName = path.filename().string();
+    std::lock_guard<std::mutex> lock{_mutex};
+    EraseLocked(fileName);
+    EvictLocked(bytes);
+    _totalBytes += bytes;
+    _entries.emplace(std::move(fileName), Entry{.Bytes = bytes, .LastUse = ++_useClock});
+    ++_stats[string{key.ImporterType}].Writes;
+    RADRAY_PROFILE_COUNTER("DerivedDataCache::TotalBytes", _totalBytes);
+    return true;
+}
+
+DerivedDataStats DerivedDataCache::GetStats(std::string_view importerType) const {
+    std::lock_guard<std::mutex> lock{_mutex};
+    auto it = _stats.find(string{importerType});
+    return it == _stats.end() ? DerivedDataStats{} : it->second;
+}
+
+uint64_t DerivedDataCache::GetTotalBytes() const noexcept {
+    std::lock_guard<std::mutex> lock{_mutex};
+    return _totalBytes;
+}
+
+uint32_t DerivedDataCache::GetEntryCount() const noexcept {
+    std::lock_guard<std::mutex> lock{_mutex};
+    return static_cast<uint32_t>(_entries.size());
+}
+
+void DerivedDataCache::RecordLookup(std::string_view importerType, bool hit, double savedMilliseconds) {
+    DerivedDataStats& stats = _stats[string{importerType}];
+    if (hit) {
+        ++stats.Hits;
+        stats.SavedMilliseconds += savedMilliseconds;
+    } else {
+        ++stats.Misses;
+    }
+}
+
+void DerivedDataCache::EvictLocked(uint64_t reserveBytes) {
+    if (_totalBytes + reserveBytes <= _maxBytes) {
+        return;
+    }
+    // 淘汰不在热路径上, 排一次序即可。
+    vector<std::pair<uint64_t, string>> byAge;
+    byAge.reserve(_entries.size());
+    for (const auto& [fileName, entry] : _entries) {
+        byAge.emplace_back(entry.LastUse, fileName);
+    }
+    std::sort(byAge.begin(), byAge.end());
+    for (const auto& [lastUse, fileName] : byAge) {
+        if (_totalBytes + reserveBytes <= _maxBytes) {
+            break;
+        }
+        std::error_code error;
+        std::filesystem::remove(_directory / fileName, error);
+        EraseLocked(fileName);
+    }
+}
+
+void DerivedDataCache::EraseLocked(const string& fileName) {
+    auto it = _entries.find(fileName);
+    if (it == _entries.end()) {
+        return;
+    }
+    _totalBytes -= it->second.Bytes;
+    _entries.erase(it);
+}
+
+}  // namespace radray
@@ -7,6 +7,7 @@
 #include <utility>
 
 #include <radray/logger.h>
+#include <radray/profiler.h>
 #include <radray/render/render_pass_registry.h>
 #include <radray/runtime/application.h>
 #include <radray/runtime/components/camera_component.h>
@@ -20,6 +21,7 @@
 #include <radray/runtime/render_system.h>
 #include <radray/runtime/shader_program.h>
 #include <radray/runtime/window_manager.h>
+#include <radray/small_vector.h>
 
 namespace radray {
 namespace {
@@ -118,14 +120,16 @@ struct ForwardPipeline::Impl {
         vector<ResidentProgramSets> ProgramSets;
     };
 
+    using DynamicOffsetList = SmallVector<render::ShaderParameterDynamicOffset, 4>;
+
     struct PreparedDraw {
         MeshDrawItem Item;
         Nullable<render::ShaderParameterSet*> ViewSet{nullptr};
         Nullable<render::ShaderParameterSet*> MaterialSet{nullptr};
         Nullable<render::ShaderParameterSet*> ObjectSet{nullptr};
-        vector<render::ShaderParameterDynamicOffset> ViewOffsets;
-        vector<render::ShaderParameterDynamicOffset> MaterialOffsets;
-        vector<render::ShaderParameterDynamicOffset> ObjectOffsets;
+        DynamicOffsetList ViewOffsets;
+        DynamicOffsetList MaterialOffsets;
+        DynamicOffsetList ObjectOffsets;
         bool Valid{false};
     };
 
@@ -162,9 +166,13 @@ struct ForwardPipeline::Impl {
     BindingGroupPlan BindingGroups;
     MeshDrawList DrawList;
     vector<PreparedDraw> Prepared;
+    // Per-program scratch, reused across frames so PrepareCamera does not allocate
+    // once it has seen the largest program batch.
+    vector<size_t> ProgramDrawIndices;
     vector<FlightResources> Flights;
     unordered_map<AppWindow*, DepthTarget> DepthTargets;
     vector<ShaderProgram*> InvalidPrograms;
+    ForwardPipelineStats Stats;
     bool LightOverflowWarned{false};
     ForwardDrawPass OpaquePass;
     ForwardDrawPass TransparentPass;
@@ -298,8 +306,8 @@ struct ForwardPipeline::Impl {
             return false;
         }
 
-        vector<SelectedLight> directional;
-        vector<SelectedLight> points;
+        SmallVector<SelectedLight, kMaxDirectionalLights> directional;
+        SmallVector<SelectedLight, kMaxPointLights> points;
         for (const unique_ptr<LightSceneProxy>& light : camera.RenderScene->Lights()) {
             if (light == nullptr || !light->AffectsWorld()) {
                 continue;
@@ -317,7 +325,7 @@ struct ForwardPipeline::Impl {
                 points.push_back(selected);
             }
         }
-        const auto sortByDistance = [](vector<SelectedLight>& lights) {
+        const auto sortByDistance = [](auto& lights) {
             std::stable_sort(
                 lights.begin(),
                 lights.end(),
@@ -448,7 +456,9 @@ struct ForwardPipeline::Impl {
     bool PrepareCamera(
         RenderPipelineContext& ctx,
         const RenderCamera& camera) {
+        RADRAY_PROFILE_SCOPE("ForwardPipeline::PrepareCamera");
         Prepared.clear();
+        Stats = {};
         if (!camera.Target.HasValue() || camera.Target.Get()->Window == nullptr ||
             camera.Target.Get()->BackBuffer == nullptr || camera.ViewCamera == nullptr ||
             camera.RenderScene == nullptr || ctx.Frame.FlightIndex() >= Flights.size()) {
@@ -465,7 +475,18 @@ struct ForwardPipeline::Impl {
             return false;
         }
 
-        DrawList.Collect(camera.RenderScene, camera.ViewCamera->ComputeViewMatrix());
+        // Proj(1, 1) maps a unit at view depth 1 onto NDC; half the viewport height turns that into pixels.
+        const float aspect = static_cast<float>(targetDesc.Width) / static_cast<float>(targetDesc.Height);
+        const float pixelsPerUnit = 0.5f * static_cast<float>(targetDesc.Height) *
+                                    camera.ViewCamera->ComputeProjMatrix(aspect)(1, 1);
+        const MeshDrawStreamingView streaming{
+            .Manager = App->GetTextureStreamingManager(),
+            .PixelsPerUnit = pixelsPerUnit};
+        DrawList.Collect(
+            camera.RenderScene,
+            camera.ViewCamera->ComputeViewMatrix(),
+            streaming,
+            MeshLodView{.PixelsPerUnit = pixelsPerUnit});
         DrawList.Sort();
         Prepared.reserve(DrawList.Size());
         for (const MeshDrawItem& item : DrawList.Items()) {
@@ -477,7 +498,7 @@ struct ForwardPipeline::Impl {
             return false;
         }
         DynamicCBufferArena& arena = *flight.Arena;
-        vector<ShaderProgram*> programs;
+        SmallVector<ShaderProgram*, 4> programs;
         for (const PreparedDraw& draw : Prepared) {
             ShaderProgram* program = draw.Item.DrawMaterial->GetProgram();
             if (std::find(programs.begin(), programs.end(), program) == programs.end()) {
@@ -512,7 +533,8 @@ struct ForwardPipeline::Impl {
                 continue;
             }
 
-            vector<size_t> drawIndices;
+            vector<size_t>& drawIndices = ProgramDrawIndices;
+            drawIndices.clear();
             for (size_t index = 0; index < Prepared.size(); ++index) {
                 if (Prepared[index].Item.DrawMaterial->GetProgram() == program) {
                     drawIndices.push_back(index);
@@ -533,8 +555,10 @@ struct ForwardPipeline::Impl {
             }
             std::memset(objectReservation.Data(), 0, objectBytes);
             bool objectValuesValid = true;
+            // LocalToWorld is the only object parameter, so one storage is overwritten
+            // per draw instead of constructing (and allocating) a fresh one each time.
+            ShaderParameterStorage objectValues{&layout};
             for (size_t localIndex = 0; localIndex < drawIndices.size(); ++localIndex) {
-                ShaderParameterStorage objectValues{&layout};
                 if (!objectValues.SetMatrix4x4(
                         "LocalToWorld",
                         Prepared[drawIndices[localIndex]].Item.LocalToWorld)) {
@@ -582,7 +606,7 @@ struct ForwardPipeline::Impl {
             }
         }
 
-        vector<Material*> materials;
+        SmallVector<Material*, 4> materials;
         for (const PreparedDraw& draw : Prepared) {
             if (draw.ViewSet.HasValue() &&
                 std::find(
@@ -595,8 +619,8 @@ struct ForwardPipeline::Impl {
         for (Material* material : materials) {
             ShaderProgram* program = material->GetProgram();
             const ShaderParameterLayout& layout = program->GetParameterLayout();
-            vector<MaterialBufferBinding> bindings;
-            vector<render::ShaderParameterDynamicOffset> offsets;
+            MaterialBufferBindingList bindings;
+            DynamicOffsetList offsets;
             bool valid = true;
             for (uint32_t bufferIndex = 0;
                  bufferIndex < layout.Buffers().size();
@@ -641,13 +665,30 @@ struct ForwardPipeline::Impl {
                 draw.Valid = true;
             }
         }
+        UpdateStats();
         return true;
     }
 
+    void UpdateStats() noexcept {
+        Stats.PreparedDrawCount = static_cast<uint32_t>(Prepared.size());
+        for (const PreparedDraw& draw : Prepared) {
+            if (draw.Valid) {
+                ++Stats.ValidDrawCount;
+            }
+            for (const DynamicOffsetList* offsets :
+                 {&draw.ViewOffsets, &draw.MaterialOffsets, &draw.ObjectOffsets}) {
+                if (!offsets->is_inline()) {
+                    ++Stats.HeapDrawListCount;
+                }
+            }
+        }
+    }
+
     bool Execute(
         RenderPipelineContext& ctx,
         const RenderCamera& camera,
         bool transparent) {
+        RADRAY_PROFILE_SCOPE("ForwardPipeline::Execute");
         if (!camera.Target.HasValue() || camera.Target.Get()->Window == nullptr ||
             camera.Target.Get()->BackBuffer == nullptr ||
             camera.Target.Get()->BackBufferView == nullptr || Registry == nullptr) {
@@ -731,7 +772,7 @@ struct ForwardPipeline::Impl {
             0, 0, targetDesc.Width, targetDesc.Height});
 
         const GraphicsPassState passState{
-            vector<render::TextureFormat>{targetDesc.Format},
+            std::span{&targetDesc.Format, 1},
             kForwardDepthFormat,
             targetDesc.SampleCount,
             pass.Get()};
@@ -818,6 +859,10 @@ void ForwardPipeline::OnAddRenderPasses(
     }
 }
 
+ForwardPipelineStats ForwardPipeline::GetStats() const noexcept {
+    return _impl->Stats;
+}
+
 bool ForwardPipeline::ExecutePreparedPass(
     RenderPipelineContext& ctx,
     const RenderCamera& camera,
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 
+#include <radray/profiler.h>
 #include <radray/runtime/application.h>
 #include <radray/runtime/game_framework/actor.h>
 #include <radray/runtime/render_system.h>
@@ -38,6 +39,7 @@ void World::DestroyActor(Actor* actor) {
 }
 
 void World::Tick(float deltaTime) {
+    RADRAY_PROFILE_SCOPE("World::Tick");
     for (auto& actor : _actors) {
         actor->Tick(deltaTime);
     }
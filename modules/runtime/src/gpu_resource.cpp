@@ -490,34 +490,41 @@ void ResourceUploader::UploadBuffer(
 
 namespace {
 
-std::optional<uint64_t> GetSubresourceUploadSize(
-    const render::TextureDescriptor& desc,
-    const render::SubresourceRange& range,
-    std::span<const byte> srcData,
-    uint64_t srcRowPitch,
-    uint64_t dstRowPitch) noexcept {
-    const uint32_t bytesPerPixel = render::GetTextureFormatBytesPerPixel(desc.Format);
-    if (bytesPerPixel == 0) {
-        return std::nullopt;
-    }
+/// 一个 mip 的行数与紧密行宽。"行"对块压缩格式是一行 4x4 块。
+struct SubresourceRows {
+    uint64_t TightRowPitch{0};
+    uint64_t TotalRows{0};
+};
+
+SubresourceRows GetSubresourceRows(const render::TextureDescriptor& desc, uint32_t mipLevel) noexcept {
+    const render::TextureFormatBlockInfo block = render::GetTextureFormatBlockInfo(desc.Format);
     const bool is3D = desc.Dim == render::TextureDimension::Dim3D;
-    const uint32_t mipLevel = range.BaseMipLevel;
     const uint32_t mipWidth = std::max(desc.Width >> mipLevel, 1u);
     const uint32_t mipHeight = std::max(desc.Height >> mipLevel, 1u);
     const uint32_t mipDepth = is3D ? std::max(desc.DepthOrArraySize >> mipLevel, 1u) : 1u;
-    const uint64_t tightRowPitch = static_cast<uint64_t>(mipWidth) * bytesPerPixel;
-    if (srcRowPitch < tightRowPitch || dstRowPitch < tightRowPitch) {
+    const uint64_t blocksWide = (mipWidth + block.Width - 1) / block.Width;
+    const uint64_t blocksHigh = (mipHeight + block.Height - 1) / block.Height;
+    return SubresourceRows{
+        .TightRowPitch = blocksWide * block.Bytes,
+        .TotalRows = blocksHigh * mipDepth};
+}
+
+std::optional<uint64_t> GetSubresourceUploadSize(
+    const SubresourceRows& rows,
+    std::span<const byte> srcData,
+    uint64_t srcRowPitch,
+    uint64_t dstRowPitch) noexcept {
+    if (rows.TightRowPitch == 0 || srcRowPitch < rows.TightRowPitch || dstRowPitch < rows.TightRowPitch) {
         return std::nullopt;
     }
-    const uint64_t totalRows = static_cast<uint64_t>(mipHeight) * mipDepth;
-    if (totalRows == 0) {
+    if (rows.TotalRows == 0) {
         return std::nullopt;
     }
-    const uint64_t requiredSrcSize = (totalRows - 1) * srcRowPitch + tightRowPitch;
+    const uint64_t requiredSrcSize = (rows.TotalRows - 1) * srcRowPitch + rows.TightRowPitch;
     if (srcData.size() < requiredSrcSize) {
         return std::nullopt;
     }
-    return dstRowPitch * totalRows;
+    return dstRowPitch * rows.TotalRows;
 }
 
 }  // namespace
@@ -525,14 +532,15 @@ std::optional<uint64_t> GetSubresourceUploadSize(
 void ResourceUploader::UploadTexture(
     render::CommandBuffer* cmdBuffer,
     const TextureUploadRequest& request) {
-    if (request.SrcData.empty() || request.DstTexture == nullptr) {
+    const bool writeInPlace = request.SrcData.empty() && request.WriteRows != nullptr;
+    if ((request.SrcData.empty() && !writeInPlace) || request.DstTexture == nullptr) {
         return;
     }
     const auto desc = request.DstTexture->GetDesc();
     const bool is3D = desc.Dim == render::TextureDimension::Dim3D;
     const uint32_t arraySize = is3D ? 1u : desc.DepthOrArraySize;
-    const uint32_t bytesPerPixel = render::GetTextureFormatBytesPerPixel(desc.Format);
-    if (bytesPerPixel == 0 ||
+    const render::TextureFormatBlockInfo block = render::GetTextureFormatBlockInfo(desc.Format);
+    if (block.Bytes == 0 ||
         request.DstRange.MipLevelCount != 1 ||
         request.DstRange.ArrayLayerCount != 1 ||
         request.DstRange.BaseMipLevel >= desc.MipLevels ||
@@ -540,8 +548,8 @@ void ResourceUploader::UploadTexture(
         return;
     }
 
-    const uint32_t baseWidth = std::max(desc.Width >> request.DstRange.BaseMipLevel, 1u);
-    const uint64_t tightRowPitch = static_cast<uint64_t>(baseWidth) * bytesPerPixel;
+    const SubresourceRows rows = GetSubresourceRows(desc, request.DstRange.BaseMipLevel);
+    const uint64_t tightRowPitch = rows.TightRowPitch;
     const uint64_t srcRowPitch = request.SrcRowPitch == 0 ? tightRowPitch : request.SrcRowPitch;
     if (srcRowPitch < tightRowPitch) {
         return;
@@ -549,28 +557,33 @@ void ResourceUploader::UploadTexture(
     const uint64_t dstRowPitch = Align(
         tightRowPitch,
         std::max<uint64_t>(1, _device->GetDetail().TextureDataPitchAlignment));
-    const auto uploadSize = GetSubresourceUploadSize(
-        desc, request.DstRange, request.SrcData, srcRowPitch, dstRowPitch);
-    if (!uploadSize.has_value()) {
+    const auto uploadSize = writeInPlace
+                                ? std::optional<uint64_t>{dstRowPitch * rows.TotalRows}
+                                : GetSubresourceUploadSize(rows, request.SrcData, srcRowPitch, dstRowPitch);
+    if (!uploadSize.has_value() || uploadSize.value() == 0) {
         return;
     }
 
     const uint64_t placementAlignment = std::max({uint64_t{1},
-                                                  static_cast<uint64_t>(bytesPerPixel),
+                                                  static_cast<uint64_t>(block.Bytes),
                                                   _device->GetDetail().TextureDataPlacementAlignment});
     auto reservation = _stagingPool.Reserve(uploadSize.value(), placementAlignment);
     auto* dst = static_cast<byte*>(reservation.Data());
     const auto* src = request.SrcData.data();
-    const uint32_t mipLevel = request.DstRange.BaseMipLevel;
-    const uint32_t mipWidth = std::max(desc.Width >> mipLevel, 1u);
-    const uint32_t mipHeight = std::max(desc.Height >> mipLevel, 1u);
-    const uint32_t mipDepth = is3D ? std::max(desc.DepthOrArraySize >> mipLevel, 1u) : 1u;
-    const uint64_t rowBytes = static_cast<uint64_t>(mipWidth) * bytesPerPixel;
-    uint64_t srcOffset = 0;
-    uint64_t dstOffset = 0;
-    for (uint32_t depth = 0; depth < mipDepth; ++depth) {
-        for (uint32_t row = 0; row < mipHeight; ++row) {
-            std::memcpy(dst + dstOffset, src + srcOffset, rowBytes);
+    if (writeInPlace) {
+        if (!request.WriteRows(std::span{dst, static_cast<size_t>(uploadSize.value())}, dstRowPitch)) {
+            RADRAY_ERR_LOG("texture upload writer failed for mip {}", request.DstRange.BaseMipLevel);
+            reservation.Commit(0);
+            return;
+        }
+    } else if (srcRowPitch == dstRowPitch) {
+        // 源已按设备行距排好 (烘焙容器的常见情况): 整级一次拷贝, 末行不带补齐。
+        std::memcpy(dst, src, (rows.TotalRows - 1) * srcRowPitch + tightRowPitch);
+    } else {
+        uint64_t srcOffset = 0;
+        uint64_t dstOffset = 0;
+        for (uint64_t row = 0; row < rows.TotalRows; ++row) {
+            std::memcpy(dst + dstOffset, src + srcOffset, tightRowPitch);
             srcOffset += srcRowPitch;
             dstOffset += dstRowPitch;
         }
@@ -44,8 +44,8 @@ bool FrameUploadScheduler::EraseUpload(FrameUploadRecord* record) noexcept {
     return _uploads.Erase(record);
 }
 
-bool FrameUploadScheduler::IsUploadAlive(FrameUploadRecord* record) const noexcept {
-    return _uploads.IsAlive(record);
+bool FrameUploadScheduler::IsUploadAlive(FrameUploadRecord* record, uint64_t ticket) const noexcept {
+    return _uploads.IsAlive(record, ticket);
 }
 
 void FrameUploadScheduler::ResumeRecord(FrameUploadRecord* record) {
@@ -60,20 +60,22 @@ void FrameUploadScheduler::RunUploadPhase(
     render::CommandBuffer* cmdBuffer,
     ResourceUploader& uploader,
     uint32_t flightIndex) {
-    vector<FrameUploadRecord*> pending;
-    const size_t uploadCount = _uploads.Count();
-    for (size_t i = 0; i < uploadCount; ++i) {
-        FrameUploadRecord* record = _uploads.At(i);
-        if (record != nullptr && record->CurrentStage == FrameUploadStage::AwaitingFrame) {
-            pending.push_back(record);
+    // 连同 ticket 一起收集: 恢复前面的记录可能摘掉后面的记录, 其 Entry 又被新的等待复用。
+    vector<std::pair<FrameUploadRecord*, uint64_t>> pending;
+    for (FrameUploadRecord* record = _uploads.Front(); record != nullptr; record = _uploads.Next(record)) {
+        if (record->CurrentStage == FrameUploadStage::AwaitingFrame) {
+            pending.emplace_back(record, record->Ticket);
         }
     }
 
-    for (FrameUploadRecord* rec : pending) {
+    for (auto [rec, ticket] : pending) {
+        if (!IsUploadAlive(rec, ticket)) {
+            continue;
+        }
         if (rec->Canceled || rec->Stop.stop_requested()) {
             rec->Canceled = true;
             ResumeRecord(rec);
-            if (IsUploadAlive(rec)) {
+            if (IsUploadAlive(rec, ticket)) {
                 EraseUpload(rec);
             }
             continue;
@@ -86,7 +88,7 @@ void FrameUploadScheduler::RunUploadPhase(
 
         ResumeRecord(rec);
 
-        if (!IsUploadAlive(rec)) {
+        if (!IsUploadAlive(rec, ticket)) {
             continue;
         }
         if (rec->CurrentStage != FrameUploadStage::AwaitingFence) {
@@ -97,12 +99,7 @@ void FrameUploadScheduler::RunUploadPhase(
 }
 
 void FrameUploadScheduler::NotifyFlightComplete(uint32_t flightIndex) {
-    const size_t uploadCount = _uploads.Count();
-    for (size_t i = 0; i < uploadCount; ++i) {
-        FrameUploadRecord* rec = _uploads.At(i);
-        if (rec == nullptr) {
-            continue;
-        }
+    for (FrameUploadRecord* rec = _uploads.Front(); rec != nullptr; rec = _uploads.Next(rec)) {
         if (rec->CurrentStage == FrameUploadStage::AwaitingFence && rec->FlightIndex == flightIndex) {
             rec->CurrentStage = FrameUploadStage::FenceComplete;
         }
@@ -113,20 +110,19 @@ void FrameUploadScheduler::PumpCompletedUploads() {
     bool resumedAny = true;
     while (resumedAny) {
         resumedAny = false;
-        for (size_t i = 0; i < _uploads.Count();) {
-            FrameUploadRecord* rec = _uploads.At(i);
+        for (FrameUploadRecord* rec = _uploads.Front(); rec != nullptr; rec = _uploads.Next(rec)) {
             if (rec->Stop.stop_requested()) {
                 rec->Canceled = true;
             }
             if (rec->Canceled || rec->CurrentStage == FrameUploadStage::FenceComplete) {
+                const uint64_t ticket = rec->Ticket;
                 ResumeRecord(rec);
-                if (IsUploadAlive(rec)) {
+                if (IsUploadAlive(rec, ticket)) {
                     EraseUpload(rec);
                 }
                 resumedAny = true;
                 break;
             }
-            ++i;
         }
     }
 }
@@ -270,20 +266,19 @@ void GpuSystem::PumpWaitFrame(uint32_t flightIndex) {
     bool resumedAny = true;
     while (resumedAny) {
         resumedAny = false;
-        for (size_t i = 0; i < waiters.Count();) {
-            WaitFrameRecord* rec = waiters.At(i);
+        for (WaitFrameRecord* rec = waiters.Front(); rec != nullptr; rec = waiters.Next(rec)) {
             if (rec->Stop.stop_requested()) {
                 rec->Canceled = true;
             }
             if (rec->Canceled || rec->FlightComplete) {
+                const uint64_t ticket = rec->Ticket;
                 waiters.ResumeRecord(rec);
-                if (waiters.IsAlive(rec)) {
+                if (waiters.IsAlive(rec, ticket)) {
                     waiters.Erase(rec);
                 }
                 resumedAny = true;
                 break;
             }
-            ++i;
         }
     }
 }
@@ -314,11 +309,8 @@ bool GpuSystem::CompleteFlight(uint32_t flightIndex) {
     // 【只标记,不恢复】: 本函数在多线程模式下由渲染线程调用 (ThreadedRunner::
     // RetireRenderedFrames), 而等待者恢复后会跑资产析构 —— 那必须在主线程。恢复交给
     // PumpWaitFrame。
-    const size_t waiterCount = flight.WaitFrame.Count();
-    for (size_t i = 0; i < waiterCount; ++i) {
-        if (WaitFrameRecord* rec = flight.WaitFrame.At(i); rec != nullptr) {
-            rec->FlightComplete = true;
-        }
+    for (WaitFrameRecord* rec = flight.WaitFrame.Front(); rec != nullptr; rec = flight.WaitFrame.Next(rec)) {
+        rec->FlightComplete = true;
     }
     return true;
 }
@@ -1,36 +1,30 @@
 #include <radray/runtime/image_asset.h>
 
-#include <array>
-#include <cstring>
 #include <optional>
-#include <fstream>
-#include <sstream>
-#include <string_view>
 
 #include <fmt/format.h>
 
+#include <radray/file.h>
+#include <radray/memory.h>
+#include <radray/pixel_convert.h>
+
 namespace radray {
 namespace {
 
-std::optional<ImageData> DecodeImageFromStream(std::istream& stream) {
-    if (ImageData::IsPNG(stream)) {
-        stream.clear();
-        stream.seekg(0, std::ios::beg);
-        return ImageData::LoadPNG(stream, PNGLoadSettings{.AddAlphaIfRGB = 0xffu});
+std::optional<ImageData> DecodeImageFromBytes(std::span<const byte> encoded) {
+    MemoryTagScope memoryTag{MemoryTag::AssetLoading};
+    if (ImageData::IsPNG(encoded)) {
+        return ImageData::LoadPNG(encoded, PNGLoadSettings{.AddAlphaIfRGB = 0xffu});
     }
-    stream.clear();
-    stream.seekg(0, std::ios::beg);
-    if (ImageData::IsJPEG(stream)) {
-        stream.clear();
-        stream.seekg(0, std::ios::beg);
-        return ImageData::LoadJPEG(stream, JPEGLoadSettings{.AddAlphaIfRGB = 0xffu});
+    if (ImageData::IsJPEG(encoded)) {
+        return ImageData::LoadJPEG(encoded, JPEGLoadSettings{.AddAlphaIfRGB = 0xffu});
     }
     return std::nullopt;
 }
 
 ImageData ApplyImageLoadOptions(ImageData image, const ImageAssetLoadOptions& options) {
     if (options.ConvertToRgba8) {
-        image = ConvertToRGBA8(image);
+        image = ConvertToRGBA8(std::move(image));
     }
     return image;
 }
@@ -47,8 +41,8 @@ AssetId MakeImageAssetId(const std::filesystem::path& path) {
 }
 
 task<AssetLoadResult> LoadImageAssetTask(std::filesystem::path path, ImageAssetLoadOptions options) {
-    std::ifstream stream{path, std::ios::binary};
-    if (!stream.is_open()) {
+    std::optional<MappedFile> mapping = MappedFile::Open(path);
+    if (!mapping.has_value()) {
         ImageData fallback = ResolveImageLoadFailure(options);
         if (fallback.Data == nullptr) {
             co_return AssetLoadResult::Failure(fmt::format("failed to open image '{}'", path.string()));
@@ -56,7 +50,7 @@ task<AssetLoadResult> LoadImageAssetTask(std::filesystem::path path, ImageAssetL
         co_return AssetLoadResult::Success(make_unique<ImageAsset>(path.string(), std::move(fallback)));
     }
 
-    std::optional<ImageData> image = DecodeImageFromStream(stream);
+    std::optional<ImageData> image = DecodeImageFromBytes(mapping->GetData());
     if (!image.has_value()) {
         ImageData fallback = ResolveImageLoadFailure(options);
         if (fallback.Data == nullptr) {
@@ -70,14 +64,7 @@ task<AssetLoadResult> LoadImageAssetTask(std::filesystem::path path, ImageAssetL
 }
 
 task<AssetLoadResult> LoadImageAssetFromMemoryTask(string name, vector<byte> encodedBytes, ImageAssetLoadOptions options) {
-    string storage;
-    storage.resize(encodedBytes.size());
-    if (!encodedBytes.empty()) {
-        std::memcpy(storage.data(), encodedBytes.data(), encodedBytes.size());
-    }
-
-    std::istringstream stream{storage, std::ios::binary};
-    std::optional<ImageData> image = DecodeImageFromStream(stream);
+    std::optional<ImageData> image = DecodeImageFromBytes(encodedBytes);
     if (!image.has_value()) {
         ImageData fallback = ResolveImageLoadFailure(options);
         if (fallback.Data == nullptr) {
@@ -109,6 +96,10 @@ RuntimeTypeId ImageAsset::GetTypeId() const noexcept {
     return runtime_type_id_v<ImageAsset>;
 }
 
+AssetMemorySize ImageAsset::GetMemorySize() const noexcept {
+    return AssetMemorySize{.CpuBytes = _image.GetSize()};
+}
+
 ImageData MakeSolidImage(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
     ImageData img;
     img.Width = 1;
@@ -126,35 +117,15 @@ std::optional<ImageData> DecodeImageBytes(std::span<const byte> encoded) {
     if (encoded.empty()) {
         return std::nullopt;
     }
-    string storage;
-    storage.resize(encoded.size());
-    std::memcpy(storage.data(), encoded.data(), encoded.size());
-    std::istringstream stream{storage, std::ios::binary};
-    return DecodeImageFromStream(stream);
+    return DecodeImageFromBytes(encoded);
 }
 
-ImageData ConvertToRGBA8(const ImageData& src) {
+ImageData ConvertToRGBA8(ImageData src) {
     if (src.Format == ImageFormat::RGBA8_BYTE) {
         return src;
     }
-    if (src.Format == ImageFormat::RGB8_BYTE) {
-        return src.RGB8ToRGBA8(0xff);
-    }
-    if (src.Format == ImageFormat::R8_BYTE) {
-        ImageData out;
-        out.Width = src.Width;
-        out.Height = src.Height;
-        out.Format = ImageFormat::RGBA8_BYTE;
-        out.Data = make_unique<byte[]>(out.GetSize());
-        const size_t count = static_cast<size_t>(src.Width) * src.Height;
-        for (size_t i = 0; i < count; ++i) {
-            byte v = src.Data[i];
-            out.Data[i * 4 + 0] = v;
-            out.Data[i * 4 + 1] = v;
-            out.Data[i * 4 + 2] = v;
-            out.Data[i * 4 + 3] = byte{0xff};
-        }
-        return out;
+    if (ConvertImageInPlace(src, ImageFormat::RGBA8_BYTE)) {
+        return src;
     }
     return MakeSolidImage(255, 255, 255, 255);
 }
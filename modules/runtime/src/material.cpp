@@ -26,9 +26,22 @@ struct Material::ResourceState {
     struct FlightSet {
         unique_ptr<render::ShaderParameterSet> Set;
         uint64_t ResourceVersion{0};
-        vector<MaterialBufferBinding> BufferBindings;
+        // Sum of GetViewVersion() over the bound textures when Set was built. A texture
+        // that streams in more mips swaps its views and bumps this, forcing a rebuild.
+        uint64_t TextureViewVersion{0};
+        MaterialBufferBindingList BufferBindings;
     };
 
+    uint64_t GetTextureViewVersion() const noexcept {
+        uint64_t version = 0;
+        for (const TextureValue& value : Textures) {
+            if (const TextureAsset* texture = value.Texture.Get(); texture != nullptr) {
+                version += texture->GetViewVersion();
+            }
+        }
+        return version;
+    }
+
     explicit ResourceState(uint32_t flightCount)
         : Flights(flightCount) {}
 
@@ -192,7 +205,7 @@ Nullable<render::ShaderParameterSet*> Material::PrepareParameterSet(
         return nullptr;
     }
 
-    vector<const MaterialBufferBinding*> materialBuffers;
+    SmallVector<const MaterialBufferBinding*, 4> materialBuffers;
     for (uint32_t bufferIndex = 0;
          bufferIndex < _program->GetParameterLayout().Buffers().size();
          ++bufferIndex) {
@@ -245,8 +258,11 @@ Nullable<render::ShaderParameterSet*> Material::PrepareParameterSet(
     }
 
     ResourceState::FlightSet& flight = _resources->Flights[flightIndex];
+    // View versions only grow, so the sum changes whenever any texture swaps its views.
+    const uint64_t textureViewVersion = _resources->GetTextureViewVersion();
     const bool rebuild = flight.Set == nullptr ||
-                         flight.ResourceVersion != _resources->Version;
+                         flight.ResourceVersion != _resources->Version ||
+                         flight.TextureViewVersion != textureViewVersion;
     // A resident set may already be referenced by command buffers recorded for an
     // earlier camera this frame. Vulkan resolves descriptors at execution time, so
     // rewriting an unchanged binding would retroactively repoint that recording.
@@ -321,6 +337,7 @@ Nullable<render::ShaderParameterSet*> Material::PrepareParameterSet(
     if (rebuild) {
         flight.Set = std::move(replacement);
         flight.ResourceVersion = _resources->Version;
+        flight.TextureViewVersion = textureViewVersion;
     }
     flight.BufferBindings.clear();
     flight.BufferBindings.reserve(materialBuffers.size());
@@ -338,6 +355,14 @@ Nullable<render::ShaderParameterSet*> Material::GetResidentParameterSet(
     return _resources->Flights[flightIndex].Set.get();
 }
 
+uint32_t Material::GetBoundTextureCount() const noexcept {
+    return static_cast<uint32_t>(_resources->Textures.size());
+}
+
+const TextureAsset* Material::GetBoundTexture(uint32_t index) const noexcept {
+    return index < _resources->Textures.size() ? _resources->Textures[index].Texture.Get() : nullptr;
+}
+
 uint64_t Material::GetResourceVersion() const noexcept {
     return _resources->Version;
 }
@@ -1,11 +1,14 @@
 #include <radray/runtime/render_framework/mesh_draw.h>
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
 
+#include <radray/profiler.h>
 #include <radray/runtime/material.h>
 #include <radray/runtime/render_framework/scene.h>
 #include <radray/runtime/shader_program.h>
+#include <radray/runtime/texture_streaming.h>
 
 namespace radray {
 namespace {
@@ -15,11 +18,35 @@ bool IsTransparent(const Material* material) noexcept {
            static_cast<int32_t>(RenderQueue::GeometryLast);
 }
 
+// Report how many screen pixels one UV unit of this draw covers to every texture its material
+// binds. The nearest point of the bounding sphere stands in for the whole section, so a close-up
+// of a large mesh asks for the detail its nearest texels need.
+void RequestTextureMips(
+    const MeshDrawStreamingView& streaming,
+    const MeshDrawArgs& args,
+    const Material* material,
+    const Eigen::Matrix4f& viewMatrix,
+    const Eigen::Matrix4f& localToWorld) noexcept {
+    const Eigen::Matrix3f linear = localToWorld.topLeftCorner<3, 3>();
+    const float worldScale = std::max({linear.col(0).norm(), linear.col(1).norm(), linear.col(2).norm()});
+    const Eigen::Vector4f viewCenter =
+        viewMatrix * (localToWorld * args.BoundsCenter.homogeneous());
+    const float distance = std::max(viewCenter.head<3>().norm() - args.BoundsRadius * worldScale, 1e-3f);
+    const float pixelsPerUv =
+        ComputeTexturePixelsPerUv(args.UvDensity, worldScale, distance, streaming.PixelsPerUnit);
+    for (uint32_t index = 0; index < material->GetBoundTextureCount(); ++index) {
+        streaming.Manager->Request(material->GetBoundTexture(index), pixelsPerUv);
+    }
+}
+
 }  // namespace
 
 void MeshDrawList::Collect(
     const Scene* scene,
-    const Eigen::Matrix4f& viewMatrix) {
+    const Eigen::Matrix4f& viewMatrix,
+    const MeshDrawStreamingView& streaming,
+    const MeshLodView& lod) {
+    RADRAY_PROFILE_SCOPE("MeshDrawList::Collect");
     _items.clear();
     for (const unique_ptr<PrimitiveSceneProxy>& proxy : scene->Primitives()) {
         if (proxy == nullptr) {
@@ -28,28 +55,44 @@ void MeshDrawList::Collect(
         const Eigen::Matrix4f localToWorld = proxy->GetLocalToWorld();
         const Eigen::Vector4f viewOrigin =
             viewMatrix * localToWorld.col(3);
+        const uint32_t lodIndex = proxy->SelectLod(viewMatrix, lod);
         for (uint32_t sectionIndex = 0;
              sectionIndex < proxy->GetSectionCount();
              ++sectionIndex) {
-            const MeshDrawArgs args = proxy->GetDrawArgs(sectionIndex);
+            const MeshDrawArgs args = proxy->GetDrawArgs(sectionIndex, lodIndex);
             const Nullable<Material*> material = proxy->GetMaterial(sectionIndex);
             if (args.Geometry == nullptr || args.IndexCount == 0 || !material.HasValue()) {
                 continue;
             }
+            if (streaming.Manager != nullptr && args.UvDensity > 0.0f) {
+                RequestTextureMips(streaming, args, material.Get(), viewMatrix, localToWorld);
+            }
+            // Quantized positions are decoded by the object transform itself; the scale is uniform,
+            // so normals transformed by its upper 3x3 only need the renormalization they already get.
+            Eigen::Matrix4f drawLocalToWorld = localToWorld;
+            if (args.PositionScale != 1.0f || !args.PositionOffset.isZero(0.0f)) {
+                Eigen::Matrix4f dequantize = Eigen::Matrix4f::Identity();
+                dequantize.topLeftCorner<3, 3>().diagonal().setConstant(args.PositionScale);
+                dequantize.topRightCorner<3, 1>() = args.PositionOffset;
+                drawLocalToWorld = localToWorld * dequantize;
+            }
             _items.push_back(MeshDrawItem{
                 .Geometry = args.Geometry,
                 .DrawMaterial = material.Get(),
-                .LocalToWorld = localToWorld,
+                .LocalToWorld = drawLocalToWorld,
                 .FirstIndex = args.FirstIndex,
                 .IndexCount = args.IndexCount,
                 .VertexOffset = args.VertexOffset,
                 .SectionIndex = sectionIndex,
+                .LodIndex = lodIndex,
                 .ViewDepth = viewOrigin.z()});
         }
     }
+    RADRAY_PROFILE_COUNTER("MeshDrawList::Items", _items.size());
 }
 
 void MeshDrawList::Sort() {
+    RADRAY_PROFILE_SCOPE("MeshDrawList::Sort");
     std::stable_sort(
         _items.begin(),
         _items.end(),
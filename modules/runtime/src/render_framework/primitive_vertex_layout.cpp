@@ -34,6 +34,39 @@ std::optional<render::VertexFormat> GetVertexFormat(
                 case 4: return render::VertexFormat::SINT32X4;
                 default: return std::nullopt;
             }
+        // 压缩格式在 RHI 里只有 2 / 4 分量的版本。
+        case VertexDataType::HALF:
+            switch (componentCount) {
+                case 2: return render::VertexFormat::FLOAT16X2;
+                case 4: return render::VertexFormat::FLOAT16X4;
+                default: return std::nullopt;
+            }
+        case VertexDataType::SNORM8:
+            switch (componentCount) {
+                case 2: return render::VertexFormat::SNORM8X2;
+                case 4: return render::VertexFormat::SNORM8X4;
+                default: return std::nullopt;
+            }
+        case VertexDataType::UNORM8:
+            switch (componentCount) {
+                case 2: return render::VertexFormat::UNORM8X2;
+                case 4: return render::VertexFormat::UNORM8X4;
+                default: return std::nullopt;
+            }
+        case VertexDataType::SNORM16:
+            switch (componentCount) {
+                case 2: return render::VertexFormat::SNORM16X2;
+                case 4: return render::VertexFormat::SNORM16X4;
+                default: return std::nullopt;
+            }
+        case VertexDataType::UNORM16:
+            switch (componentCount) {
+                case 2: return render::VertexFormat::UNORM16X2;
+                case 4: return render::VertexFormat::UNORM16X4;
+                default: return std::nullopt;
+            }
+        case VertexDataType::UNORM10_10_10_2:
+            return componentCount == 4 ? std::optional{render::VertexFormat::UNORM10_10_10_2} : std::nullopt;
     }
     return std::nullopt;
 }
@@ -1,5 +1,7 @@
 #include <radray/runtime/render_framework/static_mesh_scene_proxy.h>
 
+#include <algorithm>
+#include <limits>
 #include <utility>
 
 namespace radray {
@@ -14,7 +16,30 @@ StaticMeshSceneProxy::StaticMeshSceneProxy(
 
 StaticMeshSceneProxy::~StaticMeshSceneProxy() noexcept = default;
 
-MeshDrawArgs StaticMeshSceneProxy::GetDrawArgs(uint32_t sectionIndex) const noexcept {
+uint32_t StaticMeshSceneProxy::SelectLod(const Eigen::Matrix4f& viewMatrix, const MeshLodView& view) const noexcept {
+    const StaticMesh* mesh = _mesh.Get();
+    const Eigen::Matrix3f linear = _localToWorld.topLeftCorner<3, 3>();
+    const float worldScale = std::max({linear.col(0).norm(), linear.col(1).norm(), linear.col(2).norm()});
+    if (mesh == nullptr || !(view.PixelsPerUnit > 0.0f) || !(worldScale > 0.0f)) {
+        return 0;
+    }
+    // 包围球最近点处的屏幕误差不超过 MaxPixelError: 与贴图流送一样, 近处那部分决定整体。
+    const Eigen::Vector3f center = (mesh->GetBoundsMin() + mesh->GetBoundsMax()) * 0.5f;
+    const float radius = (mesh->GetBoundsMax() - mesh->GetBoundsMin()).norm() * 0.5f;
+    const Eigen::Vector4f viewCenter = viewMatrix * (_localToWorld * center.homogeneous());
+    const float distance = std::max(viewCenter.head<3>().norm() - radius * worldScale, 1e-3f);
+    const float errorBudget = view.MaxPixelError * distance / (worldScale * view.PixelsPerUnit);
+    // 各 primitive 的级数与误差各不相同, 取都能接受的最粗一级; 级数少的在 GetDrawArgs 里夹到最粗。
+    uint32_t lodIndex = std::numeric_limits<uint32_t>::max();
+    for (const MeshPrimitive& primitive : mesh->GetMeshResource().Primitives) {
+        if (!primitive.Lods.empty()) {
+            lodIndex = std::min(lodIndex, SelectStaticMeshLod(primitive.Lods, errorBudget));
+        }
+    }
+    return lodIndex == std::numeric_limits<uint32_t>::max() ? 0 : lodIndex;
+}
+
+MeshDrawArgs StaticMeshSceneProxy::GetDrawArgs(uint32_t sectionIndex, uint32_t lodIndex) const noexcept {
     const StaticMesh* mesh = _mesh.Get();
     if (mesh == nullptr || sectionIndex >= mesh->GetSections().size()) {
         return {};
@@ -23,11 +48,26 @@ MeshDrawArgs StaticMeshSceneProxy::GetDrawArgs(uint32_t sectionIndex) const noex
     if (section.PrimitiveIndex >= mesh->GetRenderMesh().Draws.size()) {
         return {};
     }
+    // 只有覆盖整个 LOD0 的 section 能换级: 自定义切分的 section 在粗级别里没有对应的子范围。
+    uint32_t firstIndex = section.FirstIndex;
+    uint32_t indexCount = section.IndexCount;
+    const MeshPrimitive& primitive = mesh->GetMeshResource().Primitives[section.PrimitiveIndex];
+    const vector<MeshLodEntry>& lods = primitive.Lods;
+    if (!lods.empty() && lods[0].FirstIndex == firstIndex && lods[0].IndexCount == indexCount) {
+        const MeshLodEntry& lod = lods[std::min<size_t>(lodIndex, lods.size() - 1)];
+        firstIndex = lod.FirstIndex;
+        indexCount = lod.IndexCount;
+    }
     return MeshDrawArgs{
         .Geometry = &mesh->GetRenderMesh().Draws[section.PrimitiveIndex],
-        .FirstIndex = section.FirstIndex,
-        .IndexCount = section.IndexCount,
-        .VertexOffset = section.VertexOffset};
+        .FirstIndex = firstIndex,
+        .IndexCount = indexCount,
+        .VertexOffset = section.VertexOffset,
+        .BoundsCenter = (mesh->GetBoundsMin() + mesh->GetBoundsMax()) * 0.5f,
+        .BoundsRadius = (mesh->GetBoundsMax() - mesh->GetBoundsMin()).norm() * 0.5f,
+        .UvDensity = section.UvDensity,
+        .PositionOffset = primitive.PositionOffset,
+        .PositionScale = primitive.PositionScale};
 }
 
 uint32_t StaticMeshSceneProxy::GetSectionCount() const noexcept {
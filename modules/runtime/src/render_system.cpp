@@ -8,6 +8,8 @@
 #include <radray/file.h>
 #include <radray/hash.h>
 #include <radray/logger.h>
+#include <radray/memory.h>
+#include <radray/profiler.h>
 #include <radray/render/backend_shader_artifact.h>
 #include <radray/render/rhi.h>
 #include <radray/runtime/application.h>
@@ -175,6 +177,8 @@ void RenderSystem::SetPipeline(unique_ptr<RenderPipeline> pipeline) noexcept {
 }
 
 void RenderSystem::Render(AppFrameContext& ctx) {
+    RADRAY_PROFILE_SCOPE("RenderSystem::Render");
+    MemoryTagScope memoryTag{MemoryTag::RenderFramework};
     if (_app == nullptr || _app->GetWindowManager() == nullptr) {
         return;
     }
@@ -4,6 +4,7 @@
 
 #include <radray/shader_compiler/client.h>
 #include <radray/logger.h>
+#include <radray/memory.h>
 
 #include <cstring>
 
@@ -52,6 +53,7 @@ std::optional<ShaderJitArtifact> ShaderJit::Compile(
     if (!IsAvailable() || !shader::HasTarget(request.Targets, target)) {
         return std::nullopt;
     }
+    MemoryTagScope memoryTag{MemoryTag::ShaderJit};
     shader::CompileVariantRequest concreteRequest = request;
     concreteRequest.Targets = static_cast<shader::ShaderTargetMask>(shader::ToTargetMask(target));
     const shader::CompileVariantResult result =
@@ -75,11 +75,11 @@ Nullable<unique_ptr<render::Shader>> CreateStageShader(
 }  // namespace
 
 GraphicsPassState::GraphicsPassState(
-    vector<render::TextureFormat> colorFormats,
+    std::span<const render::TextureFormat> colorFormats,
     std::optional<render::TextureFormat> depthStencilFormat,
     uint32_t sampleCount,
     render::RenderPass* compatibleRenderPass) noexcept
-    : ColorFormats(std::move(colorFormats)),
+    : ColorFormats(colorFormats.begin(), colorFormats.end()),
       DepthStencilFormat(depthStencilFormat),
       SampleCount(sampleCount),
       CompatibleRenderPass(compatibleRenderPass) {}
@@ -1,6 +1,8 @@
 #include <radray/runtime/static_mesh.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <limits>
 #include <cstring>
 #include <utility>
@@ -8,8 +10,16 @@
 #include <array>
 #include <fmt/format.h>
 
+#include <radray/binary_io.h>
+#include <radray/file.h>
+#include <radray/hash.h>
+#include <radray/logger.h>
+#include <radray/mesh_optimizer.h>
+#include <radray/mesh_simplifier.h>
 #include <radray/triangle_mesh.h>
 #include <radray/render/rhi.h>
+#include <radray/runtime/asset_decode_pool.h>
+#include <radray/runtime/derived_data_cache.h>
 #include <radray/runtime/gpu_system.h>
 #include <radray/wavefront_obj.h>
 
@@ -84,6 +94,18 @@ bool IsPrimitiveValid(const MeshPrimitive& primitive, const MeshResource& meshRe
             return false;
         }
     }
+    if (!primitive.PositionOffset.allFinite() ||
+        !(primitive.PositionScale > 0.0f) || !std::isfinite(primitive.PositionScale)) {
+        return false;
+    }
+    for (const MeshLodEntry& lod : primitive.Lods) {
+        if (lod.IndexCount == 0 ||
+            lod.FirstIndex > primitive.IndexBuffer.IndexCount ||
+            lod.IndexCount > primitive.IndexBuffer.IndexCount - lod.FirstIndex ||
+            !(lod.Error >= 0.0f) || !std::isfinite(lod.Error)) {
+            return false;
+        }
+    }
 
     return true;
 }
@@ -141,6 +163,34 @@ bool AreObjFaceIndicesValid(const WavefrontObjReader& reader) noexcept {
     return true;
 }
 
+/// 任意分量类型都可以, 读取时经 DecodeVertexData 解成 float。
+const VertexBufferEntry* FindAttribute(
+    const MeshPrimitive& primitive,
+    std::string_view semantic,
+    uint16_t minComponents) noexcept {
+    for (const VertexBufferEntry& entry : primitive.VertexBuffers) {
+        if (entry.Semantic == semantic &&
+            entry.SemanticIndex == 0 &&
+            entry.ComponentCount >= minComponents) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+/// 第 vertex 个顶点的位置, 按 primitive 的反量化参数还原到网格空间。范围由调用方保证。
+Eigen::Vector3f ReadPosition(
+    const MeshPrimitive& primitive,
+    const VertexBufferEntry& position,
+    std::span<const byte> data,
+    size_t vertex) noexcept {
+    const Eigen::Vector4f stored = DecodeVertexData(
+        position.Type,
+        position.ComponentCount,
+        data.data() + position.Offset + vertex * position.Stride);
+    return stored.head<3>() * primitive.PositionScale + primitive.PositionOffset;
+}
+
 bool BuildDefaultSectionsAndBounds(
     const MeshResource& meshResource,
     vector<StaticMeshSection>& sections,
@@ -154,25 +204,19 @@ bool BuildDefaultSectionsAndBounds(
          primitiveIndex < meshResource.Primitives.size();
          ++primitiveIndex) {
         const MeshPrimitive& primitive = meshResource.Primitives[primitiveIndex];
+        // 有 LOD 时默认 section 覆盖 LOD0, 其余级别的索引跟在后面, 由 SceneProxy 按视距换用。
         sections.emplace_back(
             primitiveIndex,
-            0,
-            primitive.IndexBuffer.IndexCount,
+            primitive.Lods.empty() ? 0 : primitive.Lods[0].FirstIndex,
+            primitive.Lods.empty() ? primitive.IndexBuffer.IndexCount : primitive.Lods[0].IndexCount,
             0,
             primitive.VertexCount - 1);
-        const auto position = std::find_if(
-            primitive.VertexBuffers.begin(),
-            primitive.VertexBuffers.end(),
-            [](const VertexBufferEntry& entry) noexcept {
-                return entry.Semantic == VertexSemantics::POSITION &&
-                       entry.SemanticIndex == 0 &&
-                       entry.Type == VertexDataType::FLOAT &&
-                       entry.ComponentCount >= 3;
-            });
-        if (position == primitive.VertexBuffers.end() ||
+        const VertexBufferEntry* position = FindAttribute(primitive, VertexSemantics::POSITION, 3);
+        if (position == nullptr ||
             position->BufferIndex >= meshResource.Bins.size()) {
             return false;
         }
+        const uint32_t positionSize = GetVertexDataSizeInBytes(position->Type, position->ComponentCount);
         const std::span<const byte> data =
             meshResource.Bins[position->BufferIndex].GetData();
         for (uint32_t vertexIndex = 0;
@@ -181,18 +225,401 @@ bool BuildDefaultSectionsAndBounds(
             const uint64_t offset = static_cast<uint64_t>(position->Offset) +
                                     static_cast<uint64_t>(vertexIndex) *
                                         position->Stride;
-            if (offset > data.size() || sizeof(float) * 3 > data.size() - offset) {
+            if (positionSize == 0 || offset > data.size() || positionSize > data.size() - offset) {
                 return false;
             }
-            float values[3];
-            std::memcpy(values, data.data() + offset, sizeof(values));
-            const Eigen::Vector3f point{values[0], values[1], values[2]};
+            const Eigen::Vector3f point = ReadPosition(primitive, *position, data, vertexIndex);
             boundsMin = boundsMin.cwiseMin(point);
             boundsMax = boundsMax.cwiseMax(point);
             hasPosition = true;
         }
     }
-    return hasPosition && IsStaticMeshDataValid(meshResource, sections);
+    if (!hasPosition || !IsStaticMeshDataValid(meshResource, sections)) {
+        return false;
+    }
+    for (StaticMeshSection& section : sections) {
+        section.UvDensity = ComputeStaticMeshUvDensity(meshResource, section);
+    }
+    return true;
+}
+
+/// CPU 阶段的产物: 已校验的网格数据 + 默认分段与包围盒。不碰 device, 可在 worker 上生成。
+struct PreparedStaticMesh {
+    MeshResource Resource;
+    vector<StaticMeshSection> Sections;
+    Eigen::Vector3f BoundsMin{Eigen::Vector3f::Zero()};
+    Eigen::Vector3f BoundsMax{Eigen::Vector3f::Zero()};
+    /// OBJ 的 mtllib 原文, 相对 OBJ 所在目录。随烘焙产物缓存, 缓存命中时也不必重新解析 OBJ。
+    vector<string> Mtllibs;
+    /// 材质库及其贴图的绝对路径, 见 AssetLoadResult::ReferencedFiles。库的内容不在缓存键里, 每次加载现读。
+    vector<std::filesystem::path> ReferencedFiles;
+    /// 非空表示 CPU 阶段失败。
+    string Error;
+
+    static PreparedStaticMesh Failure(string error) {
+        PreparedStaticMesh prepared;
+        prepared.Error = std::move(error);
+        return prepared;
+    }
+};
+
+/// OBJ 文本到解析结果(reader 的中间表、TriangleMesh、MeshResource)的估算膨胀倍数。只用于节流。
+constexpr uint64_t kEstimatedObjDecodeRatio = 4;
+
+PreparedStaticMesh PrepareStaticMesh(MeshResource meshResource) {
+    // 【校验先于上传】: 无效数据不该占用 upload 带宽, 也不该建出半成品内容。
+    if (!IsStaticMeshDataValid(meshResource, {})) {
+        return PreparedStaticMesh::Failure("static mesh resource is invalid");
+    }
+    PreparedStaticMesh prepared;
+    if (!BuildDefaultSectionsAndBounds(
+            meshResource,
+            prepared.Sections,
+            prepared.BoundsMin,
+            prepared.BoundsMax)) {
+        return PreparedStaticMesh::Failure("static mesh sections or bounds are invalid");
+    }
+    prepared.Resource = std::move(meshResource);
+    return prepared;
+}
+
+PreparedStaticMesh PrepareStaticMeshFromObj(
+    const std::filesystem::path& path,
+    std::span<const byte> text,
+    const MeshImportSettings& settings,
+    AssetDecodePool* decodePool) {
+    WavefrontObjReadOptions readOptions{};
+    if (decodePool != nullptr) {
+        readOptions.ParallelFor = [decodePool](uint32_t count, const std::function<void(uint32_t)>& body) {
+            decodePool->ParallelFor(count, body);
+        };
+    }
+    WavefrontObjReader reader{text};
+    reader.Read(readOptions);
+    if (reader.HasError()) {
+        return PreparedStaticMesh::Failure(fmt::format(
+            "cannot parse mesh source '{}': {}",
+            path.string(),
+            reader.Error()));
+    }
+    if (reader.Faces().empty() || !AreObjFaceIndicesValid(reader)) {
+        return PreparedStaticMesh::Failure(fmt::format(
+            "mesh source '{}' has no valid triangle faces",
+            path.string()));
+    }
+
+    TriangleMesh triangleMesh;
+    reader.ToTriangleMesh(&triangleMesh);
+    if (!triangleMesh.IsValid()) {
+        return PreparedStaticMesh::Failure(fmt::format(
+            "mesh source '{}' produced inconsistent vertex attributes",
+            path.string()));
+    }
+    // ToTriangleMesh 只按 (v, vt, vn) 下标去重, 值相同而下标不同的顶点留给焊接合并; 三角形次序
+    // 是文件里的面次序, 缓存重排后才有复用。
+    if (settings.Optimize && !OptimizeMesh(triangleMesh)) {
+        return PreparedStaticMesh::Failure(fmt::format(
+            "mesh source '{}' has out-of-range indices",
+            path.string()));
+    }
+
+    // 各级 LOD 的索引追加在 LOD0 之后, 共用一个索引 buffer 与全部顶点。
+    vector<MeshLodEntry> lods;
+    if (settings.LodCount > 1) {
+        lods = GenerateMeshLods(triangleMesh, {.MaxLodCount = settings.LodCount});
+    }
+
+    MeshResource meshResource;
+    if (settings.QuantizeVertices) {
+        triangleMesh.ToQuantizedMeshResource(&meshResource);
+    } else {
+        triangleMesh.ToSimpleMeshResource(&meshResource);
+    }
+    if (lods.size() > 1) {
+        meshResource.Primitives[0].Lods = std::move(lods);
+    }
+    PreparedStaticMesh prepared = PrepareStaticMesh(std::move(meshResource));
+    prepared.Mtllibs.assign(reader.Mtllibs().begin(), reader.Mtllibs().end());
+    return prepared;
+}
+
+std::filesystem::path PathFromUtf8(std::string_view value) {
+    const auto* data = reinterpret_cast<const char8_t*>(value.data());
+    return std::filesystem::path{std::u8string_view{data, value.size()}};
+}
+
+/// 材质库本身与库里引用的贴图。读不出的库仍算引用 (它可能稍后出现), 只是没有贴图可列。
+vector<std::filesystem::path> CollectMaterialReferences(
+    const std::filesystem::path& objPath,
+    std::span<const string> mtllibs) {
+    vector<std::filesystem::path> references;
+    for (const string& mtllib : mtllibs) {
+        const std::filesystem::path libraryPath = (objPath.parent_path() / PathFromUtf8(mtllib)).lexically_normal();
+        references.push_back(libraryPath);
+        const std::optional<string> library = ReadTextFile(libraryPath);
+        if (!library.has_value()) {
+            RADRAY_WARN_LOG("MeshImporter: cannot read material library '{}' of '{}'", mtllib, objPath.string());
+            continue;
+        }
+        for (const string& texture : ParseWavefrontMtlTextures(library.value())) {
+            references.push_back((libraryPath.parent_path() / PathFromUtf8(texture)).lexically_normal());
+        }
+    }
+    return references;
+}
+
+/// 烘焙产物的格式或网格处理流程变化时递增, 让旧的 derived data 失效。
+constexpr uint32_t kMeshImporterVersion = 7;
+
+vector<byte> EncodeCookedStaticMesh(const PreparedStaticMesh& prepared) {
+    size_t binBytes = 0;
+    for (const MeshBuffer& bin : prepared.Resource.Bins) {
+        binBytes += bin.GetSize() + 8;
+    }
+    BinaryWriter writer{binBytes + 256};
+    writer.String(prepared.Resource.Name);
+    writer.Size32(prepared.Resource.Bins.size());
+    for (const MeshBuffer& bin : prepared.Resource.Bins) {
+        writer.SizedBytes(bin.GetData());
+    }
+    writer.Size32(prepared.Resource.Primitives.size());
+    for (const MeshPrimitive& primitive : prepared.Resource.Primitives) {
+        writer.U32(primitive.VertexCount);
+        writer.I32(static_cast<int32_t>(primitive.Topology));
+        writer.U32(primitive.IndexBuffer.BufferIndex);
+        writer.U32(primitive.IndexBuffer.IndexCount);
+        writer.U32(primitive.IndexBuffer.Offset);
+        writer.U32(primitive.IndexBuffer.Stride);
+        writer.Size32(primitive.VertexBuffers.size());
+        for (const VertexBufferEntry& entry : primitive.VertexBuffers) {
+            writer.String(entry.Semantic);
+            writer.U32(entry.SemanticIndex);
+            writer.U32(entry.BufferIndex);
+            writer.U32(static_cast<uint32_t>(entry.Type));
+            writer.U32(entry.ComponentCount);
+            writer.U32(entry.Offset);
+            writer.U32(entry.Stride);
+        }
+        writer.Size32(primitive.Lods.size());
+        for (const MeshLodEntry& lod : primitive.Lods) {
+            writer.U32(lod.FirstIndex);
+            writer.U32(lod.IndexCount);
+            writer.Float(lod.Error);
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            writer.Float(primitive.PositionOffset[axis]);
+        }
+        writer.Float(primitive.PositionScale);
+    }
+    writer.Size32(prepared.Sections.size());
+    for (const StaticMeshSection& section : prepared.Sections) {
+        writer.U32(section.PrimitiveIndex);
+        writer.U32(section.FirstIndex);
+        writer.U32(section.IndexCount);
+        writer.U32(section.MinVertexIndex);
+        writer.U32(section.MaxVertexIndex);
+        writer.I32(section.VertexOffset);
+        writer.Float(section.UvDensity);
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        writer.Float(prepared.BoundsMin[axis]);
+        writer.Float(prepared.BoundsMax[axis]);
+    }
+    writer.Size32(prepared.Mtllibs.size());
+    for (const string& mtllib : prepared.Mtllibs) {
+        writer.String(mtllib);
+    }
+    return std::move(writer).TakeData();
+}
+
+std::optional<PreparedStaticMesh> DecodeCookedStaticMesh(std::span<const byte> cooked) {
+    BinaryReader reader{cooked};
+    PreparedStaticMesh prepared;
+    std::string_view name;
+    uint32_t binCount = 0;
+    if (!reader.String(name) || !reader.U32(binCount) || binCount > reader.Remaining()) {
+        return std::nullopt;
+    }
+    prepared.Resource.Name = string{name};
+    prepared.Resource.Bins.reserve(binCount);
+    for (uint32_t binIndex = 0; binIndex < binCount; ++binIndex) {
+        std::span<const byte> data;
+        if (!reader.SizedBytes(data)) {
+            return std::nullopt;
+        }
+        prepared.Resource.Bins.emplace_back(data);
+    }
+    uint32_t primitiveCount = 0;
+    if (!reader.U32(primitiveCount) || primitiveCount > reader.Remaining()) {
+        return std::nullopt;
+    }
+    prepared.Resource.Primitives.resize(primitiveCount);
+    for (MeshPrimitive& primitive : prepared.Resource.Primitives) {
+        int32_t topology = 0;
+        uint32_t vertexBufferCount = 0;
+        if (!reader.U32(primitive.VertexCount) ||
+            !reader.I32(topology) ||
+            !reader.U32(primitive.IndexBuffer.BufferIndex) ||
+            !reader.U32(primitive.IndexBuffer.IndexCount) ||
+            !reader.U32(primitive.IndexBuffer.Offset) ||
+            !reader.U32(primitive.IndexBuffer.Stride) ||
+            !reader.U32(vertexBufferCount) ||
+            vertexBufferCount > reader.Remaining()) {
+            return std::nullopt;
+        }
+        primitive.Topology = static_cast<PrimitiveTopology>(topology);
+        primitive.VertexBuffers.resize(vertexBufferCount);
+        for (VertexBufferEntry& entry : primitive.VertexBuffers) {
+            std::string_view semantic;
+            uint32_t type = 0;
+            uint32_t componentCount = 0;
+            if (!reader.String(semantic) ||
+                !reader.U32(entry.SemanticIndex) ||
+                !reader.U32(entry.BufferIndex) ||
+                !reader.U32(type) ||
+                !reader.U32(componentCount) ||
+                !reader.U32(entry.Offset) ||
+                !reader.U32(entry.Stride) ||
+                componentCount > std::numeric_limits<uint16_t>::max()) {
+                return std::nullopt;
+            }
+            entry.Semantic = string{semantic};
+            entry.Type = static_cast<VertexDataType>(type);
+            entry.ComponentCount = static_cast<uint16_t>(componentCount);
+        }
+        uint32_t lodCount = 0;
+        if (!reader.U32(lodCount) || lodCount > reader.Remaining()) {
+            return std::nullopt;
+        }
+        primitive.Lods.resize(lodCount);
+        for (MeshLodEntry& lod : primitive.Lods) {
+            if (!reader.U32(lod.FirstIndex) || !reader.U32(lod.IndexCount) || !reader.Float(lod.Error)) {
+                return std::nullopt;
+            }
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            if (!reader.Float(primitive.PositionOffset[axis])) {
+                return std::nullopt;
+            }
+        }
+        if (!reader.Float(primitive.PositionScale)) {
+            return std::nullopt;
+        }
+    }
+    uint32_t sectionCount = 0;
+    if (!reader.U32(sectionCount) || sectionCount > reader.Remaining()) {
+        return std::nullopt;
+    }
+    prepared.Sections.resize(sectionCount);
+    for (StaticMeshSection& section : prepared.Sections) {
+        if (!reader.U32(section.PrimitiveIndex) ||
+            !reader.U32(section.FirstIndex) ||
+            !reader.U32(section.IndexCount) ||
+            !reader.U32(section.MinVertexIndex) ||
+            !reader.U32(section.MaxVertexIndex) ||
+            !reader.I32(section.VertexOffset) ||
+            !reader.Float(section.UvDensity)) {
+            return std::nullopt;
+        }
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!reader.Float(prepared.BoundsMin[axis]) || !reader.Float(prepared.BoundsMax[axis])) {
+            return std::nullopt;
+        }
+    }
+    uint32_t mtllibCount = 0;
+    if (!reader.U32(mtllibCount) || mtllibCount > reader.Remaining()) {
+        return std::nullopt;
+    }
+    prepared.Mtllibs.reserve(mtllibCount);
+    for (uint32_t index = 0; index < mtllibCount; ++index) {
+        std::string_view mtllib;
+        if (!reader.String(mtllib)) {
+            return std::nullopt;
+        }
+        prepared.Mtllibs.emplace_back(mtllib);
+    }
+    // 产物与源数据走同一道校验: 缓存文件只验了内容哈希, 不能当作可信输入直接上传。
+    if (!reader.AtEnd() || !IsStaticMeshDataValid(prepared.Resource, prepared.Sections)) {
+        return std::nullopt;
+    }
+    return prepared;
+}
+
+/// worker 阶段: 映射源文件; 有 derived data 缓存时先按源内容查产物, 未命中才解析并回填。
+/// decodePool 非空时 OBJ 文本分块并行解析。
+PreparedStaticMesh PrepareCookedOrSourceStaticMesh(
+    const std::filesystem::path& path,
+    const MeshImportSettings& settings,
+    DerivedDataCache* derivedData,
+    AssetDecodePool* decodePool) {
+    std::optional<MappedFile> source = MappedFile::Open(path);
+    if (!source.has_value()) {
+        return PreparedStaticMesh::Failure(fmt::format("cannot read mesh source '{}'", path.string()));
+    }
+    const std::span<const byte> text = source->GetData();
+    if (derivedData == nullptr) {
+        return PrepareStaticMeshFromObj(path, text, settings, decodePool);
+    }
+    const DerivedDataKey key{
+        .ImporterType = "mesh",
+        .ImporterVersion = kMeshImporterVersion,
+        .SourceHash = HashData64(text.data(), text.size()),
+        .SettingsHash = HashImportSettings(&settings)};
+    if (std::optional<vector<byte>> cooked = derivedData->Get(key); cooked.has_value()) {
+        if (std::optional<PreparedStaticMesh> prepared = DecodeCookedStaticMesh(cooked.value()); prepared.has_value()) {
+            return std::move(prepared.value());
+        }
+        RADRAY_WARN_LOG("MeshImporter: cached mesh for '{}' is malformed, re-importing", path.string());
+    }
+    const auto cookStart = std::chrono::steady_clock::now();
+    PreparedStaticMesh prepared = PrepareStaticMeshFromObj(path, text, settings, decodePool);
+    if (prepared.Error.empty()) {
+        const double cookMilliseconds =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cookStart).count();
+        derivedData->Put(key, EncodeCookedStaticMesh(prepared), cookMilliseconds);
+    }
+    return prepared;
+}
+
+/// worker 阶段的入口: 取得网格后再读它的材质库, 列出引用的文件。
+PreparedStaticMesh PrepareStaticMeshFromSource(
+    const std::filesystem::path& path,
+    const MeshImportSettings& settings,
+    DerivedDataCache* derivedData,
+    AssetDecodePool* decodePool) {
+    PreparedStaticMesh prepared = PrepareCookedOrSourceStaticMesh(path, settings, derivedData, decodePool);
+    if (prepared.Error.empty()) {
+        prepared.ReferencedFiles = CollectMaterialReferences(path, prepared.Mtllibs);
+    }
+    return prepared;
+}
+
+/// 主线程阶段: 两阶段 GPU 上传, 完成后一次性构造内容与资产。
+task<AssetLoadResult> UploadPreparedStaticMesh(
+    FrameUploadScheduler& frameUploads,
+    PreparedStaticMesh prepared) {
+    if (!prepared.Error.empty()) {
+        co_return AssetLoadResult::Failure(std::move(prepared.Error));
+    }
+    // GPU 上传:两阶段 await(无 callback)。BeginUpload 挂起至帧顶拿到 cmd/uploader,
+    // 在本协程里 inline 录制 copy,再 co_await WaitGpu 等该 flight 的 fence。
+    FrameUploadScope frame = co_await frameUploads.BeginUpload();
+    std::optional<GpuMesh> renderMesh =
+        frame.GetUploader().UploadMeshResource(frame.GetCommandBuffer(), prepared.Resource);
+    if (!renderMesh.has_value()) {
+        co_return AssetLoadResult::Failure("static mesh upload recording failed");
+    }
+    co_await frame.WaitGpu();
+
+    AssetLoadResult result = AssetLoadResult::Success(make_unique<StaticMesh>(
+        std::move(prepared.Resource),
+        std::move(prepared.Sections),
+        prepared.BoundsMin,
+        prepared.BoundsMax,
+        std::move(renderMesh.value())));
+    result.ReferencedFiles = std::move(prepared.ReferencedFiles);
+    co_return result;
 }
 
 }  // namespace
@@ -203,7 +630,8 @@ StaticMeshSection::StaticMeshSection() noexcept
       IndexCount(0),
       MinVertexIndex(0),
       MaxVertexIndex(0),
-      VertexOffset(0) {
+      VertexOffset(0),
+      UvDensity(0.0f) {
 }
 
 StaticMeshSection::StaticMeshSection(
@@ -218,7 +646,8 @@ StaticMeshSection::StaticMeshSection(
       IndexCount(indexCount),
       MinVertexIndex(minVertexIndex),
       MaxVertexIndex(maxVertexIndex),
-      VertexOffset(vertexOffset) {
+      VertexOffset(vertexOffset),
+      UvDensity(0.0f) {
 }
 
 bool IsStaticMeshDataValid(
@@ -240,6 +669,72 @@ bool IsStaticMeshDataValid(
     return true;
 }
 
+float ComputeStaticMeshUvDensity(
+    const MeshResource& meshResource,
+    const StaticMeshSection& section) noexcept {
+    if (section.PrimitiveIndex >= meshResource.Primitives.size()) {
+        return 0.0f;
+    }
+    const MeshPrimitive& primitive = meshResource.Primitives[section.PrimitiveIndex];
+    const VertexBufferEntry* position = FindAttribute(primitive, VertexSemantics::POSITION, 3);
+    const VertexBufferEntry* uv = FindAttribute(primitive, VertexSemantics::TEXCOORD, 2);
+    if (primitive.Topology != PrimitiveTopology::TriangleList || position == nullptr || uv == nullptr) {
+        return 0.0f;
+    }
+    const std::span<const byte> positions = meshResource.Bins[position->BufferIndex].GetData();
+    const std::span<const byte> uvs = meshResource.Bins[uv->BufferIndex].GetData();
+    const std::span<const byte> indices = meshResource.Bins[primitive.IndexBuffer.BufferIndex].GetData();
+    // 各项的范围已由 IsStaticMeshDataValid 校验, 这里只防 VertexOffset 把下标推出顶点数。
+    auto readIndex = [&](uint32_t i) noexcept -> int64_t {
+        const size_t offset = primitive.IndexBuffer.Offset + size_t{i} * primitive.IndexBuffer.Stride;
+        uint32_t index = 0;
+        if (primitive.IndexBuffer.Stride == sizeof(uint16_t)) {
+            uint16_t value;
+            std::memcpy(&value, indices.data() + offset, sizeof(value));
+            index = value;
+        } else {
+            std::memcpy(&index, indices.data() + offset, sizeof(index));
+        }
+        return int64_t{index} + section.VertexOffset;
+    };
+    double geometryArea = 0.0;
+    double uvArea = 0.0;
+    const uint32_t triangleEnd = section.FirstIndex + section.IndexCount / 3 * 3;
+    for (uint32_t i = section.FirstIndex; i < triangleEnd; i += 3) {
+        Eigen::Vector3f p[3];
+        Eigen::Vector2f t[3];
+        bool inRange = true;
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            const int64_t vertex = readIndex(i + corner);
+            if (vertex < 0 || vertex >= int64_t{primitive.VertexCount}) {
+                inRange = false;
+                break;
+            }
+            p[corner] = ReadPosition(primitive, *position, positions, size_t(vertex));
+            t[corner] = DecodeVertexData(uv->Type, uv->ComponentCount, uvs.data() + uv->Offset + size_t(vertex) * uv->Stride).head<2>();
+        }
+        if (!inRange) {
+            continue;
+        }
+        geometryArea += 0.5 * (p[1] - p[0]).cross(p[2] - p[0]).norm();
+        const Eigen::Vector2f e1 = t[1] - t[0];
+        const Eigen::Vector2f e2 = t[2] - t[0];
+        uvArea += 0.5 * std::abs(e1.x() * e2.y() - e1.y() * e2.x());
+    }
+    if (!(uvArea > 0.0) || !(geometryArea > 0.0)) {
+        return 0.0f;
+    }
+    return static_cast<float>(std::sqrt(geometryArea / uvArea));
+}
+
+uint32_t SelectStaticMeshLod(std::span<const MeshLodEntry> lods, float errorBudget) noexcept {
+    uint32_t lodIndex = 0;
+    for (uint32_t index = 1; index < lods.size() && lods[index].Error <= errorBudget; ++index) {
+        lodIndex = index;
+    }
+    return lodIndex;
+}
+
 StaticMesh::StaticMesh(
     MeshResource meshResource,
     vector<StaticMeshSection> sections,
@@ -273,49 +768,74 @@ RuntimeTypeId StaticMesh::GetTypeId() const noexcept {
     return runtime_type_id_v<StaticMesh>;
 }
 
+AssetMemorySize StaticMesh::GetMemorySize() const noexcept {
+    AssetMemorySize size{};
+    for (const MeshBuffer& bin : _meshResource.Bins) {
+        size.CpuBytes += bin.GetSize();
+    }
+    for (const unique_ptr<render::Buffer>& buffer : _renderMesh.Buffers) {
+        if (buffer != nullptr) {
+            size.GpuBytes += buffer->GetDesc().Size;
+        }
+    }
+    return size;
+}
+
 task<AssetLoadResult> LoadStaticMesh(
     FrameUploadScheduler& frameUploads,
     MeshResource meshResource) {
     // 阶段(均为协程内部事务):
-    //  1) CPU 校验网格数据。
+    //  1) CPU 校验网格数据, 建默认分段与包围盒。
     //  2) 两阶段 GPU 上传:co_await FrameUploadScheduler::BeginUpload 挂起至帧顶拿 cmd/uploader,
     //     inline 录制 copy 进当前帧 cmdbuffer,再 co_await WaitGpu 跨帧等 fence。
     //  3) 一次性构造内容与资产。
-    // 【校验先于上传】: 无效数据不该占用 upload 带宽, 也不该建出半成品内容。
-    if (!IsStaticMeshDataValid(meshResource, {})) {
-        co_return AssetLoadResult::Failure("static mesh resource is invalid");
+    // 调用方已在自己的线程上建好 MeshResource, 阶段 1 只是线性扫描, 故就地执行。
+    co_return co_await UploadPreparedStaticMesh(frameUploads, PrepareStaticMesh(std::move(meshResource)));
+}
+
+const RuntimeTypeInfo& MeshImportSettings::GetTypeInfo() const noexcept {
+    return runtime_type_info_v<MeshImportSettings>;
+}
+
+bool MeshImportSettings::Deserialize(const JsonValue& json) {
+    JsonObjectReader object{json};
+    if (!object.IsValid()) {
+        return false;
     }
-    vector<StaticMeshSection> sections;
-    Eigen::Vector3f boundsMin;
-    Eigen::Vector3f boundsMax;
-    if (!BuildDefaultSectionsAndBounds(
-            meshResource,
-            sections,
-            boundsMin,
-            boundsMax)) {
-        co_return AssetLoadResult::Failure("static mesh sections or bounds are invalid");
+    const size_t knownMemberCount = static_cast<size_t>(object.Has("optimize")) +
+                                    static_cast<size_t>(object.Has("lodCount")) +
+                                    static_cast<size_t>(object.Has("quantizeVertices"));
+    if (json.Size() != knownMemberCount) {
+        return false;
     }
-
-    // GPU 上传:两阶段 await(无 callback)。BeginUpload 挂起至帧顶拿到 cmd/uploader,
-    // 在本协程里 inline 录制 copy,再 co_await WaitGpu 等该 flight 的 fence。
-    FrameUploadScope frame = co_await frameUploads.BeginUpload();
-    std::optional<GpuMesh> renderMesh =
-        frame.GetUploader().UploadMeshResource(frame.GetCommandBuffer(), meshResource);
-    if (!renderMesh.has_value()) {
-        co_return AssetLoadResult::Failure("static mesh upload recording failed");
+    MeshImportSettings decoded;
+    if (!object.MemberIfPresent("optimize", decoded.Optimize) ||
+        !object.MemberIfPresent("lodCount", decoded.LodCount) ||
+        !object.MemberIfPresent("quantizeVertices", decoded.QuantizeVertices) ||
+        decoded.LodCount == 0 ||
+        decoded.LodCount > kMaxLodCount) {
+        return false;
     }
-    co_await frame.WaitGpu();
+    *this = decoded;
+    return true;
+}
 
-    co_return AssetLoadResult::Success(make_unique<StaticMesh>(
-        std::move(meshResource),
-        std::move(sections),
-        boundsMin,
-        boundsMax,
-        std::move(renderMesh.value())));
+bool MeshImportSettings::Serialize(JsonWriteContext& context) const noexcept {
+    JsonObjectWriter object = context.BeginObject();
+    // 默认值不落盘, 全默认时写出的是空对象。
+    return object.IsValid() &&
+           (Optimize || object.Member("optimize", Optimize)) &&
+           (LodCount == MeshImportSettings{}.LodCount || object.Member("lodCount", LodCount)) &&
+           (!QuantizeVertices || object.Member("quantizeVertices", QuantizeVertices));
 }
 
-MeshImporter::MeshImporter(FrameUploadScheduler& frameUploads) noexcept
-    : _frameUploads(frameUploads) {
+MeshImporter::MeshImporter(
+    FrameUploadScheduler& frameUploads,
+    AssetDecodePool& decodePool,
+    DerivedDataCache* derivedData) noexcept
+    : _frameUploads(frameUploads),
+      _decodePool(decodePool),
+      _derivedData(derivedData) {
 }
 
 std::string_view MeshImporter::GetTypeName() const noexcept {
@@ -327,38 +847,28 @@ std::span<const std::string_view> MeshImporter::GetFileExtensions() const noexce
     return extensions;
 }
 
-task<AssetLoadResult> MeshImporter::Load(const AssetLoadContext& ctx) {
-    return LoadMesh(&_frameUploads, ctx.AbsolutePath);
+task<AssetLoadResult> MeshImporter::LoadTyped(
+    std::filesystem::path path,
+    MeshImportSettings settings) {
+    return LoadMesh(&_frameUploads, &_decodePool, _derivedData, std::move(path), std::move(settings));
 }
 
 task<AssetLoadResult> MeshImporter::LoadMesh(
     FrameUploadScheduler* frameUploads,
-    std::filesystem::path path) {
-    WavefrontObjReader reader{path};
-    reader.Read();
-    if (reader.HasError()) {
-        co_return AssetLoadResult::Failure(fmt::format(
-            "cannot parse mesh source '{}': {}",
-            path.string(),
-            reader.Error()));
-    }
-    if (reader.Faces().empty() || !AreObjFaceIndicesValid(reader)) {
-        co_return AssetLoadResult::Failure(fmt::format(
-            "mesh source '{}' has no valid triangle faces",
-            path.string()));
-    }
-
-    TriangleMesh triangleMesh;
-    reader.ToTriangleMesh(&triangleMesh);
-    if (!triangleMesh.IsValid()) {
-        co_return AssetLoadResult::Failure(fmt::format(
-            "mesh source '{}' produced inconsistent vertex attributes",
-            path.string()));
-    }
-
-    MeshResource meshResource;
-    triangleMesh.ToSimpleMeshResource(&meshResource);
-    co_return co_await LoadStaticMesh(*frameUploads, std::move(meshResource));
+    AssetDecodePool* decodePool,
+    DerivedDataCache* derivedData,
+    std::filesystem::path path,
+    MeshImportSettings settings) {
+    // 解析、三角化、网格优化、LOD 生成、切线生成与校验全部在 worker 上; 主线程只做上传。
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(path, error);
+    const uint64_t bytes = error ? 0 : static_cast<uint64_t>(fileSize) * kEstimatedObjDecodeRatio;
+    PreparedStaticMesh prepared = co_await decodePool->Run(
+        bytes,
+        [path, settings, derivedData, decodePool]() {
+            return PrepareStaticMeshFromSource(path, settings, derivedData, decodePool);
+        });
+    co_return co_await UploadPreparedStaticMesh(*frameUploads, std::move(prepared));
 }
 
 }  // namespace radray
@@ -3,14 +3,20 @@
 #include <algorithm>
 #include <array>
 #include <bit>
-#include <cmath>
+#include <chrono>
+#include <cstring>
 
 #include <fmt/format.h>
 
+#include <radray/block_compression.h>
 #include <radray/file.h>
 #include <radray/logger.h>
+#include <radray/mip_chain.h>
+#include <radray/runtime/asset_decode_pool.h>
+#include <radray/runtime/derived_data_cache.h>
 #include <radray/runtime/gpu_system.h>
 #include <radray/runtime/image_asset.h>
+#include <radray/runtime/texture_streaming.h>
 
 std::size_t std::hash<radray::TextureSubViewDesc>::operator()(
     const radray::TextureSubViewDesc& desc) const noexcept {
@@ -27,113 +33,298 @@ std::size_t std::hash<radray::TextureSubViewDesc>::operator()(
 namespace radray {
 namespace {
 
-render::TextureFormat PickFormat(bool srgb) noexcept {
-    return srgb ? render::TextureFormat::RGBA8_UNORM_SRGB : render::TextureFormat::RGBA8_UNORM;
+/// CPU 阶段的产物: 一份已校验的 .rrtex 容器。不碰 device, 可在 AssetDecodePool 的 worker 上生成。
+/// Container 指向 Mapping 或 Bytes 之一; 二者移动时数据地址都不变, 本结构可以随意移动。
+struct PreparedTexture {
+    /// 容器来自 derived data 条目或 .rrtex 源文件时的映射。
+    MappedFile Mapping;
+    /// 容器刚烘焙出来时的字节。
+    vector<byte> Bytes;
+    TextureContainer Container;
+    /// 非空表示 CPU 阶段失败。
+    string Error;
+
+    static PreparedTexture Failure(string error) {
+        PreparedTexture prepared;
+        prepared.Error = std::move(error);
+        return prepared;
+    }
+};
+
+/// 可流送贴图随首帧上传的链尾字节上限。至少一级; 最小的几级合计通常只有几 KiB。
+constexpr uint64_t kInitialResidentBytes = 256ull << 10;
+
+/// 解码后 RGBA8 像素相对编码字节的估算膨胀倍数。只用于在飞预算的节流。
+constexpr uint64_t kEstimatedTextureDecodeRatio = 8;
+
+uint64_t EstimateTexturePrepareBytes(uint64_t rgba8Bytes, uint64_t encodedBytes, bool generateMips) noexcept {
+    // 完整 mip 链约为 mip0 的 4/3, 打包成容器时再有一份; 非 RGBA8 输入经 ConvertToRGBA8 原地转换,
+    // 比 RGBA8 小的源 (RGB8 / R8) 转换期间与 mip0 并存, 按一份 mip0 计。
+    const uint64_t mipBytes = generateMips ? rgba8Bytes + rgba8Bytes / 3 : rgba8Bytes;
+    return encodedBytes + rgba8Bytes + mipBytes * 2;
 }
 
-/// 在 upload phase 内从 RGBA8 CPU 像素建 device-local 贴图 + SRV,录制上传命令。
-/// 不等 fence(由调用方 co_await frame.WaitGpu())。失败返回 nullopt。
-struct UploadedTexture {
-    unique_ptr<render::Texture> Texture;
-    unique_ptr<render::TextureView> Srv;
-};
+uint64_t EstimateEncodedTexturePrepareBytes(uint64_t encodedBytes, bool generateMips) noexcept {
+    return EstimateTexturePrepareBytes(encodedBytes * kEstimatedTextureDecodeRatio, encodedBytes, generateMips);
+}
 
-float SrgbToLinear(uint32_t value) noexcept {
-    const float normalized = static_cast<float>(value) / 255.0f;
-    return normalized <= 0.04045f
-               ? normalized / 12.92f
-               : std::pow((normalized + 0.055f) / 1.055f, 2.4f);
-}
-
-uint32_t LinearToSrgb(float value) noexcept {
-    const float encoded = value <= 0.0031308f
-                              ? value * 12.92f
-                              : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
-    return static_cast<uint32_t>(std::lround(std::clamp(encoded, 0.0f, 1.0f) * 255.0f));
-}
-
-vector<vector<byte>> BuildRgba8MipChain(const ImageData& rgba8, bool generateMips, bool srgb) {
-    vector<vector<byte>> mipChain;
-    mipChain.emplace_back(rgba8.GetSpan().begin(), rgba8.GetSpan().end());
-    if (!generateMips) {
-        return mipChain;
-    }
-
-    uint32_t sourceWidth = rgba8.Width;
-    uint32_t sourceHeight = rgba8.Height;
-    while (sourceWidth > 1 || sourceHeight > 1) {
-        const uint32_t destinationWidth = std::max(sourceWidth / 2, 1u);
-        const uint32_t destinationHeight = std::max(sourceHeight / 2, 1u);
-        const vector<byte>& source = mipChain.back();
-        vector<byte> destination(static_cast<size_t>(destinationWidth) * destinationHeight * 4);
-
-        for (uint32_t y = 0; y < destinationHeight; ++y) {
-            for (uint32_t x = 0; x < destinationWidth; ++x) {
-                float totals[4]{};
-                uint32_t sampleCount = 0;
-                for (uint32_t offsetY = 0; offsetY < 2; ++offsetY) {
-                    const uint32_t sourceY = y * 2 + offsetY;
-                    if (sourceY >= sourceHeight) {
-                        continue;
-                    }
-                    for (uint32_t offsetX = 0; offsetX < 2; ++offsetX) {
-                        const uint32_t sourceX = x * 2 + offsetX;
-                        if (sourceX >= sourceWidth) {
-                            continue;
-                        }
-                        const size_t sourceOffset =
-                            (static_cast<size_t>(sourceY) * sourceWidth + sourceX) * 4;
-                        for (size_t channel = 0; channel < 4; ++channel) {
-                            const uint32_t sample = std::to_integer<uint32_t>(source[sourceOffset + channel]);
-                            totals[channel] += srgb && channel < 3
-                                                   ? SrgbToLinear(sample)
-                                                   : static_cast<float>(sample);
-                        }
-                        ++sampleCount;
-                    }
-                }
-                const size_t destinationOffset =
-                    (static_cast<size_t>(y) * destinationWidth + x) * 4;
-                for (size_t channel = 0; channel < 4; ++channel) {
-                    const float average = totals[channel] / static_cast<float>(sampleCount);
-                    const uint32_t encoded = srgb && channel < 3
-                                                 ? LinearToSrgb(average)
-                                                 : static_cast<uint32_t>(std::lround(average));
-                    destination[destinationOffset + channel] = static_cast<byte>(encoded);
-                }
-            }
+MipChainOptions MakeMipChainOptions(const TextureAssetLoadOptions& options, AssetDecodePool* decodePool) {
+    MipChainOptions mipOptions{
+        .Srgb = options.Srgb,
+        .GenerateMips = options.GenerateMips,
+        .Filter = options.Filter};
+    if (decodePool != nullptr) {
+        mipOptions.ParallelFor = [decodePool](uint32_t count, const std::function<void(uint32_t)>& body) {
+            decodePool->ParallelFor(count, body);
+        };
+    }
+    return mipOptions;
+}
+
+bool IsTextureContainerPath(const std::filesystem::path& path) {
+    return path.extension() == ".rrtex";
+}
+
+/// 映射中的容器。bytes 必须落在 file 的映射区内。校验失败返回 nullopt。
+std::optional<PreparedTexture> MapPreparedTexture(MappedFile file, std::span<const byte> bytes) {
+    std::optional<TextureContainer> container = TextureContainer::Parse(bytes);
+    if (!container.has_value()) {
+        return std::nullopt;
+    }
+    PreparedTexture prepared;
+    prepared.Mapping = std::move(file);
+    prepared.Container = std::move(container.value());
+    return prepared;
+}
+
+/// 把 RGBA8 或块压缩的 mip 链打包成容器; blocks 非空时取代 mips。
+PreparedTexture PackTexture(
+    const string& name,
+    const Rgba8MipChain& mips,
+    const BlockCompressedMipChain& blocks,
+    TextureCompression compression,
+    bool srgb) {
+    const bool compressed = !blocks.IsEmpty();
+    const uint32_t levelCount = compressed ? blocks.GetLevelCount() : mips.GetLevelCount();
+    vector<std::span<const byte>> levels;
+    levels.reserve(levelCount);
+    for (uint32_t mipLevel = 0; mipLevel < levelCount; ++mipLevel) {
+        levels.push_back(compressed ? blocks.GetLevel(mipLevel) : mips.GetLevel(mipLevel));
+    }
+    PreparedTexture prepared;
+    prepared.Bytes = EncodeTextureContainer(
+        compressed ? blocks.GetWidth() : mips.GetWidth(),
+        compressed ? blocks.GetHeight() : mips.GetHeight(),
+        compressed ? compression : TextureCompression::None,
+        srgb,
+        levels);
+    std::optional<TextureContainer> container = TextureContainer::Parse(prepared.Bytes);
+    if (!container.has_value()) {
+        return PreparedTexture::Failure(fmt::format("texture '{}' could not be packed", name));
+    }
+    prepared.Container = std::move(container.value());
+    return prepared;
+}
+
+PreparedTexture PrepareTexture(
+    const string& name,
+    ImageData image,
+    const TextureAssetLoadOptions& options,
+    AssetDecodePool* decodePool) {
+    // RGBA8 归一(mip 生成与块压缩都以 RGBA8 为输入)。已是 RGBA8 的像素直接作为 level 0 的来源;
+    // 其它格式在 image 自己的缓冲里转换, 不比 RGBA8 大的源不再多出一份。
+    if (image.Format != ImageFormat::RGBA8_BYTE) {
+        image = ConvertToRGBA8(std::move(image));
+    }
+    if (image.Data == nullptr || image.Width == 0 || image.Height == 0) {
+        if (options.FallbackImage.Data != nullptr) {
+            image = ConvertToRGBA8(options.FallbackImage);
         }
+    }
+    if (image.Data == nullptr || image.Width == 0 || image.Height == 0) {
+        return PreparedTexture::Failure(fmt::format("texture '{}' has no valid pixels", name));
+    }
+    const MipChainOptions mipOptions = MakeMipChainOptions(options, decodePool);
+    const Rgba8MipChain mips = BuildRgba8MipChain(image.GetSpan(), image.Width, image.Height, mipOptions);
+    if (mips.IsEmpty()) {
+        return PreparedTexture::Failure(fmt::format("texture '{}' has a malformed pixel buffer", name));
+    }
+    const std::optional<BlockFormat> blockFormat = ToBlockFormat(options.Compression);
+    if (!blockFormat.has_value()) {
+        return PackTexture(name, mips, {}, TextureCompression::None, options.Srgb);
+    }
+    // 两个后端都要求块压缩贴图的 mip 0 按整块对齐。
+    if (image.Width % 4 != 0 || image.Height % 4 != 0) {
+        RADRAY_WARN_LOG(
+            "TextureAsset: '{}' is {}x{}, not a multiple of 4; uploading uncompressed",
+            name,
+            image.Width,
+            image.Height);
+        return PackTexture(name, mips, {}, TextureCompression::None, options.Srgb);
+    }
+    const BlockCompressedMipChain blocks = BlockCompressedMipChain::Compress(mips, blockFormat.value(), mipOptions.ParallelFor);
+    return PackTexture(name, mips, blocks, options.Compression, options.Srgb);
+}
 
-        mipChain.push_back(std::move(destination));
-        sourceWidth = destinationWidth;
-        sourceHeight = destinationHeight;
+PreparedTexture DecodeAndPrepareTexture(
+    const string& name,
+    std::span<const byte> encodedBytes,
+    const TextureAssetLoadOptions& options,
+    AssetDecodePool* decodePool) {
+    std::optional<ImageData> decoded = DecodeImageBytes(encodedBytes);
+    if (decoded.has_value()) {
+        return PrepareTexture(name, std::move(decoded.value()), options, decodePool);
     }
-    return mipChain;
+    if (options.FallbackImage.Data != nullptr) {
+        return PrepareTexture(name, options.FallbackImage, options, decodePool);
+    }
+    return PreparedTexture::Failure(fmt::format("texture '{}' decode failed", name));
 }
 
-std::optional<UploadedTexture> RecordTextureUpload(
-    const FrameUploadScope& frame,
-    const ImageData& rgba8,
-    bool srgb,
-    bool generateMips,
+/// 烘焙产物的格式或 mip 算法变化时递增, 让旧的 derived data 失效。
+constexpr uint32_t kTextureImporterVersion = 4;
+
+/// worker 阶段: .rrtex 源直接映射; 其余源有 derived data 缓存时先按源内容与 settings 映射产物,
+/// 未命中才解码烘焙并回填。
+PreparedTexture PrepareTextureFromSource(
+    const std::filesystem::path& path,
+    const string& name,
+    const TextureAssetLoadOptions& options,
+    DerivedDataCache* derivedData,
+    uint64_t settingsHash,
+    AssetDecodePool* decodePool) {
+    if (IsTextureContainerPath(path)) {
+        std::optional<MappedFile> file = MappedFile::Open(path);
+        if (!file.has_value()) {
+            return PreparedTexture::Failure(fmt::format("cannot read texture source '{}'", path.string()));
+        }
+        const std::span<const byte> bytes = file->GetData();
+        std::optional<PreparedTexture> prepared = MapPreparedTexture(std::move(file.value()), bytes);
+        if (!prepared.has_value()) {
+            return PreparedTexture::Failure(fmt::format("'{}' is not a valid .rrtex container", path.string()));
+        }
+        return std::move(prepared.value());
+    }
+    std::optional<vector<byte>> encoded = ReadBinaryFile(path);
+    if (!encoded.has_value()) {
+        return PreparedTexture::Failure(fmt::format("cannot read texture source '{}'", path.string()));
+    }
+    if (derivedData == nullptr) {
+        return DecodeAndPrepareTexture(name, encoded.value(), options, decodePool);
+    }
+    const DerivedDataKey key{
+        .ImporterType = "texture",
+        .ImporterVersion = kTextureImporterVersion,
+        .SourceHash = HashData64(encoded->data(), encoded->size()),
+        .SettingsHash = settingsHash};
+    if (std::optional<MappedDerivedData> cooked = derivedData->Map(key); cooked.has_value()) {
+        std::optional<PreparedTexture> prepared = MapPreparedTexture(std::move(cooked->File), cooked->Payload);
+        if (prepared.has_value()) {
+            return std::move(prepared.value());
+        }
+        RADRAY_WARN_LOG("TextureImporter: cached texture for '{}' is malformed, re-importing", name);
+    }
+    const auto cookStart = std::chrono::steady_clock::now();
+    PreparedTexture prepared = DecodeAndPrepareTexture(name, encoded.value(), options, decodePool);
+    if (prepared.Error.empty()) {
+        const double cookMilliseconds =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cookStart).count();
+        derivedData->Put(key, prepared.Container.GetBytes(), cookMilliseconds);
+    }
+    return prepared;
+}
+
+/// 设备采样不了 BC 时把容器里的块解回 RGBA8 再打包。容器行尾有补齐, 逐级先收紧再解码。
+PreparedTexture DecompressPreparedTexture(const string& name, const TextureContainer& container) {
+    const std::optional<BlockFormat> blockFormat = ToBlockFormat(container.GetCompression());
+    if (!blockFormat.has_value()) {
+        return PreparedTexture::Failure(fmt::format("texture '{}' is not block compressed", name));
+    }
+    Rgba8MipChain mips = Rgba8MipChain::Allocate(container.GetWidth(), container.GetHeight(), container.GetMipCount());
+    vector<byte> tight;
+    for (uint32_t mipLevel = 0; mipLevel < container.GetMipCount(); ++mipLevel) {
+        const TextureContainerMip& mip = container.GetMip(mipLevel);
+        const size_t tightRowPitch = GetBlockCompressedSize(blockFormat.value(), mip.Width, 1);
+        const std::span<const byte> data = container.GetMipData(mipLevel);
+        tight.resize(tightRowPitch * mip.RowCount);
+        for (uint32_t row = 0; row < mip.RowCount; ++row) {
+            std::memcpy(tight.data() + row * tightRowPitch, data.data() + size_t{row} * mip.RowPitch, tightRowPitch);
+        }
+        if (!DecompressBlocksToRgba8(tight, mip.Width, mip.Height, blockFormat.value(), mips.GetLevel(mipLevel))) {
+            return PreparedTexture::Failure(fmt::format("texture '{}' has malformed blocks", name));
+        }
+    }
+    return PackTexture(name, mips, {}, TextureCompression::None, container.IsSrgb());
+}
+
+/// 覆盖 texture 全部 mip 的默认 SRV。
+unique_ptr<render::TextureView> CreateDefaultSrv(
+    render::Device* device,
+    render::Texture* texture,
     std::string_view debugName) {
-    render::Device* device = frame.GetUploader().GetDevice();
-    if (device == nullptr || rgba8.Data == nullptr || rgba8.Width == 0 || rgba8.Height == 0) {
-        return std::nullopt;
+    const render::TextureFormat format = texture->GetDesc().Format;
+    render::TextureViewDescriptor viewDesc{
+        .Target = texture,
+        .Dim = render::TextureDimension::Dim2D,
+        .Format = format,
+        .Range = render::SubresourceRange::AllSub(),
+        .Usage = render::TextureViewUsage::Resource};
+    auto srvOpt = device->CreateTextureView(viewDesc);
+    if (!srvOpt.HasValue()) {
+        RADRAY_ERR_LOG("TextureAsset: CreateTextureView failed for '{}'", debugName);
+        return nullptr;
     }
-    const render::TextureFormat format = PickFormat(srgb);
-    const vector<vector<byte>> mipChain = BuildRgba8MipChain(rgba8, generateMips, srgb);
+    auto srv = srvOpt.Release();
+    srv->SetDebugName(fmt::format("texasset_srv_{}", debugName));
+    return srv;
+}
 
+/// 可流送时随首帧上传的链尾起点: 从最后一级往 mip 0 累加到 kInitialResidentBytes 为止。
+/// 两个后端都要求块压缩贴图的 mip 0 按整块对齐, 所以 BC 贴图的起点只能落在宽高都是 4 的倍数、
+/// 且更精细的各级也都对齐的那一段里。
+uint32_t PickTailMip(const TextureContainer& container) noexcept {
+    uint32_t limit = container.GetMipCount() - 1;
+    if (container.GetCompression() != TextureCompression::None) {
+        limit = 0;
+        while (limit + 1 < container.GetMipCount() &&
+               container.GetMip(limit + 1).Width % 4 == 0 &&
+               container.GetMip(limit + 1).Height % 4 == 0) {
+            ++limit;
+        }
+    }
+    uint32_t tailMip = container.GetMipCount() - 1;
+    uint64_t bytes = container.GetMip(tailMip).Size;
+    while (tailMip > 0 && bytes + container.GetMip(tailMip - 1).Size <= kInitialResidentBytes) {
+        bytes += container.GetMip(--tailMip).Size;
+    }
+    return std::min(tailMip, limit);
+}
+
+/// 在 upload phase 内建只含 [residentMip, 链尾) 的 device-local 贴图, 录制这几级并建默认 SRV。
+/// 不等 fence(由调用方 co_await frame.WaitGpu())。失败返回 nullopt。
+struct UploadedTexture {
+    unique_ptr<render::Texture> Texture;
+    unique_ptr<render::TextureView> Srv;
+};
+
+std::optional<UploadedTexture> RecordInitialTextureUpload(
+    const FrameUploadScope& frame,
+    const TextureContainer& container,
+    uint32_t residentMip,
+    std::string_view debugName) {
+    render::Device* device = frame.GetUploader().GetDevice();
+    const TextureContainerMip& top = container.GetMip(residentMip);
     render::TextureDescriptor texDesc{
         .Dim = render::TextureDimension::Dim2D,
-        .Width = rgba8.Width,
-        .Height = rgba8.Height,
+        .Width = top.Width,
+        .Height = top.Height,
         .DepthOrArraySize = 1,
-        .MipLevels = static_cast<uint32_t>(mipChain.size()),
+        .MipLevels = container.GetMipCount() - residentMip,
         .SampleCount = 1,
-        .Format = format,
+        .Format = container.GetFormat(),
         .Memory = render::MemoryType::Device,
-        .Usage = render::TextureUse::Resource | render::TextureUse::CopyDestination,
+        // 流送换贴图时, 保留的那几级从旧贴图拷出。
+        .Usage = render::TextureUse::Resource | render::TextureUse::CopySource | render::TextureUse::CopyDestination,
         .Hints = render::ResourceHint::None};
     auto texOpt = device->CreateTexture(texDesc);
     if (!texOpt.HasValue()) {
@@ -143,94 +334,99 @@ std::optional<UploadedTexture> RecordTextureUpload(
     auto texture = texOpt.Release();
     texture->SetDebugName(fmt::format("texasset_{}", debugName));
 
-    render::TextureViewDescriptor viewDesc{
-        .Target = texture.get(),
-        .Dim = render::TextureDimension::Dim2D,
-        .Format = format,
-        .Range = render::SubresourceRange::AllSub(),
-        .Usage = render::TextureViewUsage::Resource};
-    auto srvOpt = device->CreateTextureView(viewDesc);
-    if (!srvOpt.HasValue()) {
-        RADRAY_ERR_LOG("TextureAsset: CreateTextureView failed for '{}'", debugName);
+    unique_ptr<render::TextureView> srv = CreateDefaultSrv(device, texture.get(), debugName);
+    if (srv == nullptr) {
         return std::nullopt;
     }
-    auto srv = srvOpt.Release();
-    srv->SetDebugName(fmt::format("texasset_srv_{}", debugName));
-
-    for (uint32_t mipLevel = 0; mipLevel < mipChain.size(); ++mipLevel) {
-        TextureUploadRequest request{};
-        request.SrcData = mipChain[mipLevel];
-        request.DstTexture = texture.get();
-        request.DstRange = render::SubresourceRange{
-            .BaseArrayLayer = 0,
-            .ArrayLayerCount = 1,
-            .BaseMipLevel = mipLevel,
-            .MipLevelCount = 1};
-        request.SrcRowPitch = 0;
-        request.Before = mipLevel == 0
-                             ? render::TextureState::Undefined
-                             : render::TextureState::ShaderRead;
-        request.After = render::TextureState::ShaderRead;
-        frame.GetUploader().UploadTexture(frame.GetCommandBuffer(), request);
-    }
-
+    RecordTextureMipUploads(frame, texture.get(), container, residentMip, residentMip, container.GetMipCount(), true);
     return UploadedTexture{std::move(texture), std::move(srv)};
 }
 
-task<AssetLoadResult> LoadTextureFromImageTask(
+/// 主线程阶段: 等帧顶 upload phase 录制, 再等 GPU fence。streaming 非空时只录链尾, 资产发布后
+/// 交给管理器流送; 否则整条链随首帧上传。
+task<AssetLoadResult> UploadPreparedTextureTask(
     FrameUploadScheduler& frameUploads,
+    TextureStreamingManager* streaming,
     string name,
-    ImageData image,
-    TextureAssetLoadOptions options) {
-    // RGBA8 归一(GPU 仅支持 RGBA8 上传路径)。
-    ImageData rgba8 = ConvertToRGBA8(image);
-    if (rgba8.Data == nullptr || rgba8.Width == 0 || rgba8.Height == 0) {
-        if (options.FallbackImage.Data != nullptr) {
-            rgba8 = ConvertToRGBA8(options.FallbackImage);
-        }
-    }
-    if (rgba8.Data == nullptr || rgba8.Width == 0 || rgba8.Height == 0) {
-        co_return AssetLoadResult::Failure(fmt::format("texture '{}' has no valid pixels", name));
+    PreparedTexture prepared) {
+    if (!prepared.Error.empty()) {
+        co_return AssetLoadResult::Failure(std::move(prepared.Error));
     }
-
     FrameUploadScope frame = co_await frameUploads.BeginUpload();
-    std::optional<UploadedTexture> uploaded = RecordTextureUpload(
-        frame,
-        rgba8,
-        options.Srgb,
-        options.GenerateMips,
-        name);
+    render::Device* device = frame.GetUploader().GetDevice();
+    if (device == nullptr) {
+        co_return AssetLoadResult::Failure(fmt::format("texture '{}' upload recording failed", name));
+    }
+    if (prepared.Container.GetCompression() != TextureCompression::None &&
+        !device->GetDetail().IsBlockCompressionSupported) {
+        RADRAY_WARN_LOG("TextureAsset: device cannot sample BC textures, decompressing '{}'", name);
+        prepared = DecompressPreparedTexture(name, prepared.Container);
+        if (!prepared.Error.empty()) {
+            co_return AssetLoadResult::Failure(std::move(prepared.Error));
+        }
+    }
+    const uint32_t residentMip = streaming != nullptr ? PickTailMip(prepared.Container) : 0;
+    std::optional<UploadedTexture> uploaded = RecordInitialTextureUpload(frame, prepared.Container, residentMip, name);
     if (!uploaded.has_value()) {
         co_return AssetLoadResult::Failure(fmt::format("texture '{}' upload recording failed", name));
     }
-    render::Device* device = frame.GetUploader().GetDevice();
+    // 只有一级时没什么可流送的。
+    shared_ptr<TextureMipStream> stream;
+    if (streaming != nullptr && prepared.Container.GetMipCount() > 1) {
+        stream = make_shared<TextureMipStream>();
+        stream->Mapping = std::move(prepared.Mapping);
+        stream->Bytes = std::move(prepared.Bytes);
+        stream->Container = std::move(prepared.Container);
+        stream->TailMip = residentMip;
+    }
+    // 像素已录进 staging, 不流送时不必再陪协程跨帧等 fence。
+    prepared = {};
     co_await frame.WaitGpu();
 
-    co_return AssetLoadResult::Success(
-        make_unique<TextureAsset>(
-            device,
-            std::move(name),
-            std::move(uploaded->Texture),
-            std::move(uploaded->Srv)));
+    auto asset = make_unique<TextureAsset>(
+        device,
+        std::move(name),
+        std::move(uploaded->Texture),
+        std::move(uploaded->Srv),
+        residentMip,
+        stream);
+    if (stream != nullptr) {
+        stream->Asset = asset.get();
+        streaming->Register(std::move(stream));
+    }
+    co_return AssetLoadResult::Success(std::move(asset));
+}
+
+task<AssetLoadResult> LoadTextureFromImageTask(
+    FrameUploadScheduler& frameUploads,
+    AssetDecodePool* decodePool,
+    string name,
+    ImageData image,
+    TextureAssetLoadOptions options) {
+    const uint64_t bytes = EstimateTexturePrepareBytes(image.GetSize(), 0, options.GenerateMips);
+    PreparedTexture prepared = co_await RunOnAssetDecodePool(
+        decodePool,
+        bytes,
+        [name, image = std::move(image), options = std::move(options), decodePool]() mutable {
+            return PrepareTexture(name, std::move(image), options, decodePool);
+        });
+    co_return co_await UploadPreparedTextureTask(frameUploads, nullptr, std::move(name), std::move(prepared));
 }
 
 task<AssetLoadResult> LoadTextureFromMemoryTask(
     FrameUploadScheduler& frameUploads,
+    AssetDecodePool* decodePool,
     string name,
     vector<byte> encodedBytes,
     TextureAssetLoadOptions options) {
-    std::optional<ImageData> decoded = DecodeImageBytes(encodedBytes);
-    ImageData image;
-    if (decoded.has_value()) {
-        image = std::move(decoded.value());
-    } else if (options.FallbackImage.Data != nullptr) {
-        image = options.FallbackImage;
-    } else {
-        co_return AssetLoadResult::Failure(fmt::format("texture '{}' decode failed", name));
-    }
-    // 复用 image 路径(其内部再做 RGBA8 归一与上传)。
-    co_return co_await LoadTextureFromImageTask(
-        frameUploads, std::move(name), std::move(image), std::move(options));
+    const uint64_t bytes = EstimateEncodedTexturePrepareBytes(encodedBytes.size(), options.GenerateMips);
+    PreparedTexture prepared = co_await RunOnAssetDecodePool(
+        decodePool,
+        bytes,
+        [name, encodedBytes = std::move(encodedBytes), options = std::move(options), decodePool]() {
+            return DecodeAndPrepareTexture(name, encodedBytes, options, decodePool);
+        });
+    co_return co_await UploadPreparedTextureTask(frameUploads, nullptr, std::move(name), std::move(prepared));
 }
 
 }  // namespace
@@ -245,13 +441,17 @@ bool TextureImportSettings::Deserialize(const JsonValue& json) {
         return false;
     }
     const size_t knownMemberCount = static_cast<size_t>(object.Has("srgb")) +
-                                    static_cast<size_t>(object.Has("generateMips"));
+                                    static_cast<size_t>(object.Has("generateMips")) +
+                                    static_cast<size_t>(object.Has("mipFilter")) +
+                                    static_cast<size_t>(object.Has("compression"));
     if (json.Size() != knownMemberCount) {
         return false;
     }
     TextureImportSettings decoded;
     if (!object.MemberIfPresent("srgb", decoded.Srgb) ||
-        !object.MemberIfPresent("generateMips", decoded.GenerateMips)) {
+        !object.MemberIfPresent("generateMips", decoded.GenerateMips) ||
+        !object.MemberIfPresent("mipFilter", decoded.Filter) ||
+        !object.MemberIfPresent("compression", decoded.Compression)) {
         return false;
     }
     *this = decoded;
@@ -262,11 +462,21 @@ bool TextureImportSettings::Serialize(JsonWriteContext& context) const noexcept
     JsonObjectWriter object = context.BeginObject();
     return object.IsValid() &&
            object.Member("srgb", Srgb) &&
-           object.Member("generateMips", GenerateMips);
+           object.Member("generateMips", GenerateMips) &&
+           // 默认的 box / 不压缩不落盘, 既有 manifest 与 settings 哈希保持不变。
+           (Filter == MipFilter::Box || object.Member("mipFilter", Filter)) &&
+           (Compression == TextureCompression::None || object.Member("compression", Compression));
 }
 
-TextureImporter::TextureImporter(FrameUploadScheduler& frameUploads) noexcept
-    : _frameUploads(frameUploads) {
+TextureImporter::TextureImporter(
+    FrameUploadScheduler& frameUploads,
+    AssetDecodePool& decodePool,
+    DerivedDataCache* derivedData,
+    TextureStreamingManager* streaming) noexcept
+    : _frameUploads(frameUploads),
+      _decodePool(decodePool),
+      _derivedData(derivedData),
+      _streaming(streaming) {
 }
 
 std::string_view TextureImporter::GetTypeName() const noexcept {
@@ -274,34 +484,45 @@ std::string_view TextureImporter::GetTypeName() const noexcept {
 }
 
 std::span<const std::string_view> TextureImporter::GetFileExtensions() const noexcept {
-    static constexpr std::array<std::string_view, 3> extensions{".png", ".jpg", ".jpeg"};
+    static constexpr std::array<std::string_view, 4> extensions{".png", ".jpg", ".jpeg", ".rrtex"};
     return extensions;
 }
 
 task<AssetLoadResult> TextureImporter::LoadTyped(
     std::filesystem::path path,
     TextureImportSettings settings) {
-    std::optional<vector<byte>> encoded = ReadBinaryFile(path);
-    if (!encoded.has_value()) {
-        co_return AssetLoadResult::Failure(fmt::format("cannot read texture source '{}'", path.string()));
-    }
     TextureAssetLoadOptions options{
         .Srgb = settings.Srgb,
-        .GenerateMips = settings.GenerateMips};
-    co_return co_await CreateTextureAssetFromMemory(
-        _frameUploads,
-        path.filename().string(),
-        std::move(encoded.value()),
-        std::move(options));
+        .GenerateMips = settings.GenerateMips,
+        .Filter = settings.Filter,
+        .Compression = settings.Compression};
+    string name = path.filename().string();
+    // 只 stat 一次估算预算; 读文件本身也在 worker 上。
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(path, error);
+    const uint64_t sourceBytes = error ? 0 : fileSize;
+    // .rrtex 只映射不解码, 占用就是文件本身。
+    const uint64_t bytes = IsTextureContainerPath(path)
+                               ? sourceBytes
+                               : EstimateEncodedTexturePrepareBytes(sourceBytes, options.GenerateMips);
+    const uint64_t settingsHash = HashImportSettings(&settings);
+    PreparedTexture prepared = co_await _decodePool.Run(
+        bytes,
+        [path, name, options, derivedData = _derivedData, settingsHash, decodePool = &_decodePool]() {
+            return PrepareTextureFromSource(path, name, options, derivedData, settingsHash, decodePool);
+        });
+    co_return co_await UploadPreparedTextureTask(_frameUploads, _streaming, std::move(name), std::move(prepared));
 }
 
 task<AssetLoadResult> CreateTextureAssetFromImage(
     FrameUploadScheduler& frameUploads,
+    AssetDecodePool* decodePool,
     string name,
     ImageData image,
     TextureAssetLoadOptions options) {
     return LoadTextureFromImageTask(
         frameUploads,
+        decodePool,
         std::move(name),
         std::move(image),
         std::move(options));
@@ -309,11 +530,13 @@ task<AssetLoadResult> CreateTextureAssetFromImage(
 
 task<AssetLoadResult> CreateTextureAssetFromMemory(
     FrameUploadScheduler& frameUploads,
+    AssetDecodePool* decodePool,
     string name,
     vector<byte> encodedBytes,
     TextureAssetLoadOptions options) {
     return LoadTextureFromMemoryTask(
         frameUploads,
+        decodePool,
         std::move(name),
         std::move(encodedBytes),
         std::move(options));
@@ -323,16 +546,47 @@ TextureAsset::TextureAsset(
     render::Device* device,
     string name,
     unique_ptr<render::Texture> texture,
-    unique_ptr<render::TextureView> srv) noexcept
+    unique_ptr<render::TextureView> srv,
+    uint32_t residentMip,
+    shared_ptr<TextureMipStream> stream) noexcept
     : _device(device),
       _name(std::move(name)),
       _texture(std::move(texture)),
-      _srv(std::move(srv)) {
+      _srv(std::move(srv)),
+      _stream(std::move(stream)),
+      _residentMip(residentMip) {
+    if (_texture != nullptr) {
+        _format = _texture->GetDesc().Format;
+    }
+    if (_stream != nullptr) {
+        _width = _stream->Container.GetWidth();
+        _height = _stream->Container.GetHeight();
+        _mipCount = _stream->Container.GetMipCount();
+    } else if (_texture != nullptr) {
+        const render::TextureDescriptor desc = _texture->GetDesc();
+        _width = desc.Width;
+        _height = desc.Height;
+        _mipCount = std::max(desc.MipLevels, 1u);
+    }
 }
 
-TextureAsset::~TextureAsset() noexcept = default;
+TextureAsset::~TextureAsset() noexcept {
+    // 加载结果没被发布就丢弃时不会经过 OnUnload。
+    if (_stream != nullptr) {
+        std::lock_guard lock{_stream->Mutex};
+        _stream->Asset = nullptr;
+    }
+}
 
 void TextureAsset::OnUnload(AssetManager& manager) {
+    // 持锁置空: 管理器换贴图时也持这把锁, 之后它不会再碰本资产, 下面交出的就是最终的贴图。
+    if (_stream != nullptr) {
+        {
+            std::lock_guard lock{_stream->Mutex};
+            _stream->Asset = nullptr;
+        }
+        _stream.reset();
+    }
     // 【整包交出, 销毁顺序由 lambda 的成员声明顺序表达】: view 引用 texture, 故 view 必须
     // 先死。捕获列表里 views / srv 声明在 texture 之前, 而 lambda 的捕获成员按声明顺序
     // 构造、逆序析构 —— 这就是全部保证, 不依赖任何队列语义。
@@ -347,10 +601,48 @@ void TextureAsset::OnUnload(AssetManager& manager) {
     _name.clear();
 }
 
+RetiredTexture TextureAsset::ReplaceTexture(unique_ptr<render::Texture> texture, uint32_t residentMip) noexcept {
+    RetiredTexture retired;
+    if (_device == nullptr || texture == nullptr || residentMip >= _mipCount) {
+        retired.Texture = std::move(texture);
+        return retired;
+    }
+    unique_ptr<render::TextureView> srv = CreateDefaultSrv(_device, texture.get(), _name);
+    if (srv == nullptr) {
+        retired.Texture = std::move(texture);
+        return retired;
+    }
+    retired.Texture = std::move(_texture);
+    retired.Views.reserve(_viewCache.size() + 1);
+    retired.Views.push_back(std::move(_srv));
+    for (auto& [desc, view] : _viewCache) {
+        retired.Views.push_back(std::move(view));
+    }
+    _viewCache.clear();
+    _texture = std::move(texture);
+    _srv = std::move(srv);
+    _residentMip.store(residentMip, std::memory_order_release);
+    ++_viewVersion;
+    return retired;
+}
+
 RuntimeTypeId TextureAsset::GetTypeId() const noexcept {
     return runtime_type_id_v<TextureAsset>;
 }
 
+AssetMemorySize TextureAsset::GetMemorySize() const noexcept {
+    if (_texture == nullptr) {
+        return {};
+    }
+    // 按驻留的 mip 逐级累加, 不计 view 与驱动的对齐填充。块压缩格式按整块计。
+    // 只读构造时定下的完整链尺寸与驻留边界, 渲染侧换贴图时主线程照样可以估算。
+    uint64_t gpuBytes = 0;
+    for (uint32_t mip = GetResidentMip(); mip < _mipCount; ++mip) {
+        gpuBytes += GetTextureMipBytes(_format, _width, _height, mip);
+    }
+    return AssetMemorySize{.GpuBytes = gpuBytes};
+}
+
 render::TextureView* TextureAsset::GetOrCreateSrv(const TextureSubViewDesc& sub) noexcept {
     if (sub.IsDefault()) {
         return _srv.get();
@@ -358,17 +650,29 @@ render::TextureView* TextureAsset::GetOrCreateSrv(const TextureSubViewDesc& sub)
     if (_device == nullptr || _texture == nullptr) {
         return nullptr;
     }
-    if (auto it = _viewCache.find(sub); it != _viewCache.end()) {
+    // 裁掉尚未驻留的 mip, 裁剪后的描述即缓存键。整段都未驻留时退到驻留边界那一级。
+    const uint32_t residentMip = GetResidentMip();
+    TextureSubViewDesc resident = sub;
+    if (resident.Range.BaseMipLevel < residentMip) {
+        const uint32_t skipped = residentMip - resident.Range.BaseMipLevel;
+        resident.Range.BaseMipLevel = residentMip;
+        if (resident.Range.MipLevelCount != render::SubresourceRange::All) {
+            resident.Range.MipLevelCount = std::max(resident.Range.MipLevelCount, skipped + 1) - skipped;
+        }
+    }
+    if (auto it = _viewCache.find(resident); it != _viewCache.end()) {
         return it->second.get();
     }
-    // Format::UNKNOWN 表示沿用底层贴图格式。
+    // Format::UNKNOWN 表示沿用底层贴图格式。底层贴图只含驻留的几级, mip 级别换算到它的下标。
     const render::TextureFormat format =
-        sub.Format == render::TextureFormat::UNKNOWN ? _texture->GetDesc().Format : sub.Format;
+        resident.Format == render::TextureFormat::UNKNOWN ? _texture->GetDesc().Format : resident.Format;
+    render::SubresourceRange range = resident.Range;
+    range.BaseMipLevel -= residentMip;
     render::TextureViewDescriptor viewDesc{
         .Target = _texture.get(),
-        .Dim = sub.Dim,
+        .Dim = resident.Dim,
         .Format = format,
-        .Range = sub.Range,
+        .Range = range,
         .Usage = render::TextureViewUsage::Resource};
     auto viewOpt = _device->CreateTextureView(viewDesc);
     if (!viewOpt.HasValue()) {
@@ -378,33 +682,35 @@ render::TextureView* TextureAsset::GetOrCreateSrv(const TextureSubViewDesc& sub)
     auto view = viewOpt.Release();
     view->SetDebugName(fmt::format("texasset_subsrv_{}", _name));
     render::TextureView* raw = view.get();
-    _viewCache.emplace(sub, std::move(view));
+    _viewCache.emplace(resident, std::move(view));
     return raw;
 }
 
 StreamingAssetRef<TextureAsset> LoadTextureAssetFromImage(
     AssetManager& assetManager,
     FrameUploadScheduler& frameUploads,
+    AssetDecodePool* decodePool,
     const AssetId& assetId,
     string name,
     ImageData image,
     const TextureAssetLoadOptions& options) {
     return assetManager.Load<TextureAsset>(AssetLoadRequest{
         .Id = assetId,
-        .Task = CreateTextureAssetFromImage(frameUploads, name, std::move(image), options),
+        .Task = CreateTextureAssetFromImage(frameUploads, decodePool, name, std::move(image), options),
         .DebugName = std::move(name)});
 }
 
 StreamingAssetRef<TextureAsset> LoadTextureAssetFromMemory(
     AssetManager& assetManager,
     FrameUploadScheduler& frameUploads,
+    AssetDecodePool* decodePool,
     const AssetId& assetId,
     string name,
     vector<byte> encodedBytes,
     const TextureAssetLoadOptions& options) {
     return assetManager.Load<TextureAsset>(AssetLoadRequest{
         .Id = assetId,
-        .Task = CreateTextureAssetFromMemory(frameUploads, name, std::move(encodedBytes), options),
+        .Task = CreateTextureAssetFromMemory(frameUploads, decodePool, name, std::move(encodedBytes), options),
         .DebugName = std::move(name)});
 }
 
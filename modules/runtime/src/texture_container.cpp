@@ -0,0 +1,204 @@
+#include <radray/runtime/texture_container.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include <radray/basic_math.h>
+#include <radray/binary_io.h>
+#include <radray/logger.h>
+#include <radray/mip_chain.h>
+
+namespace radray {
+namespace {
+
+constexpr size_t kHeaderSize = 32;
+constexpr size_t kMipEntrySize = 24;
+constexpr uint8_t kFlagSrgb = 1u << 0;
+
+/// 一级 mip 的紧密行宽与行数。"行"对块压缩格式是一行 4x4 块。
+struct MipRows {
+    uint32_t Width{0};
+    uint32_t Height{0};
+    uint64_t TightRowPitch{0};
+    uint32_t RowCount{0};
+};
+
+MipRows GetMipRows(TextureCompression compression, uint32_t width, uint32_t height, uint32_t mipLevel) noexcept {
+    const uint32_t mipWidth = std::max(width >> mipLevel, 1u);
+    const uint32_t mipHeight = std::max(height >> mipLevel, 1u);
+    const std::optional<BlockFormat> blockFormat = ToBlockFormat(compression);
+    if (!blockFormat.has_value()) {
+        return MipRows{mipWidth, mipHeight, uint64_t{mipWidth} * 4, mipHeight};
+    }
+    return MipRows{
+        mipWidth,
+        mipHeight,
+        uint64_t{(mipWidth + 3) / 4} * GetBlockFormatBytes(blockFormat.value()),
+        (mipHeight + 3) / 4};
+}
+
+bool IsValidAlignment(uint32_t alignment) noexcept {
+    return alignment != 0 && std::has_single_bit(alignment);
+}
+
+}  // namespace
+
+std::optional<BlockFormat> ToBlockFormat(TextureCompression compression) noexcept {
+    switch (compression) {
+        case TextureCompression::BC1: return BlockFormat::BC1;
+        case TextureCompression::BC3: return BlockFormat::BC3;
+        case TextureCompression::BC4: return BlockFormat::BC4;
+        case TextureCompression::BC5: return BlockFormat::BC5;
+        case TextureCompression::BC7: return BlockFormat::BC7;
+        case TextureCompression::None: break;
+    }
+    return std::nullopt;
+}
+
+render::TextureFormat GetTextureContainerFormat(TextureCompression compression, bool srgb) noexcept {
+    switch (compression) {
+        case TextureCompression::BC1: return srgb ? render::TextureFormat::BC1_UNORM_SRGB : render::TextureFormat::BC1_UNORM;
+        case TextureCompression::BC3: return srgb ? render::TextureFormat::BC3_UNORM_SRGB : render::TextureFormat::BC3_UNORM;
+        case TextureCompression::BC4: return render::TextureFormat::BC4_UNORM;
+        case TextureCompression::BC5: return render::TextureFormat::BC5_UNORM;
+        case TextureCompression::BC7: return srgb ? render::TextureFormat::BC7_UNORM_SRGB : render::TextureFormat::BC7_UNORM;
+        case TextureCompression::None: break;
+    }
+    return srgb ? render::TextureFormat::RGBA8_UNORM_SRGB : render::TextureFormat::RGBA8_UNORM;
+}
+
+std::optional<TextureContainer> TextureContainer::Parse(std::span<const byte> bytes) noexcept {
+    BinaryReader reader{bytes};
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mipCount = 0;
+    uint8_t compression = 0;
+    uint8_t flags = 0;
+    uint8_t reserved0 = 0;
+    uint8_t reserved1 = 0;
+    uint32_t rowPitchAlignment = 0;
+    uint32_t placementAlignment = 0;
+    if (!reader.U32(magic) || magic != kMagic ||
+        !reader.U32(version) || version != kVersion ||
+        !reader.U32(width) || !reader.U32(height) || !reader.U32(mipCount) ||
+        !reader.U8(compression) || !reader.U8(flags) || !reader.U8(reserved0) || !reader.U8(reserved1) ||
+        !reader.U32(rowPitchAlignment) || !reader.U32(placementAlignment)) {
+        return std::nullopt;
+    }
+    if (width == 0 || height == 0 || mipCount == 0 || mipCount > GetFullMipLevelCount(width, height) ||
+        compression > static_cast<uint8_t>(TextureCompression::BC7) ||
+        !IsValidAlignment(rowPitchAlignment) || !IsValidAlignment(placementAlignment)) {
+        return std::nullopt;
+    }
+    TextureContainer container;
+    container._bytes = bytes;
+    container._width = width;
+    container._height = height;
+    container._compression = static_cast<TextureCompression>(compression);
+    container._srgb = (flags & kFlagSrgb) != 0;
+    container._mips.resize(mipCount);
+    const uint64_t tableEnd = kHeaderSize + uint64_t{mipCount} * kMipEntrySize;
+    for (uint32_t mipLevel = 0; mipLevel < mipCount; ++mipLevel) {
+        TextureContainerMip& mip = container._mips[mipLevel];
+        if (!reader.U64(mip.Offset) || !reader.U64(mip.Size) || !reader.U32(mip.RowPitch) || !reader.U32(mip.RowCount)) {
+            return std::nullopt;
+        }
+        const MipRows rows = GetMipRows(container._compression, width, height, mipLevel);
+        mip.Width = rows.Width;
+        mip.Height = rows.Height;
+        if (mip.RowCount != rows.RowCount || mip.RowPitch < rows.TightRowPitch || mip.RowPitch % rowPitchAlignment != 0 ||
+            mip.Size != uint64_t{mip.RowPitch} * mip.RowCount ||
+            mip.Offset < tableEnd || mip.Offset % placementAlignment != 0 ||
+            mip.Offset > bytes.size() || mip.Size > bytes.size() - mip.Offset) {
+            return std::nullopt;
+        }
+    }
+    return container;
+}
+
+std::span<const byte> TextureContainer::GetMipData(uint32_t mipLevel) const noexcept {
+    const TextureContainerMip& mip = _mips[mipLevel];
+    return _bytes.subspan(mip.Offset, mip.Size);
+}
+
+vector<byte> EncodeTextureContainer(
+    uint32_t width,
+    uint32_t height,
+    TextureCompression compression,
+    bool srgb,
+    std::span<const std::span<const byte>> levels,
+    const TextureContainerLayout& layout) {
+    const auto mipCount = static_cast<uint32_t>(levels.size());
+    if (width == 0 || height == 0 || mipCount == 0 || mipCount > GetFullMipLevelCount(width, height) ||
+        !IsValidAlignment(layout.RowPitchAlignment) || !IsValidAlignment(layout.PlacementAlignment)) {
+        RADRAY_ERR_LOG("EncodeTextureContainer: invalid {}x{} texture with {} mips", width, height, mipCount);
+        return {};
+    }
+    // 先排版: 从最小一级开始依次往后放。
+    vector<TextureContainerMip> mips(mipCount);
+    uint64_t offset = Align(kHeaderSize + uint64_t{mipCount} * kMipEntrySize, layout.PlacementAlignment);
+    uint64_t totalSize = offset;
+    for (uint32_t mipLevel = mipCount; mipLevel-- > 0;) {
+        const MipRows rows = GetMipRows(compression, width, height, mipLevel);
+        if (levels[mipLevel].size() != rows.TightRowPitch * rows.RowCount) {
+            RADRAY_ERR_LOG(
+                "EncodeTextureContainer: mip {} has {} bytes, expected {}",
+                mipLevel,
+                levels[mipLevel].size(),
+                rows.TightRowPitch * rows.RowCount);
+            return {};
+        }
+        TextureContainerMip& mip = mips[mipLevel];
+        mip.Width = rows.Width;
+        mip.Height = rows.Height;
+        mip.RowPitch = static_cast<uint32_t>(Align(rows.TightRowPitch, layout.RowPitchAlignment));
+        mip.RowCount = rows.RowCount;
+        mip.Size = uint64_t{mip.RowPitch} * mip.RowCount;
+        mip.Offset = offset;
+        totalSize = offset + mip.Size;
+        offset = Align(totalSize, layout.PlacementAlignment);
+    }
+
+    BinaryWriter writer{kHeaderSize + size_t{mipCount} * kMipEntrySize};
+    writer.U32(TextureContainer::kMagic);
+    writer.U32(TextureContainer::kVersion);
+    writer.U32(width);
+    writer.U32(height);
+    writer.U32(mipCount);
+    writer.U8(static_cast<uint8_t>(compression));
+    writer.U8(srgb ? kFlagSrgb : 0);
+    writer.U8(0);
+    writer.U8(0);
+    writer.U32(layout.RowPitchAlignment);
+    writer.U32(layout.PlacementAlignment);
+    for (const TextureContainerMip& mip : mips) {
+        writer.U64(mip.Offset);
+        writer.U64(mip.Size);
+        writer.U32(mip.RowPitch);
+        writer.U32(mip.RowCount);
+    }
+    const std::span<const byte> header = writer.GetData();
+
+    // 补齐字节保持为 0, 同一输入总是产出同样的文件。
+    vector<byte> bytes(totalSize);
+    std::memcpy(bytes.data(), header.data(), header.size());
+    for (uint32_t mipLevel = 0; mipLevel < mipCount; ++mipLevel) {
+        const TextureContainerMip& mip = mips[mipLevel];
+        const uint64_t tightRowPitch = levels[mipLevel].size() / mip.RowCount;
+        const byte* src = levels[mipLevel].data();
+        byte* dst = bytes.data() + mip.Offset;
+        if (tightRowPitch == mip.RowPitch) {
+            std::memcpy(dst, src, levels[mipLevel].size());
+            continue;
+        }
+        for (uint32_t row = 0; row < mip.RowCount; ++row) {
+            std::memcpy(dst + size_t{row} * mip.RowPitch, src + row * tightRowPitch, tightRowPitch);
+        }
+    }
+    return bytes;
+}
+
+}  // namespace radray
@@ -0,0 +1,443 @@
+#include <radray/runtime/texture_streaming.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include <fmt/format.h>
+
+#include <radray/logger.h>
+#include <radray/profiler.h>
+#include <radray/runtime/gpu_system.h>
+#include <radray/runtime/texture_asset.h>
+
+namespace radray {
+namespace {
+
+uint64_t ResolveVramBudget(uint64_t requested, uint64_t deviceVramBudget) noexcept {
+    if (requested != 0) {
+        return requested;
+    }
+    return deviceVramBudget != 0 ? deviceVramBudget / 2 : std::numeric_limits<uint64_t>::max();
+}
+
+uint64_t SumMipBytes(std::span<const uint64_t> mipBytes, uint32_t firstMip) noexcept {
+    uint64_t bytes = 0;
+    for (size_t mip = firstMip; mip < mipBytes.size(); ++mip) {
+        bytes += mipBytes[mip];
+    }
+    return bytes;
+}
+
+/// 在 upload phase 内建只含 [targetMip, 链尾) 的新贴图: 与旧贴图重叠的那几级在 GPU 上拷过去,
+/// 更精细的几级从容器上传。失败返回 nullptr, 旧贴图不受影响。
+unique_ptr<render::Texture> RecordTransition(
+    const FrameUploadScope& frame,
+    const TextureContainer& container,
+    render::Texture* source,
+    uint32_t sourceMip,
+    uint32_t targetMip,
+    std::string_view debugName) {
+    render::Device* device = frame.GetUploader().GetDevice();
+    const TextureContainerMip& top = container.GetMip(targetMip);
+    render::TextureDescriptor texDesc{
+        .Dim = render::TextureDimension::Dim2D,
+        .Width = top.Width,
+        .Height = top.Height,
+        .DepthOrArraySize = 1,
+        .MipLevels = container.GetMipCount() - targetMip,
+        .SampleCount = 1,
+        .Format = container.GetFormat(),
+        .Memory = render::MemoryType::Device,
+        .Usage = render::TextureUse::Resource | render::TextureUse::CopySource | render::TextureUse::CopyDestination,
+        .Hints = render::ResourceHint::None};
+    auto texOpt = device->CreateTexture(texDesc);
+    if (!texOpt.HasValue()) {
+        RADRAY_ERR_LOG("TextureStreamingManager: CreateTexture failed for '{}' at mip {}", debugName, targetMip);
+        return nullptr;
+    }
+    auto texture = texOpt.Release();
+    texture->SetDebugName(fmt::format("texasset_{}_mip{}", debugName, targetMip));
+
+    render::CommandBuffer* cmd = frame.GetCommandBuffer();
+    const std::array<render::ResourceBarrierDescriptor, 2> toCopy{
+        render::BarrierTextureDescriptor{
+            .Target = source,
+            .Before = render::TextureState::ShaderRead,
+            .After = render::TextureState::CopySource},
+        render::BarrierTextureDescriptor{
+            .Target = texture.get(),
+            .Before = render::TextureState::Undefined,
+            .After = render::TextureState::CopyDestination}};
+    cmd->ResourceBarrier(toCopy);
+    for (uint32_t mip = std::max(sourceMip, targetMip); mip < container.GetMipCount(); ++mip) {
+        const TextureContainerMip& level = container.GetMip(mip);
+        cmd->CopyTextureToTexture(render::TextureCopyDescriptor{
+            .Destination = texture.get(),
+            .DestinationMipLevel = mip - targetMip,
+            .Source = source,
+            .SourceMipLevel = mip - sourceMip,
+            .Width = level.Width,
+            .Height = level.Height});
+    }
+    const std::array<render::ResourceBarrierDescriptor, 2> toRead{
+        render::BarrierTextureDescriptor{
+            .Target = source,
+            .Before = render::TextureState::CopySource,
+            .After = render::TextureState::ShaderRead},
+        render::BarrierTextureDescriptor{
+            .Target = texture.get(),
+            .Before = render::TextureState::CopyDestination,
+            .After = render::TextureState::ShaderRead}};
+    cmd->ResourceBarrier(toRead);
+    if (targetMip < sourceMip) {
+        RecordTextureMipUploads(frame, texture.get(), container, targetMip, targetMip, sourceMip, false);
+    }
+    return texture;
+}
+
+}  // namespace
+
+uint64_t GetTextureMipBytes(render::TextureFormat format, uint32_t width, uint32_t height, uint32_t mipLevel) noexcept {
+    const render::TextureFormatBlockInfo block = render::GetTextureFormatBlockInfo(format);
+    const uint64_t blocksWide = (std::max(width >> mipLevel, 1u) + block.Width - 1) / block.Width;
+    const uint64_t blocksHigh = (std::max(height >> mipLevel, 1u) + block.Height - 1) / block.Height;
+    return blocksWide * blocksHigh * block.Bytes;
+}
+
+uint32_t ComputeRequiredTextureMip(uint32_t width, uint32_t height, uint32_t mipCount, float pixelsPerUv) noexcept {
+    if (mipCount == 0) {
+        return 0;
+    }
+    const uint32_t lastMip = mipCount - 1;
+    if (!(pixelsPerUv > 0.0f)) {
+        return lastMip;
+    }
+    // 1 UV 单位横跨整张 mip 0, 每个屏幕像素覆盖 texelsPerPixel 个 texel, 需要的就是让它回到 1 的那一级。
+    const float texelsPerPixel = static_cast<float>(std::max(width, height)) / pixelsPerUv;
+    if (!(texelsPerPixel > 1.0f)) {
+        return 0;
+    }
+    const float mip = std::floor(std::log2(texelsPerPixel));
+    return mip >= static_cast<float>(lastMip) ? lastMip : static_cast<uint32_t>(mip);
+}
+
+float ComputeTexturePixelsPerUv(float uvDensity, float worldScale, float distance, float pixelsPerUnit) noexcept {
+    if (!(uvDensity > 0.0f) || !(worldScale > 0.0f) || !(distance > 0.0f)) {
+        return 0.0f;
+    }
+    return uvDensity * worldScale * pixelsPerUnit / distance;
+}
+
+vector<uint32_t> PlanTextureStreaming(
+    std::span<const TextureStreamingCandidate> candidates,
+    const TextureStreamingBudget& budget) {
+    const size_t count = candidates.size();
+    vector<uint32_t> targets(count);
+    uint64_t residentBytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        targets[i] = candidates[i].ResidentMip;
+        residentBytes += SumMipBytes(candidates[i].MipBytes, candidates[i].ResidentMip);
+    }
+
+    // 最该淘汰一级的 candidate: 多余级数最多, 其次 Priority 最低。surplusOnly 时不碰
+    // 驻留还不够的贴图。没有可淘汰的返回 count。
+    auto pickEviction = [&](size_t skip, bool surplusOnly) {
+        size_t best = count;
+        int64_t bestSurplus = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const TextureStreamingCandidate& candidate = candidates[i];
+            if (i == skip || candidate.Busy || targets[i] >= candidate.TailMip) {
+                continue;
+            }
+            const int64_t surplus = int64_t{candidate.WantedMip} - int64_t{targets[i]};
+            if (surplusOnly && surplus <= 0) {
+                continue;
+            }
+            if (best == count || surplus > bestSurplus ||
+                (surplus == bestSurplus && candidate.Priority < candidates[best].Priority)) {
+                best = i;
+                bestSurplus = surplus;
+            }
+        }
+        return best;
+    };
+    auto evictOne = [&](size_t i) {
+        residentBytes -= candidates[i].MipBytes[targets[i]];
+        ++targets[i];
+    };
+
+    while (residentBytes > budget.VramBytes) {
+        const size_t victim = pickEviction(count, false);
+        if (victim == count) {
+            break;
+        }
+        evictOne(victim);
+    }
+
+    vector<size_t> order;
+    for (size_t i = 0; i < count; ++i) {
+        const TextureStreamingCandidate& candidate = candidates[i];
+        if (!candidate.Busy && targets[i] == candidate.ResidentMip && candidate.WantedMip < candidate.ResidentMip) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        const uint32_t lhsDeficit = candidates[lhs].ResidentMip - candidates[lhs].WantedMip;
+        const uint32_t rhsDeficit = candidates[rhs].ResidentMip - candidates[rhs].WantedMip;
+        if (lhsDeficit != rhsDeficit) {
+            return lhsDeficit > rhsDeficit;
+        }
+        return candidates[lhs].Priority > candidates[rhs].Priority;
+    });
+    uint64_t uploadBytes = 0;
+    for (size_t i : order) {
+        const TextureStreamingCandidate& candidate = candidates[i];
+        while (targets[i] > candidate.WantedMip) {
+            const uint64_t bytes = candidate.MipBytes[targets[i] - 1];
+            if (uploadBytes > 0 && uploadBytes + bytes > budget.UploadBytesPerFrame) {
+                return targets;
+            }
+            while (residentBytes + bytes > budget.VramBytes) {
+                const size_t victim = pickEviction(i, true);
+                if (victim == count) {
+                    break;
+                }
+                evictOne(victim);
+            }
+            if (residentBytes + bytes > budget.VramBytes) {
+                break;
+            }
+            --targets[i];
+            residentBytes += bytes;
+            uploadBytes += bytes;
+        }
+    }
+    return targets;
+}
+
+void RecordTextureMipUploads(
+    const FrameUploadScope& frame,
+    render::Texture* texture,
+    const TextureContainer& container,
+    uint32_t textureBaseMip,
+    uint32_t firstMip,
+    uint32_t endMip,
+    bool firstUpload) {
+    for (uint32_t mipLevel = endMip; mipLevel-- > firstMip;) {
+        TextureUploadRequest request{};
+        request.SrcData = container.GetMipData(mipLevel);
+        request.DstTexture = texture;
+        request.DstRange = render::SubresourceRange{
+            .BaseArrayLayer = 0,
+            .ArrayLayerCount = 1,
+            .BaseMipLevel = mipLevel - textureBaseMip,
+            .MipLevelCount = 1};
+        request.SrcRowPitch = container.GetMip(mipLevel).RowPitch;
+        // 上传的屏障覆盖整张贴图, 只有贴图的第一次上传从 Undefined 出发。
+        request.Before = firstUpload && mipLevel == endMip - 1
+                             ? render::TextureState::Undefined
+                             : render::TextureState::ShaderRead;
+        request.After = render::TextureState::ShaderRead;
+        frame.GetUploader().UploadTexture(frame.GetCommandBuffer(), request);
+    }
+}
+
+TextureStreamingManager::TextureStreamingManager(
+    FrameUploadScheduler& frameUploads,
+    uint64_t deviceVramBudget,
+    const TextureStreamingDescriptor& desc) noexcept
+    : _frameUploads(frameUploads),
+      _uploadBytesPerFrame(desc.UploadBytesPerFrame),
+      _requestHoldFrames(desc.RequestHoldFrames),
+      _vramBudget(ResolveVramBudget(desc.VramBudget, deviceVramBudget)) {
+}
+
+TextureStreamingManager::~TextureStreamingManager() noexcept = default;
+
+void TextureStreamingManager::Register(shared_ptr<TextureMipStream> stream) {
+    if (stream == nullptr || stream->Asset == nullptr || stream->Container.GetMipCount() == 0) {
+        return;
+    }
+    const TextureContainer& container = stream->Container;
+    Entry entry;
+    entry.MipBytes.reserve(container.GetMipCount());
+    for (uint32_t mip = 0; mip < container.GetMipCount(); ++mip) {
+        entry.MipBytes.push_back(GetTextureMipBytes(container.GetFormat(), container.GetWidth(), container.GetHeight(), mip));
+    }
+    entry.ResidentMip = stream->TailMip;
+    entry.WantedMip = stream->TailMip;
+    const TextureAsset* key = stream->Asset;
+    entry.Stream = std::move(stream);
+    std::lock_guard lock{_mutex};
+    entry.LastRequestFrame = _frame;
+    _entries.insert_or_assign(key, std::move(entry));
+}
+
+void TextureStreamingManager::Request(const TextureAsset* texture, float pixelsPerUv) noexcept {
+    if (texture == nullptr || !(pixelsPerUv > 0.0f)) {
+        return;
+    }
+    std::lock_guard lock{_mutex};
+    auto it = _entries.find(texture);
+    if (it != _entries.end()) {
+        it->second.PendingPixelsPerUv = std::max(it->second.PendingPixelsPerUv, pixelsPerUv);
+    }
+}
+
+void TextureStreamingManager::Update() {
+    RADRAY_PROFILE_SCOPE("TextureStreamingManager::Update");
+    vector<Transition> batch;
+    {
+        std::lock_guard lock{_mutex};
+        ++_frame;
+        // 已卸载的资产出表。在途批次的条目留到批次结束, 由它清掉 Busy 后下一帧再出表。
+        std::erase_if(_entries, [](const auto& item) {
+            const Entry& entry = item.second;
+            if (entry.Busy) {
+                return false;
+            }
+            std::lock_guard streamLock{entry.Stream->Mutex};
+            return entry.Stream->Asset == nullptr;
+        });
+
+        vector<TextureStreamingCandidate> candidates;
+        vector<std::pair<const TextureAsset*, Entry*>> entries;
+        candidates.reserve(_entries.size());
+        entries.reserve(_entries.size());
+        uint64_t residentBytes = 0;
+        uint64_t requestedBytes = 0;
+        for (auto& [key, entry] : _entries) {
+            const TextureMipStream& stream = *entry.Stream;
+            if (entry.PendingPixelsPerUv > 0.0f) {
+                entry.PixelsPerUv = entry.PendingPixelsPerUv;
+                entry.PendingPixelsPerUv = 0.0f;
+                entry.LastRequestFrame = _frame;
+                const uint32_t required = ComputeRequiredTextureMip(
+                    stream.Container.GetWidth(),
+                    stream.Container.GetHeight(),
+                    stream.Container.GetMipCount(),
+                    entry.PixelsPerUv);
+                entry.WantedMip = std::min(required, stream.TailMip);
+            } else if (_frame - entry.LastRequestFrame > _requestHoldFrames) {
+                entry.PixelsPerUv = 0.0f;
+                entry.WantedMip = stream.TailMip;
+            }
+            residentBytes += SumMipBytes(entry.MipBytes, entry.ResidentMip);
+            requestedBytes += SumMipBytes(entry.MipBytes, entry.WantedMip);
+            candidates.push_back(TextureStreamingCandidate{
+                .MipBytes = entry.MipBytes,
+                .ResidentMip = entry.ResidentMip,
+                .WantedMip = entry.WantedMip,
+                .TailMip = stream.TailMip,
+                .Priority = entry.PixelsPerUv,
+                .Busy = entry.Busy});
+            entries.emplace_back(key, &entry);
+        }
+        RADRAY_PROFILE_COUNTER("TextureStreaming::ResidentBytes", residentBytes);
+        RADRAY_PROFILE_COUNTER("TextureStreaming::RequestedBytes", requestedBytes);
+
+        const vector<uint32_t> targets = PlanTextureStreaming(
+            candidates,
+            TextureStreamingBudget{.VramBytes = _vramBudget, .UploadBytesPerFrame = _uploadBytesPerFrame});
+        for (size_t i = 0; i < entries.size(); ++i) {
+            auto [key, entry] = entries[i];
+            if (targets[i] == entry->ResidentMip) {
+                continue;
+            }
+            std::lock_guard streamLock{entry->Stream->Mutex};
+            // 不在批次里的条目只由本管理器换贴图, 这里读到的就是当前贴图。
+            TextureAsset* asset = entry->Stream->Asset;
+            if (asset == nullptr || asset->GetTexture() == nullptr) {
+                continue;
+            }
+            batch.push_back(Transition{
+                .Key = key,
+                .Stream = entry->Stream,
+                .DebugName = string{asset->GetName()},
+                .Source = asset->GetTexture(),
+                .SourceMip = entry->ResidentMip,
+                .TargetMip = targets[i]});
+            entry->Busy = true;
+        }
+    }
+    if (!batch.empty()) {
+        RADRAY_PROFILE_COUNTER("TextureStreaming::Transitions", batch.size());
+        _batchScope.Spawn(RunBatch(std::move(batch)));
+    }
+}
+
+task<void> TextureStreamingManager::RunBatch(vector<Transition> batch) {
+    {
+        FrameUploadScope frame = co_await _frameUploads.BeginUpload();
+        for (Transition& transition : batch) {
+            // 规划之后资产可能已卸载, 旧贴图随之进了延迟销毁, 不能再当拷贝源。
+            std::lock_guard streamLock{transition.Stream->Mutex};
+            if (transition.Stream->Asset == nullptr) {
+                continue;
+            }
+            transition.Texture = RecordTransition(
+                frame,
+                transition.Stream->Container,
+                transition.Source,
+                transition.SourceMip,
+                transition.TargetMip,
+                transition.DebugName);
+        }
+        co_await frame.WaitGpu();
+    }
+
+    // 新贴图已就绪。换进资产放在下一个 upload phase: 渲染线程此时还没开始录制这一帧,
+    // 材质取 view 不会与换贴图交错。
+    FrameUploadScope frame = co_await _frameUploads.BeginUpload();
+    vector<RetiredTexture> retired;
+    retired.reserve(batch.size());
+    {
+        std::lock_guard lock{_mutex};
+        for (Transition& transition : batch) {
+            uint32_t residentMip = transition.SourceMip;
+            {
+                std::lock_guard streamLock{transition.Stream->Mutex};
+                TextureAsset* asset = transition.Stream->Asset;
+                if (asset != nullptr && transition.Texture != nullptr) {
+                    retired.push_back(asset->ReplaceTexture(std::move(transition.Texture), transition.TargetMip));
+                    residentMip = asset->GetResidentMip();
+                } else {
+                    retired.push_back(RetiredTexture{.Texture = std::move(transition.Texture)});
+                }
+            }
+            auto it = _entries.find(transition.Key);
+            if (it != _entries.end() && it->second.Stream == transition.Stream) {
+                it->second.ResidentMip = residentMip;
+                it->second.Busy = false;
+            }
+        }
+    }
+    // 换下的贴图与 view 可能还被上一帧的命令引用, 再等一个 fence 才随协程帧释放。
+    co_await frame.WaitGpu();
+}
+
+void TextureStreamingManager::SetVramBudget(uint64_t bytes) noexcept {
+    std::lock_guard lock{_mutex};
+    _vramBudget = bytes;
+}
+
+uint64_t TextureStreamingManager::GetVramBudget() const noexcept {
+    std::lock_guard lock{_mutex};
+    return _vramBudget;
+}
+
+TextureStreamingStats TextureStreamingManager::GetStats() const noexcept {
+    std::lock_guard lock{_mutex};
+    TextureStreamingStats stats{};
+    stats.TextureCount = static_cast<uint32_t>(_entries.size());
+    stats.VramBudget = _vramBudget;
+    for (const auto& [key, entry] : _entries) {
+        stats.ResidentBytes += SumMipBytes(entry.MipBytes, entry.ResidentMip);
+        stats.RequestedBytes += SumMipBytes(entry.MipBytes, entry.WantedMip);
+    }
+    return stats;
+}
+
+}  // namespace radray
@@ -1,7 +1,10 @@
 #include <radray/runtime/asset_database.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <filesystem>
+#include <initializer_list>
 #include <string_view>
 #include <system_error>
 
@@ -10,6 +13,7 @@
 #include <fmt/format.h>
 
 #include <radray/file.h>
+#include <radray/runtime/asset_decode_pool.h>
 #include <radray/runtime/gpu_system.h>
 #include <radray/runtime/texture_asset.h>
 
@@ -252,6 +256,9 @@ TEST_F(AssetDatabaseTest, StructuralManifestErrorsFailOpen) {
         fmt::format(R"({{"version":1,"assets":[{{"guid":"{}","path":"a.test","path":"b.test","type":"test"}}]}})", guid),
         fmt::format(R"({{"version":1,"assets":[{{"guid":"{}","path":"a.test","type":"test","type":"future"}}]}})", guid),
         fmt::format(R"({{"version":1,"assets":[{{"guid":"{}","path":"a.test","type":"test","settings":{{}},"settings":{{}}}}]}})", guid),
+        fmt::format(R"({{"version":1,"assets":[{{"guid":"{}","path":"a.test","type":"test","dependencies":"{}"}}]}})", guid, guid),
+        fmt::format(R"({{"version":1,"assets":[{{"guid":"{}","path":"a.test","type":"test","dependencies":["bad"]}}]}})", guid),
+        fmt::format(R"({{"version":1,"assets":[{{"guid":"{}","path":"a.test","type":"test","dependencies":[],"dependencies":[]}}]}})", guid),
     };
 
     for (size_t index = 0; index < invalidManifests.size(); ++index) {
@@ -263,6 +270,185 @@ TEST_F(AssetDatabaseTest, StructuralManifestErrorsFailOpen) {
     }
 }
 
+TEST_F(AssetDatabaseTest, ReopeningMapsTheBinaryIndexAndDecodesEntriesLazily) {
+    const string unknownRaw = R"({ "future" : 1.50 })";
+    string error;
+    std::optional<AssetId> typed;
+    std::optional<AssetId> unknown;
+    {
+        unique_ptr<AssetDatabase> database = Open(error);
+        ASSERT_NE(database, nullptr) << error;
+        typed = database->AddEntry("Textures/Wall.test", "test", error);
+        unknown = database->AddEntry("unknown.bin", "unknown", error);
+        ASSERT_TRUE(typed.has_value() && unknown.has_value()) << error;
+        database->MutableSettings<TestImportSettings>(typed.value())->Scale = 7;
+        const AssetId dependency[]{unknown.value()};
+        ASSERT_TRUE(database->SetDependencies(typed.value(), dependency, error)) << error;
+        ASSERT_TRUE(database->Save(error)) << error;
+    }
+    ASSERT_TRUE(std::filesystem::exists(Root() / "assets.index"));
+
+    unique_ptr<AssetDatabase> reopened = Open(error);
+    ASSERT_NE(reopened, nullptr) << error;
+    EXPECT_TRUE(reopened->IsIndexBacked());
+    EXPECT_EQ(reopened->ResolveId("textures/wall.TEST"), typed);
+    const AssetEntry* entry = reopened->Find("TEXTURES/WALL.test");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->Guid, typed.value());
+    EXPECT_EQ(entry->Path, "Textures/Wall.test");
+    ASSERT_NE(GetSettings<TestImportSettings>(*entry), nullptr);
+    EXPECT_EQ(GetSettings<TestImportSettings>(*entry)->Scale, 7u);
+    EXPECT_EQ(entry->Dependencies, (vector<AssetId>{unknown.value()}));
+    EXPECT_EQ(reopened->Find(typed.value()), entry) << "a materialized entry is reused";
+    EXPECT_EQ(reopened->Find(Guid::NewGuid()), nullptr);
+    EXPECT_EQ(reopened->Find("missing.test"), nullptr);
+}
+
+TEST_F(AssetDatabaseTest, IndexBackedDatabaseSupportsEditsWithoutMaterializingFirst) {
+    string error;
+    std::optional<AssetId> first;
+    std::optional<AssetId> second;
+    std::optional<AssetId> removed;
+    {
+        unique_ptr<AssetDatabase> database = Open(error);
+        ASSERT_NE(database, nullptr) << error;
+        first = database->AddEntry("first.test", "test", error);
+        second = database->AddEntry("second.test", "test", error);
+        removed = database->AddEntry("removed.test", "test", error);
+        ASSERT_TRUE(first.has_value() && second.has_value() && removed.has_value()) << error;
+        ASSERT_TRUE(database->Save(error)) << error;
+    }
+
+    unique_ptr<AssetDatabase> database = Open(error);
+    ASSERT_NE(database, nullptr) << error;
+    ASSERT_TRUE(database->IsIndexBacked());
+    // 冲突检查必须看到仍只在索引里的条目。
+    EXPECT_FALSE(database->AddEntry("FIRST.test", "test", error).has_value());
+    EXPECT_FALSE(database->SetPath(first.value(), "second.test", error));
+
+    ASSERT_TRUE(database->SetPath(first.value(), "renamed.test", error)) << error;
+    EXPECT_EQ(database->Find("first.test"), nullptr) << "the index's stale path no longer resolves";
+    EXPECT_EQ(database->Find("renamed.test")->Guid, first.value());
+    ASSERT_TRUE(database->AddEntry("first.test", "test", error).has_value()) << error;
+
+    EXPECT_TRUE(database->RemoveEntry(removed.value()));
+    EXPECT_FALSE(database->RemoveEntry(removed.value()));
+    EXPECT_EQ(database->Find(removed.value()), nullptr);
+    EXPECT_FALSE(database->ResolveId("removed.test").has_value());
+
+    ASSERT_TRUE(database->Save(error)) << error;
+    EXPECT_TRUE(database->IsIndexBacked()) << "Save keeps the index it just wrote";
+    unique_ptr<AssetDatabase> reopened = Open(error);
+    ASSERT_NE(reopened, nullptr) << error;
+    EXPECT_EQ(reopened->Find("renamed.test")->Guid, first.value());
+    EXPECT_EQ(reopened->Find("second.test")->Guid, second.value());
+    EXPECT_NE(reopened->Find("first.test"), nullptr);
+    EXPECT_EQ(reopened->Find(removed.value()), nullptr);
+}
+
+TEST_F(AssetDatabaseTest, EditedManifestInvalidatesTheBinaryIndex) {
+    const string guid = "8f3c1a2b-4d5e-4f60-9a7b-0c1d2e3f4a5b";
+    ASSERT_TRUE(WriteManifest(fmt::format(R"({{"version":1,"assets":[{{"guid":"{}","path":"a.test","type":"test"}}]}})", guid)));
+    string error;
+    ASSERT_NE(Open(error), nullptr) << error;
+    ASSERT_TRUE(std::filesystem::exists(Root() / "assets.index")) << "the JSON path writes the index for next time";
+    ASSERT_TRUE(Open(error)->IsIndexBacked());
+
+    // 同样长度、不同内容: 只有内容哈希能发现。
+    ASSERT_TRUE(WriteManifest(fmt::format(R"({{"version":1,"assets":[{{"guid":"{}","path":"b.test","type":"test"}}]}})", guid)));
+    unique_ptr<AssetDatabase> database = Open(error);
+    ASSERT_NE(database, nullptr) << error;
+    EXPECT_FALSE(database->IsIndexBacked());
+    EXPECT_EQ(database->Find("a.test"), nullptr);
+    EXPECT_NE(database->Find("b.test"), nullptr);
+
+    ASSERT_TRUE(_directory.Write("assets.index", "garbage"));
+    unique_ptr<AssetDatabase> corrupted = Open(error);
+    ASSERT_NE(corrupted, nullptr) << error;
+    EXPECT_NE(corrupted->Find("b.test"), nullptr);
+}
+
+TEST_F(AssetDatabaseTest, SettledManifestStampSkipsReadingTheManifest) {
+    string error;
+    {
+        unique_ptr<AssetDatabase> database = Open(error);
+        ASSERT_NE(database, nullptr) << error;
+        ASSERT_TRUE(database->AddEntry("a.test", "test", error).has_value()) << error;
+        ASSERT_TRUE(database->Save(error)) << error;
+    }
+
+    // 刚写的清单还在不可信窗口内; 拨回后下一次 Open 哈希确认一次, 并把 mtime 补记进索引头。
+    const std::filesystem::path manifestPath = Root() / "assets.json";
+    const auto past = std::filesystem::file_time_type::clock::now() - std::chrono::hours{1};
+    std::error_code timeError;
+    std::filesystem::last_write_time(manifestPath, past, timeError);
+    ASSERT_FALSE(timeError) << timeError.message();
+    ASSERT_TRUE(Open(error)->IsIndexBacked()) << error;
+
+    // 同样长度、同样 mtime: 索引直接被采信, 清单一个字节都不读。
+    const std::optional<string> saved = ReadTextFile(manifestPath);
+    ASSERT_TRUE(saved.has_value());
+    const size_t pathAt = saved->find("a.test");
+    ASSERT_NE(pathAt, string::npos);
+    string edited = saved.value();
+    edited[pathAt] = 'b';
+    ASSERT_TRUE(WriteManifest(edited));
+    std::filesystem::last_write_time(manifestPath, past, timeError);
+    ASSERT_FALSE(timeError) << timeError.message();
+    unique_ptr<AssetDatabase> trusted = Open(error);
+    ASSERT_NE(trusted, nullptr) << error;
+    EXPECT_TRUE(trusted->IsIndexBacked());
+    EXPECT_NE(trusted->Find("a.test"), nullptr);
+
+    // mtime 一变就回到哈希比对, 发现内容不同。
+    std::filesystem::last_write_time(manifestPath, past + std::chrono::seconds{1}, timeError);
+    ASSERT_FALSE(timeError) << timeError.message();
+    unique_ptr<AssetDatabase> reparsed = Open(error);
+    ASSERT_NE(reparsed, nullptr) << error;
+    EXPECT_FALSE(reparsed->IsIndexBacked());
+    EXPECT_EQ(reparsed->Find("a.test"), nullptr);
+    EXPECT_NE(reparsed->Find("b.test"), nullptr);
+}
+
+TEST_F(AssetDatabaseTest, OutOfBoundsIndexRecordFailsWhenMaterialized) {
+    string error;
+    std::optional<AssetId> first;
+    std::optional<AssetId> second;
+    {
+        unique_ptr<AssetDatabase> database = Open(error);
+        ASSERT_NE(database, nullptr) << error;
+        first = database->AddEntry("first.test", "test", error);
+        second = database->AddEntry("second.test", "test", error);
+        ASSERT_TRUE(first.has_value() && second.has_value()) << error;
+        ASSERT_TRUE(database->Save(error)) << error;
+    }
+
+    // 记录按 GUID 升序; 把第一条记录的 path 偏移(头 72 字节, 记录内第 24 字节)改到字符串池之外。
+    const AssetId broken = std::min(first.value(), second.value());
+    const AssetId intact = broken == first.value() ? second.value() : first.value();
+    const std::filesystem::path indexPath = Root() / "assets.index";
+    std::optional<vector<byte>> index = ReadBinaryFile(indexPath);
+    ASSERT_TRUE(index.has_value());
+    ASSERT_GT(index->size(), 72u + 28u);
+    for (size_t offset = 72 + 24; offset < 72 + 28; ++offset) {
+        (*index)[offset] = byte{0xf0};
+    }
+    ASSERT_TRUE(WriteBinaryFile(indexPath, index.value()));
+
+    // Open 只看头与各段长度, 坏记录到被取用时才暴露。
+    unique_ptr<AssetDatabase> database = Open(error);
+    ASSERT_NE(database, nullptr) << error;
+    EXPECT_TRUE(database->IsIndexBacked());
+    EXPECT_NE(database->Find(intact), nullptr);
+    EXPECT_EQ(database->Find(broken), nullptr);
+
+    // 读不出的记录不能被 Save 悄悄从清单里丢掉。
+    const std::optional<string> before = ReadTextFile(Root() / "assets.json");
+    EXPECT_FALSE(database->Save(error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_EQ(ReadTextFile(Root() / "assets.json"), before);
+}
+
 TEST_F(AssetDatabaseTest, GuidTextFormsAreAcceptedAndSavedAsLowercaseDFormat) {
     ASSERT_TRUE(WriteManifest(R"json({
   "version": 1,
@@ -300,8 +486,9 @@ TEST_F(AssetDatabaseTest, RegisteredSettingsWithUnknownFieldsFallBackToRawText)
     ASSERT_TRUE(WriteManifest(manifest));
 
     FrameUploadScheduler frameUploads;
+    AssetDecodePool decodePool{AssetDecodePoolDescriptor{.WorkerCount = 1}};
     vector<unique_ptr<AssetImporter>> importers;
-    importers.push_back(make_unique<TextureImporter>(frameUploads));
+    importers.push_back(make_unique<TextureImporter>(frameUploads, decodePool));
     string error;
     unique_ptr<AssetDatabase> database = AssetDatabase::Open(
         Root(),
@@ -354,6 +541,23 @@ TEST_F(AssetDatabaseTest, LoadTaskOwnsAPathAndSettingsSnapshot) {
     EXPECT_EQ(probe->Scale, 3u);
 }
 
+/// 字节估算交给条目的 importer; 默认是源文件大小, 文件缺失或类型未注册时为 0。
+TEST_F(AssetDatabaseTest, LoadEstimateIsTheSourceFileSize) {
+    ASSERT_TRUE(_directory.Write("sized.test", "0123456789"));
+    string error;
+    unique_ptr<AssetDatabase> database = Open(error);
+    ASSERT_NE(database, nullptr) << error;
+    const std::optional<AssetId> sized = database->AddEntry("sized.test", "test", error);
+    const std::optional<AssetId> missing = database->AddEntry("missing.test", "test", error);
+    const std::optional<AssetId> unknown = database->AddEntry("sized.other", "other", error);
+    ASSERT_TRUE(sized.has_value() && missing.has_value() && unknown.has_value()) << error;
+
+    EXPECT_EQ(database->EstimateLoadBytes(sized.value()), 10u);
+    EXPECT_EQ(database->EstimateLoadBytes(missing.value()), 0u);
+    EXPECT_EQ(database->EstimateLoadBytes(unknown.value()), 0u);
+    EXPECT_EQ(database->EstimateLoadBytes(Guid::NewGuid()), 0u);
+}
+
 TEST_F(AssetDatabaseTest, UnknownAndInvalidSettingsKeepTheirOriginalJsonText) {
     constexpr std::string_view unknownRaw = R"({ "future" : [1, 2.00e+1], "nested": {"x" : true} })";
     constexpr std::string_view invalidRaw = R"({"enabled" : "not-a-bool", "scale": 9})";
@@ -471,6 +675,121 @@ TEST_F(AssetDatabaseTest, RefreshDiscoversClaimedFilesAndPreservesGuids) {
     EXPECT_EQ(database->Find(firstGuid)->Guid, firstGuid);
 }
 
+/// 把目录 mtime 拨回 age 之前, 使其落在 Refresh 的"刚修改过"窗口之外。
+/// 同一目录前后两次拨回要用不同的 age, 否则秒级粒度的文件系统上两次结果可能相同。
+void BackdateDirectories(
+    const std::filesystem::path& root,
+    std::initializer_list<std::string_view> directories,
+    std::chrono::hours age = std::chrono::hours{1}) {
+    const auto past = std::filesystem::file_time_type::clock::now() - age;
+    for (std::string_view directory : directories) {
+        std::error_code error;
+        std::filesystem::last_write_time(root / directory, past, error);
+        ASSERT_FALSE(error) << directory << ": " << error.message();
+    }
+}
+
+TEST_F(AssetDatabaseTest, RefreshReusesUnchangedDirectoryListingsFromTheSnapshot) {
+    ASSERT_TRUE(_directory.Write("a/one.test", "one"));
+    ASSERT_TRUE(_directory.Write("b/deep/two.test", "two"));
+    ASSERT_TRUE(_directory.Write("root.test", "root"));
+    BackdateDirectories(Root(), {"", "a", "b", "b/deep"}, std::chrono::hours{2});
+
+    string error;
+    unique_ptr<AssetDatabase> database = Open(error);
+    ASSERT_NE(database, nullptr) << error;
+    ASSERT_TRUE(database->Refresh(error)) << error;
+    EXPECT_EQ(database->GetLastRefreshStats().DirectoryCount, 4u);
+    EXPECT_EQ(database->GetLastRefreshStats().RescannedDirectoryCount, 4u) << "no snapshot yet";
+    EXPECT_EQ(database->GetLastRefreshStats().AddedCount, 3u);
+    EXPECT_TRUE(std::filesystem::exists(Root() / "assets.refresh"));
+
+    // 写快照会推进根目录的 mtime; 拨回后整棵树都应复用上次的列表。
+    BackdateDirectories(Root(), {""});
+    ASSERT_TRUE(database->Refresh(error)) << error;
+    EXPECT_EQ(database->GetLastRefreshStats().DirectoryCount, 4u);
+    EXPECT_EQ(database->GetLastRefreshStats().RescannedDirectoryCount, 0u);
+    EXPECT_EQ(database->GetLastRefreshStats().AddedCount, 0u);
+
+    // 新文件推进所在目录的 mtime, 只有那一层被重新列出。
+    ASSERT_TRUE(_directory.Write("b/deep/three.test", "three"));
+    BackdateDirectories(Root(), {"", "b/deep"});
+    ASSERT_TRUE(database->Refresh(error)) << error;
+    EXPECT_EQ(database->GetLastRefreshStats().RescannedDirectoryCount, 1u);
+    EXPECT_EQ(database->GetLastRefreshStats().AddedCount, 1u);
+    EXPECT_NE(database->Find("b/deep/three.test"), nullptr);
+
+    // 清单从未 Save: 新库复用快照里的列表, 仍要把文件重新登记出来。
+    BackdateDirectories(Root(), {""});
+    unique_ptr<AssetDatabase> unsaved = Open(error);
+    ASSERT_NE(unsaved, nullptr) << error;
+    ASSERT_TRUE(unsaved->Refresh(error)) << error;
+    EXPECT_EQ(unsaved->GetLastRefreshStats().RescannedDirectoryCount, 0u);
+    EXPECT_EQ(unsaved->GetLastRefreshStats().AddedCount, 4u);
+    EXPECT_EQ(unsaved->GetLastRefreshStats().UnseenCount, 0u);
+}
+
+/// 快照核对过已 Save 的清单后, 无事可做的 Refresh 不看任何文件, 也不重写快照;
+/// 之后只有变化的目录被重新核对。
+TEST_F(AssetDatabaseTest, NoOpRefreshLeavesTheSnapshotUntouched) {
+    ASSERT_TRUE(_directory.Write("a/one.test", "one"));
+    ASSERT_TRUE(_directory.Write("b/two.test", "two"));
+    BackdateDirectories(Root(), {"", "a", "b"}, std::chrono::hours{2});
+
+    string error;
+    unique_ptr<AssetDatabase> database = Open(error);
+    ASSERT_NE(database, nullptr) << error;
+    ASSERT_TRUE(database->Refresh(error)) << error;
+    EXPECT_EQ(database->GetLastRefreshStats().AddedCount, 2u);
+    ASSERT_TRUE(database->Save(error)) << error;
+
+    // 刚写的清单落在不可信窗口内, 拨回后这一次 Refresh 才能把它记为已核对。
+    const auto past = std::filesystem::file_time_type::clock::now() - std::chrono::hours{1};
+    std::error_code timeError;
+    std::filesystem::last_write_time(Root() / "assets.json", past, timeError);
+    ASSERT_FALSE(timeError) << timeError.message();
+    ASSERT_TRUE(database->Refresh(error)) << error;
+    EXPECT_EQ(database->GetLastRefreshStats().SkippedDirectoryCount, 0u) << "the snapshot predates the save";
+
+    const std::filesystem::path snapshotPath = Root() / "assets.refresh";
+    std::filesystem::last_write_time(snapshotPath, past, timeError);
+    ASSERT_FALSE(timeError) << timeError.message();
+    const std::filesystem::file_time_type backdated = std::filesystem::last_write_time(snapshotPath, timeError);
+    ASSERT_FALSE(timeError) << timeError.message();
+    const std::optional<vector<byte>> before = ReadBinaryFile(snapshotPath);
+    ASSERT_TRUE(before.has_value());
+
+    ASSERT_TRUE(database->Refresh(error)) << error;
+    EXPECT_EQ(database->GetLastRefreshStats().DirectoryCount, 3u);
+    EXPECT_EQ(database->GetLastRefreshStats().SkippedDirectoryCount, 3u);
+    EXPECT_EQ(database->GetLastRefreshStats().AddedCount, 0u);
+    EXPECT_EQ(database->GetLastRefreshStats().UnseenCount, 0u);
+    EXPECT_EQ(std::filesystem::last_write_time(snapshotPath, timeError), backdated);
+    EXPECT_EQ(ReadBinaryFile(snapshotPath), before);
+
+    // 只有新文件所在的目录被重新核对, 快照随之更新。
+    ASSERT_TRUE(_directory.Write("a/three.test", "three"));
+    ASSERT_TRUE(database->Refresh(error)) << error;
+    EXPECT_EQ(database->GetLastRefreshStats().SkippedDirectoryCount, 2u);
+    EXPECT_EQ(database->GetLastRefreshStats().AddedCount, 1u);
+    EXPECT_NE(database->Find("a/three.test"), nullptr);
+    EXPECT_NE(ReadBinaryFile(snapshotPath), before);
+}
+
+TEST_F(AssetDatabaseTest, CorruptRefreshSnapshotFallsBackToAFullScan) {
+    ASSERT_TRUE(_directory.Write("a/one.test", "one"));
+    ASSERT_TRUE(_directory.Write("assets.refresh", "not a snapshot"));
+    BackdateDirectories(Root(), {"", "a"});
+
+    string error;
+    unique_ptr<AssetDatabase> database = Open(error);
+    ASSERT_NE(database, nullptr) << error;
+    ASSERT_TRUE(database->Refresh(error)) << error;
+    EXPECT_EQ(database->GetLastRefreshStats().RescannedDirectoryCount, 2u);
+    EXPECT_NE(database->Find("a/one.test"), nullptr);
+    EXPECT_EQ(database->Find("assets.refresh"), nullptr);
+}
+
 TEST_F(AssetDatabaseTest, AddAndSetPathRejectEscapesWithoutChangingIdentity) {
     string error;
     unique_ptr<AssetDatabase> database = Open(error);
@@ -503,5 +822,124 @@ TEST_F(AssetDatabaseTest, AddAndSetPathRejectEscapesWithoutChangingIdentity) {
     EXPECT_EQ(database->Find(id.value())->Guid, id.value());
 }
 
+TEST_F(AssetDatabaseTest, DependenciesAreNormalizedAndSurviveSaveAndReopen) {
+    string error;
+    unique_ptr<AssetDatabase> database = Open(error);
+    ASSERT_NE(database, nullptr) << error;
+    const std::optional<AssetId> material = database->AddEntry("material.test", "test", error);
+    const std::optional<AssetId> albedo = database->AddEntry("albedo.test", "test", error);
+    ASSERT_TRUE(material.has_value() && albedo.has_value()) << error;
+    const AssetId unregistered = Guid::NewGuid();
+
+    // 重复项与自身被丢弃, 未登记的 GUID 保留 (文件可能稍后才交付)。
+    const AssetId declared[]{albedo.value(), material.value(), albedo.value(), unregistered};
+    ASSERT_TRUE(database->SetDependencies(material.value(), declared, error)) << error;
+    EXPECT_FALSE(database->SetDependencies(Guid::NewGuid(), declared, error));
+    const std::span<const AssetId> dependencies = database->GetDependencies(material.value());
+    ASSERT_EQ(dependencies.size(), 2u);
+    EXPECT_EQ(dependencies[0], albedo.value());
+    EXPECT_EQ(dependencies[1], unregistered);
+    EXPECT_TRUE(database->GetDependencies(albedo.value()).empty());
+
+    ASSERT_TRUE(database->Save(error)) << error;
+    unique_ptr<AssetDatabase> reopened = Open(error);
+    ASSERT_NE(reopened, nullptr) << error;
+    const AssetEntry* entry = reopened->Find(material.value());
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->Dependencies, (vector<AssetId>{albedo.value(), unregistered}));
+
+    // 加载时发现的依赖覆盖原记录。
+    const AssetId discovered[]{unregistered};
+    reopened->RecordDependencies(material.value(), discovered);
+    EXPECT_EQ(reopened->Find(material.value())->Dependencies, (vector<AssetId>{unregistered}));
+}
+
+TEST_F(AssetDatabaseTest, IncrementalSaveMatchesAFullRewriteByteForByte) {
+    string error;
+    vector<AssetId> ids;
+    {
+        unique_ptr<AssetDatabase> database = Open(error);
+        ASSERT_NE(database, nullptr) << error;
+        // 超过并行编码的门槛, 首次 Save 的 settings 分到多个线程编码。
+        for (uint32_t index = 0; index < 300; ++index) {
+            const std::optional<AssetId> id = database->AddEntry(fmt::format("dir{}/asset{}.test", index % 7, index), "test", error);
+            ASSERT_TRUE(id.has_value()) << error;
+            database->MutableSettings<TestImportSettings>(id.value())->Scale = index;
+            ids.push_back(id.value());
+        }
+        ASSERT_TRUE(database->AddEntry("quoted \"名字\".bin", "unknown", error).has_value()) << error;
+        ASSERT_TRUE(database->Save(error)) << error;
+    }
+
+    unique_ptr<AssetDatabase> database = Open(error);
+    ASSERT_NE(database, nullptr) << error;
+    ASSERT_TRUE(database->IsIndexBacked());
+    ASSERT_TRUE(database->SetPath(ids[3], "renamed/asset3.test", error)) << error;
+    const AssetId dependencies[]{ids[5], ids[6]};
+    ASSERT_TRUE(database->SetDependencies(ids[4], dependencies, error)) << error;
+    database->MutableSettings<TestImportSettings>(ids[7])->Enabled = false;
+    ASSERT_TRUE(database->RemoveEntry(ids[8]));
+    ASSERT_TRUE(database->AddEntry("added.test", "test", error).has_value()) << error;
+    ASSERT_NE(database->Find(ids[9]), nullptr) << "materialized but unchanged";
+    ASSERT_TRUE(database->Save(error)) << error;
+    const std::optional<string> incremental = ReadTextFile(Root() / "assets.json");
+    ASSERT_TRUE(incremental.has_value());
+
+    // 再存一次没有改动的库, 输出不变。
+    ASSERT_TRUE(database->Save(error)) << error;
+    EXPECT_EQ(ReadTextFile(Root() / "assets.json"), incremental);
+
+    // 删掉索引后从 JSON 打开, Save 只能逐条全量编码。
+    std::filesystem::remove(Root() / "assets.index");
+    unique_ptr<AssetDatabase> full = Open(error);
+    ASSERT_NE(full, nullptr) << error;
+    ASSERT_FALSE(full->IsIndexBacked());
+    ASSERT_TRUE(full->Save(error)) << error;
+    EXPECT_EQ(ReadTextFile(Root() / "assets.json"), incremental);
+    EXPECT_EQ(full->Find(ids[3])->Path, "renamed/asset3.test");
+    EXPECT_EQ(full->Find(ids[4])->Dependencies, (vector<AssetId>{ids[5], ids[6]}));
+    EXPECT_FALSE(GetSettings<TestImportSettings>(*full->Find(ids[7]))->Enabled);
+    EXPECT_EQ(full->Find(ids[8]), nullptr);
+}
+
+TEST_F(AssetDatabaseTest, SettingsWrittenThroughAnEarlierPointerReachTheNextSave) {
+    string error;
+    unique_ptr<AssetDatabase> database = Open(error);
+    ASSERT_NE(database, nullptr) << error;
+    const std::optional<AssetId> id = database->AddEntry("a.test", "test", error);
+    ASSERT_TRUE(id.has_value()) << error;
+    TestImportSettings* settings = database->MutableSettings<TestImportSettings>(id.value());
+    ASSERT_NE(settings, nullptr);
+    ASSERT_TRUE(database->Save(error)) << error;
+
+    settings->Scale = 11;
+    ASSERT_TRUE(database->Save(error)) << error;
+    unique_ptr<AssetDatabase> reopened = Open(error);
+    ASSERT_NE(reopened, nullptr) << error;
+    EXPECT_EQ(GetSettings<TestImportSettings>(*reopened->Find(id.value()))->Scale, 11u);
+}
+
+TEST_F(AssetDatabaseTest, RegisteringAnImporterForcesAFullSave) {
+    string error;
+    {
+        unique_ptr<AssetDatabase> database = AssetDatabase::Open(Root(), {}, error);
+        ASSERT_NE(database, nullptr) << error;
+        ASSERT_TRUE(database->AddEntry("a.test", "test", error).has_value()) << error;
+        ASSERT_TRUE(database->Save(error)) << error;
+    }
+    std::optional<string> saved = ReadTextFile(Root() / "assets.json");
+    ASSERT_TRUE(saved.has_value());
+    EXPECT_EQ(saved->find("\"settings\""), string::npos);
+
+    // 同一份索引, 但现在 "test" 有 importer: 条目该带上默认 settings, 旧记录不能复用。
+    unique_ptr<AssetDatabase> database = Open(error);
+    ASSERT_NE(database, nullptr) << error;
+    ASSERT_TRUE(database->IsIndexBacked());
+    ASSERT_TRUE(database->Save(error)) << error;
+    saved = ReadTextFile(Root() / "assets.json");
+    ASSERT_TRUE(saved.has_value());
+    EXPECT_NE(saved->find("\"settings\": {\"enabled\":true,\"scale\":1}"), string::npos);
+}
+
 }  // namespace
 }  // namespace radray
@@ -0,0 +1,160 @@
+// AssetDecodePool: CPU 阶段在 worker 上执行, 协程只在主线程的 Pump 里恢复;
+// 在飞字节预算限制并发; 取消与析构不会悬挂协程; 任务体内的 ParallelFor 每个下标恰好执行一次。
+//
+// 【不需要 device】被测的只是线程池与等待表, 任务体是纯计算。
+
+#include <radray/runtime/asset_decode_pool.h>
+
+#include <radray/coroutine.h>
+#include <radray/types.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace radray {
+namespace {
+
+struct Probe {
+    std::atomic<int> Running{0};
+    std::atomic<int> MaxRunning{0};
+    /// 只在主线程写: 证明协程的恢复点在 Pump 所在线程。
+    std::thread::id ResumedOn{};
+    int Completed{0};
+    int Sum{0};
+};
+
+task<void> RunDoubling(AssetDecodePool& pool, shared_ptr<Probe> probe, int value, uint64_t bytes) {
+    const int doubled = co_await pool.Run(bytes, [probe, value]() {
+        const int running = ++probe->Running;
+        int observed = probe->MaxRunning.load();
+        while (running > observed && !probe->MaxRunning.compare_exchange_weak(observed, running)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        --probe->Running;
+        return value * 2;
+    });
+    probe->ResumedOn = std::this_thread::get_id();
+    probe->Sum += doubled;
+    ++probe->Completed;
+}
+
+/// 泵到 probe 收齐 expected 个结果或超时。
+bool PumpUntil(AssetDecodePool& pool, const Probe& probe, int expected) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (probe.Completed < expected) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        pool.Pump();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+TEST(AssetDecodePoolTest, ResumesOnThePumpingThreadWithTheWorkerResult) {
+    AssetDecodePool pool{AssetDecodePoolDescriptor{.WorkerCount = 2}};
+    auto probe = make_shared<Probe>();
+    TaskScope scope;
+    for (int i = 1; i <= 4; ++i) {
+        scope.Spawn(RunDoubling(pool, probe, i, 1));
+    }
+    // 没有 Pump 就没有恢复, 无论 worker 多快。
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(probe->Completed, 0);
+
+    ASSERT_TRUE(PumpUntil(pool, *probe, 4));
+    EXPECT_EQ(probe->Sum, 2 * (1 + 2 + 3 + 4));
+    EXPECT_EQ(probe->ResumedOn, std::this_thread::get_id());
+    EXPECT_EQ(pool.GetInFlightBytes(), 0u);
+}
+
+TEST(AssetDecodePoolTest, InFlightBytesBudgetLimitsConcurrency) {
+    AssetDecodePool pool{AssetDecodePoolDescriptor{.WorkerCount = 4, .MaxInFlightBytes = 100}};
+    auto probe = make_shared<Probe>();
+    TaskScope scope;
+    // 每个任务 60 字节, 预算 100: 同一时刻只容得下一个。
+    for (int i = 0; i < 6; ++i) {
+        scope.Spawn(RunDoubling(pool, probe, i, 60));
+    }
+    ASSERT_TRUE(PumpUntil(pool, *probe, 6));
+    EXPECT_EQ(probe->MaxRunning.load(), 1);
+}
+
+TEST(AssetDecodePoolTest, OversizedJobStillRunsWhenNothingElseIsInFlight) {
+    AssetDecodePool pool{AssetDecodePoolDescriptor{.WorkerCount = 1, .MaxInFlightBytes = 16}};
+    auto probe = make_shared<Probe>();
+    TaskScope scope;
+    scope.Spawn(RunDoubling(pool, probe, 21, 1024));
+    ASSERT_TRUE(PumpUntil(pool, *probe, 1));
+    EXPECT_EQ(probe->Sum, 42);
+}
+
+TEST(AssetDecodePoolTest, CanceledWaitersAreNotResumedAndReleaseTheirBudget) {
+    AssetDecodePool pool{AssetDecodePoolDescriptor{.WorkerCount = 1}};
+    auto probe = make_shared<Probe>();
+    {
+        TaskScope scope;
+        for (int i = 0; i < 3; ++i) {
+            scope.Spawn(RunDoubling(pool, probe, i, 8));
+        }
+        // ~TaskScope 请求停止: 等待者经 stop callback 同步结束, 不必等 Pump。
+    }
+    EXPECT_EQ(probe->Completed, 0);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (pool.GetInFlightBytes() != 0 && std::chrono::steady_clock::now() < deadline) {
+        pool.Pump();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(pool.GetInFlightBytes(), 0u);
+    EXPECT_EQ(probe->Completed, 0);
+}
+
+TEST(AssetDecodePoolTest, DestroyingThePoolCancelsPendingWaiters) {
+    auto probe = make_shared<Probe>();
+    TaskScope scope;
+    {
+        AssetDecodePool pool{AssetDecodePoolDescriptor{.WorkerCount = 1, .MaxInFlightBytes = 1}};
+        for (int i = 0; i < 4; ++i) {
+            scope.Spawn(RunDoubling(pool, probe, i, 8));
+        }
+    }
+    // 池析构已让全部等待者以 stopped 结束, scope 立即为空。
+    scope.WaitUntilEmpty();
+    EXPECT_EQ(probe->Completed, 0);
+}
+
+TEST(AssetDecodePoolTest, ParallelForInsideAJobRunsEveryIndexOnce) {
+    AssetDecodePool pool{AssetDecodePoolDescriptor{.WorkerCount = 3}};
+    auto hits = make_shared<std::array<std::atomic<int>, 257>>();
+    auto probe = make_shared<Probe>();
+    TaskScope scope;
+    scope.Spawn([](AssetDecodePool& pool, shared_ptr<std::array<std::atomic<int>, 257>> hits, shared_ptr<Probe> probe) -> task<void> {
+        // 发起者自己占着一个 worker; 其余 worker 空闲时来领下标, 没空也不会卡住。
+        const int total = co_await pool.Run(1, [&pool, hits]() {
+            pool.ParallelFor(static_cast<uint32_t>(hits->size()), [&hits](uint32_t i) { ++(*hits)[i]; });
+            return static_cast<int>(hits->size());
+        });
+        probe->Sum = total;
+        ++probe->Completed;
+    }(pool, hits, probe));
+    ASSERT_TRUE(PumpUntil(pool, *probe, 1));
+    EXPECT_EQ(probe->Sum, 257);
+    for (const std::atomic<int>& hit : *hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+
+    // 在主线程上直接调用同样可行, 下标数为 0 或 1 时不碰 worker。
+    std::atomic<int> calls{0};
+    pool.ParallelFor(0, [&calls](uint32_t) { ++calls; });
+    pool.ParallelFor(1, [&calls](uint32_t) { ++calls; });
+    pool.ParallelFor(64, [&calls](uint32_t) { ++calls; });
+    EXPECT_EQ(calls.load(), 65);
+}
+
+}  // namespace
+}  // namespace radray
@@ -49,8 +49,8 @@ public:
     /// 存活引用, 槽位要到 fixture 的 ~AssetManager 才回收 —— 那已经在用例函数返回【之后】,
     /// 栈上的 Counters 早已死亡, 于是 OnUnload 写进已失效的栈帧。那种写入不一定立刻崩,
     /// 表现为随机的挂死或串扰, 极难定位。共享所有权让计数器活到最后一个写入者之后。
-    ProbeAsset(shared_ptr<Counters> counters, bool wantsDeferredDestroy) noexcept
-        : _counters(std::move(counters)), _wantsDeferredDestroy(wantsDeferredDestroy) {}
+    ProbeAsset(shared_ptr<Counters> counters, bool wantsDeferredDestroy, AssetMemorySize memorySize = {}) noexcept
+        : _counters(std::move(counters)), _wantsDeferredDestroy(wantsDeferredDestroy), _memorySize(memorySize) {}
 
     ~ProbeAsset() noexcept override {
         if (_counters != nullptr) {
@@ -72,6 +72,7 @@ public:
     }
 
     RuntimeTypeId GetTypeId() const noexcept override { return runtime_type_id_v<ProbeAsset>; }
+    AssetMemorySize GetMemorySize() const noexcept override { return _memorySize; }
 
 private:
     /// 析构时给 PayloadDestroyed +1, 被移走的那份不再记账。
@@ -99,6 +100,7 @@ private:
 
     shared_ptr<Counters> _counters;
     bool _wantsDeferredDestroy{false};
+    AssetMemorySize _memorySize{};
 };
 
 using Counters = ProbeAsset::Counters;
@@ -129,8 +131,8 @@ constexpr AssetId MakeId(uint32_t n) noexcept {
 /// 一个只有 co_return 的加载 task 没有挂起点 —— 它在 Load() 返回之前就跑完了。于是所有
 /// 关心"在飞期间发生了什么"的用例都无从下手。这个 gate 给加载协程造一个可控的停留处。
 ///
-/// 【为何是 `co_await gate.Wait()` 而不是 `co_await gate`】: exec::task 的 promise 有
-/// await_transform, 它会把 awaitable 【按值】转发一遍; 若 operator co_await 定义在 gate
+/// 【为何是 `co_await gate.Wait()` 而不是 `co_await gate`】: 带 await_transform 的 promise
+/// (如 exec::task 的) 可能把 awaitable 【按值】转发一遍; 若 operator co_await 定义在 gate
 /// 自己身上, 那个 this 就指向那份副本, 于是 handle 记进了副本而原 gate 永远 IsPending()
 /// 为 false。Wait() 返回的 awaiter 只带一个指向真 gate 的指针, 复制它无害。
 class ManualGate {
@@ -300,6 +302,27 @@ TEST_F(AssetSlotTest, ReacquiringBeforePumpKeepsTheSameAsset) {
     EXPECT_TRUE(revived.IsReady());
 }
 
+/// 回收只看零引用队列。复活后被跳过的槽位已经出队, 再次归零时必须重新入队, 否则它会
+/// 永远留在表里 —— 旧的全表扫描天然没有这个问题, 队列实现有。
+TEST_F(AssetSlotTest, RevivedSlotIsCollectedWhenReleasedAgain) {
+    shared_ptr<Counters> counters = MakeCounters();
+    const AssetId id = MakeId(31);
+
+    Assets().AddReady<ProbeAsset>(id, make_unique<ProbeAsset>(counters, false)).Reset();
+    StreamingAssetRef<ProbeAsset> revived = Assets().Find<ProbeAsset>(id);
+    ASSERT_TRUE(revived.IsReady());
+    Assets().Pump();
+    ASSERT_EQ(counters->Unloaded, 0u);
+
+    revived.Reset();
+    // 归零两次只入队一次: 第二次归零发生在同一帧内再放开一份临时引用时。
+    Assets().Find<ProbeAsset>(id).Reset();
+    Assets().Pump();
+    EXPECT_EQ(counters->Unloaded, 1u);
+    EXPECT_EQ(counters->Destroyed, 1u);
+    EXPECT_EQ(Assets().GetAssetCount(), 0u);
+}
+
 /// OnUnload 跑在析构【之前】。这不是风格问题: OnUnload 要拿 AssetManager 才能交出需要
 /// 延迟销毁的数据, 而析构函数里拿不到, 故顺序反了就等于没有延迟释放。
 TEST_F(AssetSlotTest, OnUnloadRunsBeforeTheDestructor) {
@@ -807,6 +830,82 @@ TEST_F(AssetSlotTest, CancelingAWaiterDoesNotCancelTheLoad) {
     EXPECT_TRUE(ref.IsReady()) << "canceling a waiter must not cancel the underlying load";
 }
 
+/// 门控加载。两个用例都要 "同时在飞、逐个放行" 的几个槽位。
+StreamingAssetRefAny LoadGated(AssetManager& assets, uint32_t n, ManualGate* gate, shared_ptr<Counters> counters) {
+    return assets.Load(AssetLoadRequest{
+        .Id = MakeId(n),
+        .Task = [](ManualGate* g, shared_ptr<Counters> c) -> task<AssetLoadResult> {
+            co_await g->Wait();
+            co_return AssetLoadResult::Success(make_unique<ProbeAsset>(c, false));
+        }(gate, std::move(counters))});
+}
+
+/// WhenAllReady 只在最后一个槽位进入终态的那次 Pump 里恢复, 且只恢复一次。已是终态的引用
+/// 不登记节点, 不会拖住等待者。
+TEST_F(AssetSlotTest, WhenAllReadyResumesOnceAfterTheLastSlotCompletes) {
+    shared_ptr<Counters> counters = MakeCounters();
+    ManualGate first;
+    ManualGate second;
+    StreamingAssetRefAny a = LoadGated(Assets(), 55, &first, counters);
+    StreamingAssetRefAny b = LoadGated(Assets(), 56, &second, counters);
+    StreamingAssetRef<ProbeAsset> ready =
+        Assets().AddReady<ProbeAsset>(MakeId(57), make_unique<ProbeAsset>(counters, false));
+
+    uint32_t resumes = 0;
+    bool completed = false;
+    bool sawBothReady = false;
+    TaskScope waiters;
+    waiters.Spawn([](StreamingAssetRefAny x, StreamingAssetRefAny y, StreamingAssetRef<ProbeAsset> z, uint32_t* resumesOut, bool* completedOut, bool* readyOut) -> task<void> {
+        *completedOut = co_await WhenAllReady(x, y, z);
+        ++*resumesOut;
+        *readyOut = x.IsReady() && y.IsReady();
+    }(a, b, ready, &resumes, &completed, &sawBothReady));
+
+    first.Resume();
+    Assets().Pump();
+    EXPECT_EQ(resumes, 0u) << "one slot is still loading";
+
+    second.Resume();
+    Assets().Pump();
+    EXPECT_EQ(resumes, 1u);
+    EXPECT_TRUE(completed);
+    EXPECT_TRUE(sawBothReady);
+    waiters.WaitUntilEmpty();
+}
+
+/// 取消 WhenAllReady 的等待者会把它的节点从每个槽位的等待链上摘下: 之后的 Pump 不再碰它,
+/// 同一槽位上的其它等待者照常恢复。
+TEST_F(AssetSlotTest, CancelingAWhenAllReadyWaiterUnlinksItFromEverySlot) {
+    shared_ptr<Counters> counters = MakeCounters();
+    ManualGate first;
+    ManualGate second;
+    StreamingAssetRefAny a = LoadGated(Assets(), 58, &first, counters);
+    StreamingAssetRefAny b = LoadGated(Assets(), 59, &second, counters);
+
+    bool survivorResumed = false;
+    TaskScope survivors;
+    survivors.Spawn([](StreamingAssetRefAny r, bool* out) -> task<void> {
+        *out = co_await r;
+    }(b, &survivorResumed));
+
+    bool canceledSawCompletion = true;
+    {
+        TaskScope canceled;
+        const vector<StreamingAssetRefAny> refs{a, b};
+        canceled.Spawn([](vector<StreamingAssetRefAny> r, bool* out) -> task<void> {
+            *out = co_await WhenAllReady(std::span<const StreamingAssetRefAny>{r});
+        }(refs, &canceledSawCompletion));
+    }
+    EXPECT_FALSE(canceledSawCompletion) << "false means 'the waiter was canceled'";
+
+    first.Resume();
+    second.Resume();
+    Assets().Pump();
+    EXPECT_TRUE(a.IsReady());
+    EXPECT_TRUE(survivorResumed);
+    survivors.WaitUntilEmpty();
+}
+
 // ════════════════════════════════════════════════════════════
 //  关停
 // ════════════════════════════════════════════════════════════
@@ -865,5 +964,407 @@ TEST_F(AssetSlotTest, ShutdownCommitsPendingResultsSoTheyStillUnload) {
     EXPECT_EQ(counters->PayloadDestroyed, 1u);
 }
 
+// ════════════════════════════════════════════════════════════
+//  加载优先级与准入
+// ════════════════════════════════════════════════════════════
+
+/// 记录自己被启动的加载。started 只在 task 第一次被恢复时 +1, 故排队后被丢弃的 task 不计数。
+task<AssetLoadResult> CountedProbeLoad(ManualGate* gate, uint32_t* started, shared_ptr<Counters> counters) {
+    ++*started;
+    if (gate != nullptr) {
+        co_await gate->Wait();
+    }
+    co_return AssetLoadResult::Success(make_unique<ProbeAsset>(std::move(counters), false));
+}
+
+/// 超出并发上限的加载排队, 不在 Load 里启动; 名额要等下一次 Pump 才重新分配。
+TEST_F(AssetSlotTest, LoadsBeyondTheConcurrencyLimitWaitForPump) {
+    shared_ptr<Counters> counters = MakeCounters();
+    Assets().SetLoadBudget(AssetLoadBudget{.MaxConcurrentLoads = 1});
+    uint32_t firstStarted = 0;
+    uint32_t secondStarted = 0;
+
+    ManualGate gate;
+    StreamingAssetRef<ProbeAsset> first = Assets().Load<ProbeAsset>(AssetLoadRequest{
+        .Id = MakeId(27),
+        .Task = CountedProbeLoad(&gate, &firstStarted, counters)});
+    StreamingAssetRef<ProbeAsset> second = Assets().Load<ProbeAsset>(AssetLoadRequest{
+        .Id = MakeId(28),
+        .Task = CountedProbeLoad(nullptr, &secondStarted, counters)});
+    EXPECT_EQ(firstStarted, 1u);
+    EXPECT_EQ(secondStarted, 0u) << "the second load must queue behind the concurrency limit";
+    EXPECT_EQ(Assets().GetLoadStats().RunningLoads, 1u);
+    EXPECT_EQ(Assets().GetLoadStats().Priorities[static_cast<size_t>(AssetLoadPriority::VisibleNow)].QueuedCount, 1u);
+
+    Assets().Pump();
+    EXPECT_EQ(secondStarted, 0u) << "the first load is still in flight";
+
+    gate.Resume();
+    Assets().Pump();
+    EXPECT_TRUE(first.IsReady());
+    EXPECT_EQ(secondStarted, 1u);
+    Assets().Pump();
+    EXPECT_TRUE(second.IsReady());
+    EXPECT_EQ(Assets().GetLoadStats().RunningLoads, 0u);
+}
+
+/// 名额空出来时按优先级准入, 同一优先级内按提交顺序; SetPriority 能把排队中的加载提上来。
+TEST_F(AssetSlotTest, QueuedLoadsAreAdmittedByPriority) {
+    shared_ptr<Counters> counters = MakeCounters();
+    Assets().SetLoadBudget(AssetLoadBudget{.MaxConcurrentLoads = 1});
+    uint32_t blockerStarted = 0;
+    uint32_t backgroundStarted = 0;
+    uint32_t prefetchStarted = 0;
+    uint32_t raisedStarted = 0;
+
+    ManualGate blockerGate;
+    ManualGate backgroundGate;
+    ManualGate prefetchGate;
+    ManualGate raisedGate;
+    StreamingAssetRefAny blocker = Assets().Load(AssetLoadRequest{
+        .Id = MakeId(29),
+        .Task = CountedProbeLoad(&blockerGate, &blockerStarted, counters)});
+    StreamingAssetRefAny background = Assets().Load(AssetLoadRequest{
+        .Id = MakeId(30),
+        .Task = CountedProbeLoad(&backgroundGate, &backgroundStarted, counters),
+        .Priority = AssetLoadPriority::Background});
+    StreamingAssetRefAny prefetch = Assets().Load(AssetLoadRequest{
+        .Id = MakeId(31),
+        .Task = CountedProbeLoad(&prefetchGate, &prefetchStarted, counters),
+        .Priority = AssetLoadPriority::Prefetch});
+    StreamingAssetRefAny raised = Assets().Load(AssetLoadRequest{
+        .Id = MakeId(32),
+        .Task = CountedProbeLoad(&raisedGate, &raisedStarted, counters),
+        .Priority = AssetLoadPriority::Background});
+    // 它刚进入视野。
+    Assets().SetPriority(raised, AssetLoadPriority::VisibleNow);
+
+    blockerGate.Resume();
+    Assets().Pump();
+    EXPECT_EQ(raisedStarted, 1u) << "the raised load jumps both lower-priority queues";
+    EXPECT_EQ(prefetchStarted, 0u);
+    EXPECT_EQ(backgroundStarted, 0u);
+
+    raisedGate.Resume();
+    Assets().Pump();
+    EXPECT_EQ(prefetchStarted, 1u);
+    EXPECT_EQ(backgroundStarted, 0u);
+
+    prefetchGate.Resume();
+    Assets().Pump();
+    EXPECT_EQ(backgroundStarted, 1u);
+
+    const AssetLoadStats stats = Assets().GetLoadStats();
+    EXPECT_EQ(stats.Priorities[static_cast<size_t>(AssetLoadPriority::Background)].AdmittedCount, 1u);
+    EXPECT_EQ(stats.Priorities[static_cast<size_t>(AssetLoadPriority::VisibleNow)].AdmittedCount, 2u);
+    for (const AssetLoadPriorityStats& priority : stats.Priorities) {
+        EXPECT_EQ(priority.QueuedCount, 0u);
+    }
+}
+
+/// 【启动前引用全部放开即丢弃】, 与在飞加载"跑完再回收"正相反: 排队中的加载一分代价
+/// 都还没花, 没有理由再去花。
+TEST_F(AssetSlotTest, DroppingEveryRefBeforeStartDropsTheQueuedLoad) {
+    shared_ptr<Counters> counters = MakeCounters();
+    Assets().SetLoadBudget(AssetLoadBudget{.MaxConcurrentLoads = 1});
+    uint32_t blockerStarted = 0;
+    uint32_t droppedStarted = 0;
+
+    ManualGate gate;
+    StreamingAssetRefAny blocker = Assets().Load(AssetLoadRequest{
+        .Id = MakeId(33),
+        .Task = CountedProbeLoad(&gate, &blockerStarted, counters)});
+    Assets().Load(AssetLoadRequest{
+        .Id = MakeId(34),
+        .Task = CountedProbeLoad(nullptr, &droppedStarted, counters),
+        .Priority = AssetLoadPriority::Prefetch});
+    EXPECT_EQ(Assets().GetAssetCount(), 2u);
+
+    gate.Resume();
+    Assets().Pump();
+    EXPECT_EQ(droppedStarted, 0u) << "an unreferenced queued load must never start";
+    EXPECT_EQ(Assets().GetAssetCount(), 1u);
+    const AssetLoadPriorityStats& prefetch =
+        Assets().GetLoadStats().Priorities[static_cast<size_t>(AssetLoadPriority::Prefetch)];
+    EXPECT_EQ(prefetch.DroppedBeforeStartCount, 1u);
+    EXPECT_EQ(prefetch.QueuedCount, 0u);
+}
+
+/// 取消排队中的加载不必等挂起点: task 直接丢弃, 下一次 Pump 以 Canceled 提交。
+TEST_F(AssetSlotTest, CancelingAQueuedLoadEndsInCanceledAtNextPump) {
+    shared_ptr<Counters> counters = MakeCounters();
+    Assets().SetLoadBudget(AssetLoadBudget{.MaxConcurrentLoads = 1});
+    uint32_t blockerStarted = 0;
+    uint32_t canceledStarted = 0;
+
+    ManualGate gate;
+    StreamingAssetRefAny blocker = Assets().Load(AssetLoadRequest{
+        .Id = MakeId(35),
+        .Task = CountedProbeLoad(&gate, &blockerStarted, counters)});
+    StreamingAssetRefAny canceled = Assets().Load(AssetLoadRequest{
+        .Id = MakeId(36),
+        .Task = CountedProbeLoad(nullptr, &canceledStarted, counters)});
+
+    canceled.Cancel();
+    EXPECT_FALSE(canceled.IsCompleted()) << "committed by Pump, not on the caller's stack";
+    Assets().Pump();
+    EXPECT_TRUE(canceled.IsCanceled());
+    EXPECT_EQ(canceledStarted, 0u);
+}
+
+/// 字节预算: 放不下的加载排队; 单个超预算的加载在没有其它在飞加载时照样准入;
+/// Critical 不受预算限制。
+TEST_F(AssetSlotTest, InFlightByteBudgetQueuesLoadsExceptCritical) {
+    shared_ptr<Counters> counters = MakeCounters();
+    Assets().SetLoadBudget(AssetLoadBudget{.MaxInFlightBytes = 100});
+    uint32_t oversizedStarted = 0;
+    uint32_t queuedStarted = 0;
+    uint32_t criticalStarted = 0;
+
+    ManualGate gate;
+    StreamingAssetRefAny oversized = Assets().Load(AssetLoadRequest{
+        .Id = MakeId(37),
+        .Task = CountedProbeLoad(&gate, &oversizedStarted, counters),
+        .EstimatedBytes = 1000});
+    StreamingAssetRefAny queued = Assets().Load(AssetLoadRequest{
+        .Id = MakeId(38),
+        .Task = CountedProbeLoad(nullptr, &queuedStarted, counters),
+        .EstimatedBytes = 10});
+    StreamingAssetRefAny critical = Assets().Load(AssetLoadRequest{
+        .Id = MakeId(39),
+        .Task = CountedProbeLoad(nullptr, &criticalStarted, counters),
+        .Priority = AssetLoadPriority::Critical,
+        .EstimatedBytes = 10});
+    EXPECT_EQ(oversizedStarted, 1u) << "nothing else was in flight";
+    EXPECT_EQ(queuedStarted, 0u);
+    EXPECT_EQ(criticalStarted, 1u) << "Critical ignores the budget";
+    EXPECT_EQ(Assets().GetLoadStats().InFlightBytes, 1000u);
+
+    gate.Resume();
+    Assets().Pump();
+    EXPECT_EQ(queuedStarted, 1u);
+    Assets().Pump();
+    EXPECT_TRUE(queued.IsReady());
+    EXPECT_EQ(Assets().GetLoadStats().InFlightBytes, 0u);
+}
+
+// ════════════════════════════════════════════════════════════
+//  保活缓存
+// ════════════════════════════════════════════════════════════
+
+/// 预算装配后, 引用归零的 Ready 资产不卸载; 同 id 的下一次 Load 直接复活它, loader 不再跑。
+TEST_F(AssetSlotTest, CachedAssetIsRevivedByTheNextLoadWithoutRunningTheLoader) {
+    shared_ptr<Counters> counters = MakeCounters();
+    Assets().SetCacheBudget(AssetCacheBudget{.MaxCpuBytes = 100});
+    const AssetId id = MakeId(40);
+    uint32_t started = 0;
+
+    StreamingAssetRef<ProbeAsset> ref = Assets().Load<ProbeAsset>(AssetLoadRequest{
+        .Id = id,
+        .Task = [](uint32_t* s, shared_ptr<Counters> c) -> task<AssetLoadResult> {
+            ++*s;
+            co_return AssetLoadResult::Success(make_unique<ProbeAsset>(c, true, AssetMemorySize{.CpuBytes = 40}));
+        }(&started, counters)});
+    Assets().Pump();
+    ASSERT_TRUE(ref.IsReady());
+    const ProbeAsset* object = ref.Get();
+
+    ref.Reset();
+    Assets().Pump();
+    EXPECT_EQ(counters->Unloaded, 0u) << "a cached asset must not be unloaded";
+    EXPECT_EQ(Assets().GetAssetCount(), 1u);
+    EXPECT_EQ(Assets().GetCacheStats().CachedCount, 1u);
+    EXPECT_EQ(Assets().GetCacheStats().CachedBytes.CpuBytes, 40u);
+
+    StreamingAssetRef<ProbeAsset> revived = Assets().Load<ProbeAsset>(AssetLoadRequest{
+        .Id = id,
+        .Task = CountedProbeLoad(nullptr, &started, counters)});
+    EXPECT_EQ(started, 1u) << "a cache hit must not run the loader";
+    ASSERT_TRUE(revived.IsReady()) << "revival is instant, no Pump needed";
+    EXPECT_EQ(revived.Get(), object);
+
+    const AssetCacheStats stats = Assets().GetCacheStats();
+    EXPECT_EQ(stats.HitCount, 1u);
+    EXPECT_EQ(stats.MissCount, 1u);
+    EXPECT_EQ(stats.CachedCount, 0u) << "a revived asset leaves the cache";
+    EXPECT_EQ(stats.CachedBytes.CpuBytes, 0u);
+}
+
+/// 超出预算时从最久未放开的一端挤出, 被挤出的资产照常走 OnUnload + 延迟销毁。
+TEST_F(AssetSlotTest, CacheEvictsTheLeastRecentlyReleasedAssetOverBudget) {
+    Assets().SetCacheBudget(AssetCacheBudget{.MaxCpuBytes = 100, .MaxGpuBytes = 100});
+    shared_ptr<Counters> first = MakeCounters();
+    shared_ptr<Counters> second = MakeCounters();
+    shared_ptr<Counters> third = MakeCounters();
+    const AssetMemorySize size{.CpuBytes = 40, .GpuBytes = 10};
+    StreamingAssetRef<ProbeAsset> a = Assets().AddReady<ProbeAsset>(MakeId(41), make_unique<ProbeAsset>(first, true, size));
+    StreamingAssetRef<ProbeAsset> b = Assets().AddReady<ProbeAsset>(MakeId(42), make_unique<ProbeAsset>(second, true, size));
+    StreamingAssetRef<ProbeAsset> c = Assets().AddReady<ProbeAsset>(MakeId(43), make_unique<ProbeAsset>(third, true, size));
+
+    a.Reset();
+    b.Reset();
+    Assets().Pump();
+    // b 复活后再次放开, 于是它比 a 更"新"。
+    b = Assets().Find<ProbeAsset>(MakeId(42));
+    ASSERT_TRUE(b.IsReady());
+    b.Reset();
+    c.Reset();
+    Assets().Pump();
+
+    EXPECT_EQ(first->Unloaded, 1u) << "the least recently released asset goes first";
+    EXPECT_EQ(second->Unloaded, 0u);
+    EXPECT_EQ(third->Unloaded, 0u);
+    EXPECT_EQ(first->PayloadDestroyed, 1u);
+    const AssetCacheStats stats = Assets().GetCacheStats();
+    EXPECT_EQ(stats.CachedCount, 2u);
+    EXPECT_EQ(stats.EvictedCount, 1u);
+    EXPECT_EQ(stats.EvictedBytes.CpuBytes, 40u);
+    EXPECT_EQ(stats.EvictedBytes.GpuBytes, 10u);
+
+    // 收紧预算立即挤出。
+    Assets().SetCacheBudget(AssetCacheBudget{});
+    EXPECT_EQ(second->Unloaded, 1u);
+    EXPECT_EQ(third->Unloaded, 1u);
+    EXPECT_EQ(Assets().GetAssetCount(), 0u);
+}
+
+/// 单个就超出预算的资产不进缓存, 也不为它挤掉别的资产。
+TEST_F(AssetSlotTest, AssetLargerThanTheBudgetIsUnloadedDirectly) {
+    Assets().SetCacheBudget(AssetCacheBudget{.MaxCpuBytes = 100});
+    shared_ptr<Counters> fitting = MakeCounters();
+    shared_ptr<Counters> oversized = MakeCounters();
+    StreamingAssetRef<ProbeAsset> kept = Assets().AddReady<ProbeAsset>(
+        MakeId(44), make_unique<ProbeAsset>(fitting, false, AssetMemorySize{.CpuBytes = 60}));
+    StreamingAssetRef<ProbeAsset> dropped = Assets().AddReady<ProbeAsset>(
+        MakeId(45), make_unique<ProbeAsset>(oversized, false, AssetMemorySize{.CpuBytes = 60, .GpuBytes = 1}));
+
+    kept.Reset();
+    dropped.Reset();
+    Assets().Pump();
+    EXPECT_EQ(fitting->Unloaded, 0u);
+    EXPECT_EQ(oversized->Unloaded, 1u) << "GPU bytes with a zero GPU budget never fit";
+    EXPECT_EQ(Assets().GetCacheStats().EvictedCount, 0u);
+}
+
+// ════════════════════════════════════════════════════════════
+//  依赖图预取
+// ════════════════════════════════════════════════════════════
+
+/// 一张固定的依赖图: 每个节点都能加载, 依赖由 GetDependencies 报告。记录建任务的顺序。
+class GraphAssetSource final : public IAssetSource {
+public:
+    GraphAssetSource(unordered_map<AssetId, vector<AssetId>> graph, shared_ptr<Counters> counters) noexcept
+        : _graph(std::move(graph)), _counters(std::move(counters)) {}
+
+    std::optional<task<AssetLoadResult>> CreateLoadTask(const AssetId& id) override {
+        if (!_graph.contains(id)) {
+            return std::nullopt;
+        }
+        Created.push_back(id);
+        return CountedProbeLoad(Gate, &Started, _counters);
+    }
+
+    std::optional<AssetId> ResolveId(std::string_view) const override { return std::nullopt; }
+
+    uint64_t EstimateLoadBytes(const AssetId& id) const override {
+        auto it = Estimates.find(id);
+        return it == Estimates.end() ? 0 : it->second;
+    }
+
+    std::span<const AssetId> GetDependencies(const AssetId& id) const override {
+        auto it = _graph.find(id);
+        return it == _graph.end() ? std::span<const AssetId>{} : std::span<const AssetId>{it->second};
+    }
+
+    vector<AssetId> Created;
+    unordered_map<AssetId, uint64_t> Estimates;
+    /// 非空时每个加载都停在这里, 直到测试放行。
+    ManualGate* Gate{nullptr};
+    uint32_t Started{0};
+
+private:
+    unordered_map<AssetId, vector<AssetId>> _graph;
+    shared_ptr<Counters> _counters;
+};
+
+/// 一次 Prefetch 取得整张闭包, 共享的依赖只加载一次, 叶子先于引用它的资产发起。
+TEST_F(AssetSlotTest, PrefetchLoadsTheDependencyClosureLeavesFirst) {
+    shared_ptr<Counters> counters = MakeCounters();
+    const AssetId scene = MakeId(50);
+    const AssetId material = MakeId(51);
+    const AssetId mesh = MakeId(52);
+    const AssetId texture = MakeId(53);
+    GraphAssetSource source{
+        {
+            {scene, {material, mesh}},
+            {material, {texture}},
+            {mesh, {material}},
+            {texture, {}},
+        },
+        counters};
+    Assets().SetAssetSource(&source);
+
+    const AssetId roots[]{scene};
+    AssetLoadGroup group = Assets().Prefetch(roots);
+    EXPECT_EQ(group.Size(), 4u);
+    ASSERT_EQ(source.Created.size(), 4u) << "each node of the closure is loaded exactly once";
+    EXPECT_EQ(source.Created.front(), texture);
+    EXPECT_EQ(source.Created.back(), scene);
+    EXPECT_FALSE(group.IsReady());
+
+    Assets().Pump();
+    EXPECT_TRUE(group.IsCompleted());
+    EXPECT_TRUE(group.IsReady());
+    EXPECT_TRUE(Assets().Load<ProbeAsset>(texture).IsReady()) << "a later Load reuses the prefetched slot";
+    EXPECT_EQ(source.Created.size(), 4u);
+    Assets().SetAssetSource(nullptr);
+}
+
+/// 按 id 加载不经手填的请求: 字节估算来自来源, Load(id) 与 Prefetch 都照样受字节预算约束。
+TEST_F(AssetSlotTest, LoadByIdAndPrefetchChargeTheSourceEstimate) {
+    shared_ptr<Counters> counters = MakeCounters();
+    Assets().SetLoadBudget(AssetLoadBudget{.MaxInFlightBytes = 100});
+    const AssetId material = MakeId(55);
+    const AssetId texture = MakeId(56);
+    GraphAssetSource source{
+        {
+            {material, {texture}},
+            {texture, {}},
+        },
+        counters};
+    ManualGate gate;
+    source.Gate = &gate;
+    source.Estimates = {{material, 80}, {texture, 80}};
+    Assets().SetAssetSource(&source);
+
+    StreamingAssetRefAny byId = Assets().Load(texture);
+    EXPECT_EQ(source.Started, 1u);
+    EXPECT_EQ(Assets().GetLoadStats().InFlightBytes, 80u);
+
+    const AssetId roots[]{material};
+    AssetLoadGroup group = Assets().Prefetch(roots);
+    EXPECT_EQ(group.Size(), 2u);
+    EXPECT_EQ(source.Started, 1u) << "the material's estimate does not fit next to the texture";
+
+    gate.Resume();
+    Assets().Pump();
+    EXPECT_TRUE(byId.IsReady());
+    EXPECT_EQ(source.Started, 2u);
+    EXPECT_EQ(Assets().GetLoadStats().InFlightBytes, 80u);
+
+    gate.Resume();
+    Assets().Pump();
+    EXPECT_TRUE(group.IsReady());
+    EXPECT_EQ(Assets().GetLoadStats().InFlightBytes, 0u);
+    Assets().SetAssetSource(nullptr);
+}
+
+TEST_F(AssetSlotTest, PrefetchWithoutASourceReturnsAnEmptyGroup) {
+    const AssetId roots[]{MakeId(54)};
+    AssetLoadGroup group = Assets().Prefetch(roots);
+    EXPECT_EQ(group.Size(), 0u);
+    EXPECT_TRUE(group.IsReady());
+}
+
 }  // namespace
 }  // namespace radray
@@ -0,0 +1,187 @@
+// DerivedDataCache: 完整键命中、任一键分量变化即未命中、跨实例持久、损坏条目丢弃、
+// 超出字节上限时按最近使用淘汰。
+//
+// 【不需要 device】被测的只是磁盘缓存, 产物是任意字节。
+
+#include <radray/runtime/derived_data_cache.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include <gtest/gtest.h>
+
+#include <fmt/format.h>
+
+#include <radray/guid.h>
+#include <radray/types.h>
+
+namespace radray {
+namespace {
+
+vector<byte> MakePayload(size_t size, uint8_t seed) {
+    vector<byte> payload(size);
+    for (size_t i = 0; i < size; ++i) {
+        payload[i] = static_cast<byte>(static_cast<uint8_t>(seed + i * 31));
+    }
+    return payload;
+}
+
+DerivedDataKey MakeKey(uint64_t sourceHash) noexcept {
+    return DerivedDataKey{
+        .ImporterType = "texture",
+        .ImporterVersion = 1,
+        .SourceHash = sourceHash,
+        .SettingsHash = 0x5e77'1265};
+}
+
+class DerivedDataCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::error_code error;
+        _directory = std::filesystem::temp_directory_path(error) /
+                     fmt::format("radray_derived_data_{}", Guid::NewGuid());
+        ASSERT_FALSE(error);
+    }
+
+    void TearDown() override {
+        std::error_code error;
+        std::filesystem::remove_all(_directory, error);
+    }
+
+    unique_ptr<DerivedDataCache> OpenCache(uint64_t maxBytes = 1ull << 20) const {
+        return make_unique<DerivedDataCache>(DerivedDataCacheDescriptor{.Directory = _directory, .MaxBytes = maxBytes});
+    }
+
+    vector<std::filesystem::path> ListEntries() const {
+        vector<std::filesystem::path> entries;
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator{_directory}) {
+            entries.push_back(entry.path());
+        }
+        return entries;
+    }
+
+    std::filesystem::path _directory;
+};
+
+TEST_F(DerivedDataCacheTest, PutThenGetReturnsThePayloadAndCountsHits) {
+    unique_ptr<DerivedDataCache> cache = OpenCache();
+    const vector<byte> payload = MakePayload(4096, 7);
+
+    EXPECT_FALSE(cache->Get(MakeKey(1)).has_value());
+    ASSERT_TRUE(cache->Put(MakeKey(1), payload, 25.0));
+    const std::optional<vector<byte>> cached = cache->Get(MakeKey(1));
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached.value(), payload);
+
+    const DerivedDataStats stats = cache->GetStats("texture");
+    EXPECT_EQ(stats.Hits, 1u);
+    EXPECT_EQ(stats.Misses, 1u);
+    EXPECT_EQ(stats.Writes, 1u);
+    EXPECT_DOUBLE_EQ(stats.GetHitRate(), 0.5);
+    EXPECT_GT(stats.SavedMilliseconds, 0.0);
+    EXPECT_EQ(cache->GetStats("mesh").Hits + cache->GetStats("mesh").Misses, 0u);
+    EXPECT_EQ(cache->GetEntryCount(), 1u);
+}
+
+TEST_F(DerivedDataCacheTest, EveryKeyComponentSeparatesEntries) {
+    unique_ptr<DerivedDataCache> cache = OpenCache();
+    ASSERT_TRUE(cache->Put(MakeKey(1), MakePayload(64, 1), 1.0));
+
+    DerivedDataKey otherType = MakeKey(1);
+    otherType.ImporterType = "mesh";
+    DerivedDataKey otherVersion = MakeKey(1);
+    otherVersion.ImporterVersion = 2;
+    DerivedDataKey otherSettings = MakeKey(1);
+    otherSettings.SettingsHash = 0;
+    EXPECT_FALSE(cache->Get(otherType).has_value());
+    EXPECT_FALSE(cache->Get(otherVersion).has_value());
+    EXPECT_FALSE(cache->Get(otherSettings).has_value());
+    EXPECT_FALSE(cache->Get(MakeKey(2)).has_value());
+    EXPECT_TRUE(cache->Get(MakeKey(1)).has_value());
+}
+
+TEST_F(DerivedDataCacheTest, EntriesSurviveReopeningTheDirectory) {
+    const vector<byte> payload = MakePayload(1000, 3);
+    {
+        unique_ptr<DerivedDataCache> cache = OpenCache();
+        ASSERT_TRUE(cache->Put(MakeKey(9), payload, 10.0));
+    }
+    unique_ptr<DerivedDataCache> reopened = OpenCache();
+    EXPECT_EQ(reopened->GetEntryCount(), 1u);
+    EXPECT_GT(reopened->GetTotalBytes(), payload.size());
+    const std::optional<vector<byte>> cached = reopened->Get(MakeKey(9));
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached.value(), payload);
+}
+
+TEST_F(DerivedDataCacheTest, CorruptEntriesMissAndAreRemoved) {
+    unique_ptr<DerivedDataCache> cache = OpenCache();
+    ASSERT_TRUE(cache->Put(MakeKey(4), MakePayload(512, 4), 1.0));
+    const vector<std::filesystem::path> entries = ListEntries();
+    ASSERT_EQ(entries.size(), 1u);
+    {
+        // 改写产物中间的一个字节: 长度与尾部都完好, 只有内容哈希能发现。
+        std::fstream file{entries[0], std::ios::binary | std::ios::in | std::ios::out};
+        ASSERT_TRUE(file.is_open());
+        file.seekp(100);
+        file.put('\x5a');
+    }
+
+    EXPECT_FALSE(cache->Get(MakeKey(4)).has_value());
+    EXPECT_EQ(cache->GetEntryCount(), 0u);
+    EXPECT_EQ(cache->GetTotalBytes(), 0u);
+    EXPECT_TRUE(ListEntries().empty());
+}
+
+TEST_F(DerivedDataCacheTest, MapReturnsThePayloadInPlaceAndDropsCorruptEntries) {
+    unique_ptr<DerivedDataCache> cache = OpenCache();
+    const vector<byte> payload = MakePayload(3000, 5);
+    EXPECT_FALSE(cache->Map(MakeKey(5)).has_value());
+    ASSERT_TRUE(cache->Put(MakeKey(5), payload, 12.0));
+    {
+        std::optional<MappedDerivedData> mapped = cache->Map(MakeKey(5));
+        ASSERT_TRUE(mapped.has_value());
+        // payload 在条目最前, 起点就是映射起点。
+        EXPECT_EQ(mapped->Payload.data(), mapped->File.GetData().data());
+        EXPECT_TRUE(std::equal(mapped->Payload.begin(), mapped->Payload.end(), payload.begin(), payload.end()));
+    }
+    EXPECT_EQ(cache->GetStats("texture").Hits, 1u);
+
+    {
+        std::fstream file{ListEntries().at(0), std::ios::binary | std::ios::in | std::ios::out};
+        ASSERT_TRUE(file.is_open());
+        file.seekp(10);
+        file.put('\x11');
+    }
+    EXPECT_FALSE(cache->Map(MakeKey(5)).has_value());
+    EXPECT_EQ(cache->GetEntryCount(), 0u);
+    EXPECT_TRUE(ListEntries().empty());
+}
+
+TEST_F(DerivedDataCacheTest, LeastRecentlyUsedEntriesAreEvictedOverTheByteCap) {
+    // 每个条目 1000 字节产物加不到 100 字节 footer, 上限只容得下三个。
+    unique_ptr<DerivedDataCache> cache = OpenCache(3500);
+    ASSERT_TRUE(cache->Put(MakeKey(1), MakePayload(1000, 1), 1.0));
+    ASSERT_TRUE(cache->Put(MakeKey(2), MakePayload(1000, 2), 1.0));
+    ASSERT_TRUE(cache->Put(MakeKey(3), MakePayload(1000, 3), 1.0));
+    // 用一次 1, 让 2 成为最久未用。
+    ASSERT_TRUE(cache->Get(MakeKey(1)).has_value());
+    ASSERT_TRUE(cache->Put(MakeKey(4), MakePayload(1000, 4), 1.0));
+
+    EXPECT_EQ(cache->GetEntryCount(), 3u);
+    EXPECT_LE(cache->GetTotalBytes(), 3500u);
+    EXPECT_TRUE(cache->Get(MakeKey(1)).has_value());
+    EXPECT_FALSE(cache->Get(MakeKey(2)).has_value());
+    EXPECT_TRUE(cache->Get(MakeKey(3)).has_value());
+    EXPECT_TRUE(cache->Get(MakeKey(4)).has_value());
+    EXPECT_EQ(ListEntries().size(), 3u);
+
+    // 单个就超出上限的产物不写入, 也不挤掉已有条目。
+    EXPECT_FALSE(cache->Put(MakeKey(5), MakePayload(4000, 5), 1.0));
+    EXPECT_EQ(cache->GetEntryCount(), 3u);
+}
+
+}  // namespace
+}  // namespace radray
@@ -2,10 +2,17 @@
 // view/object constant packing, material set preparation and the recorded draw. Every
 // other test in the runtime drives the pieces directly, so this is the only place where
 // PrepareCamera and the draw pass actually run against a live swapchain.
+//
+// The draw list test reads ForwardPipeline::GetStats after a steady-state frame to check
+// that the per-draw dynamic offset lists stayed in their inline storage.
+//
+// The imported dependency test goes through the same Application loop with an asset root,
+// so the real OBJ and texture importers run against GpuSystem uploads.
 #include <radray/runtime/forward_pipeline/forward_pipeline.h>
 
 #include <radray/logger.h>
 #include <radray/runtime/application.h>
+#include <radray/runtime/asset_database.h>
 #include <radray/runtime/asset_manager.h>
 #include <radray/runtime/components/camera_component.h>
 #include <radray/runtime/components/directional_light_component.h>
@@ -18,13 +25,16 @@
 #include <radray/runtime/shader_program.h>
 #include <radray/runtime/static_mesh.h>
 #include <radray/runtime/texture_asset.h>
+#include <radray/runtime/texture_container.h>
 #include <radray/runtime/window_manager.h>
 #include <radray/window/native_window.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 #include <filesystem>
+#include <fstream>
 #include <span>
 
 #if defined(RADRAY_PLATFORM_WINDOWS) || defined(_WIN32)
@@ -143,12 +153,17 @@ struct ForwardPipelineRunResult {
     bool MaterialSetResident{false};
     bool SawError{false};
     string FirstError;
+    /// ForwardPipeline stats of the last frame before shutdown.
+    ForwardPipelineStats LastStats{};
 };
 
 class ForwardPipelineTestApp final : public Application {
 public:
-    explicit ForwardPipelineTestApp(ForwardPipelineRunResult* result) noexcept
-        : _result(result) {}
+    ForwardPipelineTestApp(
+        ForwardPipelineRunResult* result,
+        uint32_t quadCount = 1) noexcept
+        : _result(result),
+          _quadCount(quadCount) {}
 
 protected:
     void OnInit() override {
@@ -181,11 +196,13 @@ protected:
             groups.ViewGroup,
             groups.MaterialGroup,
             groups.ObjectGroup};
-        const shader::KeywordAssignment assignment{.Name = "QUALITY", .Value = "high"};
+        const shader::KeywordAssignment assignments[]{
+            {.Name = "QUALITY", .Value = "high"},
+            {.Name = "VERTEX_FORMAT", .Value = "float"}};
         const Nullable<ShaderProgram*> program =
             GetRenderSystem()->GetOrCreateShaderProgram(
                 "pipelines/forward/forward.hlsl",
-                std::span{&assignment, 1},
+                assignments,
                 render::ShaderLayoutPolicy{.DynamicBufferGroups = dynamicGroups});
         if (!program.HasValue()) {
             Fail("forward shader program creation failed");
@@ -218,10 +235,17 @@ protected:
         camera->SetWorldLocation(Eigen::Vector3f{0.0f, 0.0f, -3.0f});
         camera->SetPerspective(Radian(55.0f), 0.1f, 100.0f);
 
-        _meshActor = GetWorld()->SpawnActor<Actor>();
-        _meshComponent = _meshActor.Get()->AddComponent<StaticMeshComponent>();
-        _meshActor.Get()->SetRootComponent(_meshComponent.Get());
-        _meshComponent.Get()->SetMaterial(0, _material.get());
+        for (uint32_t index = 0; index < _quadCount; ++index) {
+            Nullable<Actor*> meshActor = GetWorld()->SpawnActor<Actor>();
+            StaticMeshComponent* meshComponent =
+                meshActor.Get()->AddComponent<StaticMeshComponent>();
+            meshActor.Get()->SetRootComponent(meshComponent);
+            meshComponent->SetWorldLocation(
+                Eigen::Vector3f{static_cast<float>(index) * 0.5f, 0.0f, 0.0f});
+            meshComponent->SetMaterial(0, _material.get());
+            _meshActors.push_back(meshActor);
+            _meshComponents.push_back(meshComponent);
+        }
 
         // One light of each kind so both loops in FillViewParameters run.
         _dirLightActor = GetWorld()->SpawnActor<Actor>();
@@ -238,14 +262,18 @@ protected:
         pointLight->SetWorldLocation(Eigen::Vector3f{1.0f, 1.0f, -2.0f});
         pointLight->SetIntensity(2.0f);
 
-        GetRenderSystem()->SetPipeline(
-            make_unique<ForwardPipeline>(this, GetWorld()->GetScene(), camera));
+        unique_ptr<ForwardPipeline> pipeline =
+            make_unique<ForwardPipeline>(this, GetWorld()->GetScene(), camera);
+        _pipeline = pipeline.get();
+        GetRenderSystem()->SetPipeline(std::move(pipeline));
         _result->InitSucceeded = true;
     }
 
     void OnUpdate(const AppUpdateContext&) override {
-        if (!_result->MeshAssigned && _mesh.IsReady() && _meshComponent.HasValue()) {
-            _meshComponent.Get()->SetStaticMesh(_mesh);
+        if (!_result->MeshAssigned && _mesh.IsReady() && !_meshComponents.empty()) {
+            for (StaticMeshComponent* meshComponent : _meshComponents) {
+                meshComponent->SetStaticMesh(_mesh);
+            }
             _result->MeshAssigned = true;
         } else if (_mesh.IsFaulted() || _mesh.IsCanceled()) {
             Fail("mesh loading failed");
@@ -277,15 +305,25 @@ protected:
         }
         World* world = GetWorld();
         if (world != nullptr) {
+            for (Nullable<Actor*>& actor : _meshActors) {
+                if (actor.HasValue()) {
+                    world->DestroyActor(actor.Get());
+                }
+            }
             for (Nullable<Actor*>* actor :
-                 {&_meshActor, &_pointLightActor, &_dirLightActor, &_cameraActor}) {
+                 {&_pointLightActor, &_dirLightActor, &_cameraActor}) {
                 if (actor->HasValue()) {
                     world->DestroyActor(actor->Get());
                 }
                 *actor = nullptr;
             }
         }
-        _meshComponent = nullptr;
+        _meshActors.clear();
+        _meshComponents.clear();
+        if (_pipeline != nullptr) {
+            _result->LastStats = _pipeline->GetStats();
+            _pipeline = nullptr;
+        }
         if (GetRenderSystem() != nullptr) {
             GetRenderSystem()->SetPipeline(nullptr);
         }
@@ -322,22 +360,194 @@ private:
     }
 
     ForwardPipelineRunResult* _result;
+    uint32_t _quadCount;
+    ForwardPipeline* _pipeline{nullptr};
     StreamingAssetRef<StaticMesh> _mesh;
     StreamingAssetRef<TextureAsset> _texture;
     unique_ptr<Material> _material;
     ShaderProgram* _program{nullptr};
     Nullable<Actor*> _cameraActor{nullptr};
-    Nullable<Actor*> _meshActor{nullptr};
     Nullable<Actor*> _dirLightActor{nullptr};
     Nullable<Actor*> _pointLightActor{nullptr};
-    Nullable<StaticMeshComponent*> _meshComponent{nullptr};
+    vector<Nullable<Actor*>> _meshActors;
+    vector<StaticMeshComponent*> _meshComponents;
 };
 
-void RunForwardPipeline(render::RenderBackend backend) {
-    const std::filesystem::path projectRoot{RADRAY_PROJECT_DIR};
-    ForwardPipelineRunResult result;
-    ForwardPipelineTestApp app{&result};
-    const ApplicationRuntimeDescriptor descriptor{
+constexpr uint32_t kMaxImportFrames = 600;
+constexpr std::string_view kImportedMeshGuid = "6f1d2a3b-4c5d-4e6f-8a7b-9c0d1e2f3a4b";
+constexpr std::string_view kImportedTextureGuid = "7a2b3c4d-5e6f-4a70-8b9c-0d1e2f3a4b5c";
+
+/// Temporary asset root: an OBJ whose MTL samples a 1x1 .rrtex, and a manifest that
+/// registers the mesh and the texture but no dependency between them.
+class ImportedAssetRoot {
+public:
+    ImportedAssetRoot() {
+        std::error_code error;
+        _path = std::filesystem::temp_directory_path(error) /
+                fmt::format("radray_forward_import_{}", Guid::NewGuid());
+        if (error || !std::filesystem::create_directories(_path, error)) {
+            return;
+        }
+        constexpr std::array<byte, 4> white{byte{0xff}, byte{0xff}, byte{0xff}, byte{0xff}};
+        const std::array<std::span<const byte>, 1> levels{std::span<const byte>{white}};
+        const vector<byte> texture = EncodeTextureContainer(1, 1, TextureCompression::None, false, levels);
+        _valid = !texture.empty() &&
+                 Write("quad.obj",
+                       "mtllib quad.mtl\n"
+                       "v -1 -1 0\nv 1 -1 0\nv 1 1 0\nv -1 1 0\n"
+                       "vt 0 1\nvt 1 1\nvt 1 0\nvt 0 0\n"
+                       "vn 0 0 -1\n"
+                       "usemtl white\n"
+                       "f 1/1/1 2/2/1 3/3/1\nf 1/1/1 3/3/1 4/4/1\n") &&
+                 Write("quad.mtl", "newmtl white\nmap_Kd -bm 1 textures/white.rrtex\n") &&
+                 Write("textures/white.rrtex",
+                       std::string_view{reinterpret_cast<const char*>(texture.data()), texture.size()}) &&
+                 Write("assets.json",
+                       fmt::format(
+                           R"({{"version":1,"assets":[)"
+                           R"({{"guid":"{}","path":"quad.obj","type":"mesh"}},)"
+                           R"({{"guid":"{}","path":"textures/white.rrtex","type":"texture"}}]}})",
+                           kImportedMeshGuid,
+                           kImportedTextureGuid));
+    }
+
+    ~ImportedAssetRoot() noexcept {
+        std::error_code error;
+        std::filesystem::remove_all(_path, error);
+    }
+
+    ImportedAssetRoot(const ImportedAssetRoot&) = delete;
+    ImportedAssetRoot& operator=(const ImportedAssetRoot&) = delete;
+
+    bool IsValid() const noexcept { return _valid; }
+    const std::filesystem::path& GetPath() const noexcept { return _path; }
+
+private:
+    bool Write(std::string_view relPath, std::string_view text) const {
+        const std::filesystem::path path = _path / std::filesystem::path{relPath};
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+        std::ofstream file{path, std::ios::binary};
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        return static_cast<bool>(file);
+    }
+
+    std::filesystem::path _path;
+    bool _valid{false};
+};
+
+/// Result the imported dependency test asserts on after the app loop returns.
+struct ImportedDependencyRunResult {
+    bool MeshReady{false};
+    bool DependencyRecorded{false};
+    bool TextureLoadedByMeshImport{false};
+    bool PrefetchIncludedTexture{false};
+    bool TextureReadyAfterPrefetch{false};
+    bool SawError{false};
+    string FirstError;
+};
+
+/// Loads the mesh by id, then prefetches it. The texture is only reachable through the
+/// dependency the mesh import recorded, so the prefetch loading it proves the round trip.
+class ImportedDependencyTestApp final : public Application {
+public:
+    explicit ImportedDependencyTestApp(ImportedDependencyRunResult* result) noexcept
+        : _result(result) {}
+
+protected:
+    void OnInit() override {
+        if (GetAssetManager() == nullptr || GetAssetDatabase() == nullptr) {
+            Fail("asset database is unavailable");
+            return;
+        }
+        _mesh = GetAssetManager()->Load<StaticMesh>(Guid::Parse(kImportedMeshGuid));
+        if (!_mesh.IsValid()) {
+            Fail("mesh load was rejected");
+        }
+    }
+
+    void OnUpdate(const AppUpdateContext&) override {
+        if (_result->SawError) {
+            return;
+        }
+        if (++_frames > kMaxImportFrames) {
+            Fail("imported assets did not finish loading");
+            return;
+        }
+        const AssetId meshId = Guid::Parse(kImportedMeshGuid);
+        const AssetId textureId = Guid::Parse(kImportedTextureGuid);
+        if (!_prefetched) {
+            if (_mesh.IsFaulted() || _mesh.IsCanceled()) {
+                Fail("mesh import failed");
+                return;
+            }
+            if (!_mesh.IsReady()) {
+                return;
+            }
+            _result->MeshReady = true;
+            const std::span<const AssetId> dependencies = GetAssetDatabase()->GetDependencies(meshId);
+            _result->DependencyRecorded =
+                std::find(dependencies.begin(), dependencies.end(), textureId) != dependencies.end();
+            _result->TextureLoadedByMeshImport = GetAssetManager()->Find(textureId).IsValid();
+            const AssetId roots[]{meshId};
+            _group = GetAssetManager()->Prefetch(roots);
+            for (const StreamingAssetRefAny& ref : _group.GetRefs()) {
+                if (ref.GetAssetId() == textureId) {
+                    _result->PrefetchIncludedTexture = true;
+                }
+            }
+            _prefetched = true;
+            return;
+        }
+        if (!_group.IsCompleted()) {
+            return;
+        }
+        _result->TextureReadyAfterPrefetch = GetAssetManager()->Find(textureId).IsReady();
+        RequestClose();
+    }
+
+    void OnShutdown() override {
+        _group = AssetLoadGroup{};
+        _mesh.Reset();
+    }
+
+private:
+    void Fail(std::string_view message) {
+        if (!_result->SawError) {
+            _result->SawError = true;
+            _result->FirstError = string{message};
+        }
+        RequestClose();
+    }
+
+    void RequestClose() {
+#if defined(_WIN32)
+        WindowManager* windows = GetWindowManager();
+        if (windows == nullptr) {
+            return;
+        }
+        AppWindow* main = windows->GetMainWindow();
+        if (main == nullptr || main->GetNativeWindow() == nullptr) {
+            return;
+        }
+        auto handle = static_cast<HWND>(main->GetNativeWindow()->GetNativeHandler());
+        if (handle != nullptr) {
+            ::PostMessageW(handle, WM_CLOSE, 0, 0);
+        }
+#endif
+    }
+
+    ImportedDependencyRunResult* _result;
+    StreamingAssetRef<StaticMesh> _mesh;
+    AssetLoadGroup _group;
+    uint32_t _frames{0};
+    bool _prefetched{false};
+};
+
+ApplicationRuntimeDescriptor MakeRuntimeDescriptor(
+    render::RenderBackend backend,
+    const std::filesystem::path& projectRoot) {
+    return ApplicationRuntimeDescriptor{
         .Backend = backend,
         .EnableValidation = false,
         .Multithreaded = false,
@@ -354,7 +564,13 @@ void RunForwardPipeline(render::RenderBackend backend) {
         .FlightDataCount = 2,
         .BackBufferFormat = render::TextureFormat::BGRA8_UNORM,
         .PresentMode = render::PresentMode::FIFO};
-    ASSERT_EQ(app.Run(descriptor), 0);
+}
+
+void RunForwardPipeline(render::RenderBackend backend) {
+    const std::filesystem::path projectRoot{RADRAY_PROJECT_DIR};
+    ForwardPipelineRunResult result;
+    ForwardPipelineTestApp app{&result};
+    ASSERT_EQ(app.Run(MakeRuntimeDescriptor(backend, projectRoot)), 0);
 
     EXPECT_FALSE(result.SawError) << result.FirstError;
     EXPECT_TRUE(result.InitSucceeded);
@@ -367,6 +583,42 @@ void RunForwardPipeline(render::RenderBackend backend) {
     EXPECT_TRUE(result.MaterialSetResident);
 }
 
+// Each draw carries one view, one material and one object offset list. Those must stay
+// inside their SmallVector storage, so a steady-state frame never allocates per draw for them.
+void RunForwardDrawListsStayInline(render::RenderBackend backend) {
+    constexpr uint32_t kQuadCount = 4;
+    const std::filesystem::path projectRoot{RADRAY_PROJECT_DIR};
+    ForwardPipelineRunResult result;
+    ForwardPipelineTestApp app{&result, kQuadCount};
+    ASSERT_EQ(app.Run(MakeRuntimeDescriptor(backend, projectRoot)), 0);
+    ASSERT_FALSE(result.SawError) << result.FirstError;
+    ASSERT_GE(result.FramesRun, kFrameCount);
+
+    EXPECT_EQ(result.LastStats.PreparedDrawCount, kQuadCount);
+    EXPECT_EQ(result.LastStats.ValidDrawCount, kQuadCount);
+    EXPECT_EQ(result.LastStats.HeapDrawListCount, 0u)
+        << "per-draw dynamic offset lists spilled to the heap";
+}
+
+// The mesh import reports the texture its MTL samples; the manager records it as a
+// dependency, and a later prefetch of the mesh alone brings the texture in.
+void RunImportedDependencyPrefetch(render::RenderBackend backend) {
+    const ImportedAssetRoot assetRoot;
+    ASSERT_TRUE(assetRoot.IsValid());
+    ApplicationRuntimeDescriptor desc = MakeRuntimeDescriptor(backend, std::filesystem::path{RADRAY_PROJECT_DIR});
+    desc.AssetRoot = assetRoot.GetPath();
+    ImportedDependencyRunResult result;
+    ImportedDependencyTestApp app{&result};
+    ASSERT_EQ(app.Run(desc), 0);
+
+    EXPECT_FALSE(result.SawError) << result.FirstError;
+    EXPECT_TRUE(result.MeshReady);
+    EXPECT_TRUE(result.DependencyRecorded);
+    EXPECT_FALSE(result.TextureLoadedByMeshImport);
+    EXPECT_TRUE(result.PrefetchIncludedTexture);
+    EXPECT_TRUE(result.TextureReadyAfterPrefetch);
+}
+
 }  // namespace
 
 #if defined(RADRAY_ENABLE_D3D12)
@@ -381,4 +633,28 @@ TEST(RadRayRuntimeForwardPipeline, VulkanDrawsCollectedMeshThroughForwardPipelin
 }
 #endif
 
+#if defined(RADRAY_ENABLE_D3D12)
+TEST(RadRayRuntimeForwardPipeline, D3D12PerDrawListsStayInline) {
+    RunForwardDrawListsStayInline(render::RenderBackend::D3D12);
+}
+#endif
+
+#if defined(RADRAY_ENABLE_VULKAN)
+TEST(RadRayRuntimeForwardPipeline, VulkanPerDrawListsStayInline) {
+    RunForwardDrawListsStayInline(render::RenderBackend::Vulkan);
+}
+#endif
+
+#if defined(RADRAY_ENABLE_D3D12)
+TEST(RadRayRuntimeForwardPipeline, D3D12PrefetchLoadsImportedDependency) {
+    RunImportedDependencyPrefetch(render::RenderBackend::D3D12);
+}
+#endif
+
+#if defined(RADRAY_ENABLE_VULKAN)
+TEST(RadRayRuntimeForwardPipeline, VulkanPrefetchLoadsImportedDependency) {
+    RunImportedDependencyPrefetch(render::RenderBackend::Vulkan);
+}
+#endif
+
 }  // namespace radray
@@ -1,4 +1,5 @@
 #include <radray/render/backend/pipeline_layout_types.h>
+#include <radray/triangle_mesh.h>
 #include <radray/runtime/render_framework/primitive_vertex_layout.h>
 #include <radray/runtime/shader_parameters.h>
 
@@ -10,6 +11,7 @@
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <utility>
 
 namespace radray {
 namespace {
@@ -130,6 +132,40 @@ TEST(RadRayRuntimeMaterial, PrimitiveVertexLayoutResolvesAgainstArtifact) {
     EXPECT_FALSE(PrimitiveVertexLayout::FromMeshPrimitive(multipleStreams).has_value());
 }
 
+TEST(RadRayRuntimeMaterial, PrimitiveVertexLayoutMapsQuantizedFormats) {
+    TriangleMesh sphere;
+    sphere.InitAsUVSphere(1.0f, 8);
+    sphere.CalculateTangent();
+    sphere.Color0.assign(sphere.Positions.size(), Eigen::Vector4f{1.0f, 0.5f, 0.25f, 1.0f});
+    MeshResource resource;
+    sphere.ToQuantizedMeshResource(&resource);
+    ASSERT_EQ(resource.Primitives.size(), 1u);
+
+    const auto layout = PrimitiveVertexLayout::FromMeshPrimitive(resource.Primitives[0]);
+    ASSERT_TRUE(layout.has_value());
+    ASSERT_EQ(layout->Buffers.size(), 1u);
+    EXPECT_EQ(layout->Buffers[0].ArrayStride, 24u);
+    const std::pair<std::string_view, render::VertexFormat> expected[] = {
+        {"POSITION", render::VertexFormat::UNORM16X4},
+        {"NORMAL", render::VertexFormat::SNORM16X2},
+        {"TEXCOORD", render::VertexFormat::FLOAT16X2},
+        {"TANGENT", render::VertexFormat::UNORM10_10_10_2},
+        {"COLOR", render::VertexFormat::UNORM8X4}};
+    ASSERT_EQ(layout->Attributes.size(), std::size(expected));
+    for (size_t index = 0; index < std::size(expected); ++index) {
+        EXPECT_EQ(layout->Attributes[index].Semantic, expected[index].first);
+        EXPECT_EQ(layout->Attributes[index].Format, expected[index].second) << expected[index].first;
+    }
+
+    // The RHI only has two and four component versions of the 8 and 16 bit formats.
+    MeshPrimitive threeHalves = resource.Primitives[0];
+    threeHalves.VertexBuffers[2].ComponentCount = 3;
+    EXPECT_FALSE(PrimitiveVertexLayout::FromMeshPrimitive(threeHalves).has_value());
+    MeshPrimitive packedPair = resource.Primitives[0];
+    packedPair.VertexBuffers[3].ComponentCount = 2;
+    EXPECT_FALSE(PrimitiveVertexLayout::FromMeshPrimitive(packedPair).has_value());
+}
+
 TEST(RadRayRuntimeMaterial, TypeTreePacksNestedArraysAndMatrices) {
     const auto artifact = DecodeGeneric("nested_types");
     ASSERT_TRUE(artifact.has_value());
@@ -9,12 +9,14 @@
 #include <radray/runtime/render_framework/scene.h>
 #include <radray/runtime/render_framework/viewport.h>
 #include <radray/runtime/shader_program.h>
+#include <radray/runtime/static_mesh.h>
 #include <radray/runtime/texture_asset.h>
 #include <radray/runtime/wait_frame.h>
 
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
@@ -570,7 +572,7 @@ public:
     Eigen::Matrix4f GetLocalToWorld() const noexcept override {
         return _localToWorld;
     }
-    MeshDrawArgs GetDrawArgs(uint32_t sectionIndex) const noexcept override {
+    MeshDrawArgs GetDrawArgs(uint32_t sectionIndex, uint32_t /*lodIndex*/) const noexcept override {
         return sectionIndex < _draws.size() ? _draws[sectionIndex] : MeshDrawArgs{};
     }
     uint32_t GetSectionCount() const noexcept override {
@@ -668,8 +670,12 @@ void RunDrawListSort(render::test::DeviceContext& context) {
         {draw(55, 7, -5), draw(56, 8, -6)},
         {transparent.get(), transparent.get()},
         5.0f);
+    // 量化顶点的 draw: 反量化并进 LocalToWorld, 排序用的视深仍取物体原点。
+    MeshDrawArgs quantizedDraw = draw(66, 9, -7);
+    quantizedDraw.PositionOffset = Eigen::Vector3f{1.0f, 2.0f, 3.0f};
+    quantizedDraw.PositionScale = 4.0f;
     TestPrimitiveComponent nearTransparent(
-        {draw(66, 9, -7)},
+        {quantizedDraw},
         {transparent.get()},
         2.0f);
 
@@ -724,6 +730,41 @@ void RunDrawListSort(render::test::DeviceContext& context) {
     EXPECT_EQ(items[4].VertexOffset, -5);
     EXPECT_EQ(items[5].FirstIndex, 56u);
     EXPECT_EQ(items[6].FirstIndex, 66u);
+    const Eigen::Vector4f dequantized = items[6].LocalToWorld * Eigen::Vector4f{0.5f, 0.25f, 1.0f, 1.0f};
+    EXPECT_TRUE(dequantized.isApprox(Eigen::Vector4f{3.0f, 3.0f, 9.0f, 1.0f}));
+    EXPECT_EQ(items[4].LocalToWorld(0, 0), 1.0f);
+}
+
+TEST(RadRayRuntimeMeshDraw, StaticMeshLodFollowsErrorBudget) {
+    // 两级: LOD0 是两个三角形的四边形, LOD1 只剩一个三角形, 接在 LOD0 后面。
+    const std::array<float, 12> positions{0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0};
+    const std::array<uint32_t, 9> indices{0, 1, 2, 0, 2, 3, 0, 1, 2};
+    MeshResource mesh;
+    mesh.Bins.emplace_back(std::as_bytes(std::span{positions}));
+    mesh.Bins.emplace_back(std::as_bytes(std::span{indices}));
+    MeshPrimitive& primitive = mesh.Primitives.emplace_back();
+    primitive.VertexCount = 4;
+    primitive.IndexBuffer = IndexBufferEntry{.BufferIndex = 1, .IndexCount = 9, .Offset = 0, .Stride = 4};
+    primitive.VertexBuffers.push_back(VertexBufferEntry{
+        .Semantic = string{VertexSemantics::POSITION},
+        .ComponentCount = 3,
+        .Offset = 0,
+        .Stride = sizeof(float) * 3});
+    primitive.Lods = {{.FirstIndex = 0, .IndexCount = 6, .Error = 0.0f}, {.FirstIndex = 6, .IndexCount = 3, .Error = 0.5f}};
+    EXPECT_TRUE(IsStaticMeshDataValid(mesh, {}));
+
+    EXPECT_EQ(SelectStaticMeshLod(primitive.Lods, 0.0f), 0u);
+    EXPECT_EQ(SelectStaticMeshLod(primitive.Lods, 0.49f), 0u);
+    EXPECT_EQ(SelectStaticMeshLod(primitive.Lods, 0.5f), 1u);
+    EXPECT_EQ(SelectStaticMeshLod(primitive.Lods, 100.0f), 1u);
+    EXPECT_EQ(SelectStaticMeshLod({}, 100.0f), 0u);
+
+    // LOD 范围越出索引 buffer 或误差非法的数据不可上传。
+    primitive.Lods[1].IndexCount = 6;
+    EXPECT_FALSE(IsStaticMeshDataValid(mesh, {}));
+    primitive.Lods[1].IndexCount = 3;
+    primitive.Lods[1].Error = std::numeric_limits<float>::quiet_NaN();
+    EXPECT_FALSE(IsStaticMeshDataValid(mesh, {}));
 }
 
 TEST(RadRayRuntimeMeshDraw, DrawListClustersOpaqueAndSortsTransparentStably) {
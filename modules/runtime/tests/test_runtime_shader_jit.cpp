@@ -472,7 +472,7 @@ TEST(RadRayRuntimeShaderJit, ShaderlibPassMetadataCorruptionFailsClosed) {
         .SourceName = string{sourceName},
         .RootSource = source,
         .Defines = {},
-        .Assignments = {{"QUALITY", "low"}},
+        .Assignments = {{"QUALITY", "low"}, {"VERTEX_FORMAT", "float"}},
         .Targets = shader::ShaderTargetMask::DXIL,
         .ExpectedContract = contract.value()};
 
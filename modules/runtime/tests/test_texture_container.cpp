@@ -0,0 +1,114 @@
+// TextureContainer: 编码后的布局 (小 mip 在前、行距与起点对齐)、逐级往返、块压缩尺寸、
+// 以及截断 / 改坏 header 的文件被拒绝。
+//
+// 【不需要 device】容器只是 CPU 侧字节布局。
+
+#include <radray/runtime/texture_container.h>
+
+#include <algorithm>
+#include <array>
+
+#include <gtest/gtest.h>
+
+#include <radray/mip_chain.h>
+#include <radray/types.h>
+
+namespace radray {
+namespace {
+
+Rgba8MipChain MakeMips(uint32_t width, uint32_t height) {
+    vector<byte> pixels(size_t{width} * height * 4);
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        pixels[i] = static_cast<byte>(static_cast<uint8_t>(i * 7 + i / 13));
+    }
+    return BuildRgba8MipChain(pixels, width, height, MipChainOptions{});
+}
+
+vector<std::span<const byte>> GetLevels(const Rgba8MipChain& mips) {
+    vector<std::span<const byte>> levels;
+    for (uint32_t mipLevel = 0; mipLevel < mips.GetLevelCount(); ++mipLevel) {
+        levels.push_back(mips.GetLevel(mipLevel));
+    }
+    return levels;
+}
+
+TEST(TextureContainerTest, SmallestMipsComeFirstWithAlignedRowsAndOffsets) {
+    const Rgba8MipChain mips = MakeMips(100, 40);
+    const vector<byte> bytes = EncodeTextureContainer(100, 40, TextureCompression::None, true, GetLevels(mips));
+    const std::optional<TextureContainer> container = TextureContainer::Parse(bytes);
+    ASSERT_TRUE(container.has_value());
+    EXPECT_EQ(container->GetMipCount(), mips.GetLevelCount());
+    EXPECT_TRUE(container->IsSrgb());
+    EXPECT_EQ(container->GetFormat(), render::TextureFormat::RGBA8_UNORM_SRGB);
+
+    for (uint32_t mipLevel = 0; mipLevel < container->GetMipCount(); ++mipLevel) {
+        const TextureContainerMip& mip = container->GetMip(mipLevel);
+        EXPECT_EQ(mip.Offset % 512, 0u);
+        EXPECT_EQ(mip.RowPitch % 256, 0u);
+        EXPECT_EQ(mip.Width, mips.GetLevelWidth(mipLevel));
+        EXPECT_EQ(mip.RowCount, mips.GetLevelHeight(mipLevel));
+        if (mipLevel > 0) {
+            EXPECT_LT(mip.Offset, container->GetMip(mipLevel - 1).Offset);
+        }
+        // 逐行去掉补齐后与输入一致。
+        const std::span<const byte> data = container->GetMipData(mipLevel);
+        const std::span<const byte> expected = mips.GetLevel(mipLevel);
+        const size_t tightRowPitch = size_t{mip.Width} * 4;
+        for (uint32_t row = 0; row < mip.RowCount; ++row) {
+            EXPECT_TRUE(std::equal(
+                expected.begin() + row * tightRowPitch,
+                expected.begin() + (row + 1) * tightRowPitch,
+                data.begin() + size_t{row} * mip.RowPitch))
+                << "mip " << mipLevel << " row " << row;
+        }
+    }
+    // mip 0 最大, 放在最后, 文件到它的末尾为止。
+    EXPECT_EQ(container->GetMip(0).Offset + container->GetMip(0).Size, bytes.size());
+}
+
+TEST(TextureContainerTest, BlockCompressedRowsAreRowsOfBlocks) {
+    // 16x8 的 BC7: mip 0 为 4x2 块, 一行块 64 字节; mip 1 为 2x1 块, 行尾补齐到 64。
+    const std::array<vector<byte>, 2> levels{vector<byte>(4 * 2 * 16), vector<byte>(2 * 1 * 16)};
+    const std::array<std::span<const byte>, 2> spans{levels[0], levels[1]};
+    const TextureContainerLayout layout{.RowPitchAlignment = 64, .PlacementAlignment = 16};
+    const vector<byte> bytes = EncodeTextureContainer(16, 8, TextureCompression::BC7, true, spans, layout);
+    const std::optional<TextureContainer> container = TextureContainer::Parse(bytes);
+    ASSERT_TRUE(container.has_value());
+    EXPECT_EQ(container->GetFormat(), render::TextureFormat::BC7_UNORM_SRGB);
+    EXPECT_EQ(container->GetMip(0).RowPitch, 64u);
+    EXPECT_EQ(container->GetMip(0).RowCount, 2u);
+    EXPECT_EQ(container->GetMip(1).RowPitch, 64u);
+    EXPECT_EQ(container->GetMip(1).RowCount, 1u);
+
+    // BC4 / BC5 没有 sRGB 变体。
+    EXPECT_EQ(GetTextureContainerFormat(TextureCompression::BC5, true), render::TextureFormat::BC5_UNORM);
+    // 尺寸不符的输入被拒绝。
+    const std::array<std::span<const byte>, 1> wrongSize{std::span<const byte>{levels[1]}};
+    EXPECT_TRUE(EncodeTextureContainer(16, 8, TextureCompression::BC7, false, wrongSize).empty());
+}
+
+TEST(TextureContainerTest, TruncatedOrCorruptFilesAreRejected) {
+    const Rgba8MipChain mips = MakeMips(32, 32);
+    vector<byte> bytes = EncodeTextureContainer(32, 32, TextureCompression::None, false, GetLevels(mips));
+    ASSERT_TRUE(TextureContainer::Parse(bytes).has_value());
+
+    EXPECT_FALSE(TextureContainer::Parse(std::span<const byte>{bytes}.first(bytes.size() - 1)).has_value());
+    EXPECT_FALSE(TextureContainer::Parse(std::span<const byte>{bytes}.first(16)).has_value());
+
+    vector<byte> badMagic = bytes;
+    badMagic[0] = byte{0};
+    EXPECT_FALSE(TextureContainer::Parse(badMagic).has_value());
+
+    // mip 数超过 32x32 的完整链。
+    vector<byte> tooManyMips = bytes;
+    tooManyMips[16] = byte{7};
+    EXPECT_FALSE(TextureContainer::Parse(tooManyMips).has_value());
+
+    // mip 0 的起点偏离对齐。
+    vector<byte> misaligned = bytes;
+    misaligned[32] = static_cast<byte>(std::to_integer<uint8_t>(misaligned[32]) + 4);
+    EXPECT_FALSE(TextureContainer::Parse(misaligned).has_value());
+}
+
+}  // namespace
+}  // namespace radray
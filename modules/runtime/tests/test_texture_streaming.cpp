@@ -0,0 +1,176 @@
+// 贴图流送的纯计算部分: 屏幕密度到 mip 的换算、逐级字节数、驻留规划 (淘汰次序、上传次序、
+// 每帧与显存预算), 以及 section 的 UV 密度。
+//
+// 【不需要 device】换贴图的录制路径依赖 upload phase, 由运行中的应用覆盖。
+
+#include <radray/runtime/texture_streaming.h>
+
+#include <array>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <radray/runtime/static_mesh.h>
+#include <radray/triangle_mesh.h>
+#include <radray/types.h>
+
+namespace radray {
+namespace {
+
+// 4 级链: 64 / 16 / 4 / 1 字节, 最后一级是链尾。
+constexpr std::array<uint64_t, 4> kMipBytes{64, 16, 4, 1};
+
+TextureStreamingCandidate MakeCandidate(uint32_t residentMip, uint32_t wantedMip, float priority = 0.0f) {
+    return TextureStreamingCandidate{
+        .MipBytes = kMipBytes,
+        .ResidentMip = residentMip,
+        .WantedMip = wantedMip,
+        .TailMip = 3,
+        .Priority = priority};
+}
+
+TEST(TextureStreamingTest, RequiredMipFollowsScreenDensity) {
+    // 1024x512, 11 级。1 UV 单位占 1024 像素时 texel 与像素一一对应。
+    EXPECT_EQ(ComputeRequiredTextureMip(1024, 512, 11, 2048.0f), 0u);
+    EXPECT_EQ(ComputeRequiredTextureMip(1024, 512, 11, 1024.0f), 0u);
+    EXPECT_EQ(ComputeRequiredTextureMip(1024, 512, 11, 512.0f), 1u);
+    EXPECT_EQ(ComputeRequiredTextureMip(1024, 512, 11, 300.0f), 1u);
+    EXPECT_EQ(ComputeRequiredTextureMip(1024, 512, 11, 1.0f), 10u);
+    EXPECT_EQ(ComputeRequiredTextureMip(1024, 512, 11, 0.01f), 10u);
+    // 没有需求时退到最后一级。
+    EXPECT_EQ(ComputeRequiredTextureMip(1024, 512, 11, 0.0f), 10u);
+
+    EXPECT_FLOAT_EQ(ComputeTexturePixelsPerUv(2.0f, 1.5f, 10.0f, 100.0f), 30.0f);
+    EXPECT_EQ(ComputeTexturePixelsPerUv(0.0f, 1.0f, 10.0f, 100.0f), 0.0f);
+    EXPECT_EQ(ComputeTexturePixelsPerUv(2.0f, 1.0f, 0.0f, 100.0f), 0.0f);
+}
+
+TEST(TextureStreamingTest, MipBytesCountWholeBlocks) {
+    EXPECT_EQ(GetTextureMipBytes(render::TextureFormat::RGBA8_UNORM, 100, 40, 0), 100u * 40u * 4u);
+    EXPECT_EQ(GetTextureMipBytes(render::TextureFormat::RGBA8_UNORM, 100, 40, 7), 4u);
+    // 16x8 的 BC7: mip 0 为 4x2 块, mip 3 的 2x1 texel 仍占一整块。
+    EXPECT_EQ(GetTextureMipBytes(render::TextureFormat::BC7_UNORM, 16, 8, 0), 4u * 2u * 16u);
+    EXPECT_EQ(GetTextureMipBytes(render::TextureFormat::BC7_UNORM, 16, 8, 3), 16u);
+}
+
+TEST(TextureStreamingTest, OverBudgetEvictsSurplusLevelsFirst) {
+    // A 比需求精细两级, B 恰好够用。合计 170, 预算 100: 只淘汰 A 的两级就够了。
+    const std::array candidates{MakeCandidate(0, 2), MakeCandidate(0, 0)};
+    const vector<uint32_t> targets = PlanTextureStreaming(
+        candidates,
+        TextureStreamingBudget{.VramBytes = 100, .UploadBytesPerFrame = 1024});
+    ASSERT_EQ(targets.size(), 2u);
+    EXPECT_EQ(targets[0], 2u);
+    EXPECT_EQ(targets[1], 0u);
+
+    // 预算小到链尾都放不下时, 淘汰停在链尾。
+    const vector<uint32_t> tails = PlanTextureStreaming(
+        candidates,
+        TextureStreamingBudget{.VramBytes = 0, .UploadBytesPerFrame = 1024});
+    EXPECT_EQ(tails[0], 3u);
+    EXPECT_EQ(tails[1], 3u);
+}
+
+TEST(TextureStreamingTest, UploadsLargestDeficitFirstWithinFrameBudget) {
+    // A 缺三级, B 缺一级。每帧 20 字节: A 拿到 mip 2 与 mip 1, mip 0 与 B 留到之后的帧。
+    const std::array candidates{MakeCandidate(3, 0), MakeCandidate(2, 1, 100.0f)};
+    const vector<uint32_t> targets = PlanTextureStreaming(
+        candidates,
+        TextureStreamingBudget{.VramBytes = 1024, .UploadBytesPerFrame = 20});
+    EXPECT_EQ(targets[0], 1u);
+    EXPECT_EQ(targets[1], 2u);
+
+    // 单级超出每帧预算时照样上传一级。
+    const vector<uint32_t> oneLevel = PlanTextureStreaming(
+        std::array{MakeCandidate(1, 0)},
+        TextureStreamingBudget{.VramBytes = 1024, .UploadBytesPerFrame = 1});
+    EXPECT_EQ(oneLevel[0], 0u);
+
+    // 缺口相同时 Priority 高的先上传。
+    const vector<uint32_t> byPriority = PlanTextureStreaming(
+        std::array{MakeCandidate(3, 2, 1.0f), MakeCandidate(3, 2, 5.0f)},
+        TextureStreamingBudget{.VramBytes = 1024, .UploadBytesPerFrame = 4});
+    EXPECT_EQ(byPriority[0], 3u);
+    EXPECT_EQ(byPriority[1], 2u);
+}
+
+TEST(TextureStreamingTest, UploadsEvictOtherSurplusButNeverBusyOrMissingLevels) {
+    // 预算恰好等于当前驻留 (A 1 + B 85 + C 85)。A 要 mip 2, 只能挤掉 B 多余的 mip 0;
+    // C 有批次在途, 不动。
+    TextureStreamingCandidate busy = MakeCandidate(0, 3);
+    busy.Busy = true;
+    const std::array candidates{MakeCandidate(3, 2), MakeCandidate(0, 2), busy};
+    const vector<uint32_t> targets = PlanTextureStreaming(
+        candidates,
+        TextureStreamingBudget{.VramBytes = 171, .UploadBytesPerFrame = 1024});
+    EXPECT_EQ(targets[0], 2u);
+    EXPECT_EQ(targets[1], 1u);
+    EXPECT_EQ(targets[2], 0u);
+
+    // 没有多余级可挤时, 放不进预算的上传直接放弃, 不去淘汰别人需要的级。
+    const vector<uint32_t> blocked = PlanTextureStreaming(
+        std::array{MakeCandidate(3, 2), MakeCandidate(0, 0)},
+        TextureStreamingBudget{.VramBytes = 86, .UploadBytesPerFrame = 1024});
+    EXPECT_EQ(blocked[0], 3u);
+    EXPECT_EQ(blocked[1], 0u);
+}
+
+MeshResource MakeQuad(float size, bool withUv) {
+    // 边长 size 的正方形, UV 铺满 [0, 1]。
+    struct Vertex {
+        float Position[3];
+        float Uv[2];
+    };
+    const std::array<Vertex, 4> vertices{
+        Vertex{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
+        Vertex{{size, 0.0f, 0.0f}, {1.0f, 0.0f}},
+        Vertex{{size, size, 0.0f}, {1.0f, 1.0f}},
+        Vertex{{0.0f, size, 0.0f}, {0.0f, 1.0f}}};
+    const std::array<uint16_t, 6> indices{0, 1, 2, 0, 2, 3};
+    MeshResource mesh;
+    mesh.Bins.emplace_back(std::as_bytes(std::span{vertices}));
+    mesh.Bins.emplace_back(std::as_bytes(std::span{indices}));
+    MeshPrimitive& primitive = mesh.Primitives.emplace_back();
+    primitive.VertexCount = 4;
+    primitive.IndexBuffer = IndexBufferEntry{.BufferIndex = 1, .IndexCount = 6, .Offset = 0, .Stride = 2};
+    primitive.VertexBuffers.push_back(VertexBufferEntry{
+        .Semantic = string{VertexSemantics::POSITION},
+        .ComponentCount = 3,
+        .Offset = 0,
+        .Stride = sizeof(Vertex)});
+    if (withUv) {
+        primitive.VertexBuffers.push_back(VertexBufferEntry{
+            .Semantic = string{VertexSemantics::TEXCOORD},
+            .ComponentCount = 2,
+            .Offset = sizeof(float) * 3,
+            .Stride = sizeof(Vertex)});
+    }
+    return mesh;
+}
+
+TEST(TextureStreamingTest, SectionUvDensityIsLengthPerUvUnit) {
+    const MeshResource quad = MakeQuad(2.0f, true);
+    ASSERT_TRUE(IsStaticMeshDataValid(quad, {}));
+    const StaticMeshSection section{0, 0, 6, 0, 3};
+    EXPECT_FLOAT_EQ(ComputeStaticMeshUvDensity(quad, section), 2.0f);
+
+    // 只取前一个三角形, 面积比不变。
+    const StaticMeshSection half{0, 0, 3, 0, 2};
+    EXPECT_FLOAT_EQ(ComputeStaticMeshUvDensity(quad, half), 2.0f);
+
+    const MeshResource noUv = MakeQuad(2.0f, false);
+    EXPECT_EQ(ComputeStaticMeshUvDensity(noUv, section), 0.0f);
+
+    // 量化顶点: 位置按 PositionScale / PositionOffset 还原到网格空间后再算, UV 从 half 解出。
+    TriangleMesh rect;
+    rect.InitAsRectXY(4.0f, 4.0f);
+    MeshResource quantized;
+    rect.ToQuantizedMeshResource(&quantized);
+    ASSERT_TRUE(IsStaticMeshDataValid(quantized, {}));
+    EXPECT_NEAR(ComputeStaticMeshUvDensity(quantized, section), 4.0f, 1e-3f);
+    quantized.Primitives[0].PositionScale = 0.0f;
+    EXPECT_FALSE(IsStaticMeshDataValid(quantized, {}));
+}
+
+}  // namespace
+}  // namespace radray
@@ -46,8 +46,7 @@ TEST(RadRayShaderLibPass, ProductPassesCompileAsAtomicTwoTargetVariants) {
         shader::ShaderKind Kind;
         size_t EntryCount;
         std::span<const BindingFact> Bindings;
-        std::string_view AssignmentName;
-        std::string_view AssignmentValue;
+        vector<shader::KeywordAssignment> Assignments;
     };
     constexpr BindingFact forwardBindings[] = {
         {"ForwardView", 0, 0, 0, 0, 3},
@@ -58,9 +57,9 @@ TEST(RadRayShaderLibPass, ProductPassesCompileAsAtomicTwoTargetVariants) {
     constexpr BindingFact computeBindings[] = {
         {"Output", 0, 0, 2, 6, 4}};
     const PassCase cases[] = {
-        {"pipelines/forward/forward.hlsl", "pipelines/forward/forward.hlsl", shader::ShaderKind::Graphics, 2, forwardBindings, "QUALITY", "low"},
-        {"passes/depth.hlsl", "passes/depth.hlsl", shader::ShaderKind::Graphics, 1, {}, "DEPTH_MODE", "regular"},
-        {"passes/compute.hlsl", "passes/compute.hlsl", shader::ShaderKind::Compute, 1, computeBindings, "COMPUTE_MODE", "clear"}};
+        {"pipelines/forward/forward.hlsl", "pipelines/forward/forward.hlsl", shader::ShaderKind::Graphics, 2, forwardBindings, {{"QUALITY", "low"}, {"VERTEX_FORMAT", "float"}}},
+        {"passes/depth.hlsl", "passes/depth.hlsl", shader::ShaderKind::Graphics, 1, {}, {{"DEPTH_MODE", "regular"}}},
+        {"passes/compute.hlsl", "passes/compute.hlsl", shader::ShaderKind::Compute, 1, computeBindings, {{"COMPUTE_MODE", "clear"}}}};
 
     Client client;
     ASSERT_TRUE(client.IsAvailable());
@@ -85,7 +84,7 @@ TEST(RadRayShaderLibPass, ProductPassesCompileAsAtomicTwoTargetVariants) {
             .SourceName = string{pass.SourceName},
             .RootSource = source,
             .Defines = {},
-            .Assignments = {{string{pass.AssignmentName}, string{pass.AssignmentValue}}},
+            .Assignments = pass.Assignments,
             .Targets = shader::ShaderTargetMask::All,
             .ExpectedContract = discovery.Contract.Hash};
         const shader::CompileVariantResult result = client.CompileVariant(request, includePaths);
@@ -163,7 +162,7 @@ TEST(RadRayShaderLibPass, ForwardQualityKeywordChangesBytecode) {
                 .SourceName = string{sourceName},
                 .RootSource = source,
                 .Defines = {},
-                .Assignments = {{string{"QUALITY"}, string{value}}},
+                .Assignments = {{string{"QUALITY"}, string{value}}, {string{"VERTEX_FORMAT"}, string{"float"}}},
                 .Targets = shader::ShaderTargetMask::All,
                 .ExpectedContract = discovery.Contract.Hash},
             includePaths);
@@ -197,6 +196,75 @@ TEST(RadRayShaderLibPass, ForwardQualityKeywordChangesBytecode) {
     }
 }
 
+// VERTEX_FORMAT=quantized reads the layout TriangleMesh::ToQuantizedMeshResource writes:
+// UNORM16x4 positions, octahedral normals in two components and a two component UV. The
+// pipeline's vertex input validation matches component counts exactly, so the reflected
+// inputs are what decides which mesh layout a variant can draw.
+TEST(RadRayShaderLibPass, ForwardVertexFormatKeywordSelectsVertexInputs) {
+    Client client;
+    ASSERT_TRUE(client.IsAvailable());
+    const vector<std::filesystem::path> includePaths{ShaderlibRoot()};
+    constexpr std::string_view sourceName = "pipelines/forward/forward.hlsl";
+    const vector<byte> source = ReadBytes(ShaderlibRoot() / "pipelines/forward/forward.hlsl");
+    ASSERT_FALSE(source.empty());
+    const DiscoveryResult discovery = client.DiscoverSourceContract(
+        shader::SourceContractRequest{
+            .SourceName = string{sourceName},
+            .RootSource = source,
+            .Defines = {},
+            .Targets = shader::ShaderTargetMask::All,
+            .Policy = {}},
+        includePaths);
+    ASSERT_TRUE(discovery.Succeeded())
+        << (discovery.Diagnostics.empty() ? "" : discovery.Diagnostics.back().Message);
+
+    struct InputFact {
+        std::string_view Semantic;
+        uint32_t ComponentCount;
+    };
+    const auto expectInputs = [&](std::string_view vertexFormat, std::span<const InputFact> expected) {
+        const shader::CompileVariantResult result = client.CompileVariant(
+            shader::CompileVariantRequest{
+                .SourceName = string{sourceName},
+                .RootSource = source,
+                .Defines = {},
+                .Assignments = {{string{"QUALITY"}, string{"low"}}, {string{"VERTEX_FORMAT"}, string{vertexFormat}}},
+                .Targets = shader::ShaderTargetMask::All,
+                .ExpectedContract = discovery.Contract.Hash},
+            includePaths);
+        ASSERT_EQ(result.Status, shader::CompileStatus::Success)
+            << (result.Diagnostics.empty() ? "" : result.Diagnostics.back().Message);
+        for (const shader::CompileTargetLane& lane : result.Lanes) {
+            ASSERT_GE(lane.Metadata.size(), sizeof(shader::WireMetadataEnvelope));
+            shader::WireMetadataEnvelope envelope{};
+            std::memcpy(&envelope, lane.Metadata.data(), sizeof(envelope));
+            ASSERT_EQ(envelope.VertexInputRecords.Size, expected.size() * sizeof(shader::WireVertexInputRecord));
+            vector<shader::WireVertexInputRecord> inputs(expected.size());
+            std::memcpy(
+                inputs.data(),
+                lane.Metadata.data() + envelope.VertexInputRecords.Offset,
+                envelope.VertexInputRecords.Size);
+            for (const InputFact& fact : expected) {
+                const auto found = std::find_if(
+                    inputs.begin(),
+                    inputs.end(),
+                    [&](const shader::WireVertexInputRecord& input) {
+                        const auto* name = reinterpret_cast<const char*>(
+                            lane.Metadata.data() + input.Semantic.Offset);
+                        return std::string_view{name, input.Semantic.Size} == fact.Semantic;
+                    });
+                ASSERT_NE(found, inputs.end()) << vertexFormat << " " << fact.Semantic;
+                EXPECT_EQ(found->ComponentType, static_cast<uint32_t>(shader::ShaderVertexComponentType::Float));
+                EXPECT_EQ(found->ComponentCount, fact.ComponentCount) << vertexFormat << " " << fact.Semantic;
+            }
+        }
+    };
+    constexpr InputFact floatInputs[] = {{"POSITION", 3}, {"NORMAL", 3}, {"TEXCOORD", 2}};
+    constexpr InputFact quantizedInputs[] = {{"POSITION", 4}, {"NORMAL", 2}, {"TEXCOORD", 2}};
+    expectInputs("float", floatInputs);
+    expectInputs("quantized", quantizedInputs);
+}
+
 TEST(RadRayShaderLibPass, ProductPassesDeclareBothTargetBindingsExplicitly) {
     struct BindingCase {
         std::string_view RelativePath;
@@ -33,4 +33,14 @@ float3 safe_normalize(float3 v, float3 fallback) {
     return (len2 > RADRAY_EPS * RADRAY_EPS) ? (v * rsqrt(len2)) : fallback;
 }
 
+/// 八面体编码 ([-1, 1]^2) 还原成单位向量, 与 CPU 侧 OctahedralDecode (vertex_data.h) 一致。
+/// UNORM 存储的编码先映射回 [-1, 1] 再传进来。
+float3 octahedral_decode(float2 e) {
+    float3 n = float3(e, 1.0f - abs(e.x) - abs(e.y));
+    const float t = saturate(-n.z);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return normalize(n);
+}
+
 #endif
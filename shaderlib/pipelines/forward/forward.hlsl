@@ -3,6 +3,7 @@
 #include <pipelines/forward/bindings.hlsli>
 
 #pragma radray_keyword_group QUALITY "low" "high"
+#pragma radray_keyword_group VERTEX_FORMAT "float" "quantized"
 
 // A keyword group expands to a bare token, so it has to be pasted onto a prefix before
 // it can be compared. The indirection through RADRAY_FORWARD_CAT is what lets QUALITY
@@ -12,13 +13,43 @@
 #define RADRAY_FORWARD_QUALITY_low 0
 #define RADRAY_FORWARD_QUALITY_high 1
 #define RADRAY_FORWARD_QUALITY RADRAY_FORWARD_CAT(RADRAY_FORWARD_QUALITY_, QUALITY)
+#define RADRAY_FORWARD_VERTEX_FORMAT_float 0
+#define RADRAY_FORWARD_VERTEX_FORMAT_quantized 1
+#define RADRAY_FORWARD_VERTEX_FORMAT RADRAY_FORWARD_CAT(RADRAY_FORWARD_VERTEX_FORMAT_, VERTEX_FORMAT)
 
+#if RADRAY_FORWARD_VERTEX_FORMAT == RADRAY_FORWARD_VERTEX_FORMAT_quantized
+// Layout written by TriangleMesh::ToQuantizedMeshResource. Position is UNORM16 relative to the
+// mesh bounds; the CPU folds the dequantization into LocalToWorld, so it is used as stored. The
+// normal is an octahedral SNORM16 pair and UV is half (or float for large UVs).
+struct ForwardVertexInput {
+    float4 Position : POSITION;
+    float2 Normal : NORMAL;
+    float2 UV : TEXCOORD0;
+};
+
+float3 forward_vertex_position(ForwardVertexInput input) {
+    return input.Position.xyz;
+}
+
+float3 forward_vertex_normal(ForwardVertexInput input) {
+    return octahedral_decode(input.Normal);
+}
+#else
 struct ForwardVertexInput {
     float3 Position : POSITION;
     float3 Normal : NORMAL;
     float2 UV : TEXCOORD0;
 };
 
+float3 forward_vertex_position(ForwardVertexInput input) {
+    return input.Position;
+}
+
+float3 forward_vertex_normal(ForwardVertexInput input) {
+    return input.Normal;
+}
+#endif
+
 struct ForwardVertexOutput {
     float4 Position : SV_Position;
     float3 PositionWorld : POSITION0;
@@ -29,11 +60,11 @@ struct ForwardVertexOutput {
 [shader("vertex")]
 ForwardVertexOutput VSMain(ForwardVertexInput input) {
     ForwardVertexOutput output;
-    const float4 positionWorld = mul(ForwardObject.LocalToWorld, float4(input.Position, 1.0f));
+    const float4 positionWorld = mul(ForwardObject.LocalToWorld, float4(forward_vertex_position(input), 1.0f));
     output.Position = mul(ForwardView.ViewProj, positionWorld);
     output.PositionWorld = positionWorld.xyz;
     output.NormalWorld = safe_normalize(
-        mul((float3x3)ForwardObject.LocalToWorld, input.Normal),
+        mul((float3x3)ForwardObject.LocalToWorld, forward_vertex_normal(input)),
         float3(0.0f, 1.0f, 0.0f));
     output.UV = input.UV;
     return output;